@@ -4,7 +4,7 @@
  * Created:
  *   11/06/2021, 18:03:12
  * Last edited:
- *   9/20/2021, 8:15:45 PM
+ *   19/10/2026, 03:14:43
  * Auto updated?
  *   Yes
  *
@@ -17,18 +17,24 @@
 #include <windows.h>
 #endif
 #include <string>
+#include <sstream>
+#include <iomanip>
+#include <limits>
 #include <chrono>
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <random>
 #include <iostream>
 #include <GLFW/glfw3.h>
 
 #include "tools/Logger.hpp"
 #include "tools/Common.hpp"
+#include "tools/Profiler.hpp"
 
 #include "window/Window.hpp"
 
 #include "world/WorldSystem.hpp"
+#include "world/CameraPath.hpp"
 
 // #include "materials/MaterialSystem.hpp"
 #include "materials/textures/TexturePool.hpp"
@@ -39,6 +45,7 @@
 #include "rendering/instance/Instance.hpp"
 #include "rendering/memory_manager/MemoryManager.hpp"
 #include "rendering/RenderSystem.hpp"
+#include "rendering/profiling/BenchmarkReport.hpp"
 
 #include "ecs/EntityManager.hpp"
 
@@ -53,10 +60,90 @@ struct Options {
     /* The number of bytes to allocate on host visible memory. */
     VkDeviceSize visible_memory_size;
 
+    /* The number of frames that may be in flight at once. */
+    uint32_t frames_in_flight;
+    /* The present mode for the swapchain. */
+    VkPresentModeKHR present_mode;
+    /* The number of images in the swapchain, or 0 to choose automatically. */
+    uint32_t image_count;
+
+    /* Whether to render headless, i.e., without a window and to offscreen images. */
+    bool headless;
+    /* The number of frames to render before stopping, or 0 to keep going until the window is closed. */
+    uint32_t n_frames;
+    /* The directory to write each rendered frame to as a .png, or empty to not write them. */
+    std::string output_dir;
+    /* Whether to fill the depth buffer in a pre-pass before shading the scene. */
+    bool depth_prepass;
+    /* Whether to cull the draws against the frustum and the previous frame's depth on the GPU. */
+    bool gpu_culling;
+    /* Whether to also compare the GPU's culling results against a CPU reference each frame. Implies gpu_culling. */
+    bool cull_check;
+    /* Whether to cull entities on the CPU against the larger models in the scene, which are then marked as occluders. */
+    bool cpu_occlusion;
+    /* The number of point lights to scatter through the scene. */
+    uint32_t n_lights;
+    /* The GPU frame time to hold by scaling the render resolution, in microseconds. 0 keeps the full resolution. */
+    uint32_t target_frame_us;
+    /* The number of cameras to render at once, each to its own part of the window. */
+    uint32_t n_views;
+    /* The number of particles that may be alive at once, or 0 to not simulate any. */
+    uint32_t max_particles;
+    /* Whether to compare the number of living particles against a CPU reference each frame. Implies some particles. */
+    bool particle_check;
+    /* Whether to keep all textures in a single array that stays bound, instead of binding them per material. */
+    bool bindless;
+
+    /* Whether to measure how long the GPU spends on each material type. */
+    bool gpu_profiling;
+    /* Whether to also count the shader invocations of each material type. Implies gpu_profiling. */
+    bool pipeline_statistics;
+    /* The file to write a Chrome trace of the CPU zones to when we quit, or empty to not write one. */
+    std::string trace_path;
+    /* Whether to log a summary of the work done per frame (draws, binds, uploads, ...) once per second. */
+    bool render_stats;
+
+    /* The file to record the camera's path to, or empty to not record it. */
+    std::string record_path;
+    /* The camera path to replay as a benchmark, or empty to not run a benchmark. */
+    std::string benchmark_path;
+    /* The simulated time between two frames of a benchmark, in microseconds. */
+    uint32_t timestep_us;
+    /* The file to write the benchmark report to. */
+    std::string report_path;
+
     /* Default constructor for the Options class, which sets everything to default. */
     Options() :
         local_memory_size(100 * 1024 * 1024),
-        visible_memory_size(100 * 1024 * 1024)
+        visible_memory_size(100 * 1024 * 1024),
+
+        frames_in_flight(2),
+        present_mode(VK_PRESENT_MODE_FIFO_KHR),
+        image_count(0),
+
+        headless(false),
+        n_frames(0),
+        output_dir(""),
+        depth_prepass(false),
+        gpu_culling(false),
+        cull_check(false),
+        cpu_occlusion(false),
+        n_lights(0),
+        target_frame_us(0),
+        n_views(1),
+        max_particles(0),
+        particle_check(false),
+        bindless(false),
+
+        gpu_profiling(false),
+        pipeline_statistics(false),
+        trace_path(""),
+        render_stats(false),
+
+        record_path(""),
+        benchmark_path(""),
+        timestep_us(16667),
+        report_path("benchmark.json")
     {}
 };
 
@@ -94,9 +181,61 @@ static void print_help(std::ostream& os, const std::string& filename) {
     os << "Options:" << endl;
     os << "     --local <bytes> : The number of bytes we reserve in local device memory." << endl;
     os << "     --visible <bytes> : The number of bytes we reserve in host visible device memory." << endl;
+    os << "     --frames-in-flight <n> : The number of frames the CPU may prepare ahead of the GPU (1-4). Fewer frames means less latency, more frames means more throughput. Default: 2." << endl;
+    os << "     --present-mode <mode> : The present mode of the swapchain: 'fifo' (vsync), 'mailbox' (vsync without blocking) or 'immediate' (no vsync). Falls back to 'fifo' if unsupported. Default: fifo." << endl;
+    os << "     --images <n> : The number of images in the swapchain, or 0 to use one more than the minimum. Default: 0." << endl;
+    os << "     --headless : Renders without a window to offscreen images, e.g. on machines without a display. Works with CPU Vulkan implementations like lavapipe." << endl;
+    os << "     --frames <n> : Renders the given number of frames as fast as possible and then stops, or 0 to keep going until the window is closed. Default: 0." << endl;
+    os << "     --output <dir> : Writes every rendered frame as a .png to the given (existing) directory. The frames are captured asynchronously, so this doesn't stall rendering." << endl;
+    os << "     --depth-prepass : Fills the depth buffer with a cheap, position-only pass before drawing the scene, so that only the visible fragments are shaded. Helps scenes with a lot of overdraw." << endl;
+    os << "     --gpu-cull : Culls the draws on the GPU against the view frustum and a depth pyramid of the previous frame, drawing them with indirect draws. Keeps culling off the CPU entirely." << endl;
+    os << "     --cull-check : Like --gpu-cull, but also reads the GPU's results back and compares them against a CPU reference each frame, logging any differences. Meant for testing, e.g. on lavapipe." << endl;
+    os << "     --cpu-occlusion : Rasterizes the larger models in the scene to a small depth buffer on the CPU, and skips the draws of anything hidden behind them before they're sorted. Note that this rebuilds the draw list whenever the camera moves." << endl;
+    os << "     --lights <n> : Scatters the given number of coloured point lights through the scene, which are culled per screen cluster before shading. Use e.g. 1000 to benchmark the light culling. Default: 0 (unlit)." << endl;
+    os << "     --target-frame-time <us> : Renders the scene at a lower resolution whenever the GPU takes longer than the given time per frame (in microseconds), and stretches it over the window. Use e.g. 16667 to hold 60 fps. Default: 0 (full resolution)." << endl;
+    os << "     --views <n> : Renders the scene from the given number of cameras at once (1-" << Rendering::max_views << "), each to its own part of the window, in a single multiview pass. Only the first camera can be controlled. Default: 1." << endl;
+    os << "     --particles <n> : Places a few emitters in the scene whose particles are spawned, simulated and drawn entirely on the GPU, with room for the given number of particles at once. Use e.g. 1000000 to benchmark it. Default: 0 (no particles)." << endl;
+    os << "     --particle-check : Like --particles, but also reads the number of living particles back each frame and compares it against a CPU reference, logging any differences. Meant for testing, e.g. on lavapipe. Uses 100000 particles if --particles isn't given." << endl;
+    os << "     --bindless : Keeps all textures in a single array that stays bound (VK_EXT_descriptor_indexing), so that switching between textured materials only takes a push constant instead of binding a descriptor set. Falls back to binding them per material if the GPU doesn't support it." << endl;
+    os << "     --gpu-profile : Measures how long the GPU spends on the render pass and on each material type using timestamp queries, and logs it once per second." << endl;
+    os << "     --pipeline-stats : Like --gpu-profile, but also counts the vertex & fragment shader invocations of each material type." << endl;
+    os << "     --render-stats : Logs the min/avg/p99 of the draws, binds, uploads and fence waits of the recent frames once per second." << endl;
+    os << "     --record <file> : Records where the camera goes to the given file when quitting, so it can be replayed with --benchmark." << endl;
+    os << "     --benchmark <file> : Replays the camera path in the given file instead of reacting to input, at a fixed timestep and for as many frames as the path lasts (or as given with --frames). Writes a JSON report with the frame times, GPU times and memory usage when done." << endl;
+    os << "     --timestep <us> : The simulated time between two frames of a benchmark, in microseconds. Default: 16667." << endl;
+    os << "     --report <file> : The file to write the benchmark report to. Default: benchmark.json." << endl;
+    os << "     --trace <file> : Writes where the CPU spent its time on each thread to the given file when quitting, as a Chrome trace that can be opened in chrome://tracing or Perfetto. Only works if compiled with ENABLE_PROFILING." << endl;
     os << endl;
 }
 
+/* Returns the path of the .png file for the given frame in the given output directory. */
+static std::string get_frame_path(const std::string& output_dir, uint32_t frame) {
+    std::stringstream sstr;
+    sstr << "frame_" << std::setw(5) << std::setfill('0') << frame << ".png";
+    return Tools::merge_paths(output_dir, sstr.str());
+}
+
+/* Parses the given value of the given option as an unsigned integer in the given (inclusive) range. Exits the program with an error if that fails. */
+static uint32_t parse_uint(const std::string& option, const std::string& value, uint32_t min, uint32_t max) {
+    // Try to parse the value
+    unsigned long ivalue;
+    try {
+        size_t n_parsed;
+        ivalue = std::stoul(value, &n_parsed);
+        if (n_parsed != value.size()) { throw std::invalid_argument("trailing characters"); }
+    } catch (std::exception&) {
+        cerr << "Value '" << value << "' for option '" << option << "' is not a valid unsigned integer." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Check if it's in range
+    if (ivalue < min || ivalue > max) {
+        cerr << "Value '" << value << "' for option '" << option << "' should be between " << min << " and " << max << "." << endl;
+        exit(EXIT_FAILURE);
+    }
+    return static_cast<uint32_t>(ivalue);
+}
+
 /* Parses the given arguments, populating the given Settings struct. */
 static void parse_args(Options& opts, int argc, const char** argv) {
     // Start parsin'
@@ -167,6 +306,253 @@ static void parse_args(Options& opts, int argc, const char** argv) {
                     // Set in the settings
                     opts.visible_memory_size = ivalue;
                     
+                } else if (option == "frames-in-flight" || option.substr(0, 17) == "frames-in-flight=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 16 && option[16] == '=') {
+                        value = option.substr(17);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number within the range the FrameManager supports
+                    opts.frames_in_flight = parse_uint("frames-in-flight", value, Rendering::FrameManager::min_frames_in_flight, Rendering::FrameManager::max_frames_in_flight);
+
+                } else if (option == "present-mode" || option.substr(0, 13) == "present-mode=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 12 && option[12] == '=') {
+                        value = option.substr(13);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Map it to the Vulkan present mode
+                    if (value == "fifo") {
+                        opts.present_mode = VK_PRESENT_MODE_FIFO_KHR;
+                    } else if (value == "mailbox") {
+                        opts.present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+                    } else if (value == "immediate") {
+                        opts.present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+                    } else {
+                        cerr << "Unknown present mode '" << value << "' (expected 'fifo', 'mailbox' or 'immediate')." << endl;
+                        exit(EXIT_FAILURE);
+                    }
+
+                } else if (option == "images" || option.substr(0, 7) == "images=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 6 && option[6] == '=') {
+                        value = option.substr(7);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number; the swapchain clamps it to what the surface supports
+                    opts.image_count = parse_uint("images", value, 0, 16);
+
+                } else if (option == "headless") {
+                    // Simply mark that we render headless
+                    opts.headless = true;
+
+                } else if (option == "depth-prepass") {
+                    // Simply mark that we do a depth pre-pass
+                    opts.depth_prepass = true;
+
+                } else if (option == "gpu-cull") {
+                    // Simply mark that we cull on the GPU
+                    opts.gpu_culling = true;
+
+                } else if (option == "cull-check") {
+                    // Mark that we cull on the GPU and check it against the CPU
+                    opts.gpu_culling = true;
+                    opts.cull_check = true;
+
+                } else if (option == "cpu-occlusion") {
+                    // Simply mark that we cull against occluders on the CPU
+                    opts.cpu_occlusion = true;
+
+                } else if (option == "lights" || option.substr(0, 7) == "lights=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 6 && option[6] == '=') {
+                        value = option.substr(7);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number
+                    opts.n_lights = parse_uint("lights", value, 0, std::numeric_limits<uint32_t>::max());
+
+                } else if (option == "target-frame-time" || option.substr(0, 18) == "target-frame-time=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 17 && option[17] == '=') {
+                        value = option.substr(18);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number
+                    opts.target_frame_us = parse_uint("target-frame-time", value, 0, std::numeric_limits<uint32_t>::max());
+
+                } else if (option == "views" || option.substr(0, 6) == "views=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 5 && option[5] == '=') {
+                        value = option.substr(6);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number within the range the RenderSystem supports
+                    opts.n_views = parse_uint("views", value, 1, Rendering::max_views);
+
+                } else if (option == "particles" || option.substr(0, 10) == "particles=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 9 && option[9] == '=') {
+                        value = option.substr(10);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number
+                    opts.max_particles = parse_uint("particles", value, 0, std::numeric_limits<uint32_t>::max() / 2);
+
+                } else if (option == "particle-check") {
+                    // Mark that we check the particles, which needs some particles to check
+                    opts.particle_check = true;
+
+                } else if (option == "bindless") {
+                    // Simply mark that we keep the textures bindless
+                    opts.bindless = true;
+
+                } else if (option == "gpu-profile") {
+                    // Simply mark that we profile the GPU
+                    opts.gpu_profiling = true;
+
+                } else if (option == "pipeline-stats") {
+                    // Mark that we profile the GPU, with statistics
+                    opts.gpu_profiling = true;
+                    opts.pipeline_statistics = true;
+
+                } else if (option == "frames" || option.substr(0, 7) == "frames=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 6 && option[6] == '=') {
+                        value = option.substr(7);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number
+                    opts.n_frames = parse_uint("frames", value, 0, std::numeric_limits<uint32_t>::max());
+
+                } else if (option == "output" || option.substr(0, 7) == "output=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 6 && option[6] == '=') {
+                        value = option.substr(7);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Store it as-is; we don't create it for the user
+                    opts.output_dir = value;
+
+                } else if (option == "render-stats") {
+                    // Simply mark that we log the render stats
+                    opts.render_stats = true;
+
+                } else if (option == "record" || option.substr(0, 7) == "record=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 6 && option[6] == '=') {
+                        value = option.substr(7);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Store it as-is
+                    opts.record_path = value;
+
+                } else if (option == "benchmark" || option.substr(0, 10) == "benchmark=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 9 && option[9] == '=') {
+                        value = option.substr(10);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Store it as-is; it's loaded once we start
+                    opts.benchmark_path = value;
+
+                } else if (option == "timestep" || option.substr(0, 9) == "timestep=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 8 && option[8] == '=') {
+                        value = option.substr(9);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Parse it as a number
+                    opts.timestep_us = parse_uint("timestep", value, 1, std::numeric_limits<uint32_t>::max());
+
+                } else if (option == "report" || option.substr(0, 7) == "report=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 6 && option[6] == '=') {
+                        value = option.substr(7);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Store it as-is
+                    opts.report_path = value;
+
+                } else if (option == "trace" || option.substr(0, 6) == "trace=") {
+                    // Either take the next one or split
+                    std::string value;
+                    if (option.size() > 5 && option[5] == '=') {
+                        value = option.substr(6);
+                    } else if (i < argc - 1) {
+                        value = argv[++i];
+                    } else {
+                        cerr << "Missing value for option '" << arg << "'.";
+                    }
+
+                    // Store it as-is
+                    opts.trace_path = value;
+
                 } else if (option == "help") {
                     // Print the help string!
                     print_help(cout, argv[0]);
@@ -200,6 +586,9 @@ static void parse_args(Options& opts, int argc, const char** argv) {
 
         }
     }
+
+    // Checking the particles needs some particles to check
+    if (opts.particle_check && opts.max_particles == 0) { opts.max_particles = 100000; }
 }
 
 
@@ -225,19 +614,43 @@ int main(int argc, const char** argv) {
         std::string exe_path = get_executable_path();
         logger.log(Verbosity::important, "Running from '", exe_path, "'...");
 
-        // Initialize the GLFW library
-        logger.log(Verbosity::important, "Initializing GLFW...");
-        glfwInit();
-        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
-        glfwSetErrorCallback(glfw_error_callback);
+        // Initialize the GLFW library, unless we don't need a window
+        if (!opts.headless) {
+            logger.log(Verbosity::important, "Initializing GLFW...");
+            glfwInit();
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+            glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+            glfwSetErrorCallback(glfw_error_callback);
+        } else {
+            logger.log(Verbosity::important, "Rendering headless...");
+        }
+        if (!opts.output_dir.empty()) {
+            logger.log(Verbosity::important, "Writing frames to '", opts.output_dir, "'...");
+        }
+        if (!opts.trace_path.empty() && !Tools::Profiler::enabled) {
+            logger.warning("Compiled without ENABLE_PROFILING; the trace written to '", opts.trace_path, "' will be empty.");
+        }
 
-        // Prepare the Vulkan instance first
-        Rendering::Instance instance(Rendering::instance_extensions + get_glfw_extensions());
+        // Load the camera path to benchmark, if any. By default, we render as many frames as it lasts, and we always measure the GPU
+        World::CameraPath camera_path;
+        bool benchmarking = !opts.benchmark_path.empty();
+        float timestep = (float) opts.timestep_us / 1000000.0f;
+        if (benchmarking) {
+            camera_path = World::CameraPath::load(opts.benchmark_path);
+            if (opts.n_frames == 0) { opts.n_frames = static_cast<uint32_t>(camera_path.duration() / timestep) + 1; }
+            opts.gpu_profiling = true;
+            logger.log(Verbosity::important, "Benchmarking '", opts.benchmark_path, "' for ", opts.n_frames, " frames of ", opts.timestep_us, "us each...");
+        }
+        if (!opts.record_path.empty()) {
+            logger.log(Verbosity::important, "Recording the camera path to '", opts.record_path, "'...");
+        }
+
+        // Prepare the Vulkan instance first. Headless rendering doesn't need any of GLFW's surface extensions
+        Rendering::Instance instance(opts.headless ? Rendering::instance_extensions : Rendering::instance_extensions + get_glfw_extensions());
 
         // Use that to prepare the Window class
         uint32_t width = 800, height = 600;
-        Window window(instance, "Rasterizer", width, height);
+        Window window = opts.headless ? Window(instance, width, height) : Window(instance, "Rasterizer", width, height, opts.present_mode, opts.image_count);
         // Prepare the memory manager
         Rendering::MemoryManager memory_manager(window.gpu(), opts.local_memory_size, opts.visible_memory_size);
         // Initialize the WorldSystem
@@ -250,7 +663,21 @@ int main(int argc, const char** argv) {
         // Initialize the ModelSystem
         Models::ModelSystem model_system(memory_manager, material_pool);
         // Initialize the RenderSystem
-        Rendering::RenderSystem render_system(window, memory_manager, model_system);
+        Rendering::RenderSystem::Options render_options;
+        render_options.frames_in_flight = opts.frames_in_flight;
+        render_options.gpu_profiling = opts.gpu_profiling;
+        render_options.pipeline_statistics = opts.pipeline_statistics;
+        render_options.depth_prepass = opts.depth_prepass;
+        render_options.gpu_culling = opts.gpu_culling;
+        render_options.cull_check = opts.cull_check;
+        render_options.cpu_occlusion = opts.cpu_occlusion;
+        render_options.target_frame_us = opts.target_frame_us;
+        render_options.n_views = opts.n_views;
+        render_options.max_particles = opts.max_particles;
+        render_options.particle_check = opts.particle_check;
+        render_options.bindless = opts.bindless;
+        Rendering::RenderSystem render_system(window, memory_manager, model_system, render_options);
+        if (benchmarking) { render_system.set_particle_step(timestep); }
         // Initialize the entity manager
         ECS::EntityManager entity_manager;
 
@@ -269,13 +696,24 @@ int main(int argc, const char** argv) {
         // world_system.set(entity_manager, square2, { 0.0, 0.0, -0.5 }, { 0.0, 0.0, 0.0 }, { 1.0, 1.0, 1.0 });
         // model_system.load_model(entity_manager, square2, "", Models::ModelFormat::square);
 
-        // Prepare the camera
+        // Prepare the cameras. With several views, they're laid out in a grid over the window, each looking another way
+        uint32_t n_views = render_system.views();
+        uint32_t view_cols = static_cast<uint32_t>(std::ceil(std::sqrt((float) n_views)));
+        uint32_t view_rows = (n_views + view_cols - 1) / view_cols;
+        glm::vec2 view_cell(1.0f / (float) view_cols, 1.0f / (float) view_rows);
+        float view_ratio = ((float) width * view_cell.x) / ((float) height * view_cell.y);
         entity_t cam = entity_manager.add(ECS::ComponentFlags::camera | ECS::ComponentFlags::controllable | ECS::ComponentFlags::transform);
-        world_system.set_cam(entity_manager, cam, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, 45, (float) width / (float) height);
+        world_system.set_cam(entity_manager, cam, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, 45, view_ratio, glm::vec4(0.0f, 0.0f, view_cell));
         world_system.set_controllable(entity_manager, cam, 1.0f, 10.0f);
+        for (uint32_t v = 1; v < n_views; v++) {
+            entity_t view_cam = entity_manager.add(ECS::ComponentFlags::camera | ECS::ComponentFlags::transform);
+            glm::vec4 viewport((float) (v % view_cols) * view_cell.x, (float) (v / view_cols) * view_cell.y, view_cell);
+            world_system.set_cam(entity_manager, view_cam, { 0.0, 0.0, 0.0 }, { 0.0, 90.0f * (float) v, 0.0 }, 45, view_ratio, viewport);
+        }
 
-        // Prepare the teddy bear
-        entity_t obj = entity_manager.add(ECS::ComponentFlags::transform | ECS::ComponentFlags::model);
+        // Prepare the teddy bear. If we cull on the CPU, it's large enough to hide things behind it
+        ECS::ComponentFlags occluder = opts.cpu_occlusion ? ECS::ComponentFlags::occluder : ECS::ComponentFlags::none;
+        entity_t obj = entity_manager.add(ECS::ComponentFlags::transform | ECS::ComponentFlags::model | occluder);
         world_system.set(entity_manager, obj, { 0.0f, 0.0f, 0.0f }, { 0.5f * M_PI, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
         // world_system.set(entity_manager, obj, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.5, 0.5, 0.5 });
         // world_system.set(entity_manager, obj, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.03, 0.03, 0.03 });
@@ -295,7 +733,7 @@ int main(int argc, const char** argv) {
         logger.log(Verbosity::details, "Triangle is mapped to entity index ", obj2);
 
         // And the third object, with a different material
-        entity_t obj3 = entity_manager.add(ECS::ComponentFlags::transform | ECS::ComponentFlags::model);
+        entity_t obj3 = entity_manager.add(ECS::ComponentFlags::transform | ECS::ComponentFlags::model | occluder);
         world_system.set(entity_manager, obj3, { 3.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
         model_system.load_model(entity_manager, obj3, "data/models/watermill.obj", Models::ModelFormat::obj);
         // texture_system.load_texture(entity_manager, obj2, exe_path + "/data/textures/capsule.jpg", Textures::TextureFormat::jpg);
@@ -308,16 +746,81 @@ int main(int argc, const char** argv) {
         // texture_system.load_texture(entity_manager, obj2, exe_path + "/data/textures/capsule.jpg", Textures::TextureFormat::jpg);
         logger.log(Verbosity::details, "Capsule is mapped to entity index ", obj4);
 
+        // Scatter the point lights around the objects. The seed is fixed, so that benchmarks see the same lights every run
+        std::mt19937 light_rng(42);
+        std::uniform_real_distribution<float> light_pos(-6.0f, 6.0f);
+        std::uniform_real_distribution<float> light_height(-1.0f, 3.0f);
+        std::uniform_real_distribution<float> light_colour(0.2f, 1.0f);
+        for (uint32_t i = 0; i < opts.n_lights; i++) {
+            entity_t light = entity_manager.add(ECS::ComponentFlags::transform | ECS::ComponentFlags::light);
+            world_system.set(entity_manager, light, { light_pos(light_rng), light_height(light_rng), light_pos(light_rng) }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+            world_system.set_light(entity_manager, light, { light_colour(light_rng), light_colour(light_rng), light_colour(light_rng) }, 1.0f, 1.5f);
+        }
+        if (opts.n_lights > 0) { logger.log(Verbosity::details, "Scattered ", opts.n_lights, " point lights through the scene"); }
+
+        // Add a plume of smoke and a fountain of sparks. Each spawns just under half the particles that fit, so that the buffer never overflows once they've settled
+        if (render_system.particles()) {
+            float smoke_lifetime = 4.0f, sparks_lifetime = 1.5f;
+            entity_t smoke = entity_manager.add(ECS::ComponentFlags::transform | ECS::ComponentFlags::emitter);
+            world_system.set(entity_manager, smoke, { 3.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+            world_system.set_emitter(entity_manager, smoke, { 0.0f, -0.8f, 0.0f }, 0.3f, { 0.15f, 0.15f, 0.17f }, 0.45f * (float) opts.max_particles / smoke_lifetime, smoke_lifetime, 0.05f, 0.3f);
+            entity_t sparks = entity_manager.add(ECS::ComponentFlags::transform | ECS::ComponentFlags::emitter);
+            world_system.set(entity_manager, sparks, { -3.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+            world_system.set_emitter(entity_manager, sparks, { 0.0f, -2.5f, 0.0f }, 1.0f, { 1.0f, 0.5f, 0.1f }, 0.45f * (float) opts.max_particles / sparks_lifetime, sparks_lifetime, 0.01f, 0.05f);
+            logger.log(Verbosity::details, "Added a smoke emitter as entity ", smoke, " and a sparks emitter as entity ", sparks);
+        }
+
         // Do the render
         uint32_t fps = 0;
+        uint32_t n_rendered = 0;
+        Rendering::BenchmarkReport report;
         logger.log(Verbosity::important, "Done initializing, entering game loop...");
         chrono::system_clock::time_point last_fps_update = chrono::system_clock::now();
+        chrono::steady_clock::time_point loop_start = chrono::steady_clock::now();
+        chrono::steady_clock::time_point frame_start = loop_start;
         bool busy = true;
         while (busy) {
+            PROFILE_SCOPE("frame");
+
+            // When benchmarking, put the camera where the path says it is at the simulated time of this frame
+            if (benchmarking) {
+                World::CameraKey key = camera_path.sample((float) n_rendered * timestep);
+                const ECS::Camera& camera = entity_manager.get_component<ECS::Camera>(cam);
+                world_system.set_cam(entity_manager, cam, key.position, key.rotation, camera.fov, camera.ratio, camera.viewport);
+            }
+
+            // Capture the frame we're about to render if asked to; it's written to disk in the background
+            if (!opts.output_dir.empty()) {
+                render_system.capture_frame(get_frame_path(opts.output_dir, n_rendered));
+            }
             // Run the render engine
             busy = render_system.render_frame(entity_manager);
-            // Update the world
-            world_system.update(entity_manager, window);
+            // Update the world, unless the benchmark decides where the camera goes
+            if (!benchmarking) {
+                world_system.update(entity_manager, window);
+            }
+
+            // Remember where the camera went, if asked to
+            if (!opts.record_path.empty()) {
+                const ECS::Transform& transform = entity_manager.get_component<ECS::Transform>(cam);
+                float time = (float) chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - loop_start).count() / 1000000.0f;
+                camera_path.add(time, transform.position, transform.rotation);
+            }
+
+            // Time the frame for the benchmark
+            chrono::steady_clock::time_point frame_end = chrono::steady_clock::now();
+            if (benchmarking && !render_system.render_stats_history().empty()) {
+                uint64_t frame_us = static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(frame_end - frame_start).count());
+                report.add_frame(frame_us, render_system.frame_wait_stats().last_wait_us, render_system.render_stats());
+            }
+            frame_start = frame_end;
+
+            // Stop if we rendered enough frames
+            ++n_rendered;
+            if (opts.n_frames > 0 && n_rendered >= opts.n_frames) {
+                logger.log(Verbosity::important, "Rendered ", n_rendered, " frames, stopping...");
+                busy = false;
+            }
 
             // Keep track of the fps
             ++fps;
@@ -325,9 +828,23 @@ int main(int argc, const char** argv) {
                 // Reset the timer
                 last_fps_update += chrono::milliseconds(1000);
 
-                // Show the FPS
+                // Show the FPS, in the log if there's no title to show it in
                 window.set_title("Rasterizer (FPS: " + std::to_string(fps) + ")");
+                if (window.headless()) { logger.log(Verbosity::important, "FPS: ", fps); }
                 fps = 0;
+                if (render_system.dynamic_resolution()) { logger.log(Verbosity::details, "Rendering at ", render_system.render_scale(), " of the resolution"); }
+
+                // Report how long the CPU waited for frames, which tells us whether we're throttled by the frames in flight / present mode
+                const Rendering::FrameWaitStats& wait_stats = render_system.frame_wait_stats();
+                logger.log(Verbosity::details, "CPU frame wait over ", wait_stats.n_frames, " frames (", render_system.frames_in_flight(), " in flight): avg ", wait_stats.avg_wait_us(), "us (fence ", wait_stats.fence_wait_us, "us, acquire ", wait_stats.acquire_wait_us, "us total), max ", wait_stats.max_wait_us, "us");
+                render_system.reset_frame_wait_stats();
+
+                // Report where the GPU spent its time, if we measured that. The benchmark report needs them for the whole run, though
+                render_system.log_gpu_stats();
+                if (!benchmarking) { render_system.reset_gpu_stats(); }
+
+                // Report the work done per frame, if asked to
+                if (opts.render_stats) { render_system.log_render_stats(); }
 
                 // Add another model???
                 // if (count == 0) {
@@ -361,6 +878,20 @@ int main(int argc, const char** argv) {
         // Wait for the GPU to be idle before we stop
         logger.log(Verbosity::important, "Cleaning up...");
         window.gpu().wait_for_idle();
+
+        // Write the benchmark results, if we ran one
+        if (benchmarking) {
+            report.write(opts.report_path, opts.benchmark_path, (double) opts.timestep_us / 1000.0, render_system.gpu_profiling() ? &render_system.gpu_stats() : nullptr, memory_manager);
+        }
+        // Save the camera path, if we recorded one
+        if (!opts.record_path.empty()) {
+            camera_path.save(opts.record_path);
+        }
+
+        // Write the CPU zones if asked to
+        if (!opts.trace_path.empty()) {
+            Tools::profiler.write_trace(opts.trace_path);
+        }
     
     } catch (Tools::Logger::Fatal&) {
         // Do nothing, the debugger already handled it
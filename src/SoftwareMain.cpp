@@ -0,0 +1,339 @@
+/* SOFTWARE MAIN.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:24:10
+ * Last edited:
+ *   19/10/2026, 02:24:10
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Entry point to the software rasterizer executable, which renders the
+ *   same scene as the rasterizer on the CPU and writes it to a .png. It
+ *   needs neither a GPU nor a Vulkan driver. With --benchmark, it instead
+ *   renders the scene with more and more threads and reports how many
+ *   triangles per second each manages.
+**/
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+#include <string>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <cstdio>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <iostream>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "tools/Logger.hpp"
+#include "tools/Common.hpp"
+
+#include "software/AssetPool.hpp"
+#include "software/Rasterizer.hpp"
+
+using namespace std;
+using namespace Makma3D;
+
+
+/***** HELPER STRUCTS *****/
+struct Options {
+    /* The width of the image to render, in pixels. */
+    uint32_t width;
+    /* The height of the image to render, in pixels. */
+    uint32_t height;
+    /* The number of threads to render with, or the most to try when benchmarking. */
+    uint32_t n_threads;
+    /* The number of frames to render (for each number of threads, when benchmarking). */
+    uint32_t n_frames;
+    /* The .png file to write the last rendered frame to, or empty to not write it. */
+    std::string output_path;
+    /* Whether to benchmark the rasterizer with different numbers of threads. */
+    bool benchmark;
+
+    /* Default constructor for the Options class, which sets everything to default. */
+    Options() :
+        width(800),
+        height(600),
+        n_threads(std::max(std::thread::hardware_concurrency(), 1u)),
+        n_frames(0),
+        output_path("frame.png"),
+        benchmark(false)
+    {}
+};
+
+/* A single model in the scene, with its transformation matrix. */
+struct SceneObject {
+    /* The model itself. */
+    Software::Model model;
+    /* The model's transformation matrix. */
+    glm::mat4 transform;
+};
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Prints the usage string. */
+static void print_usage(std::ostream& os, const std::string& filename) {
+    os << "Usage: " << filename << " [options]" << endl;
+}
+
+/* Prints the help string. */
+static void print_help(std::ostream& os, const std::string& filename) {
+    print_usage(os, filename);
+
+    os << endl;
+    os << "Renders the rasterizer's scene on the CPU, without a GPU or a Vulkan driver." << endl;
+    os << endl;
+    os << "Options:" << endl;
+    os << "     --width <n> : The width of the image to render, in pixels. Default: 800." << endl;
+    os << "     --height <n> : The height of the image to render, in pixels. Default: 600." << endl;
+    os << "     --threads <n> : The number of threads to render with, or the most to try with --benchmark. Default: the number of cores." << endl;
+    os << "     --frames <n> : The number of frames to render (per number of threads with --benchmark). Default: 1, or 20 with --benchmark." << endl;
+    os << "     --output <file> : The .png file to write the last rendered frame to, or an empty string to not write it. Default: frame.png." << endl;
+    os << "     --benchmark : Renders the scene with 1, 2, 4, ... up to --threads threads, and reports the triangles per second of each." << endl;
+    os << endl;
+}
+
+/* Parses the given value of the given option as an unsigned integer in the given (inclusive) range. Exits the program with an error if that fails. */
+static uint32_t parse_uint(const std::string& option, const std::string& value, uint32_t min, uint32_t max) {
+    // Try to parse the value
+    unsigned long ivalue;
+    try {
+        size_t n_parsed;
+        ivalue = std::stoul(value, &n_parsed);
+        if (n_parsed != value.size()) { throw std::invalid_argument("trailing characters"); }
+    } catch (std::exception&) {
+        cerr << "Value '" << value << "' for option '" << option << "' is not a valid unsigned integer." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Check if it's in range
+    if (ivalue < min || ivalue > max) {
+        cerr << "Value '" << value << "' for option '" << option << "' should be between " << min << " and " << max << "." << endl;
+        exit(EXIT_FAILURE);
+    }
+    return static_cast<uint32_t>(ivalue);
+}
+
+/* Returns whether the given long option is the option with the given name that takes a value. If so, the value is either taken from after the '=' or from the next argument. */
+static bool match_option(const std::string& option, const std::string& name, int argc, const char** argv, int& i, std::string& value) {
+    if (option == name) {
+        if (i >= argc - 1) {
+            cerr << "Missing value for option '--" << name << "'." << endl;
+            exit(EXIT_FAILURE);
+        }
+        value = argv[++i];
+        return true;
+    } else if (option.size() > name.size() && option.substr(0, name.size() + 1) == name + '=') {
+        value = option.substr(name.size() + 1);
+        return true;
+    }
+    return false;
+}
+
+/* Parses the given arguments, populating the given Settings struct. */
+static void parse_args(Options& opts, int argc, const char** argv) {
+    // Start parsin'
+    bool accept_options = true;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        // Check if it begins with a stripe
+        if (accept_options && arg[0] == '-') {
+            // It's either shortoption or a long option
+            if (arg[1] == '-') {
+                // Longoption
+                std::string option = arg + 2;
+                std::string value;
+                if (option.empty()) {
+                    // It's the empty option; from now on, no more options
+                    accept_options = false;
+
+                } else if (match_option(option, "width", argc, argv, i, value)) {
+                    opts.width = parse_uint("width", value, 1, 16384);
+
+                } else if (match_option(option, "height", argc, argv, i, value)) {
+                    opts.height = parse_uint("height", value, 1, 16384);
+
+                } else if (match_option(option, "threads", argc, argv, i, value)) {
+                    opts.n_threads = parse_uint("threads", value, 1, 256);
+
+                } else if (match_option(option, "frames", argc, argv, i, value)) {
+                    opts.n_frames = parse_uint("frames", value, 1, std::numeric_limits<uint32_t>::max());
+
+                } else if (match_option(option, "output", argc, argv, i, value)) {
+                    opts.output_path = value;
+
+                } else if (option == "benchmark") {
+                    opts.benchmark = true;
+
+                } else if (option == "help") {
+                    // Print the help string!
+                    print_help(cout, argv[0]);
+                    exit(EXIT_SUCCESS);
+
+                } else {
+                    // Iwwegal option
+                    cerr << "Unknown option '" << option << "'." << endl;
+                    cerr << "Use '" << argv[0] << " -h' to see all options." << endl;
+                    exit(EXIT_FAILURE);
+
+                }
+
+            } else {
+                switch(arg[1]) {
+                    case 'h':
+                        // Print the help string!
+                        print_help(cout, argv[0]);
+                        exit(EXIT_SUCCESS);
+
+                    default:
+                        // Iwwegal option
+                        cerr << "Unknown option '" << arg[1] << "'." << endl;
+                        cerr << "Use '" << argv[0] << " -h' to see all options." << endl;
+                        exit(EXIT_FAILURE);
+                }
+            }
+        }
+    }
+
+    // Fill in the frames if they weren't given
+    if (opts.n_frames == 0) { opts.n_frames = opts.benchmark ? 20 : 1; }
+}
+
+/* Computes the transformation matrix of a model at the given position, rotation and scale, the same way the WorldSystem does. */
+static glm::mat4 compute_transform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+    glm::mat4 result(1.0f);
+    result = glm::translate(result, position);
+    result = glm::rotate(result, rotation[0], glm::vec3(1.0, 0.0, 0.0));
+    result = glm::rotate(result, rotation[1], glm::vec3(0.0, 1.0, 0.0));
+    result = glm::rotate(result, rotation[2], glm::vec3(0.0, 0.0, 1.0));
+    result = glm::scale(result, scale);
+    return result;
+}
+
+/* Renders the given scene the given number of times with the given rasterizer, as seen by the given camera. Returns the average time per frame, in milliseconds. */
+static double render_scene(Software::Rasterizer& rasterizer, const Tools::Array<SceneObject>& scene, const glm::mat4& proj, const glm::mat4& view, uint32_t n_frames) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n_frames; i++) {
+        rasterizer.begin(proj, view);
+        for (uint32_t j = 0; j < scene.size(); j++) {
+            rasterizer.draw(scene[j].model, scene[j].transform);
+        }
+        rasterizer.end();
+    }
+    return chrono::duration<double, std::milli>(chrono::steady_clock::now() - start).count() / (double) n_frames;
+}
+
+/* Returns whether the framebuffers of the two given rasterizers (of the same size) are the same. */
+static bool same_image(const Software::Rasterizer& r1, const Software::Rasterizer& r2) {
+    for (uint32_t y = 0; y < r1.height(); y++) {
+        for (uint32_t x = 0; x < r1.width(); x++) {
+            if (r1.pixel(x, y) != r2.pixel(x, y)) { return false; }
+        }
+    }
+    return true;
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main(int argc, const char** argv) {
+    try {
+        // Parse the arguments
+        Options opts;
+        parse_args(opts, argc, argv);
+
+        // Update the logger with the correct verbosity
+        logger.set_thread_name("main");
+        logger.set_verbosity(Verbosity::important);
+
+        // Indicate that we're starting
+        logger.log(Verbosity::important, "Starting software rasterizer on ", logger.get_start_time());
+        logger.log(Verbosity::important, "Running from '", Tools::get_executable_path(), "'...");
+
+        // Load the same scene as the rasterizer
+        Software::AssetPool asset_pool;
+        Tools::Array<SceneObject> scene(4);
+        scene.resize(4);
+        asset_pool.load_model(scene[0].model, "data/models/viking_room.obj", Models::ModelFormat::obj);
+        scene[0].transform = compute_transform({ 0.0f, 0.0f, 0.0f }, { 0.5f * M_PI, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+        asset_pool.load_model(scene[1].model, "triangle", Models::ModelFormat::triangle);
+        scene[1].transform = compute_transform({ -3.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+        asset_pool.load_model(scene[2].model, "data/models/watermill.obj", Models::ModelFormat::obj);
+        scene[2].transform = compute_transform({ 3.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+        asset_pool.load_model(scene[3].model, "data/models/capsule.obj", Models::ModelFormat::obj);
+        scene[3].transform = compute_transform({ 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+
+        // Prepare the same camera as the WorldSystem would (note that it passes the field-of-view to glm as-is)
+        glm::mat4 proj = glm::perspective(45.0f, (float) opts.width / (float) opts.height, 0.001f, 10.0f);
+        proj[1][1] *= -1;
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+
+        if (!opts.benchmark) {
+            // Simply render the frames with the given number of threads
+            Software::Rasterizer rasterizer(opts.width, opts.height, opts.n_threads);
+            double frame_time = render_scene(rasterizer, scene, proj, view, opts.n_frames);
+            const Software::RasterStats& stats = rasterizer.stats();
+            logger.log(Verbosity::important, "Rendered ", opts.n_frames, " frame(s) in ", frame_time, "ms each (", stats.n_triangles, " triangles, of which ", stats.n_binned, " binned; transform ", stats.transform_time, "ms, bin ", stats.bin_time, "ms, raster ", stats.raster_time, "ms).");
+            if (!opts.output_path.empty()) {
+                logger.log(Verbosity::important, "Writing frame to '", opts.output_path, "'...");
+                rasterizer.write_png(opts.output_path);
+            }
+
+        } else {
+            // Render the scene with a single thread first, which the others should match exactly
+            logger.log(Verbosity::important, "Benchmarking with up to ", opts.n_threads, " threads, ", opts.n_frames, " frames each...");
+            Software::Rasterizer reference(opts.width, opts.height, 1);
+            render_scene(reference, scene, proj, view, 1);
+
+            // Then try more and more threads
+            double single_time = 0.0;
+            cout << endl << "threads | ms/frame | transform | bin      | raster   | Mtris/s  | speedup" << endl;
+            for (uint32_t n_threads = 1; n_threads <= opts.n_threads; n_threads = (n_threads * 2 > opts.n_threads && n_threads < opts.n_threads) ? opts.n_threads : n_threads * 2) {
+                Software::Rasterizer rasterizer(opts.width, opts.height, n_threads);
+                render_scene(rasterizer, scene, proj, view, 1);
+                double frame_time = render_scene(rasterizer, scene, proj, view, opts.n_frames);
+                if (n_threads == 1) { single_time = frame_time; }
+
+                // Report the results
+                const Software::RasterStats& stats = rasterizer.stats();
+                char line[128];
+                snprintf(line, sizeof(line), "%7u | %8.3f | %9.3f | %8.3f | %8.3f | %8.3f | %6.2fx", n_threads, frame_time, stats.transform_time, stats.bin_time, stats.raster_time, (double) stats.n_triangles / (frame_time * 1000.0), single_time / frame_time);
+                cout << line << endl;
+                if (!same_image(reference, rasterizer)) {
+                    logger.warning("The frame rendered with ", n_threads, " threads differs from the one rendered with a single thread.");
+                }
+
+                // Write the last one, if asked to
+                if (n_threads == opts.n_threads && !opts.output_path.empty()) {
+                    rasterizer.write_png(opts.output_path);
+                }
+            }
+            cout << endl;
+        }
+
+    } catch (Tools::Logger::Fatal&) {
+        // Do nothing, the debugger already handled it
+        return EXIT_FAILURE;
+
+    } catch (std::exception& e) {
+        // Otherwise, print the error and return
+        logger.error(e.what());
+        return EXIT_FAILURE;
+    }
+
+    // We're done
+    return EXIT_SUCCESS;
+}
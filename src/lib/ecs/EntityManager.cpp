@@ -4,7 +4,7 @@
  * Created:
  *   18/07/2021, 15:49:49
  * Last edited:
- *   10/09/2021, 17:21:11
+ *   19/10/2026, 02:53:26
  * Auto updated?
  *   Yes
  *
@@ -27,7 +27,10 @@ EntityManager::EntityManager() :
     transforms(ComponentFlags::transform),
     models(ComponentFlags::model),
     controllables(ComponentFlags::controllable),
-    cameras(ComponentFlags::camera)
+    cameras(ComponentFlags::camera),
+    occluders(ComponentFlags::occluder),
+    lights(ComponentFlags::light),
+    emitters(ComponentFlags::emitter)
 {}
 
 
@@ -59,6 +62,15 @@ entity_t EntityManager::add(ComponentFlags components) {
     if (components & ComponentFlags::camera) {
         this->cameras.add(entity);
     }
+    if (components & ComponentFlags::occluder) {
+        this->occluders.add(entity);
+    }
+    if (components & ComponentFlags::light) {
+        this->lights.add(entity);
+    }
+    if (components & ComponentFlags::emitter) {
+        this->emitters.add(entity);
+    }
 
     // We're done; return the ID
     return entity;
@@ -85,6 +97,15 @@ void EntityManager::remove(entity_t entity) {
     if (components & ComponentFlags::camera) {
         this->cameras.remove(entity);
     }
+    if (components & ComponentFlags::occluder) {
+        this->occluders.remove(entity);
+    }
+    if (components & ComponentFlags::light) {
+        this->lights.remove(entity);
+    }
+    if (components & ComponentFlags::emitter) {
+        this->emitters.remove(entity);
+    }
 
     // Remove the entity from the manager itself
     this->entities.erase(entity);
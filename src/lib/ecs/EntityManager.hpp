@@ -4,7 +4,7 @@
  * Created:
  *   18/07/2021, 12:19:10
  * Last edited:
- *   10/09/2021, 17:19:31
+ *   19/10/2026, 02:53:26
  * Auto updated?
  *   Yes
  *
@@ -27,6 +27,9 @@
 #include "components/Model.hpp"
 #include "components/Controllable.hpp"
 #include "components/Camera.hpp"
+#include "components/Occluder.hpp"
+#include "components/Light.hpp"
+#include "components/Emitter.hpp"
 
 #include "Entity.hpp"
 
@@ -51,6 +54,12 @@ namespace Makma3D::ECS {
         ComponentList<Controllable> controllables;
         /* The Camera components of all entities. */
         ComponentList<Camera> cameras;
+        /* The Occluder components of all entities. */
+        ComponentList<Occluder> occluders;
+        /* The Light components of all entities. */
+        ComponentList<Light> lights;
+        /* The Emitter components of all entities. */
+        ComponentList<Emitter> emitters;
 
     public:
         /* Constructor for the EntityManager class. */
@@ -114,6 +123,18 @@ namespace Makma3D::ECS {
     template <> inline Camera& EntityManager::get_component<Camera>(entity_t entity) { return this->cameras.get(entity); }
     /* Returns a immuteable reference to the Camera component of the given entity. Does not perform any checks on whether or not the entity has the given component. */
     template <> inline const Camera& EntityManager::get_component<Camera>(entity_t entity) const { return this->cameras.get(entity); }
+    /* Returns a muteable reference to the Occluder component of the given entity. Does not perform any checks on whether or not the entity has the given component. */
+    template <> inline Occluder& EntityManager::get_component<Occluder>(entity_t entity) { return this->occluders.get(entity); }
+    /* Returns a immuteable reference to the Occluder component of the given entity. Does not perform any checks on whether or not the entity has the given component. */
+    template <> inline const Occluder& EntityManager::get_component<Occluder>(entity_t entity) const { return this->occluders.get(entity); }
+    /* Returns a muteable reference to the Light component of the given entity. Does not perform any checks on whether or not the entity has the given component. */
+    template <> inline Light& EntityManager::get_component<Light>(entity_t entity) { return this->lights.get(entity); }
+    /* Returns a immuteable reference to the Light component of the given entity. Does not perform any checks on whether or not the entity has the given component. */
+    template <> inline const Light& EntityManager::get_component<Light>(entity_t entity) const { return this->lights.get(entity); }
+    /* Returns a muteable reference to the Emitter component of the given entity. Does not perform any checks on whether or not the entity has the given component. */
+    template <> inline Emitter& EntityManager::get_component<Emitter>(entity_t entity) { return this->emitters.get(entity); }
+    /* Returns a immuteable reference to the Emitter component of the given entity. Does not perform any checks on whether or not the entity has the given component. */
+    template <> inline const Emitter& EntityManager::get_component<Emitter>(entity_t entity) const { return this->emitters.get(entity); }
 
     /* Returns a muteable reference to the component list itself so that it can be iterated over. */
     template <> inline ComponentList<Transform>& EntityManager::get_list<Transform>() { return this->transforms; }
@@ -131,6 +152,18 @@ namespace Makma3D::ECS {
     template <> inline ComponentList<Camera>& EntityManager::get_list<Camera>() { return this->cameras; }
     /* Returns an immuteable reference to the component list itself so that it can be iterated over. */
     template <> inline const ComponentList<Camera>& EntityManager::get_list<Camera>() const { return this->cameras; }
+    /* Returns a muteable reference to the component list itself so that it can be iterated over. */
+    template <> inline ComponentList<Occluder>& EntityManager::get_list<Occluder>() { return this->occluders; }
+    /* Returns an immuteable reference to the component list itself so that it can be iterated over. */
+    template <> inline const ComponentList<Occluder>& EntityManager::get_list<Occluder>() const { return this->occluders; }
+    /* Returns a muteable reference to the component list itself so that it can be iterated over. */
+    template <> inline ComponentList<Light>& EntityManager::get_list<Light>() { return this->lights; }
+    /* Returns an immuteable reference to the component list itself so that it can be iterated over. */
+    template <> inline const ComponentList<Light>& EntityManager::get_list<Light>() const { return this->lights; }
+    /* Returns a muteable reference to the component list itself so that it can be iterated over. */
+    template <> inline ComponentList<Emitter>& EntityManager::get_list<Emitter>() { return this->emitters; }
+    /* Returns an immuteable reference to the component list itself so that it can be iterated over. */
+    template <> inline const ComponentList<Emitter>& EntityManager::get_list<Emitter>() const { return this->emitters; }
 
 }
 
@@ -4,7 +4,7 @@
  * Created:
  *   06/08/2021, 13:17:30
  * Last edited:
- *   07/08/2021, 15:21:59
+ *   19/10/2026, 02:41:16
  * Auto updated?
  *   Yes
  *
@@ -32,6 +32,8 @@ namespace Makma3D::ECS {
         glm::mat4 proj;
         /* The view matrix for the camera. */
         glm::mat4 view;
+        /* The part of the window the camera renders to, as the x, y, width & height in fractions of the window's size. */
+        glm::vec4 viewport;
     };
 
     /* Hash function for the Camera struct, which returns its 'hash' code. */
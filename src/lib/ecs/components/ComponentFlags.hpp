@@ -4,7 +4,7 @@
  * Created:
  *   18/07/2021, 15:32:11
  * Last edited:
- *   10/09/2021, 17:18:29
+ *   19/10/2026, 02:53:26
  * Auto updated?
  *   Yes
  *
@@ -36,7 +36,13 @@ namespace Makma3D::ECS {
             /* The Camera component, which means the entity defines some camera through which we can render the scene. */
             camera = 0x4,
             /* The Controllable component, which means the entity can listen to mouse/keyboard input. */
-            controllable = 0x8
+            controllable = 0x8,
+            /* The Occluder component, which means the entity hides other entities behind it when culling on the CPU. */
+            occluder = 0x10,
+            /* The Light component, which means the entity is a point light that lights the entities around it. */
+            light = 0x20,
+            /* The Emitter component, which means the entity spawns particles around it. */
+            emitter = 0x40
 
         };
     };
@@ -51,7 +57,10 @@ namespace Makma3D::ECS {
         { ComponentFlags::transform,    "transform" },
         { ComponentFlags::model,        "model" },
         { ComponentFlags::camera,       "camera" },
-        { ComponentFlags::controllable, "controllable" }
+        { ComponentFlags::controllable, "controllable" },
+        { ComponentFlags::occluder,     "occluder" },
+        { ComponentFlags::light,        "light" },
+        { ComponentFlags::emitter,      "emitter" }
     };
 
 }
@@ -0,0 +1,58 @@
+/* EMITTER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:50:17
+ * Last edited:
+ *   19/10/2026, 02:50:17
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Defines the Emitter component, which turns an entity into a source of
+ *   particles that are simulated on the GPU. Its position is defined by
+ *   the Transform component.
+**/
+
+#ifndef ECS_EMITTER_HPP
+#define ECS_EMITTER_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "../auxillary/ComponentHash.hpp"
+#include "tools/Typenames.hpp"
+
+namespace Makma3D::ECS {
+    /* The Emitter component, which allows an entity to continuously spawn particles around it. */
+    struct Emitter {
+        /* The velocity with which the particles leave the emitter. */
+        glm::vec3 velocity;
+        /* The largest random speed added to that velocity, in any direction. */
+        float speed_spread;
+        /* The (linear) colour of the particles. */
+        glm::vec3 colour;
+        /* The number of particles spawned per second. */
+        float rate;
+        /* The number of seconds each particle lives. */
+        float lifetime;
+        /* The half-size of each particle's billboard. */
+        float size;
+        /* The radius of the sphere around the emitter in which particles spawn. */
+        float radius;
+    };
+
+    /* Hash function for the Emitter struct, which returns its 'hash' code. */
+    template <> inline constexpr uint32_t hash_component<Emitter>() { return 6; }
+
+}
+
+
+
+namespace Tools {
+    /* The string name of the Emitter component. */
+    template <> inline constexpr const char* type_name<Makma3D::ECS::Emitter>() { return "ECS::Emitter"; }
+}
+
+#endif
@@ -0,0 +1,50 @@
+/* LIGHT.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Defines the Light component, which turns an entity into a point light
+ *   that lights the materials around it. Its position is defined by the
+ *   Transform component.
+**/
+
+#ifndef ECS_LIGHT_HPP
+#define ECS_LIGHT_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "../auxillary/ComponentHash.hpp"
+#include "tools/Typenames.hpp"
+
+namespace Makma3D::ECS {
+    /* The Light component, which allows an entity to light the entities around it like a point light. */
+    struct Light {
+        /* The (linear) colour of the light. */
+        glm::vec3 colour;
+        /* The intensity with which the light shines, which simply scales its colour. */
+        float intensity;
+        /* The distance beyond which the light doesn't reach anything. */
+        float radius;
+    };
+
+    /* Hash function for the Light struct, which returns its 'hash' code. */
+    template <> inline constexpr uint32_t hash_component<Light>() { return 5; }
+
+}
+
+
+
+namespace Tools {
+    /* The string name of the Light component. */
+    template <> inline constexpr const char* type_name<Makma3D::ECS::Light>() { return "ECS::Light"; }
+}
+
+#endif
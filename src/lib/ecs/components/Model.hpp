@@ -4,7 +4,7 @@
  * Created:
  *   10/09/2021, 16:59:44
  * Last edited:
- *   10/09/2021, 17:06:30
+ *   19/10/2026, 01:52:32
  * Auto updated?
  *   Yes
  *
@@ -18,6 +18,7 @@
 
 #include <string>
 
+#include "glm/glm.hpp"
 #include "tools/Typenames.hpp"
 #include "tools/Array.hpp"
 #include "rendering/memory/Buffer.hpp"
@@ -26,12 +27,18 @@
 namespace Makma3D::ECS {
     /* Helper struct for the Model component, which contains data about a single mesh for the Model. */
     struct Mesh {
-        /* List of indices to render for this mesh. */
+        /* The (shared) index buffer where this mesh' indices live. */
         const Rendering::Buffer* indices;
+        /* The index of the first index of this mesh in the shared index buffer. */
+        uint32_t first_index;
         /* The number of indices to render. */
         uint32_t n_indices;
+        /* The offset that is added to each index before it's used to lookup a vertex in the shared vertex buffer. */
+        int32_t vertex_offset;
         /* The material for this mesh. */
         const Materials::Material* material;
+        /* The bounding sphere of the mesh in model space, as the centre in xyz and the radius in w. */
+        glm::vec4 bounds;
 
         /* Name for this Mesh (only used for debugging). */
         std::string name;
@@ -42,8 +49,12 @@ namespace Makma3D::ECS {
 
     /* The Model component, which contains everything needed to render all meshes of an entity. */
     struct Model {
-        /* All vertices belonging to this Model. Because we sort everything by Vertex, also includes normal and texel coordinates. */
-        Rendering::Buffer* vertices;
+        /* The (shared) vertex buffer where the positions of the vertices of this Model live. */
+        const Rendering::Buffer* positions;
+        /* The (shared) vertex buffer where the other attributes of the vertices of this Model live (such as colours and texel coordinates), at the same indices as the positions. */
+        const Rendering::Buffer* attributes;
+        /* The index of the first vertex of this Model in the shared vertex buffer. */
+        uint32_t first_vertex;
         /* The number of vertices in this Model. */
         uint32_t n_vertices;
 
@@ -0,0 +1,49 @@
+/* OCCLUDER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Defines the Occluder component, which marks an entity as something
+ *   that hides other entities behind it. Keeps a copy of its geometry on
+ *   the CPU, so that it can be rasterized by the OcclusionCuller.
+**/
+
+#ifndef ECS_OCCLUDER_HPP
+#define ECS_OCCLUDER_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "../auxillary/ComponentHash.hpp"
+#include "tools/Typenames.hpp"
+#include "tools/Array.hpp"
+
+namespace Makma3D::ECS {
+    /* The Occluder component, which allows an entity to hide other entities behind it when culling on the CPU. */
+    struct Occluder {
+        /* The positions of the occluder's vertices, in model space. */
+        Tools::Array<glm::vec3> vertices;
+        /* The occluder's triangles, as indices into its vertices. */
+        Tools::Array<uint32_t> indices;
+    };
+
+    /* Hash function for the Occluder struct, which returns its 'hash' code. */
+    template <> inline constexpr uint32_t hash_component<Occluder>() { return 4; }
+
+}
+
+
+
+namespace Tools {
+    /* The string name of the Occluder component. */
+    template <> inline constexpr const char* type_name<Makma3D::ECS::Occluder>() { return "ECS::Occluder"; }
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   29/09/2021, 12:52:49
  * Last edited:
- *   29/09/2021, 12:52:49
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
@@ -23,7 +23,9 @@ using namespace Makma3D::Materials;
 /* Constructor for the Material class, which takes its type and its name. */
 Material::Material(MaterialType type, const std::string& name) :
     _type(type),
-    _name(name)
+    _name(name),
+    _id(0),
+    _version(0)
 {}
 
 /* Destructor for the Material class, which is virtual but private. */
@@ -4,7 +4,7 @@
  * Created:
  *   09/09/2021, 16:46:02
  * Last edited:
- *   09/09/2021, 16:46:02
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
@@ -30,6 +30,10 @@ namespace Makma3D::Materials {
         MaterialType _type;
         /* The name of the Material (used for debugging). */
         std::string _name;
+        /* The ID of the Material, which is assigned by the MaterialPool and stays the same for as long as the Material lives. Freed IDs are re-used. */
+        uint32_t _id;
+        /* The version of the pool at which the Material was last allocated or modified, which tells the renderer whether it has to upload it again. */
+        uint64_t _version;
 
     protected:
         /* Constructor for the Material class, which takes its type and its name. */
@@ -50,6 +54,10 @@ namespace Makma3D::Materials {
         inline MaterialType type() const { return this->_type; }
         /* Returns the Material's name. */
         inline const std::string& name() const { return this->_name; }
+        /* Returns the Material's ID, which is its index in the material buffer on the GPU. */
+        inline uint32_t id() const { return this->_id; }
+        /* Returns the version of the pool at which the Material was last allocated or modified. */
+        inline uint64_t version() const { return this->_version; }
 
         /* Copy assignment operator for the Material class, which is deleted. */
         Material& operator=(const Material& other) = delete;
@@ -4,7 +4,7 @@
  * Created:
  *   09/09/2021, 16:32:42
  * Last edited:
- *   9/20/2021, 10:52:48 PM
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
@@ -31,7 +31,9 @@ using namespace Makma3D::Rendering;
 /***** MATERIALPOOL CLASS *****/
 /* Constructor for the MaterialPool class, which takes a TexturePool to allocate textures with. */
 MaterialPool::MaterialPool(Materials::TexturePool& texture_pool) :
-    texture_pool(texture_pool)
+    texture_pool(texture_pool),
+    n_ids(0),
+    _version(0)
 {
     logger.logc(Verbosity::important, MaterialPool::channel, "Initializing...");
 
@@ -51,7 +53,11 @@ MaterialPool::MaterialPool(MaterialPool&& other) :
     _default(std::move(other._default)),
     simple(std::move(other.simple)),
     simple_coloured(std::move(other.simple_coloured)),
-    simple_textured(std::move(other.simple_textured))
+    simple_textured(std::move(other.simple_textured)),
+
+    n_ids(other.n_ids),
+    free_ids(std::move(other.free_ids)),
+    _version(other._version)
 {
     other.simple.clear();
     other.simple_coloured.clear();
@@ -90,27 +96,41 @@ MaterialPool::~MaterialPool() {
 
 
 
-/* Initializes given DescriptorSetLayout with everything needed for materials. */
+/* Private helper function that gives the given, newly allocated material an ID and stamps it with a new version. */
+void MaterialPool::_register(Materials::Material* material) {
+    // Re-use a freed ID if there is one, so the IDs stay as compact as possible
+    if (!this->free_ids.empty()) {
+        material->_id = this->free_ids[this->free_ids.size() - 1];
+        this->free_ids.pop_back();
+    } else {
+        material->_id = this->n_ids++;
+    }
+
+    // A new version makes sure it's uploaded, even if its ID belonged to another material before
+    material->_version = ++this->_version;
+}
+
+
+
+/* Initializes given DescriptorSetLayout with everything needed for materials. Their parameters live in the material buffer, so that's only the texture of textured materials. */
 void MaterialPool::init_layout(Rendering::DescriptorSetLayout& descriptor_set_layout) {
-    descriptor_set_layout.add_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
-    descriptor_set_layout.add_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
     descriptor_set_layout.add_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
     descriptor_set_layout.finalize();
 }
 
 
 
-/* Modifies the pipeline constructor based on the given MaterialType. The shader pool is used to allocate new shaders, unless those shaders are already allocated. As little properties as possible are changed. */
-void MaterialPool::init_props(MaterialType material_type, Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor) {
+/* Modifies the pipeline constructor based on the given MaterialType. The shader pool is used to allocate new shaders, unless those shaders are already allocated. If multiview is true, uses the shaders that render all views of the render pass at once. If bindless is true, textured materials use the shaders that find their texture in the array of all textures. As little properties as possible are changed. */
+void MaterialPool::init_props(MaterialType material_type, Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview, bool bindless) {
     switch (material_type) {
         case MaterialType::simple:
-            return MaterialPool::init_props_simple(shader_pool, pipeline_constructor);
+            return MaterialPool::init_props_simple(shader_pool, pipeline_constructor, multiview);
 
         case MaterialType::simple_coloured:
-            return MaterialPool::init_props_simple_coloured(shader_pool, pipeline_constructor);
+            return MaterialPool::init_props_simple_coloured(shader_pool, pipeline_constructor, multiview);
         
         case MaterialType::simple_textured:
-            return MaterialPool::init_props_simple_textured(shader_pool, pipeline_constructor);
+            return MaterialPool::init_props_simple_textured(shader_pool, pipeline_constructor, multiview, bindless);
         
         default:
             logger.fatalc(MaterialPool::channel, "Cannot return properties of unknown material type '", material_type_names[(int) material_type], '\'');
@@ -118,27 +138,27 @@ void MaterialPool::init_props(MaterialType material_type, Rendering::ShaderPool&
     }
 }
 
-/* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the Simple material. The shaders are allocated with the given ShaderPool. As little properties as possible are changed. */
-void MaterialPool::init_props_simple(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor) {
+/* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the Simple material. The shaders are allocated with the given ShaderPool. If multiview is true, uses the shaders that render all views of the render pass at once. As little properties as possible are changed. */
+void MaterialPool::init_props_simple(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview) {
     // Load the shaders to use
     Tools::Array<ShaderStage> shaders(2);
     shaders.push_back(ShaderStage(
-        shader_pool.allocate("shaders/materials/simple_vert.spv"),
+        shader_pool.allocate(multiview ? "shaders/materials/simple_multiview_vert.spv" : "shaders/materials/simple_vert.spv"),
         VK_SHADER_STAGE_VERTEX_BIT,
         {}
     ));
     shaders.push_back(ShaderStage(
-        shader_pool.allocate("shaders/materials/simple_frag.spv"),
+        shader_pool.allocate(multiview ? "shaders/materials/simple_multiview_frag.spv" : "shaders/materials/simple_frag.spv"),
         VK_SHADER_STAGE_FRAGMENT_BIT,
         {}
     ));
 
     // Set the pipeline shaders
     pipeline_constructor.shaders = shaders;
-    // Set the pipeline input vertex attributes
+    // Set the pipeline input vertex attributes, which come from the position and attribute streams
     pipeline_constructor.vertex_input_state = VertexInputState(
-        { VertexBinding(0, sizeof(Vertex)) },
-        { VertexAttribute(0, 0, offsetof(Vertex, pos), VK_FORMAT_R32G32B32_SFLOAT), VertexAttribute(0, 1, offsetof(Vertex, colour), VK_FORMAT_R32G32B32_SFLOAT) }
+        { VertexBinding(position_binding, sizeof(glm::vec3)), VertexBinding(attribute_binding, sizeof(VertexAttributes)) },
+        { VertexAttribute(position_binding, 0, 0, VK_FORMAT_R32G32B32_SFLOAT), VertexAttribute(attribute_binding, 1, offsetof(VertexAttributes, colour), VK_FORMAT_R32G32B32_SFLOAT) }
     );
     // Set the input assembly
     pipeline_constructor.input_assembly_state = InputAssemblyState(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
@@ -146,55 +166,59 @@ void MaterialPool::init_props_simple(Rendering::ShaderPool& shader_pool, Renderi
     // Done
 }
 
-/* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleColoured material. The shaders are allocated with the given ShaderPool. As little properties as possible are changed. */
-void MaterialPool::init_props_simple_coloured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor) {
+/* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleColoured material. The shaders are allocated with the given ShaderPool. If multiview is true, uses the shaders that render all views of the render pass at once. As little properties as possible are changed. */
+void MaterialPool::init_props_simple_coloured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview) {
     // Load the shaders to use
     Tools::Array<ShaderStage> shaders(2);
     shaders.push_back(ShaderStage(
-        shader_pool.allocate("shaders/materials/simple_coloured_vert.spv"),
+        shader_pool.allocate(multiview ? "shaders/materials/simple_coloured_multiview_vert.spv" : "shaders/materials/simple_coloured_vert.spv"),
         VK_SHADER_STAGE_VERTEX_BIT,
         {}
     ));
     shaders.push_back(ShaderStage(
-        shader_pool.allocate("shaders/materials/simple_coloured_frag.spv"),
+        shader_pool.allocate(multiview ? "shaders/materials/simple_coloured_multiview_frag.spv" : "shaders/materials/simple_coloured_frag.spv"),
         VK_SHADER_STAGE_FRAGMENT_BIT,
         {}
     ));
 
     // Set the pipeline shaders
     pipeline_constructor.shaders = shaders;
-    // Set the pipeline input vertex attributes
-    pipeline_constructor.vertex_input_state.vertex_attributes = {
-        VertexAttribute(0, 0, offsetof(Vertex, pos), VK_FORMAT_R32G32B32_SFLOAT)
-    };
+    // Set the pipeline input vertex attributes, which only need the position stream
+    pipeline_constructor.vertex_input_state = VertexInputState(
+        { VertexBinding(position_binding, sizeof(glm::vec3)) },
+        { VertexAttribute(position_binding, 0, 0, VK_FORMAT_R32G32B32_SFLOAT) }
+    );
     // Set the input assembly
     pipeline_constructor.input_assembly_state = InputAssemblyState(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
 
     // Done
 }
 
-/* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleTextured material. The shaders are allocated with the given ShaderPool. As little properties as possible are changed. */
-void MaterialPool::init_props_simple_textured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor) {
+/* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleTextured material. The shaders are allocated with the given ShaderPool. If multiview is true, uses the shaders that render all views of the render pass at once. If bindless is true, uses the fragment shader that finds the texture in the array of all textures through the material index in the push constants. As little properties as possible are changed. */
+void MaterialPool::init_props_simple_textured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview, bool bindless) {
     // Load the shaders to use
     Tools::Array<ShaderStage> shaders(2);
     shaders.push_back(ShaderStage(
-        shader_pool.allocate("shaders/materials/simple_textured_vert.spv"),
+        shader_pool.allocate(multiview ? "shaders/materials/simple_textured_multiview_vert.spv" : "shaders/materials/simple_textured_vert.spv"),
         VK_SHADER_STAGE_VERTEX_BIT,
         {}
     ));
     shaders.push_back(ShaderStage(
-        shader_pool.allocate("shaders/materials/simple_textured_frag.spv"),
+        shader_pool.allocate(std::string("shaders/materials/simple_textured") + (bindless ? "_bindless" : "") + (multiview ? "_multiview" : "") + "_frag.spv"),
         VK_SHADER_STAGE_FRAGMENT_BIT,
         {}
     ));
 
     // Set the pipeline shaders
     pipeline_constructor.shaders = shaders;
-    // Set the pipeline input vertex attributes
-    pipeline_constructor.vertex_input_state.vertex_attributes = {
-        VertexAttribute(0, 0, offsetof(Vertex, pos), VK_FORMAT_R32G32B32_SFLOAT),
-        VertexAttribute(0, 1, offsetof(Vertex, texel), VK_FORMAT_R32G32_SFLOAT)
-    };
+    // Set the pipeline input vertex attributes, which come from the position and attribute streams
+    pipeline_constructor.vertex_input_state = VertexInputState(
+        { VertexBinding(position_binding, sizeof(glm::vec3)), VertexBinding(attribute_binding, sizeof(VertexAttributes)) },
+        {
+            VertexAttribute(position_binding, 0, 0, VK_FORMAT_R32G32B32_SFLOAT),
+            VertexAttribute(attribute_binding, 1, offsetof(VertexAttributes, texel), VK_FORMAT_R32G32_SFLOAT)
+        }
+    );
     // Set the input assembly
     pipeline_constructor.input_assembly_state = InputAssemblyState(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
 
@@ -215,6 +239,7 @@ Materials::Simple* MaterialPool::allocate_simple(const std::string& name) {
     
     // Create the Simple material and add it internally
     Simple* result = new Simple(name);
+    this->_register(result);
     this->simple.insert(result);
 
     #ifndef NDEBUG
@@ -238,6 +263,7 @@ Materials::SimpleColoured* MaterialPool::allocate_simple_coloured(const std::str
     
     // Create the SimpleColoured material
     SimpleColoured* result = new SimpleColoured(name, colour);
+    this->_register(result);
     this->simple_coloured.insert(result);
 
     #ifndef NDEBUG
@@ -264,6 +290,7 @@ Materials::SimpleTextured* MaterialPool::allocate_simple_textured(const std::str
     
     // Use that to create the SimpleTextured material
     SimpleTextured* result = new SimpleTextured(name, texture);
+    this->_register(result);
     this->simple_textured.insert(result);
 
     #ifndef NDEBUG
@@ -293,7 +320,8 @@ void MaterialPool::free(const Materials::Material* material) {
             this->names.erase(material->_name);
             #endif
 
-            // Destroy the material
+            // Destroy the material, after which its ID may be re-used
+            this->free_ids.push_back(simple->_id);
             delete simple;
 
             // Remove it from the list, done
@@ -315,7 +343,8 @@ void MaterialPool::free(const Materials::Material* material) {
             this->names.erase(material->_name);
             #endif
 
-            // Destroy the material
+            // Destroy the material, after which its ID may be re-used
+            this->free_ids.push_back(simple_coloured->_id);
             delete simple_coloured;
 
             // Remove it from the list, done
@@ -337,7 +366,8 @@ void MaterialPool::free(const Materials::Material* material) {
             this->names.erase(material->_name);
             #endif
 
-            // Destroy the material
+            // Destroy the material, after which its ID may be re-used
+            this->free_ids.push_back(simple_textured->_id);
             this->texture_pool.free(simple_textured->texture);
             delete simple_textured;
 
@@ -353,6 +383,11 @@ void MaterialPool::free(const Materials::Material* material) {
 
 }
 
+/* Marks the given Material as modified, which should be done after changing its properties so the renderer uploads them again. */
+void MaterialPool::modify(Materials::Material* material) {
+    material->_version = ++this->_version;
+}
+
 
 
 /* Swap operator for the MaterialPool class. */
@@ -371,4 +406,8 @@ void Materials::swap(MaterialPool& ms1, MaterialPool& ms2) {
     swap(ms1.simple, ms2.simple);
     swap(ms1.simple_coloured, ms2.simple_coloured);
     swap(ms1.simple_textured, ms2.simple_textured);
+
+    swap(ms1.n_ids, ms2.n_ids);
+    swap(ms1.free_ids, ms2.free_ids);
+    swap(ms1._version, ms2._version);
 }
@@ -4,7 +4,7 @@
  * Created:
  *   09/09/2021, 16:28:57
  * Last edited:
- *   9/20/2021, 10:52:39 PM
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
@@ -61,6 +61,16 @@ namespace Makma3D::Materials {
         /* The list of SimpleTextured materials allocated in the pool. */
         std::unordered_set<Materials::SimpleTextured*> simple_textured;
 
+        /* The number of IDs handed out so far, i.e., one more than the largest ID in use. */
+        uint32_t n_ids;
+        /* The IDs of freed materials, which are handed out again before new ones. */
+        Tools::Array<uint32_t> free_ids;
+        /* The version of the pool, which goes up each time a material is allocated or modified. */
+        uint64_t _version;
+
+        /* Private helper function that gives the given, newly allocated material an ID and stamps it with a new version. */
+        void _register(Materials::Material* material);
+
     public:
         /* Constructor for the MaterialPool class, which takes a TexturePool to allocate textures with. */
         MaterialPool(Materials::TexturePool& texture_pool);
@@ -71,17 +81,17 @@ namespace Makma3D::Materials {
         /* Destructor for the MaterialPool. */
         ~MaterialPool();
 
-        /* Initializes given DescriptorSetLayout with everything needed for materials. */
+        /* Initializes given DescriptorSetLayout with everything needed for materials. Their parameters live in the material buffer, so that's only the texture of textured materials. */
         static void init_layout(Rendering::DescriptorSetLayout& descriptor_set_layout);
 
-        /* Modifies the pipeline constructor based on the given MaterialType. The shader pool is used to allocate new shaders, unless those shaders are already allocated. As little properties as possible are changed. */
-        static void init_props(MaterialType material_type, Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor);
-        /* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the Simple material. The shaders are allocated with the given ShaderPool. As little properties as possible are changed. */
-        static void init_props_simple(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor);
-        /* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleColoured material. The shaders are allocated with the given ShaderPool. As little properties as possible are changed. */
-        static void init_props_simple_coloured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor);
-        /* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleTextured material. The shaders are allocated with the given ShaderPool. As little properties as possible are changed. */
-        static void init_props_simple_textured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor);
+        /* Modifies the pipeline constructor based on the given MaterialType. The shader pool is used to allocate new shaders, unless those shaders are already allocated. If multiview is true, uses the shaders that render all views of the render pass at once. If bindless is true, textured materials use the shaders that find their texture in the array of all textures. As little properties as possible are changed. */
+        static void init_props(MaterialType material_type, Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview = false, bool bindless = false);
+        /* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the Simple material. The shaders are allocated with the given ShaderPool. If multiview is true, uses the shaders that render all views of the render pass at once. As little properties as possible are changed. */
+        static void init_props_simple(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview = false);
+        /* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleColoured material. The shaders are allocated with the given ShaderPool. If multiview is true, uses the shaders that render all views of the render pass at once. As little properties as possible are changed. */
+        static void init_props_simple_coloured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview = false);
+        /* Takes a PipelineConstructor and modifies the relevant properties so that it's suitable to render the SimpleTextured material. The shaders are allocated with the given ShaderPool. If multiview is true, uses the shaders that render all views of the render pass at once. If bindless is true, uses the fragment shader that finds the texture in the array of all textures through the material index in the push constants. As little properties as possible are changed. */
+        static void init_props_simple_textured(Rendering::ShaderPool& shader_pool, Rendering::PipelineConstructor& pipeline_constructor, bool multiview = false, bool bindless = false);
 
         /* Adds a new material to the pool that simply takes the vertex colours, no lighting applied. Only takes the name of that material. */
         Materials::Simple* allocate_simple(const std::string& name);
@@ -91,6 +101,8 @@ namespace Makma3D::Materials {
         Materials::SimpleTextured* allocate_simple_textured(const std::string& name, const std::string& path, VkFilter filter, VkBool32 enable_anisotropy, float max_anisotropy_level = 16.0f, TextureFormat format = TextureFormat::automatic);
         /* Frees the given Material again. */
         void free(const Materials::Material* material);
+        /* Marks the given Material as modified, which should be done after changing its properties so the renderer uploads them again. */
+        void modify(Materials::Material* material);
 
         /* Sets the default material for this pool. */
         inline void set_default(const Materials::Material* material) { this->_default = material; }
@@ -104,6 +116,11 @@ namespace Makma3D::Materials {
         /* Returns a constant reference to the internal set of SimpleTextured materials so they can be iterated over. */
         inline const std::unordered_set<Materials::SimpleTextured*>& get_simple_textured() const { return this->simple_textured; }
 
+        /* Returns the number of IDs handed out so far, i.e., one more than the largest ID of any material in the pool. */
+        inline uint32_t max_id() const { return this->n_ids; }
+        /* Returns the version of the pool, which goes up each time a material is allocated or modified. Materials with a larger version than a previous one of the pool have changed since. */
+        inline uint64_t version() const { return this->_version; }
+
         /* Returns the total number of materials registered in the MaterialSystem. */
         inline uint32_t size() const { return static_cast<uint32_t>(this->simple.size()) + static_cast<uint32_t>(this->simple_coloured.size()) + static_cast<uint32_t>(this->simple_textured.size()); } 
 
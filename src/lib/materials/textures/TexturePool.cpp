@@ -4,7 +4,7 @@
  * Created:
  *   16/08/2021, 11:49:36
  * Last edited:
- *   16/08/2021, 11:49:36
+ *   19/10/2026, 03:13:49
  * Auto updated?
  *   Yes
  *
@@ -119,7 +119,8 @@ TexturePool::TexturePool(Rendering::MemoryManager& memory_manager) :
 /* Move constructor for the TexturePool class. */
 TexturePool::TexturePool(TexturePool&& other) :
     memory_manager(other.memory_manager),
-    textures(std::move(other.textures))
+    textures(std::move(other.textures)),
+    free_callback(std::move(other.free_callback))
 {
     this->textures.clear();
 }
@@ -132,6 +133,9 @@ TexturePool::~TexturePool() {
     if (!this->textures.empty()) {
         logger.logc(Verbosity::details, TexturePool::channel, "Cleaning ", this->textures.size(), " textures...");
         for (const auto& p : this->textures) {
+            // Let anyone interested know the texture is going away
+            if (this->free_callback) { this->free_callback(p.second); }
+
             // Free the texture's structures
             vkDestroySampler(this->memory_manager.gpu, p.second->_sampler, nullptr);
             vkDestroyImageView(this->memory_manager.gpu, p.second->_view, nullptr);
@@ -230,6 +234,9 @@ void TexturePool::free(const Materials::Texture* texture) {
         logger.fatalc(TexturePool::channel, "Cannot free Texture '", texture->_name, "' that wasn't allocated with this pool.");
     }
 
+    // Let anyone interested know the texture is going away
+    if (this->free_callback) { this->free_callback(texture); }
+
     // Free the texture's structures
     vkDestroySampler(this->memory_manager.gpu, texture->_sampler, nullptr);
     vkDestroyImageView(this->memory_manager.gpu, texture->_view, nullptr);
@@ -254,4 +261,5 @@ void Materials::swap(TexturePool& tp1, TexturePool& tp2) {
     using std::swap;
 
     swap(tp1.textures, tp2.textures);
+    swap(tp1.free_callback, tp2.free_callback);
 }
@@ -4,7 +4,7 @@
  * Created:
  *   16/08/2021, 11:49:33
  * Last edited:
- *   9/19/2021, 5:56:37 PM
+ *   19/10/2026, 03:13:49
  * Auto updated?
  *   Yes
  *
@@ -18,6 +18,7 @@
 #define MATERIALS_TEXTURE_POOL_HPP
 
 #include <unordered_map>
+#include <functional>
 
 #include "rendering/memory_manager/MemoryManager.hpp"
 
@@ -37,6 +38,8 @@ namespace Makma3D::Materials {
     private:
         /* The list of Textures that we allocated with this pool. */
         std::unordered_map<std::string, Materials::Texture*> textures;
+        /* Function called with each texture just before it's freed, if any. */
+        std::function<void(const Materials::Texture*)> free_callback;
 
     public:
         /* Constructor for the TexturePool class, which takes a reference to the MemoryManager from which we allocate buffers and images and junk. */
@@ -55,6 +58,8 @@ namespace Makma3D::Materials {
         Materials::Texture* allocate(const std::string& path, VkFilter filter, VkBool32 enable_anisotropy, float max_anisotropy_level = 16.0f, TextureFormat format = TextureFormat::automatic);
         /* Destroys the given texture, freeing memory again. */
         void free(const Materials::Texture* texture);
+        /* Registers a function that is called with each texture just before it's freed, so that anything referring to it can forget about it. Replaces any previous function; pass nullptr to remove it. */
+        inline void on_free(std::function<void(const Materials::Texture*)>&& callback) { this->free_callback = std::move(callback); }
 
         /* Copy assignment operator for the TexturePool class, which is deleted. */
         TexturePool& operator=(const TexturePool& other) = delete;
@@ -4,28 +4,36 @@
  * Created:
  *   20/09/2021, 14:44:05
  * Last edited:
- *   20/09/2021, 14:44:05
+ *   19/10/2026, 02:41:16
  * Auto updated?
  *   Yes
  *
  * Description:
- *   The fragment shader for the Simple material. Doesn't apply any
- *   lighting, but instead returns the colour as given by the vertex
- *   shader.
+ *   The fragment shader for the Simple material. Lights the colour as
+ *   given by the vertex shader with the point lights in the fragment's
+ *   cluster.
 **/
 
 #version 450
+#extension GL_GOOGLE_include_directive : require
+// Must come before any declarations, since it may enable the multiview extension
+#include "views.glsl"
 
 /* Memory layout */
 // The input is the color we get from the vertex shader
 layout(location = 0) in vec3 fragColor;
+// And the position in view space
+layout(location = 1) in vec3 frag_view_pos;
 // The output is the color to actually render
 layout(location = 0) out vec4 outColor;
 
+// The clustered lights
+#include "lighting.glsl"
+
 
 
 /* Entry point */
 void main() {
-    // Simply pass on
-    outColor = vec4(fragColor, 1.0);
+    // Light the colour
+    outColor = vec4(fragColor * compute_lighting(frag_view_pos), 1.0);
 }
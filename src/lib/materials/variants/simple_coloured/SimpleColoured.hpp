@@ -4,7 +4,7 @@
  * Created:
  *   29/09/2021, 12:57:31
  * Last edited:
- *   29/09/2021, 12:57:31
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
@@ -18,14 +18,13 @@
 #define MATERIALS_SIMPLE_COLOURED_HPP
 
 #include "glm/glm.hpp"
-#include "rendering/data/MaterialData.hpp"
 #include "../../Material.hpp"
 
 namespace Makma3D::Materials {
     /* The SimpleColoured class, which carries information needed for the similarly named material. */
     class SimpleColoured: public Materials::Material {
     public:
-        /* The colour of the SimpleColoured material. */
+        /* The colour of the SimpleColoured material. After changing it, MaterialPool::modify() has to be called for the renderer to pick it up. */
         glm::vec3 colour;
 
     private:
@@ -43,9 +42,6 @@ namespace Makma3D::Materials {
         /* Move constructor for the SimpleColoured class, which is deleted. */
         SimpleColoured(SimpleColoured&& other) = delete;
 
-        /* Returns the properties of the SimpleColoured material as a SimpleColouredData, so it can be transferred to the GPU. */
-        inline Rendering::SimpleColouredData data() const { return Rendering::SimpleColouredData({ this->colour }); }
-
         /* Copy assignment operator for the SimpleColoured class, which is deleted. */
         SimpleColoured& operator=(const SimpleColoured& other) = delete;
         /* Move assignment operator for the SimpleColoured class, which is deleted. */
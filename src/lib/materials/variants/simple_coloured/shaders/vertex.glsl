@@ -4,7 +4,7 @@
  * Created:
  *   20/09/2021, 14:42:44
  * Last edited:
- *   20/09/2021, 14:42:44
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
@@ -14,22 +14,22 @@
 **/
 
 #version 450
+#extension GL_GOOGLE_include_directive : require
+// Must come before any declarations, since it may enable the multiview extension
+#include "views.glsl"
 
 /* Memory layout */
 // We take a list of 3D positions of the points
 layout(location = 0) in vec3 vertex;
 // We drop the color of the vertex for the fragment shader
 layout(location = 0) out vec3 frag_color;
+// And the position of the vertex in view space, so the fragment shader can light it
+layout(location = 1) out vec3 frag_view_pos;
 
-// The camera data as a uniform buffer
-layout(set = 0, binding = 0) uniform Camera {
-    mat4 proj;
-    mat4 view;
-} camera;
-// The material data as a uniform buffer
-layout(set = 1, binding = 0) uniform Material {
-    vec3 color;
-} material;
+// The camera data of the view we're rendering
+#include "camera.glsl"
+// The material's colour is in the buffer with the parameters of all materials
+#include "materials.glsl"
 // The object data as a uniform buffer
 layout(set = 2, binding = 0) uniform Object {
     mat4 translation;
@@ -42,5 +42,7 @@ void main() {
     // Return the vertex as a 4D vertex
     gl_Position = camera.proj * camera.view * object.translation * vec4(vertex, 1.0);
     // Also return the color for the fragment shader
-    frag_color = material.color;
+    frag_color = materials.params[material.id].colour.rgb;
+    // And where it is in view space
+    frag_view_pos = vec3(camera.view * object.translation * vec4(vertex, 1.0));
 }
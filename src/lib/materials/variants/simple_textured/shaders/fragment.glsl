@@ -4,31 +4,48 @@
  * Created:
  *   20/09/2021, 14:44:05
  * Last edited:
- *   20/09/2021, 14:44:05
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
  * Description:
- *   The fragment shader for the SimpleTextured material. Doesn't apply any
- *   lighting, but instead returns the texture pixels associated with the with
- *   texel.
+ *   The fragment shader for the SimpleTextured material. Lights the
+ *   texture pixels associated with the texel with the point lights in the
+ *   fragment's cluster. When compiled with BINDLESS defined, finds the
+ *   texture in the array with all textures instead.
 **/
 
 #version 450
+#extension GL_GOOGLE_include_directive : require
+// Must come before any declarations, since it may enable the multiview extension
+#include "views.glsl"
 
 /* Memory layout */
 // The input is the texel we get from the vertex shader
 layout(location = 0) in vec2 frag_texel;
+// And the position in view space
+layout(location = 1) in vec3 frag_view_pos;
 // The output is the color to actually render
 layout(location = 0) out vec4 out_color;
 
+#ifdef BINDLESS
+// The texture is the one the material buffer points to
+#include "bindless.glsl"
+#define TEXTURE textures[materials.params[material.id].texture]
+#else
 // The image sampler for the texture
-layout(set = 1, binding = 2) uniform sampler2D texture_sampler;
+layout(set = 1, binding = 0) uniform sampler2D texture_sampler;
+#define TEXTURE texture_sampler
+#endif
+
+// The clustered lights
+#include "lighting.glsl"
 
 
 
 /* Entry point */
 void main() {
-    // Simply pass on
-    out_color = texture(texture_sampler, vec2(frag_texel.x, -frag_texel.y));
+    // Light the texture's colour, but leave its alpha as-is
+    vec4 colour = texture(TEXTURE, vec2(frag_texel.x, -frag_texel.y));
+    out_color = vec4(colour.rgb * compute_lighting(frag_view_pos), colour.a);
 }
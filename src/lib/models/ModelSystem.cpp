@@ -4,7 +4,7 @@
  * Created:
  *   01/07/2021, 14:09:32
  * Last edited:
- *   8/1/2021, 3:41:39 PM
+ *   19/10/2026, 02:01:52
  * Auto updated?
  *   Yes
  *
@@ -14,9 +14,11 @@
 **/
 
 #include <cstring>
+#include <limits>
 #include <algorithm>
 
 #include "tools/Logger.hpp"
+#include "tools/Profiler.hpp"
 #include "tools/Common.hpp"
 #include "rendering/auxillary/Index.hpp"
 #include "rendering/auxillary/Vertex.hpp"
@@ -33,49 +35,155 @@ using namespace Makma3D::Models;
 
 
 /***** MODELMANAGER CLASS *****/
-/* Constructor for the ModelSystem class, which takes a MemoryManager struct for the required memory pools and a material pool to possibly define new materials found in, for example, .obj files. */
-ModelSystem::ModelSystem(Rendering::MemoryManager& memory_manager, Materials::MaterialPool& material_pool) :
+/* Constructor for the ModelSystem class, which takes a MemoryManager struct for the required memory pools and a material pool to possibly define new materials found in, for example, .obj files. Optionally, the maximum number of vertices and indices that can be loaded at the same time can be given. */
+ModelSystem::ModelSystem(Rendering::MemoryManager& memory_manager, Materials::MaterialPool& material_pool, uint32_t max_vertices, uint32_t max_indices) :
     memory_manager(memory_manager),
-    material_pool(material_pool)
+    material_pool(material_pool),
+    vertex_allocator(max_vertices),
+    index_allocator(max_indices),
+    _generation(0)
 {
     logger.logc(Verbosity::important, ModelSystem::channel, "Initializing...");
 
-    // Nothing as of yet
+    // Allocate the shared geometry buffers on the GPU
+    logger.logc(Verbosity::details, ModelSystem::channel, "Allocating shared geometry buffers (", Tools::bytes_to_string(max_vertices * sizeof(glm::vec3)), " for positions, ", Tools::bytes_to_string(max_vertices * sizeof(Rendering::VertexAttributes)), " for other vertex attributes, ", Tools::bytes_to_string(max_indices * sizeof(Rendering::index_t)), " for indices)...");
+    this->_position_buffer = this->memory_manager.draw_pool.allocate(max_vertices * sizeof(glm::vec3), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    this->_attribute_buffer = this->memory_manager.draw_pool.allocate(max_vertices * sizeof(Rendering::VertexAttributes), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    this->_index_buffer = this->memory_manager.draw_pool.allocate(max_indices * sizeof(Rendering::index_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
 
     logger.logc(Verbosity::important, ModelSystem::channel, "Init success.");
 }
 
-/* Copy constructor for the ModelSystem class. */
-ModelSystem::ModelSystem(const ModelSystem& other) :
-    memory_manager(other.memory_manager),
-    material_pool(other.material_pool)
-{
-    logger.logc(Verbosity::debug, ModelSystem::channel, "Copying ModelSystem @ ", &other, "...");
-
-    // Nothing as of yet
-
-    logger.logc(Verbosity::debug, ModelSystem::channel, "Copy success.");
-}
-
 /* Move constructor for the ModelSystem class. */
 ModelSystem::ModelSystem(ModelSystem&& other) :
     memory_manager(other.memory_manager),
-    material_pool(other.material_pool)
-{}
+    material_pool(other.material_pool),
+    _position_buffer(other._position_buffer),
+    _attribute_buffer(other._attribute_buffer),
+    _index_buffer(other._index_buffer),
+    vertex_allocator(std::move(other.vertex_allocator)),
+    index_allocator(std::move(other.index_allocator)),
+    _generation(other._generation)
+{
+    // Make sure the other doesn't deallocate the buffers
+    other._position_buffer = nullptr;
+    other._attribute_buffer = nullptr;
+    other._index_buffer = nullptr;
+}
 
 /* Destructor for the ModelSystem class. */
 ModelSystem::~ModelSystem() {
     logger.logc(Verbosity::important, ModelSystem::channel, "Cleaning...");
 
-    // Nothing as of yet
+    // Deallocate the shared buffers
+    if (this->_index_buffer != nullptr) {
+        this->memory_manager.draw_pool.free(this->_index_buffer);
+    }
+    if (this->_attribute_buffer != nullptr) {
+        this->memory_manager.draw_pool.free(this->_attribute_buffer);
+    }
+    if (this->_position_buffer != nullptr) {
+        this->memory_manager.draw_pool.free(this->_position_buffer);
+    }
     
     logger.logc(Verbosity::important, ModelSystem::channel, "Cleaned.");
 }
 
 
 
-/* Loads a model at the given path and with the given format and adds it to the given entity in the given entity manager. */
+/* Private helper function that sub-allocates space for the given vertices and indices in the shared buffers, splits the vertices in positions and other attributes, uploads them in one transfer and rebases the given model and its meshes to point to them. */
+void ModelSystem::upload_geometry(ECS::Model& model, const Tools::Array<Rendering::Vertex>& vertices, const Tools::Array<Rendering::index_t>& indices) {
+    // Either way, the set of loaded models changes
+    ++this->_generation;
+
+    // Do nothing if there is nothing to upload
+    if (vertices.empty() || indices.empty()) {
+        logger.warningc(ModelSystem::channel, "Model '", model.name, "' does not have any geometry; it will not be rendered.");
+        model.positions = this->_position_buffer;
+        model.attributes = this->_attribute_buffer;
+        model.first_vertex = 0;
+        model.n_vertices = 0;
+        model.meshes.clear();
+        return;
+    }
+
+    // Reserve a range of vertices in the shared vertex buffers
+    uint32_t first_vertex = this->vertex_allocator.allocate(vertices.size());
+    if (first_vertex == std::numeric_limits<uint32_t>::max()) {
+        logger.fatalc(ModelSystem::channel, "Not enough space left in the shared vertex buffer to load ", vertices.size(), " vertices (", this->vertex_allocator.size(), "/", this->vertex_allocator.capacity(), " in use).");
+    } else if (first_vertex == std::numeric_limits<uint32_t>::max() - 1) {
+        logger.fatalc(ModelSystem::channel, "Shared vertex buffer is too fragmented to load ", vertices.size(), " vertices (", this->vertex_allocator.size(), "/", this->vertex_allocator.capacity(), " in use).");
+    }
+    // Do the same for the indices
+    uint32_t first_index = this->index_allocator.allocate(indices.size());
+    if (first_index == std::numeric_limits<uint32_t>::max()) {
+        logger.fatalc(ModelSystem::channel, "Not enough space left in the shared index buffer to load ", indices.size(), " indices (", this->index_allocator.size(), "/", this->index_allocator.capacity(), " in use).");
+    } else if (first_index == std::numeric_limits<uint32_t>::max() - 1) {
+        logger.fatalc(ModelSystem::channel, "Shared index buffer is too fragmented to load ", indices.size(), " indices (", this->index_allocator.size(), "/", this->index_allocator.capacity(), " in use).");
+    }
+
+    // Prepare a single staging buffer that contains the positions, the other attributes and the indices back-to-back, splitting the vertices while we write them
+    VkDeviceSize positions_size = vertices.size() * sizeof(glm::vec3);
+    VkDeviceSize attributes_size = vertices.size() * sizeof(Rendering::VertexAttributes);
+    VkDeviceSize indices_size = indices.size() * sizeof(Rendering::index_t);
+    Rendering::Buffer* stage = this->memory_manager.stage_pool.allocate(positions_size + attributes_size + indices_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    void* stage_memory;
+    stage->map(&stage_memory);
+    glm::vec3* positions = (glm::vec3*) stage_memory;
+    Rendering::VertexAttributes* attributes = (Rendering::VertexAttributes*) ((uint8_t*) stage_memory + positions_size);
+    for (uint32_t i = 0; i < vertices.size(); i++) {
+        positions[i] = vertices[i].pos;
+        attributes[i] = { vertices[i].colour, vertices[i].texel };
+    }
+    memcpy((void*) ((uint8_t*) stage_memory + positions_size + attributes_size), (void*) indices.rdata(), indices_size);
+    stage->flush();
+    stage->unmap();
+
+    // Copy all ranges to their place in the shared buffers in one submission
+    this->memory_manager.copy_cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    stage->schedule_copyto(this->_position_buffer, positions_size, 0, first_vertex * sizeof(glm::vec3), this->memory_manager.copy_cmd);
+    stage->schedule_copyto(this->_attribute_buffer, attributes_size, positions_size, first_vertex * sizeof(Rendering::VertexAttributes), this->memory_manager.copy_cmd);
+    stage->schedule_copyto(this->_index_buffer, indices_size, positions_size + attributes_size, first_index * sizeof(Rendering::index_t), this->memory_manager.copy_cmd);
+    this->memory_manager.copy_cmd->end(this->memory_manager.gpu.queues(Rendering::QueueType::memory)[0]);
+
+    // We can free the stage buffer again
+    this->memory_manager.stage_pool.free(stage);
+
+    // Finally, rebase the model and its meshes to their place in the shared buffers
+    model.positions = this->_position_buffer;
+    model.attributes = this->_attribute_buffer;
+    model.first_vertex = first_vertex;
+    model.n_vertices = vertices.size();
+    for (uint32_t i = 0; i < model.meshes.size(); i++) {
+        ECS::Mesh& mesh = model.meshes[i];
+
+        // Compute the bounding sphere of the mesh from the vertices it actually uses, centred in its bounding box
+        glm::vec3 min = mesh.n_indices > 0 ? vertices[indices[mesh.first_index] + mesh.vertex_offset].pos : glm::vec3(0.0f);
+        glm::vec3 max = min;
+        for (uint32_t k = mesh.first_index; k < mesh.first_index + mesh.n_indices; k++) {
+            const glm::vec3& pos = vertices[indices[k] + mesh.vertex_offset].pos;
+            min = glm::min(min, pos);
+            max = glm::max(max, pos);
+        }
+        glm::vec3 centre = 0.5f * (min + max);
+        float radius = 0.0f;
+        for (uint32_t k = mesh.first_index; k < mesh.first_index + mesh.n_indices; k++) {
+            radius = std::max(radius, glm::length(vertices[indices[k] + mesh.vertex_offset].pos - centre));
+        }
+        mesh.bounds = glm::vec4(centre, radius);
+
+        // Then move it to its place
+        mesh.indices = this->_index_buffer;
+        mesh.first_index += first_index;
+        mesh.vertex_offset += static_cast<int32_t>(first_vertex);
+    }
+}
+
+
+
+/* Loads a model at the given path and with the given format and adds it to the given entity in the given entity manager. If the entity is an occluder, its geometry is also kept on the CPU for occlusion culling. */
 void ModelSystem::load_model(ECS::EntityManager& entity_manager, entity_t entity, const std::string& path, ModelFormat format) {
+    PROFILE_SCOPE("load_model");
     logger.logc(Verbosity::important, ModelSystem::channel, "Loading model for entity ", entity, "...");
 
     // Create a 'real' path, containing the executable's location as well
@@ -84,55 +192,37 @@ void ModelSystem::load_model(ECS::EntityManager& entity_manager, entity_t entity
     // Get the entity's component
     ECS::Model& model = entity_manager.get_component<ECS::Model>(entity);
 
-    // Load the model according to the given format
+    // Load the model according to the given format, collecting its geometry CPU-side first
+    Tools::Array<Rendering::Vertex> vertices;
+    Tools::Array<Rendering::index_t> indices;
     switch (format) {
         case ModelFormat::obj:
             // Use the load function from the modelloader
             logger.logc(Verbosity::details, ModelSystem::channel, "Loading '", fullpath, "' as .obj file...");
-            load_obj_model(this->memory_manager, this->material_pool, model, fullpath);
+            load_obj_model(this->material_pool, model, vertices, indices, fullpath);
             break;
 
         case ModelFormat::triangle: {
             // Simply set the hardcoded list
             logger.logc(Verbosity::details, ModelSystem::channel, "Loading static triangle...");
-            uint32_t n_vertices = 3, n_indices = 3;
-
-            // Prepare a staging buffer
-            Rendering::Buffer* stage_buffer = this->memory_manager.stage_pool.allocate(std::max(n_vertices * sizeof(Rendering::Vertex), n_indices * sizeof(Rendering::index_t)), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-            void* stage_memory;
-            stage_buffer->map(&stage_memory);
-
-            // Prepare the model's vertex buffer
-            model.vertices = this->memory_manager.draw_pool.allocate(n_vertices * sizeof(Rendering::Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-            model.n_vertices = n_vertices;
-
-            // Populate the vertex buffer
-            Rendering::Vertex* vstage_memory = (Rendering::Vertex*) stage_memory;
-            vstage_memory[0] = Rendering::Vertex({ 0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f});
-            vstage_memory[1] = Rendering::Vertex({ 0.5f,  0.5f, 0.0f}, {0.0f, 1.0f, 0.0f});
-            vstage_memory[2] = Rendering::Vertex({-0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f});
-            stage_buffer->flush(n_vertices * sizeof(Rendering::Vertex));
-            stage_buffer->copyto(model.vertices, n_vertices * sizeof(Rendering::Vertex), 0, 0, this->memory_manager.copy_cmd);
+            vertices = {
+                Rendering::Vertex({ 0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}),
+                Rendering::Vertex({ 0.5f,  0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}),
+                Rendering::Vertex({-0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f})
+            };
+            indices = {
+                0, 1, 2
+            };
 
             // Next, prepare the mesh
             model.meshes.push_back({});
-            Mesh& mesh = model.meshes[0];
+            ECS::Mesh& mesh = model.meshes[0];
             mesh.name = "triangle";
-            mesh.indices = this->memory_manager.draw_pool.allocate(n_indices * sizeof(Rendering::index_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT  | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-            mesh.n_indices = n_indices;
+            mesh.first_index = 0;
+            mesh.n_indices = indices.size();
+            mesh.vertex_offset = 0;
             mesh.material = this->material_pool.default();
-
-            // Populate its indices
-            Rendering::index_t* istage_memory = (Rendering::index_t*) stage_memory;
-            istage_memory[0] = 0;
-            istage_memory[1] = 1;
-            istage_memory[2] = 2;
-            stage_buffer->flush(n_indices * sizeof(Rendering::index_t));
-            stage_buffer->copyto(mesh.indices, n_indices * sizeof(Rendering::index_t), 0, 0, this->memory_manager.copy_cmd);
-
-            // Deallocate the stage buffer and update the index count
-            stage_buffer->unmap();
-            this->memory_manager.stage_pool.free(stage_buffer);
+            model.name = "triangle";
 
             // Done
             break;
@@ -141,48 +231,26 @@ void ModelSystem::load_model(ECS::EntityManager& entity_manager, entity_t entity
         case ModelFormat::square: {
             // Simply set the hardcoded list
             logger.logc(Verbosity::details, ModelSystem::channel, "Loading static square...");
-            uint32_t n_vertices = 4, n_indices = 6;
-
-            // Prepare a staging buffer
-            Rendering::Buffer* stage_buffer = this->memory_manager.stage_pool.allocate(std::max(n_vertices * sizeof(Rendering::Vertex), n_indices * sizeof(Rendering::index_t)), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-            void* stage_memory;
-            stage_buffer->map(&stage_memory);
-
-            // Prepare the model's vertex buffer
-            model.vertices = this->memory_manager.draw_pool.allocate(n_vertices * sizeof(Rendering::Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-            model.n_vertices = n_vertices;
-
-            // Populate the vertex buffer
-            Rendering::Vertex* vstage_memory = (Rendering::Vertex*) stage_memory;
-            vstage_memory[0] = Rendering::Vertex({-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f});
-            vstage_memory[1] = Rendering::Vertex({ 0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f});
-            vstage_memory[2] = Rendering::Vertex({ 0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f});
-            vstage_memory[3] = Rendering::Vertex({-0.5f,  0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f});
-            stage_buffer->flush(n_vertices * sizeof(Rendering::Vertex));
-            stage_buffer->copyto(model.vertices, n_vertices * sizeof(Rendering::Vertex), 0, 0, this->memory_manager.copy_cmd);
+            vertices = {
+                Rendering::Vertex({-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}),
+                Rendering::Vertex({ 0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}),
+                Rendering::Vertex({ 0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}),
+                Rendering::Vertex({-0.5f,  0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f})
+            };
+            indices = {
+                0, 1, 2,
+                2, 3, 0
+            };
 
             // Next, prepare the mesh
             model.meshes.push_back({});
-            Mesh& mesh = model.meshes[0];
+            ECS::Mesh& mesh = model.meshes[0];
             mesh.name = "square";
-            mesh.indices = this->memory_manager.draw_pool.allocate(n_indices * sizeof(Rendering::index_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT  | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-            mesh.n_indices =  n_indices;
+            mesh.first_index = 0;
+            mesh.n_indices = indices.size();
+            mesh.vertex_offset = 0;
             mesh.material = this->material_pool.default();
-
-            // Populate its indices
-            Rendering::index_t* istage_memory = (Rendering::index_t*) stage_memory;
-            istage_memory[0] = 0;
-            istage_memory[1] = 1;
-            istage_memory[2] = 2;
-            istage_memory[3] = 2;
-            istage_memory[4] = 3;
-            istage_memory[5] = 0;
-            stage_buffer->flush(n_indices * sizeof(Rendering::index_t));
-            stage_buffer->copyto(mesh.indices, n_indices * sizeof(Rendering::index_t), 0, 0, this->memory_manager.copy_cmd);
-
-            // Deallocate the stage buffer and update the index count
-            stage_buffer->unmap();
-            this->memory_manager.stage_pool.free(stage_buffer);
+            model.name = "square";
 
             // Done
             break;
@@ -214,6 +282,27 @@ void ModelSystem::load_model(ECS::EntityManager& entity_manager, entity_t entity
 
     }
 
+    // If the entity hides others when culling on the CPU, it keeps a copy of the positions and triangles of all its meshes there
+    if (entity_manager.has_component(entity, ECS::ComponentFlags::occluder)) {
+        ECS::Occluder& occluder = entity_manager.get_component<ECS::Occluder>(entity);
+        occluder.vertices.clear();
+        occluder.indices.clear();
+        occluder.vertices.reserve_opt(vertices.size());
+        occluder.indices.reserve_opt(indices.size());
+        for (uint32_t i = 0; i < vertices.size(); i++) {
+            occluder.vertices.push_back(vertices[i].pos);
+        }
+        for (uint32_t i = 0; i < model.meshes.size(); i++) {
+            const ECS::Mesh& mesh = model.meshes[i];
+            for (uint32_t k = mesh.first_index; k < mesh.first_index + mesh.n_indices; k++) {
+                occluder.indices.push_back(static_cast<uint32_t>(indices[k] + mesh.vertex_offset));
+            }
+        }
+    }
+
+    // Move the collected geometry to its place in the shared buffers
+    this->upload_geometry(model, vertices, indices);
+
     // Do some debug print to close off
     logger.logc(Verbosity::debug, ModelSystem::channel, "Loaded ", model.meshes.size(), " new meshes.");
 }
@@ -222,16 +311,30 @@ void ModelSystem::load_model(ECS::EntityManager& entity_manager, entity_t entity
 void ModelSystem::unload_model(ECS::EntityManager& entity_manager, entity_t entity) {
     logger.logc(Verbosity::important, ModelSystem::channel, "Deallocating model for entity ", entity, "...");
 
-    // Deallocate the global vertex array first
+    // Release the model's range in the shared vertex buffers first
     ECS::Model& model = entity_manager.get_component<ECS::Model>(entity);
-    this->memory_manager.draw_pool.free(model.vertices);
+    if (model.n_vertices > 0) {
+        this->vertex_allocator.free(model.first_vertex);
+    }
 
-    // Loop through the model's meshes to delete the index buffers
-    for (uint32_t i = 0; i < model.meshes.size(); i++) {
-        this->memory_manager.draw_pool.free(model.meshes[i].indices);
+    // Release the meshes' range in the shared index buffer. Since they were uploaded in one go, the first mesh marks the start of the allocated block
+    if (!model.meshes.empty()) {
+        this->index_allocator.free(model.meshes[0].first_index);
     }
     // Clear the list of meshes
     model.meshes.clear();
+    model.positions = nullptr;
+    model.attributes = nullptr;
+    model.n_vertices = 0;
+    // Drop its CPU-side copy as an occluder too
+    if (entity_manager.has_component(entity, ECS::ComponentFlags::occluder)) {
+        ECS::Occluder& occluder = entity_manager.get_component<ECS::Occluder>(entity);
+        occluder.vertices.clear();
+        occluder.indices.clear();
+    }
+
+    // Mark that the set of loaded models changed
+    ++this->_generation;
 }
 
 
@@ -246,4 +349,10 @@ void Models::swap(ModelSystem& mm1, ModelSystem& mm2) {
 
     // Otherwise, swap all elements
     using std::swap;
+    swap(mm1._position_buffer, mm2._position_buffer);
+    swap(mm1._attribute_buffer, mm2._attribute_buffer);
+    swap(mm1._index_buffer, mm2._index_buffer);
+    swap(mm1.vertex_allocator, mm2.vertex_allocator);
+    swap(mm1.index_allocator, mm2.index_allocator);
+    swap(mm1._generation, mm2._generation);
 }
@@ -4,7 +4,7 @@
  * Created:
  *   01/07/2021, 14:09:53
  * Last edited:
- *   9/19/2021, 5:56:30 PM
+ *   19/10/2026, 02:01:52
  * Auto updated?
  *   Yes
  *
@@ -20,11 +20,15 @@
 #include <unordered_map>
 #include <vulkan/vulkan.h>
 
+#include "tools/Array.hpp"
 #include "ecs/EntityManager.hpp"
 #include "ecs/components/Model.hpp"
 #include "materials/MaterialPool.hpp"
 #include "rendering/memory_manager/MemoryManager.hpp"
 #include "rendering/commandbuffers/CommandBuffer.hpp"
+#include "rendering/memory/allocators/BlockAllocator.hpp"
+#include "rendering/auxillary/Vertex.hpp"
+#include "rendering/auxillary/Index.hpp"
 #include "ModelFormat.hpp"
 
 namespace Makma3D::Models {
@@ -39,23 +43,50 @@ namespace Makma3D::Models {
         /* Reference to the MaterialPool which we use to load new materials with. */
         Materials::MaterialPool& material_pool;
 
+    private:
+        /* The shared vertex buffer where all models store the positions of their vertices. */
+        Rendering::Buffer* _position_buffer;
+        /* The shared vertex buffer where all models store the other attributes of their vertices, at the same index as their positions. */
+        Rendering::Buffer* _attribute_buffer;
+        /* The shared index buffer where all meshes store their indices. */
+        Rendering::Buffer* _index_buffer;
+        /* Allocator that manages which vertices in the shared vertex buffers are in use (in units of vertices). */
+        Rendering::BlockAllocator<uint32_t> vertex_allocator;
+        /* Allocator that manages which indices in the shared index buffer are in use (in units of indices). */
+        Rendering::BlockAllocator<uint32_t> index_allocator;
+        /* Counter that is bumped every time a model is loaded or unloaded, so that others can cheaply see if any geometry changed. */
+        uint64_t _generation;
+
+
+        /* Private helper function that sub-allocates space for the given vertices and indices in the shared buffers, splits the vertices in positions and other attributes, uploads them in one transfer and rebases the given model and its meshes to point to them. */
+        void upload_geometry(ECS::Model& model, const Tools::Array<Rendering::Vertex>& vertices, const Tools::Array<Rendering::index_t>& indices);
+
     public:
-        /* Constructor for the ModelSystem class, which takes a MemoryManager struct for the required memory pools and a material pool to possibly define new materials found in, for example, .obj files. */
-        ModelSystem(Rendering::MemoryManager& memory_manager, Materials::MaterialPool& material_pool);
-        /* Copy constructor for the ModelSystem class. */
-        ModelSystem(const ModelSystem& other);
+        /* Constructor for the ModelSystem class, which takes a MemoryManager struct for the required memory pools and a material pool to possibly define new materials found in, for example, .obj files. Optionally, the maximum number of vertices and indices that can be loaded at the same time can be given. */
+        ModelSystem(Rendering::MemoryManager& memory_manager, Materials::MaterialPool& material_pool, uint32_t max_vertices = 1048576, uint32_t max_indices = 2097152);
+        /* Copy constructor for the ModelSystem class, which is deleted. */
+        ModelSystem(const ModelSystem& other) = delete;
         /* Move constructor for the ModelSystem class. */
         ModelSystem(ModelSystem&& other);
         /* Destructor for the ModelSystem class. */
         ~ModelSystem();
 
-        /* Loads a model at the given path and with the given format and adds it to the given entity in the given entity manager. */
+        /* Loads a model at the given path and with the given format and adds it to the given entity in the given entity manager. If the entity is an occluder, its geometry is also kept on the CPU for occlusion culling. */
         void load_model(ECS::EntityManager& entity_manager, entity_t entity, const std::string& path, ModelFormat format = ModelFormat::obj);
         /* Unloads the model belonging to the given entity in the given entity manager. */
         void unload_model(ECS::EntityManager& entity_manager, entity_t entity);
 
-        /* Copy assignment operator for the ModelSystem class. */
-        inline ModelSystem& operator=(const ModelSystem& other) { return *this = ModelSystem(other); }
+        /* Returns the shared vertex buffer in which the positions of all models live. */
+        inline const Rendering::Buffer* position_buffer() const { return this->_position_buffer; }
+        /* Returns the shared vertex buffer in which the other vertex attributes of all models live. */
+        inline const Rendering::Buffer* attribute_buffer() const { return this->_attribute_buffer; }
+        /* Returns the shared index buffer in which all meshes live. */
+        inline const Rendering::Buffer* index_buffer() const { return this->_index_buffer; }
+        /* Returns the current generation of the loaded models, which changes every time a model is loaded or unloaded. */
+        inline uint64_t generation() const { return this->_generation; }
+
+        /* Copy assignment operator for the ModelSystem class, which is deleted. */
+        ModelSystem& operator=(const ModelSystem& other) = delete;
         /* Move assignment operator for the ModelSystem class. */
         inline ModelSystem& operator=(ModelSystem&& other) { if (this != &other) { swap(*this, other); } return *this; }
         /* Swap operator for the ModelSystem class. */
@@ -4,7 +4,7 @@
  * Created:
  *   22/09/2021, 14:51:31
  * Last edited:
- *   22/09/2021, 14:51:31
+ *   19/10/2026, 00:45:14
  * Auto updated?
  *   Yes
  *
@@ -100,8 +100,8 @@ static Rendering::index_t store_vertex(Tools::Array<Rendering::Vertex>& vertices
 
 
 /***** LIBRARY FUNCTIONS *****/
-/* Loads the file at the given path as a .obj file, and populates the given model data from it. Uses the tinyobjloader library for most of the work. */
-void Models::load_obj_model(Rendering::MemoryManager& memory_manager, Materials::MaterialPool& material_pool, ECS::Model& model, const std::string& path) {
+/* Loads the file at the given path as a .obj file, and populates the given model's meshes from it. The vertices and indices are appended CPU-side to the given arrays, and each mesh' first_index is relative to the start of the given index array; uploading them is left to the ModelSystem. Uses the tinyobjloader library for most of the work. */
+void Models::load_obj_model(Materials::MaterialPool& material_pool, ECS::Model& model, Tools::Array<Rendering::Vertex>& vertices, Tools::Array<Rendering::index_t>& indices, const std::string& path) {
     // Load the model
     tinyobj::attrib_t data;
     std::vector<tinyobj::shape_t> shapes;
@@ -154,12 +154,12 @@ void Models::load_obj_model(Rendering::MemoryManager& memory_manager, Materials:
 
     // Go through the meshes to collect the data
     model.meshes.reserve_opt(16);
-    Tools::Array<Rendering::Vertex> vertices(16);
+    vertices.reserve_opt(16);
+    indices.reserve_opt(16);
     std::unordered_map<glm::uvec3, uint32_t> vertex_map;
     std::unordered_map<int, Tools::Array<Rendering::index_t>> cpu_index_lists;
     for (size_t i = 0; i < shapes.size(); i++) {
         // Populate the lists of indices CPU-side, sorting them by material
-        uint32_t largest_list_size = 0;
         for (size_t j = 0; j < shapes[i].mesh.indices.size(); j++) {
             // Find a unique vector/normal/texel pair from the coordinates and map it to our indices
             const tinyobj::index_t& obj_indices = shapes[i].mesh.indices[j];
@@ -175,15 +175,8 @@ void Models::load_obj_model(Rendering::MemoryManager& memory_manager, Materials:
             // Insert our index into the mesh's list
             while ((*iter).second.size() >= (*iter).second.capacity()) { (*iter).second.reserve(2 * (*iter).second.capacity()); }
             (*iter).second.push_back(index);
-
-            // Also keep track of the largest list for the stage buffer
-            if ((*iter).second.size() > largest_list_size) { largest_list_size = (*iter).second.size(); }
         }
 
-        // Next, allocate a staging buffer with enough space for all buffers (but not at the same time)
-        Rendering::Buffer* stage = memory_manager.stage_pool.allocate(largest_list_size * sizeof(Rendering::index_t), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-        void* stage_map; stage->map(&stage_map);
-
         // With the list of material-sorted indices, create a new Mesh each
         for (const auto& [ material_id, cpu_indices ] : cpu_index_lists) {
             // Fetch the appropriate material
@@ -194,40 +187,25 @@ void Models::load_obj_model(Rendering::MemoryManager& memory_manager, Materials:
             mesh.name = cpu_index_lists.size() == 1 ? shapes[i].name : shapes[i].name + ' ' + material->name();
             mesh.material = material;
 
-            // Create the buffer for this mesh
-            mesh.indices = memory_manager.draw_pool.allocate(cpu_indices.size() * sizeof(Rendering::index_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+            // Mark where its range starts in the global list of indices
+            mesh.first_index = indices.size();
             mesh.n_indices = cpu_indices.size();
+            mesh.vertex_offset = 0;
 
-            // Populate the buffer with the staging buffer
-            memcpy(stage_map, (void*) cpu_indices.rdata(), cpu_indices.size() * sizeof(Rendering::index_t));
-            stage->flush();
-            stage->copyto(mesh.indices, cpu_indices.size() * sizeof(Rendering::index_t), 0, 0, memory_manager.copy_cmd);
+            // Append the indices to the global list of them
+            while (indices.size() + cpu_indices.size() > indices.capacity()) { indices.reserve(2 * indices.capacity()); }
+            memcpy((void*) (indices.wdata(indices.size() + cpu_indices.size()) + mesh.first_index), (void*) cpu_indices.rdata(), cpu_indices.size() * sizeof(Rendering::index_t));
 
             // Add the Mesh to the model before we're done
             while (model.meshes.size() >= model.meshes.capacity()) { model.meshes.reserve(2 * model.meshes.capacity()); }
             model.meshes.push_back(std::move(mesh));
         }
 
-        // We can free the stage buffer again
-        stage->unmap();
-        memory_manager.stage_pool.free(stage);
-
         // Reset the necessary buffers to re-use them next iteration
         cpu_index_lists.clear();
     }
 
-
-
-    // With a global collection of vertices complete, it's time to send them to the GPU
-    model.n_vertices = vertices.size();
-    model.vertices = memory_manager.draw_pool.allocate(model.n_vertices * sizeof(Rendering::Vertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-    // Prepare a stage buffer to use
-    Rendering::Buffer* stage = memory_manager.stage_pool.allocate(model.n_vertices * sizeof(Rendering::Vertex), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-    // Use the stage buffer to populate the main buffer
-    model.vertices->set((void*) vertices.rdata(), model.n_vertices * sizeof(Rendering::Vertex), stage, memory_manager.copy_cmd);
-    // We can free the buffer again
-    memory_manager.stage_pool.free(stage);
-
     // And with that, we've loaded the model
+    model.n_vertices = vertices.size();
     model.name = path;
 }
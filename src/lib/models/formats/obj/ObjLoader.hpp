@@ -4,7 +4,7 @@
  * Created:
  *   22/09/2021, 14:50:12
  * Last edited:
- *   22/09/2021, 14:50:12
+ *   19/10/2026, 00:45:14
  * Auto updated?
  *   Yes
  *
@@ -19,13 +19,15 @@
 
 #include <string>
 
-#include "rendering/memory_manager/MemoryManager.hpp"
+#include "tools/Array.hpp"
+#include "rendering/auxillary/Vertex.hpp"
+#include "rendering/auxillary/Index.hpp"
 #include "materials/MaterialPool.hpp"
 #include "ecs/components/Model.hpp"
 
 namespace Makma3D::Models {
-    /* Loads the file at the given path as a .obj file, and populates the given model data from it. Uses the tinyobjloader library for most of the work. */
-    void load_obj_model(Rendering::MemoryManager& memory_manager, Materials::MaterialPool& material_pool, ECS::Model& model, const std::string& path);
+    /* Loads the file at the given path as a .obj file, and populates the given model's meshes from it. The vertices and indices are appended CPU-side to the given arrays, and each mesh' first_index is relative to the start of the given index array; uploading them is left to the ModelSystem. Uses the tinyobjloader library for most of the work. */
+    void load_obj_model(Materials::MaterialPool& material_pool, ECS::Model& model, Tools::Array<Rendering::Vertex>& vertices, Tools::Array<Rendering::index_t>& indices, const std::string& path);
 
 }
 
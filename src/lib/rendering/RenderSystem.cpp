@@ -4,7 +4,7 @@
  * Created:
  *   20/07/2021, 15:10:25
  * Last edited:
- *   9/20/2021, 10:51:53 PM
+ *   19/10/2026, 03:25:22
  * Auto updated?
  *   Yes
  *
@@ -14,15 +14,20 @@
  *   component to decide where to place the entity.
 **/
 
+#include <cmath>
+
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
 #include "tools/Common.hpp"
+#include "tools/Profiler.hpp"
 #include "ecs/components/Transform.hpp"
 #include "ecs/components/Model.hpp"
 #include "ecs/components/Camera.hpp"
+#include "ecs/components/Light.hpp"
+#include "ecs/components/Emitter.hpp"
 #include "models/ModelSystem.hpp"
 
 #include "auxillary/ErrorCodes.hpp"
@@ -30,6 +35,9 @@
 #include "auxillary/Vertex.hpp"
 #include "auxillary/Index.hpp"
 
+#include "culling/CullReference.hpp"
+#include "lighting/LightBuffers.hpp"
+
 #include "RenderSystem.hpp"
 
 using namespace std;
@@ -38,96 +46,63 @@ using namespace Makma3D::ECS;
 using namespace Makma3D::Rendering;
 
 
-/***** HELPER STRUCTS *****/
-/* Used to store data for a single mesh to render. */
-struct MeshRenderData {
-    /* The entity to which the mesh belongs. */
-    ECS::entity_t entity;
-    /* The vertex buffer of this entity. */
-    const Rendering::Buffer* vertex_buffer;
-    /* The index buffer to render. */
-    const Rendering::Buffer* index_buffer;
-    /* The number of indices to render. */
-    uint32_t n_indices;
-
-};
-
-
-
-
-
-/***** HELPER FUNCTIONS *****/
-/* Sorts given list of 'entities' (list of their Model components) in such a way that they can be rendered material-by-material efficiently. */
-static std::unordered_map<Materials::MaterialType, std::unordered_map<const Materials::Material*, Tools::Array<MeshRenderData>>> sort_entities(const Materials::MaterialPool& material_pool, const ECS::ComponentList<ECS::Model>& entities) {
-    // Delcare the result array
-    std::unordered_map<Materials::MaterialType, std::unordered_map<const Materials::Material*, Tools::Array<MeshRenderData>>> result;
-
-    // Loop through the entities in the given list to sort them
-    for (uint32_t i = 0; i < entities.size(); i++) {
-        // Get the entity & their model
-        ECS::entity_t entity = entities.get_entity(i);
-        const ECS::Model& model = entities[i];
-
-        // Loop through the model's meshes
-        for (uint32_t j = 0; j < model.meshes.size(); j++) {
-            // Get the mesh and its material
-            const ECS::Mesh& mesh = model.meshes[j];
-            const Materials::Material* material = mesh.material;
-
-            // Check if we have already seen a material with this type
-            std::unordered_map<Materials::MaterialType, std::unordered_map<const Materials::Material*, Tools::Array<MeshRenderData>>>::iterator type_iter = result.find(material->type());
-            if (type_iter == result.end()) {
-                type_iter = result.insert({ material->type(), {} }).first;
-            }
-
-            // Next, check if we have already seen index buffers of this type
-            std::unordered_map<const Materials::Material*, Tools::Array<MeshRenderData>>::iterator material_iter = (*type_iter).second.find(material);
-            if (material_iter == (*type_iter).second.end()) {
-                material_iter = (*type_iter).second.insert({ material, Tools::Array<MeshRenderData>(16) }).first;
-            }
-
-            // Populate the IndexBufferRenderData and add it to the list, resizing it in a more optimal fashion
-            Tools::Array<MeshRenderData>& indices_to_render = (*material_iter).second;
-            if (indices_to_render.size() >= indices_to_render.capacity()) { indices_to_render.reserve(2 * indices_to_render.capacity()); }
-            indices_to_render.push_back({
-                entity,
-                model.vertices,
-                mesh.indices,
-                mesh.n_indices
-            });
-        }
-    }
-
-    // Done! Return the list
-    return result;
-}
-
-
-
-
-
 /***** RENDERSYSTEM CLASS *****/
-/* Constructor for the RenderSystem, which takes a window, a memory manager to render (to and draw memory from, respectively) and a model system to schedule the model buffers withh. */
-RenderSystem::RenderSystem(Window& window, MemoryManager& memory_manager, const Models::ModelSystem& model_system) :
+/* Constructor for the RenderSystem, which takes a window, a memory manager to render (to and draw memory from, respectively), a model system to schedule the model buffers with and the options that decide which features to use. If the window is headless, renders to as many offscreen images as there are frames in flight instead. */
+RenderSystem::RenderSystem(Window& window, MemoryManager& memory_manager, const Models::ModelSystem& model_system, const Options& options) :
     window(window),
     memory_manager(memory_manager),
     model_system(model_system),
 
+    offscreen_target(this->window.headless() ? new Rendering::OffscreenTarget(this->memory_manager, this->window.extent(), options.frames_in_flight) : nullptr),
+
     global_descriptor_layout(this->window.gpu()),
     material_descriptor_layout(this->window.gpu()),
     object_descriptor_layout(this->window.gpu()),
 
-    depth_stencil(this->window.gpu(), this->memory_manager.draw_pool, this->window.swapchain().extent()),
-
     shader_pool(this->window.gpu()),
 
-    render_pass(this->window.gpu()),
+    render_graph(this->window.gpu()),
+    prepass_pass(RenderGraph::unused),
+    graph_attachments(nullptr),
+    depth_resource(RenderGraph::unused),
+    scene_resource(RenderGraph::unused),
+    n_views(1),
+    view_size(1.0f, 1.0f),
 
     pipeline_cache(this->window.gpu(), Tools::merge_paths(get_executable_path(), "pipeline.cache")),
-    pipeline_constructor(this->window.gpu(), this->pipeline_cache)
+    pipeline_constructor(this->window.gpu(), this->pipeline_cache),
+    prepass_pipeline(nullptr),
+
+    gpu_profiler(nullptr),
+    stats_history(),
+    resolution_scaler(nullptr),
+    upscale_filter(VK_FILTER_LINEAR),
+    gpu_culler(nullptr),
+    hiz_pyramid(nullptr),
+    prev_view_proj(1.0f),
+    cull_check(options.gpu_culling && options.cull_check),
+    occlusion_culler(nullptr),
+    particle_system(nullptr),
+    particle_pipeline(nullptr),
+    particle_check(options.max_particles > 0 && options.particle_check),
+    particle_step(0.0f),
+    particle_time(0.0),
+    particle_update(std::chrono::steady_clock::now()),
+    particle_seed(0),
+    bindless_textures(nullptr),
+    material_buffer(nullptr),
+
+    scene_version(1),
+    queued_generation(0),
+    queued_view_proj(1.0f)
 {
-    // Initialize the descriptor set layout for the global data
+    // Initialize the descriptor set layout for the global data: the camera, followed by the clustering parameters, the lights, the clusters and their light indices, and finally the parameters of all materials
     this->global_descriptor_layout.add_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
+    this->global_descriptor_layout.add_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+    for (uint32_t i = 1; i < LightBuffers::n_bindings; i++) {
+        this->global_descriptor_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+    }
+    this->global_descriptor_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
     this->global_descriptor_layout.finalize();
 
     // Initialize the descritpor set layout for the per-material data
@@ -137,25 +112,98 @@ RenderSystem::RenderSystem(Window& window, MemoryManager& memory_manager, const
     this->object_descriptor_layout.add_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
     this->object_descriptor_layout.finalize();
 
-    // Initialize the render pass
-    uint32_t col_index = this->render_pass.add_attachment(this->window.swapchain().format(), VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
-    uint32_t dep_index = this->render_pass.add_attachment(this->depth_stencil.format(), VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-    this->render_pass.add_subpass({ std::make_pair(col_index, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) }, std::make_pair(dep_index, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL));
-    this->render_pass.add_dependency(VK_SUBPASS_EXTERNAL, col_index, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, 0, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
-    this->render_pass.finalize();
+    // Both scaling the resolution and rendering several views draw the scene to an attachment of its own first, which is then blitted to the images we render to. Check if we can
+    VkFormatProperties format_properties;
+    vkGetPhysicalDeviceFormatProperties(this->window.gpu(), this->_target_format(), &format_properties);
+    VkFormatFeatureFlags blit_features = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+    bool can_blit = (format_properties.optimalTilingFeatures & blit_features) == blit_features;
+    bool can_copy_to = this->offscreen_target != nullptr || (this->window.gpu().swapchain_info().capabilities().supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    this->upscale_filter = format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+
+    // If asked to render several views, check that the GPU can render them all in one pass, and that we can place each of them in its own part of the images we render to
+    uint32_t n_views = options.n_views;
+    if (n_views > 1) {
+        if (n_views > max_views) {
+            logger.warningc(RenderSystem::channel, "Cannot render more than ", max_views, " views; only rendering the first ", max_views, " cameras.");
+            n_views = max_views;
+        }
+        if (!this->window.gpu().supports_multiview()) {
+            logger.warningc(RenderSystem::channel, "GPU does not support multiview; only rendering the first camera.");
+        } else if (!can_blit || !can_copy_to) {
+            logger.warningc(RenderSystem::channel, "GPU cannot blit to the images we render to; only rendering the first camera.");
+        } else {
+            this->n_views = n_views;
+            logger.logc(Verbosity::important, RenderSystem::channel, "Rendering ", this->n_views, " views at once using multiview.");
+        }
+    }
+    // Each view has its own clusters, since each looks at the lights from somewhere else
+    this->light_clusterers = Tools::Array<LightClusterer>(LightClusterer(), this->n_views);
+
+    // The occluders are only rasterized as seen from a single camera, so the CPU culling would hide what the other views can see
+    if (options.cpu_occlusion) {
+        if (this->n_views > 1) {
+            logger.warningc(RenderSystem::channel, "Cannot cull on the CPU when rendering several views; disabling CPU occlusion culling.");
+        } else {
+            this->occlusion_culler = new OcclusionCuller();
+        }
+    }
+
+    // If asked to hold a frame time, check that we can both measure the GPU and stretch a smaller image over the ones we render to
+    if (options.target_frame_us > 0) {
+        if (!this->window.gpu().supports_timestamps()) {
+            logger.warningc(RenderSystem::channel, "GPU does not support timestamps on its graphics queue; cannot scale the resolution to the GPU frame time.");
+        } else if (!can_blit || !can_copy_to) {
+            logger.warningc(RenderSystem::channel, "GPU cannot blit to the images we render to; cannot scale the resolution to the GPU frame time.");
+        } else {
+            this->resolution_scaler = new ResolutionScaler((double) options.target_frame_us);
+            logger.logc(Verbosity::important, RenderSystem::channel, "Scaling the resolution to hold a GPU frame time of ", options.target_frame_us, "us.");
+        }
+    }
+
+    // Describe the frame as a render graph, which draws the scene to the images we render to using a transient depth buffer. Offscreen images end up ready to be copied instead of presented
+    this->render_graph.set_views(this->n_views);
+    VkImageLayout col_final_layout = this->_target_layout();
+    uint32_t target = this->render_graph.import_attachment("target", this->_target_format(), col_final_layout);
+    // If the resolution is scaled or there are several views, the scene is instead drawn to an attachment of its own (with a layer per view), which is stretched over the target after the render pass
+    uint32_t colour = target;
+    if (this->resolution_scaler != nullptr || this->n_views > 1) {
+        this->scene_resource = this->render_graph.add_attachment("scene", this->_target_format());
+        this->render_graph.export_attachment(this->scene_resource, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+        colour = this->scene_resource;
+    }
+    uint32_t depth = this->render_graph.add_attachment("depth", RenderGraph::depth_format(this->window.gpu()));
+    this->depth_resource = depth;
+    if (options.depth_prepass) {
+        // Fill the depth buffer first, so that the scene only has to test against it
+        this->prepass_pass = this->render_graph.add_pass("depth_prepass");
+        this->render_graph.use(this->prepass_pass, depth, AttachmentUsage::depth);
+    }
+    this->scene_pass = this->render_graph.add_pass("scene");
+    this->render_graph.use(this->scene_pass, colour, AttachmentUsage::colour);
+    this->render_graph.use(this->scene_pass, depth, options.depth_prepass ? AttachmentUsage::depth_read : AttachmentUsage::depth);
+    // If we cull on the GPU, the next frame is culled against the depth buffer of this one, so it has to survive the render pass
+    if (options.gpu_culling) {
+        this->render_graph.export_attachment(depth, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT);
+    }
+    // Compile it to a render pass, and allocate its transient attachments at the size we render at
+    this->render_graph.compile();
+    this->graph_attachments = new GraphAttachments(this->window.gpu(), this->memory_manager.draw_pool, this->render_graph, this->_render_extent(this->_target_extent()));
 
     // Prepare pipeline construction by settings the constructor properties
     this->pipeline_constructor.vertex_input_state = VertexInputState(
-        { VertexBinding(0, sizeof(Vertex)) },
+        { VertexBinding(position_binding, sizeof(glm::vec3)), VertexBinding(attribute_binding, sizeof(VertexAttributes)) },
         {
-            VertexAttribute(0, 0, offsetof(Vertex, pos), VK_FORMAT_R32G32B32_SFLOAT),
-            VertexAttribute(0, 1, offsetof(Vertex, colour), VK_FORMAT_R32G32B32_SFLOAT),
-            VertexAttribute(0, 2, offsetof(Vertex, texel), VK_FORMAT_R32G32_SFLOAT)
+            VertexAttribute(position_binding, 0, 0, VK_FORMAT_R32G32B32_SFLOAT),
+            VertexAttribute(attribute_binding, 1, offsetof(VertexAttributes, colour), VK_FORMAT_R32G32B32_SFLOAT),
+            VertexAttribute(attribute_binding, 2, offsetof(VertexAttributes, texel), VK_FORMAT_R32G32_SFLOAT)
         }
     );
     this->pipeline_constructor.input_assembly_state = InputAssemblyState(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-    this->pipeline_constructor.depth_testing = DepthTesting(VK_TRUE, VK_COMPARE_OP_LESS);
-    this->pipeline_constructor.viewport_transformation = ViewportTransformation(VkOffset2D{ 0, 0 }, this->window.swapchain().extent(), VkOffset2D{ 0, 0 }, this->window.swapchain().extent());
+    // If the pre-pass already wrote the depth, only the closest fragments have exactly that depth, so shade only those and leave the depth alone
+    this->pipeline_constructor.depth_testing = options.depth_prepass ? DepthTesting(VK_TRUE, VK_COMPARE_OP_EQUAL, VK_FALSE) : DepthTesting(VK_TRUE, VK_COMPARE_OP_LESS);
+    this->pipeline_constructor.viewport_transformation = ViewportTransformation(VkOffset2D{ 0, 0 }, this->_target_extent(), VkOffset2D{ 0, 0 }, this->_target_extent());
+    // The viewport & scissor are set while recording instead, so that resizing doesn't require new pipelines
+    this->pipeline_constructor.dynamic_state = DynamicState({ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR });
     this->pipeline_constructor.rasterization = Rasterization(VK_TRUE, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE);
     // this->pipeline_constructor.rasterization = Rasterization(VK_TRUE, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE);
     this->pipeline_constructor.multisampling = Multisampling();
@@ -163,23 +211,111 @@ RenderSystem::RenderSystem(Window& window, MemoryManager& memory_manager, const
         VK_FALSE, VK_LOGIC_OP_NO_OP,
         { ColorBlending(0, VK_FALSE, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD) }
     );
-    this->pipeline_constructor.pipeline_layout = PipelineLayout({ this->global_descriptor_layout, this->material_descriptor_layout, this->object_descriptor_layout }, {});
+    // The shaders find the parameters of the material they draw in the material buffer, through the ID in the push constants
+    this->pipeline_constructor.pipeline_layout = PipelineLayout({ this->global_descriptor_layout, this->material_descriptor_layout, this->object_descriptor_layout }, { { VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(uint32_t) } });
+    this->material_buffer = new MaterialBuffer(this->window.gpu());
+
+    // If asked to, keep the textures bindless. The pipelines then also get the set with all textures
+    if (options.bindless) {
+        if (!this->window.gpu().supports_descriptor_indexing()) {
+            logger.warningc(RenderSystem::channel, "GPU does not support descriptor indexing; binding the textures per material instead.");
+        } else {
+            this->bindless_textures = new BindlessTextures(this->window.gpu());
+            this->pipeline_constructor.pipeline_layout = PipelineLayout({ this->global_descriptor_layout, this->material_descriptor_layout, this->object_descriptor_layout, this->bindless_textures->layout() }, { { VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(uint32_t) } });
+            logger.logc(Verbosity::important, RenderSystem::channel, "Keeping up to ", BindlessTextures::max_textures, " textures bindless.");
+        }
+    }
 
     // Create the pipeline for all materials
     for (uint32_t i = 0; i < Materials::MaterialPool::n_types; i++) {
         // Modify the pipeline constructor for this type
-        this->model_system.material_pool.init_props(Materials::MaterialPool::types[i], this->shader_pool, this->pipeline_constructor);
+        this->model_system.material_pool.init_props(Materials::MaterialPool::types[i], this->shader_pool, this->pipeline_constructor, this->n_views > 1, this->bindless_textures != nullptr);
 
         // Construct the new pipeline and insert it into the list
         this->pipelines.insert({
             Materials::MaterialPool::types[i],
-            this->pipeline_constructor.construct(this->render_pass, 0, VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT)
+            this->pipeline_constructor.construct(this->render_graph.render_pass(), this->render_graph.subpass(this->scene_pass), VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT)
         });
     }
 
-    // Initialize the frame manager
-    this->frame_manager = new FrameManager(this->memory_manager, this->window.swapchain(), this->global_descriptor_layout, this->material_descriptor_layout, this->object_descriptor_layout);
-    this->frame_manager->bind(this->render_pass, this->depth_stencil);
+    // Create the pipeline for the depth pre-pass if needed, which only needs the positions and doesn't have a fragment shader or colour attachments
+    if (options.depth_prepass) {
+        this->pipeline_constructor.shaders = { ShaderStage(this->shader_pool.allocate(this->n_views > 1 ? "shaders/depth_prepass_multiview_vert.spv" : "shaders/depth_prepass_vert.spv"), VK_SHADER_STAGE_VERTEX_BIT, {}) };
+        this->pipeline_constructor.vertex_input_state = VertexInputState(
+            { VertexBinding(position_binding, sizeof(glm::vec3)) },
+            { VertexAttribute(position_binding, 0, 0, VK_FORMAT_R32G32B32_SFLOAT) }
+        );
+        this->pipeline_constructor.depth_testing = DepthTesting(VK_TRUE, VK_COMPARE_OP_LESS);
+        this->pipeline_constructor.color_logic = ColorLogic(VK_FALSE, VK_LOGIC_OP_NO_OP, {});
+        this->prepass_pipeline = this->pipeline_constructor.construct(this->render_graph.render_pass(), this->render_graph.subpass(this->prepass_pass));
+    }
+
+    // Prepare the particles if asked to. They're billboards built from the vertex index, which are blended over the scene after everything else without writing the depth
+    if (options.max_particles > 0) {
+        this->particle_system = new ParticleSystem(this->window.gpu(), this->shader_pool, this->pipeline_cache, options.max_particles, this->particle_check);
+        this->pipeline_constructor.shaders = {
+            ShaderStage(this->shader_pool.allocate(this->n_views > 1 ? "shaders/particle_multiview_vert.spv" : "shaders/particle_vert.spv"), VK_SHADER_STAGE_VERTEX_BIT, {}),
+            ShaderStage(this->shader_pool.allocate("shaders/particle_frag.spv"), VK_SHADER_STAGE_FRAGMENT_BIT, {})
+        };
+        this->pipeline_constructor.vertex_input_state = VertexInputState();
+        this->pipeline_constructor.depth_testing = DepthTesting(VK_TRUE, VK_COMPARE_OP_LESS_OR_EQUAL, VK_FALSE);
+        this->pipeline_constructor.rasterization = Rasterization(VK_TRUE, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+        this->pipeline_constructor.color_logic = ColorLogic(
+            VK_FALSE, VK_LOGIC_OP_NO_OP,
+            { ColorBlending(0, VK_TRUE, VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD) }
+        );
+        this->pipeline_constructor.pipeline_layout = PipelineLayout({ this->global_descriptor_layout, this->particle_system->draw_layout() }, {});
+        this->particle_pipeline = this->pipeline_constructor.construct(this->render_graph.render_pass(), this->render_graph.subpass(this->scene_pass));
+        logger.logc(Verbosity::important, RenderSystem::channel, "Simulating up to ", options.max_particles, " particles on the GPU.");
+    }
+
+    // Prepare culling on the GPU if asked to, with a depth pyramid the size of the depth buffer. With several views, it's only built from the first one
+    if (options.gpu_culling) {
+        this->gpu_culler = new GpuCuller(this->window.gpu(), this->shader_pool, this->pipeline_cache);
+        this->hiz_pyramid = new HiZPyramid(this->window.gpu(), this->memory_manager.draw_pool, this->gpu_culler->pyramid_layout(), this->gpu_culler->sampler(), this->graph_attachments->base_view(depth), this->graph_attachments->extent());
+    }
+
+    // Spawn the threads that record the scene, one per core but at most max_record_threads
+    uint32_t n_record_threads = std::max(1U, std::min(std::thread::hardware_concurrency(), RenderSystem::max_record_threads));
+    this->record_pool = new Tools::ThreadPool(n_record_threads, "record");
+
+    // Initialize the frame manager, giving each frame a recorder per thread for each subpass
+    uint32_t max_chunks = n_record_threads * this->render_graph.subpasses();
+    if (this->offscreen_target != nullptr) {
+        this->frame_manager = new FrameManager(this->memory_manager, *this->offscreen_target, this->global_descriptor_layout, this->material_descriptor_layout, this->object_descriptor_layout, options.frames_in_flight, max_chunks);
+    } else {
+        this->frame_manager = new FrameManager(this->memory_manager, this->window.swapchain(), this->global_descriptor_layout, this->material_descriptor_layout, this->object_descriptor_layout, options.frames_in_flight, max_chunks);
+    }
+    this->frame_manager->bind(this->render_graph.render_pass(), *this->graph_attachments);
+
+    // Have the bindless textures forget any texture that is freed, only handing out its slot again once no frame in flight may read it anymore
+    if (this->bindless_textures != nullptr) {
+        BindlessTextures* bindless_textures = this->bindless_textures;
+        FrameManager* frame_manager = this->frame_manager;
+        this->model_system.material_pool.texture_pool.on_free([bindless_textures, frame_manager](const Materials::Texture* texture) {
+            uint32_t slot = bindless_textures->remove(texture);
+            if (slot < BindlessTextures::max_textures) {
+                frame_manager->retire([bindless_textures, slot]() { bindless_textures->release(slot); });
+            }
+        });
+    }
+
+    // Prepare the ring for capturing frames, with a slot per frame in flight so a frame's slot is free again by the time the frame is re-used
+    this->readback_ring = new ReadbackRing(this->window.gpu(), options.frames_in_flight, col_final_layout);
+
+    // Prepare the GPU profiler if asked to (or if the resolution follows the GPU's frame time), with a bucket per material type and one for the depth pre-pass
+    if (options.gpu_profiling || this->resolution_scaler != nullptr) {
+        if (this->window.gpu().supports_timestamps()) {
+            Tools::Array<std::string> bucket_names(Materials::MaterialPool::n_types + 1);
+            for (uint32_t i = 0; i < Materials::MaterialPool::n_types; i++) {
+                bucket_names.push_back(Materials::material_type_names[(int) Materials::MaterialPool::types[i]]);
+            }
+            if (options.depth_prepass) { bucket_names.push_back("depth_prepass"); }
+            this->gpu_profiler = new GpuProfiler(this->window.gpu(), options.frames_in_flight, max_chunks, bucket_names, options.pipeline_statistics);
+        } else {
+            logger.warningc(RenderSystem::channel, "GPU does not support timestamps on its graphics queue; cannot profile the GPU.");
+        }
+    }
 
     // Done initializing
     logger.logc(Verbosity::important, RenderSystem::channel, "Init success.");
@@ -191,88 +327,445 @@ RenderSystem::RenderSystem(RenderSystem&& other)  :
     memory_manager(other.memory_manager),
     model_system(other.model_system),
 
+    offscreen_target(other.offscreen_target),
+
     global_descriptor_layout(std::move(other.global_descriptor_layout)),
     material_descriptor_layout(std::move(other.material_descriptor_layout)),
     object_descriptor_layout(std::move(other.object_descriptor_layout)),
 
-    depth_stencil(std::move(other.depth_stencil)),
-
     shader_pool(std::move(other.shader_pool)),
     
-    render_pass(std::move(other.render_pass)),
+    render_graph(std::move(other.render_graph)),
+    scene_pass(other.scene_pass),
+    prepass_pass(other.prepass_pass),
+    graph_attachments(other.graph_attachments),
+    depth_resource(other.depth_resource),
+    scene_resource(other.scene_resource),
+    n_views(other.n_views),
+    view_size(other.view_size),
 
     pipeline_cache(std::move(other.pipeline_cache)),
     pipeline_constructor(std::move(other.pipeline_constructor)),
     pipelines(other.pipelines),
-
-    frame_manager(other.frame_manager)
+    prepass_pipeline(other.prepass_pipeline),
+
+    frame_manager(other.frame_manager),
+    record_pool(other.record_pool),
+    readback_ring(other.readback_ring),
+    capture_path(std::move(other.capture_path)),
+    gpu_profiler(other.gpu_profiler),
+    stats_history(std::move(other.stats_history)),
+    resolution_scaler(other.resolution_scaler),
+    upscale_filter(other.upscale_filter),
+    gpu_culler(other.gpu_culler),
+    hiz_pyramid(other.hiz_pyramid),
+    prev_view_proj(other.prev_view_proj),
+    cull_check(other.cull_check),
+    occlusion_culler(other.occlusion_culler),
+    particle_system(other.particle_system),
+    particle_pipeline(other.particle_pipeline),
+    particle_check(other.particle_check),
+    particle_step(other.particle_step),
+    particle_time(other.particle_time),
+    particle_update(other.particle_update),
+    particle_seed(other.particle_seed),
+    bindless_textures(other.bindless_textures),
+    material_buffer(other.material_buffer),
+    light_clusterers(std::move(other.light_clusterers)),
+    lights(std::move(other.lights)),
+    emitters(std::move(other.emitters)),
+
+    render_queue(std::move(other.render_queue)),
+    scene_version(other.scene_version),
+    queued_generation(other.queued_generation),
+    queued_entities(std::move(other.queued_entities)),
+    queued_transforms(std::move(other.queued_transforms)),
+    queued_materials(std::move(other.queued_materials)),
+    queued_first_indices(std::move(other.queued_first_indices)),
+    queued_view_proj(other.queued_view_proj),
+    cull_items(std::move(other.cull_items))
 {
     // Prevent the frame manager from being deallocated
     other.pipelines.clear();
+    other.prepass_pipeline = nullptr;
     other.frame_manager = nullptr;
+    other.record_pool = nullptr;
+    other.readback_ring = nullptr;
+    other.gpu_profiler = nullptr;
+    other.resolution_scaler = nullptr;
+    other.gpu_culler = nullptr;
+    other.hiz_pyramid = nullptr;
+    other.occlusion_culler = nullptr;
+    other.particle_system = nullptr;
+    other.particle_pipeline = nullptr;
+    other.bindless_textures = nullptr;
+    other.material_buffer = nullptr;
+    other.offscreen_target = nullptr;
+    other.graph_attachments = nullptr;
 }
 
 /* Destructor for the RenderSystem class. */
 RenderSystem::~RenderSystem() {
     logger.logc(Verbosity::important, RenderSystem::channel, "Cleaning...");
 
+    // Stop telling the bindless textures about freed textures, since they're about to go
+    if (this->bindless_textures != nullptr) {
+        this->model_system.material_pool.texture_pool.on_free(nullptr);
+    }
+
+    // Write any frames that are still being captured. The GPU is expected to be idle by now
+    if (this->readback_ring != nullptr) {
+        delete this->readback_ring;
+    }
+    // Deallocate the profiler's queries if needed
+    if (this->gpu_profiler != nullptr) {
+        delete this->gpu_profiler;
+    }
     // Deallocate the frame manager if needed
     if (this->frame_manager != nullptr) {
         delete this->frame_manager;
     }
+    // Deallocate the culler and its depth pyramid after the frames that use them
+    if (this->hiz_pyramid != nullptr) {
+        delete this->hiz_pyramid;
+    }
+    if (this->gpu_culler != nullptr) {
+        delete this->gpu_culler;
+    }
+    // The particles too
+    if (this->particle_system != nullptr) {
+        delete this->particle_system;
+    }
+    // And the textures & materials they keep bound
+    if (this->bindless_textures != nullptr) {
+        delete this->bindless_textures;
+    }
+    if (this->material_buffer != nullptr) {
+        delete this->material_buffer;
+    }
+    if (this->occlusion_culler != nullptr) {
+        delete this->occlusion_culler;
+    }
+    if (this->resolution_scaler != nullptr) {
+        delete this->resolution_scaler;
+    }
+    // Deallocate the offscreen images and the transient attachments after the frames that wrap them
+    if (this->offscreen_target != nullptr) {
+        delete this->offscreen_target;
+    }
+    if (this->graph_attachments != nullptr) {
+        delete this->graph_attachments;
+    }
+    // Stop the recording threads if needed
+    if (this->record_pool != nullptr) {
+        delete this->record_pool;
+    }
     // Deallocate the pipelines
     if (!this->pipelines.empty()) {
         for (const auto& p : this->pipelines) {
             delete p.second;
         }
     }
+    if (this->prepass_pipeline != nullptr) {
+        delete this->prepass_pipeline;
+    }
+    if (this->particle_pipeline != nullptr) {
+        delete this->particle_pipeline;
+    }
 
     logger.logc(Verbosity::important, RenderSystem::channel, "Cleaned.");
 }
 
 
 
+/* Private helper function that returns the profiler bucket of the given material type, which is its index in the MaterialPool's list of types. */
+uint32_t RenderSystem::_bucket(Materials::MaterialType type) {
+    for (uint32_t i = 0; i < Materials::MaterialPool::n_types; i++) {
+        if (Materials::MaterialPool::types[i] == type) { return i; }
+    }
+    logger.fatalc(RenderSystem::channel, "Unknown material type '", Materials::material_type_names[(int) type], '\'');
+    return 0;
+}
+
+/* Private helper function that re-allocates the render graph's attachments (and everything built on them) for the given size of the images we render to, scaled by the current render scale. The old ones are retired. */
+void RenderSystem::_allocate_attachments(const VkExtent2D& target_extent) {
+    // Re-allocate the render graph's transient attachments with a new size, retiring the old ones
+    Rendering::GraphAttachments* old_attachments = this->graph_attachments;
+    this->graph_attachments = new Rendering::GraphAttachments(this->window.gpu(), this->memory_manager.draw_pool, this->render_graph, this->_render_extent(target_extent));
+    this->frame_manager->retire([old_attachments]() { delete old_attachments; });
+    // The depth pyramid is built from the depth buffer, so it's re-created along with it. The new one is empty, so the first frame after the resize is only culled against the frustum
+    if (this->hiz_pyramid != nullptr) {
+        Rendering::HiZPyramid* old_pyramid = this->hiz_pyramid;
+        this->hiz_pyramid = new Rendering::HiZPyramid(this->window.gpu(), this->memory_manager.draw_pool, this->gpu_culler->pyramid_layout(), this->gpu_culler->sampler(), this->graph_attachments->base_view(this->depth_resource), this->graph_attachments->extent());
+        this->frame_manager->retire([old_pyramid]() { delete old_pyramid; });
+    }
+
+    // Re-create all frames in the frame manager, which retires the old ones
+    this->frame_manager->bind(this->render_graph.render_pass(), *this->graph_attachments);
+
+    // Since the viewport & scissor are dynamic, the pipelines survive a new size. Any recorded scenes still have the old ones set, though, so make sure they are re-recorded
+    ++this->scene_version;
+}
+
 /* Private helper function that resizes all required structures for a new window size. */
 void RenderSystem::_resize() {
     logger.logc(Verbosity::important, RenderSystem::channel, "Resizing...");
 
-    // First, wait until the device is idle
-    this->window.gpu().wait_for_idle();
+    // Note that we don't wait until the device is idle; instead, everything that frames in flight may still use is retired, and only destroyed once those frames have completed
 
-    // Then, resize the window
-    this->window.resize();
+    // First, resize the window, which re-creates the swapchain
+    VkSwapchainKHR vk_old_swapchain = this->window.resize();
 
-    // Re-create the depth stencil with a new size
+    // Re-allocate the attachments for the new size
     logger.logc(Verbosity::details, RenderSystem::channel, "New window size: ", this->window.real_extent().width, 'x', this->window.real_extent().height);
-    this->depth_stencil.resize(this->window.real_extent());
-
-    // Re-create all frames in the frame manager
-    this->frame_manager->bind(this->render_pass, this->depth_stencil);
-
-    // Update the pipeline constructor with the new viewport data
-    this->pipeline_constructor.viewport_transformation.viewport.width  = (float) this->window.swapchain().extent().width;
-    this->pipeline_constructor.viewport_transformation.viewport.height = (float) this->window.swapchain().extent().height;
-    this->pipeline_constructor.viewport_transformation.scissor.extent = this->window.swapchain().extent();
-
-    // Recreate our pipelines
-    for (auto& p : this->pipelines) {
-        // Update the constructo to this type's preferences
-        this->model_system.material_pool.init_props(p.first, this->shader_pool, this->pipeline_constructor);
-        // Set the current pipeline as the base
-        this->pipeline_constructor.set_base_pipeline(p.second);
-        
-        // Now, recreate it
-        Pipeline* new_pipeline = this->pipeline_constructor.construct(this->render_pass, 0);
-        // Replace it with the current one
-        delete p.second;
-        p.second = new_pipeline;
+    this->_allocate_attachments(this->window.real_extent());
+
+    // Retire the old swapchain last, so it's destroyed after the frames that refer to its images
+    const Rendering::GPU& gpu = this->window.gpu();
+    this->frame_manager->retire([&gpu, vk_old_swapchain]() { vkDestroySwapchainKHR(gpu, vk_old_swapchain, nullptr); });
+}
+
+/* Private helper function that re-allocates the attachments after the render scale or the size of the views changed. Unlike a resize, this leaves the swapchain alone. */
+void RenderSystem::_rescale() {
+    VkExtent2D extent = this->_render_extent(this->_target_extent());
+    logger.logc(Verbosity::details, RenderSystem::channel, "Rendering at ", this->render_scale(), " of the resolution (", extent.width, 'x', extent.height, ')');
+    this->_allocate_attachments(this->_target_extent());
+}
+
+/* Private helper function that returns the extent at which we render the scene for images of the given extent. With several views, that's the size of the largest viewport, and it's smaller still if the resolution is scaled down. */
+VkExtent2D RenderSystem::_render_extent(const VkExtent2D& target_extent) const {
+    VkExtent2D extent = target_extent;
+    if (this->n_views > 1) {
+        extent.width = std::max(1U, static_cast<uint32_t>(std::lround((double) target_extent.width * (double) this->view_size.x)));
+        extent.height = std::max(1U, static_cast<uint32_t>(std::lround((double) target_extent.height * (double) this->view_size.y)));
+    }
+    if (this->resolution_scaler != nullptr) {
+        extent = VkExtent2D{ this->resolution_scaler->scaled(extent.width), this->resolution_scaler->scaled(extent.height) };
     }
+    return extent;
+}
+
+/* Private helper function that checks whether the renderable part of the scene changed since the render queue was last built. If so, updates the cached state and returns true. */
+bool RenderSystem::_scene_changed(const ECS::EntityManager& entity_manager) {
+    const ECS::ComponentList<ECS::Model>& entities = entity_manager.get_list<ECS::Model>();
+
+    // Count the meshes, which tells us if models with a different number of them were assigned
+    uint32_t n_meshes = 0;
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        n_meshes += entities[i].meshes.size();
+    }
+
+    // If models were (un)loaded, entities were added or removed or the number of meshes changed, we know enough
+    bool changed = this->model_system.generation() != this->queued_generation || entities.size() != this->queued_entities.size() || n_meshes != this->queued_materials.size();
+    if (changed) {
+        this->queued_generation = this->model_system.generation();
+        this->queued_entities.resize(entities.size());
+        this->queued_transforms.resize(entities.size());
+        this->queued_materials.resize(n_meshes);
+        this->queued_first_indices.resize(n_meshes);
+    }
+
+    // Otherwise, compare each entity, its transform and its meshes to the ones we saw last time. The meshes are compared by where their indices start and by their material, since those change when the entity gets another model or a mesh gets another material
+    uint32_t m = 0;
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        ECS::entity_t entity = entities.get_entity(i);
+        const ECS::Transform& transform = entity_manager.get_component<ECS::Transform>(entity);
+        if (changed || entity != this->queued_entities[i] || transform.translation != this->queued_transforms[i]) {
+            this->queued_entities[i] = entity;
+            this->queued_transforms[i] = transform.translation;
+            changed = true;
+        }
+
+        const ECS::Model& model = entities[i];
+        for (uint32_t j = 0; j < model.meshes.size(); j++, m++) {
+            const ECS::Mesh& mesh = model.meshes[j];
+            if (changed || mesh.material != this->queued_materials[m] || mesh.first_index != this->queued_first_indices[m]) {
+                this->queued_materials[m] = mesh.material;
+                this->queued_first_indices[m] = mesh.first_index;
+                changed = true;
+            }
+        }
+    }
+
+    // Done
+    return changed;
+}
+
+/* Private helper function that collects the lights of the entities in the given entity manager, placed in the world by their transforms. */
+void RenderSystem::_collect_lights(const ECS::EntityManager& entity_manager) {
+    const ECS::ComponentList<ECS::Light>& lights = entity_manager.get_list<ECS::Light>();
+
+    // Make room for all of them at once
+    this->lights.clear();
+    this->lights.reserve_opt(lights.size());
+    LightData* data = this->lights.wdata(lights.size());
+    for (uint32_t i = 0; i < lights.size(); i++) {
+        ECS::entity_t entity = lights.get_entity(i);
+        const ECS::Light& light = lights[i];
+        glm::vec3 position = entity_manager.has_component(entity, ECS::ComponentFlags::transform) ? glm::vec3(entity_manager.get_component<ECS::Transform>(entity).translation[3]) : glm::vec3(0.0f);
+        data[i] = { glm::vec4(position, light.radius), glm::vec4(light.colour * light.intensity, 0.0f) };
+    }
+}
+
+/* Private helper function that collects the emitters of the entities in the given entity manager that spawn particles when the particles are advanced by the given number of seconds, placed in the world by their transforms. */
+void RenderSystem::_collect_emitters(const ECS::EntityManager& entity_manager, float dt) {
+    const ECS::ComponentList<ECS::Emitter>& emitters = entity_manager.get_list<ECS::Emitter>();
+
+    // Each emitter spawns however many whole particles its rate adds up to since the simulation started, so fractional particles carry over to later frames
+    double start = this->particle_time;
+    double end = start + (double) dt;
+    this->emitters.clear();
+    this->emitters.reserve_opt(emitters.size());
+    for (uint32_t i = 0; i < emitters.size(); i++) {
+        const ECS::Emitter& emitter = emitters[i];
+        uint32_t count = static_cast<uint32_t>(std::floor(end * (double) emitter.rate) - std::floor(start * (double) emitter.rate));
+        if (count == 0) { continue; }
+
+        // The first particle of each emitter is only known once they're uploaded
+        ECS::entity_t entity = emitters.get_entity(i);
+        glm::vec3 position = entity_manager.has_component(entity, ECS::ComponentFlags::transform) ? glm::vec3(entity_manager.get_component<ECS::Transform>(entity).translation[3]) : glm::vec3(0.0f);
+        this->emitters.push_back(EmitterData{ glm::vec4(position, emitter.radius), glm::vec4(emitter.velocity, emitter.speed_spread), glm::vec4(emitter.colour, emitter.lifetime), emitter.size, 0, count, 0 });
+    }
+    this->particle_time = end;
+}
+
+/* Private helper function that rebuilds & sorts the render queue from the renderable entities in the given entity manager, as seen from the given camera. */
+void RenderSystem::_build_queue(const ECS::EntityManager& entity_manager, const ECS::Camera& cam) {
+    const ECS::ComponentList<ECS::Model>& entities = entity_manager.get_list<ECS::Model>();
+
+    // Collect the meshes of all entities in the render queue
+    this->render_queue.clear();
+    this->cull_items.clear();
+
+    // If we cull on the CPU, rasterize the occluders first so the entities can be tested against them. The recording threads are idle at this point, so we borrow them
+    if (this->occlusion_culler != nullptr) {
+        PROFILE_SCOPE("rasterize_occluders");
+        this->queued_view_proj = cam.proj * cam.view;
+        this->occlusion_culler->begin(this->queued_view_proj);
+        const ECS::ComponentList<ECS::Occluder>& occluders = entity_manager.get_list<ECS::Occluder>();
+        for (uint32_t i = 0; i < occluders.size(); i++) {
+            ECS::entity_t entity = occluders.get_entity(i);
+            const ECS::Occluder& occluder = occluders[i];
+            glm::mat4 transform = entity_manager.has_component(entity, ECS::ComponentFlags::transform) ? entity_manager.get_component<ECS::Transform>(entity).translation : glm::mat4(1.0f);
+            this->occlusion_culler->add_occluder(transform, occluder.vertices.rdata(), occluder.indices.rdata(), occluder.indices.size());
+        }
+        this->occlusion_culler->rasterize(this->record_pool);
+    }
+
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        const ECS::Model& model = entities[i];
+        const glm::mat4& transform = this->queued_transforms[i];
+
+        // Compute the view-space depth of the entity's origin, so we can sort front-to-back. Note that this isn't updated if only the camera moves, which only costs us some early-z efficiency
+        float depth = -(cam.view * transform[3]).z;
+        // The bounding spheres grow with the largest scale of the transform, so they keep enclosing the mesh if it's scaled unevenly
+        float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+
+        // Add each of its meshes as a separate draw
+        for (uint32_t j = 0; j < model.meshes.size(); j++) {
+            const ECS::Mesh& mesh = model.meshes[j];
+            glm::vec4 bounds(glm::vec3(transform * glm::vec4(glm::vec3(mesh.bounds), 1.0f)), mesh.bounds.w * scale);
+            // Skip the mesh altogether if it's hidden behind the occluders
+            if (this->occlusion_culler != nullptr && !this->occlusion_culler->visible(glm::vec3(bounds) - bounds.w, glm::vec3(bounds) + bounds.w)) { continue; }
+            this->render_queue.push({ this->queued_entities[i], mesh.material, mesh.first_index, mesh.n_indices, mesh.vertex_offset, bounds }, depth);
+            if (this->gpu_culler != nullptr) { this->cull_items.push_back({ bounds, mesh.first_index, mesh.n_indices, mesh.vertex_offset, 0 }); }
+        }
+    }
+
+    // Sort the draws by pipeline, then material and then depth. The depth pre-pass also wants them purely front-to-back
+    PROFILE_SCOPE("sort_draws");
+    this->render_queue.sort(this->prepass_pipeline != nullptr);
+}
+
+/* Private helper function that records the draws in the given range of the render queue as the given chunk of the given frame. Can be called for different chunks from different threads at the same time. */
+void RenderSystem::_record_chunk(ConceptualFrame* frame, uint32_t chunk, uint32_t first_draw, uint32_t last_draw) const {
+    PROFILE_SCOPE("record_chunk");
+
+    // All geometry lives in the ModelSystem's shared buffers, so bind those only once
+    frame->schedule_vertex_buffer(chunk, position_binding, this->model_system.position_buffer());
+    frame->schedule_vertex_buffer(chunk, attribute_binding, this->model_system.attribute_buffer());
+    frame->schedule_index_buffer(chunk, this->model_system.index_buffer());
+
+    // Loop through the sorted draws, only switching pipelines and materials when the next draw needs it. Since each chunk is its own command buffer, the first draw always binds everything
+    const Materials::Material* last_material = nullptr;
+    for (uint32_t i = first_draw; i < last_draw; i++) {
+        const DrawItem& item = this->render_queue[i];
+
+        // Switch material if needed
+        if (item.material != last_material) {
+            // Switch pipeline if the material type changed as well
+            if (last_material == nullptr || item.material->type() != last_material->type()) {
+                // Each material type is its own bucket for the profiler
+                if (last_material != nullptr) { frame->schedule_bucket_stop(chunk, RenderSystem::_bucket(last_material->type())); }
+                frame->schedule_bucket_start(chunk, RenderSystem::_bucket(item.material->type()));
+
+                // Schedule the pipeline for this material
+                frame->schedule_pipeline(chunk, this->pipelines.at(item.material->type()));
+                // Schedule the frame global data on it
+                frame->schedule_global(chunk);
+            }
+
+            // Schedule the data for this material
+            frame->schedule_material(chunk, item.material);
+            last_material = item.material;
+        }
+
+        // Schedule the object data
+        frame->schedule_entity(chunk, item.entity);
+
+        // Draw the mesh' range of the shared buffers, or let the GPU culling decide whether to draw it at all
+        if (this->gpu_culler != nullptr) {
+            frame->schedule_indirect_draw(chunk, this->render_queue.index(i), item.n_indices);
+        } else {
+            frame->schedule_draw(chunk, item.first_index, item.n_indices, item.vertex_offset);
+        }
+    }
+
+    // Close the last bucket
+    if (last_material != nullptr) { frame->schedule_bucket_stop(chunk, RenderSystem::_bucket(last_material->type())); }
+}
+
+/* Private helper function that records the draws in the given range of the front-to-back sorted render queue as the given chunk of the depth pre-pass of the given frame. Can be called for different chunks from different threads at the same time. */
+void RenderSystem::_record_prepass_chunk(ConceptualFrame* frame, uint32_t chunk, uint32_t first_draw, uint32_t last_draw) const {
+    PROFILE_SCOPE("record_prepass_chunk");
+    if (first_draw == last_draw) { return; }
+
+    // The pre-pass only needs the positions, so it doesn't even bind the other vertex attributes
+    frame->schedule_vertex_buffer(chunk, position_binding, this->model_system.position_buffer());
+    frame->schedule_index_buffer(chunk, this->model_system.index_buffer());
+
+    // Every draw uses the same pipeline, regardless of its material
+    frame->schedule_bucket_start(chunk, RenderSystem::prepass_bucket);
+    frame->schedule_pipeline(chunk, this->prepass_pipeline);
+    frame->schedule_global(chunk);
+
+    // Draw everything front-to-back, so that the depth test rejects as much of what's behind it as possible
+    for (uint32_t i = first_draw; i < last_draw; i++) {
+        const DrawItem& item = this->render_queue.front_to_back(i);
+        frame->schedule_entity(chunk, item.entity);
+        if (this->gpu_culler != nullptr) {
+            frame->schedule_indirect_draw(chunk, this->render_queue.front_to_back_index(i), item.n_indices);
+        } else {
+            frame->schedule_draw(chunk, item.first_index, item.n_indices, item.vertex_offset);
+        }
+    }
+    frame->schedule_bucket_stop(chunk, RenderSystem::prepass_bucket);
+}
+
+/* Private helper function that records drawing the particles at the end of the given chunk of the given frame, which has to be in the scene pass. */
+void RenderSystem::_record_particles(ConceptualFrame* frame, uint32_t chunk) const {
+    PROFILE_SCOPE("record_particles");
+
+    // The particles are blended over everything, so they come after all other draws. Since their number lives on the GPU, the draw never has to be re-recorded for it
+    frame->schedule_particle_draw(chunk, this->particle_pipeline);
 }
 
 
 
 /* Runs a single iteration of the game loop. Returns whether or not the RenderSystem is asked to close the window (false) or not (true). */
 bool RenderSystem::render_frame(const ECS::EntityManager& entity_manager) {
+    PROFILE_SCOPE("render_frame");
+
     /* PREPARATION */
     // First, handle window events
     bool can_continue = this->window.loop();
@@ -281,32 +774,97 @@ bool RenderSystem::render_frame(const ECS::EntityManager& entity_manager) {
     }
 
     // Next, get a conceptual frame to render to
-    ConceptualFrame* frame = this->frame_manager->get_frame();
+    ConceptualFrame* frame;
+    {
+        PROFILE_SCOPE("get_frame");
+        frame = this->frame_manager->get_frame();
+    }
     if (frame == nullptr) {
         // Resize, then stop this iteration
         this->_resize();
         return true;
     }
 
-    // Prepare rendering to the frame
-    const ECS::ComponentList<ECS::Model>& entities = entity_manager.get_list<ECS::Model>();
-    frame->prepare_render(this->model_system.material_pool.size(), entities.size());
-
-    // Sort the objects by material type
-    std::unordered_map<Materials::MaterialType, std::unordered_map<const Materials::Material*, Tools::Array<MeshRenderData>>> sorted_entities = sort_entities(this->model_system.material_pool, entities);
-
-    // Populate the frame's camera data
-    const Camera& cam = entity_manager.get_list<Camera>()[0];
-    frame->upload_camera_data(cam.proj, cam.view);
+    // The frame manager waited for the frame we got, so any captures of the frames before it can be written now
+    this->readback_ring->collect(this->frame_manager->completed_frames());
+    // The same goes for the GPU timings, after which the frame can re-use its queries
+    // The resolution scaler follows the time the GPU spent on the most recently measured frame
+    bool rescale = false;
+    if (this->gpu_profiler != nullptr) {
+        uint32_t n_measured = this->gpu_profiler->collect(this->frame_manager->completed_frames());
+        if (this->resolution_scaler != nullptr && n_measured > 0) {
+            rescale = this->resolution_scaler->update(this->gpu_profiler->stats().last_pass_us);
+        }
+    }
+    frame->schedule_profiling(this->gpu_profiler, this->frame_manager->current_frame());
+    // Likewise, the last culling of the frame can be compared against the CPU now that it's done
+    if (this->cull_check) { frame->check_culling(); }
+    frame->schedule_culling(this->gpu_culler, this->hiz_pyramid, this->cull_check);
+    // And so can the number of particles it left alive
+    if (this->particle_check) { frame->check_particles(); }
+    frame->schedule_particles(this->particle_system, this->particle_check);
+    frame->schedule_bindless(this->bindless_textures);
+    frame->schedule_materials(this->material_buffer);
+    // Only the materials that changed since the last frame are uploaded, whether or not the scene is recorded again
+    frame->upload_material_params(this->model_system.material_pool);
+
+    // Collect the cameras we render. The first one decides what's in the draw list; with several views, each of the others is rendered to a layer of its own as well
+    const ECS::ComponentList<Camera>& cams = entity_manager.get_list<Camera>();
+    const Camera& cam = cams[0];
+    uint32_t n_cams = std::min(this->n_views, static_cast<uint32_t>(cams.size()));
+    CameraData views[max_views];
+    for (uint32_t v = 0; v < this->n_views; v++) {
+        // Layers without a camera simply render the first one again, but aren't shown
+        const Camera& view_cam = cams[v < n_cams ? v : 0];
+        views[v] = { view_cam.proj, view_cam.view };
+    }
 
-    // Populate the object datas in advance
-    for (uint32_t i = 0; i < entities.size(); i++) {
-        // Get the entity's transform data
-        ECS::entity_t entity = entities.get_entity(i);
-        const ECS::Transform& transform = entity_manager.get_component<ECS::Transform>(entity);
+    // Each view is stretched over the part of the images its viewport covers. Since all layers share a size, that's the size of the largest viewport; if that changed, the attachments are re-allocated after this frame
+    Tools::Array<VkRect2D> view_rects;
+    if (this->n_views > 1) {
+        VkExtent2D target_extent = this->_target_extent();
+        glm::vec2 view_size(0.0f);
+        view_rects.reserve(n_cams);
+        for (uint32_t v = 0; v < n_cams; v++) {
+            const glm::vec4& viewport = cams[v].viewport;
+            int32_t x = static_cast<int32_t>(std::lround(viewport.x * target_extent.width));
+            int32_t y = static_cast<int32_t>(std::lround(viewport.y * target_extent.height));
+            uint32_t width = std::max(1U, static_cast<uint32_t>(std::lround(viewport.z * target_extent.width)));
+            uint32_t height = std::max(1U, static_cast<uint32_t>(std::lround(viewport.w * target_extent.height)));
+            view_rects.push_back(VkRect2D{ { x, y }, { width, height } });
+            view_size = glm::max(view_size, glm::vec2(viewport.z, viewport.w));
+        }
+        if (view_size != this->view_size) {
+            this->view_size = view_size;
+            rescale = true;
+        }
+    }
+    frame->schedule_upscale(this->scene_resource != RenderGraph::unused ? this->graph_attachments->image(this->scene_resource) : nullptr, this->_target_layout(), this->upscale_filter, view_rects);
+
+    // Rebuild the draw list only if the scene actually changed since last time
+    bool scene_changed = this->_scene_changed(entity_manager);
+    // If we cull on the CPU, what's hidden depends on where we look from, so then the queue is rebuilt whenever the camera moves as well
+    if (scene_changed || (this->occlusion_culler != nullptr && cam.proj * cam.view != this->queued_view_proj)) {
+        PROFILE_SCOPE("build_queue");
+        this->_build_queue(entity_manager, cam);
+        ++this->scene_version;
+    }
 
-        // Upload it to the GPU
-        frame->upload_entity_data(entity, EntityData{ transform.translation });
+    // Populate the frame's camera data. This is always updated, since it lives in a buffer and thus doesn't invalidate any recorded scene
+    frame->upload_camera_data(views, this->n_views);
+
+    // The lights move along with the camera in view space, so they're clustered anew every frame as well. The recording threads are idle at this point, so we borrow them if there are enough lights
+    {
+        PROFILE_SCOPE("cluster_lights");
+        this->_collect_lights(entity_manager);
+        VkExtent2D extent = this->graph_attachments->extent();
+        Tools::ThreadPool* pool = this->lights.size() >= RenderSystem::min_threaded_lights ? this->record_pool : nullptr;
+        for (uint32_t v = 0; v < this->n_views; v++) {
+            this->light_clusterers[v].set_projection(views[v].proj, extent.width, extent.height);
+            this->light_clusterers[v].cluster(views[v].view, this->lights.rdata(), this->lights.size(), pool);
+        }
+        // The views share the parameters of the first, so this assumes they share its near & far planes too. This may invalidate the recorded scene if the frame's light buffers have to grow
+        frame->upload_light_data(this->light_clusterers.rdata(), this->n_views, this->light_clusterers[0].params(RenderSystem::ambient_light));
     }
 
 
@@ -314,53 +872,125 @@ bool RenderSystem::render_frame(const ECS::EntityManager& entity_manager) {
 
 
     /* RECORDING */
-    // Start recording the frame's command buffer
-    frame->schedule_start();
-
-    // Loop through all present material types
-    for (const auto& material_types : sorted_entities) {
-        // Schedule the pipeline for this material
-        frame->schedule_pipeline(this->pipelines.at(material_types.first));
-        // Schedule the frame global data on it
-        frame->schedule_global();
-
-        // Loop through all specific materials for this type
-        for (const auto& materials : material_types.second) {
-            // Upload & schedule the data for this material
-            frame->upload_material_data(materials.first);
-            frame->schedule_material(materials.first);
-
-            // Next, loop through all index buffers of this material to render them
-            for (uint32_t i = 0; i < materials.second.size(); i++) {
-                // Get a shortcut to the data we'll need
-                const MeshRenderData& render_data = materials.second[i];
-
-                // Schedule the object data & its vertex buffer
-                frame->schedule_entity(render_data.entity);
-                frame->schedule_vertex_buffer(render_data.vertex_buffer);
-
-                // Draw the given index buffer
-                frame->schedule_draw(render_data.index_buffer, render_data.n_indices);
+    // If the frame already has this version of the scene recorded, we can simply submit it again
+    if (!frame->has_scene(this->scene_version)) {
+        PROFILE_SCOPE("record_scene");
+
+        // Prepare rendering to the frame
+        frame->prepare_render(this->model_system.material_pool.size(), this->queued_entities.size());
+
+        // Upload the draws to cull before recording them, since that may replace the buffer they read their draw commands from
+        if (this->gpu_culler != nullptr) { frame->upload_cull_items(this->cull_items); }
+
+        // Populate the object datas in advance
+        for (uint32_t i = 0; i < this->queued_entities.size(); i++) {
+            frame->upload_entity_data(this->queued_entities[i], EntityData{ this->queued_transforms[i] });
+        }
+
+        // Prepare the materials in advance, since the recording threads can't bind anything themselves. Since the queue is sorted by material, each one only occurs in one run
+        const Materials::Material* last_material = nullptr;
+        for (uint32_t i = 0; i < this->render_queue.size(); i++) {
+            const DrawItem& item = this->render_queue[i];
+            if (item.material != last_material) {
+                frame->upload_material_data(item.material);
+                last_material = item.material;
             }
         }
-    }
 
-    // Close off recording
-    frame->schedule_stop();
+        // Decide in how many chunks to split the draws, giving each thread at least a minimum amount of work. Each subpass gets its own chunks, since a secondary command buffer only continues a single subpass, so the threads are divided over the subpasses
+        uint32_t n_draws = this->render_queue.size();
+        uint32_t n_subpasses = this->render_graph.subpasses();
+        uint32_t n_chunks = std::max(1U, std::min(this->record_pool->size() / n_subpasses, (n_draws + RenderSystem::min_draws_per_chunk - 1) / RenderSystem::min_draws_per_chunk));
+
+        // Record the chunks of each subpass, in parallel if there's more than one and a thread for each
+        uint32_t prepass_subpass = this->prepass_pipeline != nullptr ? this->render_graph.subpass(this->prepass_pass) : RenderGraph::unused;
+        frame->schedule_start(this->scene_version, n_chunks, n_subpasses);
+        // The particles go at the end of the scene pass' last chunk, which is the very last one since the scene pass is the last subpass
+        std::function<void(uint32_t)> record = [this, frame, n_draws, n_chunks, n_subpasses, prepass_subpass](uint32_t chunk) {
+            uint32_t first_draw = static_cast<uint32_t>((uint64_t) (chunk % n_chunks) * n_draws / n_chunks);
+            uint32_t last_draw  = static_cast<uint32_t>((uint64_t) (chunk % n_chunks + 1) * n_draws / n_chunks);
+            if (chunk / n_chunks == prepass_subpass) {
+                this->_record_prepass_chunk(frame, chunk, first_draw, last_draw);
+            } else {
+                this->_record_chunk(frame, chunk, first_draw, last_draw);
+            }
+            if (this->particle_pipeline != nullptr && chunk == n_chunks * n_subpasses - 1) {
+                this->_record_particles(frame, chunk);
+            }
+        };
+        if (n_chunks * n_subpasses == 1 || n_chunks * n_subpasses > this->record_pool->size()) {
+            for (uint32_t c = 0; c < n_chunks * n_subpasses; c++) { record(c); }
+        } else {
+            this->record_pool->run(n_chunks * n_subpasses, record);
+        }
+
+        // Close off recording
+        frame->schedule_stop();
+    }
 
 
 
 
 
     /* PRESENTING */
+    // Tell the culling where the camera is now, and where it was when the depth pyramid was rendered. Without a pyramid (e.g., right after a resize), we only cull against the frustum. Draws seen by any of the other views are kept too
+    glm::mat4 view_proj = cam.proj * cam.view;
+    if (this->gpu_culler != nullptr) {
+        CullParams params{};
+        params.view_proj = view_proj;
+        params.prev_view_proj = this->prev_view_proj;
+        for (uint32_t v = 0; v < this->n_views; v++) {
+            extract_frustum_planes(views[v].proj * views[v].view, params.planes + 6 * v);
+        }
+        params.pyramid_size = glm::vec2(this->hiz_pyramid->extent().width, this->hiz_pyramid->extent().height);
+        params.use_pyramid = this->hiz_pyramid->built() ? 1 : 0;
+        params.n_views = this->n_views;
+        frame->upload_cull_params(params);
+    }
+
+    // Advance the particles by the time that passed since the last frame, spawning whatever the emitters produced in that time. The world's up is -y, so they fall towards +y
+    if (this->particle_system != nullptr) {
+        PROFILE_SCOPE("collect_emitters");
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        float dt = this->particle_step;
+        if (dt <= 0.0f) {
+            dt = std::min(RenderSystem::max_particle_step, (float) std::chrono::duration_cast<std::chrono::microseconds>(now - this->particle_update).count() / 1000000.0f);
+        }
+        this->particle_update = now;
+        this->_collect_emitters(entity_manager, dt);
+
+        ParticleParams params{};
+        params.gravity = glm::vec4(0.0f, RenderSystem::particle_gravity, 0.0f, RenderSystem::particle_drag);
+        params.dt = dt;
+        params.seed = this->particle_seed++;
+        frame->upload_particle_data(this->emitters, params);
+    }
+
     // 'Render' the frame by submitting it
     VkQueue graphics_queue = this->window.gpu().queues(QueueType::graphics)[0];
-    frame->submit(graphics_queue);
+    if (!this->capture_path.empty()) {
+        frame->schedule_readback(this->readback_ring, this->frame_manager->current_frame(), this->capture_path);
+        this->capture_path.clear();
+    }
+    {
+        PROFILE_SCOPE("submit");
+        frame->submit(graphics_queue, this->offscreen_target == nullptr);
+    }
+    this->prev_view_proj = view_proj;
+    this->stats_history.push(frame->stats());
 
     // Schedule the frame for presentation once it's done rendering
-    if (this->window.needs_resize() || this->frame_manager->present_frame(frame)) {
+    bool needs_resize;
+    {
+        PROFILE_SCOPE("present");
+        needs_resize = this->window.needs_resize() || this->frame_manager->present_frame(frame);
+    }
+    if (needs_resize) {
         // Resize the window
         this->_resize();
+    } else if (rescale) {
+        // Only the attachments have to change size; the frame we just submitted is done with the old ones once they're retired
+        this->_rescale();
     }
 
 
@@ -372,6 +1002,18 @@ bool RenderSystem::render_frame(const ECS::EntityManager& entity_manager) {
     // return false;
 }
 
+/* Captures the next rendered frame to the given path as a .png. Doesn't block; the frame is copied back once it's done rendering, and written to disk on a separate thread. */
+void RenderSystem::capture_frame(const std::string& path) {
+    // Swapchain images can only be copied from if the surface allows it
+    if (this->offscreen_target == nullptr && !(this->window.gpu().swapchain_info().capabilities().supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+        logger.warningc(RenderSystem::channel, "Cannot capture frames, since the window's surface doesn't allow copying from its images; skipping capture of '", path, "'.");
+        return;
+    }
+
+    // Remember it for the next frame
+    this->capture_path = path;
+}
+
 
 
 /* Swap operator for the RenderSystem class. */
@@ -385,19 +1027,61 @@ void Rendering::swap(RenderSystem& rs1, RenderSystem& rs2) {
     // Simply swap everything
     using std::swap;
 
+    swap(rs1.offscreen_target, rs2.offscreen_target);
+
     swap(rs1.global_descriptor_layout, rs2.global_descriptor_layout);
     swap(rs1.material_descriptor_layout, rs2.material_descriptor_layout);
     swap(rs1.object_descriptor_layout, rs2.object_descriptor_layout);
 
-    swap(rs1.depth_stencil, rs2.depth_stencil);
-
     swap(rs1.shader_pool, rs2.shader_pool);
 
-    swap(rs1.render_pass, rs2.render_pass);
+    swap(rs1.render_graph, rs2.render_graph);
+    swap(rs1.scene_pass, rs2.scene_pass);
+    swap(rs1.prepass_pass, rs2.prepass_pass);
+    swap(rs1.graph_attachments, rs2.graph_attachments);
+    swap(rs1.depth_resource, rs2.depth_resource);
+    swap(rs1.scene_resource, rs2.scene_resource);
+    swap(rs1.n_views, rs2.n_views);
+    swap(rs1.view_size, rs2.view_size);
 
     swap(rs1.pipeline_cache, rs2.pipeline_cache);
     swap(rs1.pipeline_constructor, rs2.pipeline_constructor);
     swap(rs1.pipelines, rs2.pipelines);
+    swap(rs1.prepass_pipeline, rs2.prepass_pipeline);
 
     swap(rs1.frame_manager, rs2.frame_manager);
+    swap(rs1.record_pool, rs2.record_pool);
+    swap(rs1.readback_ring, rs2.readback_ring);
+    swap(rs1.capture_path, rs2.capture_path);
+    swap(rs1.gpu_profiler, rs2.gpu_profiler);
+    swap(rs1.stats_history, rs2.stats_history);
+    swap(rs1.resolution_scaler, rs2.resolution_scaler);
+    swap(rs1.upscale_filter, rs2.upscale_filter);
+    swap(rs1.gpu_culler, rs2.gpu_culler);
+    swap(rs1.hiz_pyramid, rs2.hiz_pyramid);
+    swap(rs1.prev_view_proj, rs2.prev_view_proj);
+    swap(rs1.cull_check, rs2.cull_check);
+    swap(rs1.occlusion_culler, rs2.occlusion_culler);
+    swap(rs1.particle_system, rs2.particle_system);
+    swap(rs1.particle_pipeline, rs2.particle_pipeline);
+    swap(rs1.particle_check, rs2.particle_check);
+    swap(rs1.particle_step, rs2.particle_step);
+    swap(rs1.particle_time, rs2.particle_time);
+    swap(rs1.particle_update, rs2.particle_update);
+    swap(rs1.particle_seed, rs2.particle_seed);
+    swap(rs1.bindless_textures, rs2.bindless_textures);
+    swap(rs1.material_buffer, rs2.material_buffer);
+    swap(rs1.light_clusterers, rs2.light_clusterers);
+    swap(rs1.lights, rs2.lights);
+    swap(rs1.emitters, rs2.emitters);
+
+    swap(rs1.render_queue, rs2.render_queue);
+    swap(rs1.scene_version, rs2.scene_version);
+    swap(rs1.queued_generation, rs2.queued_generation);
+    swap(rs1.queued_entities, rs2.queued_entities);
+    swap(rs1.queued_transforms, rs2.queued_transforms);
+    swap(rs1.queued_materials, rs2.queued_materials);
+    swap(rs1.queued_first_indices, rs2.queued_first_indices);
+    swap(rs1.queued_view_proj, rs2.queued_view_proj);
+    swap(rs1.cull_items, rs2.cull_items);
 }
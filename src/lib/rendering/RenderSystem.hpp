@@ -4,7 +4,7 @@
  * Created:
  *   20/07/2021, 15:10:33
  * Last edited:
- *   9/19/2021, 5:56:40 PM
+ *   19/10/2026, 03:25:22
  * Auto updated?
  *   Yes
  *
@@ -17,23 +17,42 @@
 #ifndef RENDERING_RENDER_SYSTEM_HPP
 #define RENDERING_RENDER_SYSTEM_HPP
 
+#include <chrono>
+
+#include "tools/Array.hpp"
+#include "tools/ThreadPool.hpp"
 #include "window/Window.hpp"
 #include "ecs/EntityManager.hpp"
 #include "models/ModelSystem.hpp"
 
 #include "memory_manager/MemoryManager.hpp"
 
-#include "depthtesting/DepthStencil.hpp"
-
 #include "descriptors/DescriptorSetLayout.hpp"
 
 #include "shaders/ShaderPool.hpp"
-#include "renderpass/RenderPass.hpp"
+#include "rendergraph/RenderGraph.hpp"
+#include "rendergraph/GraphAttachments.hpp"
 #include "pipeline/PipelineCache.hpp"
 #include "pipeline/PipelineConstructor.hpp"
 #include "pipeline/Pipeline.hpp"
 
 #include "swapchain/FrameManager.hpp"
+#include "swapchain/ReadbackRing.hpp"
+#include "profiling/GpuProfiler.hpp"
+#include "profiling/RenderStats.hpp"
+#include "profiling/ResolutionScaler.hpp"
+#include "renderqueue/RenderQueue.hpp"
+#include "culling/GpuCuller.hpp"
+#include "culling/HiZPyramid.hpp"
+#include "occlusion/OcclusionCuller.hpp"
+#include "lighting/LightClusterer.hpp"
+#include "particles/ParticleSystem.hpp"
+#include "bindless/BindlessTextures.hpp"
+#include "bindless/MaterialBuffer.hpp"
+#include "data/CameraData.hpp"
+#include "data/CullData.hpp"
+#include "data/LightData.hpp"
+#include "data/ParticleData.hpp"
 
 namespace Makma3D::Rendering {
     /* The RenderSystem class, which is in charge of rendering the renderable entities in the EntityManager. */
@@ -41,8 +60,22 @@ namespace Makma3D::Rendering {
     public:
         /* Channel name for the RenderSystem class. */
         static constexpr const char* channel = "RenderSystem";
-        /* The maximum number of frames in flight we allow. */
-        static constexpr const uint32_t max_frames_in_flight = 2;
+        /* The maximum number of threads we use to record command buffers. */
+        static constexpr const uint32_t max_record_threads = 8;
+        /* The minimum number of draws we give to each recording thread, to make sure the threading overhead stays worth it. */
+        static constexpr const uint32_t min_draws_per_chunk = 512;
+        /* The minimum number of lights before we cluster them on the recording threads, to make sure the threading overhead stays worth it. */
+        static constexpr const uint32_t min_threaded_lights = 256;
+        /* The amount of light that reaches every fragment once there are any lights in the scene. */
+        static constexpr const float ambient_light = 0.1f;
+        /* The most seconds the particles are advanced in a single frame, so that a hitch doesn't fling them across the scene. */
+        static constexpr const float max_particle_step = 0.1f;
+        /* The acceleration with which the particles fall, in units per second squared. */
+        static constexpr const float particle_gravity = 1.0f;
+        /* The fraction of their velocity the particles lose per second. */
+        static constexpr const float particle_drag = 0.5f;
+        /* The profiler bucket of the depth pre-pass, which comes after those of the material types. */
+        static constexpr const uint32_t prepass_bucket = Materials::MaterialPool::n_types;
         /* Defines the descriptor set used for engine-global resources (i.e., bound once per frame). */
         static constexpr const uint32_t desc_set_global = 0;
         /* Defines the descriptor set used for per-renderpass resources (i.e., bound once per render pass). */
@@ -52,6 +85,34 @@ namespace Makma3D::Rendering {
         /* Defines the descriptor set used for per-object resources (i.e., bound very often). */
         static constexpr const uint32_t desc_set_object = 3;
 
+        /* The options for the RenderSystem, which decide which of its optional features it uses. */
+        struct Options {
+            /* The number of frames that may be in flight at once, between FrameManager::min_frames_in_flight and FrameManager::max_frames_in_flight. */
+            uint32_t frames_in_flight = 2;
+            /* Whether to measure how long the GPU spends on each material type. */
+            bool gpu_profiling = false;
+            /* Whether to also count how many shader invocations each material type needs. Only used when the GPU is measured. */
+            bool pipeline_statistics = false;
+            /* Whether to fill the depth buffer in a cheap pre-pass first, so that the materials only shade the fragments that end up visible. */
+            bool depth_prepass = false;
+            /* Whether to cull the draws on the GPU against the view frustum and the depth buffer of the previous frame. */
+            bool gpu_culling = false;
+            /* Whether to read back each result of the GPU culling to compare it against the CPU. */
+            bool cull_check = false;
+            /* Whether to cull entities on the CPU against the occluders in the scene before their draws are even sorted. */
+            bool cpu_occlusion = false;
+            /* The GPU frame time (in microseconds) above which the scene is rendered at a lower resolution and upscaled, or 0 to always render at full resolution. Implies measuring the GPU. */
+            uint32_t target_frame_us = 0;
+            /* The number of cameras rendered at once with multiview, each to the part of the images given by its viewport. Without multiview support, only the first camera is rendered. */
+            uint32_t n_views = 1;
+            /* The number of particles there is room for when simulating the particles of the scene's emitters on the GPU, or 0 to not simulate any. */
+            uint32_t max_particles = 0;
+            /* Whether to read back the number of particles each frame to compare it against the CPU. */
+            bool particle_check = false;
+            /* Whether to keep all textures in a single array that stays bound (if the GPU supports descriptor indexing), so that textured materials are switched with a push constant instead of a descriptor set. */
+            bool bindless = false;
+        };
+
         /* The Window which we render to. */
         Window& window;
         /* The MemoryManager that contains the pools we might need. */
@@ -60,6 +121,9 @@ namespace Makma3D::Rendering {
         const Models::ModelSystem& model_system;
 
     private:
+        /* The images we render to if the window is headless. Is a nullptr otherwise, in which case we render to the window's swapchain. */
+        Rendering::OffscreenTarget* offscreen_target;
+
         /* Descriptor set layout for general data, such as the camera information. */
         Rendering::DescriptorSetLayout global_descriptor_layout;
         /* Descriptor set layout for per-material data, such as its colour. */
@@ -67,14 +131,25 @@ namespace Makma3D::Rendering {
         /* Descriptor set layout for per-object data, such as its position. */
         Rendering::DescriptorSetLayout object_descriptor_layout;
 
-        /* The depth stencil we attach to the pipeline. */
-        Rendering::DepthStencil depth_stencil;
-
         /* A pool where we draw shaders from. */
         Rendering::ShaderPool shader_pool;
 
-        /* The render pass which we use to draw. */
-        Rendering::RenderPass render_pass;
+        /* Describes the passes of a frame and the attachments they use, and compiles them to the render pass which we use to draw. */
+        Rendering::RenderGraph render_graph;
+        /* The pass in the render graph that draws the scene. */
+        uint32_t scene_pass;
+        /* The pass in the render graph that fills the depth buffer before the scene is drawn, or RenderGraph::unused if we don't do a depth pre-pass. */
+        uint32_t prepass_pass;
+        /* The transient attachments of the render graph (such as the depth buffer), sized to the images we render to. */
+        Rendering::GraphAttachments* graph_attachments;
+        /* The depth buffer in the render graph. */
+        uint32_t depth_resource;
+        /* The attachment in the render graph that the scene is rendered to before it's upscaled, or RenderGraph::unused if the scene is rendered to the target images directly. */
+        uint32_t scene_resource;
+        /* The number of cameras we render at once, each to its own layer of the attachments. */
+        uint32_t n_views;
+        /* The size of the largest viewport of the cameras, in fractions of the images we render to. The layers of the attachments have that size. Only used if there's more than one view. */
+        glm::vec2 view_size;
 
         /* A cache for creating pipelines. */
         Rendering::PipelineCache pipeline_cache;
@@ -82,17 +157,117 @@ namespace Makma3D::Rendering {
         Rendering::PipelineConstructor pipeline_constructor;
         /* The graphics pipelines we use to render, sorted by material types. */
         std::unordered_map<Materials::MaterialType, Rendering::Pipeline*> pipelines;
+        /* The pipeline that only writes the depth of the scene in the depth pre-pass. Is a nullptr if we don't do a depth pre-pass. */
+        Rendering::Pipeline* prepass_pipeline;
 
         /* The FrameManager in charge for giving us frames we can render to. */
         Rendering::FrameManager* frame_manager;
+        /* The threads we use to record the chunks of the scene in parallel. */
+        Tools::ThreadPool* record_pool;
+        /* The ring of buffers through which frames are captured without stalling the render loop. */
+        Rendering::ReadbackRing* readback_ring;
+        /* The path to capture the next rendered frame to. Is empty if the next frame isn't captured. */
+        std::string capture_path;
+        /* Measures how long the GPU spends on each material type. Is a nullptr if we don't profile the GPU. */
+        Rendering::GpuProfiler* gpu_profiler;
+        /* The work done for each of the most recent frames. */
+        Rendering::RenderStatsHistory stats_history;
+        /* Decides at what fraction of the target's resolution the scene is rendered, based on how long the GPU took for the last frames. Is a nullptr if we always render at full resolution. */
+        Rendering::ResolutionScaler* resolution_scaler;
+        /* The filter with which the scene is upscaled to the target images. */
+        VkFilter upscale_filter;
+        /* Culls the draws of each frame on the GPU, against the view frustum and the depth buffer of the frame before it. Is a nullptr if we don't cull on the GPU. */
+        Rendering::GpuCuller* gpu_culler;
+        /* The depth pyramid built from the depth buffer of the last submitted frame, which the next frame is culled against. Is a nullptr if we don't cull on the GPU. */
+        Rendering::HiZPyramid* hiz_pyramid;
+        /* The view-projection matrix with which the last submitted frame was rendered, and thus its depth pyramid. */
+        glm::mat4 prev_view_proj;
+        /* Whether the culling of each frame is read back and compared against the reference on the CPU. */
+        bool cull_check;
+        /* Culls the entities on the CPU against the occluders in the scene, before their draws are sorted. Is a nullptr if we don't cull on the CPU. */
+        Rendering::OcclusionCuller* occlusion_culler;
+        /* Simulates the particles of the emitters in the scene on the GPU. Is a nullptr if we don't have particles. */
+        Rendering::ParticleSystem* particle_system;
+        /* The pipeline that draws the particles as additive billboards at the end of the scene pass. Is a nullptr if we don't have particles. */
+        Rendering::Pipeline* particle_pipeline;
+        /* Whether the number of living particles after each frame is read back and compared against the reference on the CPU. */
+        bool particle_check;
+        /* The number of seconds the particles are advanced each frame, or 0 to advance them by the time that actually passed. */
+        float particle_step;
+        /* The number of seconds the particles have been simulated, which decides how many each emitter has spawned. */
+        double particle_time;
+        /* The moment the particles were last advanced. */
+        std::chrono::steady_clock::time_point particle_update;
+        /* Seeds the random numbers of the particles spawned each frame. */
+        uint32_t particle_seed;
+        /* Keeps all textures in a single array that stays bound, so textured materials don't need a set of their own. Is a nullptr if the textures are bound per material. */
+        Rendering::BindlessTextures* bindless_textures;
+        /* The buffer with the parameters of all materials, indexed by their IDs, to which only the materials that changed are uploaded. */
+        Rendering::MaterialBuffer* material_buffer;
+
+        /* Assigns the lights in the scene to the clusters of each view's frustum each frame, so the fragment shaders only loop over the lights that can reach them. */
+        Tools::Array<Rendering::LightClusterer> light_clusterers;
+        /* The lights in the scene in world space, as collected for the current frame. Kept around to re-use its memory. */
+        Tools::Array<Rendering::LightData> lights;
+        /* What each emitter in the scene spawns in the current frame. Kept around to re-use its memory. */
+        Tools::Array<Rendering::EmitterData> emitters;
+        /* The queue in which we collect and sort the draws for each frame. Kept around to re-use its memory. */
+        Rendering::RenderQueue render_queue;
+        /* The version of the scene in the render queue. Bumped every time the queue is rebuilt, so the frames know they have to re-record their scene. */
+        uint64_t scene_version;
+        /* The generation of the ModelSystem when the render queue was last built. */
+        uint64_t queued_generation;
+        /* The entities with a model when the render queue was last built, in the order of their component list. */
+        Tools::Array<ECS::entity_t> queued_entities;
+        /* The transformation matrices of the queued entities when the render queue was last built. */
+        Tools::Array<glm::mat4> queued_transforms;
+        /* The material of each mesh of the queued entities when the render queue was last built, in order, so that reassigning a material is noticed. */
+        Tools::Array<const Materials::Material*> queued_materials;
+        /* The first index of each mesh of the queued entities when the render queue was last built, in order, so that giving an entity another (already loaded) model is noticed. */
+        Tools::Array<uint32_t> queued_first_indices;
+        /* The view-projection matrix of the camera when the render queue was last built. Only kept up-to-date if we cull on the CPU, since only then the queue depends on the camera. */
+        glm::mat4 queued_view_proj;
+        /* The draws to cull on the GPU, in the order in which they were pushed to the render queue. Only filled if we cull on the GPU. */
+        Tools::Array<Rendering::CullItem> cull_items;
 
     private:
+        /* Private helper function that returns the extent of the images we render to, i.e., of the offscreen target if headless or else the swapchain. */
+        inline VkExtent2D _target_extent() const { return this->offscreen_target != nullptr ? this->offscreen_target->extent() : this->window.swapchain().extent(); }
+        /* Private helper function that returns the format of the images we render to, i.e., of the offscreen target if headless or else the swapchain. */
+        inline VkFormat _target_format() const { return this->offscreen_target != nullptr ? this->offscreen_target->format() : this->window.swapchain().format(); }
+        /* Private helper function that returns the layout the images we render to should be in once they're done, i.e., ready to be copied if headless or else to be presented. */
+        inline VkImageLayout _target_layout() const { return this->offscreen_target != nullptr ? OffscreenTarget::final_layout : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; }
+
+        /* Private helper function that returns the profiler bucket of the given material type, which is its index in the MaterialPool's list of types. */
+        static uint32_t _bucket(Materials::MaterialType type);
+        /* Private helper function that re-allocates the render graph's attachments (and what depends on them) for images of the given extent, at the current resolution scale. The old ones are retired, so frames in flight can still finish with them. */
+        void _allocate_attachments(const VkExtent2D& target_extent);
         /* Private helper function that resizes all required structures for a new window size. */
         void _resize();
+        /* Private helper function that re-allocates the attachments after the resolution scale or the size of the views changed. Unlike a resize, this leaves the swapchain and the pipelines alone. */
+        void _rescale();
+        /* Private helper function that returns the extent at which we render the scene for images of the given extent. With several views, that's the size of the largest viewport, and it's smaller still if the resolution is scaled down. */
+        VkExtent2D _render_extent(const VkExtent2D& target_extent) const;
+        /* Private helper function that checks whether the renderable part of the scene changed since the render queue was last built. If so, updates the cached state and returns true. */
+        bool _scene_changed(const ECS::EntityManager& entity_manager);
+        /* Private helper function that collects the lights of the entities in the given entity manager, placed in the world by their transforms. */
+        void _collect_lights(const ECS::EntityManager& entity_manager);
+        /* Private helper function that collects the emitters of the entities in the given entity manager that spawn particles when the particles are advanced by the given number of seconds, placed in the world by their transforms. */
+        void _collect_emitters(const ECS::EntityManager& entity_manager, float dt);
+        /* Private helper function that rebuilds & sorts the render queue from the renderable entities in the given entity manager, as seen from the given camera. */
+        void _build_queue(const ECS::EntityManager& entity_manager, const ECS::Camera& cam);
+        /* Private helper function that records the draws in the given range of the render queue as the given chunk of the given frame. Can be called for different chunks from different threads at the same time. */
+        void _record_chunk(ConceptualFrame* frame, uint32_t chunk, uint32_t first_draw, uint32_t last_draw) const;
+        /* Private helper function that records the draws in the given range of the front-to-back sorted render queue as the given chunk of the depth pre-pass of the given frame. Can be called for different chunks from different threads at the same time. */
+        void _record_prepass_chunk(ConceptualFrame* frame, uint32_t chunk, uint32_t first_draw, uint32_t last_draw) const;
+        /* Private helper function that records drawing the particles at the end of the given chunk of the given frame, which has to be in the scene pass. */
+        void _record_particles(ConceptualFrame* frame, uint32_t chunk) const;
 
     public:
-        /* Constructor for the RenderSystem, which takes a window, a memory manager to render (to and draw memory from, respectively) and a model system to schedule the model buffers withh. */
-        RenderSystem(Window& window, MemoryManager& memory_manager, const Models::ModelSystem& model_system);
+        /* Constructor for the RenderSystem, which takes a window, a memory manager to render (to and draw memory from, respectively) and a model system to schedule the model buffers with. Uses none of the optional features. */
+        inline RenderSystem(Window& window, MemoryManager& memory_manager, const Models::ModelSystem& model_system) : RenderSystem(window, memory_manager, model_system, Options()) {}
+        /* Constructor for the RenderSystem, which takes a window, a memory manager to render (to and draw memory from, respectively), a model system to schedule the model buffers with and the options that decide which features to use. If the window is headless, renders to as many offscreen images as there are frames in flight instead. */
+        RenderSystem(Window& window, MemoryManager& memory_manager, const Models::ModelSystem& model_system, const Options& options);
         /* Copy constructor for the RenderSystem class, which is deleted. */
         RenderSystem(const RenderSystem& other) = delete;
         /* Move constructor for the RenderSystem class. */
@@ -102,6 +277,49 @@ namespace Makma3D::Rendering {
 
         /* Runs a single iteration of the game loop. Returns whether or not the RenderSystem is asked to close the window (false) or not (true). */
         bool render_frame(const ECS::EntityManager& entity_manager);
+        /* Captures the next rendered frame to the given path as a .png. Doesn't block; the frame is copied back once it's done rendering, and written to disk on a separate thread. */
+        void capture_frame(const std::string& path);
+
+        /* Returns whether or not we render headless, i.e., to offscreen images instead of the window's swapchain. */
+        inline bool headless() const { return this->offscreen_target != nullptr; }
+        /* Returns the number of frames that may be in flight at once. */
+        inline uint32_t frames_in_flight() const { return this->frame_manager->frames_in_flight(); }
+        /* Returns how long the CPU waited for frames to become available since the statistics were last reset. */
+        inline const Rendering::FrameWaitStats& frame_wait_stats() const { return this->frame_manager->wait_stats(); }
+        /* Resets the frame wait statistics. */
+        inline void reset_frame_wait_stats() { this->frame_manager->reset_wait_stats(); }
+        /* Returns whether or not we measure how long the GPU spends on each material type. */
+        inline bool gpu_profiling() const { return this->gpu_profiler != nullptr; }
+        /* Returns whether we fill the depth buffer in a pre-pass before drawing the scene. */
+        inline bool depth_prepass() const { return this->prepass_pipeline != nullptr; }
+        /* Returns whether we cull the draws on the GPU. */
+        inline bool gpu_culling() const { return this->gpu_culler != nullptr; }
+        /* Returns whether we cull the entities on the CPU against the occluders in the scene. */
+        inline bool cpu_occlusion() const { return this->occlusion_culler != nullptr; }
+        /* Returns whether the resolution of the scene follows the GPU frame time. */
+        inline bool dynamic_resolution() const { return this->resolution_scaler != nullptr; }
+        /* Returns the number of cameras we render at once. */
+        inline uint32_t views() const { return this->n_views; }
+        /* Returns whether we simulate the particles of the scene's emitters. */
+        inline bool particles() const { return this->particle_system != nullptr; }
+        /* Advances the particles by the given number of seconds each frame, e.g. to replay a benchmark at a fixed timestep. 0 advances them by the time that actually passed. */
+        inline void set_particle_step(float seconds) { this->particle_step = seconds; }
+        /* Returns whether the textures are kept bindless. */
+        inline bool bindless() const { return this->bindless_textures != nullptr; }
+        /* Returns the fraction of the target's width & height at which the scene is currently rendered. */
+        inline float render_scale() const { return this->resolution_scaler != nullptr ? this->resolution_scaler->scale() : 1.0f; }
+        /* Returns the GPU time spent per frame and per material type since the statistics were last reset. Only possible when profiling the GPU. */
+        inline const Rendering::GpuStats& gpu_stats() const { return this->gpu_profiler->stats(); }
+        /* Logs the GPU statistics on the GpuProfiler channel. Does nothing if we don't profile the GPU. */
+        inline void log_gpu_stats() const { if (this->gpu_profiler != nullptr) { this->gpu_profiler->log_stats(); } }
+        /* Resets the GPU statistics. Does nothing if we don't profile the GPU. */
+        inline void reset_gpu_stats() { if (this->gpu_profiler != nullptr) { this->gpu_profiler->reset_stats(); } }
+        /* Returns the work done for the most recently rendered frame (draws, binds, uploads, ...). At least one frame must have been rendered. */
+        inline const Rendering::RenderStats& render_stats() const { return this->stats_history.last(); }
+        /* Returns the work done for each of the most recent frames, which can be summarized as min / avg / p99. */
+        inline const Rendering::RenderStatsHistory& render_stats_history() const { return this->stats_history; }
+        /* Logs the min / avg / p99 of the work done for the most recent frames on the RenderStats channel. */
+        inline void log_render_stats() const { if (!this->stats_history.empty()) { this->stats_history.log(); } }
 
         /* Copy assignment operator for the RenderSystem class, which is deleted. */
         RenderSystem& operator=(const RenderSystem& other) = delete;
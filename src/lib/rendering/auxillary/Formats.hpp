@@ -4,13 +4,13 @@
  * Created:
  *   25/05/2021, 15:53:47
  * Last edited:
- *   8/1/2021, 3:36:38 PM
+ *   19/10/2026, 01:31:44
  * Auto updated?
  *   Yes
  *
  * Description:
  *   Provides a map for converting VkFormat enums to a string
- *   representation of that format.
+ *   representation of that format, and helpers to classify formats.
 **/
 
 #ifndef RENDERING_FORMATS_HPP
@@ -276,6 +276,12 @@ namespace Makma3D::Rendering {
         MAP_VK_FORMAT(VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK_EXT),
         MAP_VK_FORMAT(VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK_EXT)
     });
+
+    /* Returns whether the given format has a depth aspect, i.e., is meant for depth attachments. */
+    inline bool is_depth_format(VkFormat vk_format) {
+        return vk_format == VK_FORMAT_D16_UNORM || vk_format == VK_FORMAT_X8_D24_UNORM_PACK32 || vk_format == VK_FORMAT_D32_SFLOAT ||
+               vk_format == VK_FORMAT_D16_UNORM_S8_UINT || vk_format == VK_FORMAT_D24_UNORM_S8_UINT || vk_format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+    }
 }
 
 #endif
@@ -0,0 +1,38 @@
+/* PRESENT MODES.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:00:20
+ * Last edited:
+ *   19/10/2026, 01:00:20
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains mappings from vulkan VkPresentModeKHR to readable names.
+**/
+
+#ifndef RENDERING_PRESENT_MODES_HPP
+#define RENDERING_PRESENT_MODES_HPP
+
+#include <unordered_map>
+#include <string>
+#include <vulkan/vulkan.h>
+
+/* Simple macro that sets the given enum to its string representation. */
+#define MAP_VK_PRESENT_MODE(MODE) \
+    { (MODE), (#MODE) }
+
+namespace Makma3D::Rendering {
+    /* Static map of VkPresentModeKHRs to their respective string representations. */
+    static std::unordered_map<VkPresentModeKHR, std::string> vk_present_mode_map({
+        MAP_VK_PRESENT_MODE(VK_PRESENT_MODE_IMMEDIATE_KHR),
+        MAP_VK_PRESENT_MODE(VK_PRESENT_MODE_MAILBOX_KHR),
+        MAP_VK_PRESENT_MODE(VK_PRESENT_MODE_FIFO_KHR),
+        MAP_VK_PRESENT_MODE(VK_PRESENT_MODE_FIFO_RELAXED_KHR),
+        MAP_VK_PRESENT_MODE(VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR),
+        MAP_VK_PRESENT_MODE(VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR)
+    });
+}
+
+#endif
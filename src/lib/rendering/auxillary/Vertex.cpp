@@ -4,13 +4,14 @@
  * Created:
  *   01/07/2021, 14:37:11
  * Last edited:
- *   8/1/2021, 3:48:20 PM
+ *   19/10/2026, 01:35:58
  * Auto updated?
  *   Yes
  *
  * Description:
  *   Describes how a single Vertex looks like. Also contains code to create
- *   Vulkan descriptions for itself.
+ *   Vulkan descriptions for itself. On the GPU, vertices are split in a
+ *   stream of positions and a stream of the other attributes.
 **/
 
 #include "Vertex.hpp"
@@ -4,13 +4,14 @@
  * Created:
  *   01/07/2021, 14:35:05
  * Last edited:
- *   01/07/2021, 14:35:05
+ *   19/10/2026, 01:35:58
  * Auto updated?
  *   Yes
  *
  * Description:
  *   Describes how a single Vertex looks like. Also contains code to create
- *   Vulkan descriptions for itself.
+ *   Vulkan descriptions for itself. On the GPU, vertices are split in a
+ *   stream of positions and a stream of the other attributes.
 **/
 
 #ifndef MODELS_VERTEX_HPP
@@ -40,6 +41,19 @@ namespace Makma3D::Rendering {
 
     };
 
+    /* Struct to contain the attributes of a single Vertex other than its position, which live in a separate vertex stream so that passes that only need positions (like the depth pre-pass) don't fetch them. */
+    struct VertexAttributes {
+        /* The colour of the vertex. */
+        glm::vec3 colour;
+        /* The texture coordinate of the vertex. */
+        glm::vec2 texel;
+    };
+
+    /* The binding of the vertex stream with the positions of the vertices. */
+    static constexpr const uint32_t position_binding = 0;
+    /* The binding of the vertex stream with the other attributes of the vertices. */
+    static constexpr const uint32_t attribute_binding = 1;
+
 }
 
 #endif
@@ -0,0 +1,139 @@
+/* BINDLESS TEXTURES.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:02:11
+ * Last edited:
+ *   19/10/2026, 03:13:49
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the BindlessTextures class, which keeps the views & samplers
+ *   of all textures drawn so far in one large, partially bound array
+ *   (VK_EXT_descriptor_indexing). It lives for as long as the
+ *   RenderSystem, and the material buffer tells each textured material
+ *   which of them is its texture, so that switching between textured
+ *   materials only takes a push constant instead of binding a descriptor
+ *   set.
+**/
+
+#include "tools/Logger.hpp"
+
+#include "BindlessTextures.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** BINDLESSTEXTURES CLASS *****/
+/* Constructor for the BindlessTextures class, which takes the GPU where they live. The GPU has to support descriptor indexing. */
+BindlessTextures::BindlessTextures(const Rendering::GPU& gpu) :
+    gpu(gpu),
+    _layout(this->gpu),
+    n_slots(0)
+{
+    #ifndef NDEBUG
+    if (!this->gpu.supports_descriptor_indexing()) { logger.fatalc(BindlessTextures::channel, "Cannot keep the textures bindless on a GPU without descriptor indexing."); }
+    #endif
+
+    // Prepare the layout. Most of the array is never written, and new textures are written to it while the frames in flight are using it
+    this->_layout.add_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, BindlessTextures::max_textures, VK_SHADER_STAGE_FRAGMENT_BIT, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT);
+    this->_layout.finalize();
+
+    // Allocate the only set we'll ever need, from a pool that allows updating it after it's bound
+    this->descriptor_pool = new DescriptorPool(this->gpu, {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, BindlessTextures::max_textures }
+    }, 1, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT);
+    this->_set = this->descriptor_pool->allocate(this->_layout);
+}
+
+/* Move constructor for the BindlessTextures class. */
+BindlessTextures::BindlessTextures(BindlessTextures&& other) :
+    gpu(other.gpu),
+    _layout(std::move(other._layout)),
+    descriptor_pool(other.descriptor_pool),
+    _set(other._set),
+    texture_map(std::move(other.texture_map)),
+    free_slots(std::move(other.free_slots)),
+    n_slots(other.n_slots)
+{
+    // Make sure the other doesn't deallocate anything
+    other.descriptor_pool = nullptr;
+    other._set = nullptr;
+}
+
+/* Destructor for the BindlessTextures class. */
+BindlessTextures::~BindlessTextures() {
+    if (this->descriptor_pool != nullptr) {
+        delete this->descriptor_pool;
+    }
+}
+
+
+
+/* Returns the index of the given texture in the array, writing it to a free slot if it isn't in there yet. Since in-flight frames never read that slot, this is safe while they're using the set. */
+uint32_t BindlessTextures::add(const Materials::Texture* texture) {
+    // Return the slot if it already has one
+    std::unordered_map<const Materials::Texture*, uint32_t>::iterator iter = this->texture_map.find(texture);
+    if (iter != this->texture_map.end()) { return (*iter).second; }
+
+    // Otherwise, re-use the slot of a removed texture, or take a new one if there is none
+    uint32_t index;
+    if (!this->free_slots.empty()) {
+        index = this->free_slots[this->free_slots.size() - 1];
+        this->free_slots.pop_back();
+    } else {
+        if (this->n_slots >= BindlessTextures::max_textures) {
+            logger.fatalc(BindlessTextures::channel, "Cannot add texture '", texture->name(), "': already holding the maximum of ", BindlessTextures::max_textures, " textures.");
+        }
+        index = this->n_slots++;
+    }
+
+    // Write the texture to it, overwriting whatever texture had the slot before
+    this->_set->bind(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, { texture }, index);
+    this->texture_map.insert({ texture, index });
+    logger.logc(Verbosity::debug, BindlessTextures::channel, "Added texture '", texture->name(), "' at index ", index);
+    return index;
+}
+
+/* Forgets the given texture, returning the slot it had (or max_textures if it never got one). The slot is only written again after it's given back with release(), which should wait until no frame in flight may read it anymore. */
+uint32_t BindlessTextures::remove(const Materials::Texture* texture) {
+    // Nothing to do if the texture was never drawn
+    std::unordered_map<const Materials::Texture*, uint32_t>::iterator iter = this->texture_map.find(texture);
+    if (iter == this->texture_map.end()) { return BindlessTextures::max_textures; }
+
+    // Otherwise, forget it
+    uint32_t index = (*iter).second;
+    this->texture_map.erase(iter);
+    logger.logc(Verbosity::debug, BindlessTextures::channel, "Removed texture '", texture->name(), "' from index ", index);
+    return index;
+}
+
+/* Gives the given slot of a removed texture back, so that add() may write another texture to it. */
+void BindlessTextures::release(uint32_t slot) {
+    #ifndef NDEBUG
+    if (slot >= this->n_slots) { logger.fatalc(BindlessTextures::channel, "Cannot release slot ", slot, " that was never handed out (only ", this->n_slots, " were)."); }
+    #endif
+
+    this->free_slots.push_back(slot);
+}
+
+
+
+/* Swap operator for the BindlessTextures class. */
+void Rendering::swap(BindlessTextures& bt1, BindlessTextures& bt2) {
+    #ifndef NDEBUG
+    if (bt1.gpu != bt2.gpu) { logger.fatalc(BindlessTextures::channel, "Cannot swap bindless textures with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(bt1._layout, bt2._layout);
+    swap(bt1.descriptor_pool, bt2.descriptor_pool);
+    swap(bt1._set, bt2._set);
+    swap(bt1.texture_map, bt2.texture_map);
+    swap(bt1.free_slots, bt2.free_slots);
+    swap(bt1.n_slots, bt2.n_slots);
+}
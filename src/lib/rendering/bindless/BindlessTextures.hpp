@@ -0,0 +1,102 @@
+/* BINDLESS TEXTURES.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:02:11
+ * Last edited:
+ *   19/10/2026, 03:13:49
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the BindlessTextures class, which keeps the views & samplers
+ *   of all textures drawn so far in one large, partially bound array
+ *   (VK_EXT_descriptor_indexing). It lives for as long as the
+ *   RenderSystem, and the material buffer tells each textured material
+ *   which of them is its texture, so that switching between textured
+ *   materials only takes a push constant instead of binding a descriptor
+ *   set.
+**/
+
+#ifndef RENDERING_BINDLESS_TEXTURES_HPP
+#define RENDERING_BINDLESS_TEXTURES_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+#include "materials/textures/Texture.hpp"
+#include "../gpu/GPU.hpp"
+#include "../descriptors/DescriptorSetLayout.hpp"
+#include "../descriptors/DescriptorPool.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+
+namespace Makma3D::Rendering {
+    /* The BindlessTextures class, which owns the array with all textures. */
+    class BindlessTextures {
+    public:
+        /* Channel name for the BindlessTextures class. */
+        static constexpr const char* channel = "BindlessTextures";
+        /* The number of textures the array can hold. Matches MAX_TEXTURES in bindless.glsl. */
+        static constexpr const uint32_t max_textures = 1024;
+        /* The index of the descriptor set slot where the pipelines expect the array. */
+        static constexpr const uint32_t set_index = 3;
+
+        /* The GPU where the BindlessTextures live. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The layout of the set, which only has the partially bound texture array. */
+        Rendering::DescriptorSetLayout _layout;
+        /* The pool with the single set, which allows it to be updated after it's bound. */
+        Rendering::DescriptorPool* descriptor_pool;
+        /* The set itself, which is bound once and then only written to. */
+        Rendering::DescriptorSet* _set;
+
+        /* Maps the textures to their index in the array. */
+        std::unordered_map<const Materials::Texture*, uint32_t> texture_map;
+        /* The slots of removed textures that may be written again, which are handed out before new ones. */
+        Tools::Array<uint32_t> free_slots;
+        /* The number of slots that have ever been handed out. */
+        uint32_t n_slots;
+
+    public:
+        /* Constructor for the BindlessTextures class, which takes the GPU where they live. The GPU has to support descriptor indexing. */
+        BindlessTextures(const Rendering::GPU& gpu);
+        /* Copy constructor for the BindlessTextures class, which is deleted. */
+        BindlessTextures(const BindlessTextures& other) = delete;
+        /* Move constructor for the BindlessTextures class. */
+        BindlessTextures(BindlessTextures&& other);
+        /* Destructor for the BindlessTextures class. */
+        ~BindlessTextures();
+
+        /* Returns the index of the given texture in the array, writing it to a free slot if it isn't in there yet. Since in-flight frames never read that slot, this is safe while they're using the set. */
+        uint32_t add(const Materials::Texture* texture);
+        /* Forgets the given texture, returning the slot it had (or max_textures if it never got one). The slot is only written again after it's given back with release(), which should wait until no frame in flight may read it anymore. */
+        uint32_t remove(const Materials::Texture* texture);
+        /* Gives the given slot of a removed texture back, so that add() may write another texture to it. */
+        void release(uint32_t slot);
+
+        /* Returns the layout of the set with the texture array. */
+        inline const Rendering::DescriptorSetLayout& layout() const { return this->_layout; }
+        /* Returns the set with the texture array. */
+        inline const Rendering::DescriptorSet* set() const { return this->_set; }
+        /* Returns the number of textures in the array. */
+        inline uint32_t n_textures() const { return static_cast<uint32_t>(this->texture_map.size()); }
+
+        /* Copy assignment operator for the BindlessTextures class, which is deleted. */
+        BindlessTextures& operator=(const BindlessTextures& other) = delete;
+        /* Move assignment operator for the BindlessTextures class. */
+        inline BindlessTextures& operator=(BindlessTextures&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the BindlessTextures class. */
+        friend void swap(BindlessTextures& bt1, BindlessTextures& bt2);
+
+    };
+
+    /* Swap operator for the BindlessTextures class. */
+    void swap(BindlessTextures& bt1, BindlessTextures& bt2);
+
+}
+
+#endif
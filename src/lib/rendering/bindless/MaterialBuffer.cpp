@@ -0,0 +1,113 @@
+/* MATERIAL BUFFER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:04:58
+ * Last edited:
+ *   19/10/2026, 03:27:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MaterialBuffer class, which keeps the parameters of all
+ *   materials in a single device-local storage buffer, indexed by the
+ *   IDs the MaterialPool gives them. It lives for as long as the
+ *   RenderSystem, and only the materials that were allocated or modified
+ *   since the last frame are uploaded again.
+**/
+
+#include "tools/Logger.hpp"
+
+#include "MaterialBuffer.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** MATERIALBUFFER CLASS *****/
+/* Constructor for the MaterialBuffer class, which takes the GPU where it lives. */
+MaterialBuffer::MaterialBuffer(const Rendering::GPU& gpu) :
+    gpu(gpu),
+    synced_version(0)
+{
+    // Allocate the buffer at its full size, so the descriptors pointing to it never have to change
+    VkDeviceSize n_bytes = MaterialUploads::max_materials * sizeof(MaterialData);
+    this->pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { n_bytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT } }), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    this->_buffer = this->pool->allocate(n_bytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+}
+
+/* Move constructor for the MaterialBuffer class. */
+MaterialBuffer::MaterialBuffer(MaterialBuffer&& other) :
+    gpu(other.gpu),
+    pool(other.pool),
+    _buffer(other._buffer),
+    synced_version(other.synced_version)
+{
+    // Make sure the other doesn't deallocate anything
+    other.pool = nullptr;
+    other._buffer = nullptr;
+}
+
+/* Destructor for the MaterialBuffer class. */
+MaterialBuffer::~MaterialBuffer() {
+    if (this->_buffer != nullptr) {
+        this->pool->free(this->_buffer);
+    }
+    if (this->pool != nullptr) {
+        delete this->pool;
+    }
+}
+
+
+
+/* Stages the materials in the given pool that were allocated or modified since the last call in the given uploads, replacing whatever they staged before. Textured materials find their texture in the given bindless textures, if there are any. Since the uploads are copied in order of submission, they have to be submitted in the order they're collected. Returns the number of materials staged. */
+uint32_t MaterialBuffer::collect(const Materials::MaterialPool& pool, Rendering::BindlessTextures* bindless_textures, Rendering::MaterialUploads& uploads) {
+    uploads.clear();
+
+    // Nothing changed if the pool's version didn't, which is almost always the case
+    if (pool.version() == this->synced_version) { return 0; }
+    if (pool.max_id() > MaterialUploads::max_materials) {
+        logger.fatalc(MaterialBuffer::channel, "Cannot upload ", pool.max_id(), " materials; the material buffer only has room for ", MaterialUploads::max_materials, " materials.");
+    }
+
+    // Stage those that changed since. Simple materials have no parameters, so they're never uploaded
+    for (const Materials::SimpleColoured* material : pool.get_simple_coloured()) {
+        if (material->version() <= this->synced_version) { continue; }
+        MaterialData data{};
+        data.colour = glm::vec4(material->colour, 1.0f);
+        uploads.add(material->id(), data);
+    }
+    for (const Materials::SimpleTextured* material : pool.get_simple_textured()) {
+        if (material->version() <= this->synced_version) { continue; }
+        MaterialData data{};
+        // Without bindless textures, the texture is bound with the material's set instead
+        if (bindless_textures != nullptr) { data.texture = bindless_textures->add(material->texture); }
+        uploads.add(material->id(), data);
+    }
+
+    // Done
+    logger.logc(Verbosity::debug, MaterialBuffer::channel, "Uploading ", uploads.size(), " changed materials");
+    this->synced_version = pool.version();
+    return uploads.size();
+}
+
+/* Binds the buffer to the given binding of the given descriptor set as a storage buffer. */
+void MaterialBuffer::bind(const Rendering::DescriptorSet* set, uint32_t binding) const {
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, binding, { this->_buffer });
+}
+
+
+
+/* Swap operator for the MaterialBuffer class. */
+void Rendering::swap(MaterialBuffer& mb1, MaterialBuffer& mb2) {
+    #ifndef NDEBUG
+    if (mb1.gpu != mb2.gpu) { logger.fatalc(MaterialBuffer::channel, "Cannot swap material buffers with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(mb1.pool, mb2.pool);
+    swap(mb1._buffer, mb2._buffer);
+    swap(mb1.synced_version, mb2.synced_version);
+}
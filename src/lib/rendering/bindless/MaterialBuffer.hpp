@@ -0,0 +1,84 @@
+/* MATERIAL BUFFER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:04:58
+ * Last edited:
+ *   19/10/2026, 03:04:58
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MaterialBuffer class, which keeps the parameters of all
+ *   materials in a single device-local storage buffer, indexed by the
+ *   IDs the MaterialPool gives them. It lives for as long as the
+ *   RenderSystem, and only the materials that were allocated or modified
+ *   since the last frame are uploaded again.
+**/
+
+#ifndef RENDERING_MATERIAL_BUFFER_HPP
+#define RENDERING_MATERIAL_BUFFER_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "materials/MaterialPool.hpp"
+#include "../gpu/GPU.hpp"
+#include "../memory/LinearMemoryPool.hpp"
+#include "../memory/Buffer.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+
+#include "BindlessTextures.hpp"
+#include "MaterialUploads.hpp"
+
+namespace Makma3D::Rendering {
+    /* The MaterialBuffer class, which owns the buffer with the parameters of all materials. */
+    class MaterialBuffer {
+    public:
+        /* Channel name for the MaterialBuffer class. */
+        static constexpr const char* channel = "MaterialBuffer";
+
+        /* The GPU where the MaterialBuffer lives. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The pool with the buffer. */
+        Rendering::LinearMemoryPool* pool;
+        /* The device-local buffer with room for MaterialUploads::max_materials materials. */
+        Rendering::Buffer* _buffer;
+        /* The version of the MaterialPool up to which the materials have been collected. */
+        uint64_t synced_version;
+
+    public:
+        /* Constructor for the MaterialBuffer class, which takes the GPU where it lives. */
+        MaterialBuffer(const Rendering::GPU& gpu);
+        /* Copy constructor for the MaterialBuffer class, which is deleted. */
+        MaterialBuffer(const MaterialBuffer& other) = delete;
+        /* Move constructor for the MaterialBuffer class. */
+        MaterialBuffer(MaterialBuffer&& other);
+        /* Destructor for the MaterialBuffer class. */
+        ~MaterialBuffer();
+
+        /* Stages the materials in the given pool that were allocated or modified since the last call in the given uploads, replacing whatever they staged before. Textured materials find their texture in the given bindless textures, if there are any. Since the uploads are copied in order of submission, they have to be submitted in the order they're collected. Returns the number of materials staged. */
+        uint32_t collect(const Materials::MaterialPool& pool, Rendering::BindlessTextures* bindless_textures, Rendering::MaterialUploads& uploads);
+        /* Binds the buffer to the given binding of the given descriptor set as a storage buffer. */
+        void bind(const Rendering::DescriptorSet* set, uint32_t binding) const;
+
+        /* Returns the buffer with the parameters of all materials. */
+        inline const Rendering::Buffer* buffer() const { return this->_buffer; }
+
+        /* Copy assignment operator for the MaterialBuffer class, which is deleted. */
+        MaterialBuffer& operator=(const MaterialBuffer& other) = delete;
+        /* Move assignment operator for the MaterialBuffer class. */
+        inline MaterialBuffer& operator=(MaterialBuffer&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the MaterialBuffer class. */
+        friend void swap(MaterialBuffer& mb1, MaterialBuffer& mb2);
+
+    };
+
+    /* Swap operator for the MaterialBuffer class. */
+    void swap(MaterialBuffer& mb1, MaterialBuffer& mb2);
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+/* MATERIAL UPLOADS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:04:58
+ * Last edited:
+ *   19/10/2026, 03:27:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MaterialUploads class, which stages the parameters of the
+ *   materials that changed for a single frame. They're copied to the
+ *   MaterialBuffer in one go at the start of the frame's command buffer,
+ *   so uploading them never waits for the GPU.
+**/
+
+#include "tools/Logger.hpp"
+
+#include "MaterialUploads.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given VkBufferCopy struct to copy a single material from the given index in the staging buffer to the given ID in the material buffer. */
+static void populate_buffer_copy(VkBufferCopy& copy_region, uint32_t index, uint32_t id) {
+    copy_region = {};
+    copy_region.srcOffset = (VkDeviceSize) index * sizeof(MaterialData);
+    copy_region.dstOffset = (VkDeviceSize) id * sizeof(MaterialData);
+    copy_region.size = sizeof(MaterialData);
+}
+
+/* Populates the given VkMemoryBarrier struct. */
+static void populate_memory_barrier(VkMemoryBarrier& memory_barrier, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    memory_barrier = {};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memory_barrier.srcAccessMask = src_access;
+    memory_barrier.dstAccessMask = dst_access;
+}
+
+
+
+
+
+/***** MATERIALUPLOADS CLASS *****/
+/* Constructor for the MaterialUploads class, which takes the GPU where they live. */
+MaterialUploads::MaterialUploads(const Rendering::GPU& gpu) :
+    gpu(gpu)
+{
+    // Allocate the staging buffer once at its full size, so that staging never has to wait for it to grow. The memory is coherent, so we don't have to flush our writes
+    VkDeviceSize n_bytes = MaterialUploads::max_materials * sizeof(MaterialData);
+    this->stage_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { n_bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    this->stage_buffer = this->stage_pool->allocate(n_bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    this->stage_buffer->map((void**) &this->stage_mapped);
+
+    // Make sure staging never has to grow the list of copies either
+    this->copies.reserve(MaterialUploads::max_materials);
+}
+
+/* Move constructor for the MaterialUploads class. */
+MaterialUploads::MaterialUploads(MaterialUploads&& other) :
+    gpu(other.gpu),
+    stage_pool(other.stage_pool),
+    stage_buffer(other.stage_buffer),
+    stage_mapped(other.stage_mapped),
+    copies(std::move(other.copies))
+{
+    // Make sure the other doesn't deallocate anything
+    other.stage_pool = nullptr;
+    other.stage_buffer = nullptr;
+    other.stage_mapped = nullptr;
+}
+
+/* Destructor for the MaterialUploads class. */
+MaterialUploads::~MaterialUploads() {
+    if (this->stage_buffer != nullptr) {
+        this->stage_buffer->unmap();
+        this->stage_pool->free(this->stage_buffer);
+    }
+    if (this->stage_pool != nullptr) {
+        delete this->stage_pool;
+    }
+}
+
+
+
+/* Stages the given parameters for the material with the given ID. Each material may be staged at most once between clears. The frame may not be in flight. */
+void MaterialUploads::add(uint32_t id, const Rendering::MaterialData& data) {
+    #ifndef NDEBUG
+    if (id >= MaterialUploads::max_materials) {
+        logger.fatalc(MaterialUploads::channel, "Material ID ", id, " is out of range (the material buffer only has room for ", MaterialUploads::max_materials, " materials)");
+    }
+    #endif
+
+    // Put it after the ones staged before, and remember where it goes
+    uint32_t index = static_cast<uint32_t>(this->copies.size());
+    this->stage_mapped[index] = data;
+    VkBufferCopy copy_region;
+    populate_buffer_copy(copy_region, index, id);
+    this->copies.push_back(copy_region);
+}
+
+/* Schedules copying the staged materials to the given material buffer on the given command buffer, which may not be in a render pass. The copy waits for the frames before it to stop drawing with the buffer, and the draws after it wait for the copy. Does nothing if nothing is staged. */
+void MaterialUploads::schedule_upload(const Rendering::CommandBuffer* cmd, const Rendering::Buffer* material_buffer) const {
+    if (this->copies.empty()) { return; }
+
+    // The frames before us may still be reading the buffer. Overwriting it only has to wait for them, so the barrier needs no access on their side
+    VkMemoryBarrier memory_barrier;
+    populate_memory_barrier(memory_barrier, 0, VK_ACCESS_TRANSFER_WRITE_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+
+    // Copy all of them at once
+    vkCmdCopyBuffer(cmd->vulkan(), this->stage_buffer->vulkan(), material_buffer->vulkan(), static_cast<uint32_t>(this->copies.size()), this->copies.rdata());
+
+    // Make them visible to the shaders that draw with them
+    populate_memory_barrier(memory_barrier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+}
+
+
+
+/* Swap operator for the MaterialUploads class. */
+void Rendering::swap(MaterialUploads& mu1, MaterialUploads& mu2) {
+    #ifndef NDEBUG
+    if (mu1.gpu != mu2.gpu) { logger.fatalc(MaterialUploads::channel, "Cannot swap material uploads with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(mu1.stage_pool, mu2.stage_pool);
+    swap(mu1.stage_buffer, mu2.stage_buffer);
+    swap(mu1.stage_mapped, mu2.stage_mapped);
+    swap(mu1.copies, mu2.copies);
+}
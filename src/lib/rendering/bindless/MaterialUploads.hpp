@@ -0,0 +1,88 @@
+/* MATERIAL UPLOADS.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:04:58
+ * Last edited:
+ *   19/10/2026, 03:04:58
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MaterialUploads class, which stages the parameters of the
+ *   materials that changed for a single frame. They're copied to the
+ *   MaterialBuffer in one go at the start of the frame's command buffer,
+ *   so uploading them never waits for the GPU.
+**/
+
+#ifndef RENDERING_MATERIAL_UPLOADS_HPP
+#define RENDERING_MATERIAL_UPLOADS_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../memory/LinearMemoryPool.hpp"
+#include "../memory/Buffer.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+#include "../data/MaterialData.hpp"
+
+namespace Makma3D::Rendering {
+    /* The MaterialUploads class, which owns the staging buffer for the materials uploaded in a single frame. */
+    class MaterialUploads {
+    public:
+        /* Channel name for the MaterialUploads class. */
+        static constexpr const char* channel = "MaterialUploads";
+        /* The number of materials the material buffer can hold, and thus the most that can be uploaded at once. */
+        static constexpr const uint32_t max_materials = 4096;
+
+        /* The GPU where the MaterialUploads live. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The pool with the staging buffer. */
+        Rendering::LinearMemoryPool* stage_pool;
+        /* The host-visible buffer with room for max_materials materials. */
+        Rendering::Buffer* stage_buffer;
+        /* The staging buffer's memory, which stays mapped for as long as the buffer exists. */
+        Rendering::MaterialData* stage_mapped;
+        /* Where each staged material goes in the material buffer. */
+        Tools::Array<VkBufferCopy> copies;
+
+    public:
+        /* Constructor for the MaterialUploads class, which takes the GPU where they live. */
+        MaterialUploads(const Rendering::GPU& gpu);
+        /* Copy constructor for the MaterialUploads class, which is deleted. */
+        MaterialUploads(const MaterialUploads& other) = delete;
+        /* Move constructor for the MaterialUploads class. */
+        MaterialUploads(MaterialUploads&& other);
+        /* Destructor for the MaterialUploads class. */
+        ~MaterialUploads();
+
+        /* Throws away the materials staged before. The frame may not be in flight. */
+        inline void clear() { this->copies.clear(); }
+        /* Stages the given parameters for the material with the given ID. Each material may be staged at most once between clears. The frame may not be in flight. */
+        void add(uint32_t id, const Rendering::MaterialData& data);
+        /* Schedules copying the staged materials to the given material buffer on the given command buffer, which may not be in a render pass. The copy waits for the frames before it to stop drawing with the buffer, and the draws after it wait for the copy. Does nothing if nothing is staged. */
+        void schedule_upload(const Rendering::CommandBuffer* cmd, const Rendering::Buffer* material_buffer) const;
+
+        /* Returns the number of staged materials. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->copies.size()); }
+
+        /* Copy assignment operator for the MaterialUploads class, which is deleted. */
+        MaterialUploads& operator=(const MaterialUploads& other) = delete;
+        /* Move assignment operator for the MaterialUploads class. */
+        inline MaterialUploads& operator=(MaterialUploads&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the MaterialUploads class. */
+        friend void swap(MaterialUploads& mu1, MaterialUploads& mu2);
+
+    };
+
+    /* Swap operator for the MaterialUploads class. */
+    void swap(MaterialUploads& mu1, MaterialUploads& mu2);
+
+}
+
+#endif
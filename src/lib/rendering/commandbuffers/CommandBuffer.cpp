@@ -4,7 +4,7 @@
  * Created:
  *   19/06/2021, 12:13:03
  * Last edited:
- *   19/06/2021, 12:13:03
+ *   19/10/2026, 00:50:38
  * Auto updated?
  *   Yes
  *
@@ -36,6 +36,23 @@ static void populate_begin_info(VkCommandBufferBeginInfo& begin_info, VkCommandB
     begin_info.flags = usage_flags;
 }
 
+/* Function that populates a given VkCommandBufferInheritanceInfo struct with the given values. */
+static void populate_inheritance_info(VkCommandBufferInheritanceInfo& inheritance_info, VkRenderPass vk_render_pass, uint32_t subpass) {
+    // Set the deafult
+    inheritance_info = {};
+    inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+    // Set the render pass we continue
+    inheritance_info.renderPass = vk_render_pass;
+    inheritance_info.subpass = subpass;
+
+    // Leave the framebuffer unspecified, so the buffer can be executed on any framebuffer compatible with the render pass
+    inheritance_info.framebuffer = VK_NULL_HANDLE;
+
+    // We don't use any queries
+    inheritance_info.occlusionQueryEnable = VK_FALSE;
+}
+
 /* Function that populates a given VkSubmitINfo struct with the given values. */
 static void populate_submit_info(VkSubmitInfo& submit_info, const VkCommandBuffer& vk_command_buffer) {
     // Set to default
@@ -79,6 +96,24 @@ void CommandBuffer::begin(VkCommandBufferUsageFlags usage_flags) const {
     }
 }
 
+/* Begins recording the command buffer as a secondary command buffer that continues the given subpass of the given render pass. The VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT is added to the given usage flags automatically. */
+void CommandBuffer::begin(VkRenderPass vk_render_pass, uint32_t subpass, VkCommandBufferUsageFlags usage_flags) const {
+    // Populate the inheritance info struct
+    VkCommandBufferInheritanceInfo inheritance_info;
+    populate_inheritance_info(inheritance_info, vk_render_pass, subpass);
+
+    // Populate the begin info struct
+    VkCommandBufferBeginInfo begin_info;
+    populate_begin_info(begin_info, usage_flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT);
+    begin_info.pInheritanceInfo = &inheritance_info;
+
+    // Initialize the recording
+    VkResult vk_result;
+    if ((vk_result = vkBeginCommandBuffer(this->vk_command_buffer, &begin_info)) != VK_SUCCESS) {
+        logger.fatalc(CommandBuffer::channel, "Could not begin recording secondary command buffer: ", vk_error_map[vk_result]);
+    }
+}
+
 /* Ends recording the command buffer, but does not yet submit to any queue unless one is given. If so, then you can optionally specify to wait or not to wait for the queue to become idle. */
 void CommandBuffer::end(VkQueue vk_queue, bool wait_queue_idle) const {
     // Whatever the parameters, always call the stop recording
@@ -4,7 +4,7 @@
  * Created:
  *   19/06/2021, 12:13:06
  * Last edited:
- *   19/06/2021, 12:13:06
+ *   19/10/2026, 00:50:38
  * Auto updated?
  *   Yes
  *
@@ -47,6 +47,8 @@ namespace Makma3D::Rendering {
 
         /* Begins recording the command buffer. Overwrites whatever is already recorded here, for some reason. Takes optional usage flags for this recording. */
         void begin(VkCommandBufferUsageFlags usage_flags = 0) const;
+        /* Begins recording the command buffer as a secondary command buffer that continues the given subpass of the given render pass. The VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT is added to the given usage flags automatically. */
+        void begin(VkRenderPass vk_render_pass, uint32_t subpass, VkCommandBufferUsageFlags usage_flags = 0) const;
         /* Ends recording the command buffer, but does not yet submit to any queue unless one is given. If so, then you can optionally specify to wait or not to wait for the queue to become idle. */
         void end(VkQueue vk_queue = nullptr, bool wait_queue_idle = true) const;
         /* Return the VkSubmitInfo for this command buffer. */
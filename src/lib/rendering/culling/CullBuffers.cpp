@@ -0,0 +1,382 @@
+/* CULL BUFFERS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 03:27:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the CullBuffers class, which owns the buffers a single frame
+ *   needs to cull its draws on the GPU: the per-frame parameters, the
+ *   draws to cull and the indirect draw commands the culling writes.
+ *   Can also read back the results to compare them against a reference
+ *   on the CPU.
+**/
+
+#include <cstring>
+#include <algorithm>
+
+#include "tools/Logger.hpp"
+
+#include "CullReference.hpp"
+#include "CullBuffers.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given VkBufferCopy struct to copy the given number of bytes from the start of one buffer to the start of another. */
+static void populate_buffer_copy(VkBufferCopy& copy_region, VkDeviceSize n_bytes) {
+    copy_region = {};
+    copy_region.srcOffset = 0;
+    copy_region.dstOffset = 0;
+    copy_region.size = n_bytes;
+}
+
+/* Populates the given VkBufferImageCopy struct to copy the given level of a depth pyramid of the given size to the given offset in a buffer. */
+static void populate_level_copy(VkBufferImageCopy& copy_region, uint32_t level, const VkExtent2D& vk_extent, VkDeviceSize offset) {
+    // Set to default
+    copy_region = {};
+
+    // The buffer is tightly packed from the given offset
+    copy_region.bufferOffset = offset;
+    copy_region.bufferRowLength = 0;
+    copy_region.bufferImageHeight = 0;
+
+    // Copy the entire level
+    copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy_region.imageSubresource.mipLevel = level;
+    copy_region.imageSubresource.baseArrayLayer = 0;
+    copy_region.imageSubresource.layerCount = 1;
+    copy_region.imageOffset = { 0, 0, 0 };
+    copy_region.imageExtent = { vk_extent.width, vk_extent.height, 1 };
+}
+
+/* Populates the given VkMemoryBarrier struct. */
+static void populate_memory_barrier(VkMemoryBarrier& memory_barrier, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    memory_barrier = {};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memory_barrier.srcAccessMask = src_access;
+    memory_barrier.dstAccessMask = dst_access;
+}
+
+
+
+
+
+/***** CULLBUFFERS CLASS *****/
+/* Constructor for the CullBuffers class, which takes the GPU where they live, the layout of the descriptor set to cull with (see GpuCuller) and whether to read back the results of each culling to check them. */
+CullBuffers::CullBuffers(const Rendering::GPU& gpu, const Rendering::DescriptorSetLayout& cull_layout, bool check_results) :
+    gpu(gpu),
+    items_pool(nullptr),
+    items_buffer(nullptr),
+    items_mapped(nullptr),
+    draws_pool(nullptr),
+    draws_buffer(nullptr),
+    capacity(0),
+    n_items(0),
+    check_results(check_results),
+    readback_pool(nullptr),
+    readback_buffer(nullptr),
+    readback_mapped(nullptr),
+    readback_capacity(0),
+    readback_pending(false),
+    params({})
+{
+    // Allocate the parameters once, since they never change size. The memory is coherent, so we don't have to flush our writes
+    this->params_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { sizeof(CullParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    this->params_buffer = this->params_pool->allocate(sizeof(CullParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    this->params_buffer->map(&this->params_mapped);
+
+    // Make sure there's always a buffer to bind, even if there's nothing to cull
+    this->_reserve(1);
+
+    // Allocate the descriptor set
+    this->descriptor_pool = new DescriptorPool(this->gpu, {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 }
+    }, 1);
+    this->set = this->descriptor_pool->allocate(cull_layout);
+}
+
+/* Move constructor for the CullBuffers class. */
+CullBuffers::CullBuffers(CullBuffers&& other) :
+    gpu(other.gpu),
+    params_pool(other.params_pool),
+    params_buffer(other.params_buffer),
+    params_mapped(other.params_mapped),
+    items_pool(other.items_pool),
+    items_buffer(other.items_buffer),
+    items_mapped(other.items_mapped),
+    draws_pool(other.draws_pool),
+    draws_buffer(other.draws_buffer),
+    capacity(other.capacity),
+    n_items(other.n_items),
+    descriptor_pool(other.descriptor_pool),
+    set(other.set),
+    check_results(other.check_results),
+    readback_pool(other.readback_pool),
+    readback_buffer(other.readback_buffer),
+    readback_mapped(other.readback_mapped),
+    readback_capacity(other.readback_capacity),
+    readback_pending(other.readback_pending),
+    params(other.params),
+    readback_extents(std::move(other.readback_extents))
+{
+    // Make sure the other doesn't deallocate anything
+    other.params_pool = nullptr;
+    other.params_buffer = nullptr;
+    other.items_pool = nullptr;
+    other.items_buffer = nullptr;
+    other.draws_pool = nullptr;
+    other.draws_buffer = nullptr;
+    other.descriptor_pool = nullptr;
+    other.readback_pool = nullptr;
+    other.readback_buffer = nullptr;
+}
+
+/* Destructor for the CullBuffers class. */
+CullBuffers::~CullBuffers() {
+    if (this->descriptor_pool != nullptr) {
+        delete this->descriptor_pool;
+    }
+    if (this->readback_buffer != nullptr) {
+        this->readback_buffer->unmap();
+        this->readback_pool->free(this->readback_buffer);
+    }
+    if (this->readback_pool != nullptr) {
+        delete this->readback_pool;
+    }
+    if (this->draws_buffer != nullptr) {
+        this->draws_pool->free(this->draws_buffer);
+    }
+    if (this->draws_pool != nullptr) {
+        delete this->draws_pool;
+    }
+    if (this->items_buffer != nullptr) {
+        this->items_buffer->unmap();
+        this->items_pool->free(this->items_buffer);
+    }
+    if (this->items_pool != nullptr) {
+        delete this->items_pool;
+    }
+    if (this->params_buffer != nullptr) {
+        this->params_buffer->unmap();
+        this->params_pool->free(this->params_buffer);
+    }
+    if (this->params_pool != nullptr) {
+        delete this->params_pool;
+    }
+}
+
+
+
+/* Private helper function that (re)allocates the buffers with the draws and the draw commands such that they can hold at least the given number of draws. The frame may not be in flight. */
+void CullBuffers::_reserve(uint32_t n_items) {
+    if (this->capacity >= n_items) { return; }
+
+    // Grow at least twice as large, so a slowly growing scene doesn't reallocate every time
+    uint32_t new_capacity = std::max(n_items, 2 * this->capacity);
+    logger.logc(Verbosity::debug, CullBuffers::channel, "Growing cull buffers from ", this->capacity, " to ", new_capacity, " draws...");
+
+    // Release the old buffers
+    if (this->items_buffer != nullptr) {
+        this->items_buffer->unmap();
+        this->items_pool->free(this->items_buffer);
+        delete this->items_pool;
+        this->draws_pool->free(this->draws_buffer);
+        delete this->draws_pool;
+    }
+
+    // Allocate the draws to cull in host-visible memory, since they are rewritten whenever the scene changes
+    VkDeviceSize items_size = (VkDeviceSize) new_capacity * sizeof(CullItem);
+    this->items_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { items_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    this->items_buffer = this->items_pool->allocate(items_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    this->items_buffer->map(&this->items_mapped);
+
+    // Allocate the draw commands in device-local memory, since only the GPU touches them (except when they're copied to be checked)
+    VkDeviceSize draws_size = (VkDeviceSize) new_capacity * sizeof(VkDrawIndexedIndirectCommand);
+    this->draws_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { draws_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT } }), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    this->draws_buffer = this->draws_pool->allocate(draws_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+    // Done
+    this->capacity = new_capacity;
+}
+
+/* Private helper function that (re)allocates the readback buffer such that it can hold at least the given number of bytes. The frame may not be in flight. */
+void CullBuffers::_reserve_readback(VkDeviceSize n_bytes) {
+    if (this->readback_capacity >= n_bytes) { return; }
+
+    // Release the old buffer
+    if (this->readback_buffer != nullptr) {
+        this->readback_buffer->unmap();
+        this->readback_pool->free(this->readback_buffer);
+        delete this->readback_pool;
+    }
+
+    // Allocate a new one in its own pool, and map it once for as long as it lives
+    this->readback_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { n_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    this->readback_buffer = this->readback_pool->allocate(n_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    this->readback_buffer->map(&this->readback_mapped);
+    this->readback_capacity = n_bytes;
+}
+
+
+
+/* Uploads the given draws to cull, in the order in which their draw commands are written. Invalidates the draw commands buffer if it has to grow, so any recorded scene that uses it has to be re-recorded. The frame may not be in flight. */
+void CullBuffers::upload_items(const Tools::Array<Rendering::CullItem>& items) {
+    this->_reserve(items.size());
+    if (items.size() > 0) {
+        std::memcpy(this->items_mapped, items.rdata(), items.size() * sizeof(CullItem));
+    }
+    this->n_items = items.size();
+}
+
+/* Uploads the given culling parameters. The number of draws in it is overwritten with that of the last upload_items(). The frame may not be in flight. */
+void CullBuffers::upload_params(const Rendering::CullParams& params) {
+    this->params = params;
+    this->params.n_items = this->n_items;
+    std::memcpy(this->params_mapped, &this->params, sizeof(CullParams));
+}
+
+/* Schedules culling the uploaded draws against the given depth pyramid with the given culler on the given command buffer, before the render pass that draws them. If the results are checked, also copies them to the readback buffer. */
+void CullBuffers::schedule_cull(const Rendering::CommandBuffer* cmd, const Rendering::GpuCuller& culler, Rendering::HiZPyramid& pyramid) {
+    // The buffers and the pyramid may have been replaced since the last time, so always bind them anew
+    culler.bind(this->set, this->params_buffer, this->items_buffer, this->draws_buffer, pyramid);
+    bool pyramid_built = pyramid.built();
+    culler.schedule_cull(cmd, this->set, this->n_items, pyramid);
+    if (!this->check_results) { return; }
+
+    // Make room for the draw commands and all levels of the pyramid that was culled against, if any
+    VkDeviceSize draws_size = (VkDeviceSize) this->n_items * sizeof(VkDrawIndexedIndirectCommand);
+    VkDeviceSize n_bytes = draws_size;
+    this->readback_extents.clear();
+    if (pyramid_built) {
+        this->readback_extents.reserve(pyramid.levels());
+        for (uint32_t l = 0; l < pyramid.levels(); l++) {
+            this->readback_extents.push_back(pyramid_level_extent(pyramid.extent(), l));
+            n_bytes += sizeof(float) * (VkDeviceSize) this->readback_extents.last().width * (VkDeviceSize) this->readback_extents.last().height;
+        }
+    }
+    this->_reserve_readback(std::max(n_bytes, (VkDeviceSize) sizeof(float)));
+
+    // Copy the draw commands, which the culler already made available to transfers
+    if (draws_size > 0) {
+        VkBufferCopy buffer_copy;
+        populate_buffer_copy(buffer_copy, draws_size);
+        vkCmdCopyBuffer(cmd->vulkan(), this->draws_buffer->vulkan(), this->readback_buffer->vulkan(), 1, &buffer_copy);
+    }
+
+    // Copy the levels of the pyramid, once the previous frame is done writing them
+    if (pyramid_built) {
+        VkMemoryBarrier memory_barrier;
+        populate_memory_barrier(memory_barrier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+        vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+
+        Tools::Array<VkBufferImageCopy> level_copies(pyramid.levels());
+        VkDeviceSize offset = draws_size;
+        for (uint32_t l = 0; l < pyramid.levels(); l++) {
+            level_copies.push_back(VkBufferImageCopy());
+            populate_level_copy(level_copies.last(), l, this->readback_extents[l], offset);
+            offset += sizeof(float) * (VkDeviceSize) this->readback_extents[l].width * (VkDeviceSize) this->readback_extents[l].height;
+        }
+        vkCmdCopyImageToBuffer(cmd->vulkan(), pyramid.levels_image()->vulkan(), VK_IMAGE_LAYOUT_GENERAL, this->readback_buffer->vulkan(), level_copies.size(), level_copies.rdata());
+    }
+
+    // Make the copies visible to the host
+    VkMemoryBarrier memory_barrier;
+    populate_memory_barrier(memory_barrier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+    this->readback_pending = true;
+}
+
+/* Compares the results of the last culling against the reference implementation on the CPU, logging any differences. Returns the number of draws that differ, or 0 if nothing was read back. The frame may not be in flight. */
+uint32_t CullBuffers::check() {
+    if (!this->readback_pending) { return 0; }
+    this->readback_pending = false;
+
+    // Unpack the pyramid that was culled against
+    const VkDrawIndexedIndirectCommand* draws = (const VkDrawIndexedIndirectCommand*) this->readback_mapped;
+    const float* texels = (const float*) (draws + this->params.n_items);
+    DepthPyramid pyramid;
+    pyramid.extents = this->readback_extents;
+    pyramid.levels.reserve(this->readback_extents.size());
+    for (uint32_t l = 0; l < this->readback_extents.size(); l++) {
+        uint32_t n_texels = this->readback_extents[l].width * this->readback_extents[l].height;
+        pyramid.levels.push_back(Tools::Array<float>(texels, n_texels));
+        texels += n_texels;
+    }
+
+    // Check that each level was reduced correctly from the one before it. Taking the maximum is exact, so they should match exactly
+    uint32_t n_wrong_texels = 0;
+    Tools::Array<float> expected;
+    for (uint32_t l = 1; l < pyramid.levels.size(); l++) {
+        expected.resize(pyramid.levels[l].size());
+        reduce_depth_level(pyramid.levels[l - 1].rdata(), pyramid.extents[l - 1], expected.wdata(), pyramid.extents[l]);
+        for (uint32_t i = 0; i < expected.size(); i++) {
+            if (expected[i] != pyramid.levels[l][i]) { ++n_wrong_texels; }
+        }
+    }
+    if (n_wrong_texels > 0) {
+        logger.warningc(CullBuffers::channel, "Depth pyramid differs from the reference in ", n_wrong_texels, " texels.");
+    }
+
+    // Cull the same draws on the CPU, and compare the outcome
+    Tools::Array<bool> visible;
+    cull_reference(this->params, (const CullItem*) this->items_mapped, this->params.n_items, &pyramid, visible);
+    uint32_t n_visible = 0;
+    uint32_t n_mismatches = 0;
+    for (uint32_t i = 0; i < this->params.n_items; i++) {
+        bool gpu_visible = draws[i].instanceCount > 0;
+        if (gpu_visible) { ++n_visible; }
+        if (gpu_visible != visible[i]) {
+            ++n_mismatches;
+            logger.logc(Verbosity::debug, CullBuffers::channel, "Draw ", i, " is ", gpu_visible ? "visible" : "culled", " on the GPU but ", visible[i] ? "visible" : "culled", " on the CPU.");
+        }
+    }
+    if (n_mismatches > 0) {
+        logger.warningc(CullBuffers::channel, "GPU culling differs from the reference for ", n_mismatches, " out of ", this->params.n_items, " draws.");
+    }
+    logger.logc(Verbosity::details, CullBuffers::channel, "GPU culling kept ", n_visible, " out of ", this->params.n_items, " draws", this->params.use_pyramid != 0 ? " (with occlusion)" : " (frustum only)", ".");
+
+    // Done
+    return n_mismatches;
+}
+
+
+
+/* Swap operator for the CullBuffers class. */
+void Rendering::swap(CullBuffers& cb1, CullBuffers& cb2) {
+    #ifndef NDEBUG
+    if (cb1.gpu != cb2.gpu) { logger.fatalc(CullBuffers::channel, "Cannot swap cull buffers with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(cb1.params_pool, cb2.params_pool);
+    swap(cb1.params_buffer, cb2.params_buffer);
+    swap(cb1.params_mapped, cb2.params_mapped);
+    swap(cb1.items_pool, cb2.items_pool);
+    swap(cb1.items_buffer, cb2.items_buffer);
+    swap(cb1.items_mapped, cb2.items_mapped);
+    swap(cb1.draws_pool, cb2.draws_pool);
+    swap(cb1.draws_buffer, cb2.draws_buffer);
+    swap(cb1.capacity, cb2.capacity);
+    swap(cb1.n_items, cb2.n_items);
+    swap(cb1.descriptor_pool, cb2.descriptor_pool);
+    swap(cb1.set, cb2.set);
+    swap(cb1.check_results, cb2.check_results);
+    swap(cb1.readback_pool, cb2.readback_pool);
+    swap(cb1.readback_buffer, cb2.readback_buffer);
+    swap(cb1.readback_mapped, cb2.readback_mapped);
+    swap(cb1.readback_capacity, cb2.readback_capacity);
+    swap(cb1.readback_pending, cb2.readback_pending);
+    swap(cb1.params, cb2.params);
+    swap(cb1.readback_extents, cb2.readback_extents);
+}
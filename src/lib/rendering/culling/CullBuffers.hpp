@@ -0,0 +1,138 @@
+/* CULL BUFFERS.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the CullBuffers class, which owns the buffers a single frame
+ *   needs to cull its draws on the GPU: the per-frame parameters, the
+ *   draws to cull and the indirect draw commands the culling writes.
+ *   Can also read back the results to compare them against a reference
+ *   on the CPU.
+**/
+
+#ifndef RENDERING_CULL_BUFFERS_HPP
+#define RENDERING_CULL_BUFFERS_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../memory/LinearMemoryPool.hpp"
+#include "../memory/Buffer.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+#include "../descriptors/DescriptorSetLayout.hpp"
+#include "../descriptors/DescriptorPool.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+#include "../data/CullData.hpp"
+
+#include "HiZPyramid.hpp"
+#include "GpuCuller.hpp"
+
+namespace Makma3D::Rendering {
+    /* The CullBuffers class, which owns the buffers to cull the draws of a single frame with. */
+    class CullBuffers {
+    public:
+        /* Channel name for the CullBuffers class. */
+        static constexpr const char* channel = "CullBuffers";
+
+        /* The GPU where the CullBuffers live. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The pool with the parameters. Each mapped buffer has its own pool, since a pool's memory can only be mapped once at a time. */
+        Rendering::LinearMemoryPool* params_pool;
+        /* The host-visible buffer with the parameters. */
+        Rendering::Buffer* params_buffer;
+        /* The parameters' memory, which stays mapped for as long as the buffer exists. */
+        void* params_mapped;
+        /* The pool with the draws to cull. */
+        Rendering::LinearMemoryPool* items_pool;
+        /* The host-visible buffer with the draws to cull. */
+        Rendering::Buffer* items_buffer;
+        /* The draws' memory, which stays mapped for as long as the buffer exists. */
+        void* items_mapped;
+        /* The pool with the draw commands. */
+        Rendering::LinearMemoryPool* draws_pool;
+        /* The device-local buffer with one indirect draw command per draw, which is written by the culling. */
+        Rendering::Buffer* draws_buffer;
+        /* The number of draws the buffers can hold. */
+        uint32_t capacity;
+        /* The number of draws to cull. */
+        uint32_t n_items;
+
+        /* The pool for the descriptor set. */
+        Rendering::DescriptorPool* descriptor_pool;
+        /* The descriptor set to cull with. */
+        Rendering::DescriptorSet* set;
+
+        /* Whether the results of each culling are read back to check them. */
+        bool check_results;
+        /* The pool with the readback buffer. Is a nullptr until something is read back. */
+        Rendering::LinearMemoryPool* readback_pool;
+        /* The host-visible buffer to which the draw commands and the levels of the depth pyramid are copied, in that order. */
+        Rendering::Buffer* readback_buffer;
+        /* The readback buffer's memory, which stays mapped for as long as the buffer exists. */
+        void* readback_mapped;
+        /* The number of bytes the readback buffer can hold. */
+        VkDeviceSize readback_capacity;
+        /* Whether a readback has been recorded that hasn't been checked yet. */
+        bool readback_pending;
+        /* The parameters of the last culling. */
+        Rendering::CullParams params;
+        /* The size of each level of the pyramid that was read back. Is empty if it hadn't been built yet. */
+        Tools::Array<VkExtent2D> readback_extents;
+
+        /* Private helper function that (re)allocates the buffers with the draws and the draw commands such that they can hold at least the given number of draws. The frame may not be in flight. */
+        void _reserve(uint32_t n_items);
+        /* Private helper function that (re)allocates the readback buffer such that it can hold at least the given number of bytes. The frame may not be in flight. */
+        void _reserve_readback(VkDeviceSize n_bytes);
+
+    public:
+        /* Constructor for the CullBuffers class, which takes the GPU where they live, the layout of the descriptor set to cull with (see GpuCuller) and whether to read back the results of each culling to check them. */
+        CullBuffers(const Rendering::GPU& gpu, const Rendering::DescriptorSetLayout& cull_layout, bool check_results);
+        /* Copy constructor for the CullBuffers class, which is deleted. */
+        CullBuffers(const CullBuffers& other) = delete;
+        /* Move constructor for the CullBuffers class. */
+        CullBuffers(CullBuffers&& other);
+        /* Destructor for the CullBuffers class. */
+        ~CullBuffers();
+
+        /* Uploads the given draws to cull, in the order in which their draw commands are written. Invalidates the draw commands buffer if it has to grow, so any recorded scene that uses it has to be re-recorded. The frame may not be in flight. */
+        void upload_items(const Tools::Array<Rendering::CullItem>& items);
+        /* Uploads the given culling parameters. The number of draws in it is overwritten with that of the last upload_items(). The frame may not be in flight. */
+        void upload_params(const Rendering::CullParams& params);
+        /* Schedules culling the uploaded draws against the given depth pyramid with the given culler on the given command buffer, before the render pass that draws them. If the results are checked, also copies them to the readback buffer. */
+        void schedule_cull(const Rendering::CommandBuffer* cmd, const Rendering::GpuCuller& culler, Rendering::HiZPyramid& pyramid);
+        /* Compares the results of the last culling against the reference implementation on the CPU, logging any differences. Returns the number of draws that differ, or 0 if nothing was read back. The frame may not be in flight. */
+        uint32_t check();
+
+        /* Returns the buffer with the draw commands. */
+        inline const Rendering::Buffer* draws() const { return this->draws_buffer; }
+        /* Returns the offset (in bytes) of the draw command for the given draw in the draws buffer. */
+        inline VkDeviceSize draw_offset(uint32_t index) const { return (VkDeviceSize) index * sizeof(VkDrawIndexedIndirectCommand); }
+        /* Returns the number of draws to cull. */
+        inline uint32_t size() const { return this->n_items; }
+
+        /* Copy assignment operator for the CullBuffers class, which is deleted. */
+        CullBuffers& operator=(const CullBuffers& other) = delete;
+        /* Move assignment operator for the CullBuffers class. */
+        inline CullBuffers& operator=(CullBuffers&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the CullBuffers class. */
+        friend void swap(CullBuffers& cb1, CullBuffers& cb2);
+
+    };
+
+    /* Swap operator for the CullBuffers class. */
+    void swap(CullBuffers& cb1, CullBuffers& cb2);
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+/* CULL REFERENCE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains a CPU implementation of the frustum & Hi-Z occlusion culling
+ *   that the GpuCuller does on the GPU. It does exactly the same steps as
+ *   the cull_comp & hiz_reduce_comp shaders, so that the GPU's results
+ *   can be checked against it.
+**/
+
+#include <cmath>
+#include <algorithm>
+
+#include "CullReference.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns the index of the most significant bit that is set in the given value, like GLSL's findMSB(). The value may not be zero. */
+static uint32_t find_msb(uint32_t value) {
+    uint32_t result = 0;
+    while (value >>= 1) { ++result; }
+    return result;
+}
+
+
+
+
+
+/***** LIBRARY FUNCTIONS *****/
+/* Returns the number of levels in a depth pyramid for a depth buffer of the given size. The first level has the same size as the depth buffer, and each next one is half the size of the one before it (rounded down), until it's a single texel. */
+uint32_t Rendering::pyramid_levels(const VkExtent2D& extent) {
+    return find_msb(std::max({ extent.width, extent.height, 1U })) + 1;
+}
+
+/* Returns the size of the given level in a depth pyramid for a depth buffer of the given size. */
+VkExtent2D Rendering::pyramid_level_extent(const VkExtent2D& extent, uint32_t level) {
+    return VkExtent2D{ std::max(1U, extent.width >> level), std::max(1U, extent.height >> level) };
+}
+
+
+
+/* Reduces the given level of depths to the next, smaller one by taking the farthest depth of all source texels each destination texel covers. If the sizes aren't a multiple of each other, border texels count for both destination texels they touch. */
+void Rendering::reduce_depth_level(const float* src, const VkExtent2D& src_extent, float* dst, const VkExtent2D& dst_extent) {
+    for (uint32_t y = 0; y < dst_extent.height; y++) {
+        // Compute which source rows this destination row covers; same as in hiz_reduce_comp.glsl
+        uint32_t start_y = y * src_extent.height / dst_extent.height;
+        uint32_t end_y = ((y + 1) * src_extent.height + dst_extent.height - 1) / dst_extent.height;
+        for (uint32_t x = 0; x < dst_extent.width; x++) {
+            uint32_t start_x = x * src_extent.width / dst_extent.width;
+            uint32_t end_x = ((x + 1) * src_extent.width + dst_extent.width - 1) / dst_extent.width;
+
+            // Take the farthest of them
+            float depth = 0.0f;
+            for (uint32_t sy = start_y; sy < end_y; sy++) {
+                for (uint32_t sx = start_x; sx < end_x; sx++) {
+                    depth = std::max(depth, src[sy * src_extent.width + sx]);
+                }
+            }
+            dst[y * dst_extent.width + x] = depth;
+        }
+    }
+}
+
+/* Builds a depth pyramid from the given depth buffer of the given size. */
+void Rendering::build_depth_pyramid(const float* depth, const VkExtent2D& extent, Rendering::DepthPyramid& pyramid) {
+    uint32_t n_levels = pyramid_levels(extent);
+    pyramid.extents.resize(n_levels);
+    pyramid.levels.resize(n_levels);
+
+    // The first level is simply the depth buffer itself
+    pyramid.extents[0] = extent;
+    pyramid.levels[0] = Tools::Array<float>(depth, extent.width * extent.height);
+
+    // Then reduce each level to the next
+    for (uint32_t l = 1; l < n_levels; l++) {
+        pyramid.extents[l] = pyramid_level_extent(extent, l);
+        pyramid.levels[l].resize(pyramid.extents[l].width * pyramid.extents[l].height);
+        reduce_depth_level(pyramid.levels[l - 1].rdata(), pyramid.extents[l - 1], pyramid.levels[l].wdata(), pyramid.extents[l]);
+    }
+}
+
+
+
+/* Extracts the six frustum planes (left, right, bottom, top, near & far) from the given view-projection matrix, with depths in the zero-to-one range. The planes are normalized, and their normals point inwards. */
+void Rendering::extract_frustum_planes(const glm::mat4& view_proj, glm::vec4 planes[6]) {
+    // GLM is column-major, so collect the rows first
+    glm::vec4 rows[4];
+    for (uint32_t i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(view_proj[0][i], view_proj[1][i], view_proj[2][i], view_proj[3][i]);
+    }
+
+    // Each plane bounds one of the clip coordinates by w; since the depth goes from zero to one, the near plane is simply z >= 0
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[2];
+    planes[5] = rows[3] - rows[2];
+
+    // Normalize them, so the distance to them can be compared with a radius
+    for (uint32_t i = 0; i < 6; i++) {
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+    }
+}
+
+/* Returns whether the given bounding sphere (centre in xyz, radius in w) lies (partly) inside the frustum with the given planes. */
+bool Rendering::in_frustum(const glm::vec4 planes[6], const glm::vec4& sphere) {
+    for (uint32_t i = 0; i < 6; i++) {
+        if (glm::dot(glm::vec3(planes[i]), glm::vec3(sphere)) + planes[i].w < -sphere.w) { return false; }
+    }
+    return true;
+}
+
+/* Returns whether the given bounding sphere may be visible in the depth buffer the given pyramid was built from, which was rendered with the given view-projection matrix. Spheres that cross the camera plane are always visible. */
+bool Rendering::unoccluded(const glm::mat4& view_proj, const Rendering::DepthPyramid& pyramid, const glm::vec4& sphere) {
+    // Project the corners of the sphere's bounding box to find the rectangle it covers on the screen, and how near it gets
+    glm::vec2 ndc_min(1.0f), ndc_max(-1.0f);
+    float nearest = 1.0f;
+    for (uint32_t i = 0; i < 8; i++) {
+        glm::vec3 corner = glm::vec3(sphere) + sphere.w * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+        glm::vec4 clip = view_proj * glm::vec4(corner, 1.0f);
+        if (clip.w <= 0.0f) { return true; }
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        ndc_min = glm::min(ndc_min, glm::vec2(ndc));
+        ndc_max = glm::max(ndc_max, glm::vec2(ndc));
+        nearest = std::min(nearest, ndc.z);
+    }
+    glm::vec2 uv_min = glm::clamp(ndc_min * 0.5f + 0.5f, glm::vec2(0.0f), glm::vec2(1.0f));
+    glm::vec2 uv_max = glm::clamp(ndc_max * 0.5f + 0.5f, glm::vec2(0.0f), glm::vec2(1.0f));
+
+    // Pick the level at which the rectangle spans at most two texels in each direction
+    glm::vec2 size_px = (uv_max - uv_min) * glm::vec2(pyramid.extents[0].width, pyramid.extents[0].height);
+    uint32_t span = static_cast<uint32_t>(std::ceil(std::max(size_px.x, size_px.y)));
+    uint32_t level = span <= 1 ? 0 : find_msb(span - 1) + 1;
+    level = std::min(level, static_cast<uint32_t>(pyramid.levels.size()) - 1);
+
+    // Take the farthest depth of the texels it covers at that level
+    const VkExtent2D& extent = pyramid.extents[level];
+    uint32_t x0 = std::min(static_cast<uint32_t>(uv_min.x * extent.width), extent.width - 1);
+    uint32_t y0 = std::min(static_cast<uint32_t>(uv_min.y * extent.height), extent.height - 1);
+    uint32_t x1 = std::min(static_cast<uint32_t>(uv_max.x * extent.width), extent.width - 1);
+    uint32_t y1 = std::min(static_cast<uint32_t>(uv_max.y * extent.height), extent.height - 1);
+    const Tools::Array<float>& depths = pyramid.levels[level];
+    float farthest = std::max({ depths[y0 * extent.width + x0], depths[y0 * extent.width + x1], depths[y1 * extent.width + x0], depths[y1 * extent.width + x1] });
+
+    // It's visible if any part of it is nearer than that
+    return nearest <= farthest;
+}
+
+
+
+/* Culls the given draws with the given parameters like the GPU would, writing whether each of them is visible to the given array. The pyramid is only used if the parameters say so, and may be a nullptr otherwise. */
+void Rendering::cull_reference(const Rendering::CullParams& params, const Rendering::CullItem* items, uint32_t n_items, const Rendering::DepthPyramid* pyramid, Tools::Array<bool>& visible) {
+    bool use_pyramid = params.use_pyramid != 0 && pyramid != nullptr && !pyramid->levels.empty();
+    visible.resize(n_items);
+    for (uint32_t i = 0; i < n_items; i++) {
+        visible[i] = in_frustum(params.planes, items[i].sphere) && (!use_pyramid || unoccluded(params.prev_view_proj, *pyramid, items[i].sphere));
+        // The pyramid only knows the first view, so the others only test their frustum
+        for (uint32_t v = 1; !visible[i] && v < params.n_views; v++) {
+            visible[i] = in_frustum(params.planes + 6 * v, items[i].sphere);
+        }
+    }
+}
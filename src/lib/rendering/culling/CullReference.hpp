@@ -0,0 +1,62 @@
+/* CULL REFERENCE.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains a CPU implementation of the frustum & Hi-Z occlusion culling
+ *   that the GpuCuller does on the GPU. It does exactly the same steps as
+ *   the cull_comp & hiz_reduce_comp shaders, so that the GPU's results
+ *   can be checked against it.
+**/
+
+#ifndef RENDERING_CULL_REFERENCE_HPP
+#define RENDERING_CULL_REFERENCE_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "glm/glm.hpp"
+#include "tools/Array.hpp"
+
+#include "../data/CullData.hpp"
+
+namespace Makma3D::Rendering {
+    /* A depth pyramid on the CPU, either read back from the GPU or built by build_depth_pyramid(). Each level stores the farthest depth of the texels it covers in the level before it. */
+    struct DepthPyramid {
+        /* The size of each level. */
+        Tools::Array<VkExtent2D> extents;
+        /* The depths of each level, row by row. */
+        Tools::Array<Tools::Array<float>> levels;
+    };
+
+
+
+    /* Returns the number of levels in a depth pyramid for a depth buffer of the given size. The first level has the same size as the depth buffer, and each next one is half the size of the one before it (rounded down), until it's a single texel. */
+    uint32_t pyramid_levels(const VkExtent2D& extent);
+    /* Returns the size of the given level in a depth pyramid for a depth buffer of the given size. */
+    VkExtent2D pyramid_level_extent(const VkExtent2D& extent, uint32_t level);
+
+    /* Reduces the given level of depths to the next, smaller one by taking the farthest depth of all source texels each destination texel covers. If the sizes aren't a multiple of each other, border texels count for both destination texels they touch. */
+    void reduce_depth_level(const float* src, const VkExtent2D& src_extent, float* dst, const VkExtent2D& dst_extent);
+    /* Builds a depth pyramid from the given depth buffer of the given size. */
+    void build_depth_pyramid(const float* depth, const VkExtent2D& extent, Rendering::DepthPyramid& pyramid);
+
+    /* Extracts the six frustum planes (left, right, bottom, top, near & far) from the given view-projection matrix, with depths in the zero-to-one range. The planes are normalized, and their normals point inwards. */
+    void extract_frustum_planes(const glm::mat4& view_proj, glm::vec4 planes[6]);
+    /* Returns whether the given bounding sphere (centre in xyz, radius in w) lies (partly) inside the frustum with the given planes. */
+    bool in_frustum(const glm::vec4 planes[6], const glm::vec4& sphere);
+    /* Returns whether the given bounding sphere may be visible in the depth buffer the given pyramid was built from, which was rendered with the given view-projection matrix. Spheres that cross the camera plane are always visible. */
+    bool unoccluded(const glm::mat4& view_proj, const Rendering::DepthPyramid& pyramid, const glm::vec4& sphere);
+
+    /* Culls the given draws with the given parameters like the GPU would, writing whether each of them is visible to the given array. The pyramid is only used if the parameters say so, and may be a nullptr otherwise. */
+    void cull_reference(const Rendering::CullParams& params, const Rendering::CullItem* items, uint32_t n_items, const Rendering::DepthPyramid* pyramid, Tools::Array<bool>& visible);
+
+}
+
+#endif
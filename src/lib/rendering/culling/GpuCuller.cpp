@@ -0,0 +1,244 @@
+/* GPU CULLER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GpuCuller class, which culls the draws of a frame on the
+ *   GPU. A compute pass tests each draw's bounding sphere against the
+ *   view frustum and against a depth pyramid of the previous frame, and
+ *   writes an indirect draw command for it that only draws it if it
+ *   survived. Another compute pass builds that pyramid from the depth
+ *   buffer after the frame is rendered.
+**/
+
+#include <tuple>
+
+#include "tools/Logger.hpp"
+#include "../auxillary/ErrorCodes.hpp"
+#include "../pipeline/PipelineConstructor.hpp"
+
+#include "CullReference.hpp"
+
+#include "GpuCuller.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given VkSamplerCreateInfo struct for a sampler that reads texels as-is from any mip level. */
+static void populate_sampler_info(VkSamplerCreateInfo& sampler_info) {
+    // Set to default
+    sampler_info = {};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+
+    // Don't filter anything, and stay within the image
+    sampler_info.magFilter = VK_FILTER_NEAREST;
+    sampler_info.minFilter = VK_FILTER_NEAREST;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.anisotropyEnable = VK_FALSE;
+    sampler_info.compareEnable = VK_FALSE;
+    sampler_info.unnormalizedCoordinates = VK_FALSE;
+
+    // Allow all mip levels to be read
+    sampler_info.minLod = 0.0f;
+    sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+}
+
+/* Populates the given VkImageMemoryBarrier struct for the given range of levels of the given depth pyramid image. */
+static void populate_level_barrier(VkImageMemoryBarrier& image_barrier, VkImage vk_image, uint32_t base_level, uint32_t n_levels, VkImageLayout old_layout, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    // Set to default
+    image_barrier = {};
+    image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+    // The pyramid always lives in the general layout, and we don't transfer ownership
+    image_barrier.oldLayout = old_layout;
+    image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+    // Set the levels
+    image_barrier.image = vk_image;
+    image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_barrier.subresourceRange.baseMipLevel = base_level;
+    image_barrier.subresourceRange.levelCount = n_levels;
+    image_barrier.subresourceRange.baseArrayLayer = 0;
+    image_barrier.subresourceRange.layerCount = 1;
+
+    // Set the accesses to wait for
+    image_barrier.srcAccessMask = src_access;
+    image_barrier.dstAccessMask = dst_access;
+}
+
+/* Populates the given VkMemoryBarrier struct. */
+static void populate_memory_barrier(VkMemoryBarrier& memory_barrier, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    memory_barrier = {};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memory_barrier.srcAccessMask = src_access;
+    memory_barrier.dstAccessMask = dst_access;
+}
+
+
+
+
+
+/***** GPUCULLER CLASS *****/
+/* Constructor for the GpuCuller class, which takes the GPU where it lives, the pool to load its shaders from and the cache to create its pipelines with. */
+GpuCuller::GpuCuller(const Rendering::GPU& gpu, Rendering::ShaderPool& shader_pool, const Rendering::PipelineCache& pipeline_cache) :
+    gpu(gpu),
+    _cull_layout(gpu),
+    _pyramid_layout(gpu)
+{
+    logger.logc(Verbosity::important, GpuCuller::channel, "Initializing...");
+
+    // Define the layout for culling: the parameters, the draws to cull, the draw commands to write and the depth pyramid
+    this->_cull_layout.add_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_cull_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_cull_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_cull_layout.add_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_cull_layout.finalize();
+
+    // Define the layout for building a level of the pyramid: the level before it and the level itself
+    this->_pyramid_layout.add_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_pyramid_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_pyramid_layout.finalize();
+
+    // Create the pipelines, which only need a shader and a layout
+    PipelineConstructor pipeline_constructor(this->gpu, pipeline_cache);
+    pipeline_constructor.shaders = { ShaderStage(shader_pool.allocate("shaders/cull_comp.spv"), VK_SHADER_STAGE_COMPUTE_BIT, {}) };
+    pipeline_constructor.pipeline_layout = PipelineLayout({ this->_cull_layout }, {});
+    this->cull_pipeline = pipeline_constructor.construct_compute();
+    pipeline_constructor.shaders = { ShaderStage(shader_pool.allocate("shaders/hiz_reduce_comp.spv"), VK_SHADER_STAGE_COMPUTE_BIT, {}) };
+    pipeline_constructor.pipeline_layout = PipelineLayout({ this->_pyramid_layout }, {});
+    this->pyramid_pipeline = pipeline_constructor.construct_compute();
+
+    // Create the sampler to read the depths with
+    VkSamplerCreateInfo sampler_info;
+    populate_sampler_info(sampler_info);
+    VkResult vk_result;
+    if ((vk_result = vkCreateSampler(this->gpu, &sampler_info, nullptr, &this->vk_sampler)) != VK_SUCCESS) {
+        logger.fatalc(GpuCuller::channel, "Could not create depth sampler: ", vk_error_map[vk_result]);
+    }
+
+    // Done
+    logger.logc(Verbosity::important, GpuCuller::channel, "Init success.");
+}
+
+/* Move constructor for the GpuCuller class. */
+GpuCuller::GpuCuller(GpuCuller&& other) :
+    gpu(other.gpu),
+    _cull_layout(std::move(other._cull_layout)),
+    _pyramid_layout(std::move(other._pyramid_layout)),
+    cull_pipeline(other.cull_pipeline),
+    pyramid_pipeline(other.pyramid_pipeline),
+    vk_sampler(other.vk_sampler)
+{
+    // Make sure the other doesn't deallocate anything
+    other.cull_pipeline = nullptr;
+    other.pyramid_pipeline = nullptr;
+    other.vk_sampler = nullptr;
+}
+
+/* Destructor for the GpuCuller class. */
+GpuCuller::~GpuCuller() {
+    logger.logc(Verbosity::important, GpuCuller::channel, "Cleaning...");
+
+    if (this->vk_sampler != nullptr) {
+        vkDestroySampler(this->gpu, this->vk_sampler, nullptr);
+    }
+    if (this->pyramid_pipeline != nullptr) {
+        delete this->pyramid_pipeline;
+    }
+    if (this->cull_pipeline != nullptr) {
+        delete this->cull_pipeline;
+    }
+
+    logger.logc(Verbosity::important, GpuCuller::channel, "Cleaned.");
+}
+
+
+
+/* Binds the given buffers with the parameters, the draws to cull and the draw commands to write, and the given depth pyramid to the given descriptor set, which has to have the cull layout. */
+void GpuCuller::bind(const Rendering::DescriptorSet* set, Rendering::Buffer* params, Rendering::Buffer* items, Rendering::Buffer* draws, const Rendering::HiZPyramid& pyramid) const {
+    set->bind(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, { params });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, { items });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, { draws });
+    set->bind(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3, { std::make_tuple(pyramid.view(), VK_IMAGE_LAYOUT_GENERAL, this->vk_sampler) });
+}
+
+/* Schedules culling the given number of draws with the given descriptor set on the given command buffer, before the render pass that draws them. Also makes sure the draw commands can be read by indirect draws and by transfers afterwards. */
+void GpuCuller::schedule_cull(const Rendering::CommandBuffer* cmd, const Rendering::DescriptorSet* set, uint32_t n_items, Rendering::HiZPyramid& pyramid) const {
+    // Wait until the previous frame is done building the pyramid. If it never has, move it out of the undefined layout anyway so its descriptor is valid; the shader won't read it
+    if (pyramid.built()) {
+        VkMemoryBarrier memory_barrier;
+        populate_memory_barrier(memory_barrier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+        vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+    } else {
+        VkImageMemoryBarrier image_barrier;
+        populate_level_barrier(image_barrier, pyramid.levels_image()->vulkan(), 0, pyramid.levels(), VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_ACCESS_SHADER_READ_BIT);
+        vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+    }
+
+    // Cull all draws, a group at a time
+    if (n_items > 0) {
+        this->cull_pipeline->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        set->schedule(cmd, this->cull_pipeline->layout(), 0, VK_PIPELINE_BIND_POINT_COMPUTE);
+        this->cull_pipeline->schedule_dispatch(cmd, (n_items + GpuCuller::group_size - 1) / GpuCuller::group_size);
+    }
+
+    // Make the draw commands available to the indirect draws, and to copies in case they're checked
+    VkMemoryBarrier memory_barrier;
+    populate_memory_barrier(memory_barrier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+}
+
+/* Schedules building the given depth pyramid from its depth buffer on the given command buffer, after the render pass that wrote it. */
+void GpuCuller::schedule_pyramid(const Rendering::CommandBuffer* cmd, Rendering::HiZPyramid& pyramid) const {
+    // Wait until culling (and any copies to check it) is done reading the old pyramid, which we overwrite completely
+    VkImageMemoryBarrier image_barrier;
+    populate_level_barrier(image_barrier, pyramid.levels_image()->vulkan(), 0, pyramid.levels(), pyramid.built() ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_ACCESS_SHADER_WRITE_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+    // Build each level from the one before it, which has to be written completely before the next one reads it
+    this->pyramid_pipeline->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+    for (uint32_t l = 0; l < pyramid.levels(); l++) {
+        if (l > 0) {
+            populate_level_barrier(image_barrier, pyramid.levels_image()->vulkan(), l - 1, 1, VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+            vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+        }
+
+        VkExtent2D extent = pyramid_level_extent(pyramid.extent(), l);
+        pyramid.level_set(l)->schedule(cmd, this->pyramid_pipeline->layout(), 0, VK_PIPELINE_BIND_POINT_COMPUTE);
+        this->pyramid_pipeline->schedule_dispatch(cmd, (extent.width + GpuCuller::pyramid_group_size - 1) / GpuCuller::pyramid_group_size, (extent.height + GpuCuller::pyramid_group_size - 1) / GpuCuller::pyramid_group_size);
+    }
+
+    // The next frame's culling waits for the last level before reading it
+    pyramid.mark_built();
+}
+
+
+
+/* Swap operator for the GpuCuller class. */
+void Rendering::swap(GpuCuller& gc1, GpuCuller& gc2) {
+    #ifndef NDEBUG
+    if (gc1.gpu != gc2.gpu) { logger.fatalc(GpuCuller::channel, "Cannot swap GPU cullers with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(gc1._cull_layout, gc2._cull_layout);
+    swap(gc1._pyramid_layout, gc2._pyramid_layout);
+    swap(gc1.cull_pipeline, gc2.cull_pipeline);
+    swap(gc1.pyramid_pipeline, gc2.pyramid_pipeline);
+    swap(gc1.vk_sampler, gc2.vk_sampler);
+}
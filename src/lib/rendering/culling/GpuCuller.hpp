@@ -0,0 +1,101 @@
+/* GPU CULLER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GpuCuller class, which culls the draws of a frame on the
+ *   GPU. A compute pass tests each draw's bounding sphere against the
+ *   view frustum and against a depth pyramid of the previous frame, and
+ *   writes an indirect draw command for it that only draws it if it
+ *   survived. Another compute pass builds that pyramid from the depth
+ *   buffer after the frame is rendered.
+**/
+
+#ifndef RENDERING_GPU_CULLER_HPP
+#define RENDERING_GPU_CULLER_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "../gpu/GPU.hpp"
+#include "../memory/Buffer.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+#include "../descriptors/DescriptorSetLayout.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+#include "../shaders/ShaderPool.hpp"
+#include "../pipeline/PipelineCache.hpp"
+#include "../pipeline/Pipeline.hpp"
+
+#include "HiZPyramid.hpp"
+
+namespace Makma3D::Rendering {
+    /* The GpuCuller class, which owns the pipelines to cull draws and build depth pyramids on the GPU. */
+    class GpuCuller {
+    public:
+        /* Channel name for the GpuCuller class. */
+        static constexpr const char* channel = "GpuCuller";
+        /* The number of draws culled by a single workgroup, which has to match cull_comp.glsl. */
+        static constexpr const uint32_t group_size = 64;
+        /* The width & height of the texels written by a single workgroup when building the pyramid, which has to match hiz_reduce_comp.glsl. */
+        static constexpr const uint32_t pyramid_group_size = 8;
+
+        /* The GPU where the GpuCuller lives. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The layout of the descriptor set to cull with: the parameters, the draws to cull, the draw commands to write and the depth pyramid. */
+        Rendering::DescriptorSetLayout _cull_layout;
+        /* The layout of the descriptor set to build a level of the depth pyramid with: the level (or depth buffer) before it and the level itself. */
+        Rendering::DescriptorSetLayout _pyramid_layout;
+        /* The pipeline that culls the draws. */
+        Rendering::Pipeline* cull_pipeline;
+        /* The pipeline that builds a single level of the depth pyramid. */
+        Rendering::Pipeline* pyramid_pipeline;
+        /* The sampler with which the depth buffer and the levels of the pyramid are read. Since the shaders only fetch texels, it doesn't filter. */
+        VkSampler vk_sampler;
+
+    public:
+        /* Constructor for the GpuCuller class, which takes the GPU where it lives, the pool to load its shaders from and the cache to create its pipelines with. */
+        GpuCuller(const Rendering::GPU& gpu, Rendering::ShaderPool& shader_pool, const Rendering::PipelineCache& pipeline_cache);
+        /* Copy constructor for the GpuCuller class, which is deleted. */
+        GpuCuller(const GpuCuller& other) = delete;
+        /* Move constructor for the GpuCuller class. */
+        GpuCuller(GpuCuller&& other);
+        /* Destructor for the GpuCuller class. */
+        ~GpuCuller();
+
+        /* Binds the given buffers with the parameters, the draws to cull and the draw commands to write, and the given depth pyramid to the given descriptor set, which has to have the cull layout. */
+        void bind(const Rendering::DescriptorSet* set, Rendering::Buffer* params, Rendering::Buffer* items, Rendering::Buffer* draws, const Rendering::HiZPyramid& pyramid) const;
+        /* Schedules culling the given number of draws with the given descriptor set on the given command buffer, before the render pass that draws them. Also makes sure the draw commands can be read by indirect draws and by transfers afterwards. */
+        void schedule_cull(const Rendering::CommandBuffer* cmd, const Rendering::DescriptorSet* set, uint32_t n_items, Rendering::HiZPyramid& pyramid) const;
+        /* Schedules building the given depth pyramid from its depth buffer on the given command buffer, after the render pass that wrote it. */
+        void schedule_pyramid(const Rendering::CommandBuffer* cmd, Rendering::HiZPyramid& pyramid) const;
+
+        /* Returns the layout of the descriptor set to cull with. */
+        inline const Rendering::DescriptorSetLayout& cull_layout() const { return this->_cull_layout; }
+        /* Returns the layout of the descriptor set to build a level of a depth pyramid with. */
+        inline const Rendering::DescriptorSetLayout& pyramid_layout() const { return this->_pyramid_layout; }
+        /* Returns the sampler to read the depth buffer and the levels of a depth pyramid with. */
+        inline VkSampler sampler() const { return this->vk_sampler; }
+
+        /* Copy assignment operator for the GpuCuller class, which is deleted. */
+        GpuCuller& operator=(const GpuCuller& other) = delete;
+        /* Move assignment operator for the GpuCuller class. */
+        inline GpuCuller& operator=(GpuCuller&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the GpuCuller class. */
+        friend void swap(GpuCuller& gc1, GpuCuller& gc2);
+
+    };
+
+    /* Swap operator for the GpuCuller class. */
+    void swap(GpuCuller& gc1, GpuCuller& gc2);
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+/* HI Z PYRAMID.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the HiZPyramid class, which owns the hierarchical depth
+ *   pyramid that the GpuCuller builds from the depth buffer after each
+ *   frame. Each level stores the farthest depth of the texels it covers
+ *   in the level before it, and has its own view and descriptor set to
+ *   build it from that level.
+**/
+
+#include <tuple>
+
+#include "tools/Logger.hpp"
+#include "../auxillary/ErrorCodes.hpp"
+
+#include "CullReference.hpp"
+#include "HiZPyramid.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates a given VkImageViewCreateInfo struct for the given range of mip levels. */
+static void populate_view_info(VkImageViewCreateInfo& view_info, const VkImage& vk_image, uint32_t base_level, uint32_t n_levels) {
+    // Set the struct's default values
+    view_info = {};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+
+    // Link the image
+    view_info.image = vk_image;
+
+    // Set the type and format of the image
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = HiZPyramid::format;
+
+    // Set the components of the image. For now, all of them are just themselves
+    view_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    view_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    view_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    view_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+    // Only look at the given levels
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.baseMipLevel = base_level;
+    view_info.subresourceRange.levelCount = n_levels;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+}
+
+
+
+
+
+/***** HIZPYRAMID CLASS *****/
+/* Constructor for the HiZPyramid class, which takes the GPU where it lives, a memory pool to allocate its image from, the layout of the descriptor sets to build each level with (see GpuCuller), the sampler to read the levels with, the view of the depth buffer to build it from and that depth buffer's size. */
+HiZPyramid::HiZPyramid(const Rendering::GPU& gpu, Rendering::MemoryPool& draw_pool, const Rendering::DescriptorSetLayout& level_layout, VkSampler vk_sampler, VkImageView vk_depth_view, const VkExtent2D& vk_extent) :
+    gpu(gpu),
+    draw_pool(draw_pool),
+    vk_extent(vk_extent),
+    _built(false)
+{
+    logger.logc(Verbosity::details, HiZPyramid::channel, "Initializing...");
+
+    // Allocate the image with a mip level for each level of the pyramid. It's written as storage image, sampled while culling and copied when checking against the CPU
+    uint32_t n_levels = pyramid_levels(this->vk_extent);
+    this->image = this->draw_pool.allocate(this->vk_extent, HiZPyramid::format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE, 0, n_levels);
+
+    // Create the view on all of them, and one for each of them
+    VkImageViewCreateInfo view_info;
+    VkResult vk_result;
+    populate_view_info(view_info, this->image->vulkan(), 0, n_levels);
+    if ((vk_result = vkCreateImageView(this->gpu, &view_info, nullptr, &this->vk_view)) != VK_SUCCESS) {
+        logger.fatalc(HiZPyramid::channel, "Could not create image view for depth pyramid: ", vk_error_map[vk_result]);
+    }
+    this->vk_level_views.resize(n_levels);
+    for (uint32_t l = 0; l < n_levels; l++) {
+        populate_view_info(view_info, this->image->vulkan(), l, 1);
+        if ((vk_result = vkCreateImageView(this->gpu, &view_info, nullptr, &this->vk_level_views[l])) != VK_SUCCESS) {
+            logger.fatalc(HiZPyramid::channel, "Could not create image view for level ", l, " of depth pyramid: ", vk_error_map[vk_result]);
+        }
+    }
+
+    // Prepare a descriptor set per level, which reads the level before it (or the depth buffer) and writes the level itself
+    this->descriptor_pool = new DescriptorPool(this->gpu, {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, n_levels },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, n_levels }
+    }, n_levels);
+    this->level_sets = this->descriptor_pool->nallocate(n_levels, level_layout);
+    for (uint32_t l = 0; l < n_levels; l++) {
+        if (l == 0) {
+            this->level_sets[l]->bind(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, { std::make_tuple(vk_depth_view, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, vk_sampler) });
+        } else {
+            this->level_sets[l]->bind(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, { std::make_tuple(this->vk_level_views[l - 1], VK_IMAGE_LAYOUT_GENERAL, vk_sampler) });
+        }
+        this->level_sets[l]->bind(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, { std::make_tuple(this->vk_level_views[l], VK_IMAGE_LAYOUT_GENERAL) });
+    }
+
+    // Done
+    logger.logc(Verbosity::details, HiZPyramid::channel, "Allocated depth pyramid of ", this->vk_extent.width, 'x', this->vk_extent.height, " with ", n_levels, " levels.");
+    logger.logc(Verbosity::details, HiZPyramid::channel, "Init success.");
+}
+
+/* Move constructor for the HiZPyramid class. */
+HiZPyramid::HiZPyramid(HiZPyramid&& other) :
+    gpu(other.gpu),
+    draw_pool(other.draw_pool),
+    image(other.image),
+    vk_view(other.vk_view),
+    vk_level_views(std::move(other.vk_level_views)),
+    descriptor_pool(other.descriptor_pool),
+    level_sets(std::move(other.level_sets)),
+    vk_extent(other.vk_extent),
+    _built(other._built)
+{
+    // Make sure the other doesn't deallocate anything
+    other.image = nullptr;
+    other.vk_view = nullptr;
+    other.vk_level_views.clear();
+    other.descriptor_pool = nullptr;
+    other.level_sets.clear();
+}
+
+/* Destructor for the HiZPyramid class. */
+HiZPyramid::~HiZPyramid() {
+    logger.logc(Verbosity::details, HiZPyramid::channel, "Cleaning...");
+
+    // The descriptor sets go with their pool
+    if (this->descriptor_pool != nullptr) {
+        delete this->descriptor_pool;
+    }
+    // Destroy the views before the image they look at
+    for (uint32_t i = 0; i < this->vk_level_views.size(); i++) {
+        vkDestroyImageView(this->gpu, this->vk_level_views[i], nullptr);
+    }
+    if (this->vk_view != nullptr) {
+        vkDestroyImageView(this->gpu, this->vk_view, nullptr);
+    }
+    if (this->image != nullptr) {
+        this->draw_pool.free(this->image);
+    }
+
+    logger.logc(Verbosity::details, HiZPyramid::channel, "Cleaned.");
+}
+
+
+
+/* Swap operator for the HiZPyramid class. */
+void Rendering::swap(HiZPyramid& hzp1, HiZPyramid& hzp2) {
+    #ifndef NDEBUG
+    if (hzp1.gpu != hzp2.gpu) { logger.fatalc(HiZPyramid::channel, "Cannot swap depth pyramids with different GPUs."); }
+    if (&hzp1.draw_pool != &hzp2.draw_pool) { logger.fatalc(HiZPyramid::channel, "Cannot swap depth pyramids with different draw pools."); }
+    #endif
+
+    using std::swap;
+
+    swap(hzp1.image, hzp2.image);
+    swap(hzp1.vk_view, hzp2.vk_view);
+    swap(hzp1.vk_level_views, hzp2.vk_level_views);
+    swap(hzp1.descriptor_pool, hzp2.descriptor_pool);
+    swap(hzp1.level_sets, hzp2.level_sets);
+    swap(hzp1.vk_extent, hzp2.vk_extent);
+    swap(hzp1._built, hzp2._built);
+}
@@ -0,0 +1,104 @@
+/* HI Z PYRAMID.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the HiZPyramid class, which owns the hierarchical depth
+ *   pyramid that the GpuCuller builds from the depth buffer after each
+ *   frame. Each level stores the farthest depth of the texels it covers
+ *   in the level before it, and has its own view and descriptor set to
+ *   build it from that level.
+**/
+
+#ifndef RENDERING_HI_Z_PYRAMID_HPP
+#define RENDERING_HI_Z_PYRAMID_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../memory/MemoryPool.hpp"
+#include "../memory/Image.hpp"
+#include "../descriptors/DescriptorSetLayout.hpp"
+#include "../descriptors/DescriptorPool.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+
+namespace Makma3D::Rendering {
+    /* The HiZPyramid class, which owns a depth pyramid for a depth buffer of a given size. */
+    class HiZPyramid {
+    public:
+        /* Channel name for the HiZPyramid class. */
+        static constexpr const char* channel = "HiZPyramid";
+        /* The format of the pyramid's levels. */
+        static constexpr const VkFormat format = VK_FORMAT_R32_SFLOAT;
+
+        /* The GPU where the HiZPyramid lives. */
+        const Rendering::GPU& gpu;
+        /* The MemoryPool used to allocate the pyramid's image. */
+        Rendering::MemoryPool& draw_pool;
+
+    private:
+        /* The image with all levels of the pyramid as its mip levels. Is always in the general layout once it's been built. */
+        Rendering::Image* image;
+        /* A view on all levels of the pyramid, for culling against it. */
+        VkImageView vk_view;
+        /* A view on each separate level of the pyramid, for building it. */
+        Tools::Array<VkImageView> vk_level_views;
+        /* The pool for the descriptor sets of the levels. */
+        Rendering::DescriptorPool* descriptor_pool;
+        /* The descriptor set to build each level with, which binds the level (or depth buffer) before it and the level itself. */
+        Tools::Array<Rendering::DescriptorSet*> level_sets;
+        /* The size of the pyramid's first level, which is that of the depth buffer. */
+        VkExtent2D vk_extent;
+        /* Whether the pyramid has been built at least once, i.e., whether it has something to cull against. */
+        bool _built;
+
+    public:
+        /* Constructor for the HiZPyramid class, which takes the GPU where it lives, a memory pool to allocate its image from, the layout of the descriptor sets to build each level with (see GpuCuller), the sampler to read the levels with, the view of the depth buffer to build it from and that depth buffer's size. */
+        HiZPyramid(const Rendering::GPU& gpu, Rendering::MemoryPool& draw_pool, const Rendering::DescriptorSetLayout& level_layout, VkSampler vk_sampler, VkImageView vk_depth_view, const VkExtent2D& vk_extent);
+        /* Copy constructor for the HiZPyramid class, which is deleted. */
+        HiZPyramid(const HiZPyramid& other) = delete;
+        /* Move constructor for the HiZPyramid class. */
+        HiZPyramid(HiZPyramid&& other);
+        /* Destructor for the HiZPyramid class. */
+        ~HiZPyramid();
+
+        /* Marks that the pyramid has been built, i.e., that all commands to build it have been recorded. */
+        inline void mark_built() { this->_built = true; }
+
+        /* Returns the image with all levels of the pyramid. */
+        inline const Rendering::Image* levels_image() const { return this->image; }
+        /* Returns a view on all levels of the pyramid. */
+        inline VkImageView view() const { return this->vk_view; }
+        /* Returns the descriptor set to build the given level with. */
+        inline const Rendering::DescriptorSet* level_set(uint32_t level) const { return this->level_sets[level]; }
+        /* Returns the number of levels in the pyramid. */
+        inline uint32_t levels() const { return static_cast<uint32_t>(this->vk_level_views.size()); }
+        /* Returns the size of the pyramid's first level. */
+        inline const VkExtent2D& extent() const { return this->vk_extent; }
+        /* Returns whether the pyramid has been built at least once. */
+        inline bool built() const { return this->_built; }
+
+        /* Copy assignment operator for the HiZPyramid class, which is deleted. */
+        HiZPyramid& operator=(const HiZPyramid& other) = delete;
+        /* Move assignment operator for the HiZPyramid class. */
+        inline HiZPyramid& operator=(HiZPyramid&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the HiZPyramid class. */
+        friend void swap(HiZPyramid& hzp1, HiZPyramid& hzp2);
+
+    };
+
+    /* Swap operator for the HiZPyramid class. */
+    void swap(HiZPyramid& hzp1, HiZPyramid& hzp2);
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+/* CAMERA DATA.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:41:16
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Struct that carries the matrices of a single camera to the vertex
+ *   shaders. The frame uploads one per view it renders to; the layout
+ *   matches the Camera block in camera.glsl.
+**/
+
+#ifndef RENDERING_CAMERA_DATA_HPP
+#define RENDERING_CAMERA_DATA_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+namespace Makma3D::Rendering {
+    /* The maximum number of views (i.e., cameras) a single frame renders to. Matches MAX_VIEWS in views.glsl. */
+    static constexpr const uint32_t max_views = 4;
+
+    /* The CameraData struct, which carries the matrices of a single view to the GPU (std140 layout). */
+    struct CameraData {
+        /* The projection matrix for the camera. */
+        glm::mat4 proj;
+        /* The view matrix for the camera. */
+        glm::mat4 view;
+    };
+}
+
+#endif
@@ -0,0 +1,60 @@
+/* CULL DATA.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Structs that carry the draws to cull and the culling parameters to
+ *   the culling compute shader. Their layouts match those in
+ *   cull_comp.glsl.
+**/
+
+#ifndef RENDERING_CULL_DATA_HPP
+#define RENDERING_CULL_DATA_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "CameraData.hpp"
+
+namespace Makma3D::Rendering {
+    /* The CullItem struct, which describes a single draw to cull (std430 layout). */
+    struct CullItem {
+        /* The bounding sphere of the draw in world space, as the centre in xyz and the radius in w. */
+        glm::vec4 sphere;
+        /* The first index of the mesh in the shared index buffer. */
+        uint32_t first_index;
+        /* The number of indices to render. */
+        uint32_t n_indices;
+        /* The offset of the mesh' vertices in the shared vertex buffer. */
+        int32_t vertex_offset;
+        /* Pads the struct to a multiple of the sphere's alignment. */
+        uint32_t padding;
+    };
+
+    /* The CullParams struct, which carries the per-frame culling parameters (std140 layout). */
+    struct CullParams {
+        /* The current view-projection matrix of the first view. */
+        glm::mat4 view_proj;
+        /* The view-projection matrix of the first view in the previous frame, with which its depth pyramid was rendered. */
+        glm::mat4 prev_view_proj;
+        /* The six frustum planes of each view's current view-projection matrix, as the normal in xyz and the distance in w. */
+        glm::vec4 planes[max_views * 6];
+        /* The size of the depth pyramid's first level. */
+        glm::vec2 pyramid_size;
+        /* The number of draws to cull. */
+        uint32_t n_items;
+        /* Whether to test against the depth pyramid (1) or only against the frustum (0). Only the first view has a pyramid. */
+        uint32_t use_pyramid;
+        /* The number of views a draw is visible in if it lies in any of their frustums. */
+        uint32_t n_views;
+    };
+}
+
+#endif
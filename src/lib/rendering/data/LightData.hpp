@@ -0,0 +1,60 @@
+/* LIGHT DATA.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Structs that carry the lights, the light lists of the clusters and
+ *   the clustering parameters to the fragment shaders. Their layouts
+ *   match those in lighting.glsl.
+**/
+
+#ifndef RENDERING_LIGHT_DATA_HPP
+#define RENDERING_LIGHT_DATA_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+namespace Makma3D::Rendering {
+    /* The LightData struct, which describes a single point light (std430 layout). */
+    struct LightData {
+        /* The position of the light as xyz, and the radius beyond which it doesn't light anything as w. */
+        glm::vec4 position;
+        /* The colour of the light as rgb, already multiplied with its intensity. The w is unused. */
+        glm::vec4 colour;
+    };
+
+    /* The ClusterData struct, which points to the lights of a single cluster in the list of light indices (std430 layout). */
+    struct ClusterData {
+        /* The index of the cluster's first light index. */
+        uint32_t offset;
+        /* The number of lights that touch the cluster. */
+        uint32_t count;
+    };
+
+    /* The ClusterParams struct, which carries what the fragment shaders need to find their cluster (std140 layout). */
+    struct ClusterParams {
+        /* The number of clusters in x, in y and in depth, and the number of lights in w. */
+        glm::uvec4 grid;
+        /* The size of a cluster on the screen, in pixels. */
+        glm::vec2 tile_size;
+        /* The scale with which the log of a view-space depth is turned into a depth slice. */
+        float slice_scale;
+        /* The bias added to the scaled log of the depth to get the depth slice. */
+        float slice_bias;
+        /* The view-space depth where the first depth slice ends, and the exponential ones start. */
+        float first_slice;
+        /* The amount of light that reaches every fragment if there are any lights at all. */
+        float ambient;
+        /* Pads the struct to a multiple of 16 bytes. */
+        float padding[2];
+    };
+}
+
+#endif
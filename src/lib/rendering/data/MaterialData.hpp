@@ -4,7 +4,7 @@
  * Created:
  *   20/09/2021, 15:14:42
  * Last edited:
- *   20/09/2021, 15:14:42
+ *   19/10/2026, 03:04:58
  * Auto updated?
  *   Yes
  *
@@ -20,10 +20,14 @@
 #include "glm/glm.hpp"
 
 namespace Makma3D::Rendering {
-    /* GPU data carrier for the SimpleColoured class. */
-    struct SimpleColouredData {
-        /* The colour of the material. */
-        glm::vec3 colour;
+    /* GPU data carrier for the parameters of any material, which is an element of the material buffer (std430 layout). Each material only uses the fields that apply to its type. */
+    struct MaterialData {
+        /* The colour of the material (SimpleColoured). The alpha is unused. */
+        glm::vec4 colour;
+        /* The index of the material's texture in the array of all textures (SimpleTextured, if the textures are bindless). */
+        uint32_t texture;
+        /* Pads the struct to the alignment of its colour. */
+        uint32_t _padding[3];
     };
 
 }
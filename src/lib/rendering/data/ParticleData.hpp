@@ -0,0 +1,96 @@
+/* PARTICLE DATA.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Structs that carry the particles, their emitters and the counters of
+ *   the particle simulation between the CPU and the compute & vertex
+ *   shaders. Their layouts match those in particles.glsl.
+**/
+
+#ifndef RENDERING_PARTICLE_DATA_HPP
+#define RENDERING_PARTICLE_DATA_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+namespace Makma3D::Rendering {
+    /* The ParticleData struct, which describes a single living particle (std430 layout). Only ever touched by the GPU. */
+    struct ParticleData {
+        /* The position of the particle in world space as xyz, and the half-size of its billboard as w. */
+        glm::vec4 position;
+        /* The velocity of the particle as xyz, and the number of seconds it has left to live as w. */
+        glm::vec4 velocity;
+        /* The colour of the particle as rgb, and one over its total lifetime as w, so it can fade out as it ages. */
+        glm::vec4 colour;
+    };
+
+    /* The EmitterData struct, which describes what a single emitter spawns this frame (std430 layout). */
+    struct EmitterData {
+        /* The position of the emitter in world space as xyz, and the radius of the sphere around it in which particles spawn as w. */
+        glm::vec4 position;
+        /* The initial velocity of the particles as xyz, and the largest random speed added to it in any direction as w. */
+        glm::vec4 velocity;
+        /* The colour of the particles as rgb, and the number of seconds they live as w. */
+        glm::vec4 colour;
+        /* The half-size of the particles' billboards. */
+        float size;
+        /* The index of the emitter's first particle among all particles spawned this frame. */
+        uint32_t first;
+        /* The number of particles the emitter spawns this frame. */
+        uint32_t count;
+        /* Pads the struct to a multiple of the vectors' alignment. */
+        uint32_t padding;
+    };
+
+    /* The ParticleParams struct, which carries the per-frame simulation parameters (std140 layout). */
+    struct ParticleParams {
+        /* The acceleration applied to all particles as xyz, and the fraction of their velocity they lose per second as w. */
+        glm::vec4 gravity;
+        /* The number of seconds to simulate. */
+        float dt;
+        /* The number of emitters that spawn particles this frame. */
+        uint32_t n_emitters;
+        /* The total number of particles spawned this frame, across all emitters. */
+        uint32_t n_emit;
+        /* Seeds the random numbers of the particles spawned this frame. */
+        uint32_t seed;
+    };
+
+    /* The ParticleCounters struct, which holds the state of the simulation on the GPU (std430 layout). The first members double as the indirect draw & dispatch commands, so they must stay in this order. */
+    struct ParticleCounters {
+        /* The number of vertices of each particle's billboard (VkDrawIndirectCommand::vertexCount). */
+        uint32_t draw_vertices;
+        /* The number of particles to draw (VkDrawIndirectCommand::instanceCount). */
+        uint32_t draw_instances;
+        /* Always 0 (VkDrawIndirectCommand::firstVertex). */
+        uint32_t draw_first_vertex;
+        /* Always 0 (VkDrawIndirectCommand::firstInstance). */
+        uint32_t draw_first_instance;
+        /* The number of workgroups that simulate the living particles (VkDispatchIndirectCommand::x). */
+        uint32_t dispatch_x;
+        /* Always 1 (VkDispatchIndirectCommand::y). */
+        uint32_t dispatch_y;
+        /* Always 1 (VkDispatchIndirectCommand::z). */
+        uint32_t dispatch_z;
+        /* The number of living particles at the start of a frame. */
+        uint32_t alive;
+        /* The number of particles written to the other half of the particle buffer during a frame. */
+        uint32_t written;
+        /* The half of the particle buffer (0 or 1) that holds the living particles. */
+        uint32_t current;
+        /* The number of particles each half of the particle buffer can hold. */
+        uint32_t capacity;
+        /* The number of particles that could not be spawned because the buffer was full, since the simulation started. */
+        uint32_t dropped;
+    };
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   19/06/2021, 12:49:22
  * Last edited:
- *   19/06/2021, 12:49:22
+ *   19/10/2026, 02:59:22
  * Auto updated?
  *   Yes
  *
@@ -71,8 +71,8 @@ static void populate_write_info(VkWriteDescriptorSet& write_info, VkDescriptorSe
     write_info.pTexelBufferView = nullptr;
 }
 
-/* Populates a given VkWriteDescriptorSet struct to write an image. */
-static void populate_write_info(VkWriteDescriptorSet& write_info, VkDescriptorSet vk_descriptor_set, VkDescriptorType vk_descriptor_type, uint32_t bind_index, const Tools::Array<VkDescriptorImageInfo>& image_infos) {
+/* Populates a given VkWriteDescriptorSet struct to write an image, starting at the given element of the binding's array. */
+static void populate_write_info(VkWriteDescriptorSet& write_info, VkDescriptorSet vk_descriptor_set, VkDescriptorType vk_descriptor_type, uint32_t bind_index, const Tools::Array<VkDescriptorImageInfo>& image_infos, uint32_t first_element = 0) {
     // Set to default
     write_info = {};
     write_info.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -83,8 +83,8 @@ static void populate_write_info(VkWriteDescriptorSet& write_info, VkDescriptorSe
     // Set the binding to use; this one's equal to the sub-binding in the shader
     write_info.dstBinding = bind_index;
     
-    // Set the element of the array. For now, we fix this at 0
-    write_info.dstArrayElement = 0;
+    // Set the element of the array to start writing at
+    write_info.dstArrayElement = first_element;
 
     // Next, set which type of descriptor this is and how many
     write_info.descriptorCount = static_cast<uint32_t>(image_infos.size());
@@ -156,8 +156,29 @@ void DescriptorSet::bind(VkDescriptorType descriptor_type, uint32_t bind_index,
     vkUpdateDescriptorSets(gpu, 1, &write_info, 0, nullptr);
 }
 
-/* Binds this descriptor set with the contents of a given texture (i.e., image, imageview & sampler) to the given bind index. Must be enough textures to actually populate all bindings of the given type. */
-void DescriptorSet::bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<const Materials::Texture*>& textures) const {
+/* Binds this descriptor set with the contents of a given image view, read through the given sampler, to the given bind index. Must be enough views to actually populate all bindings of the given type. */
+void DescriptorSet::bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<std::tuple<VkImageView, VkImageLayout, VkSampler>>& image_views) const {
+    // We first create a list of image infos
+    Tools::Array<VkDescriptorImageInfo> image_infos(image_views.size());
+    for (uint32_t i = 0; i < image_views.size(); i++) {
+        // Start by creating the image info so that the descriptor knows smthng about the image and how to sample it
+        VkDescriptorImageInfo image_info;
+        populate_image_info(image_info, std::get<0>(image_views[i]), std::get<1>(image_views[i]), std::get<2>(image_views[i]));
+
+        // Add to the list
+        image_infos.push_back(image_info);
+    }
+
+    // Next, generate a VkWriteDescriptorSet with which we populate the image information
+    VkWriteDescriptorSet write_info;
+    populate_write_info(write_info, this->vk_descriptor_set, descriptor_type, bind_index, image_infos);
+
+    // With the write info populated, update this set
+    vkUpdateDescriptorSets(gpu, 1, &write_info, 0, nullptr);
+}
+
+/* Binds this descriptor set with the contents of a given texture (i.e., image, imageview & sampler) to the given bind index, starting at the given element of its array. Must be enough textures to actually populate all bindings of the given type, unless the binding is partially bound. */
+void DescriptorSet::bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<const Materials::Texture*>& textures, uint32_t first_element) const {
     // We first create a list of image infos
     Tools::Array<VkDescriptorImageInfo> image_infos(textures.size());
     for (uint32_t i = 0; i < textures.size(); i++) {
@@ -172,14 +193,14 @@ void DescriptorSet::bind(VkDescriptorType descriptor_type, uint32_t bind_index,
     // Next, generate a VkWriteDescriptorSet with which we populate the image information
     // Can also use copies, for descriptor-to-descriptor stuff.
     VkWriteDescriptorSet write_info;
-    populate_write_info(write_info, this->vk_descriptor_set, descriptor_type, bind_index, image_infos);
+    populate_write_info(write_info, this->vk_descriptor_set, descriptor_type, bind_index, image_infos, first_element);
 
     // With the write info populated, update this set. Note that this can be used to perform multiple descriptor write & copies simultaneously
     vkUpdateDescriptorSets(gpu, 1, &write_info, 0, nullptr);
 }
 
-/* Binds the descriptor to the given (compute) command buffer. We assume that the recording already started. */
-void DescriptorSet::schedule(const CommandBuffer* buffer, VkPipelineLayout pipeline_layout, uint32_t set_index) const {
+/* Binds the descriptor to the given command buffer, for pipelines at the given bind point. We assume that the recording already started. */
+void DescriptorSet::schedule(const CommandBuffer* buffer, VkPipelineLayout pipeline_layout, uint32_t set_index, VkPipelineBindPoint bind_point) const {
     // Add the binding
-    vkCmdBindDescriptorSets(buffer->vulkan(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, set_index, 1, &this->vk_descriptor_set, 0, nullptr);
+    vkCmdBindDescriptorSets(buffer->vulkan(), bind_point, pipeline_layout, set_index, 1, &this->vk_descriptor_set, 0, nullptr);
 }
@@ -4,7 +4,7 @@
  * Created:
  *   19/06/2021, 12:47:50
  * Last edited:
- *   19/06/2021, 12:47:50
+ *   19/10/2026, 02:59:22
  * Auto updated?
  *   Yes
  *
@@ -53,10 +53,12 @@ namespace Makma3D::Rendering {
         void bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<Rendering::Buffer*>& buffers) const;
         /* Binds this descriptor set with the contents of a given image view to the given bind index. Must be enough views to actually populate all bindings of the given type. */
         void bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<std::tuple<VkImageView, VkImageLayout>>& image_views) const;
-        /* Binds this descriptor set with the contents of a given texture (i.e., image, imageview & sampler) to the given bind index. Must be enough textures to actually populate all bindings of the given type. */
-        void bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<const Materials::Texture*>& textures) const;
-        /* Binds the descriptor to the given (compute) command buffer. We assume that the recording already started. */
-        void schedule(const Rendering::CommandBuffer* buffer, VkPipelineLayout pipeline_layout, uint32_t set_index = 0) const;
+        /* Binds this descriptor set with the contents of a given image view, read through the given sampler, to the given bind index. Must be enough views to actually populate all bindings of the given type. */
+        void bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<std::tuple<VkImageView, VkImageLayout, VkSampler>>& image_views) const;
+        /* Binds this descriptor set with the contents of a given texture (i.e., image, imageview & sampler) to the given bind index, starting at the given element of its array. Must be enough textures to actually populate all bindings of the given type, unless the binding is partially bound. */
+        void bind(VkDescriptorType descriptor_type, uint32_t bind_index, const Tools::Array<const Materials::Texture*>& textures, uint32_t first_element = 0) const;
+        /* Binds the descriptor to the given command buffer, for pipelines at the given bind point. We assume that the recording already started. */
+        void schedule(const Rendering::CommandBuffer* buffer, VkPipelineLayout pipeline_layout, uint32_t set_index = 0, VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
 
         /* Explicity returns the internal VkDescriptorSet object. */
         inline const VkDescriptorSet& vulkan() const { return this->vk_descriptor_set; }
@@ -4,7 +4,7 @@
  * Created:
  *   26/04/2021, 15:33:41
  * Last edited:
- *   9/20/2021, 8:34:22 PM
+ *   19/10/2026, 03:23:40
  * Auto updated?
  *   Yes
  *
@@ -45,11 +45,24 @@ static void populate_descriptor_set_binding(VkDescriptorSetLayoutBinding& descri
     descriptor_set_binding.pImmutableSamplers = nullptr;
 }
 
-/* Populates a given VkDescriptorSetLayoutCreateInfo struct. */
-static void populate_descriptor_set_layout_info(VkDescriptorSetLayoutCreateInfo& descriptor_set_layout_info, const Tools::Array<VkDescriptorSetLayoutBinding>& vk_bindings) {
+/* Populates a given VkDescriptorSetLayoutBindingFlagsCreateInfoEXT struct with the flags of each binding. */
+static void populate_binding_flags_info(VkDescriptorSetLayoutBindingFlagsCreateInfoEXT& binding_flags_info, const Tools::Array<VkDescriptorBindingFlagsEXT>& vk_binding_flags) {
+    // Initialize to default
+    binding_flags_info = {};
+    binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+
+    // Set the flags, one per binding
+    binding_flags_info.bindingCount = static_cast<uint32_t>(vk_binding_flags.size());
+    binding_flags_info.pBindingFlags = vk_binding_flags.rdata();
+}
+
+/* Populates a given VkDescriptorSetLayoutCreateInfo struct. The flags of the bindings can be chained to it with the given next pointer. */
+static void populate_descriptor_set_layout_info(VkDescriptorSetLayoutCreateInfo& descriptor_set_layout_info, const Tools::Array<VkDescriptorSetLayoutBinding>& vk_bindings, VkDescriptorSetLayoutCreateFlags vk_flags, const void* next = nullptr) {
     // Initialize to default
     descriptor_set_layout_info = {};
     descriptor_set_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptor_set_layout_info.pNext = next;
+    descriptor_set_layout_info.flags = vk_flags;
 
     // Set the bindings to use
     descriptor_set_layout_info.bindingCount = static_cast<uint32_t>(vk_bindings.size());
@@ -71,7 +84,8 @@ DescriptorSetLayout::DescriptorSetLayout(const GPU& gpu) :
 DescriptorSetLayout::DescriptorSetLayout(const DescriptorSetLayout& other) :
     gpu(other.gpu),
     vk_descriptor_set_layout(other.vk_descriptor_set_layout),
-    vk_bindings(other.vk_bindings)
+    vk_bindings(other.vk_bindings),
+    vk_binding_flags(other.vk_binding_flags)
 {
     // If the descriptor set layout is not a nullptr, re-create it manually
     if (this->vk_descriptor_set_layout != nullptr) {
@@ -85,7 +99,8 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout&& other) :
     gpu(other.gpu),
     vk_descriptor_set_layout(other.vk_descriptor_set_layout),
     // vk_bindings(other.vk_bindings)
-    vk_bindings(std::move(other.vk_bindings))
+    vk_bindings(std::move(other.vk_bindings)),
+    vk_binding_flags(std::move(other.vk_binding_flags))
 {
     // Set the layout to a nullptr to avoid deallocation
     other.vk_descriptor_set_layout = nullptr;
@@ -100,8 +115,8 @@ DescriptorSetLayout::~DescriptorSetLayout() {
 
 
 
-/* Adds a binding to the DescriptorSetLayout; i.e., one type of resource that a single descriptorset will bind. Returns the binding index of this binding. */
-uint32_t DescriptorSetLayout::add_binding(VkDescriptorType vk_descriptor_type, uint32_t n_descriptors, VkShaderStageFlags vk_shader_stage) {
+/* Adds a binding to the DescriptorSetLayout; i.e., one type of resource that a single descriptorset will bind. The flags can mark the binding as partially bound or as updatable after it's bound (VK_EXT_descriptor_indexing). Returns the binding index of this binding. */
+uint32_t DescriptorSetLayout::add_binding(VkDescriptorType vk_descriptor_type, uint32_t n_descriptors, VkShaderStageFlags vk_shader_stage, VkDescriptorBindingFlagsEXT vk_binding_flags) {
     // If the layout has already been created, then crash
     if (this->vk_descriptor_set_layout != nullptr) {
         logger.fatalc(DescriptorSetLayout::channel, "Cannot add binding to DescriptorSetLayout after finalize() has been called.");
@@ -114,8 +129,9 @@ uint32_t DescriptorSetLayout::add_binding(VkDescriptorType vk_descriptor_type, u
     VkDescriptorSetLayoutBinding binding;
     populate_descriptor_set_binding(binding, bind_index, vk_descriptor_type, n_descriptors, vk_shader_stage);
 
-    // Add it to the internal list
+    // Add it to the internal lists
     this->vk_bindings.push_back(binding);
+    this->vk_binding_flags.push_back(vk_binding_flags);
 
     // Done, return the binding index
     return bind_index;
@@ -129,9 +145,19 @@ void DescriptorSetLayout::finalize() {
         return;
     }
 
-    // Otherwise, prepare the bindings
+    // Only pass the binding flags if any binding has them, so that layouts without them don't need the extension. Bindings updated after they're bound need the layout to say so as well
+    bool has_flags = false;
+    VkDescriptorSetLayoutCreateFlags vk_flags = 0;
+    for (uint32_t i = 0; i < this->vk_binding_flags.size(); i++) {
+        if (this->vk_binding_flags[i] != 0) { has_flags = true; }
+        if (this->vk_binding_flags[i] & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT) { vk_flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT; }
+    }
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info;
+    populate_binding_flags_info(binding_flags_info, this->vk_binding_flags);
+
+    // Prepare the bindings
     VkDescriptorSetLayoutCreateInfo descriptor_set_layout_info;
-    populate_descriptor_set_layout_info(descriptor_set_layout_info, this->vk_bindings);
+    populate_descriptor_set_layout_info(descriptor_set_layout_info, this->vk_bindings, vk_flags, has_flags ? &binding_flags_info : nullptr);
 
     // Create the layout
     VkResult vk_result;
@@ -142,6 +168,22 @@ void DescriptorSetLayout::finalize() {
     // Do not clear the bindings, to keep the class copyable
 }
 
+/* Returns a key for the definition of this layout, which is equal for identically defined layouts even if they're different objects. Vulkan considers pipeline layouts with such set layouts compatible. */
+uint64_t DescriptorSetLayout::key() const {
+    // Hash everything that defines the layout with FNV-1a
+    uint64_t key = 14695981039346656037ULL;
+    auto mix = [&key](uint64_t value) { key = (key ^ value) * 1099511628211ULL; };
+    mix(this->vk_bindings.size());
+    for (uint32_t i = 0; i < this->vk_bindings.size(); i++) {
+        mix(this->vk_bindings[i].binding);
+        mix(this->vk_bindings[i].descriptorType);
+        mix(this->vk_bindings[i].descriptorCount);
+        mix(this->vk_bindings[i].stageFlags);
+        mix(this->vk_binding_flags[i]);
+    }
+    return key;
+}
+
 
 
 /* Move assignment operator for the DescriptorSetLayout class. */
@@ -162,4 +204,5 @@ void Rendering::swap(DescriptorSetLayout& dsl1, DescriptorSetLayout& dsl2) {
     // Swap all fields
     swap(dsl1.vk_descriptor_set_layout, dsl2.vk_descriptor_set_layout);
     swap(dsl1.vk_bindings, dsl2.vk_bindings);
+    swap(dsl1.vk_binding_flags, dsl2.vk_binding_flags);
 }
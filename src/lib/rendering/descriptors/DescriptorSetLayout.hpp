@@ -4,7 +4,7 @@
  * Created:
  *   26/04/2021, 15:33:48
  * Last edited:
- *   9/20/2021, 10:49:35 PM
+ *   19/10/2026, 03:23:40
  * Auto updated?
  *   Yes
  *
@@ -36,6 +36,8 @@ namespace Makma3D::Rendering {
         VkDescriptorSetLayout vk_descriptor_set_layout;
         /* Keeps track of all bindings defined. */
         Tools::Array<VkDescriptorSetLayoutBinding> vk_bindings;
+        /* The flags of each of the bindings, which are mostly zero. */
+        Tools::Array<VkDescriptorBindingFlagsEXT> vk_binding_flags;
 
     public:
         /* Constructor for the DescriptorSetLayout class, which takes a gpu to bind the buffer to, the index of this bind as seen on the shader, the type of the buffer we describe for and the shader stage where the uniform buffer will eventually be bound to. */
@@ -47,10 +49,12 @@ namespace Makma3D::Rendering {
         /* Destructor for the DescriptorSetLayout class. */
         ~DescriptorSetLayout();
 
-        /* Adds a binding to the DescriptorSetLayout; i.e., one type of resource that a single descriptorset will bind. Returns the binding index of this binding. */
-        uint32_t add_binding(VkDescriptorType vk_descriptor_type, uint32_t n_descriptors, VkShaderStageFlags vk_shader_stage);
+        /* Adds a binding to the DescriptorSetLayout; i.e., one type of resource that a single descriptorset will bind. The flags can mark the binding as partially bound or as updatable after it's bound (VK_EXT_descriptor_indexing). Returns the binding index of this binding. */
+        uint32_t add_binding(VkDescriptorType vk_descriptor_type, uint32_t n_descriptors, VkShaderStageFlags vk_shader_stage, VkDescriptorBindingFlagsEXT vk_binding_flags = 0);
         /* Finalizes the descriptor layout. Note that no more bindings can be added after this point. */
         void finalize();
+        /* Returns a key for the definition of this layout, which is equal for identically defined layouts even if they're different objects. Vulkan considers pipeline layouts with such set layouts compatible. */
+        uint64_t key() const;
 
         /* Expliticly returns the internal VkDescriptorSetLayout object. */
         inline const VkDescriptorSetLayout& vulkan() const { return this->vk_descriptor_set_layout; }
@@ -4,7 +4,7 @@
  * Created:
  *   16/04/2021, 17:21:49
  * Last edited:
- *   8/1/2021, 4:33:01 PM
+ *   19/10/2026, 03:23:54
  * Auto updated?
  *   Yes
  *
@@ -47,19 +47,46 @@ static void populate_queue_infos(Tools::Array<VkDeviceQueueCreateInfo>& queue_in
 }
 
 /* Populates a VkPhysicalDeviceFeatures struct with hardcoded settings. */
-static void populate_device_features(VkPhysicalDeviceFeatures& device_features, VkBool32 enable_anisotropy) {
+static void populate_device_features(VkPhysicalDeviceFeatures& device_features, VkBool32 enable_anisotropy, VkBool32 enable_pipeline_statistics, VkBool32 enable_descriptor_indexing) {
     // None!
     device_features = {};
 
     // Enable anisotropy if asked to do so
     device_features.samplerAnisotropy = enable_anisotropy;
+    // Enable pipeline statistics queries if asked to do so
+    device_features.pipelineStatisticsQuery = enable_pipeline_statistics;
+    // The texture array is indexed with a value read from the material buffer, which needs dynamic indexing of sampler arrays
+    device_features.shaderSampledImageArrayDynamicIndexing = enable_descriptor_indexing;
 }
 
-/* Populates a VkDeviceCreateInfo struct based on the given list of qeueu infos and the given device features. */
-static void populate_device_info(VkDeviceCreateInfo& device_info, const Tools::Array<VkDeviceQueueCreateInfo>& queue_infos, const VkPhysicalDeviceFeatures& device_features, const Tools::Array<const char*>& device_extensions) {
+/* Populates a VkPhysicalDeviceMultiviewFeaturesKHR struct, which enables rendering to several views in a single render pass if asked to. */
+static void populate_multiview_features(VkPhysicalDeviceMultiviewFeaturesKHR& multiview_features, VkBool32 enable_multiview) {
+    // Set to default
+    multiview_features = {};
+    multiview_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES_KHR;
+
+    // Only enable multiview itself, not its use in geometry or tessellation shaders
+    multiview_features.multiview = enable_multiview;
+}
+
+/* Populates a VkPhysicalDeviceDescriptorIndexingFeaturesEXT struct, which enables keeping all textures in a single array that's only partially bound and that may be updated while in use, if asked to. */
+static void populate_descriptor_indexing_features(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& indexing_features, VkBool32 enable_descriptor_indexing) {
+    // Set to default
+    indexing_features = {};
+    indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+    // Only enable what the texture array needs: unwritten slots, and writing new slots while the array is in use
+    indexing_features.descriptorBindingPartiallyBound = enable_descriptor_indexing;
+    indexing_features.descriptorBindingSampledImageUpdateAfterBind = enable_descriptor_indexing;
+    indexing_features.descriptorBindingUpdateUnusedWhilePending = enable_descriptor_indexing;
+}
+
+/* Populates a VkDeviceCreateInfo struct based on the given list of qeueu infos and the given device features. Any features of extensions can be chained to it with the given next pointer. */
+static void populate_device_info(VkDeviceCreateInfo& device_info, const Tools::Array<VkDeviceQueueCreateInfo>& queue_infos, const VkPhysicalDeviceFeatures& device_features, const Tools::Array<const char*>& device_extensions, const void* next = nullptr) {
     // Set the meta info first
     device_info = {};
     device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    device_info.pNext = next;
 
     // Next, pass the queue infos
     device_info.queueCreateInfoCount = static_cast<uint32_t>(queue_infos.size());
@@ -117,20 +144,54 @@ static bool gpu_supports_extensions(const VkPhysicalDevice& vk_physical_device,
     return true;
 }
 
-/* Given a physical device, checks if it meets our needs. */
-static bool is_suitable_gpu(const VkPhysicalDevice& vk_physical_device, const Surface& surface, const Tools::Array<const char*>& device_extensions) {
+/* Given a physical device, checks if it supports the given optional extension. Unlike gpu_supports_extensions(), doesn't complain if it doesn't. */
+static bool gpu_supports_extension(const VkPhysicalDevice& vk_physical_device, const char* extension) {
+    // Get a list of all extensions supported on this device
+    uint32_t n_supported_extensions = 0;
+    if (vkEnumerateDeviceExtensionProperties(vk_physical_device, nullptr, &n_supported_extensions, nullptr) != VK_SUCCESS) { return false; }
+    Tools::Array<VkExtensionProperties> supported_extensions(n_supported_extensions);
+    if (vkEnumerateDeviceExtensionProperties(vk_physical_device, nullptr, &n_supported_extensions, supported_extensions.wdata(n_supported_extensions)) != VK_SUCCESS) { return false; }
+
+    // Try to find it in there
+    for (uint32_t i = 0; i < supported_extensions.size(); i++) {
+        if (strcmp(extension, supported_extensions[i].extensionName) == 0) { return true; }
+    }
+    return false;
+}
+
+/* Given a physical device, checks if it supports the parts of VK_EXT_descriptor_indexing we use to keep all textures in a single, partially bound array that's updated while in use and indexed dynamically. Relies on the instance having VK_KHR_get_physical_device_properties2 enabled. */
+static bool gpu_supports_descriptor_indexing(VkInstance vk_instance, const VkPhysicalDevice& vk_physical_device) {
+    // The extension needs maintenance3 as well
+    if (!gpu_supports_extension(vk_physical_device, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) || !gpu_supports_extension(vk_physical_device, VK_KHR_MAINTENANCE3_EXTENSION_NAME)) { return false; }
+
+    // The features themselves can only be queried through the extended function, which we have to load since we target Vulkan 1.0
+    PFN_vkGetPhysicalDeviceFeatures2KHR get_features = (PFN_vkGetPhysicalDeviceFeatures2KHR) vkGetInstanceProcAddr(vk_instance, "vkGetPhysicalDeviceFeatures2KHR");
+    if (get_features == nullptr) { return false; }
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features = {};
+    indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2KHR features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features.pNext = (void*) &indexing_features;
+    get_features(vk_physical_device, &features);
+
+    // Check the ones we need. Besides those of the extension, the shaders index the array with a runtime value, which arrays of samplers only allow with dynamic indexing
+    return indexing_features.descriptorBindingPartiallyBound && indexing_features.descriptorBindingSampledImageUpdateAfterBind && indexing_features.descriptorBindingUpdateUnusedWhilePending && features.features.shaderSampledImageArrayDynamicIndexing;
+}
+
+/* Given a physical device, checks if it meets our needs. If the surface is a nullptr, the device doesn't have to be able to present. */
+static bool is_suitable_gpu(const VkPhysicalDevice& vk_physical_device, const Surface* surface, const Tools::Array<const char*>& device_extensions) {
     // First, we get a list of supported queues on this device
-    QueueInfo queue_info(vk_physical_device, surface);
+    QueueInfo queue_info(vk_physical_device, surface != nullptr ? surface->surface() : VK_NULL_HANDLE);
 
     // Next, check if the device supports the extensions we want
     bool supports_extensions = gpu_supports_extensions(vk_physical_device, device_extensions);
 
     // With those two, return it the GPU is suitable
-    return queue_info.supports(QueueType::graphics) && queue_info.supports(QueueType::compute) && queue_info.supports(QueueType::memory) && queue_info.supports(QueueType::present) && supports_extensions;
+    return queue_info.supports(QueueType::graphics) && queue_info.supports(QueueType::compute) && queue_info.supports(QueueType::memory) && (surface == nullptr || queue_info.supports(QueueType::present)) && supports_extensions;
 }
 
 /* Selects a suitable GPU from the ones that support Vulkan. */
-static VkPhysicalDevice select_gpu(const Instance& instance, const Surface& surface, const Tools::Array<const char*>& device_extensions) {
+static VkPhysicalDevice select_gpu(const Instance& instance, const Surface* surface, const Tools::Array<const char*>& device_extensions) {
     // Get how many Vulkan-capable devices are out there
     uint32_t n_available_devices = 0;
     VkResult vk_result;
@@ -166,6 +227,11 @@ static VkPhysicalDevice select_gpu(const Instance& instance, const Surface& surf
 /***** GPU CLASS *****/
 /* Constructor for the GPU class, which takes a Vulkan instance, the target surface and a list of required extensions to enable on the GPU. */
 GPU::GPU(const Instance& instance, const Surface& surface, const Tools::Array<uint32_t>& queue_counts, const Tools::Array<const char*>& extensions) :
+    GPU(instance, &surface, queue_counts, extensions)
+{}
+
+/* Constructor for the GPU class, which takes a Vulkan instance, a pointer to the target surface and a list of required extensions to enable on the GPU. If the surface is a nullptr, the GPU is headless: it doesn't need to be able to present, and has no present queues or swapchain info. */
+GPU::GPU(const Instance& instance, const Surface* surface, const Tools::Array<uint32_t>& queue_counts, const Tools::Array<const char*>& extensions) :
     instance(instance),
     surface(surface),
     vk_extensions(extensions)
@@ -180,14 +246,29 @@ GPU::GPU(const Instance& instance, const Surface& surface, const Tools::Array<ui
 
     // Next, get some of its properties, like the name & queue info
     vkGetPhysicalDeviceProperties(this->vk_physical_device, &this->vk_physical_device_properties);
-    this->vk_queue_info = QueueInfo(this->vk_physical_device, this->surface);
-    this->vk_swapchain_info = SwapchainInfo(this->vk_physical_device, this->surface);
-    logger.logc(Verbosity::important, GPU::channel, "Selected GPU: '", this->vk_physical_device_properties.deviceName, '\'');
+    if (this->surface != nullptr) {
+        this->vk_queue_info = QueueInfo(this->vk_physical_device, *this->surface);
+        this->vk_swapchain_info = SwapchainInfo(this->vk_physical_device, *this->surface);
+    } else {
+        // Headless GPUs have no surface to query present support or swapchain info for
+        this->vk_queue_info = QueueInfo(this->vk_physical_device, VK_NULL_HANDLE);
+    }
+    logger.logc(Verbosity::important, GPU::channel, "Selected GPU: '", this->vk_physical_device_properties.deviceName, '\'', this->surface == nullptr ? " (headless)" : "");
 
     // Set some optional features
     VkPhysicalDeviceFeatures supported_features;
     vkGetPhysicalDeviceFeatures(vk_physical_device, &supported_features);
     this->vk_supports_anisotropy = supported_features.samplerAnisotropy;
+    this->vk_supports_pipeline_statistics = supported_features.pipelineStatisticsQuery;
+    // Multiview comes with an extension, which always supports the feature itself. If the GPU has it, we enable it so that several views can be drawn in a single render pass
+    this->vk_supports_multiview = gpu_supports_extension(this->vk_physical_device, VK_KHR_MULTIVIEW_EXTENSION_NAME) ? VK_TRUE : VK_FALSE;
+    if (this->vk_supports_multiview) { this->vk_extensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME); }
+    // Descriptor indexing is an extension as well, but not every GPU that has it supports all the features we use
+    this->vk_supports_descriptor_indexing = gpu_supports_descriptor_indexing(this->instance, this->vk_physical_device) ? VK_TRUE : VK_FALSE;
+    if (this->vk_supports_descriptor_indexing) {
+        this->vk_extensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+        this->vk_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    }
 
 
 
@@ -206,11 +287,19 @@ GPU::GPU(const Instance& instance, const Surface& surface, const Tools::Array<ui
 
     // Next, populate the list of features we like from our device.
     VkPhysicalDeviceFeatures device_features;
-    populate_device_features(device_features, this->vk_supports_anisotropy);
+    populate_device_features(device_features, this->vk_supports_anisotropy, this->vk_supports_pipeline_statistics, this->vk_supports_descriptor_indexing);
+    VkPhysicalDeviceMultiviewFeaturesKHR multiview_features;
+    populate_multiview_features(multiview_features, this->vk_supports_multiview);
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features;
+    populate_descriptor_indexing_features(indexing_features, this->vk_supports_descriptor_indexing);
+    // Only chain the features of the extensions we actually enable
+    void* next = nullptr;
+    if (this->vk_supports_descriptor_indexing) { indexing_features.pNext = next; next = (void*) &indexing_features; }
+    if (this->vk_supports_multiview) { multiview_features.pNext = next; next = (void*) &multiview_features; }
 
     // Then, use the queue indices and the features to populate the create info for the device itself
     VkDeviceCreateInfo device_info;
-    populate_device_info(device_info, queue_infos, device_features, this->vk_extensions);
+    populate_device_info(device_info, queue_infos, device_features, this->vk_extensions, next);
 
     // With the device info ready, create it
     VkResult vk_result;
@@ -221,17 +310,18 @@ GPU::GPU(const Instance& instance, const Surface& surface, const Tools::Array<ui
 
 
     // For debugging purposes, print the extensions enabled
-    for (uint32_t i = 0; i < extensions.size(); i++) {
-        logger.logc(Verbosity::debug, GPU::channel, "Enabled extension '", std::string(extensions[i]), '\'');
+    for (uint32_t i = 0; i < this->vk_extensions.size(); i++) {
+        logger.logc(Verbosity::debug, GPU::channel, "Enabled extension '", std::string(this->vk_extensions[i]), '\'');
     }
 
 
 
-    // As a quick next step, fetch the relevant device queues
+    // As a quick next step, fetch the relevant device queues (skipping families we don't have, like the present family on headless GPUs)
     logger.logc(Verbosity::details, GPU::channel, "Fetching device queues...");
     for (uint32_t i = 0; i < QueueInfo::n_queues; i++) {
-        this->vk_queues[i].resize(queue_counts[i]);
-        for (uint32_t j = 0; j < queue_counts[i]; j++) {
+        uint32_t n_queues = this->vk_queue_info.supports((QueueType) i) ? queue_counts[i] : 0;
+        this->vk_queues[i].resize(n_queues);
+        for (uint32_t j = 0; j < n_queues; j++) {
             vkGetDeviceQueue(this->vk_device, this->vk_queue_info[(QueueType) i], j, &this->vk_queues[i][j]);
         }
     }
@@ -249,6 +339,9 @@ GPU::GPU(const GPU& other) :
     vk_queue_info(other.vk_queue_info),
     vk_swapchain_info(other.vk_swapchain_info),
     vk_supports_anisotropy(other.vk_supports_anisotropy),
+    vk_supports_pipeline_statistics(other.vk_supports_pipeline_statistics),
+    vk_supports_multiview(other.vk_supports_multiview),
+    vk_supports_descriptor_indexing(other.vk_supports_descriptor_indexing),
     vk_extensions(other.vk_extensions)
 {
     logger.logc(Verbosity::debug, GPU::channel, "Copying...");
@@ -270,11 +363,19 @@ GPU::GPU(const GPU& other) :
 
     // Next, populate the list of features we like from our device.
     VkPhysicalDeviceFeatures device_features;
-    populate_device_features(device_features, this->vk_supports_anisotropy);
+    populate_device_features(device_features, this->vk_supports_anisotropy, this->vk_supports_pipeline_statistics, this->vk_supports_descriptor_indexing);
+    VkPhysicalDeviceMultiviewFeaturesKHR multiview_features;
+    populate_multiview_features(multiview_features, this->vk_supports_multiview);
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features;
+    populate_descriptor_indexing_features(indexing_features, this->vk_supports_descriptor_indexing);
+    // Only chain the features of the extensions we actually enable
+    void* next = nullptr;
+    if (this->vk_supports_descriptor_indexing) { indexing_features.pNext = next; next = (void*) &indexing_features; }
+    if (this->vk_supports_multiview) { multiview_features.pNext = next; next = (void*) &multiview_features; }
 
     // Then, use the queue indices and the features to populate the create info for the device itself
     VkDeviceCreateInfo device_info;
-    populate_device_info(device_info, queue_infos, device_features, this->vk_extensions);
+    populate_device_info(device_info, queue_infos, device_features, this->vk_extensions, next);
 
     // With the device info ready, create it
     VkResult vk_result;
@@ -303,6 +404,9 @@ GPU::GPU(GPU&& other) :
     vk_queue_info(other.vk_queue_info),
     vk_swapchain_info(other.vk_swapchain_info),
     vk_supports_anisotropy(other.vk_supports_anisotropy),
+    vk_supports_pipeline_statistics(other.vk_supports_pipeline_statistics),
+    vk_supports_multiview(other.vk_supports_multiview),
+    vk_supports_descriptor_indexing(other.vk_supports_descriptor_indexing),
     vk_device(other.vk_device),
     vk_extensions(other.vk_extensions)
 {
@@ -332,10 +436,13 @@ GPU::~GPU() {
 
 
 
-/* Refreshes the swapchain info, based on the new surface. */
+/* Refreshes the swapchain info, based on the new surface. Does nothing for headless GPUs. */
 void GPU::refresh_swapchain_info() {
+    // Without surface, there's no swapchain info to refresh
+    if (this->surface == nullptr) { return; }
+
     // Simply generate a new one based on the physical device and the surface
-    this->vk_swapchain_info = SwapchainInfo(this->vk_physical_device, this->surface.surface());
+    this->vk_swapchain_info = SwapchainInfo(this->vk_physical_device, this->surface->surface());
 }
 
 
@@ -356,6 +463,10 @@ void Rendering::swap(GPU& g1, GPU& g2) {
     swap(g1.vk_physical_device_properties, g2.vk_physical_device_properties);
     swap(g1.vk_queue_info, g2.vk_queue_info);
     swap(g1.vk_swapchain_info, g2.vk_swapchain_info);
+    swap(g1.vk_supports_anisotropy, g2.vk_supports_anisotropy);
+    swap(g1.vk_supports_pipeline_statistics, g2.vk_supports_pipeline_statistics);
+    swap(g1.vk_supports_multiview, g2.vk_supports_multiview);
+    swap(g1.vk_supports_descriptor_indexing, g2.vk_supports_descriptor_indexing);
     swap(g1.vk_device, g2.vk_device);
     swap(g1.vk_extensions, g2.vk_extensions);
     swap(g1.vk_queues, g2.vk_queues);
@@ -4,7 +4,7 @@
  * Created:
  *   16/04/2021, 17:21:54
  * Last edited:
- *   28/06/2021, 20:06:29
+ *   19/10/2026, 02:59:22
  * Auto updated?
  *   Yes
  *
@@ -31,6 +31,8 @@ namespace Makma3D::Rendering {
     const Tools::Array<const char*> device_extensions({
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     });
+    /* The Vulkan device extensions we want to be enabled on headless GPUs, which don't present to a surface. */
+    const Tools::Array<const char*> headless_device_extensions;
 
 
 
@@ -42,8 +44,8 @@ namespace Makma3D::Rendering {
 
         /* Constant reference to the instance where this GPU is declared with. */
         const Instance& instance;
-        /* Constant reference to the surface where we render to. */
-        const Surface& surface;
+        /* Constant pointer to the surface where we render to. Is a nullptr if the GPU is headless. */
+        const Surface* surface;
 
     private:
         /* The physical GPU this class references. */
@@ -57,6 +59,12 @@ namespace Makma3D::Rendering {
 
         /* Whether or not this device supports anisotropic filtering. */
         VkBool32 vk_supports_anisotropy;
+        /* Whether or not this device supports pipeline statistics queries. */
+        VkBool32 vk_supports_pipeline_statistics;
+        /* Whether or not this device supports rendering to several views in a single render pass (VK_KHR_multiview). */
+        VkBool32 vk_supports_multiview;
+        /* Whether or not this device supports keeping all textures in a single, partially bound array that's updated while in use (VK_EXT_descriptor_indexing). */
+        VkBool32 vk_supports_descriptor_indexing;
 
         /* The logical device this class references. */
         VkDevice vk_device;
@@ -69,6 +77,8 @@ namespace Makma3D::Rendering {
     public:
         /* Constructor for the GPU class, which takes a Vulkan instance, the target surface and a list of required extensions to enable on the GPU. */
         GPU(const Instance& instance, const Surface& surface, const Tools::Array<uint32_t>& queue_counts = Tools::Array<uint32_t>({ 1, 1, 1, 1 }), const Tools::Array<const char*>& extensions = device_extensions);
+        /* Constructor for the GPU class, which takes a Vulkan instance, a pointer to the target surface and a list of required extensions to enable on the GPU. If the surface is a nullptr, the GPU is headless: it doesn't need to be able to present, and has no present queues or swapchain info. */
+        GPU(const Instance& instance, const Surface* surface, const Tools::Array<uint32_t>& queue_counts = Tools::Array<uint32_t>({ 1, 1, 1, 1 }), const Tools::Array<const char*>& extensions = headless_device_extensions);
         /* Copy constructor for the GPU class. */
         GPU(const GPU& other);
         /* Move constructor for the GPU class. */
@@ -86,13 +96,25 @@ namespace Makma3D::Rendering {
         /* Returns the array that contains all queues of the given family. */
         inline const Tools::Array<VkQueue>& queues(QueueType family) const { return this->vk_queues[static_cast<uint32_t>(family)]; }
 
-        /* Refreshes the swapchain info, based on the new surface. */
+        /* Refreshes the swapchain info, based on the new surface. Does nothing for headless GPUs. */
         void refresh_swapchain_info();
 
+        /* Returns whether or not the GPU is headless, i.e., has no surface to present to. */
+        inline bool headless() const { return this->surface == nullptr; }
         /* Returns the name of the chosen GPU. */
         inline std::string name() const { return std::string(this->vk_physical_device_properties.deviceName); }
         /* Returns whether or not the GPU supports anisotropic filtering. */
         inline VkBool32 supports_anisotropy() const { return this->vk_supports_anisotropy; }
+        /* Returns whether or not the GPU supports pipeline statistics queries. */
+        inline VkBool32 supports_pipeline_statistics() const { return this->vk_supports_pipeline_statistics; }
+        /* Returns whether or not the GPU supports rendering to several views in a single render pass. */
+        inline VkBool32 supports_multiview() const { return this->vk_supports_multiview; }
+        /* Returns whether or not the GPU supports keeping all textures in a single, partially bound array that's updated while in use. */
+        inline VkBool32 supports_descriptor_indexing() const { return this->vk_supports_descriptor_indexing; }
+        /* Returns whether or not the GPU supports timestamp queries on its graphics queues. */
+        inline bool supports_timestamps() const { return this->vk_physical_device_properties.limits.timestampComputeAndGraphics == VK_TRUE; }
+        /* Returns the number of nanoseconds it takes for a timestamp query to be incremented by one. */
+        inline float timestamp_period() const { return this->vk_physical_device_properties.limits.timestampPeriod; }
         /* Returns the queue information of the chosen GPU. */
         inline const QueueInfo& queue_info() const { return this->vk_queue_info; }
         /* Returns the swapchain information of the chosen GPU. */
@@ -4,7 +4,7 @@
  * Created:
  *   05/06/2021, 15:27:42
  * Last edited:
- *   9/20/2021, 8:14:07 PM
+ *   19/10/2026, 01:06:35
  * Auto updated?
  *   Yes
  *
@@ -32,7 +32,7 @@ QueueInfo::QueueInfo() :
     })
 {}
 
-/* Constructor for the QueueInfo class, which takes a Vulkan physical device and surface and uses that to set its own properties. */
+/* Constructor for the QueueInfo class, which takes a Vulkan physical device and surface and uses that to set its own properties. If the surface is VK_NULL_HANDLE, no queue is considered to be able to present. */
 QueueInfo::QueueInfo(const VkPhysicalDevice& vk_physical_device, const VkSurfaceKHR& vk_surface) :
     // Initialize the queue info to nothing being supported
     QueueInfo()
@@ -43,7 +43,7 @@ QueueInfo::QueueInfo(const VkPhysicalDevice& vk_physical_device, const VkSurface
 
 
 
-/* Refreshes the QueueInfo, i.e., re-populates its values according to the given device and surface. */
+/* Refreshes the QueueInfo, i.e., re-populates its values according to the given device and surface. If the surface is VK_NULL_HANDLE, no queue is considered to be able to present. */
 void QueueInfo::refresh(const VkPhysicalDevice& vk_physical_device, const VkSurfaceKHR& vk_surface) {
     logger.logc(Verbosity::details, QueueInfo::channel, "Refreshing QueueInfo...");
 
@@ -60,14 +60,14 @@ void QueueInfo::refresh(const VkPhysicalDevice& vk_physical_device, const VkSurf
     }
 
     // Loop through the queues to find the compute queue
-    VkBool32 vk_can_present;
+    VkBool32 vk_can_present = VK_FALSE;
     for (uint32_t i = 0; i < supported_queues.size(); i++) {
         // First, collect the properties of the queue family
         bool capabilities[QueueInfo::n_queues];
         capabilities[0] = supported_queues[i].queueFlags & VK_QUEUE_GRAPHICS_BIT;
         capabilities[1] = supported_queues[i].queueFlags & VK_QUEUE_COMPUTE_BIT;
         capabilities[2] = supported_queues[i].queueFlags & VK_QUEUE_TRANSFER_BIT;
-        vkGetPhysicalDeviceSurfaceSupportKHR(vk_physical_device, i, vk_surface, &vk_can_present);
+        if (vk_surface != VK_NULL_HANDLE) { vkGetPhysicalDeviceSurfaceSupportKHR(vk_physical_device, i, vk_surface, &vk_can_present); }
         capabilities[3] = (bool) vk_can_present;
 
         // Use that to count how many abilities the queue has
@@ -99,10 +99,10 @@ void QueueInfo::refresh(const VkPhysicalDevice& vk_physical_device, const VkSurf
         }
     }
 
-    // Next, set the unique queue(count)
+    // Next, set the unique queue(count). Note that there may be less queue indices than queue types if some are unsupported
     this->uqueues_indices.clear();
     this->uqueues_indices.reserve(QueueInfo::n_queues);
-    for (uint32_t i = 0; i < QueueInfo::n_queues; i++) {
+    for (uint32_t i = 0; i < this->queue_indices.size(); i++) {
         // Check if it already occurs
         bool found = false;
         for (uint32_t j = 0; j < this->uqueues_indices.size(); j++) {
@@ -4,7 +4,7 @@
  * Created:
  *   05/06/2021, 15:27:33
  * Last edited:
- *   05/06/2021, 15:27:33
+ *   19/10/2026, 01:06:35
  * Auto updated?
  *   Yes
  *
@@ -62,10 +62,10 @@ namespace Makma3D::Rendering {
     public:
         /* Default constructor for the QueueInfo class, which initializes the info to nothing supported. Use ::refresh() to populate it normally. */
         QueueInfo();
-        /* Constructor for the QueueInfo class, which takes a Vulkan physical device and surface and uses that to set its own properties. */
+        /* Constructor for the QueueInfo class, which takes a Vulkan physical device and surface and uses that to set its own properties. If the surface is VK_NULL_HANDLE, no queue is considered to be able to present. */
         QueueInfo(const VkPhysicalDevice& vk_physical_device, const VkSurfaceKHR& vk_surface);
 
-        /* Refreshes the QueueInfo, i.e., re-populates its values according to the given device and surface. */
+        /* Refreshes the QueueInfo, i.e., re-populates its values according to the given device and surface. If the surface is VK_NULL_HANDLE, no queue is considered to be able to present. */
         void refresh(const VkPhysicalDevice& vk_physical_device, const VkSurfaceKHR& vk_surface);
 
         /* Returns the queue family of the given type. */
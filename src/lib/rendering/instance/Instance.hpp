@@ -4,7 +4,7 @@
  * Created:
  *   30/04/2021, 14:03:39
  * Last edited:
- *   10/09/2021, 10:55:53
+ *   19/10/2026, 02:41:16
  * Auto updated?
  *   Yes
  *
@@ -24,7 +24,8 @@
 namespace Makma3D::Rendering {
     /* The Vulkan instance extensions we want to be enabled. */
     const Tools::Array<const char*> instance_extensions({
-        VK_EXT_DEBUG_UTILS_EXTENSION_NAME
+        VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
+        VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME
     });
     /* The Vulkan validation layers we want to be enabled. */
     const Tools::Array<const char*> debug_layers({
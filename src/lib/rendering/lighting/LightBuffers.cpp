@@ -0,0 +1,174 @@
+/* LIGHT BUFFERS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 03:27:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the LightBuffers class, which owns the buffers through which
+ *   a single frame hands the clustered lights to the fragment shaders:
+ *   the clustering parameters, the lights, the clusters and their light
+ *   indices. All of them live in host-visible memory, since they're
+ *   rewritten every frame.
+**/
+
+#include <cstring>
+#include <algorithm>
+
+#include "tools/Logger.hpp"
+
+#include "LightBuffers.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** LIGHTBUFFERS CLASS *****/
+/* Constructor for the LightBuffers class, which takes the GPU where they live. */
+LightBuffers::LightBuffers(const Rendering::GPU& gpu) :
+    gpu(gpu),
+    params({ nullptr, nullptr, nullptr, 0 }),
+    lights({ nullptr, nullptr, nullptr, 0 }),
+    clusters({ nullptr, nullptr, nullptr, 0 }),
+    indices({ nullptr, nullptr, nullptr, 0 })
+{
+    // Make sure there's always something to bind, even if there are no lights
+    this->_reserve(this->params, sizeof(ClusterParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    this->_reserve(this->lights, 64 * sizeof(LightData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    this->_reserve(this->clusters, LightClusterer::default_tiles_x * LightClusterer::default_tiles_y * LightClusterer::default_slices * sizeof(ClusterData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    this->_reserve(this->indices, 1024 * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+}
+
+/* Move constructor for the LightBuffers class. */
+LightBuffers::LightBuffers(LightBuffers&& other) :
+    gpu(other.gpu),
+    params(other.params),
+    lights(other.lights),
+    clusters(other.clusters),
+    indices(other.indices)
+{
+    // Make sure the other doesn't deallocate anything
+    other.params = { nullptr, nullptr, nullptr, 0 };
+    other.lights = { nullptr, nullptr, nullptr, 0 };
+    other.clusters = { nullptr, nullptr, nullptr, 0 };
+    other.indices = { nullptr, nullptr, nullptr, 0 };
+}
+
+/* Destructor for the LightBuffers class. */
+LightBuffers::~LightBuffers() {
+    this->_release(this->indices);
+    this->_release(this->clusters);
+    this->_release(this->lights);
+    this->_release(this->params);
+}
+
+
+
+/* Private helper function that (re)allocates the given buffer such that it can hold at least the given number of bytes, with the given usage. Returns whether it had to be reallocated. The frame may not be in flight. */
+bool LightBuffers::_reserve(MappedBuffer& target, VkDeviceSize n_bytes, VkBufferUsageFlags usage) {
+    if (target.capacity >= n_bytes) { return false; }
+
+    // Grow at least twice as large, so a slowly growing number of lights doesn't reallocate every frame
+    VkDeviceSize new_capacity = std::max(n_bytes, 2 * target.capacity);
+    logger.logc(Verbosity::debug, LightBuffers::channel, "Growing light buffer from ", target.capacity, " to ", new_capacity, " bytes...");
+    this->_release(target);
+
+    // Allocate a new one in its own pool, and map it once for as long as it lives. The memory is coherent, so we don't have to flush our writes
+    target.pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { new_capacity, usage } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, usage);
+    target.buffer = target.pool->allocate(new_capacity, usage);
+    target.buffer->map(&target.mapped);
+    target.capacity = new_capacity;
+    return true;
+}
+
+/* Private helper function that releases the given buffer, if it's allocated. */
+void LightBuffers::_release(MappedBuffer& target) {
+    if (target.buffer != nullptr) {
+        target.buffer->unmap();
+        target.pool->free(target.buffer);
+        target.buffer = nullptr;
+    }
+    if (target.pool != nullptr) {
+        delete target.pool;
+        target.pool = nullptr;
+    }
+}
+
+
+
+/* Uploads the lights and clusters of the given clusterers, one per view, and the given parameters to find them with. The views' lists are put back-to-back, so the fragment shaders of view v find their clusters after those of the views before it. Returns whether any buffer had to grow, in which case they have to be bound anew. The frame may not be in flight. */
+bool LightBuffers::upload(const Rendering::LightClusterer* clusterers, uint32_t n_views, const Rendering::ClusterParams& params) {
+    // Make room for everything first
+    size_t n_lights = 0, n_clusters = 0, n_indices = 0;
+    for (uint32_t v = 0; v < n_views; v++) {
+        n_lights += clusterers[v].lights().size();
+        n_clusters += clusterers[v].clusters().size();
+        n_indices += clusterers[v].indices().size();
+    }
+    bool grown = this->_reserve(this->lights, n_lights * sizeof(LightData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    grown = this->_reserve(this->clusters, n_clusters * sizeof(ClusterData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) || grown;
+    grown = this->_reserve(this->indices, n_indices * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) || grown;
+
+    // Then copy it over
+    std::memcpy(this->params.mapped, &params, sizeof(ClusterParams));
+    if (n_views == 1) {
+        // A single view can be copied as-is
+        const LightClusterer& clusterer = clusterers[0];
+        if (n_lights > 0) { std::memcpy(this->lights.mapped, clusterer.lights().rdata(), n_lights * sizeof(LightData)); }
+        if (n_clusters > 0) { std::memcpy(this->clusters.mapped, clusterer.clusters().rdata(), n_clusters * sizeof(ClusterData)); }
+        if (n_indices > 0) { std::memcpy(this->indices.mapped, clusterer.indices().rdata(), n_indices * sizeof(uint32_t)); }
+        return grown;
+    }
+
+    // Otherwise, each view has its own copy of the lights (since they're in its view space), so the clusters and indices of the later views have to point past those of the earlier ones
+    LightData* light_data = (LightData*) this->lights.mapped;
+    ClusterData* cluster_data = (ClusterData*) this->clusters.mapped;
+    uint32_t* index_data = (uint32_t*) this->indices.mapped;
+    uint32_t light_offset = 0, index_offset = 0;
+    for (uint32_t v = 0; v < n_views; v++) {
+        const LightClusterer& clusterer = clusterers[v];
+        if (clusterer.lights().size() > 0) { std::memcpy(light_data, clusterer.lights().rdata(), clusterer.lights().size() * sizeof(LightData)); }
+        for (uint32_t i = 0; i < clusterer.clusters().size(); i++) {
+            cluster_data[i] = { clusterer.clusters()[i].offset + index_offset, clusterer.clusters()[i].count };
+        }
+        for (uint32_t i = 0; i < clusterer.indices().size(); i++) {
+            index_data[i] = clusterer.indices()[i] + light_offset;
+        }
+
+        light_data += clusterer.lights().size();
+        cluster_data += clusterer.clusters().size();
+        index_data += clusterer.indices().size();
+        light_offset += clusterer.lights().size();
+        index_offset += clusterer.indices().size();
+    }
+    return grown;
+}
+
+/* Binds the buffers to the given descriptor set: the parameters as a uniform buffer at the given binding, and the lights, the clusters and the light indices as storage buffers at the bindings after it. */
+void LightBuffers::bind(const Rendering::DescriptorSet* set, uint32_t first_binding) const {
+    set->bind(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, first_binding, { this->params.buffer });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, first_binding + 1, { this->lights.buffer });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, first_binding + 2, { this->clusters.buffer });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, first_binding + 3, { this->indices.buffer });
+}
+
+
+
+/* Swap operator for the LightBuffers class. */
+void Rendering::swap(LightBuffers& lb1, LightBuffers& lb2) {
+    #ifndef NDEBUG
+    if (lb1.gpu != lb2.gpu) { logger.fatalc(LightBuffers::channel, "Cannot swap light buffers with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(lb1.params, lb2.params);
+    swap(lb1.lights, lb2.lights);
+    swap(lb1.clusters, lb2.clusters);
+    swap(lb1.indices, lb2.indices);
+}
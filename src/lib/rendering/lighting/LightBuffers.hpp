@@ -0,0 +1,101 @@
+/* LIGHT BUFFERS.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the LightBuffers class, which owns the buffers through which
+ *   a single frame hands the clustered lights to the fragment shaders:
+ *   the clustering parameters, the lights, the clusters and their light
+ *   indices. All of them live in host-visible memory, since they're
+ *   rewritten every frame.
+**/
+
+#ifndef RENDERING_LIGHT_BUFFERS_HPP
+#define RENDERING_LIGHT_BUFFERS_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "../gpu/GPU.hpp"
+#include "../memory/LinearMemoryPool.hpp"
+#include "../memory/Buffer.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+#include "../data/LightData.hpp"
+
+#include "LightClusterer.hpp"
+
+namespace Makma3D::Rendering {
+    /* The LightBuffers class, which owns the buffers with the clustered lights of a single frame. */
+    class LightBuffers {
+    public:
+        /* Channel name for the LightBuffers class. */
+        static constexpr const char* channel = "LightBuffers";
+        /* The number of bindings the buffers take up in a descriptor set, starting at the binding given to bind(). */
+        static constexpr const uint32_t n_bindings = 4;
+
+        /* The GPU where the LightBuffers live. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* A host-visible buffer that stays mapped for as long as it exists. */
+        struct MappedBuffer {
+            /* The pool with the buffer. Each mapped buffer has its own pool, since a pool's memory can only be mapped once at a time. */
+            Rendering::LinearMemoryPool* pool;
+            /* The buffer itself. */
+            Rendering::Buffer* buffer;
+            /* The buffer's memory. */
+            void* mapped;
+            /* The number of bytes the buffer can hold. */
+            VkDeviceSize capacity;
+        };
+
+        /* The buffer with the clustering parameters. */
+        MappedBuffer params;
+        /* The buffer with the lights, in view space. */
+        MappedBuffer lights;
+        /* The buffer with where each cluster's lights are in the list of light indices. */
+        MappedBuffer clusters;
+        /* The buffer with the light indices of all clusters, back-to-back. */
+        MappedBuffer indices;
+
+        /* Private helper function that (re)allocates the given buffer such that it can hold at least the given number of bytes, with the given usage. Returns whether it had to be reallocated. The frame may not be in flight. */
+        bool _reserve(MappedBuffer& target, VkDeviceSize n_bytes, VkBufferUsageFlags usage);
+        /* Private helper function that releases the given buffer, if it's allocated. */
+        void _release(MappedBuffer& target);
+
+    public:
+        /* Constructor for the LightBuffers class, which takes the GPU where they live. */
+        LightBuffers(const Rendering::GPU& gpu);
+        /* Copy constructor for the LightBuffers class, which is deleted. */
+        LightBuffers(const LightBuffers& other) = delete;
+        /* Move constructor for the LightBuffers class. */
+        LightBuffers(LightBuffers&& other);
+        /* Destructor for the LightBuffers class. */
+        ~LightBuffers();
+
+        /* Uploads the lights and clusters of the given clusterers, one per view, and the given parameters to find them with. The views' lists are put back-to-back, so the fragment shaders of view v find their clusters after those of the views before it. Returns whether any buffer had to grow, in which case they have to be bound anew. The frame may not be in flight. */
+        bool upload(const Rendering::LightClusterer* clusterers, uint32_t n_views, const Rendering::ClusterParams& params);
+        /* Binds the buffers to the given descriptor set: the parameters as a uniform buffer at the given binding, and the lights, the clusters and the light indices as storage buffers at the bindings after it. */
+        void bind(const Rendering::DescriptorSet* set, uint32_t first_binding) const;
+
+        /* Copy assignment operator for the LightBuffers class, which is deleted. */
+        LightBuffers& operator=(const LightBuffers& other) = delete;
+        /* Move assignment operator for the LightBuffers class. */
+        inline LightBuffers& operator=(LightBuffers&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the LightBuffers class. */
+        friend void swap(LightBuffers& lb1, LightBuffers& lb2);
+
+    };
+
+    /* Swap operator for the LightBuffers class. */
+    void swap(LightBuffers& lb1, LightBuffers& lb2);
+
+}
+
+#endif
@@ -0,0 +1,299 @@
+/* LIGHT CLUSTERER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the LightClusterer class, which splits the view frustum in
+ *   a 3D grid of clusters (tiles on the screen times exponential depth
+ *   slices) and lists for each cluster which point lights touch it, so
+ *   the fragment shaders only have to loop over the lights of their own
+ *   cluster. The lights are tested against the clusters' view-space
+ *   bounding boxes four at a time with SSE2, and the depth slices are
+ *   divided over threads. Lives without any GPU, so it can be tested on
+ *   its own.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "LightClusterer.hpp"
+
+// Use SSE2 to test four lights at a time wherever it's available, which is on any x86-64 CPU
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLUSTER_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns a mask with a bit set for each of the four lights at the given index in the given candidates that touches the given box, i.e., whose centre lies within its radius of the box. */
+static inline uint32_t touches4(const float* x, const float* y, const float* z, const float* r2, const glm::vec3& min, const glm::vec3& max) {
+    #ifdef CLUSTER_SSE2
+    // The distance to the box along each axis is how far the centre lies beyond either side of it; only one of the two can be positive
+    __m128 zero = _mm_setzero_ps();
+    __m128 cx = _mm_loadu_ps(x);
+    __m128 cy = _mm_loadu_ps(y);
+    __m128 cz = _mm_loadu_ps(z);
+    __m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(min.x), cx), zero), _mm_max_ps(_mm_sub_ps(cx, _mm_set1_ps(max.x)), zero));
+    __m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(min.y), cy), zero), _mm_max_ps(_mm_sub_ps(cy, _mm_set1_ps(max.y)), zero));
+    __m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(min.z), cz), zero), _mm_max_ps(_mm_sub_ps(cz, _mm_set1_ps(max.z)), zero));
+    __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    return (uint32_t) _mm_movemask_ps(_mm_cmple_ps(d2, _mm_loadu_ps(r2)));
+
+    #else
+    // Do the same, one light at a time
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        float dx = std::max(min.x - x[i], 0.0f) + std::max(x[i] - max.x, 0.0f);
+        float dy = std::max(min.y - y[i], 0.0f) + std::max(y[i] - max.y, 0.0f);
+        float dz = std::max(min.z - z[i], 0.0f) + std::max(z[i] - max.z, 0.0f);
+        if (dx * dx + dy * dy + dz * dz <= r2[i]) { mask |= 1 << i; }
+    }
+    return mask;
+
+    #endif
+}
+
+/* Appends the given light to the given candidates at the given index. The arrays must have room for it. */
+static inline void set_candidate(float* x, float* y, float* z, float* r2, uint32_t* lights, uint32_t index, float cx, float cy, float cz, float cr2, uint32_t light) {
+    x[index] = cx;
+    y[index] = cy;
+    z[index] = cz;
+    r2[index] = cr2;
+    lights[index] = light;
+}
+
+
+
+
+
+/***** LIGHTCLUSTERER CLASS *****/
+/* Constructor for the LightClusterer class, which takes the number of clusters in x, in y and in depth. */
+LightClusterer::LightClusterer(uint32_t tiles_x, uint32_t tiles_y, uint32_t slices) :
+    _tiles_x(tiles_x),
+    _tiles_y(tiles_y),
+    _slices(slices),
+
+    proj(0.0f),
+    _width(0),
+    _height(0),
+    _first_slice(0.0f),
+    slice_scale(0.0f),
+    slice_bias(0.0f)
+{
+    // Prepare the bounds and the clusters, which never change size
+    this->slice_depths.resize(this->_slices + 1);
+    this->cluster_min.resize(this->size());
+    this->cluster_max.resize(this->size());
+    this->row_min.resize(this->_slices * this->_tiles_y);
+    this->row_max.resize(this->_slices * this->_tiles_y);
+    this->_clusters.resize(this->size());
+    for (uint32_t i = 0; i < this->size(); i++) { this->_clusters[i] = { 0, 0 }; }
+}
+
+
+
+/* Tells the clusterer through which projection matrix and at what screen size (in pixels) the lights are seen. The cluster bounds are only recomputed if the matrix changed. */
+void LightClusterer::set_projection(const glm::mat4& proj, uint32_t width, uint32_t height) {
+    // The size only affects the parameters of the shaders, since the clusters are laid out in normalized device coordinates
+    this->_width = width;
+    this->_height = height;
+    if (proj == this->proj) { return; }
+    this->proj = proj;
+
+    // Find the far plane. Both depth ranges (-1 to 1 and 0 to 1) share the same formula for it
+    float far = proj[3][2] / (proj[2][2] + 1.0f);
+    this->_first_slice = far * LightClusterer::first_slice_fraction;
+
+    // The first slice runs up to first_slice, after which the slices grow exponentially up to the far plane
+    uint32_t n_exp = this->_slices - 1;
+    this->slice_scale = n_exp > 0 ? (float) n_exp / std::log(far / this->_first_slice) : 0.0f;
+    this->slice_bias = -std::log(this->_first_slice) * this->slice_scale;
+    this->slice_depths[0] = 0.0f;
+    for (uint32_t s = 1; s < this->_slices; s++) {
+        this->slice_depths[s] = this->_first_slice * std::pow(far / this->_first_slice, (float) (s - 1) / (float) n_exp);
+    }
+    this->slice_depths[this->_slices] = far;
+
+    // Find the direction of the rays through the corners of each tile, scaled such that they're one unit deep. Works for any perspective projection, regardless of its depth range or which way y points
+    glm::mat4 inv_proj = glm::inverse(proj);
+    Tools::Array<glm::vec3> rays((this->_tiles_x + 1) * (this->_tiles_y + 1));
+    for (uint32_t y = 0; y <= this->_tiles_y; y++) {
+        for (uint32_t x = 0; x <= this->_tiles_x; x++) {
+            glm::vec4 point = inv_proj * glm::vec4(2.0f * (float) x / (float) this->_tiles_x - 1.0f, 2.0f * (float) y / (float) this->_tiles_y - 1.0f, 0.5f, 1.0f);
+            glm::vec3 ray = glm::vec3(point) / point.w;
+            rays.push_back(ray / -ray.z);
+        }
+    }
+
+    // The bounding box of a cluster then spans its tile's rays between the depths of its slice
+    for (uint32_t s = 0; s < this->_slices; s++) {
+        float near_depth = this->slice_depths[s];
+        float far_depth = this->slice_depths[s + 1];
+        for (uint32_t y = 0; y < this->_tiles_y; y++) {
+            glm::vec3 row_lo(std::numeric_limits<float>::max());
+            glm::vec3 row_hi(-std::numeric_limits<float>::max());
+            for (uint32_t x = 0; x < this->_tiles_x; x++) {
+                glm::vec3 lo(std::numeric_limits<float>::max());
+                glm::vec3 hi(-std::numeric_limits<float>::max());
+                for (uint32_t i = 0; i < 4; i++) {
+                    const glm::vec3& ray = rays[(y + (i >> 1)) * (this->_tiles_x + 1) + x + (i & 1)];
+                    lo = glm::min(lo, glm::min(ray * near_depth, ray * far_depth));
+                    hi = glm::max(hi, glm::max(ray * near_depth, ray * far_depth));
+                }
+                uint32_t c = this->cluster_index(x, y, s);
+                this->cluster_min[c] = lo;
+                this->cluster_max[c] = hi;
+                row_lo = glm::min(row_lo, lo);
+                row_hi = glm::max(row_hi, hi);
+            }
+            this->row_min[s * this->_tiles_y + y] = row_lo;
+            this->row_max[s * this->_tiles_y + y] = row_hi;
+        }
+    }
+}
+
+/* Private helper function that lists the lights of all clusters in the given range of slices, using the given job's memory. Offsets are relative to the start of the job's own list. */
+void LightClusterer::_cluster_slices(uint32_t job, uint32_t first_slice, uint32_t last_slice) {
+    Scratch& mem = this->scratch[job];
+    mem.indices.clear();
+    mem.indices.reserve_opt(64);
+
+    // Make sure the candidates have room for all lights, plus the padding
+    uint32_t n_lights = this->_lights.size();
+    uint32_t n_padded = (n_lights + 3) & ~3U;
+    for (Candidates* candidates : { &mem.slice, &mem.row }) {
+        candidates->x.reserve_opt(n_padded);
+        candidates->y.reserve_opt(n_padded);
+        candidates->z.reserve_opt(n_padded);
+        candidates->r2.reserve_opt(n_padded);
+        candidates->lights.reserve_opt(n_padded);
+    }
+    float* sx = mem.slice.x.wdata();
+    float* sy = mem.slice.y.wdata();
+    float* sz = mem.slice.z.wdata();
+    float* sr2 = mem.slice.r2.wdata();
+    uint32_t* slights = mem.slice.lights.wdata();
+    float* rx = mem.row.x.wdata();
+    float* ry = mem.row.y.wdata();
+    float* rz = mem.row.z.wdata();
+    float* rr2 = mem.row.r2.wdata();
+    uint32_t* rlights = mem.row.lights.wdata();
+
+    for (uint32_t s = first_slice; s < last_slice; s++) {
+        // Collect the lights whose depth range overlaps the slice. Padding lights have a negative squared radius, so they never touch anything
+        float near_depth = this->slice_depths[s];
+        float far_depth = this->slice_depths[s + 1];
+        uint32_t n_slice = 0;
+        for (uint32_t i = 0; i < n_lights; i++) {
+            const glm::vec4& light = this->_lights[i].position;
+            if (-light.z + light.w < near_depth || -light.z - light.w > far_depth) { continue; }
+            set_candidate(sx, sy, sz, sr2, slights, n_slice++, light.x, light.y, light.z, light.w * light.w, i);
+        }
+        while (n_slice & 3) { set_candidate(sx, sy, sz, sr2, slights, n_slice++, 0.0f, 0.0f, 0.0f, -1.0f, 0); }
+
+        for (uint32_t y = 0; y < this->_tiles_y; y++) {
+            // Narrow the candidates down to those that touch the row as a whole
+            uint32_t n_row = 0;
+            const glm::vec3& row_lo = this->row_min[s * this->_tiles_y + y];
+            const glm::vec3& row_hi = this->row_max[s * this->_tiles_y + y];
+            for (uint32_t i = 0; i < n_slice; i += 4) {
+                uint32_t mask = touches4(sx + i, sy + i, sz + i, sr2 + i, row_lo, row_hi);
+                for (uint32_t b = 0; b < 4; b++) {
+                    if (mask & (1 << b)) { set_candidate(rx, ry, rz, rr2, rlights, n_row++, sx[i + b], sy[i + b], sz[i + b], sr2[i + b], slights[i + b]); }
+                }
+            }
+            while (n_row & 3) { set_candidate(rx, ry, rz, rr2, rlights, n_row++, 0.0f, 0.0f, 0.0f, -1.0f, 0); }
+
+            // Then test those against each cluster in the row, in order so the lists come out sorted by light
+            for (uint32_t x = 0; x < this->_tiles_x; x++) {
+                uint32_t c = this->cluster_index(x, y, s);
+                uint32_t offset = mem.indices.size();
+                while (offset + n_row > mem.indices.capacity()) { mem.indices.reserve(2 * mem.indices.capacity()); }
+                uint32_t* out = mem.indices.wdata();
+                uint32_t n_out = offset;
+                for (uint32_t i = 0; i < n_row; i += 4) {
+                    uint32_t mask = touches4(rx + i, ry + i, rz + i, rr2 + i, this->cluster_min[c], this->cluster_max[c]);
+                    for (uint32_t b = 0; b < 4; b++) {
+                        if (mask & (1 << b)) { out[n_out++] = rlights[i + b]; }
+                    }
+                }
+                mem.indices.wdata(n_out);
+                this->_clusters[c] = { offset, n_out - offset };
+            }
+        }
+    }
+}
+
+/* Moves the given world-space lights to the view space of the given view matrix, and lists for each cluster which of them touch it. If a pool is given, the slices are divided over its threads. */
+void LightClusterer::cluster(const glm::mat4& view, const Rendering::LightData* lights, uint32_t n_lights, Tools::ThreadPool* pool) {
+    // Move the lights to view space, where the cluster bounds live
+    this->_lights.clear();
+    this->_lights.reserve_opt(n_lights);
+    Rendering::LightData* view_lights = this->_lights.wdata(n_lights);
+    for (uint32_t i = 0; i < n_lights; i++) {
+        view_lights[i].position = glm::vec4(glm::vec3(view * glm::vec4(glm::vec3(lights[i].position), 1.0f)), lights[i].position.w);
+        view_lights[i].colour = lights[i].colour;
+    }
+
+    // Give each job a contiguous range of slices, so its clusters are contiguous too
+    uint32_t n_jobs = pool != nullptr ? std::min(pool->size(), this->_slices) : 1;
+    this->scratch.resize_opt(n_jobs);
+    if (n_jobs <= 1) {
+        this->_cluster_slices(0, 0, this->_slices);
+    } else {
+        pool->run(n_jobs, [this, n_jobs](uint32_t job) {
+            this->_cluster_slices(job, job * this->_slices / n_jobs, (job + 1) * this->_slices / n_jobs);
+        });
+    }
+
+    // Stitch the lists of the jobs together, which gives the same list regardless of the number of jobs
+    uint32_t n_indices = 0;
+    for (uint32_t j = 0; j < n_jobs; j++) { n_indices += this->scratch[j].indices.size(); }
+    this->_indices.clear();
+    this->_indices.reserve_opt(n_indices);
+    uint32_t* out = this->_indices.wdata(n_indices);
+    uint32_t base = 0;
+    for (uint32_t j = 0; j < n_jobs; j++) {
+        const Tools::Array<uint32_t>& indices = this->scratch[j].indices;
+        if (indices.size() > 0) { memcpy(out + base, indices.rdata(), indices.size() * sizeof(uint32_t)); }
+        uint32_t first = this->cluster_index(0, 0, j * this->_slices / n_jobs);
+        uint32_t last = this->cluster_index(0, 0, (j + 1) * this->_slices / n_jobs);
+        for (uint32_t c = first; c < last; c++) { this->_clusters[c].offset += base; }
+        base += indices.size();
+    }
+}
+
+
+
+/* Returns the parameters the fragment shaders need to find their cluster, with the given amount of ambient light. */
+Rendering::ClusterParams LightClusterer::params(float ambient) const {
+    Rendering::ClusterParams result{};
+    result.grid = glm::uvec4(this->_tiles_x, this->_tiles_y, this->_slices, this->_lights.size());
+    result.tile_size = glm::vec2((float) this->_width / (float) this->_tiles_x, (float) this->_height / (float) this->_tiles_y);
+    result.slice_scale = this->slice_scale;
+    result.slice_bias = this->slice_bias;
+    result.first_slice = this->_first_slice;
+    result.ambient = ambient;
+    return result;
+}
+
+/* Returns the depth slice of the given (positive) view-space depth. */
+uint32_t LightClusterer::slice(float depth) const {
+    // Must match the computation in lighting.glsl
+    if (depth < this->_first_slice) { return 0; }
+    int32_t s = 1 + (int32_t) std::floor(std::log(depth) * this->slice_scale + this->slice_bias);
+    return (uint32_t) std::max(1, std::min(s, (int32_t) this->_slices - 1));
+}
@@ -0,0 +1,151 @@
+/* LIGHT CLUSTERER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the LightClusterer class, which splits the view frustum in
+ *   a 3D grid of clusters (tiles on the screen times exponential depth
+ *   slices) and lists for each cluster which point lights touch it, so
+ *   the fragment shaders only have to loop over the lights of their own
+ *   cluster. The lights are tested against the clusters' view-space
+ *   bounding boxes four at a time with SSE2, and the depth slices are
+ *   divided over threads. Lives without any GPU, so it can be tested on
+ *   its own.
+**/
+
+#ifndef RENDERING_LIGHT_CLUSTERER_HPP
+#define RENDERING_LIGHT_CLUSTERER_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+#include "tools/Array.hpp"
+#include "tools/ThreadPool.hpp"
+
+#include "../data/LightData.hpp"
+
+namespace Makma3D::Rendering {
+    /* The LightClusterer class, which assigns point lights to the clusters of the view frustum on the CPU. */
+    class LightClusterer {
+    public:
+        /* Channel name for the LightClusterer class. */
+        static constexpr const char* channel = "LightClusterer";
+        /* The default number of clusters in x. */
+        static constexpr const uint32_t default_tiles_x = 16;
+        /* The default number of clusters in y. */
+        static constexpr const uint32_t default_tiles_y = 9;
+        /* The default number of depth slices. */
+        static constexpr const uint32_t default_slices = 24;
+        /* The fraction of the far plane's depth at which the first depth slice ends. Everything nearer shares a single slice, so the exponential slices aren't wasted on the few centimeters in front of the camera. */
+        static constexpr const float first_slice_fraction = 1.0f / 64.0f;
+
+    private:
+        /* The lights that may touch a slice or row of clusters, in SIMD-friendly form. The lists are padded to a multiple of four with lights that touch nothing. */
+        struct Candidates {
+            /* The x-coordinates of the lights' view-space centres. */
+            Tools::Array<float> x;
+            /* The y-coordinates of the lights' view-space centres. */
+            Tools::Array<float> y;
+            /* The z-coordinates of the lights' view-space centres. */
+            Tools::Array<float> z;
+            /* The squared radii of the lights. */
+            Tools::Array<float> r2;
+            /* The indices of the lights. */
+            Tools::Array<uint32_t> lights;
+        };
+        /* The memory each job uses while clustering, kept around to re-use it. */
+        struct Scratch {
+            /* The lights that may touch the current slice. */
+            Candidates slice;
+            /* The lights that may touch the current row of the current slice. */
+            Candidates row;
+            /* The light indices of the job's clusters, back-to-back. */
+            Tools::Array<uint32_t> indices;
+        };
+
+        /* The number of clusters in x. */
+        uint32_t _tiles_x;
+        /* The number of clusters in y. */
+        uint32_t _tiles_y;
+        /* The number of depth slices. */
+        uint32_t _slices;
+
+        /* The projection matrix for which the cluster bounds were computed. */
+        glm::mat4 proj;
+        /* The width of the screen, in pixels. */
+        uint32_t _width;
+        /* The height of the screen, in pixels. */
+        uint32_t _height;
+        /* The view-space depth where the first depth slice ends. */
+        float _first_slice;
+        /* The scale with which the log of a depth is turned into a slice. */
+        float slice_scale;
+        /* The bias added to the scaled log of a depth to get a slice. */
+        float slice_bias;
+        /* The view-space depths where each slice starts, plus where the last one ends. */
+        Tools::Array<float> slice_depths;
+        /* The view-space bounding boxes of the clusters, as their minima... */
+        Tools::Array<glm::vec3> cluster_min;
+        /* ...and their maxima. */
+        Tools::Array<glm::vec3> cluster_max;
+        /* The view-space bounding boxes of each row of clusters in each slice, as their minima... */
+        Tools::Array<glm::vec3> row_min;
+        /* ...and their maxima. */
+        Tools::Array<glm::vec3> row_max;
+
+        /* The lights that were last clustered, moved to view space. */
+        Tools::Array<Rendering::LightData> _lights;
+        /* Where each cluster's lights are in the list of light indices. */
+        Tools::Array<Rendering::ClusterData> _clusters;
+        /* The light indices of all clusters, back-to-back. */
+        Tools::Array<uint32_t> _indices;
+        /* The memory of each job. */
+        Tools::Array<Scratch> scratch;
+
+        /* Private helper function that lists the lights of all clusters in the given range of slices, using the given job's memory. Offsets are relative to the start of the job's own list. */
+        void _cluster_slices(uint32_t job, uint32_t first_slice, uint32_t last_slice);
+
+    public:
+        /* Constructor for the LightClusterer class, which takes the number of clusters in x, in y and in depth. */
+        LightClusterer(uint32_t tiles_x = LightClusterer::default_tiles_x, uint32_t tiles_y = LightClusterer::default_tiles_y, uint32_t slices = LightClusterer::default_slices);
+
+        /* Tells the clusterer through which projection matrix and at what screen size (in pixels) the lights are seen. The cluster bounds are only recomputed if the matrix changed. */
+        void set_projection(const glm::mat4& proj, uint32_t width, uint32_t height);
+        /* Moves the given world-space lights to the view space of the given view matrix, and lists for each cluster which of them touch it. If a pool is given, the slices are divided over its threads. */
+        void cluster(const glm::mat4& view, const Rendering::LightData* lights, uint32_t n_lights, Tools::ThreadPool* pool = nullptr);
+
+        /* Returns the parameters the fragment shaders need to find their cluster, with the given amount of ambient light. */
+        Rendering::ClusterParams params(float ambient) const;
+        /* Returns the depth slice of the given (positive) view-space depth. */
+        uint32_t slice(float depth) const;
+        /* Returns the index of the cluster at the given tile & slice. */
+        inline uint32_t cluster_index(uint32_t x, uint32_t y, uint32_t slice) const { return (slice * this->_tiles_y + y) * this->_tiles_x + x; }
+        /* Returns the view-space bounding box of the cluster with the given index. */
+        inline void cluster_bounds(uint32_t index, glm::vec3& min, glm::vec3& max) const { min = this->cluster_min[index]; max = this->cluster_max[index]; }
+
+        /* Returns the lights that were last clustered, in view space. */
+        inline const Tools::Array<Rendering::LightData>& lights() const { return this->_lights; }
+        /* Returns where each cluster's lights are in the list of light indices. */
+        inline const Tools::Array<Rendering::ClusterData>& clusters() const { return this->_clusters; }
+        /* Returns the light indices of all clusters, back-to-back. */
+        inline const Tools::Array<uint32_t>& indices() const { return this->_indices; }
+        /* Returns the number of clusters in x. */
+        inline uint32_t tiles_x() const { return this->_tiles_x; }
+        /* Returns the number of clusters in y. */
+        inline uint32_t tiles_y() const { return this->_tiles_y; }
+        /* Returns the number of depth slices. */
+        inline uint32_t slices() const { return this->_slices; }
+        /* Returns the total number of clusters. */
+        inline uint32_t size() const { return this->_tiles_x * this->_tiles_y * this->_slices; }
+
+    };
+
+}
+
+#endif
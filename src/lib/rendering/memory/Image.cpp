@@ -4,7 +4,7 @@
  * Created:
  *   16/08/2021, 16:14:20
  * Last edited:
- *   16/08/2021, 16:14:20
+ *   19/10/2026, 02:41:16
  * Auto updated?
  *   Yes
  *
@@ -57,14 +57,17 @@ static void populate_image_barrier(VkImageMemoryBarrier& image_barrier, VkImage
 
 
 /***** IMAGE CLASS *****/
-/* Constructor for the Image class, which takes the memory pool where it was allocated, the image object to wrap, its offset in the large pool, its extent, its format, its layout and its memory properties. Also takes other stuff that's needed to copy the image. */
-Image::Image(const MemoryPool& pool, VkImage vk_image, VkDeviceSize offset, const VkExtent2D& vk_extent, VkFormat vk_format, VkImageLayout vk_layout, const VkMemoryRequirements& vk_requirements, VkImageUsageFlags image_usage, VkSharingMode sharing_mode, VkImageCreateFlags create_flags) :
+/* Constructor for the Image class, which takes the memory pool where it was allocated, the image object to wrap, its offset in the large pool, its extent, its format, its layout, its memory properties, its number of mip levels and its number of array layers. Also takes other stuff that's needed to copy the image. */
+Image::Image(const MemoryPool& pool, VkImage vk_image, VkDeviceSize offset, const VkExtent2D& vk_extent, VkFormat vk_format, VkImageLayout vk_layout, const VkMemoryRequirements& vk_requirements, uint32_t vk_mip_levels, uint32_t vk_layers, VkImageUsageFlags image_usage, VkSharingMode sharing_mode, VkImageCreateFlags create_flags) :
     MemoryObject(pool, MemoryObjectType::image, offset),
     vk_image(vk_image),
     vk_extent(vk_extent),
     vk_format(vk_format),
     vk_layout(vk_layout),
+    vk_mip_levels(vk_mip_levels),
+    vk_layers(vk_layers),
     vk_requirements(vk_requirements),
+    aliased(false),
     init_data({ image_usage, sharing_mode, create_flags })
 {}
 
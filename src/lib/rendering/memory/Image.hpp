@@ -4,7 +4,7 @@
  * Created:
  *   16/08/2021, 16:14:17
  * Last edited:
- *   16/08/2021, 16:14:17
+ *   19/10/2026, 02:41:16
  * Auto updated?
  *   Yes
  *
@@ -48,8 +48,14 @@ namespace Makma3D::Rendering {
         VkFormat vk_format;
         /* The layout of the image. */
         VkImageLayout vk_layout;
+        /* The number of mip levels in the image. */
+        uint32_t vk_mip_levels;
+        /* The number of array layers in the image. */
+        uint32_t vk_layers;
         /* The memory requirements of this specific object, including its real size (in bytes). */
         VkMemoryRequirements vk_requirements;
+        /* Whether the image shares the memory of another image (see MemoryPool::alias()), in which case freeing it doesn't free the memory. */
+        bool aliased;
 
         /* Other data needed only for the buffer to be copyable. */
         InitData init_data;
@@ -60,8 +66,8 @@ namespace Makma3D::Rendering {
         friend class MemoryPool;
 
 
-        /* Constructor for the Image class, which takes the memory pool where it was allocated, the image object to wrap, its offset in the large pool, its extent, its format, its layout and its memory properties. Also takes other stuff that's needed to copy the image. */
-        Image(const MemoryPool& pool, VkImage vk_image, VkDeviceSize offset, const VkExtent2D& vk_extent, VkFormat vk_format, VkImageLayout vk_layout, const VkMemoryRequirements& vk_requirements, VkImageUsageFlags image_usage, VkSharingMode sharing_mode, VkImageCreateFlags create_flags);
+        /* Constructor for the Image class, which takes the memory pool where it was allocated, the image object to wrap, its offset in the large pool, its extent, its format, its layout, its memory properties, its number of mip levels and its number of array layers. Also takes other stuff that's needed to copy the image. */
+        Image(const MemoryPool& pool, VkImage vk_image, VkDeviceSize offset, const VkExtent2D& vk_extent, VkFormat vk_format, VkImageLayout vk_layout, const VkMemoryRequirements& vk_requirements, uint32_t vk_mip_levels, uint32_t vk_layers, VkImageUsageFlags image_usage, VkSharingMode sharing_mode, VkImageCreateFlags create_flags);
         /* Destructor for the Image class. */
         ~Image();
     
@@ -80,12 +86,18 @@ namespace Makma3D::Rendering {
         inline const VkFormat& format() const { return this->vk_format; }
         /* Returns the layout of the image. */
         inline const VkImageLayout& layout() const { return this->vk_layout; }
+        /* Returns the number of mip levels in the image. */
+        inline uint32_t mip_levels() const { return this->vk_mip_levels; }
+        /* Returns the number of array layers in the image. */
+        inline uint32_t layers() const { return this->vk_layers; }
         /* Returns the memory offset of the buffer, in bytes. */
         inline VkDeviceSize offset() const { return this->object_offset; }
         /* Returns the conceptual size of the image, in bytes. */
         inline VkDeviceSize size() const { return 4 * this->vk_extent.width * this->vk_extent.height; }
         /* Returns the size of the image, in bytes. */
         inline VkDeviceSize rsize() const { return this->vk_requirements.size; }
+        /* Returns whether the image shares the memory of another image. */
+        inline bool is_alias() const { return this->aliased; }
         /* Explicit retrieval of the internal VkImage object. */
         inline const VkImage& vulkan() const { return this->vk_image; }
         /* Implicit retrieval of the internal VkImage object. */
@@ -4,7 +4,7 @@
  * Created:
  *   30/09/2021, 15:44:33
  * Last edited:
- *   30/09/2021, 15:44:33
+ *   19/10/2026, 03:27:35
  * Auto updated?
  *   Yes
  *
@@ -39,6 +39,26 @@ LinearMemoryPool::~LinearMemoryPool() {}
 
 
 
+/* Returns the exact number of bytes a LinearMemoryPool needs to hold Buffers of the given sizes & usage flags, allocated in the given order. Uses each buffer's real memory requirements, so includes its size & alignment padding on the given GPU. */
+VkDeviceSize LinearMemoryPool::required_size(const Rendering::GPU& gpu, const Tools::Array<std::pair<VkDeviceSize, VkBufferUsageFlags>>& buffers) {
+    // Walk the buffers like the allocator would
+    VkDeviceSize result = 0;
+    for (uint32_t i = 0; i < buffers.size(); i++) {
+        VkMemoryRequirements requirements = MemoryPool::buffer_requirements(gpu, buffers[i].first, buffers[i].second);
+
+        // Align the offset up to where this buffer would start, then add its size
+        if (requirements.alignment > 0 && result % requirements.alignment != 0) {
+            result += requirements.alignment - (result % requirements.alignment);
+        }
+        result += requirements.size;
+    }
+
+    // Done
+    return result;
+}
+
+
+
 /* Private helper function that does the actual memory allocation part using the internal allocator. */
 VkDeviceSize LinearMemoryPool::_allocate(const VkMemoryRequirements& requirements) {
     // Try to reserve memory in the freelist
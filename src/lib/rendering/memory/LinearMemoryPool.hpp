@@ -4,7 +4,7 @@
  * Created:
  *   30/09/2021, 15:44:30
  * Last edited:
- *   30/09/2021, 15:44:30
+ *   19/10/2026, 03:27:35
  * Auto updated?
  *   Yes
  *
@@ -16,8 +16,10 @@
 #ifndef RENDERING_LINEAR_MEMORY_POOL_HPP
 #define RENDERING_LINEAR_MEMORY_POOL_HPP
 
+#include <utility>
 #include <vulkan/vulkan.h>
 
+#include "tools/Array.hpp"
 #include "../gpu/GPU.hpp"
 
 #include "allocators/LinearAllocator.hpp"
@@ -53,6 +55,9 @@ namespace Makma3D::Rendering {
         /* Returns the total number of bytes in the MemoryPool. */
         inline VkDeviceSize capacity() const { return this->allocator.capacity(); }
 
+        /* Returns the exact number of bytes a LinearMemoryPool needs to hold Buffers of the given sizes & usage flags, allocated in the given order. Uses each buffer's real memory requirements, so includes its size & alignment padding on the given GPU. */
+        static VkDeviceSize required_size(const Rendering::GPU& gpu, const Tools::Array<std::pair<VkDeviceSize, VkBufferUsageFlags>>& buffers);
+
         /* Copy assignment operator for the LinearMemoryPool class, which is deleted. */
         LinearMemoryPool& operator=(const LinearMemoryPool& other) = delete;
         /* Move assignment operator for the LinearMemoryPool class. */
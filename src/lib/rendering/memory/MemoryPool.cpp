@@ -4,7 +4,7 @@
  * Created:
  *   16/08/2021, 15:11:40
  * Last edited:
- *   9/20/2021, 8:18:11 PM
+ *   19/10/2026, 03:27:35
  * Auto updated?
  *   Yes
  *
@@ -41,7 +41,7 @@ static void populate_buffer_info(VkBufferCreateInfo& buffer_info, VkDeviceSize n
 }
 
 /* Populates a given VkImageCreateInfo struct. */
-static void populate_image_info(VkImageCreateInfo& image_info, const VkExtent3D& image_size, VkFormat image_format, VkImageLayout image_layout, VkImageUsageFlags usage_flags, VkSharingMode sharing_mode, VkImageCreateFlags create_flags) {
+static void populate_image_info(VkImageCreateInfo& image_info, const VkExtent3D& image_size, VkFormat image_format, VkImageLayout image_layout, VkImageUsageFlags usage_flags, VkSharingMode sharing_mode, VkImageCreateFlags create_flags, uint32_t mip_levels = 1, uint32_t layers = 1) {
     // Only set to default
     image_info = {};
     image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -55,9 +55,9 @@ static void populate_image_info(VkImageCreateInfo& image_info, const VkExtent3D&
     image_info.flags = create_flags;
     
     // Set the image-specific parameters
-    image_info.arrayLayers = 1;
+    image_info.arrayLayers = layers;
     image_info.imageType = VK_IMAGE_TYPE_2D;
-    image_info.mipLevels = 1;
+    image_info.mipLevels = mip_levels;
     image_info.samples = VK_SAMPLE_COUNT_1_BIT;
     image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
 
@@ -307,12 +307,12 @@ Buffer* MemoryPool::allocate(const Buffer* other) {
 
 
 
-/* Tries to allocate a new Image of the given size (in pixels), the given format, the given layout and with the given usage flags. Optionally, one can set the sharing mode and any create flags. */
-Image* MemoryPool::allocate(const VkExtent2D& image_extent, VkFormat image_format, VkImageLayout image_layout, VkImageUsageFlags usage_flags, VkSharingMode sharing_mode, VkImageCreateFlags create_flags) {
+/* Tries to allocate a new Image of the given size (in pixels), the given format, the given layout and with the given usage flags. Optionally, one can set the sharing mode, any create flags, the number of mip levels and the number of array layers. */
+Image* MemoryPool::allocate(const VkExtent2D& image_extent, VkFormat image_format, VkImageLayout image_layout, VkImageUsageFlags usage_flags, VkSharingMode sharing_mode, VkImageCreateFlags create_flags, uint32_t mip_levels, uint32_t layers) {
     // First, create the buffer object itself
     VkExtent3D vk_extent3D = { image_extent.width, image_extent.height, 1 };
     VkImageCreateInfo image_info;
-    populate_image_info(image_info, vk_extent3D, image_format, image_layout, usage_flags, sharing_mode, create_flags);
+    populate_image_info(image_info, vk_extent3D, image_format, image_layout, usage_flags, sharing_mode, create_flags, mip_levels, layers);
 
     VkResult vk_result;
     VkImage image;
@@ -329,7 +329,7 @@ Image* MemoryPool::allocate(const VkExtent2D& image_extent, VkFormat image_forma
     vkBindImageMemory(this->gpu, image, this->vk_memory, offset);
 
     // Create the new Buffer object and insert it in our own list
-    Image* to_return = new Image(*this, image, offset, image_extent, image_format, image_layout, image_requirements, usage_flags, sharing_mode, create_flags);
+    Image* to_return = new Image(*this, image, offset, image_extent, image_format, image_layout, image_requirements, mip_levels, layers, usage_flags, sharing_mode, create_flags);
     this->objects.insert((MemoryObject*) to_return);
 
     // Done
@@ -341,7 +341,7 @@ Image* MemoryPool::allocate(const Image* other) {
     // First, create the buffer object itself
     VkExtent3D vk_extent3D = { other->vk_extent.width, other->vk_extent.height, 1 };
     VkImageCreateInfo image_info;
-    populate_image_info(image_info, vk_extent3D, other->vk_format, other->vk_layout, other->init_data.image_usage, other->init_data.sharing_mode, other->init_data.create_flags);
+    populate_image_info(image_info, vk_extent3D, other->vk_format, other->vk_layout, other->init_data.image_usage, other->init_data.sharing_mode, other->init_data.create_flags, other->vk_mip_levels, other->vk_layers);
 
     VkResult vk_result;
     VkImage image;
@@ -358,7 +358,7 @@ Image* MemoryPool::allocate(const Image* other) {
     vkBindImageMemory(this->gpu, image, this->vk_memory, offset);
 
     // Create the new Buffer object and insert it in our own list
-    Image* to_return = new Image(*this, image, offset, other->vk_extent, other->vk_format, other->vk_layout, image_requirements, other->init_data.image_usage, other->init_data.sharing_mode, other->init_data.create_flags);
+    Image* to_return = new Image(*this, image, offset, other->vk_extent, other->vk_format, other->vk_layout, image_requirements, other->vk_mip_levels, other->vk_layers, other->init_data.image_usage, other->init_data.sharing_mode, other->init_data.create_flags);
     this->objects.insert((MemoryObject*) to_return);
 
     // Done!
@@ -367,6 +367,85 @@ Image* MemoryPool::allocate(const Image* other) {
 
 
 
+/* Creates a new Image with the given format & usage flags that shares the memory of the given Image, which has to be large enough. The new Image has the same extent as the given one, and has to be freed before it is. Only one of the two should be used at a time. */
+Image* MemoryPool::alias(const Image* image, VkFormat image_format, VkImageUsageFlags usage_flags) {
+    #ifndef NDEBUG
+    if (this->objects.find(const_cast<Image*>(image)) == this->objects.end()) {
+        logger.fatalc(MemoryPool::channel, "Tried to alias Image that was not allocated with this pool.");
+    }
+    #endif
+
+    // First, create the image object itself
+    VkExtent3D vk_extent3D = { image->vk_extent.width, image->vk_extent.height, 1 };
+    VkImageCreateInfo image_info;
+    populate_image_info(image_info, vk_extent3D, image_format, VK_IMAGE_LAYOUT_UNDEFINED, usage_flags, image->init_data.sharing_mode, image->init_data.create_flags, image->vk_mip_levels, image->vk_layers);
+
+    VkResult vk_result;
+    VkImage vk_image;
+    if ((vk_result = vkCreateImage(this->gpu, &image_info, nullptr, &vk_image)) != VK_SUCCESS) {
+        logger.fatalc(MemoryPool::channel, "Could not create image alias: " + vk_error_map[vk_result]);
+    }
+
+    // Make sure it fits in the memory of the other image
+    VkMemoryRequirements image_requirements;
+    vkGetImageMemoryRequirements(this->gpu, vk_image, &image_requirements);
+    if (image_requirements.size > image->vk_requirements.size || image->object_offset % image_requirements.alignment != 0 || (image_requirements.memoryTypeBits & image->vk_requirements.memoryTypeBits) == 0) {
+        logger.fatalc(MemoryPool::channel, "Cannot alias image of ", Tools::bytes_to_string(image->vk_requirements.size), " with image of ", Tools::bytes_to_string(image_requirements.size), ", since its memory is too small or incompatible.");
+    }
+
+    // Bind it to the same memory
+    vkBindImageMemory(this->gpu, vk_image, this->vk_memory, image->object_offset);
+
+    // Create the new Image object, marking it as not owning its memory
+    Image* to_return = new Image(*this, vk_image, image->object_offset, image->vk_extent, image_format, VK_IMAGE_LAYOUT_UNDEFINED, image_requirements, image->vk_mip_levels, image->vk_layers, usage_flags, image->init_data.sharing_mode, image->init_data.create_flags);
+    to_return->aliased = true;
+    this->objects.insert((MemoryObject*) to_return);
+
+    // Done
+    return to_return;
+}
+
+/* Returns the memory requirements a Buffer of the given size (in bytes) and usage flags would have on the given GPU, without allocating it. */
+VkMemoryRequirements MemoryPool::buffer_requirements(const Rendering::GPU& gpu, VkDeviceSize buffer_size, VkBufferUsageFlags buffer_usage) {
+    // Create a temporary buffer with those properties
+    VkBufferCreateInfo buffer_info;
+    populate_buffer_info(buffer_info, buffer_size, buffer_usage, VK_SHARING_MODE_EXCLUSIVE, 0);
+
+    VkResult vk_result;
+    VkBuffer vk_buffer;
+    if ((vk_result = vkCreateBuffer(gpu, &buffer_info, nullptr, &vk_buffer)) != VK_SUCCESS) {
+        logger.fatalc(MemoryPool::channel, "Could not create temporary buffer: ", vk_error_map[vk_result]);
+    }
+
+    // Ask what it needs, then throw it away again
+    VkMemoryRequirements buffer_requirements;
+    vkGetBufferMemoryRequirements(gpu, vk_buffer, &buffer_requirements);
+    vkDestroyBuffer(gpu, vk_buffer, nullptr);
+    return buffer_requirements;
+}
+
+/* Returns the memory requirements an Image of the given size, format, usage flags and number of array layers would have, without allocating it. */
+VkMemoryRequirements MemoryPool::requirements(const VkExtent2D& image_extent, VkFormat image_format, VkImageUsageFlags usage_flags, uint32_t layers) const {
+    // Create a temporary image with those properties
+    VkExtent3D vk_extent3D = { image_extent.width, image_extent.height, 1 };
+    VkImageCreateInfo image_info;
+    populate_image_info(image_info, vk_extent3D, image_format, VK_IMAGE_LAYOUT_UNDEFINED, usage_flags, VK_SHARING_MODE_EXCLUSIVE, 0, 1, layers);
+
+    VkResult vk_result;
+    VkImage vk_image;
+    if ((vk_result = vkCreateImage(this->gpu, &image_info, nullptr, &vk_image)) != VK_SUCCESS) {
+        logger.fatalc(MemoryPool::channel, "Could not create temporary image: " + vk_error_map[vk_result]);
+    }
+
+    // Ask what it needs, then throw it away again
+    VkMemoryRequirements image_requirements;
+    vkGetImageMemoryRequirements(this->gpu, vk_image, &image_requirements);
+    vkDestroyImage(this->gpu, vk_image, nullptr);
+    return image_requirements;
+}
+
+
+
 /* Deallocates the given MemoryObject. */
 void MemoryPool::free(const MemoryObject* object) {
     // Try to remove the pointer from the list
@@ -381,8 +460,10 @@ void MemoryPool::free(const MemoryObject* object) {
         }
     }
 
-    // Free the memory in the freelist
-    this->_free((*iter)->object_offset);
+    // Free the memory in the freelist, unless it's an image that borrowed the memory of another
+    if ((*iter)->type != MemoryObjectType::image || !((Image*) (*iter))->aliased) {
+        this->_free((*iter)->object_offset);
+    }
 
     // Destroy either the buffer or the image
     if ((*iter)->type == MemoryObjectType::buffer) {
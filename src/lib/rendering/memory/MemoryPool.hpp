@@ -4,7 +4,7 @@
  * Created:
  *   16/08/2021, 14:58:51
  * Last edited:
- *   16/08/2021, 14:58:51
+ *   19/10/2026, 03:27:35
  * Auto updated?
  *   Yes
  *
@@ -73,10 +73,16 @@ namespace Makma3D::Rendering {
 
         /* Tries to allocate a new Image of the given size (in pixels), the given format, the given layout and with the given usage flags. Optionally, one can set the sharing mode and any create flags. */
         inline Image* allocate(uint32_t width, uint32_t height, VkFormat image_format, VkImageLayout image_layout, VkImageUsageFlags usage_flags, VkSharingMode sharing_mode = VK_SHARING_MODE_EXCLUSIVE, VkImageCreateFlags create_flags = 0)  { return this->allocate(VkExtent2D({ width, height }), image_format, image_layout, usage_flags, sharing_mode, create_flags); }
-        /* Tries to allocate a new Image of the given size (in pixels), the given format, the given layout and with the given usage flags. Optionally, one can set the sharing mode and any create flags. */
-        Image* allocate(const VkExtent2D& image_extent, VkFormat image_format, VkImageLayout image_layout, VkImageUsageFlags usage_flags, VkSharingMode sharing_mode = VK_SHARING_MODE_EXCLUSIVE, VkImageCreateFlags create_flags = 0);
+        /* Tries to allocate a new Image of the given size (in pixels), the given format, the given layout and with the given usage flags. Optionally, one can set the sharing mode, any create flags, the number of mip levels and the number of array layers. */
+        Image* allocate(const VkExtent2D& image_extent, VkFormat image_format, VkImageLayout image_layout, VkImageUsageFlags usage_flags, VkSharingMode sharing_mode = VK_SHARING_MODE_EXCLUSIVE, VkImageCreateFlags create_flags = 0, uint32_t mip_levels = 1, uint32_t layers = 1);
         /* Tries to allocate a new Image that is a copy of the given Image. */
         Image* allocate(const Image* other);
+        /* Creates a new Image with the given format & usage flags that shares the memory of the given Image, which has to be large enough. The new Image has the same extent and number of layers as the given one, and has to be freed before it is. Only one of the two should be used at a time. */
+        Image* alias(const Image* image, VkFormat image_format, VkImageUsageFlags usage_flags);
+        /* Returns the memory requirements a Buffer of the given size (in bytes) and usage flags would have on the given GPU, without allocating it. Doesn't need a pool, so that pools can be sized to fit their buffers. */
+        static VkMemoryRequirements buffer_requirements(const Rendering::GPU& gpu, VkDeviceSize buffer_size, VkBufferUsageFlags buffer_usage);
+        /* Returns the memory requirements an Image of the given size, format, usage flags and number of array layers would have, without allocating it. */
+        VkMemoryRequirements requirements(const VkExtent2D& image_extent, VkFormat image_format, VkImageUsageFlags usage_flags, uint32_t layers = 1) const;
 
         /* Deallocates the given MemoryObject. */
         void free(const MemoryObject* object);
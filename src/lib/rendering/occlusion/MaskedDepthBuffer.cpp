@@ -0,0 +1,249 @@
+/* MASKED DEPTH BUFFER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MaskedDepthBuffer class, which is a low-resolution depth
+ *   buffer on the CPU that occluders are rasterized to. Instead of a depth
+ *   per pixel, it stores two depths per tile of 32x8 pixels and a
+ *   coverage mask that tells which of the two applies to each pixel, so
+ *   that a tile is rasterized in a handful of SIMD instructions. The
+ *   depths it stores are never nearer than the real ones, so it can only
+ *   ever report too little occlusion, never too much.
+**/
+
+#include <algorithm>
+#include <cmath>
+
+#include "MaskedDepthBuffer.hpp"
+
+// Use SSE2 to compute the coverage four pixels at a time wherever it's available, which is on any x86-64 CPU
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MASKED_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Prepares the given triangle for rasterization into a buffer of the given size. Returns false if it doesn't cover any area within the buffer, in which case it can be skipped. */
+bool Rendering::setup_triangle(const Rendering::ScreenTriangle& triangle, uint32_t width, uint32_t height, Rendering::TriangleSetup& setup) {
+    // Make sure the corners are in counter-clockwise order (with y pointing down), so that the inside is where all edge functions are positive. Occluders are rasterized regardless of which side they face
+    glm::vec3 v0 = triangle.v[0], v1 = triangle.v[1], v2 = triangle.v[2];
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (!(area != 0.0f)) { return false; }
+    if (area < 0.0f) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    // Compute the bounding box, and stop if it doesn't overlap with the buffer
+    float min_x = std::min({ v0.x, v1.x, v2.x }), max_x = std::max({ v0.x, v1.x, v2.x });
+    float min_y = std::min({ v0.y, v1.y, v2.y }), max_y = std::max({ v0.y, v1.y, v2.y });
+    setup.min_x = static_cast<uint32_t>(std::floor(std::min(std::max(min_x, 0.0f), (float) width)));
+    setup.max_x = static_cast<uint32_t>(std::ceil(std::min(std::max(max_x, 0.0f), (float) width)));
+    setup.min_y = static_cast<uint32_t>(std::floor(std::min(std::max(min_y, 0.0f), (float) height)));
+    setup.max_y = static_cast<uint32_t>(std::ceil(std::min(std::max(max_y, 0.0f), (float) height)));
+    if (setup.min_x >= setup.max_x || setup.min_y >= setup.max_y) { return false; }
+
+    // Compute the edge functions, each of which is positive on the side of the edge where the opposite corner lies
+    const glm::vec3* corners[3] = { &v0, &v1, &v2 };
+    for (uint32_t i = 0; i < 3; i++) {
+        const glm::vec3& p = *corners[i];
+        const glm::vec3& q = *corners[(i + 1) % 3];
+        setup.a[i] = p.y - q.y;
+        setup.b[i] = q.x - p.x;
+        setup.c[i] = -(setup.a[i] * p.x + setup.b[i] * p.y);
+    }
+
+    // Compute the plane through the depths of the corners
+    setup.z_a = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+    setup.z_b = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+    setup.z_c = v0.z - setup.z_a * v0.x - setup.z_b * v0.y;
+    setup.z_max = std::max({ v0.z, v1.z, v2.z });
+
+    // Done
+    return true;
+}
+
+
+
+
+
+/***** MASKEDDEPTHBUFFER CLASS *****/
+/* Constructor for the MaskedDepthBuffer class, which takes its size in pixels. Both are rounded up to a whole number of tiles. */
+MaskedDepthBuffer::MaskedDepthBuffer(uint32_t width, uint32_t height) :
+    n_tiles_x((width + MaskedDepthBuffer::tile_width - 1) / MaskedDepthBuffer::tile_width),
+    n_tiles_y((height + MaskedDepthBuffer::tile_height - 1) / MaskedDepthBuffer::tile_height)
+{
+    this->_width = this->n_tiles_x * MaskedDepthBuffer::tile_width;
+    this->_height = this->n_tiles_y * MaskedDepthBuffer::tile_height;
+
+    // Allocate the tiles, and start out empty
+    this->tiles.resize(this->n_tiles_x * this->n_tiles_y);
+    this->clear();
+}
+
+
+
+/* Resets the buffer so that all pixels lie at the far plane. */
+void MaskedDepthBuffer::clear() {
+    for (uint32_t i = 0; i < this->tiles.size(); i++) {
+        Tile& tile = this->tiles[i];
+        for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) {
+            tile.mask[r] = 0;
+        }
+        tile.z_reference = 1.0f;
+        tile.z_working = 0.0f;
+    }
+}
+
+/* Rasterizes the given triangles in the given range of tile rows (last row exclusive). Since different rows never touch the same tiles, ranges can be rasterized in parallel. */
+void MaskedDepthBuffer::rasterize(const Rendering::ScreenTriangle* triangles, uint32_t n_triangles, uint32_t first_row, uint32_t last_row) {
+    for (uint32_t i = 0; i < n_triangles; i++) {
+        // Prepare the triangle, skipping it if it doesn't cover anything
+        TriangleSetup setup;
+        if (!setup_triangle(triangles[i], this->_width, this->_height, setup)) { continue; }
+
+        // Find the tiles it overlaps within our rows
+        uint32_t min_tx = setup.min_x / MaskedDepthBuffer::tile_width;
+        uint32_t max_tx = (setup.max_x + MaskedDepthBuffer::tile_width - 1) / MaskedDepthBuffer::tile_width;
+        uint32_t min_ty = std::max(first_row, setup.min_y / MaskedDepthBuffer::tile_height);
+        uint32_t max_ty = std::min(last_row, (setup.max_y + MaskedDepthBuffer::tile_height - 1) / MaskedDepthBuffer::tile_height);
+        for (uint32_t ty = min_ty; ty < max_ty; ty++) {
+            for (uint32_t tx = min_tx; tx < max_tx; tx++) {
+                Tile& tile = this->tiles[ty * this->n_tiles_x + tx];
+
+                // Find the farthest depth of the triangle in this tile. Since the depth is a plane, it's farthest at one of the corners of the pixels it may cover, but never farther than its own corners
+                float x0 = (float) std::max(tx * MaskedDepthBuffer::tile_width, setup.min_x) + 0.5f;
+                float x1 = (float) std::min((tx + 1) * MaskedDepthBuffer::tile_width, setup.max_x) - 0.5f;
+                float y0 = (float) std::max(ty * MaskedDepthBuffer::tile_height, setup.min_y) + 0.5f;
+                float y1 = (float) std::min((ty + 1) * MaskedDepthBuffer::tile_height, setup.max_y) - 0.5f;
+                float z_tri = std::min(setup.z_max, std::max({ setup.depth(x0, y0), setup.depth(x1, y0), setup.depth(x0, y1), setup.depth(x1, y1) }));
+                // If that's behind everything in the tile already, it can't occlude anything new
+                if (z_tri >= tile.z_reference) { continue; }
+
+                // Compute which pixels it covers
+                uint32_t mask[MaskedDepthBuffer::tile_height];
+                MaskedDepthBuffer::coverage(setup, tx, ty, mask);
+                uint32_t any = 0;
+                for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) { any |= mask[r]; }
+                if (any == 0) { continue; }
+
+                // If the triangle is much nearer than the working layer, that layer is discarded in favour of a new one. This only loses occlusion, since the reference depth still bounds those pixels
+                if (tile.z_working - z_tri > tile.z_reference - tile.z_working) {
+                    for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) { tile.mask[r] = 0; }
+                    tile.z_working = 0.0f;
+                }
+                // Merge the triangle into the working layer
+                uint32_t full = ~0U;
+                tile.z_working = std::max(tile.z_working, z_tri);
+                for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) {
+                    tile.mask[r] |= mask[r];
+                    full &= tile.mask[r];
+                }
+                // If that covers the whole tile, it becomes the new reference layer
+                if (full == ~0U) {
+                    tile.z_reference = tile.z_working;
+                    tile.z_working = 0.0f;
+                    for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) { tile.mask[r] = 0; }
+                }
+            }
+        }
+    }
+}
+
+/* Returns whether anything at the given depth could be visible in the given rectangle of pixels (maxima inclusive), i.e., whether any of its pixels lies at or behind it. */
+bool MaskedDepthBuffer::test_rect(uint32_t min_x, uint32_t min_y, uint32_t max_x, uint32_t max_y, float z_min) const {
+    max_x = std::min(max_x, this->_width - 1);
+    max_y = std::min(max_y, this->_height - 1);
+    for (uint32_t ty = min_y / MaskedDepthBuffer::tile_height; ty <= max_y / MaskedDepthBuffer::tile_height; ty++) {
+        for (uint32_t tx = min_x / MaskedDepthBuffer::tile_width; tx <= max_x / MaskedDepthBuffer::tile_width; tx++) {
+            const Tile& tile = this->tiles[ty * this->n_tiles_x + tx];
+
+            // If it's behind the reference depth, it's hidden in this tile; if it's at or before the working depth, it's visible in all of it
+            if (z_min > tile.z_reference) { continue; }
+            if (z_min <= tile.z_working) { return true; }
+
+            // Otherwise, it's only visible where the mask isn't set, so check the part of the rectangle in this tile against that
+            uint32_t first_col = std::max(min_x, tx * MaskedDepthBuffer::tile_width) - tx * MaskedDepthBuffer::tile_width;
+            uint32_t last_col = std::min(max_x, (tx + 1) * MaskedDepthBuffer::tile_width - 1) - tx * MaskedDepthBuffer::tile_width;
+            uint32_t cols = (last_col - first_col == MaskedDepthBuffer::tile_width - 1) ? ~0U : ((1U << (last_col - first_col + 1)) - 1) << first_col;
+            uint32_t first_row = std::max(min_y, ty * MaskedDepthBuffer::tile_height) - ty * MaskedDepthBuffer::tile_height;
+            uint32_t last_row = std::min(max_y, (ty + 1) * MaskedDepthBuffer::tile_height - 1) - ty * MaskedDepthBuffer::tile_height;
+            for (uint32_t r = first_row; r <= last_row; r++) {
+                if ((~tile.mask[r] & cols) != 0) { return true; }
+            }
+        }
+    }
+
+    // It's hidden everywhere
+    return false;
+}
+
+
+
+/* Returns the depth that the given pixel is known to lie at or before. */
+float MaskedDepthBuffer::depth_bound(uint32_t x, uint32_t y) const {
+    const Tile& tile = this->tiles[(y / MaskedDepthBuffer::tile_height) * this->n_tiles_x + x / MaskedDepthBuffer::tile_width];
+    bool masked = (tile.mask[y % MaskedDepthBuffer::tile_height] >> (x % MaskedDepthBuffer::tile_width)) & 0x1;
+    return masked ? tile.z_working : tile.z_reference;
+}
+
+/* Computes which pixels of the given tile are covered by the given triangle, as a mask per tile row. */
+void MaskedDepthBuffer::coverage(const Rendering::TriangleSetup& setup, uint32_t tile_x, uint32_t tile_y, uint32_t* mask) {
+    float x0 = (float) (tile_x * MaskedDepthBuffer::tile_width) + 0.5f;
+    float y0 = (float) (tile_y * MaskedDepthBuffer::tile_height) + 0.5f;
+
+    #ifdef MASKED_SSE2
+    // Prepare the x-coordinates of the pixel centres in each row, four at a time
+    constexpr uint32_t n_groups = MaskedDepthBuffer::tile_width / 4;
+    __m128 xs[n_groups];
+    for (uint32_t g = 0; g < n_groups; g++) {
+        xs[g] = _mm_add_ps(_mm_set1_ps(x0 + (float) (4 * g)), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+    }
+    __m128 a0 = _mm_set1_ps(setup.a[0]), a1 = _mm_set1_ps(setup.a[1]), a2 = _mm_set1_ps(setup.a[2]);
+    __m128 zero = _mm_setzero_ps();
+
+    // Evaluate the edge functions for each row, where the part that only depends on y is shared by the whole row
+    for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) {
+        float y = y0 + (float) r;
+        __m128 row0 = _mm_set1_ps(setup.b[0] * y + setup.c[0]);
+        __m128 row1 = _mm_set1_ps(setup.b[1] * y + setup.c[1]);
+        __m128 row2 = _mm_set1_ps(setup.b[2] * y + setup.c[2]);
+
+        uint32_t row_mask = 0;
+        for (uint32_t g = 0; g < n_groups; g++) {
+            __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, xs[g]), row0), zero);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, xs[g]), row1), zero));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, xs[g]), row2), zero));
+            row_mask |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << (4 * g);
+        }
+        mask[r] = row_mask;
+    }
+
+    #else
+    // Simply evaluate the edge functions one pixel at a time
+    for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) {
+        float y = y0 + (float) r;
+        uint32_t row_mask = 0;
+        for (uint32_t c = 0; c < MaskedDepthBuffer::tile_width; c++) {
+            float x = x0 + (float) c;
+            if (setup.edge(0, x, y) >= 0.0f && setup.edge(1, x, y) >= 0.0f && setup.edge(2, x, y) >= 0.0f) {
+                row_mask |= 0x1U << c;
+            }
+        }
+        mask[r] = row_mask;
+    }
+
+    #endif
+}
@@ -0,0 +1,121 @@
+/* MASKED DEPTH BUFFER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MaskedDepthBuffer class, which is a low-resolution depth
+ *   buffer on the CPU that occluders are rasterized to. Instead of a depth
+ *   per pixel, it stores two depths per tile of 32x8 pixels and a
+ *   coverage mask that tells which of the two applies to each pixel, so
+ *   that a tile is rasterized in a handful of SIMD instructions. The
+ *   depths it stores are never nearer than the real ones, so it can only
+ *   ever report too little occlusion, never too much.
+**/
+
+#ifndef RENDERING_MASKED_DEPTH_BUFFER_HPP
+#define RENDERING_MASKED_DEPTH_BUFFER_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+#include "tools/Array.hpp"
+
+namespace Makma3D::Rendering {
+    /* A triangle that is projected to the screen, with its x & y coordinates in pixels and its z coordinate the depth (zero to one, larger is farther). */
+    struct ScreenTriangle {
+        /* The three corners of the triangle. */
+        glm::vec3 v[3];
+    };
+
+    /* The edge functions, depth plane and bounds of a ScreenTriangle, which both the MaskedDepthBuffer and the ReferenceDepthBuffer rasterize from so they agree on which pixels are covered. */
+    struct TriangleSetup {
+        /* The coefficients of the three edge functions, where a pixel centre (x, y) is covered if a * x + (b * y + c) >= 0 for all of them. */
+        float a[3], b[3], c[3];
+        /* The coefficients of the depth plane, where the depth at (x, y) is z_a * x + (z_b * y + z_c). */
+        float z_a, z_b, z_c;
+        /* The farthest depth of the triangle's corners. */
+        float z_max;
+        /* The bounding box of the triangle in pixels, clamped to the buffer. The maxima are exclusive. */
+        uint32_t min_x, min_y, max_x, max_y;
+
+        /* Evaluates the given edge function at the given pixel centre. */
+        inline float edge(uint32_t i, float x, float y) const { return this->a[i] * x + (this->b[i] * y + this->c[i]); }
+        /* Evaluates the depth plane at the given point. */
+        inline float depth(float x, float y) const { return this->z_a * x + (this->z_b * y + this->z_c); }
+    };
+
+    /* Prepares the given triangle for rasterization into a buffer of the given size. Returns false if it doesn't cover any area within the buffer, in which case it can be skipped. */
+    bool setup_triangle(const Rendering::ScreenTriangle& triangle, uint32_t width, uint32_t height, Rendering::TriangleSetup& setup);
+
+
+
+    /* The MaskedDepthBuffer class, which rasterizes occluders to a tiled, conservative depth buffer and tests bounding rectangles against it. */
+    class MaskedDepthBuffer {
+    public:
+        /* Channel name for the MaskedDepthBuffer class. */
+        static constexpr const char* channel = "MaskedDepthBuffer";
+        /* The width of a single tile, in pixels. Each row of a tile is a single 32-bit mask. */
+        static constexpr const uint32_t tile_width = 32;
+        /* The height of a single tile, in pixels. */
+        static constexpr const uint32_t tile_height = 8;
+
+        /* A single tile in the buffer. */
+        struct Tile {
+            /* The coverage mask of the tile, with a bit per pixel and a row per element. Pixels that are set lie at or before z_working, the others at or before z_reference. */
+            uint32_t mask[MaskedDepthBuffer::tile_height];
+            /* The reference depth of the tile, which bounds the depth of all of its pixels. */
+            float z_reference;
+            /* The working depth of the tile, which bounds the depth of the pixels in the mask. */
+            float z_working;
+        };
+
+    private:
+        /* The width of the buffer, in pixels. Always a multiple of the tile width. */
+        uint32_t _width;
+        /* The height of the buffer, in pixels. Always a multiple of the tile height. */
+        uint32_t _height;
+        /* The number of tiles in each row. */
+        uint32_t n_tiles_x;
+        /* The number of tile rows. */
+        uint32_t n_tiles_y;
+        /* The tiles in the buffer, row by row. */
+        Tools::Array<Tile> tiles;
+
+    public:
+        /* Constructor for the MaskedDepthBuffer class, which takes its size in pixels. Both are rounded up to a whole number of tiles. */
+        MaskedDepthBuffer(uint32_t width, uint32_t height);
+
+        /* Resets the buffer so that all pixels lie at the far plane. */
+        void clear();
+        /* Rasterizes the given triangles in the given range of tile rows (last row exclusive). Since different rows never touch the same tiles, ranges can be rasterized in parallel. */
+        void rasterize(const Rendering::ScreenTriangle* triangles, uint32_t n_triangles, uint32_t first_row, uint32_t last_row);
+        /* Returns whether anything at the given depth could be visible in the given rectangle of pixels (maxima inclusive), i.e., whether any of its pixels lies at or behind it. */
+        bool test_rect(uint32_t min_x, uint32_t min_y, uint32_t max_x, uint32_t max_y, float z_min) const;
+
+        /* Returns the depth that the given pixel is known to lie at or before. */
+        float depth_bound(uint32_t x, uint32_t y) const;
+        /* Computes which pixels of the given tile are covered by the given triangle, as a mask per tile row. */
+        static void coverage(const Rendering::TriangleSetup& setup, uint32_t tile_x, uint32_t tile_y, uint32_t* mask);
+
+        /* Returns the tile at the given tile coordinates. */
+        inline const Tile& tile(uint32_t tile_x, uint32_t tile_y) const { return this->tiles[tile_y * this->n_tiles_x + tile_x]; }
+        /* Returns the width of the buffer, in pixels. */
+        inline uint32_t width() const { return this->_width; }
+        /* Returns the height of the buffer, in pixels. */
+        inline uint32_t height() const { return this->_height; }
+        /* Returns the number of tiles in each row. */
+        inline uint32_t tiles_x() const { return this->n_tiles_x; }
+        /* Returns the number of tile rows. */
+        inline uint32_t tiles_y() const { return this->n_tiles_y; }
+
+    };
+
+}
+
+#endif
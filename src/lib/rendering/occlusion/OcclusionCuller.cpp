@@ -0,0 +1,143 @@
+/* OCCLUSION CULLER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the OcclusionCuller class, which culls entities on the CPU
+ *   before their draws are even sorted. A few designated occluders are
+ *   projected to the screen and rasterized to a MaskedDepthBuffer, after
+ *   which the bounding boxes of the entities are tested against it. Lives
+ *   without any GPU, so it can be tested on its own.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "OcclusionCuller.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Projects the given clip-space point to the screen of the given size. */
+static glm::vec3 project(const glm::vec4& clip, uint32_t width, uint32_t height) {
+    return glm::vec3((clip.x / clip.w * 0.5f + 0.5f) * (float) width, (clip.y / clip.w * 0.5f + 0.5f) * (float) height, clip.z / clip.w);
+}
+
+
+
+
+
+/***** OCCLUSIONCULLER CLASS *****/
+/* Constructor for the OcclusionCuller class, which takes the size of its depth buffer in pixels. */
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height) :
+    buffer(width, height),
+    view_proj(1.0f)
+{}
+
+
+
+/* Starts culling for a new frame as seen with the given view-projection matrix, which clears the occluders of the previous one. */
+void OcclusionCuller::begin(const glm::mat4& view_proj) {
+    this->view_proj = view_proj;
+    this->triangles.clear();
+    this->buffer.clear();
+}
+
+/* Adds an occluder with the given model-space vertices and triangle list, placed in the world with the given transformation matrix. Its triangles are clipped to the near plane and projected to the screen, but not yet rasterized. */
+void OcclusionCuller::add_occluder(const glm::mat4& transform, const glm::vec3* vertices, const uint32_t* indices, uint32_t n_indices) {
+    // Move the vertices to clip space first, since they're shared between triangles
+    glm::mat4 model_view_proj = this->view_proj * transform;
+    uint32_t n_vertices = 0;
+    for (uint32_t i = 0; i < n_indices; i++) { n_vertices = std::max(n_vertices, indices[i] + 1); }
+    this->clip_vertices.clear();
+    this->clip_vertices.reserve_opt(n_vertices);
+    for (uint32_t i = 0; i < n_vertices; i++) {
+        this->clip_vertices.push_back(model_view_proj * glm::vec4(vertices[i], 1.0f));
+    }
+
+    // Then clip each triangle against the near plane, which in zero-to-one depth is simply z >= 0
+    this->triangles.reserve_opt(this->triangles.size() + n_indices / 3);
+    for (uint32_t i = 0; i + 2 < n_indices; i += 3) {
+        const glm::vec4 corners[3] = { this->clip_vertices[indices[i]], this->clip_vertices[indices[i + 1]], this->clip_vertices[indices[i + 2]] };
+        glm::vec4 clipped[4];
+        uint32_t n_clipped = 0;
+        for (uint32_t j = 0; j < 3; j++) {
+            const glm::vec4& cur = corners[j];
+            const glm::vec4& next = corners[(j + 1) % 3];
+            if (cur.z >= 0.0f) { clipped[n_clipped++] = cur; }
+            if ((cur.z >= 0.0f) != (next.z >= 0.0f)) { clipped[n_clipped++] = cur + (cur.z / (cur.z - next.z)) * (next - cur); }
+        }
+        // Anything left should lie in front of the camera, but skip degenerate projections to be sure
+        if (n_clipped < 3) { continue; }
+        bool in_front = true;
+        for (uint32_t j = 0; j < n_clipped; j++) { in_front = in_front && clipped[j].w > 0.0f; }
+        if (!in_front) { continue; }
+
+        // Project what's left to the screen as a fan of one or two triangles
+        glm::vec3 screen[4];
+        for (uint32_t j = 0; j < n_clipped; j++) { screen[j] = project(clipped[j], this->buffer.width(), this->buffer.height()); }
+        for (uint32_t j = 2; j < n_clipped; j++) {
+            this->triangles.push_back({ { screen[0], screen[j - 1], screen[j] } });
+        }
+    }
+}
+
+/* Rasterizes all added occluders to the depth buffer. If a pool is given, bands of tile rows are rasterized in parallel on it. */
+void OcclusionCuller::rasterize(Tools::ThreadPool* pool) {
+    // Every band goes through all triangles in the same order, so the result doesn't depend on the number of bands
+    uint32_t n_rows = this->buffer.tiles_y();
+    uint32_t n_bands = pool != nullptr ? std::min(pool->size(), n_rows) : 1;
+    if (n_bands <= 1) {
+        this->buffer.rasterize(this->triangles.rdata(), this->triangles.size(), 0, n_rows);
+        return;
+    }
+    pool->run(n_bands, [this, n_rows, n_bands](uint32_t band) {
+        this->buffer.rasterize(this->triangles.rdata(), this->triangles.size(), band * n_rows / n_bands, (band + 1) * n_rows / n_bands);
+    });
+}
+
+
+
+/* Computes the rectangle of pixels (maxima inclusive) that the given world-space bounding box covers on the screen, and the nearest depth it reaches. Returns false if it can't be tested, because it crosses the near plane or lies off-screen. */
+bool OcclusionCuller::screen_bounds(const glm::vec3& min, const glm::vec3& max, uint32_t& min_x, uint32_t& min_y, uint32_t& max_x, uint32_t& max_y, float& z_min) const {
+    // Project the corners of the box to find the rectangle it covers on the screen, and how near it gets
+    glm::vec2 lo(std::numeric_limits<float>::max());
+    glm::vec2 hi(-std::numeric_limits<float>::max());
+    z_min = 1.0f;
+    for (uint32_t i = 0; i < 8; i++) {
+        glm::vec4 clip = this->view_proj * glm::vec4(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0f);
+        if (clip.w <= 0.0f || clip.z < 0.0f) { return false; }
+        glm::vec3 screen = project(clip, this->buffer.width(), this->buffer.height());
+        lo = glm::min(lo, glm::vec2(screen));
+        hi = glm::max(hi, glm::vec2(screen));
+        z_min = std::min(z_min, screen.z);
+    }
+
+    // Boxes off-screen are left to frustum culling
+    if (hi.x < 0.0f || hi.y < 0.0f || lo.x >= (float) this->buffer.width() || lo.y >= (float) this->buffer.height()) { return false; }
+
+    // Take all pixels the rectangle touches, not only those whose centre it covers
+    min_x = static_cast<uint32_t>(std::max(lo.x, 0.0f));
+    min_y = static_cast<uint32_t>(std::max(lo.y, 0.0f));
+    max_x = static_cast<uint32_t>(std::min(hi.x, (float) (this->buffer.width() - 1)));
+    max_y = static_cast<uint32_t>(std::min(hi.y, (float) (this->buffer.height() - 1)));
+    return true;
+}
+
+/* Returns whether the given world-space bounding box may be visible, i.e., isn't entirely hidden behind the occluders. Boxes that can't be tested are always visible. */
+bool OcclusionCuller::visible(const glm::vec3& min, const glm::vec3& max) const {
+    uint32_t min_x, min_y, max_x, max_y;
+    float z_min;
+    if (!this->screen_bounds(min, max, min_x, min_y, max_x, max_y, z_min)) { return true; }
+    return this->buffer.test_rect(min_x, min_y, max_x, max_y, z_min);
+}
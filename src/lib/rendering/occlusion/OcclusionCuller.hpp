@@ -0,0 +1,76 @@
+/* OCCLUSION CULLER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the OcclusionCuller class, which culls entities on the CPU
+ *   before their draws are even sorted. A few designated occluders are
+ *   projected to the screen and rasterized to a MaskedDepthBuffer, after
+ *   which the bounding boxes of the entities are tested against it. Lives
+ *   without any GPU, so it can be tested on its own.
+**/
+
+#ifndef RENDERING_OCCLUSION_CULLER_HPP
+#define RENDERING_OCCLUSION_CULLER_HPP
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+#include "tools/Array.hpp"
+#include "tools/ThreadPool.hpp"
+
+#include "MaskedDepthBuffer.hpp"
+
+namespace Makma3D::Rendering {
+    /* The OcclusionCuller class, which rasterizes occluders on the CPU and tests bounding boxes against them. */
+    class OcclusionCuller {
+    public:
+        /* Channel name for the OcclusionCuller class. */
+        static constexpr const char* channel = "OcclusionCuller";
+        /* The default width of the depth buffer, in pixels. */
+        static constexpr const uint32_t default_width = 320;
+        /* The default height of the depth buffer, in pixels. */
+        static constexpr const uint32_t default_height = 192;
+
+    private:
+        /* The depth buffer the occluders are rasterized to. */
+        Rendering::MaskedDepthBuffer buffer;
+        /* The view-projection matrix of the camera we cull for. */
+        glm::mat4 view_proj;
+        /* The triangles of all occluders added since the last begin(), projected to the screen. */
+        Tools::Array<Rendering::ScreenTriangle> triangles;
+        /* Scratch space for the vertices of an occluder in clip space. Kept around to re-use its memory. */
+        Tools::Array<glm::vec4> clip_vertices;
+
+    public:
+        /* Constructor for the OcclusionCuller class, which takes the size of its depth buffer in pixels. */
+        OcclusionCuller(uint32_t width = OcclusionCuller::default_width, uint32_t height = OcclusionCuller::default_height);
+
+        /* Starts culling for a new frame as seen with the given view-projection matrix, which clears the occluders of the previous one. */
+        void begin(const glm::mat4& view_proj);
+        /* Adds an occluder with the given model-space vertices and triangle list, placed in the world with the given transformation matrix. Its triangles are clipped to the near plane and projected to the screen, but not yet rasterized. */
+        void add_occluder(const glm::mat4& transform, const glm::vec3* vertices, const uint32_t* indices, uint32_t n_indices);
+        /* Rasterizes all added occluders to the depth buffer. If a pool is given, bands of tile rows are rasterized in parallel on it. */
+        void rasterize(Tools::ThreadPool* pool = nullptr);
+
+        /* Computes the rectangle of pixels (maxima inclusive) that the given world-space bounding box covers on the screen, and the nearest depth it reaches. Returns false if it can't be tested, because it crosses the near plane or lies off-screen. */
+        bool screen_bounds(const glm::vec3& min, const glm::vec3& max, uint32_t& min_x, uint32_t& min_y, uint32_t& max_x, uint32_t& max_y, float& z_min) const;
+        /* Returns whether the given world-space bounding box may be visible, i.e., isn't entirely hidden behind the occluders. Boxes that can't be tested are always visible. */
+        bool visible(const glm::vec3& min, const glm::vec3& max) const;
+
+        /* Returns the depth buffer the occluders are rasterized to. */
+        inline const Rendering::MaskedDepthBuffer& depth_buffer() const { return this->buffer; }
+        /* Returns the projected triangles of the occluders added since the last begin(). */
+        inline const Tools::Array<Rendering::ScreenTriangle>& screen_triangles() const { return this->triangles; }
+
+    };
+
+}
+
+#endif
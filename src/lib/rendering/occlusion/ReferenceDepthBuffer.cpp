@@ -0,0 +1,77 @@
+/* REFERENCE DEPTH BUFFER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ReferenceDepthBuffer class, which rasterizes the same
+ *   triangles as the MaskedDepthBuffer the brute-force way, with an exact
+ *   depth per pixel. It's much too slow to cull with, but serves as the
+ *   reference to check the MaskedDepthBuffer against.
+**/
+
+#include <algorithm>
+
+#include "ReferenceDepthBuffer.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** REFERENCEDEPTHBUFFER CLASS *****/
+/* Constructor for the ReferenceDepthBuffer class, which takes its size in pixels. */
+ReferenceDepthBuffer::ReferenceDepthBuffer(uint32_t width, uint32_t height) :
+    _width(width),
+    _height(height)
+{
+    this->depths.resize(this->_width * this->_height);
+    this->clear();
+}
+
+
+
+/* Resets the buffer so that all pixels lie at the far plane. */
+void ReferenceDepthBuffer::clear() {
+    for (uint32_t i = 0; i < this->depths.size(); i++) {
+        this->depths[i] = 1.0f;
+    }
+}
+
+/* Rasterizes the given triangles, keeping the nearest depth in each pixel whose centre they cover. */
+void ReferenceDepthBuffer::rasterize(const Rendering::ScreenTriangle* triangles, uint32_t n_triangles) {
+    for (uint32_t i = 0; i < n_triangles; i++) {
+        // Prepare the triangle the same way the MaskedDepthBuffer does
+        TriangleSetup setup;
+        if (!setup_triangle(triangles[i], this->_width, this->_height, setup)) { continue; }
+
+        // Test every pixel in its bounding box
+        for (uint32_t y = setup.min_y; y < setup.max_y; y++) {
+            float py = (float) y + 0.5f;
+            for (uint32_t x = setup.min_x; x < setup.max_x; x++) {
+                float px = (float) x + 0.5f;
+                if (setup.edge(0, px, py) >= 0.0f && setup.edge(1, px, py) >= 0.0f && setup.edge(2, px, py) >= 0.0f) {
+                    float& depth = this->depths[y * this->_width + x];
+                    depth = std::min(depth, setup.depth(px, py));
+                }
+            }
+        }
+    }
+}
+
+/* Returns whether anything at the given depth could be visible in the given rectangle of pixels (maxima inclusive), i.e., whether any of its pixels lies at or behind it. */
+bool ReferenceDepthBuffer::test_rect(uint32_t min_x, uint32_t min_y, uint32_t max_x, uint32_t max_y, float z_min) const {
+    max_x = std::min(max_x, this->_width - 1);
+    max_y = std::min(max_y, this->_height - 1);
+    for (uint32_t y = min_y; y <= max_y; y++) {
+        for (uint32_t x = min_x; x <= max_x; x++) {
+            if (z_min <= this->depths[y * this->_width + x]) { return true; }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,64 @@
+/* REFERENCE DEPTH BUFFER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ReferenceDepthBuffer class, which rasterizes the same
+ *   triangles as the MaskedDepthBuffer the brute-force way, with an exact
+ *   depth per pixel. It's much too slow to cull with, but serves as the
+ *   reference to check the MaskedDepthBuffer against.
+**/
+
+#ifndef RENDERING_REFERENCE_DEPTH_BUFFER_HPP
+#define RENDERING_REFERENCE_DEPTH_BUFFER_HPP
+
+#include <cstdint>
+
+#include "tools/Array.hpp"
+
+#include "MaskedDepthBuffer.hpp"
+
+namespace Makma3D::Rendering {
+    /* The ReferenceDepthBuffer class, which rasterizes triangles to a plain depth buffer, one pixel at a time. */
+    class ReferenceDepthBuffer {
+    public:
+        /* Channel name for the ReferenceDepthBuffer class. */
+        static constexpr const char* channel = "ReferenceDepthBuffer";
+
+    private:
+        /* The width of the buffer, in pixels. */
+        uint32_t _width;
+        /* The height of the buffer, in pixels. */
+        uint32_t _height;
+        /* The depth of each pixel, row by row. */
+        Tools::Array<float> depths;
+
+    public:
+        /* Constructor for the ReferenceDepthBuffer class, which takes its size in pixels. */
+        ReferenceDepthBuffer(uint32_t width, uint32_t height);
+
+        /* Resets the buffer so that all pixels lie at the far plane. */
+        void clear();
+        /* Rasterizes the given triangles, keeping the nearest depth in each pixel whose centre they cover. */
+        void rasterize(const Rendering::ScreenTriangle* triangles, uint32_t n_triangles);
+        /* Returns whether anything at the given depth could be visible in the given rectangle of pixels (maxima inclusive), i.e., whether any of its pixels lies at or behind it. */
+        bool test_rect(uint32_t min_x, uint32_t min_y, uint32_t max_x, uint32_t max_y, float z_min) const;
+
+        /* Returns the depth of the given pixel. */
+        inline float depth(uint32_t x, uint32_t y) const { return this->depths[y * this->_width + x]; }
+        /* Returns the width of the buffer, in pixels. */
+        inline uint32_t width() const { return this->_width; }
+        /* Returns the height of the buffer, in pixels. */
+        inline uint32_t height() const { return this->_height; }
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,243 @@
+/* PARTICLE BUFFERS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 03:27:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParticleBuffers class, which owns the buffers a single
+ *   frame needs to update the particles on the GPU: the per-frame
+ *   parameters and the emitters. Can also read back the counters to
+ *   compare the number of living particles against a reference on the
+ *   CPU.
+**/
+
+#include <cstring>
+#include <algorithm>
+
+#include "tools/Logger.hpp"
+
+#include "ParticleBuffers.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given VkBufferCopy struct to copy the given number of bytes from the start of one buffer to the start of another. */
+static void populate_buffer_copy(VkBufferCopy& copy_region, VkDeviceSize n_bytes) {
+    copy_region = {};
+    copy_region.srcOffset = 0;
+    copy_region.dstOffset = 0;
+    copy_region.size = n_bytes;
+}
+
+/* Populates the given VkMemoryBarrier struct. */
+static void populate_memory_barrier(VkMemoryBarrier& memory_barrier, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    memory_barrier = {};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memory_barrier.srcAccessMask = src_access;
+    memory_barrier.dstAccessMask = dst_access;
+}
+
+
+
+
+
+/***** PARTICLEBUFFERS CLASS *****/
+/* Constructor for the ParticleBuffers class, which takes the GPU where they live, the layout of the descriptor set to simulate with (see ParticleSystem) and whether to read back the counters after each update to check them. */
+ParticleBuffers::ParticleBuffers(const Rendering::GPU& gpu, const Rendering::DescriptorSetLayout& simulate_layout, bool check_results) :
+    gpu(gpu),
+    params({}),
+    check_results(check_results),
+    readback_pool(nullptr),
+    readback_buffer(nullptr),
+    readback_mapped(nullptr),
+    readback_pending(false),
+    expected_alive(0),
+    expected_exact(true)
+{
+    // Allocate the parameters and the emitters once, since they never change size. The memory is coherent, so we don't have to flush our writes
+    this->params_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { sizeof(ParticleParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    this->params_buffer = this->params_pool->allocate(sizeof(ParticleParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    this->params_buffer->map(&this->params_mapped);
+    VkDeviceSize emitters_size = ParticleSystem::max_emitters * sizeof(EmitterData);
+    this->emitters_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { emitters_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    this->emitters_buffer = this->emitters_pool->allocate(emitters_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    this->emitters_buffer->map(&this->emitters_mapped);
+
+    // Only the counters are read back, so that buffer never changes size either
+    if (this->check_results) {
+        this->readback_pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { sizeof(ParticleCounters), VK_BUFFER_USAGE_TRANSFER_DST_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        this->readback_buffer = this->readback_pool->allocate(sizeof(ParticleCounters), VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        this->readback_buffer->map(&this->readback_mapped);
+    }
+
+    // Allocate the descriptor set
+    this->descriptor_pool = new DescriptorPool(this->gpu, {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 }
+    }, 1);
+    this->set = this->descriptor_pool->allocate(simulate_layout);
+}
+
+/* Move constructor for the ParticleBuffers class. */
+ParticleBuffers::ParticleBuffers(ParticleBuffers&& other) :
+    gpu(other.gpu),
+    params_pool(other.params_pool),
+    params_buffer(other.params_buffer),
+    params_mapped(other.params_mapped),
+    emitters_pool(other.emitters_pool),
+    emitters_buffer(other.emitters_buffer),
+    emitters_mapped(other.emitters_mapped),
+    descriptor_pool(other.descriptor_pool),
+    set(other.set),
+    params(other.params),
+    check_results(other.check_results),
+    readback_pool(other.readback_pool),
+    readback_buffer(other.readback_buffer),
+    readback_mapped(other.readback_mapped),
+    readback_pending(other.readback_pending),
+    expected_alive(other.expected_alive),
+    expected_exact(other.expected_exact)
+{
+    // Make sure the other doesn't deallocate anything
+    other.params_pool = nullptr;
+    other.params_buffer = nullptr;
+    other.emitters_pool = nullptr;
+    other.emitters_buffer = nullptr;
+    other.descriptor_pool = nullptr;
+    other.readback_pool = nullptr;
+    other.readback_buffer = nullptr;
+}
+
+/* Destructor for the ParticleBuffers class. */
+ParticleBuffers::~ParticleBuffers() {
+    if (this->descriptor_pool != nullptr) {
+        delete this->descriptor_pool;
+    }
+    if (this->readback_buffer != nullptr) {
+        this->readback_buffer->unmap();
+        this->readback_pool->free(this->readback_buffer);
+    }
+    if (this->readback_pool != nullptr) {
+        delete this->readback_pool;
+    }
+    if (this->emitters_buffer != nullptr) {
+        this->emitters_buffer->unmap();
+        this->emitters_pool->free(this->emitters_buffer);
+    }
+    if (this->emitters_pool != nullptr) {
+        delete this->emitters_pool;
+    }
+    if (this->params_buffer != nullptr) {
+        this->params_buffer->unmap();
+        this->params_pool->free(this->params_buffer);
+    }
+    if (this->params_pool != nullptr) {
+        delete this->params_pool;
+    }
+}
+
+
+
+/* Uploads the given emitters and parameters, whose first particles & number of emitters and particles are overwritten to match the emitters. Any emitters beyond ParticleSystem::max_emitters are ignored. If the system checks its results, also advances its reference. The frame may not be in flight. */
+void ParticleBuffers::upload(const Tools::Array<Rendering::EmitterData>& emitters, const Rendering::ParticleParams& params, Rendering::ParticleSystem& system) {
+    // Copy the emitters, giving each a consecutive range of the particles spawned this frame
+    uint32_t n_emitters = std::min(emitters.size(), ParticleSystem::max_emitters);
+    EmitterData* mapped = (EmitterData*) this->emitters_mapped;
+    uint32_t n_emit = 0;
+    for (uint32_t i = 0; i < n_emitters; i++) {
+        mapped[i] = emitters[i];
+        mapped[i].first = n_emit;
+        n_emit += emitters[i].count;
+    }
+
+    // Copy the parameters
+    this->params = params;
+    this->params.n_emitters = n_emitters;
+    this->params.n_emit = n_emit;
+    std::memcpy(this->params_mapped, &this->params, sizeof(ParticleParams));
+
+    // Remember what the reference expects after this frame. Frames are uploaded in the order they're submitted, so it sees them in the same order as the GPU
+    if (system.reference() != nullptr) {
+        system.reference()->advance(this->params, mapped, n_emitters);
+        this->expected_alive = system.reference()->alive();
+        this->expected_exact = system.reference()->exact();
+    }
+}
+
+/* Schedules updating the particles of the given system with the uploaded emitters on the given command buffer, before the render pass that draws them. If the results are checked, also copies the counters to the readback buffer. */
+void ParticleBuffers::schedule_update(const Rendering::CommandBuffer* cmd, Rendering::ParticleSystem& system) {
+    // The set is cheap to bind, so always bind it anew rather than tracking which system it was bound to
+    system.bind(this->set, this->params_buffer, this->emitters_buffer);
+    system.schedule_update(cmd, this->set, this->params.n_emit);
+    if (!this->check_results) { return; }
+
+    // Copy the counters, which the system already made available to transfers
+    VkBufferCopy buffer_copy;
+    populate_buffer_copy(buffer_copy, sizeof(ParticleCounters));
+    vkCmdCopyBuffer(cmd->vulkan(), system.counters()->vulkan(), this->readback_buffer->vulkan(), 1, &buffer_copy);
+
+    // Make the copy visible to the host
+    VkMemoryBarrier memory_barrier;
+    populate_memory_barrier(memory_barrier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+    this->readback_pending = true;
+}
+
+/* Compares the number of living particles after the last update against the reference on the CPU, logging any difference. Returns the number of particles that differ, or 0 if nothing was read back. The frame may not be in flight. */
+uint32_t ParticleBuffers::check() {
+    if (!this->readback_pending) { return 0; }
+    this->readback_pending = false;
+
+    // The number of particles drawn is the number that survived
+    const ParticleCounters* counters = (const ParticleCounters*) this->readback_mapped;
+    uint32_t alive = counters->draw_instances;
+    uint32_t n_wrong = alive > this->expected_alive ? alive - this->expected_alive : this->expected_alive - alive;
+    if (counters->alive != alive || counters->dispatch_x != (alive + ParticleSystem::group_size - 1) / ParticleSystem::group_size) {
+        logger.warningc(ParticleBuffers::channel, "Particle counters are inconsistent: drawing ", alive, " particles, but ", counters->alive, " are alive and ", counters->dispatch_x, " groups are dispatched.");
+    }
+
+    // Once particles were dropped, the GPU may have dropped those of different emitters than the reference, so only then a difference is to be expected
+    if (n_wrong > 0 && this->expected_exact) {
+        logger.warningc(ParticleBuffers::channel, "GPU simulation has ", alive, " living particles, but the reference has ", this->expected_alive, ".");
+    }
+    logger.logc(Verbosity::details, ParticleBuffers::channel, "GPU simulation has ", alive, " living particles (expected ", this->expected_alive, this->expected_exact ? "" : " approximately", "), ", counters->dropped, " dropped so far.");
+
+    // Done
+    return this->expected_exact ? n_wrong : 0;
+}
+
+
+
+/* Swap operator for the ParticleBuffers class. */
+void Rendering::swap(ParticleBuffers& pb1, ParticleBuffers& pb2) {
+    #ifndef NDEBUG
+    if (pb1.gpu != pb2.gpu) { logger.fatalc(ParticleBuffers::channel, "Cannot swap particle buffers with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(pb1.params_pool, pb2.params_pool);
+    swap(pb1.params_buffer, pb2.params_buffer);
+    swap(pb1.params_mapped, pb2.params_mapped);
+    swap(pb1.emitters_pool, pb2.emitters_pool);
+    swap(pb1.emitters_buffer, pb2.emitters_buffer);
+    swap(pb1.emitters_mapped, pb2.emitters_mapped);
+    swap(pb1.descriptor_pool, pb2.descriptor_pool);
+    swap(pb1.set, pb2.set);
+    swap(pb1.params, pb2.params);
+    swap(pb1.check_results, pb2.check_results);
+    swap(pb1.readback_pool, pb2.readback_pool);
+    swap(pb1.readback_buffer, pb2.readback_buffer);
+    swap(pb1.readback_mapped, pb2.readback_mapped);
+    swap(pb1.readback_pending, pb2.readback_pending);
+    swap(pb1.expected_alive, pb2.expected_alive);
+    swap(pb1.expected_exact, pb2.expected_exact);
+}
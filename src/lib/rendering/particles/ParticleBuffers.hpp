@@ -0,0 +1,115 @@
+/* PARTICLE BUFFERS.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParticleBuffers class, which owns the buffers a single
+ *   frame needs to update the particles on the GPU: the per-frame
+ *   parameters and the emitters. Can also read back the counters to
+ *   compare the number of living particles against a reference on the
+ *   CPU.
+**/
+
+#ifndef RENDERING_PARTICLE_BUFFERS_HPP
+#define RENDERING_PARTICLE_BUFFERS_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../memory/LinearMemoryPool.hpp"
+#include "../memory/Buffer.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+#include "../descriptors/DescriptorPool.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+#include "../data/ParticleData.hpp"
+
+#include "ParticleSystem.hpp"
+
+namespace Makma3D::Rendering {
+    /* The ParticleBuffers class, which owns the buffers to update the particles with in a single frame. */
+    class ParticleBuffers {
+    public:
+        /* Channel name for the ParticleBuffers class. */
+        static constexpr const char* channel = "ParticleBuffers";
+
+        /* The GPU where the ParticleBuffers live. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The pool with the parameters. Each mapped buffer has its own pool, since a pool's memory can only be mapped once at a time. */
+        Rendering::LinearMemoryPool* params_pool;
+        /* The host-visible buffer with the parameters. */
+        Rendering::Buffer* params_buffer;
+        /* The parameters' memory, which stays mapped for as long as the buffer exists. */
+        void* params_mapped;
+        /* The pool with the emitters. */
+        Rendering::LinearMemoryPool* emitters_pool;
+        /* The host-visible buffer with room for ParticleSystem::max_emitters emitters. */
+        Rendering::Buffer* emitters_buffer;
+        /* The emitters' memory, which stays mapped for as long as the buffer exists. */
+        void* emitters_mapped;
+
+        /* The pool for the descriptor set. */
+        Rendering::DescriptorPool* descriptor_pool;
+        /* The descriptor set to simulate with. */
+        Rendering::DescriptorSet* set;
+
+        /* The parameters of the last upload. */
+        Rendering::ParticleParams params;
+
+        /* Whether the counters are read back after each update to check them. */
+        bool check_results;
+        /* The pool with the readback buffer. Is a nullptr if nothing is checked. */
+        Rendering::LinearMemoryPool* readback_pool;
+        /* The host-visible buffer to which the counters are copied. */
+        Rendering::Buffer* readback_buffer;
+        /* The readback buffer's memory, which stays mapped for as long as the buffer exists. */
+        void* readback_mapped;
+        /* Whether a readback has been recorded that hasn't been checked yet. */
+        bool readback_pending;
+        /* The number of particles the reference expected to be alive after the last update. */
+        uint32_t expected_alive;
+        /* Whether that number was exact. */
+        bool expected_exact;
+
+    public:
+        /* Constructor for the ParticleBuffers class, which takes the GPU where they live, the layout of the descriptor set to simulate with (see ParticleSystem) and whether to read back the counters after each update to check them. */
+        ParticleBuffers(const Rendering::GPU& gpu, const Rendering::DescriptorSetLayout& simulate_layout, bool check_results);
+        /* Copy constructor for the ParticleBuffers class, which is deleted. */
+        ParticleBuffers(const ParticleBuffers& other) = delete;
+        /* Move constructor for the ParticleBuffers class. */
+        ParticleBuffers(ParticleBuffers&& other);
+        /* Destructor for the ParticleBuffers class. */
+        ~ParticleBuffers();
+
+        /* Uploads the given emitters and parameters, whose first particles & number of emitters and particles are overwritten to match the emitters. Any emitters beyond ParticleSystem::max_emitters are ignored. If the system checks its results, also advances its reference. The frame may not be in flight. */
+        void upload(const Tools::Array<Rendering::EmitterData>& emitters, const Rendering::ParticleParams& params, Rendering::ParticleSystem& system);
+        /* Schedules updating the particles of the given system with the uploaded emitters on the given command buffer, before the render pass that draws them. If the results are checked, also copies the counters to the readback buffer. */
+        void schedule_update(const Rendering::CommandBuffer* cmd, Rendering::ParticleSystem& system);
+        /* Compares the number of living particles after the last update against the reference on the CPU, logging any difference. Returns the number of particles that differ, or 0 if nothing was read back. The frame may not be in flight. */
+        uint32_t check();
+
+        /* Copy assignment operator for the ParticleBuffers class, which is deleted. */
+        ParticleBuffers& operator=(const ParticleBuffers& other) = delete;
+        /* Move assignment operator for the ParticleBuffers class. */
+        inline ParticleBuffers& operator=(ParticleBuffers&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the ParticleBuffers class. */
+        friend void swap(ParticleBuffers& pb1, ParticleBuffers& pb2);
+
+    };
+
+    /* Swap operator for the ParticleBuffers class. */
+    void swap(ParticleBuffers& pb1, ParticleBuffers& pb2);
+
+}
+
+#endif
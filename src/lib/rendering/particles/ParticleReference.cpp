@@ -0,0 +1,65 @@
+/* PARTICLE REFERENCE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParticleReference class, which follows the lifetimes of
+ *   the particles simulated on the GPU on the CPU, so that the number of
+ *   particles the GPU keeps alive can be checked against it. It only
+ *   tracks how long groups of particles have left to live, not where
+ *   they are, since that's all that decides the count.
+**/
+
+#include <algorithm>
+
+#include "ParticleReference.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** PARTICLEREFERENCE CLASS *****/
+/* Constructor for the ParticleReference class, which takes the number of particles that can be alive at once. */
+ParticleReference::ParticleReference(uint32_t capacity) :
+    _capacity(capacity),
+    _alive(0),
+    _exact(true)
+{}
+
+
+
+/* Simulates a single frame with the given parameters and the given emitters like the GPU would: the living particles age first, after which the emitters spawn new ones until the buffer is full. */
+void ParticleReference::advance(const Rendering::ParticleParams& params, const Rendering::EmitterData* emitters, uint32_t n_emitters) {
+    // Age all groups, dropping those that die. This is the same single subtraction the shader does, so they die in exactly the same frame
+    uint32_t n_kept = 0;
+    this->_alive = 0;
+    for (uint32_t i = 0; i < this->batches.size(); i++) {
+        Batch batch = this->batches[i];
+        batch.life -= params.dt;
+        if (batch.life <= 0.0f) { continue; }
+        this->batches[n_kept++] = batch;
+        this->_alive += batch.count;
+    }
+    while (this->batches.size() > n_kept) { this->batches.pop_back(); }
+
+    // Make room for a group per emitter, growing generously since this happens every frame
+    if (this->batches.size() + n_emitters > this->batches.capacity()) {
+        this->batches.reserve(2 * (this->batches.size() + n_emitters));
+    }
+
+    // Spawn the new ones in emitter order, until there's no more room
+    for (uint32_t e = 0; e < n_emitters; e++) {
+        uint32_t count = std::min(emitters[e].count, this->_capacity - this->_alive);
+        if (count < emitters[e].count) { this->_exact = false; }
+        if (count == 0) { continue; }
+        this->batches.push_back({ emitters[e].colour.w, count });
+        this->_alive += count;
+    }
+}
@@ -0,0 +1,67 @@
+/* PARTICLE REFERENCE.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParticleReference class, which follows the lifetimes of
+ *   the particles simulated on the GPU on the CPU, so that the number of
+ *   particles the GPU keeps alive can be checked against it. It only
+ *   tracks how long groups of particles have left to live, not where
+ *   they are, since that's all that decides the count.
+**/
+
+#ifndef RENDERING_PARTICLE_REFERENCE_HPP
+#define RENDERING_PARTICLE_REFERENCE_HPP
+
+#include <cstdint>
+
+#include "tools/Array.hpp"
+
+#include "../data/ParticleData.hpp"
+
+namespace Makma3D::Rendering {
+    /* The ParticleReference class, which counts the particles the GPU should have alive after each frame. */
+    class ParticleReference {
+    private:
+        /* A group of particles spawned by the same emitter in the same frame, which thus all die in the same frame. */
+        struct Batch {
+            /* The number of seconds the particles have left to live. */
+            float life;
+            /* The number of particles in the group. */
+            uint32_t count;
+        };
+
+        /* The number of particles that can be alive at once. */
+        uint32_t _capacity;
+        /* The groups of living particles. */
+        Tools::Array<Batch> batches;
+        /* The number of living particles. */
+        uint32_t _alive;
+        /* Whether the count is still exact. Once the buffer overflows, the GPU may drop the particles of other emitters than we do, and those may live longer or shorter. */
+        bool _exact;
+
+    public:
+        /* Constructor for the ParticleReference class, which takes the number of particles that can be alive at once. */
+        ParticleReference(uint32_t capacity);
+
+        /* Simulates a single frame with the given parameters and the given emitters like the GPU would: the living particles age first, after which the emitters spawn new ones until the buffer is full. */
+        void advance(const Rendering::ParticleParams& params, const Rendering::EmitterData* emitters, uint32_t n_emitters);
+
+        /* Returns the number of particles that can be alive at once. */
+        inline uint32_t capacity() const { return this->_capacity; }
+        /* Returns the number of living particles after the last frame. */
+        inline uint32_t alive() const { return this->_alive; }
+        /* Returns whether the count is exact, which it stops being once more particles were spawned than fit. */
+        inline bool exact() const { return this->_exact; }
+
+    };
+
+}
+
+#endif
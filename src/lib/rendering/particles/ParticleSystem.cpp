@@ -0,0 +1,248 @@
+/* PARTICLE SYSTEM.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 03:27:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParticleSystem class, which simulates particles entirely
+ *   on the GPU. Each frame, three compute passes age and move the living
+ *   particles (compacting the survivors into the other half of a
+ *   ping-pong buffer), spawn the particles the emitters asked for and
+ *   write the indirect commands that draw the particles and simulate
+ *   them next frame. The CPU only ever uploads the emitters.
+**/
+
+#include <cstddef>
+
+#include "tools/Logger.hpp"
+#include "../pipeline/PipelineConstructor.hpp"
+
+#include "ParticleSystem.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given VkMemoryBarrier struct. */
+static void populate_memory_barrier(VkMemoryBarrier& memory_barrier, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    memory_barrier = {};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memory_barrier.srcAccessMask = src_access;
+    memory_barrier.dstAccessMask = dst_access;
+}
+
+/* Populates the given ParticleCounters struct for an empty simulation with the given capacity. */
+static void populate_initial_counters(ParticleCounters& counters, uint32_t capacity) {
+    // Set to default
+    counters = {};
+
+    // Each particle is a quad of two triangles, and there's nothing to draw or simulate yet
+    counters.draw_vertices = 6;
+    counters.dispatch_y = 1;
+    counters.dispatch_z = 1;
+
+    // The living particles start in the first half
+    counters.current = 0;
+    counters.capacity = capacity;
+}
+
+
+
+
+
+/***** PARTICLESYSTEM CLASS *****/
+/* Constructor for the ParticleSystem class, which takes the GPU where it lives, the pool to load its shaders from, the cache to create its pipelines with, the number of particles that can be alive at once and whether to follow that number on the CPU so that frames can check the simulation. */
+ParticleSystem::ParticleSystem(const Rendering::GPU& gpu, Rendering::ShaderPool& shader_pool, const Rendering::PipelineCache& pipeline_cache, uint32_t capacity, bool check_results) :
+    gpu(gpu),
+    _simulate_layout(gpu),
+    _draw_layout(gpu),
+    _capacity(capacity),
+    initialized(false),
+    _reference(check_results ? new ParticleReference(capacity) : nullptr)
+{
+    logger.logc(Verbosity::important, ParticleSystem::channel, "Initializing with room for ", capacity, " particles...");
+
+    // Define the layout for simulating: the parameters, the emitters, the particles and the counters
+    this->_simulate_layout.add_binding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_simulate_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_simulate_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_simulate_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    this->_simulate_layout.finalize();
+
+    // Define the layout for drawing: only the vertex shader reads the particles and the counters
+    this->_draw_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
+    this->_draw_layout.add_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT);
+    this->_draw_layout.finalize();
+
+    // Create the pipelines, which share the layout and only differ in their stage of the same shader
+    PipelineConstructor pipeline_constructor(this->gpu, pipeline_cache);
+    pipeline_constructor.pipeline_layout = PipelineLayout({ this->_simulate_layout }, {});
+    pipeline_constructor.shaders = { ShaderStage(shader_pool.allocate("shaders/particle_simulate_comp.spv"), VK_SHADER_STAGE_COMPUTE_BIT, {}) };
+    this->simulate_pipeline = pipeline_constructor.construct_compute();
+    pipeline_constructor.shaders = { ShaderStage(shader_pool.allocate("shaders/particle_emit_comp.spv"), VK_SHADER_STAGE_COMPUTE_BIT, {}) };
+    this->emit_pipeline = pipeline_constructor.construct_compute();
+    pipeline_constructor.shaders = { ShaderStage(shader_pool.allocate("shaders/particle_finalize_comp.spv"), VK_SHADER_STAGE_COMPUTE_BIT, {}) };
+    this->finalize_pipeline = pipeline_constructor.construct_compute();
+
+    // Allocate both halves of the particles and the counters in device-local memory, since only the GPU ever touches them (except when the counters are copied to be checked)
+    VkDeviceSize particles_size = 2 * (VkDeviceSize) capacity * sizeof(ParticleData);
+    this->pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, {
+        { particles_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT },
+        { sizeof(ParticleCounters), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT }
+    }), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    this->particles_buffer = this->pool->allocate(particles_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    this->counters_buffer = this->pool->allocate(sizeof(ParticleCounters), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    // Allocate & bind the descriptor set to draw with once, since the buffers never change
+    this->descriptor_pool = new DescriptorPool(this->gpu, {
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 }
+    }, 1);
+    this->_draw_set = this->descriptor_pool->allocate(this->_draw_layout);
+    this->_draw_set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0, { this->particles_buffer });
+    this->_draw_set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, { this->counters_buffer });
+
+    // Done
+    logger.logc(Verbosity::important, ParticleSystem::channel, "Init success.");
+}
+
+/* Move constructor for the ParticleSystem class. */
+ParticleSystem::ParticleSystem(ParticleSystem&& other) :
+    gpu(other.gpu),
+    _simulate_layout(std::move(other._simulate_layout)),
+    _draw_layout(std::move(other._draw_layout)),
+    simulate_pipeline(other.simulate_pipeline),
+    emit_pipeline(other.emit_pipeline),
+    finalize_pipeline(other.finalize_pipeline),
+    pool(other.pool),
+    particles_buffer(other.particles_buffer),
+    counters_buffer(other.counters_buffer),
+    _capacity(other._capacity),
+    initialized(other.initialized),
+    descriptor_pool(other.descriptor_pool),
+    _draw_set(other._draw_set),
+    _reference(other._reference)
+{
+    // Make sure the other doesn't deallocate anything
+    other.simulate_pipeline = nullptr;
+    other.emit_pipeline = nullptr;
+    other.finalize_pipeline = nullptr;
+    other.pool = nullptr;
+    other.particles_buffer = nullptr;
+    other.counters_buffer = nullptr;
+    other.descriptor_pool = nullptr;
+    other._reference = nullptr;
+}
+
+/* Destructor for the ParticleSystem class. */
+ParticleSystem::~ParticleSystem() {
+    logger.logc(Verbosity::important, ParticleSystem::channel, "Cleaning...");
+
+    if (this->_reference != nullptr) {
+        delete this->_reference;
+    }
+    if (this->descriptor_pool != nullptr) {
+        delete this->descriptor_pool;
+    }
+    if (this->counters_buffer != nullptr) {
+        this->pool->free(this->counters_buffer);
+    }
+    if (this->particles_buffer != nullptr) {
+        this->pool->free(this->particles_buffer);
+    }
+    if (this->pool != nullptr) {
+        delete this->pool;
+    }
+    if (this->finalize_pipeline != nullptr) {
+        delete this->finalize_pipeline;
+    }
+    if (this->emit_pipeline != nullptr) {
+        delete this->emit_pipeline;
+    }
+    if (this->simulate_pipeline != nullptr) {
+        delete this->simulate_pipeline;
+    }
+
+    logger.logc(Verbosity::important, ParticleSystem::channel, "Cleaned.");
+}
+
+
+
+/* Binds the given buffers with the parameters and the emitters, and the particles & counters, to the given descriptor set, which has to have the simulate layout. */
+void ParticleSystem::bind(const Rendering::DescriptorSet* set, Rendering::Buffer* params, Rendering::Buffer* emitters) const {
+    set->bind(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, { params });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, { emitters });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, { this->particles_buffer });
+    set->bind(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3, { this->counters_buffer });
+}
+
+/* Schedules simulating a single frame with the given descriptor set on the given command buffer, spawning the given number of particles, before the render pass that draws them. Also makes sure the counters can be read by indirect draws, vertex shaders and transfers afterwards. */
+void ParticleSystem::schedule_update(const Rendering::CommandBuffer* cmd, const Rendering::DescriptorSet* set, uint32_t n_emit) {
+    // The very first frame starts from an empty simulation
+    if (!this->initialized) {
+        ParticleCounters counters;
+        populate_initial_counters(counters, this->_capacity);
+        vkCmdUpdateBuffer(cmd->vulkan(), this->counters_buffer->vulkan(), 0, sizeof(ParticleCounters), &counters);
+        this->initialized = true;
+    }
+
+    // Wait until the previous frame is done drawing & copying the particles, and until the counters are written
+    VkMemoryBarrier memory_barrier;
+    populate_memory_barrier(memory_barrier, VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+
+    // Age & compact the living particles, with as many groups as the last frame's finalize asked for
+    this->simulate_pipeline->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+    set->schedule(cmd, this->simulate_pipeline->layout(), 0, VK_PIPELINE_BIND_POINT_COMPUTE);
+    this->simulate_pipeline->schedule_dispatch_indirect(cmd, this->counters_buffer, offsetof(ParticleCounters, dispatch_x));
+
+    // Spawn the new particles behind the survivors, once they know how many there are
+    populate_memory_barrier(memory_barrier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    if (n_emit > 0) {
+        vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+        this->emit_pipeline->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        set->schedule(cmd, this->emit_pipeline->layout(), 0, VK_PIPELINE_BIND_POINT_COMPUTE);
+        this->emit_pipeline->schedule_dispatch(cmd, (n_emit + ParticleSystem::group_size - 1) / ParticleSystem::group_size);
+    }
+
+    // Write the commands for the next frame once everything is written
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+    this->finalize_pipeline->bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+    set->schedule(cmd, this->finalize_pipeline->layout(), 0, VK_PIPELINE_BIND_POINT_COMPUTE);
+    this->finalize_pipeline->schedule_dispatch(cmd, 1);
+
+    // Make the particles and the counters available to the draw, and to copies in case they're checked
+    populate_memory_barrier(memory_barrier, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+}
+
+
+
+/* Swap operator for the ParticleSystem class. */
+void Rendering::swap(ParticleSystem& ps1, ParticleSystem& ps2) {
+    #ifndef NDEBUG
+    if (ps1.gpu != ps2.gpu) { logger.fatalc(ParticleSystem::channel, "Cannot swap particle systems with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(ps1._simulate_layout, ps2._simulate_layout);
+    swap(ps1._draw_layout, ps2._draw_layout);
+    swap(ps1.simulate_pipeline, ps2.simulate_pipeline);
+    swap(ps1.emit_pipeline, ps2.emit_pipeline);
+    swap(ps1.finalize_pipeline, ps2.finalize_pipeline);
+    swap(ps1.pool, ps2.pool);
+    swap(ps1.particles_buffer, ps2.particles_buffer);
+    swap(ps1.counters_buffer, ps2.counters_buffer);
+    swap(ps1._capacity, ps2._capacity);
+    swap(ps1.initialized, ps2.initialized);
+    swap(ps1.descriptor_pool, ps2.descriptor_pool);
+    swap(ps1._draw_set, ps2._draw_set);
+    swap(ps1._reference, ps2._reference);
+}
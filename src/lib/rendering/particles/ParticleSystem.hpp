@@ -0,0 +1,127 @@
+/* PARTICLE SYSTEM.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParticleSystem class, which simulates particles entirely
+ *   on the GPU. Each frame, three compute passes age and move the living
+ *   particles (compacting the survivors into the other half of a
+ *   ping-pong buffer), spawn the particles the emitters asked for and
+ *   write the indirect commands that draw the particles and simulate
+ *   them next frame. The CPU only ever uploads the emitters.
+**/
+
+#ifndef RENDERING_PARTICLE_SYSTEM_HPP
+#define RENDERING_PARTICLE_SYSTEM_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+#include "../gpu/GPU.hpp"
+#include "../memory/LinearMemoryPool.hpp"
+#include "../memory/Buffer.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+#include "../descriptors/DescriptorSetLayout.hpp"
+#include "../descriptors/DescriptorPool.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+#include "../shaders/ShaderPool.hpp"
+#include "../pipeline/PipelineCache.hpp"
+#include "../pipeline/Pipeline.hpp"
+#include "../data/ParticleData.hpp"
+
+#include "ParticleReference.hpp"
+
+namespace Makma3D::Rendering {
+    /* The ParticleSystem class, which owns the particles, the pipelines that simulate them and the layout to draw them with. */
+    class ParticleSystem {
+    public:
+        /* Channel name for the ParticleSystem class. */
+        static constexpr const char* channel = "ParticleSystem";
+        /* The number of particles handled by a single workgroup, which has to match PARTICLE_GROUP_SIZE in particles.glsl. */
+        static constexpr const uint32_t group_size = 64;
+        /* The maximum number of emitters that spawn particles in a single frame. */
+        static constexpr const uint32_t max_emitters = 256;
+
+        /* The GPU where the ParticleSystem lives. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The layout of the descriptor set to simulate with: the parameters, the emitters, the particles and the counters. */
+        Rendering::DescriptorSetLayout _simulate_layout;
+        /* The layout of the descriptor set to draw with: the particles and the counters. */
+        Rendering::DescriptorSetLayout _draw_layout;
+        /* The pipeline that ages, moves and compacts the living particles. */
+        Rendering::Pipeline* simulate_pipeline;
+        /* The pipeline that spawns new particles. */
+        Rendering::Pipeline* emit_pipeline;
+        /* The pipeline that writes the indirect commands for the next frame. */
+        Rendering::Pipeline* finalize_pipeline;
+
+        /* The pool with the particles and the counters. */
+        Rendering::LinearMemoryPool* pool;
+        /* The device-local buffer with both halves of the particle buffer, back-to-back. */
+        Rendering::Buffer* particles_buffer;
+        /* The device-local buffer with the counters, which double as the indirect draw & dispatch commands. */
+        Rendering::Buffer* counters_buffer;
+        /* The number of particles that can be alive at once. */
+        uint32_t _capacity;
+        /* Whether the counters have been initialized on the GPU yet. */
+        bool initialized;
+
+        /* The pool for the descriptor set to draw with. */
+        Rendering::DescriptorPool* descriptor_pool;
+        /* The descriptor set to draw with, which never changes since the buffers never do. */
+        Rendering::DescriptorSet* _draw_set;
+
+        /* Follows the number of living particles on the CPU if the simulation is checked, or else a nullptr. */
+        Rendering::ParticleReference* _reference;
+
+    public:
+        /* Constructor for the ParticleSystem class, which takes the GPU where it lives, the pool to load its shaders from, the cache to create its pipelines with, the number of particles that can be alive at once and whether to follow that number on the CPU so that frames can check the simulation. */
+        ParticleSystem(const Rendering::GPU& gpu, Rendering::ShaderPool& shader_pool, const Rendering::PipelineCache& pipeline_cache, uint32_t capacity, bool check_results);
+        /* Copy constructor for the ParticleSystem class, which is deleted. */
+        ParticleSystem(const ParticleSystem& other) = delete;
+        /* Move constructor for the ParticleSystem class. */
+        ParticleSystem(ParticleSystem&& other);
+        /* Destructor for the ParticleSystem class. */
+        ~ParticleSystem();
+
+        /* Binds the given buffers with the parameters and the emitters, and the particles & counters, to the given descriptor set, which has to have the simulate layout. */
+        void bind(const Rendering::DescriptorSet* set, Rendering::Buffer* params, Rendering::Buffer* emitters) const;
+        /* Schedules simulating a single frame with the given descriptor set on the given command buffer, spawning the given number of particles, before the render pass that draws them. Also makes sure the counters can be read by indirect draws, vertex shaders and transfers afterwards. */
+        void schedule_update(const Rendering::CommandBuffer* cmd, const Rendering::DescriptorSet* set, uint32_t n_emit);
+
+        /* Returns the layout of the descriptor set to simulate with. */
+        inline const Rendering::DescriptorSetLayout& simulate_layout() const { return this->_simulate_layout; }
+        /* Returns the layout of the descriptor set to draw with. */
+        inline const Rendering::DescriptorSetLayout& draw_layout() const { return this->_draw_layout; }
+        /* Returns the descriptor set to draw with. */
+        inline const Rendering::DescriptorSet* draw_set() const { return this->_draw_set; }
+        /* Returns the buffer with the counters, which starts with the VkDrawIndirectCommand that draws the particles. */
+        inline const Rendering::Buffer* counters() const { return this->counters_buffer; }
+        /* Returns the number of particles that can be alive at once. */
+        inline uint32_t capacity() const { return this->_capacity; }
+        /* Returns the reference that follows the number of living particles on the CPU, or a nullptr if the simulation isn't checked. */
+        inline Rendering::ParticleReference* reference() { return this->_reference; }
+
+        /* Copy assignment operator for the ParticleSystem class, which is deleted. */
+        ParticleSystem& operator=(const ParticleSystem& other) = delete;
+        /* Move assignment operator for the ParticleSystem class. */
+        inline ParticleSystem& operator=(ParticleSystem&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the ParticleSystem class. */
+        friend void swap(ParticleSystem& ps1, ParticleSystem& ps2);
+
+    };
+
+    /* Swap operator for the ParticleSystem class. */
+    void swap(ParticleSystem& ps1, ParticleSystem& ps2);
+
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   20/06/2021, 12:29:37
  * Last edited:
- *   8/1/2021, 3:48:45 PM
+ *   19/10/2026, 03:23:40
  * Auto updated?
  *   Yes
  *
@@ -13,6 +13,8 @@
  *   rendering process.
 **/
 
+#include <algorithm>
+
 #include "tools/Logger.hpp"
 
 #include "Pipeline.hpp"
@@ -23,20 +25,29 @@ using namespace Makma3D::Rendering;
 
 
 /***** PIPELINE CLASS *****/
-/* Constructor for the Pipeline class, which takes a GPU where it lives, the VkPipeline to wrap and its matching layout. */
-Pipeline::Pipeline(const Rendering::GPU& gpu, const VkPipeline& vk_pipeline, const VkPipelineLayout& vk_pipeline_layout) :
+/* Constructor for the Pipeline class, which takes a GPU where it lives, the VkPipeline to wrap, its matching layout and the definition of that layout. */
+Pipeline::Pipeline(const Rendering::GPU& gpu, const VkPipeline& vk_pipeline, const VkPipelineLayout& vk_pipeline_layout, const Rendering::PipelineLayout& pipeline_layout) :
     gpu(gpu),
 
     vk_pipeline(vk_pipeline),
-    vk_pipeline_layout(vk_pipeline_layout)
-{}
+    vk_pipeline_layout(vk_pipeline_layout),
+    set_keys(pipeline_layout.descriptor_layouts.size()),
+    push_ranges(pipeline_layout.get_ranges())
+{
+    // Remember what defines each set layout, so we can tell compatible layouts apart from the others without keeping the set layouts around
+    for (uint32_t i = 0; i < pipeline_layout.descriptor_layouts.size(); i++) {
+        this->set_keys.push_back(pipeline_layout.descriptor_layouts[i].key());
+    }
+}
 
 /* Move constructor for the Pipeline class, which is deleted. */
 Pipeline::Pipeline(Pipeline&& other) :
     gpu(other.gpu),
 
     vk_pipeline(other.vk_pipeline),
-    vk_pipeline_layout(other.vk_pipeline_layout)
+    vk_pipeline_layout(other.vk_pipeline_layout),
+    set_keys(std::move(other.set_keys)),
+    push_ranges(std::move(other.push_ranges))
 {
     other.vk_pipeline = nullptr;
     other.vk_pipeline_layout = nullptr;
@@ -54,6 +65,27 @@ Pipeline::~Pipeline() {
 
 
 
+/* Returns the number of descriptor sets bound while the given pipeline was bound that stay bound after binding this one, i.e., the sets for which both layouts are compatible. */
+uint32_t Pipeline::compatible_sets(const Pipeline& other) const {
+    // Layouts with different push constant ranges aren't compatible for any set
+    if (this->push_ranges.size() != other.push_ranges.size()) { return 0; }
+    for (uint32_t i = 0; i < this->push_ranges.size(); i++) {
+        const VkPushConstantRange& range = this->push_ranges[i];
+        const VkPushConstantRange& other_range = other.push_ranges[i];
+        if (range.stageFlags != other_range.stageFlags || range.offset != other_range.offset || range.size != other_range.size) { return 0; }
+    }
+
+    // Otherwise, they're compatible up to the first set whose layouts are defined differently
+    uint32_t n_sets = static_cast<uint32_t>(std::min(this->set_keys.size(), other.set_keys.size()));
+    uint32_t n_compatible = 0;
+    while (n_compatible < n_sets && this->set_keys[n_compatible] == other.set_keys[n_compatible]) {
+        ++n_compatible;
+    }
+    return n_compatible;
+}
+
+
+
 /* Swap operator for the Pipeline class. */
 void Rendering::swap(Pipeline& p1, Pipeline& p2) {
     #ifndef NDEBUG
@@ -64,4 +96,6 @@ void Rendering::swap(Pipeline& p1, Pipeline& p2) {
 
     swap(p1.vk_pipeline, p2.vk_pipeline);
     swap(p1.vk_pipeline_layout, p2.vk_pipeline_layout);
+    swap(p1.set_keys, p2.set_keys);
+    swap(p1.push_ranges, p2.push_ranges);
 }
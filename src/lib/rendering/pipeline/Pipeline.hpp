@@ -4,7 +4,7 @@
  * Created:
  *   20/06/2021, 12:29:41
  * Last edited:
- *   28/06/2021, 22:26:49
+ *   19/10/2026, 03:23:40
  * Auto updated?
  *   Yes
  *
@@ -19,6 +19,8 @@
 #include "tools/Array.hpp"
 #include "../gpu/GPU.hpp"
 #include "../commandbuffers/CommandBuffer.hpp"
+#include "../memory/Buffer.hpp"
+#include "properties/PipelineLayout.hpp"
 
 namespace Makma3D::Rendering {
     /* The Pipeline class, which functions a as a more convenient wrapper for the internal VkPipeline object. */
@@ -35,13 +37,17 @@ namespace Makma3D::Rendering {
         VkPipeline vk_pipeline;
         /* The layout of the pipeline. */
         VkPipelineLayout vk_pipeline_layout;
+        /* The key of each descriptor set layout in the pipeline's layout, which tells which sets stay bound when switching pipelines. */
+        Tools::Array<uint64_t> set_keys;
+        /* The push constant ranges in the pipeline's layout, which have to match for any set to stay bound when switching pipelines. */
+        Tools::Array<VkPushConstantRange> push_ranges;
 
         /* Mark the PipelineConstructor as a friend. */
         friend class PipelineConstructor;
 
 
-        /* Constructor for the Pipeline class, which takes a GPU where it lives, the VkPipeline to wrap and its matching layout. */
-        Pipeline(const Rendering::GPU& gpu, const VkPipeline& vk_pipeline, const VkPipelineLayout& vk_pipeline_layout);
+        /* Constructor for the Pipeline class, which takes a GPU where it lives, the VkPipeline to wrap, its matching layout and the definition of that layout. */
+        Pipeline(const Rendering::GPU& gpu, const VkPipeline& vk_pipeline, const VkPipelineLayout& vk_pipeline_layout, const Rendering::PipelineLayout& pipeline_layout);
 
     public:
         /* Copy constructor for the Pipeline class, which is deleted. */
@@ -61,6 +67,17 @@ namespace Makma3D::Rendering {
         inline void schedule_draw(const Rendering::CommandBuffer* cmd, uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex = 0, uint32_t first_instance = 0) const { vkCmdDraw(cmd->vulkan(), vertex_count, instance_count, first_vertex, first_instance); }
         /* Schedules an indexed draw for this pipeline with the given number of indices and the given number of instances. Optionally, an offset can be given in any of the three arrays. */
         inline void schedule_idraw(const Rendering::CommandBuffer* cmd, uint32_t index_count, uint32_t instance_count, uint32_t first_vertex = 0, uint32_t first_index = 0, uint32_t first_instance = 0) const { vkCmdDrawIndexed(cmd->vulkan(), index_count, instance_count, first_index, first_vertex, first_instance); }
+        /* Schedules the given number of indexed draws for this pipeline, whose parameters are read from VkDrawIndexedIndirectCommands in the given buffer (starting at the given offset, in bytes) when the draws are executed. */
+        inline void schedule_idraw_indirect(const Rendering::CommandBuffer* cmd, const Rendering::Buffer* buffer, VkDeviceSize offset, uint32_t draw_count = 1) const { vkCmdDrawIndexedIndirect(cmd->vulkan(), buffer->vulkan(), offset, draw_count, sizeof(VkDrawIndexedIndirectCommand)); }
+        /* Schedules the given number of non-indexed draws for this pipeline, whose parameters are read from VkDrawIndirectCommands in the given buffer (starting at the given offset, in bytes) when the draws are executed. */
+        inline void schedule_draw_indirect(const Rendering::CommandBuffer* cmd, const Rendering::Buffer* buffer, VkDeviceSize offset, uint32_t draw_count = 1) const { vkCmdDrawIndirect(cmd->vulkan(), buffer->vulkan(), offset, draw_count, sizeof(VkDrawIndirectCommand)); }
+        /* Schedules the given number of workgroups in each dimension for this (compute) pipeline. */
+        inline void schedule_dispatch(const Rendering::CommandBuffer* cmd, uint32_t n_groups_x, uint32_t n_groups_y = 1, uint32_t n_groups_z = 1) const { vkCmdDispatch(cmd->vulkan(), n_groups_x, n_groups_y, n_groups_z); }
+        /* Schedules a dispatch for this (compute) pipeline, whose number of workgroups is read from a VkDispatchIndirectCommand in the given buffer (at the given offset, in bytes) when the dispatch is executed. */
+        inline void schedule_dispatch_indirect(const Rendering::CommandBuffer* cmd, const Rendering::Buffer* buffer, VkDeviceSize offset) const { vkCmdDispatchIndirect(cmd->vulkan(), buffer->vulkan(), offset); }
+
+        /* Returns the number of descriptor sets bound while the given pipeline was bound that stay bound after binding this one, i.e., the sets for which both layouts are compatible. */
+        uint32_t compatible_sets(const Pipeline& other) const;
 
         /* Expliticly returns the internal VkPipelineLayout object. */
         inline const VkPipelineLayout& layout() const { return this->vk_pipeline_layout; }
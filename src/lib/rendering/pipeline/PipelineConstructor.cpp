@@ -4,7 +4,7 @@
  * Created:
  *   18/09/2021, 11:41:08
  * Last edited:
- *   18/09/2021, 11:41:08
+ *   19/10/2026, 03:23:40
  * Auto updated?
  *   Yes
  *
@@ -47,6 +47,7 @@ PipelineConstructor::PipelineConstructor(const PipelineConstructor& other) :
     rasterization(other.rasterization),
     multisampling(other.multisampling),
     color_logic(other.color_logic),
+    dynamic_state(other.dynamic_state),
     pipeline_layout(other.pipeline_layout)
 {}
 
@@ -65,6 +66,7 @@ PipelineConstructor::PipelineConstructor(PipelineConstructor&& other) :
     rasterization(std::move(other.rasterization)),
     multisampling(std::move(other.multisampling)),
     color_logic(std::move(other.color_logic)),
+    dynamic_state(std::move(other.dynamic_state)),
     pipeline_layout(std::move(other.pipeline_layout))
 {}
 
@@ -87,6 +89,7 @@ Rendering::Pipeline* PipelineConstructor::construct(const Rendering::RenderPass&
         this->rasterization,
         this->multisampling,
         this->color_logic,
+        this->dynamic_state,
         this->pipeline_layout,
         render_pass, first_subpass,
         this->base_pipeline != nullptr ? this->base_pipeline->vulkan() : VK_NULL_HANDLE, -1,
@@ -107,7 +110,7 @@ Rendering::Pipeline* PipelineConstructor::construct(const Rendering::RenderPass&
     }
 
     // Wrap it in a Pipeline class and we're as good as done
-    return new Pipeline(this->gpu, vk_pipeline, vk_pipeline_layout);
+    return new Pipeline(this->gpu, vk_pipeline, vk_pipeline_layout, this->pipeline_layout);
 }
 
 /* Creates N new Pipelines with the internal properties and the given RenderPass & first subpass. Optionally takes create flags for the VkPipeline, too. */
@@ -124,6 +127,7 @@ Tools::Array<Rendering::Pipeline*> PipelineConstructor::nconstruct(uint32_t N, c
         this->rasterization,
         this->multisampling,
         this->color_logic,
+        this->dynamic_state,
         this->pipeline_layout,
         render_pass, first_subpass,
         this->base_pipeline != nullptr ? this->base_pipeline->vulkan() : VK_NULL_HANDLE, -1,
@@ -154,7 +158,7 @@ Tools::Array<Rendering::Pipeline*> PipelineConstructor::nconstruct(uint32_t N, c
     // Wrap it in a list of Pipeline classes
     Tools::Array<Rendering::Pipeline*> result(N);
     for (uint32_t i = 0; i < N; i++) {
-        result.push_back(new Pipeline(this->gpu, vk_pipelines[i], vk_pipeline_layouts[i]));
+        result.push_back(new Pipeline(this->gpu, vk_pipelines[i], vk_pipeline_layouts[i], this->pipeline_layout));
     }
 
     // Clean the remaining arrays and return
@@ -163,6 +167,43 @@ Tools::Array<Rendering::Pipeline*> PipelineConstructor::nconstruct(uint32_t N, c
     return result;
 }
 
+/* Creates a new compute Pipeline with the internal pipeline layout and the first of the internal shaders, which should be a compute shader. All other properties are ignored. Optionally takes create flags for the VkPipeline, too. */
+Rendering::Pipeline* PipelineConstructor::construct_compute(VkPipelineCreateFlags create_flags) const {
+    #ifndef NDEBUG
+    if (this->shaders.empty() || this->shaders[0].shader_stage != VK_SHADER_STAGE_COMPUTE_BIT) { logger.fatalc(PipelineConstructor::channel, "Cannot construct a compute pipeline without a compute shader as first shader."); }
+    #endif
+
+    VkResult vk_result;
+
+    // A compute pipeline only needs its shader and its layout
+    ShaderStageInfo shader_stage_info(this->shaders[0]);
+    PipelineLayoutInfo pipeline_layout_info(this->pipeline_layout);
+
+    // Create the pipeline layout based on its create info
+    VkPipelineLayout vk_pipeline_layout;
+    if ((vk_result = vkCreatePipelineLayout(this->gpu, pipeline_layout_info, nullptr, &vk_pipeline_layout)) != VK_SUCCESS) {
+        logger.fatalc(PipelineConstructor::channel, "Could not create compute pipeline layout: ", vk_error_map[vk_result]);
+    }
+
+    // Populate the create info for the pipeline itself
+    VkComputePipelineCreateInfo pipeline_info = {};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_info.stage = shader_stage_info;
+    pipeline_info.layout = vk_pipeline_layout;
+    pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+    pipeline_info.basePipelineIndex = -1;
+    pipeline_info.flags = create_flags;
+
+    // With the layout, we can create the pipeline
+    VkPipeline vk_pipeline;
+    if ((vk_result = vkCreateComputePipelines(this->gpu, this->pipeline_cache, 1, &pipeline_info, nullptr, &vk_pipeline)) != VK_SUCCESS) {
+        logger.fatalc(PipelineConstructor::channel, "Could not create compute pipeline: ", vk_error_map[vk_result]);
+    }
+
+    // Wrap it in a Pipeline class and we're as good as done
+    return new Pipeline(this->gpu, vk_pipeline, vk_pipeline_layout, this->pipeline_layout);
+}
+
 
 
 /* Swap operator for the PipelineConstructor class. */
@@ -184,5 +225,6 @@ void Rendering::swap(PipelineConstructor& pc1, PipelineConstructor& pc2) {
     swap(pc1.rasterization, pc2.rasterization);
     swap(pc1.multisampling, pc2.multisampling);
     swap(pc1.color_logic, pc2.color_logic);
+    swap(pc1.dynamic_state, pc2.dynamic_state);
     swap(pc1.pipeline_layout, pc2.pipeline_layout);
 }
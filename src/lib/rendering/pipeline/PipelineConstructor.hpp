@@ -4,7 +4,7 @@
  * Created:
  *   17/09/2021, 21:43:24
  * Last edited:
- *   17/09/2021, 21:43:24
+ *   19/10/2026, 01:52:32
  * Auto updated?
  *   Yes
  *
@@ -26,6 +26,7 @@
 #include "properties/InputAssemblyState.hpp"
 #include "properties/DepthTesting.hpp"
 #include "properties/ViewportTransformation.hpp"
+#include "properties/DynamicState.hpp"
 #include "properties/Rasterization.hpp"
 #include "properties/Multisampling.hpp"
 #include "properties/ColorLogic.hpp"
@@ -65,6 +66,8 @@ namespace Makma3D::Rendering {
         Rendering::Multisampling multisampling;
         /* Defines how to populate the resulting framebuffers. */
         Rendering::ColorLogic color_logic;
+        /* Defines which state isn't baked into the pipeline but set while recording instead. */
+        Rendering::DynamicState dynamic_state;
         /* Defines the layout of the pipeline in terms of descriptors and push constants. */
         Rendering::PipelineLayout pipeline_layout;
 
@@ -85,6 +88,8 @@ namespace Makma3D::Rendering {
         Rendering::Pipeline* construct(const Rendering::RenderPass& render_pass, uint32_t first_subpass, VkPipelineCreateFlags create_flags = 0) const;
         /* Creates N new Pipelines with the internal properties and the given RenderPass & first subpass. Optionally takes create flags for the VkPipeline, too. */
         Tools::Array<Rendering::Pipeline*> nconstruct(uint32_t N, const Rendering::RenderPass& render_pass, uint32_t first_subpass, VkPipelineCreateFlags create_flags = 0) const;
+        /* Creates a new compute Pipeline with the internal pipeline layout and the first of the internal shaders, which should be a compute shader. All other properties are ignored. Optionally takes create flags for the VkPipeline, too. */
+        Rendering::Pipeline* construct_compute(VkPipelineCreateFlags create_flags = 0) const;
 
         /* Copy assignment operator for the PipelineConstructor class. */
         inline PipelineConstructor& operator=(const PipelineConstructor& other) { return *this = PipelineConstructor(other); }
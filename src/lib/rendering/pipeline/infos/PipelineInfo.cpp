@@ -4,7 +4,7 @@
  * Created:
  *   19/09/2021, 15:48:27
  * Last edited:
- *   9/19/2021, 6:03:45 PM
+ *   19/10/2026, 00:55:15
  * Auto updated?
  *   Yes
  *
@@ -36,6 +36,7 @@ static void populate_pipeline_info(VkGraphicsPipelineCreateInfo& pipeline_info,
                                    const VkPipelineRasterizationStateCreateInfo* vk_rasterization,
                                    const VkPipelineMultisampleStateCreateInfo* vk_multisampling,
                                    const VkPipelineColorBlendStateCreateInfo* vk_color_logic,
+                                   const VkPipelineDynamicStateCreateInfo* vk_dynamic_state,
                                    const VkRenderPass& vk_render_pass, uint32_t first_subpass,
                                    const VkPipeline& vk_base_handle, int32_t base_index,
                                    VkPipelineCreateFlags create_flags)
@@ -56,7 +57,7 @@ static void populate_pipeline_info(VkGraphicsPipelineCreateInfo& pipeline_info,
     pipeline_info.pRasterizationState = vk_rasterization;
     pipeline_info.pMultisampleState = vk_multisampling;
     pipeline_info.pColorBlendState = vk_color_logic;
-    pipeline_info.pDynamicState = nullptr;
+    pipeline_info.pDynamicState = vk_dynamic_state;
 
     // We don't set the layout yet, but wait until it's created
     pipeline_info.layout = nullptr;
@@ -88,6 +89,7 @@ static void populate_pipeline_info(VkGraphicsPipelineCreateInfo& pipeline_info,
  * @param rasterization What to do during the rasterization stage.
  * @param multisampling How the pipeline should deal with multisampling.
  * @param color_logic How to deal with pixels already present in the target framebuffer(s).
+ * @param dynamic_state Which state is not baked into the pipeline but set while recording instead.
  * @param pipeline_layout How the data in the pipeline looks like, in terms of descriptors and push constants.
  * @param render_pass The RenderPass to which to bind the PipelineInfo.
  * @param first_subpass The index of the first subpass that should be executed.
@@ -103,6 +105,7 @@ PipelineInfo::PipelineInfo(const Tools::Array<Rendering::ShaderStage>& shaders,
                            const Rendering::Rasterization& rasterization,
                            const Rendering::Multisampling& multisampling,
                            const Rendering::ColorLogic& color_logic,
+                           const Rendering::DynamicState& dynamic_state,
                            const Rendering::PipelineLayout& pipeline_layout,
                            const Rendering::RenderPass& render_pass, uint32_t first_subpass,
                            const VkPipeline& vk_base_handle, int32_t base_index,
@@ -110,7 +113,8 @@ PipelineInfo::PipelineInfo(const Tools::Array<Rendering::ShaderStage>& shaders,
     shader_stage_infos(shaders.size()),
     vertex_input_state_info(vertex_input_state),
     color_logic_info(color_logic),
-    pipeline_layout_info(pipeline_layout)
+    pipeline_layout_info(pipeline_layout),
+    dynamic_state(dynamic_state)
 {
     // Initialize the list of shader stage infos first, immediately casting to to the vklist
     this->vk_shader_stage_infos = new VkPipelineShaderStageCreateInfo[shaders.size()];
@@ -128,6 +132,7 @@ PipelineInfo::PipelineInfo(const Tools::Array<Rendering::ShaderStage>& shaders,
     this->vk_multisampling_info = new VkPipelineMultisampleStateCreateInfo(multisampling.get_info());
     this->vk_color_logic_info = &this->color_logic_info.vulkan();
     this->vk_pipeline_layout_info =&this->pipeline_layout_info.vulkan();
+    this->vk_dynamic_state_info = this->dynamic_state.states.empty() ? nullptr : new VkPipelineDynamicStateCreateInfo(this->dynamic_state.get_info());
 
     // With all that, we can try to populate the graphics pipeline info (at least for so far)
     populate_pipeline_info(
@@ -140,6 +145,7 @@ PipelineInfo::PipelineInfo(const Tools::Array<Rendering::ShaderStage>& shaders,
         this->vk_rasterization_info,
         this->vk_multisampling_info,
         this->vk_color_logic_info,
+        this->vk_dynamic_state_info,
         render_pass.vulkan(), first_subpass,
         vk_base_handle, base_index,
         create_flags
@@ -152,6 +158,7 @@ PipelineInfo::PipelineInfo(const PipelineInfo& other) :
     vertex_input_state_info(other.vertex_input_state_info),
     color_logic_info(other.color_logic_info),
     pipeline_layout_info(other.pipeline_layout_info),
+    dynamic_state(other.dynamic_state),
 
     vk_pipeline_info(other.vk_pipeline_info)
 {
@@ -170,6 +177,8 @@ PipelineInfo::PipelineInfo(const PipelineInfo& other) :
     this->vk_multisampling_info = new VkPipelineMultisampleStateCreateInfo(*other.vk_multisampling_info);
     this->vk_color_logic_info = &this->color_logic_info.vulkan();
     this->vk_pipeline_layout_info = &this->pipeline_layout_info.vulkan();
+    // The dynamic state info refers to the list of states, so re-generate it from our own copy
+    this->vk_dynamic_state_info = this->dynamic_state.states.empty() ? nullptr : new VkPipelineDynamicStateCreateInfo(this->dynamic_state.get_info());
 
     // Update the pointers in the pipeline info
     this->vk_pipeline_info.pStages = this->vk_shader_stage_infos;
@@ -180,7 +189,7 @@ PipelineInfo::PipelineInfo(const PipelineInfo& other) :
     this->vk_pipeline_info.pRasterizationState = this->vk_rasterization_info;
     this->vk_pipeline_info.pMultisampleState = this->vk_multisampling_info;
     this->vk_pipeline_info.pColorBlendState = this->vk_color_logic_info;
-    this->vk_pipeline_info.pDynamicState = nullptr;
+    this->vk_pipeline_info.pDynamicState = this->vk_dynamic_state_info;
 }
 
 /* Move constructor for the PipelineInfo class. */
@@ -189,6 +198,7 @@ PipelineInfo::PipelineInfo(PipelineInfo&& other) :
     vertex_input_state_info(other.vertex_input_state_info),
     color_logic_info(other.color_logic_info),
     pipeline_layout_info(other.pipeline_layout_info),
+    dynamic_state(other.dynamic_state),
 
     vk_shader_stage_infos(other.vk_shader_stage_infos),
     vk_vertex_input_state_info(other.vk_vertex_input_state_info),
@@ -198,10 +208,17 @@ PipelineInfo::PipelineInfo(PipelineInfo&& other) :
     vk_rasterization_info(other.vk_rasterization_info),
     vk_multisampling_info(other.vk_multisampling_info),
     vk_color_logic_info(other.vk_color_logic_info),
+    vk_dynamic_state_info(nullptr),
     vk_pipeline_layout_info(other.vk_pipeline_layout_info),
 
     vk_pipeline_info(other.vk_pipeline_info)
 {
+    // The dynamic state info refers to the other's list of states, so re-generate it from our own copy
+    if (other.vk_dynamic_state_info != nullptr) {
+        this->vk_dynamic_state_info = new VkPipelineDynamicStateCreateInfo(this->dynamic_state.get_info());
+    }
+    this->vk_pipeline_info.pDynamicState = this->vk_dynamic_state_info;
+
     // Prevent everything from deallocating
     other.vk_shader_stage_infos = nullptr;
     other.vk_input_assembly_state_info = nullptr;
@@ -215,6 +232,7 @@ PipelineInfo::PipelineInfo(PipelineInfo&& other) :
 PipelineInfo::~PipelineInfo() {
     // The vk_pipeline_layout_info is managed by our internal pipeline_layout_info
     // The vk_color_logic_info is managed by our internal color_logic_info
+    if (this->vk_dynamic_state_info != nullptr) { delete this->vk_dynamic_state_info; }
     if (this->vk_multisampling_info != nullptr) { delete this->vk_multisampling_info; }
     if (this->vk_rasterization_info != nullptr) { delete this->vk_rasterization_info; }
     if (this->vk_viewport_transformation_info != nullptr) { delete this->vk_viewport_transformation_info; }
@@ -234,6 +252,7 @@ void Rendering::swap(PipelineInfo& pi1, PipelineInfo& pi2) {
     swap(pi1.vertex_input_state_info, pi2.vertex_input_state_info);
     swap(pi1.color_logic_info, pi2.color_logic_info);
     swap(pi1.pipeline_layout_info, pi2.pipeline_layout_info);
+    swap(pi1.dynamic_state, pi2.dynamic_state);
 
     swap(pi1.vk_shader_stage_infos, pi2.vk_shader_stage_infos);
     swap(pi1.vk_vertex_input_state_info, pi2.vk_vertex_input_state_info);
@@ -243,6 +262,7 @@ void Rendering::swap(PipelineInfo& pi1, PipelineInfo& pi2) {
     swap(pi1.vk_rasterization_info, pi2.vk_rasterization_info);
     swap(pi1.vk_multisampling_info, pi2.vk_multisampling_info);
     swap(pi1.vk_color_logic_info, pi2.vk_color_logic_info);
+    swap(pi1.vk_dynamic_state_info, pi2.vk_dynamic_state_info);
     swap(pi1.vk_pipeline_layout_info, pi2.vk_pipeline_layout_info);
 
     swap(pi1.vk_pipeline_info, pi2.vk_pipeline_info);
@@ -4,7 +4,7 @@
  * Created:
  *   19/09/2021, 14:01:13
  * Last edited:
- *   19/09/2021, 14:01:13
+ *   19/10/2026, 00:55:15
  * Auto updated?
  *   Yes
  *
@@ -28,6 +28,7 @@
 #include "../properties/InputAssemblyState.hpp"
 #include "../properties/DepthTesting.hpp"
 #include "../properties/ViewportTransformation.hpp"
+#include "../properties/DynamicState.hpp"
 #include "../properties/Rasterization.hpp"
 #include "../properties/Multisampling.hpp"
 #include "../properties/ColorLogic.hpp"
@@ -54,6 +55,8 @@ namespace Makma3D::Rendering {
         Rendering::ColorLogicInfo color_logic_info;
         /* Describes what we need for the VkPipelineLayoutCreateInfo struct. */
         Rendering::PipelineLayoutInfo pipeline_layout_info;
+        /* Our own copy of the dynamic state, since the VkPipelineDynamicStateCreateInfo struct refers to its list. */
+        Rendering::DynamicState dynamic_state;
 
     public:
         /* The list of VkPipelineShaderStageCreateInfo we need to describe all the shaders bound to this pipeline. Has the same size as shader_stage_infos. */
@@ -72,6 +75,8 @@ namespace Makma3D::Rendering {
         const VkPipelineMultisampleStateCreateInfo* vk_multisampling_info;
         /* The VkPipelineColorBlendStateCreateInfo struct that describes what to do with pixels already present in the resulting framebuffer. */
         const VkPipelineColorBlendStateCreateInfo* vk_color_logic_info;
+        /* The VkPipelineDynamicStateCreateInfo struct that describes which state is set while recording instead. Is a nullptr if there is no such state. */
+        const VkPipelineDynamicStateCreateInfo* vk_dynamic_state_info;
         /* The VkPipelineLayoutCreateInfo used to create the pipeline layout for the pipeline we'll create. */
         const VkPipelineLayoutCreateInfo* vk_pipeline_layout_info;
 
@@ -89,6 +94,7 @@ namespace Makma3D::Rendering {
          * @param rasterization What to do during the rasterization stage.
          * @param multisampling How the pipeline should deal with multisampling.
          * @param color_logic How to deal with pixels already present in the target framebuffer(s).
+         * @param dynamic_state Which state is not baked into the pipeline but set while recording instead.
          * @param pipeline_layout How the data in the pipeline looks like, in terms of descriptors and push constants.
          * @param render_pass The RenderPass to which to bind the PipelineInfo.
          * @param first_subpass The index of the first subpass that should be executed.
@@ -104,6 +110,7 @@ namespace Makma3D::Rendering {
                      const Rendering::Rasterization& rasterization,
                      const Rendering::Multisampling& multisampling,
                      const Rendering::ColorLogic& color_logic,
+                     const Rendering::DynamicState& dynamic_state,
                      const Rendering::PipelineLayout& pipeline_layout,
                      const Rendering::RenderPass& render_pass, uint32_t first_subpass,
                      const VkPipeline& vk_base_handle, int32_t base_index,
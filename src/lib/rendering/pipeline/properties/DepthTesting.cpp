@@ -4,7 +4,7 @@
  * Created:
  *   11/09/2021, 17:24:35
  * Last edited:
- *   11/09/2021, 17:24:35
+ *   19/10/2026, 01:35:58
  * Auto updated?
  *   Yes
  *
@@ -27,10 +27,11 @@ DepthTesting::DepthTesting() :
     DepthTesting(VK_FALSE, VK_COMPARE_OP_MAX_ENUM)
 {}
 
-/* Constructor for the DepthTesting class, which takes that it is enabled (true_type) and the compare operation for when a new fragment needs to be tested for depth. */
-DepthTesting::DepthTesting(VkBool32 enabled, VkCompareOp compare_op) :
+/* Constructor for the DepthTesting class, which takes whether to enable depthtesting or not, the compare operation for when a new fragment needs to be tested for depth and optionally whether to write the depth of fragments that pass (only done if testing is enabled). */
+DepthTesting::DepthTesting(VkBool32 enabled, VkCompareOp compare_op, VkBool32 write) :
     enabled(enabled),
-    compare_op(compare_op)
+    compare_op(compare_op),
+    write(write)
 {}
 
 
@@ -41,9 +42,9 @@ VkPipelineDepthStencilStateCreateInfo DepthTesting::get_info() const {
     VkPipelineDepthStencilStateCreateInfo info{};
     info.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
 
-    // Set whether to test and write (which we treat as the same)
+    // Set whether to test and write. Writing without testing isn't possible, so only do that if testing is enabled
     info.depthTestEnable = this->enabled;
-    info.depthWriteEnable = this->enabled;
+    info.depthWriteEnable = this->enabled && this->write;
 
     // Define how to compare the values
     info.depthCompareOp = this->compare_op;
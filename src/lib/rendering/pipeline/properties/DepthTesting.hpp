@@ -4,7 +4,7 @@
  * Created:
  *   11/09/2021, 17:24:32
  * Last edited:
- *   11/09/2021, 17:24:32
+ *   19/10/2026, 01:35:58
  * Auto updated?
  *   Yes
  *
@@ -28,12 +28,14 @@ namespace Makma3D::Rendering {
         VkBool32 enabled;
         /* What kind of operation to perform when comparing old pixels with new ones. */
         VkCompareOp compare_op;
+        /* Whether or not to write the depth of fragments that pass the test. */
+        VkBool32 write;
     
     public:
         /* Default constructor for the DepthTesting class. */
         DepthTesting();
-        /* Constructor for the DepthTesting class, which takes whether to enable depthtesting or not and the compare operation for when a new fragment needs to be tested for depth. */
-        DepthTesting(VkBool32 enabled, VkCompareOp compare_op);
+        /* Constructor for the DepthTesting class, which takes whether to enable depthtesting or not, the compare operation for when a new fragment needs to be tested for depth and optionally whether to write the depth of fragments that pass (only done if testing is enabled). */
+        DepthTesting(VkBool32 enabled, VkCompareOp compare_op, VkBool32 write = VK_TRUE);
 
         /* Returns a VkPipelineDepthStencilStateCreateInfo populated with the internal properties. */
         VkPipelineDepthStencilStateCreateInfo get_info() const;
@@ -0,0 +1,47 @@
+/* DYNAMIC STATE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:35:08
+ * Last edited:
+ *   19/10/2026, 01:35:08
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the DynamicState class, which is a collection of properties
+ *   for a Pipeline that describe which parts of its state are not baked
+ *   in but set while recording command buffers instead.
+**/
+
+#include "DynamicState.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** DYNAMICSTATE CLASS *****/
+/* Default constructor for the DynamicState class, which makes no state dynamic. */
+DynamicState::DynamicState() {}
+
+/* Constructor for the DynamicState class, which takes the list of states that are to be set dynamically (e.g., the viewport and the scissor). */
+DynamicState::DynamicState(const Tools::Array<VkDynamicState>& states) :
+    states(states)
+{}
+
+
+
+/* Returns a VkPipelineDynamicStateCreateInfo struct populated with the internal properties. Note that it refers to the internal list, so the DynamicState has to outlive the struct. */
+VkPipelineDynamicStateCreateInfo DynamicState::get_info() const {
+    // Initialize to default
+    VkPipelineDynamicStateCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+
+    // Attach the list of states
+    info.dynamicStateCount = this->states.size();
+    info.pDynamicStates = this->states.rdata();
+
+    // Done
+    return info;
+}
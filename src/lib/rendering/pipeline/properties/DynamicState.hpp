@@ -0,0 +1,43 @@
+/* DYNAMIC STATE.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:35:12
+ * Last edited:
+ *   19/10/2026, 01:35:12
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the DynamicState class, which is a collection of properties
+ *   for a Pipeline that describe which parts of its state are not baked
+ *   in but set while recording command buffers instead.
+**/
+
+#ifndef RENDERING_DYNAMIC_STATE_HPP
+#define RENDERING_DYNAMIC_STATE_HPP
+
+#include <vulkan/vulkan.h>
+#include "tools/Array.hpp"
+
+namespace Makma3D::Rendering {
+    /* The DynamicState class, which is a collection of Pipeline properties that determine which state is set dynamically. */
+    class DynamicState {
+    public:
+        /* The list of states that are set dynamically. */
+        Tools::Array<VkDynamicState> states;
+
+    public:
+        /* Default constructor for the DynamicState class, which makes no state dynamic. */
+        DynamicState();
+        /* Constructor for the DynamicState class, which takes the list of states that are to be set dynamically (e.g., the viewport and the scissor). */
+        DynamicState(const Tools::Array<VkDynamicState>& states);
+
+        /* Returns a VkPipelineDynamicStateCreateInfo struct populated with the internal properties. Note that it refers to the internal list, so the DynamicState has to outlive the struct. */
+        VkPipelineDynamicStateCreateInfo get_info() const;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+/* BENCHMARK REPORT.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:22:38
+ * Last edited:
+ *   19/10/2026, 01:25:01
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the BenchmarkReport class, which collects the frame times of
+ *   a benchmark run and writes them, together with the GPU timings and
+ *   memory pool usage, as a JSON report that can be compared across
+ *   commits.
+**/
+
+#include <fstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "tools/Logger.hpp"
+
+#include "BenchmarkReport.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns the given percentile (0-100) of the given, sorted values using the nearest-rank method. */
+static uint64_t percentile(const std::vector<uint64_t>& sorted, uint32_t p) {
+    if (sorted.empty()) { return 0; }
+    size_t rank = (sorted.size() * p + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/* Writes the mean, p50, p95, p99 and max of the given values as a JSON object to the given stream. */
+static void write_distribution(std::ostream& os, std::vector<uint64_t> values) {
+    std::sort(values.begin(), values.end());
+    double total = 0.0;
+    for (size_t i = 0; i < values.size(); i++) { total += (double) values[i]; }
+    double mean = values.empty() ? 0.0 : total / (double) values.size();
+    os << "{ \"mean\": " << mean << ", \"p50\": " << percentile(values, 50) << ", \"p95\": " << percentile(values, 95) << ", \"p99\": " << percentile(values, 99) << ", \"max\": " << (values.empty() ? 0 : values.back()) << " }";
+}
+
+/* Writes the given string as a JSON string to the given stream, quotes included. */
+static void write_json_string(std::ostream& os, const std::string& str) {
+    os << '"';
+    for (size_t i = 0; i < str.size(); i++) {
+        if (str[i] == '"' || str[i] == '\\') { os << '\\' << str[i]; }
+        else if ((unsigned char) str[i] < 0x20) { os << ' '; }
+        else { os << str[i]; }
+    }
+    os << '"';
+}
+
+
+
+
+
+/***** BENCHMARKREPORT CLASS *****/
+/* Default constructor for the BenchmarkReport class. */
+BenchmarkReport::BenchmarkReport() {}
+
+
+
+/* Adds a frame that took the given time, of which the CPU waited the given time, and that did the given work. */
+void BenchmarkReport::add_frame(uint64_t frame_us, uint64_t wait_us, const Rendering::RenderStats& stats) {
+    this->frame_us.push_back(frame_us);
+    this->cpu_us.push_back(frame_us > wait_us ? frame_us - wait_us : 0);
+    this->wait_us.push_back(wait_us);
+    this->draws.push_back(stats.draws);
+    this->triangles.push_back(stats.triangles);
+}
+
+/* Writes the report as JSON to the given path. The name of the benchmark and the timestep are written as-is, the GPU statistics only if they're given (i.e., not a nullptr) and the memory usage of the given MemoryManager's pools. Returns whether it succeeded. */
+bool BenchmarkReport::write(const std::string& path, const std::string& name, double timestep_ms, const Rendering::GpuStats* gpu_stats, const Rendering::MemoryManager& memory_manager) const {
+    // Try to open the file
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) {
+        logger.warningc(BenchmarkReport::channel, "Could not open report file '", path, "': ", strerror(errno));
+        return false;
+    }
+
+    // Write what we benchmarked
+    ofs << "{" << endl;
+    ofs << "    \"benchmark\": ";
+    write_json_string(ofs, name);
+    ofs << "," << endl;
+    ofs << "    \"frames\": " << this->frame_us.size() << "," << endl;
+    ofs << "    \"timestep_ms\": " << timestep_ms << "," << endl;
+
+    // Write the CPU timings
+    ofs << "    \"frame_time_us\": ";
+    write_distribution(ofs, this->frame_us);
+    ofs << "," << endl << "    \"cpu_time_us\": ";
+    write_distribution(ofs, this->cpu_us);
+    ofs << "," << endl << "    \"wait_time_us\": ";
+    write_distribution(ofs, this->wait_us);
+    ofs << "," << endl << "    \"draws\": ";
+    write_distribution(ofs, this->draws);
+    ofs << "," << endl << "    \"triangles\": ";
+    write_distribution(ofs, this->triangles);
+    ofs << "," << endl;
+
+    // Write the GPU timings, if we have them
+    if (gpu_stats != nullptr) {
+        ofs << "    \"gpu_time_us\": { \"frames\": " << gpu_stats->n_frames << ", \"mean\": " << gpu_stats->avg_pass_us() << ", \"max\": " << gpu_stats->max_pass_us << ", \"buckets\": {";
+        for (uint32_t i = 0; i < gpu_stats->buckets.size(); i++) {
+            ofs << (i > 0 ? ", " : " ");
+            write_json_string(ofs, gpu_stats->buckets[i].name);
+            ofs << ": { \"mean\": " << gpu_stats->avg_bucket_us(i) << ", \"max\": " << gpu_stats->buckets[i].max_us << " }";
+        }
+        ofs << " } }," << endl;
+    } else {
+        ofs << "    \"gpu_time_us\": null," << endl;
+    }
+
+    // Write the memory usage
+    ofs << "    \"memory\": {" << endl;
+    ofs << "        \"draw_pool\": { \"used\": " << memory_manager.draw_pool.size() << ", \"capacity\": " << memory_manager.draw_pool.capacity() << " }," << endl;
+    ofs << "        \"stage_pool\": { \"used\": " << memory_manager.stage_pool.size() << ", \"capacity\": " << memory_manager.stage_pool.capacity() << " }" << endl;
+    ofs << "    }" << endl;
+    ofs << "}" << endl;
+    ofs.close();
+
+    // Done
+    logger.logc(Verbosity::important, BenchmarkReport::channel, "Wrote report of ", this->frame_us.size(), " frames to '", path, "'");
+    return true;
+}
@@ -0,0 +1,66 @@
+/* BENCHMARK REPORT.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:22:38
+ * Last edited:
+ *   19/10/2026, 01:25:01
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the BenchmarkReport class, which collects the frame times of
+ *   a benchmark run and writes them, together with the GPU timings and
+ *   memory pool usage, as a JSON report that can be compared across
+ *   commits.
+**/
+
+#ifndef RENDERING_BENCHMARK_REPORT_HPP
+#define RENDERING_BENCHMARK_REPORT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../memory_manager/MemoryManager.hpp"
+
+#include "GpuProfiler.hpp"
+#include "RenderStats.hpp"
+
+namespace Makma3D::Rendering {
+    /* The BenchmarkReport class, which gathers the timings of a benchmark run and writes them as JSON. */
+    class BenchmarkReport {
+    public:
+        /* Channel name for the BenchmarkReport class. */
+        static constexpr const char* channel = "BenchmarkReport";
+
+    private:
+        /* The wall-clock time of each frame, in microseconds. */
+        std::vector<uint64_t> frame_us;
+        /* The time the CPU was busy in each frame (i.e., the frame time minus the time spent waiting for the GPU or the swapchain), in microseconds. */
+        std::vector<uint64_t> cpu_us;
+        /* The time the CPU waited on the GPU or the swapchain in each frame, in microseconds. */
+        std::vector<uint64_t> wait_us;
+        /* The number of draws in each frame. */
+        std::vector<uint64_t> draws;
+        /* The number of triangles in each frame. */
+        std::vector<uint64_t> triangles;
+
+    public:
+        /* Default constructor for the BenchmarkReport class. */
+        BenchmarkReport();
+
+        /* Adds a frame that took the given time, of which the CPU waited the given time, and that did the given work. */
+        void add_frame(uint64_t frame_us, uint64_t wait_us, const Rendering::RenderStats& stats);
+
+        /* Writes the report as JSON to the given path. The name of the benchmark and the timestep are written as-is, the GPU statistics only if they're given (i.e., not a nullptr) and the memory usage of the given MemoryManager's pools. Returns whether it succeeded. */
+        bool write(const std::string& path, const std::string& name, double timestep_ms, const Rendering::GpuStats* gpu_stats, const Rendering::MemoryManager& memory_manager) const;
+
+        /* Returns the number of frames in the report. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->frame_us.size()); }
+
+    };
+
+}
+
+#endif
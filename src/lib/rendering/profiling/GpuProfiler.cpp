@@ -0,0 +1,321 @@
+/* GPU PROFILER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:14:46
+ * Last edited:
+ *   19/10/2026, 02:29:42
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GpuProfiler class, which measures how long the GPU
+ *   spends on the render pass and on each bucket of draws (i.e., each
+ *   material type) using timestamp queries, and optionally counts the
+ *   shader invocations of each bucket using pipeline statistics
+ *   queries. The results are read back frames-in-flight frames later,
+ *   once they're known to be done, so profiling never stalls the GPU.
+**/
+
+#include <algorithm>
+
+#include "tools/Logger.hpp"
+#include "../auxillary/ErrorCodes.hpp"
+
+#include "GpuProfiler.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** CONSTANTS *****/
+/* The pipeline statistics we collect per segment. Their results are returned in the order of their bits. */
+static constexpr const VkQueryPipelineStatisticFlags statistic_flags = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+/* The number of values in a single pipeline statistics query result, without availability. */
+static constexpr const uint32_t n_statistics = 2;
+
+
+
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given VkQueryPoolCreateInfo struct to create a pool with the given number of queries of the given type. */
+static void populate_query_pool_info(VkQueryPoolCreateInfo& query_pool_info, VkQueryType vk_query_type, uint32_t n_queries, VkQueryPipelineStatisticFlags vk_statistics = 0) {
+    // Set to default
+    query_pool_info = {};
+    query_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+
+    // Set the type and the number of queries
+    query_pool_info.queryType = vk_query_type;
+    query_pool_info.queryCount = n_queries;
+
+    // Set which statistics to collect, if any
+    query_pool_info.pipelineStatistics = vk_statistics;
+}
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Creates a query pool with the given number of queries of the given type on the given GPU. */
+static VkQueryPool create_query_pool(const Rendering::GPU& gpu, VkQueryType vk_query_type, uint32_t n_queries, VkQueryPipelineStatisticFlags vk_statistics = 0) {
+    // Prepare the create info
+    VkQueryPoolCreateInfo query_pool_info;
+    populate_query_pool_info(query_pool_info, vk_query_type, n_queries, vk_statistics);
+
+    // Create the pool
+    VkQueryPool vk_query_pool;
+    VkResult vk_result;
+    if ((vk_result = vkCreateQueryPool(gpu, &query_pool_info, nullptr, &vk_query_pool)) != VK_SUCCESS) {
+        logger.fatalc(GpuProfiler::channel, "Could not create query pool: ", vk_error_map[vk_result]);
+    }
+
+    // Done
+    return vk_query_pool;
+}
+
+
+
+
+
+/***** GPUPROFILER CLASS *****/
+/* Constructor for the GpuProfiler class, which takes the GPU where it lives, the number of slots (which should be the number of frames in flight), the maximum number of chunks the scene may be recorded in, the names of the buckets to measure and whether or not to collect pipeline statistics as well. */
+GpuProfiler::GpuProfiler(const Rendering::GPU& gpu, uint32_t n_slots, uint32_t max_chunks, const Tools::Array<std::string>& bucket_names, bool pipeline_statistics) :
+    gpu(gpu),
+    max_chunks(max_chunks),
+    n_buckets(bucket_names.size()),
+    ns_per_tick((double) gpu.timestamp_period())
+{
+    logger.logc(Verbosity::details, GpuProfiler::channel, "Initializing profiler for ", this->n_buckets, " buckets in at most ", this->max_chunks, " chunks...");
+
+    // Only collect pipeline statistics if the GPU can
+    if (pipeline_statistics && !this->gpu.supports_pipeline_statistics()) {
+        logger.warningc(GpuProfiler::channel, "GPU does not support pipeline statistics queries; only measuring time.");
+        pipeline_statistics = false;
+    }
+
+    // Create the query pools for each slot
+    this->slots.reserve(n_slots);
+    for (uint32_t i = 0; i < n_slots; i++) {
+        VkQueryPool timestamps = create_query_pool(this->gpu, VK_QUERY_TYPE_TIMESTAMP, 2 + 2 * this->_n_segments());
+        VkQueryPool statistics = pipeline_statistics ? create_query_pool(this->gpu, VK_QUERY_TYPE_PIPELINE_STATISTICS, this->_n_segments(), statistic_flags) : VK_NULL_HANDLE;
+        this->slots.push_back(Slot{ timestamps, statistics, 0, false });
+    }
+
+    // Prepare the statistics for each bucket
+    this->_stats = {};
+    this->_stats.buckets.reserve(this->n_buckets);
+    for (uint32_t i = 0; i < this->n_buckets; i++) {
+        this->_stats.buckets.push_back(GpuBucketStats{ bucket_names[i], 0.0, 0.0, 0.0, 0, 0 });
+    }
+}
+
+/* Move constructor for the GpuProfiler class. */
+GpuProfiler::GpuProfiler(GpuProfiler&& other) :
+    gpu(other.gpu),
+    max_chunks(other.max_chunks),
+    n_buckets(other.n_buckets),
+    ns_per_tick(other.ns_per_tick),
+    slots(std::move(other.slots)),
+    results(std::move(other.results)),
+    _stats(std::move(other._stats))
+{
+    // Array's move guarantees that the other's slots are empty after a move constructor
+}
+
+/* Destructor for the GpuProfiler class. */
+GpuProfiler::~GpuProfiler() {
+    for (uint32_t i = 0; i < this->slots.size(); i++) {
+        if (this->slots[i].statistics != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(this->gpu, this->slots[i].statistics, nullptr);
+        }
+        vkDestroyQueryPool(this->gpu, this->slots[i].timestamps, nullptr);
+    }
+}
+
+
+
+/* Private helper function that reads the results of the given slot and adds them to the statistics. */
+void GpuProfiler::_read_slot(const Slot& slot) {
+    // Read the timestamps with their availability, since segments that weren't drawn this frame are never written. That means we may get VK_NOT_READY, even though all written queries are done
+    uint32_t n_timestamps = 2 + 2 * this->_n_segments();
+    this->results.reserve_opt(2 * n_timestamps);
+    VkResult vk_result = vkGetQueryPoolResults(this->gpu, slot.timestamps, 0, n_timestamps, 2 * n_timestamps * sizeof(uint64_t), this->results.wdata(2 * n_timestamps), 2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (vk_result != VK_SUCCESS && vk_result != VK_NOT_READY) {
+        logger.fatalc(GpuProfiler::channel, "Could not read timestamp queries: ", vk_error_map[vk_result]);
+    }
+
+    // Skip the frame if the render pass itself wasn't measured
+    const uint64_t* timestamps = this->results.rdata();
+    if (timestamps[1] == 0 || timestamps[3] == 0) {
+        logger.logc(Verbosity::debug, GpuProfiler::channel, "Timestamps for frame ", slot.frame, " not available; skipping it.");
+        return;
+    }
+
+    // Add the time of the render pass
+    double pass_us = (double) (timestamps[2] - timestamps[0]) * this->ns_per_tick / 1000.0;
+    ++this->_stats.n_frames;
+    this->_stats.pass_us += pass_us;
+    this->_stats.last_pass_us = pass_us;
+    if (pass_us > this->_stats.max_pass_us) { this->_stats.max_pass_us = pass_us; }
+
+    // Add the time of each bucket, which is the sum of its segments in all chunks
+    for (uint32_t b = 0; b < this->n_buckets; b++) {
+        double bucket_us = 0.0;
+        for (uint32_t c = 0; c < this->max_chunks; c++) {
+            const uint64_t* segment = timestamps + 4 + 4 * this->_segment(c, b);
+            if (segment[1] == 0 || segment[3] == 0) { continue; }
+            bucket_us += (double) (segment[2] - segment[0]) * this->ns_per_tick / 1000.0;
+        }
+
+        GpuBucketStats& bucket = this->_stats.buckets[b];
+        bucket.total_us += bucket_us;
+        bucket.last_us = bucket_us;
+        if (bucket_us > bucket.max_us) { bucket.max_us = bucket_us; }
+    }
+
+    // Do the same for the pipeline statistics, if we collect them
+    if (slot.statistics != VK_NULL_HANDLE) {
+        uint32_t n_queries = this->_n_segments();
+        uint32_t stride = n_statistics + 1;
+        this->results.reserve_opt(stride * n_queries);
+        vk_result = vkGetQueryPoolResults(this->gpu, slot.statistics, 0, n_queries, stride * n_queries * sizeof(uint64_t), this->results.wdata(stride * n_queries), stride * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (vk_result != VK_SUCCESS && vk_result != VK_NOT_READY) {
+            logger.fatalc(GpuProfiler::channel, "Could not read pipeline statistics queries: ", vk_error_map[vk_result]);
+        }
+
+        // Sum them per bucket
+        const uint64_t* statistics = this->results.rdata();
+        for (uint32_t b = 0; b < this->n_buckets; b++) {
+            for (uint32_t c = 0; c < this->max_chunks; c++) {
+                const uint64_t* segment = statistics + stride * this->_segment(c, b);
+                if (segment[n_statistics] == 0) { continue; }
+                this->_stats.buckets[b].vertex_invocations += segment[0];
+                this->_stats.buckets[b].fragment_invocations += segment[1];
+            }
+        }
+    }
+}
+
+
+
+/* Resets the queries of the given frame and writes the timestamp at the start of its render pass. Must be recorded in the frame's primary command buffer, before the render pass. */
+void GpuProfiler::begin_frame(uint64_t frame, const Rendering::CommandBuffer* cmd) {
+    Slot& slot = this->slots[frame % this->slots.size()];
+    #ifndef NDEBUG
+    if (slot.pending) {
+        logger.fatalc(GpuProfiler::channel, "Cannot re-use queries of frame ", slot.frame, " for frame ", frame, " before they have been collected.");
+    }
+    #endif
+
+    // Reset the queries, since they can only be written once
+    vkCmdResetQueryPool(cmd->vulkan(), slot.timestamps, 0, 2 + 2 * this->_n_segments());
+    if (slot.statistics != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(cmd->vulkan(), slot.statistics, 0, this->_n_segments());
+    }
+
+    // Mark the start of the render pass
+    vkCmdWriteTimestamp(cmd->vulkan(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.timestamps, 0);
+
+    // Remember the slot is in use
+    slot.frame = frame;
+    slot.pending = true;
+}
+
+/* Writes the timestamp at the end of the given frame's render pass. Must be recorded in the frame's primary command buffer, after the render pass. */
+void GpuProfiler::end_frame(uint64_t frame, const Rendering::CommandBuffer* cmd) {
+    vkCmdWriteTimestamp(cmd->vulkan(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, this->slots[frame % this->slots.size()].timestamps, 1);
+}
+
+/* Starts measuring the given bucket in the given chunk of the given frame, by writing a timestamp (and starting the statistics query) in the given command buffer. */
+void GpuProfiler::begin_bucket(uint64_t frame, const Rendering::CommandBuffer* cmd, uint32_t chunk, uint32_t bucket) {
+    const Slot& slot = this->slots[frame % this->slots.size()];
+    uint32_t segment = this->_segment(chunk, bucket);
+    vkCmdWriteTimestamp(cmd->vulkan(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.timestamps, 2 + 2 * segment);
+    if (slot.statistics != VK_NULL_HANDLE) {
+        vkCmdBeginQuery(cmd->vulkan(), slot.statistics, segment, 0);
+    }
+}
+
+/* Stops measuring the given bucket in the given chunk of the given frame. */
+void GpuProfiler::end_bucket(uint64_t frame, const Rendering::CommandBuffer* cmd, uint32_t chunk, uint32_t bucket) {
+    const Slot& slot = this->slots[frame % this->slots.size()];
+    uint32_t segment = this->_segment(chunk, bucket);
+    if (slot.statistics != VK_NULL_HANDLE) {
+        vkCmdEndQuery(cmd->vulkan(), slot.statistics, segment);
+    }
+    vkCmdWriteTimestamp(cmd->vulkan(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.timestamps, 2 + 2 * segment + 1);
+}
+
+/* Reads back the results of all frames that have completed, given the number of frames that have completed so far. Never waits on the GPU. Returns the number of frames read, so callers know whether the last frame's statistics are new. */
+uint32_t GpuProfiler::collect(uint64_t n_completed) {
+    // Read the slots in frame order, so the 'last' statistics are actually of the last frame
+    uint32_t n_read = 0;
+    while (true) {
+        Slot* oldest = nullptr;
+        for (uint32_t i = 0; i < this->slots.size(); i++) {
+            Slot& slot = this->slots[i];
+            if (slot.pending && slot.frame < n_completed && (oldest == nullptr || slot.frame < oldest->frame)) {
+                oldest = &slot;
+            }
+        }
+        if (oldest == nullptr) { return n_read; }
+
+        // Read it
+        this->_read_slot(*oldest);
+        oldest->pending = false;
+        ++n_read;
+    }
+}
+
+
+
+/* Logs the statistics gathered since they were last reset on the GpuProfiler channel. */
+void GpuProfiler::log_stats() const {
+    logger.logc(Verbosity::details, GpuProfiler::channel, "GPU render pass over ", this->_stats.n_frames, " frames: avg ", this->_stats.avg_pass_us(), "us, last ", this->_stats.last_pass_us, "us, max ", this->_stats.max_pass_us, "us");
+    for (uint32_t i = 0; i < this->_stats.buckets.size(); i++) {
+        const GpuBucketStats& bucket = this->_stats.buckets[i];
+        if (bucket.total_us == 0.0) { continue; }
+        if (this->pipeline_statistics()) {
+            logger.logc(Verbosity::details, GpuProfiler::channel, " - '", bucket.name, "': avg ", this->_stats.avg_bucket_us(i), "us, max ", bucket.max_us, "us, ", bucket.vertex_invocations / std::max(1U, this->_stats.n_frames), " vertex & ", bucket.fragment_invocations / std::max(1U, this->_stats.n_frames), " fragment invocations per frame");
+        } else {
+            logger.logc(Verbosity::details, GpuProfiler::channel, " - '", bucket.name, "': avg ", this->_stats.avg_bucket_us(i), "us, max ", bucket.max_us, "us");
+        }
+    }
+}
+
+/* Resets the statistics. */
+void GpuProfiler::reset_stats() {
+    this->_stats.n_frames = 0;
+    this->_stats.pass_us = 0.0;
+    this->_stats.last_pass_us = 0.0;
+    this->_stats.max_pass_us = 0.0;
+    for (uint32_t i = 0; i < this->_stats.buckets.size(); i++) {
+        GpuBucketStats& bucket = this->_stats.buckets[i];
+        bucket.total_us = 0.0;
+        bucket.last_us = 0.0;
+        bucket.max_us = 0.0;
+        bucket.vertex_invocations = 0;
+        bucket.fragment_invocations = 0;
+    }
+}
+
+
+
+/* Swap operator for the GpuProfiler class. */
+void Rendering::swap(GpuProfiler& gp1, GpuProfiler& gp2) {
+    #ifndef NDEBUG
+    if (gp1.gpu != gp2.gpu) { logger.fatalc(GpuProfiler::channel, "Cannot swap profilers with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(gp1.max_chunks, gp2.max_chunks);
+    swap(gp1.n_buckets, gp2.n_buckets);
+    swap(gp1.ns_per_tick, gp2.ns_per_tick);
+    swap(gp1.slots, gp2.slots);
+    swap(gp1.results, gp2.results);
+    swap(gp1._stats, gp2._stats);
+}
@@ -0,0 +1,156 @@
+/* GPU PROFILER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:14:46
+ * Last edited:
+ *   19/10/2026, 02:29:42
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GpuProfiler class, which measures how long the GPU
+ *   spends on the render pass and on each bucket of draws (i.e., each
+ *   material type) using timestamp queries, and optionally counts the
+ *   shader invocations of each bucket using pipeline statistics
+ *   queries. The results are read back frames-in-flight frames later,
+ *   once they're known to be done, so profiling never stalls the GPU.
+**/
+
+#ifndef RENDERING_GPU_PROFILER_HPP
+#define RENDERING_GPU_PROFILER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+
+namespace Makma3D::Rendering {
+    /* Statistics on a single bucket of draws, as measured by the GpuProfiler. */
+    struct GpuBucketStats {
+        /* The name of the bucket. */
+        std::string name;
+        /* The total time the GPU spent on the bucket, in microseconds. */
+        double total_us;
+        /* The time spent on the bucket in the most recent frame, in microseconds. */
+        double last_us;
+        /* The longest time spent on the bucket in a single frame, in microseconds. */
+        double max_us;
+        /* The total number of vertex shader invocations in the bucket. Only counted if pipeline statistics are enabled. */
+        uint64_t vertex_invocations;
+        /* The total number of fragment shader invocations in the bucket. Only counted if pipeline statistics are enabled. */
+        uint64_t fragment_invocations;
+    };
+
+    /* Statistics on how long the GPU spent rendering, as measured by the GpuProfiler. */
+    struct GpuStats {
+        /* The number of frames measured. */
+        uint32_t n_frames;
+        /* The total time the GPU spent on the render pass, in microseconds. */
+        double pass_us;
+        /* The time spent on the render pass in the most recent frame, in microseconds. */
+        double last_pass_us;
+        /* The longest time spent on the render pass in a single frame, in microseconds. */
+        double max_pass_us;
+        /* The statistics per bucket of draws. */
+        Tools::Array<GpuBucketStats> buckets;
+
+        /* Returns the average time spent on the render pass per frame, in microseconds. */
+        inline double avg_pass_us() const { return this->n_frames > 0 ? this->pass_us / (double) this->n_frames : 0.0; }
+        /* Returns the average time spent on the given bucket per frame, in microseconds. */
+        inline double avg_bucket_us(uint32_t bucket) const { return this->n_frames > 0 ? this->buckets[bucket].total_us / (double) this->n_frames : 0.0; }
+    };
+
+
+
+    /* The GpuProfiler class, which measures GPU time per render pass and per bucket of draws without stalling the GPU. */
+    class GpuProfiler {
+    public:
+        /* Channel name for the GpuProfiler class. */
+        static constexpr const char* channel = "GpuProfiler";
+
+        /* The GPU where the GpuProfiler lives. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* Private struct that holds the queries of a single frame in flight. */
+        struct Slot {
+            /* The pool with the timestamps: the start & end of the render pass, followed by the start & end of each segment. */
+            VkQueryPool timestamps;
+            /* The pool with the pipeline statistics of each segment. Is VK_NULL_HANDLE if those aren't collected. */
+            VkQueryPool statistics;
+            /* The number of the frame that last used the slot. */
+            uint64_t frame;
+            /* Whether the slot holds results that haven't been read yet. */
+            bool pending;
+        };
+
+        /* The maximum number of chunks the scene may be recorded in. */
+        uint32_t max_chunks;
+        /* The number of buckets we measure. */
+        uint32_t n_buckets;
+        /* The number of nanoseconds per timestamp tick. */
+        double ns_per_tick;
+        /* The slots with queries, one per frame in flight. */
+        Tools::Array<Slot> slots;
+        /* Scratch space to read the query results to, kept around to avoid allocations each frame. */
+        Tools::Array<uint64_t> results;
+        /* The statistics gathered so far. */
+        Rendering::GpuStats _stats;
+
+        /* Private helper function that returns the index of the segment with the given bucket in the given chunk. Since the draws are sorted on material type, each bucket occurs at most once per chunk. */
+        inline uint32_t _segment(uint32_t chunk, uint32_t bucket) const { return chunk * this->n_buckets + bucket; }
+        /* Private helper function that returns the number of segments per slot. */
+        inline uint32_t _n_segments() const { return this->max_chunks * this->n_buckets; }
+        /* Private helper function that reads the results of the given slot and adds them to the statistics. */
+        void _read_slot(const Slot& slot);
+
+    public:
+        /* Constructor for the GpuProfiler class, which takes the GPU where it lives, the number of slots (which should be the number of frames in flight), the maximum number of chunks the scene may be recorded in, the names of the buckets to measure and whether or not to collect pipeline statistics as well. */
+        GpuProfiler(const Rendering::GPU& gpu, uint32_t n_slots, uint32_t max_chunks, const Tools::Array<std::string>& bucket_names, bool pipeline_statistics = false);
+        /* Copy constructor for the GpuProfiler class, which is deleted. */
+        GpuProfiler(const GpuProfiler& other) = delete;
+        /* Move constructor for the GpuProfiler class. */
+        GpuProfiler(GpuProfiler&& other);
+        /* Destructor for the GpuProfiler class. */
+        ~GpuProfiler();
+
+        /* Resets the queries of the given frame and writes the timestamp at the start of its render pass. Must be recorded in the frame's primary command buffer, before the render pass. */
+        void begin_frame(uint64_t frame, const Rendering::CommandBuffer* cmd);
+        /* Writes the timestamp at the end of the given frame's render pass. Must be recorded in the frame's primary command buffer, after the render pass. */
+        void end_frame(uint64_t frame, const Rendering::CommandBuffer* cmd);
+        /* Starts measuring the given bucket in the given chunk of the given frame, by writing a timestamp (and starting the statistics query) in the given command buffer. */
+        void begin_bucket(uint64_t frame, const Rendering::CommandBuffer* cmd, uint32_t chunk, uint32_t bucket);
+        /* Stops measuring the given bucket in the given chunk of the given frame. */
+        void end_bucket(uint64_t frame, const Rendering::CommandBuffer* cmd, uint32_t chunk, uint32_t bucket);
+        /* Reads back the results of all frames that have completed, given the number of frames that have completed so far. Never waits on the GPU. Returns the number of frames read, so callers know whether the last frame's statistics are new. */
+        uint32_t collect(uint64_t n_completed);
+
+        /* Logs the statistics gathered since they were last reset on the GpuProfiler channel. */
+        void log_stats() const;
+        /* Returns the statistics gathered since they were last reset. */
+        inline const Rendering::GpuStats& stats() const { return this->_stats; }
+        /* Resets the statistics. */
+        void reset_stats();
+        /* Returns whether or not pipeline statistics are collected. */
+        inline bool pipeline_statistics() const { return this->slots.size() > 0 && this->slots[0].statistics != VK_NULL_HANDLE; }
+
+        /* Copy assignment operator for the GpuProfiler class, which is deleted. */
+        GpuProfiler& operator=(const GpuProfiler& other) = delete;
+        /* Move assignment operator for the GpuProfiler class. */
+        inline GpuProfiler& operator=(GpuProfiler&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the GpuProfiler class. */
+        friend void swap(GpuProfiler& gp1, GpuProfiler& gp2);
+
+    };
+
+    /* Swap operator for the GpuProfiler class. */
+    void swap(GpuProfiler& gp1, GpuProfiler& gp2);
+
+}
+
+#endif
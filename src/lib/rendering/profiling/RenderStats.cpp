@@ -0,0 +1,132 @@
+/* RENDER STATS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:20:55
+ * Last edited:
+ *   19/10/2026, 01:22:06
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RenderStats struct, which counts the work the renderer
+ *   did for a single frame (draws, binds, uploads, ...), and the
+ *   RenderStatsHistory class, which keeps those of the last couple of
+ *   frames around to summarize them as min / avg / p99.
+**/
+
+#include <vector>
+#include <algorithm>
+#include <sstream>
+
+#include "tools/Logger.hpp"
+
+#include "RenderStats.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** RENDERSTATS STRUCT *****/
+/* The names of the metrics, in the order of metric(). */
+const char* const RenderStats::metric_names[RenderStats::n_metrics] = {
+    "draws",
+    "instances",
+    "triangles",
+    "pipeline binds",
+    "descriptor binds",
+    "buffer binds",
+    "staging submissions",
+    "uploaded bytes",
+    "descriptor sets allocated",
+    "fence wait (us)"
+};
+
+
+
+/* Returns the value of the metric with the given index, which matches the order of the fields. */
+uint64_t RenderStats::metric(uint32_t index) const {
+    switch (index) {
+        case 0: return this->draws;
+        case 1: return this->instances;
+        case 2: return this->triangles;
+        case 3: return this->pipeline_binds;
+        case 4: return this->descriptor_binds;
+        case 5: return this->buffer_binds;
+        case 6: return this->staging_submissions;
+        case 7: return this->uploaded_bytes;
+        case 8: return this->descriptor_sets_allocated;
+        case 9: return this->fence_wait_us;
+        default:
+            logger.fatalc(RenderStatsHistory::channel, "Unknown metric index ", index, " (expected less than ", RenderStats::n_metrics, ")");
+            return 0;
+    }
+}
+
+
+
+
+
+/***** RENDERSTATSHISTORY CLASS *****/
+/* Constructor for the RenderStatsHistory class, which takes the number of frames to keep. */
+RenderStatsHistory::RenderStatsHistory(uint32_t max_frames) :
+    max_frames(std::max(1U, max_frames)),
+    head(0)
+{
+    this->frames.reserve(this->max_frames);
+}
+
+
+
+/* Adds the stats of a new frame, forgetting those of the oldest one if the history is full. */
+void RenderStatsHistory::push(const Rendering::RenderStats& stats) {
+    if (this->frames.size() < this->max_frames) {
+        this->frames.push_back(stats);
+    } else {
+        this->frames[this->head] = stats;
+    }
+    this->head = (this->head + 1) % this->max_frames;
+}
+
+/* Forgets all frames. */
+void RenderStatsHistory::clear() {
+    this->frames.clear();
+    this->head = 0;
+}
+
+
+
+/* Summarizes the metric with the given index over all frames in the history. */
+Rendering::MetricSummary RenderStatsHistory::summarize(uint32_t metric) const {
+    if (this->frames.empty()) { return MetricSummary{ 0, 0.0, 0, 0 }; }
+
+    // Collect the values of the metric
+    std::vector<uint64_t> values;
+    values.reserve(this->frames.size());
+    double total = 0.0;
+    for (uint32_t i = 0; i < this->frames.size(); i++) {
+        values.push_back(this->frames[i].metric(metric));
+        total += (double) values.back();
+    }
+
+    // Find the percentile without fully sorting the values, then the extremes
+    size_t p99_index = (values.size() * 99) / 100;
+    std::nth_element(values.begin(), values.begin() + p99_index, values.end());
+    uint64_t p99 = values[p99_index];
+    std::pair<std::vector<uint64_t>::const_iterator, std::vector<uint64_t>::const_iterator> extremes = std::minmax_element(values.cbegin(), values.cend());
+
+    // Done
+    return MetricSummary{ *extremes.first, total / (double) values.size(), p99, *extremes.second };
+}
+
+/* Logs the min / avg / p99 of each metric on the RenderStats channel. */
+void RenderStatsHistory::log() const {
+    std::stringstream sstr;
+    sstr << "Last " << this->frames.size() << " frames (min/avg/p99):";
+    for (uint32_t i = 0; i < RenderStats::n_metrics; i++) {
+        MetricSummary summary = this->summarize(i);
+        sstr << (i > 0 ? "," : "") << ' ' << RenderStats::metric_names[i] << ' ' << summary.min << '/' << (uint64_t) (summary.avg + 0.5) << '/' << summary.p99;
+    }
+    logger.logc(Verbosity::details, RenderStatsHistory::channel, sstr.str());
+}
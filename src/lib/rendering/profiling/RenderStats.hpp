@@ -0,0 +1,113 @@
+/* RENDER STATS.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:20:55
+ * Last edited:
+ *   19/10/2026, 01:22:06
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RenderStats struct, which counts the work the renderer
+ *   did for a single frame (draws, binds, uploads, ...), and the
+ *   RenderStatsHistory class, which keeps those of the last couple of
+ *   frames around to summarize them as min / avg / p99.
+**/
+
+#ifndef RENDERING_RENDER_STATS_HPP
+#define RENDERING_RENDER_STATS_HPP
+
+#include <cstdint>
+
+#include "tools/Array.hpp"
+
+namespace Makma3D::Rendering {
+    /* The work the renderer did for a single frame. */
+    struct RenderStats {
+        /* The number of metrics in the struct, i.e., the number of fields. */
+        static constexpr const uint32_t n_metrics = 10;
+        /* The names of the metrics, in the order of metric(). */
+        static const char* const metric_names[n_metrics];
+
+        /* The number of draw calls submitted. */
+        uint64_t draws;
+        /* The number of instances drawn by those draw calls. */
+        uint64_t instances;
+        /* The number of triangles drawn. */
+        uint64_t triangles;
+        /* The number of pipeline binds submitted. */
+        uint64_t pipeline_binds;
+        /* The number of descriptor set binds submitted. */
+        uint64_t descriptor_binds;
+        /* The number of vertex & index buffer binds submitted. */
+        uint64_t buffer_binds;
+        /* The number of transfers done through the staging buffer. */
+        uint64_t staging_submissions;
+        /* The number of bytes uploaded through the staging buffer. */
+        uint64_t uploaded_bytes;
+        /* The number of descriptor sets allocated. */
+        uint64_t descriptor_sets_allocated;
+        /* The time the CPU waited in get_frame() until the frame was no longer in flight, in microseconds. */
+        uint64_t fence_wait_us;
+
+        /* Returns the value of the metric with the given index, which matches the order of the fields. */
+        uint64_t metric(uint32_t index) const;
+    };
+
+    /* A summary of a single metric over multiple frames. */
+    struct MetricSummary {
+        /* The smallest value of the metric. */
+        uint64_t min;
+        /* The average value of the metric. */
+        double avg;
+        /* The 99th percentile of the metric. */
+        uint64_t p99;
+        /* The largest value of the metric. */
+        uint64_t max;
+    };
+
+
+
+    /* The RenderStatsHistory class, which keeps the RenderStats of the most recent frames around. */
+    class RenderStatsHistory {
+    public:
+        /* Channel name for the RenderStatsHistory class. */
+        static constexpr const char* channel = "RenderStats";
+
+    private:
+        /* The stats of the most recent frames, used as a ring. */
+        Tools::Array<Rendering::RenderStats> frames;
+        /* The maximum number of frames we keep. */
+        uint32_t max_frames;
+        /* The index where the next frame is written once the ring is full. */
+        uint32_t head;
+
+    public:
+        /* Constructor for the RenderStatsHistory class, which takes the number of frames to keep. */
+        RenderStatsHistory(uint32_t max_frames = 240);
+
+        /* Adds the stats of a new frame, forgetting those of the oldest one if the history is full. */
+        void push(const Rendering::RenderStats& stats);
+        /* Forgets all frames. */
+        void clear();
+
+        /* Summarizes the metric with the given index over all frames in the history. */
+        Rendering::MetricSummary summarize(uint32_t metric) const;
+        /* Logs the min / avg / p99 of each metric on the RenderStats channel. */
+        void log() const;
+
+        /* Returns the stats of the most recent frame. The history may not be empty. */
+        inline const Rendering::RenderStats& last() const { return this->frames[(this->head + this->frames.size() - 1) % this->frames.size()]; }
+        /* Returns the number of frames in the history. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->frames.size()); }
+        /* Returns whether the history is empty. */
+        inline bool empty() const { return this->frames.empty(); }
+        /* Returns the maximum number of frames in the history. */
+        inline uint32_t capacity() const { return this->max_frames; }
+
+    };
+
+}
+
+#endif
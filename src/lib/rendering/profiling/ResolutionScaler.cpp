@@ -0,0 +1,82 @@
+/* RESOLUTION SCALER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:41:08
+ * Last edited:
+ *   19/10/2026, 03:41:08
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ResolutionScaler class, which decides at what fraction
+ *   of the window's resolution the scene is rendered, based on how long
+ *   the GPU took for the last frames. It shrinks the resolution when
+ *   those take longer than a target frame time and grows it back once
+ *   there is room again, in discrete steps and with some patience, so
+ *   that the attachments aren't re-allocated every frame.
+**/
+
+#include <cmath>
+#include <algorithm>
+
+#include "tools/Common.hpp"
+#include "tools/Logger.hpp"
+
+#include "ResolutionScaler.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** RESOLUTIONSCALER CLASS *****/
+/* Constructor for the ResolutionScaler class, which takes the GPU frame time to aim for (in microseconds) and the smallest scale it may render at. It starts at the full resolution. */
+ResolutionScaler::ResolutionScaler(double target_us, float min_scale) :
+    _target_us(target_us),
+    _min_scale(std::min(std::max(min_scale, ResolutionScaler::scale_step), 1.0f)),
+    _scale(1.0f),
+    smoothed_us(-1.0),
+    cooldown(0)
+{}
+
+
+
+/* Feeds the GPU time of the most recently measured frame (in microseconds) to the scaler. Returns whether the scale changed, in which case the attachments have to be re-allocated at the new scaled size. */
+bool ResolutionScaler::update(double gpu_us) {
+    // Smooth the measurements, so that a single slow frame doesn't change the resolution
+    this->smoothed_us = this->smoothed_us < 0.0 ? gpu_us : this->smoothed_us + ResolutionScaler::smoothing * (gpu_us - this->smoothed_us);
+    if (this->cooldown > 0) {
+        --this->cooldown;
+        return false;
+    }
+    if (this->smoothed_us <= 0.0) { return false; }
+
+    // Only act if we're over the target, or well below it
+    bool shrink = this->smoothed_us > this->_target_us;
+    bool grow = this->smoothed_us < ResolutionScaler::grow_threshold * this->_target_us;
+    if (!shrink && !grow) { return false; }
+
+    // The GPU time mostly grows with the number of pixels, i.e., with the square of the scale. Use that to estimate the scale that lands us halfway between the thresholds
+    double setpoint_us = 0.5 * (1.0 + ResolutionScaler::grow_threshold) * this->_target_us;
+    float wanted = this->_scale * static_cast<float>(std::sqrt(setpoint_us / this->smoothed_us));
+    // Not all of the frame's work depends on the resolution, so the estimate overshoots when growing; take a few steps at most
+    if (grow) { wanted = std::min(wanted, this->_scale + 4.0f * ResolutionScaler::scale_step); }
+
+    // Snap it to a step and keep it within bounds
+    float new_scale = std::floor(wanted / ResolutionScaler::scale_step) * ResolutionScaler::scale_step;
+    new_scale = std::min(std::max(new_scale, this->_min_scale), 1.0f);
+    if (new_scale == this->_scale) { return false; }
+
+    // Predict the frame time at the new scale, and wait for the frames at the old scale to pass before looking again
+    logger.logc(Verbosity::details, ResolutionScaler::channel, "GPU frame time of ", this->smoothed_us, "us against a target of ", this->_target_us, "us; rescaling from ", this->_scale, " to ", new_scale);
+    this->smoothed_us *= (double) (new_scale * new_scale) / (double) (this->_scale * this->_scale);
+    this->_scale = new_scale;
+    this->cooldown = ResolutionScaler::settle_frames;
+    return true;
+}
+
+/* Returns the given size (in pixels) scaled with the current scale. Never returns less than a single pixel. */
+uint32_t ResolutionScaler::scaled(uint32_t size) const {
+    return std::max(1U, static_cast<uint32_t>(std::lround((double) size * (double) this->_scale)));
+}
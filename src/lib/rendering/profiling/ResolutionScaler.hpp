@@ -0,0 +1,74 @@
+/* RESOLUTION SCALER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:41:08
+ * Last edited:
+ *   19/10/2026, 03:41:08
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ResolutionScaler class, which decides at what fraction
+ *   of the window's resolution the scene is rendered, based on how long
+ *   the GPU took for the last frames. It shrinks the resolution when
+ *   those take longer than a target frame time and grows it back once
+ *   there is room again, in discrete steps and with some patience, so
+ *   that the attachments aren't re-allocated every frame.
+**/
+
+#ifndef RENDERING_RESOLUTION_SCALER_HPP
+#define RENDERING_RESOLUTION_SCALER_HPP
+
+#include <cstdint>
+
+namespace Makma3D::Rendering {
+    /* The ResolutionScaler class, which steers the render resolution towards a target GPU frame time. */
+    class ResolutionScaler {
+    public:
+        /* Channel name for the ResolutionScaler class. */
+        static constexpr const char* channel = "ResolutionScaler";
+        /* The default smallest scale we render at, as a fraction of the window's width & height. */
+        static constexpr const float default_min_scale = 0.5f;
+        /* The steps in which the scale changes. Scales in between aren't used, so that small fluctuations don't cause a re-allocation each time. */
+        static constexpr const float scale_step = 1.0f / 32.0f;
+        /* The fraction of the target that the frame time has to drop below before we grow the resolution again. Keeps the scale from flipping back and forth around the target. */
+        static constexpr const float grow_threshold = 0.85f;
+        /* The weight of a new measurement in the smoothed frame time. */
+        static constexpr const float smoothing = 0.2f;
+        /* The number of measurements we wait after changing the scale before changing it again. Frames that were in flight during the change were still measured at the old scale, so this has to be at least the number of frames in flight. */
+        static constexpr const uint32_t settle_frames = 8;
+
+    private:
+        /* The GPU frame time we aim for, in microseconds. */
+        double _target_us;
+        /* The smallest scale we render at. */
+        float _min_scale;
+        /* The current scale. */
+        float _scale;
+        /* The smoothed GPU frame time, in microseconds. Negative if nothing was measured yet. */
+        double smoothed_us;
+        /* The number of measurements to ignore before the scale may change again. */
+        uint32_t cooldown;
+
+    public:
+        /* Constructor for the ResolutionScaler class, which takes the GPU frame time to aim for (in microseconds) and the smallest scale it may render at. It starts at the full resolution. */
+        ResolutionScaler(double target_us, float min_scale = ResolutionScaler::default_min_scale);
+
+        /* Feeds the GPU time of the most recently measured frame (in microseconds) to the scaler. Returns whether the scale changed, in which case the attachments have to be re-allocated at the new scaled size. */
+        bool update(double gpu_us);
+        /* Returns the given size (in pixels) scaled with the current scale. Never returns less than a single pixel. */
+        uint32_t scaled(uint32_t size) const;
+
+        /* Returns the GPU frame time we aim for, in microseconds. */
+        inline double target_us() const { return this->_target_us; }
+        /* Returns the smallest scale we render at. */
+        inline float min_scale() const { return this->_min_scale; }
+        /* Returns the current scale, as a fraction of the window's width & height. */
+        inline float scale() const { return this->_scale; }
+
+    };
+
+}
+
+#endif
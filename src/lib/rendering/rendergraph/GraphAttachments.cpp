@@ -0,0 +1,215 @@
+/* GRAPH ATTACHMENTS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GraphAttachments class, which allocates the transient
+ *   attachments of a compiled RenderGraph for a given size. Attachments
+ *   that the graph put in the same memory slot are allocated once and
+ *   aliased, so they share the same memory in the MemoryPool.
+**/
+
+#include "tools/Logger.hpp"
+#include "tools/Common.hpp"
+#include "../auxillary/ErrorCodes.hpp"
+#include "../auxillary/Formats.hpp"
+
+#include "GraphAttachments.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates a given VkImageViewCreateInfo struct for the given range of layers of the given image. If it covers more than one, the view is an array view. */
+static void populate_view_info(VkImageViewCreateInfo& view_info, const VkImage& vk_image, const VkFormat& vk_format, uint32_t base_layer = 0, uint32_t n_layers = 1) {
+    // Set the struct's default values
+    view_info = {};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+
+    // Link the image
+    view_info.image = vk_image;
+
+    // Set the type and format of the image
+    view_info.viewType = n_layers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = vk_format;
+
+    // Set the components of the image. For now, all of them are just themselves
+    view_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    view_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    view_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    view_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+    // Set the subresource range's properties: what kind of aspect we're interested in, how many bitmaps this image has and how many layers
+    view_info.subresourceRange.aspectMask = is_depth_format(vk_format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.baseArrayLayer = base_layer;
+    view_info.subresourceRange.layerCount = n_layers;
+}
+
+
+
+
+
+/***** GRAPHATTACHMENTS CLASS *****/
+/* Constructor for the GraphAttachments class, which takes the GPU where they live, a memory pool to allocate the images from, the compiled RenderGraph to allocate the transient attachments of and the size of the attachments. */
+GraphAttachments::GraphAttachments(const Rendering::GPU& gpu, Rendering::MemoryPool& draw_pool, const Rendering::RenderGraph& render_graph, const VkExtent2D& vk_extent) :
+    gpu(gpu),
+    draw_pool(draw_pool),
+    images((Rendering::Image*) nullptr, render_graph.size()),
+    vk_views((VkImageView) nullptr, render_graph.size()),
+    vk_base_views((VkImageView) nullptr, render_graph.size()),
+    attachments(RenderGraph::unused, render_graph.size()),
+    vk_extent(vk_extent),
+    n_layers(render_graph.views())
+{
+    logger.logc(Verbosity::details, GraphAttachments::channel, "Initializing...");
+
+    #ifndef NDEBUG
+    if (!render_graph.is_compiled()) { logger.fatalc(GraphAttachments::channel, "Cannot allocate the attachments of a graph that isn't compiled."); }
+    #endif
+
+    // Find the largest attachment in each slot, which is the one that actually gets the memory
+    Tools::Array<uint32_t> slot_owner(RenderGraph::unused, render_graph.slots());
+    Tools::Array<VkDeviceSize> slot_size((VkDeviceSize) 0, render_graph.slots());
+    uint32_t n_attachments = 0;
+    for (uint32_t i = 0; i < render_graph.size(); i++) {
+        const GraphResource& resource = render_graph.resource(i);
+        if (resource.attachment == RenderGraph::unused) { continue; }
+        this->attachments[resource.attachment] = i;
+        ++n_attachments;
+        if (resource.imported) { continue; }
+
+        VkMemoryRequirements requirements = this->draw_pool.requirements(this->vk_extent, resource.format, resource.image_usage, this->n_layers);
+        if (slot_owner[resource.slot] == RenderGraph::unused || requirements.size > slot_size[resource.slot]) {
+            slot_owner[resource.slot] = i;
+            slot_size[resource.slot] = requirements.size;
+        }
+    }
+    this->attachments.resize(n_attachments);
+
+    // Allocate those first, and then let the others in their slot borrow their memory
+    VkDeviceSize total_size = 0, aliased_size = 0;
+    for (uint32_t s = 0; s < render_graph.slots(); s++) {
+        const GraphResource& resource = render_graph.resource(slot_owner[s]);
+        this->images[slot_owner[s]] = this->draw_pool.allocate(this->vk_extent, resource.format, VK_IMAGE_LAYOUT_UNDEFINED, resource.image_usage, VK_SHARING_MODE_EXCLUSIVE, 0, 1, this->n_layers);
+        total_size += slot_size[s];
+    }
+    for (uint32_t i = 0; i < render_graph.size(); i++) {
+        const GraphResource& resource = render_graph.resource(i);
+        if (resource.attachment == RenderGraph::unused || resource.imported || slot_owner[resource.slot] == i) { continue; }
+
+        this->images[i] = this->draw_pool.alias(this->images[slot_owner[resource.slot]], resource.format, resource.image_usage);
+        aliased_size += this->images[i]->rsize();
+    }
+
+    // Create a view for each of them, covering all of their layers
+    for (uint32_t i = 0; i < render_graph.size(); i++) {
+        if (this->images[i] == nullptr) { continue; }
+
+        VkImageViewCreateInfo view_info;
+        populate_view_info(view_info, this->images[i]->vulkan(), this->images[i]->format(), 0, this->n_layers);
+        VkResult vk_result;
+        if ((vk_result = vkCreateImageView(this->gpu, &view_info, nullptr, &this->vk_views[i])) != VK_SUCCESS) {
+            logger.fatalc(GraphAttachments::channel, "Could not create image view for attachment '", render_graph.resource(i).name, "': ", vk_error_map[vk_result]);
+        }
+
+        // Exported attachments are read outside of the graph by shaders that only know a single layer, so they get a view of the first one as well
+        if (this->n_layers > 1 && render_graph.resource(i).exported) {
+            populate_view_info(view_info, this->images[i]->vulkan(), this->images[i]->format(), 0, 1);
+            if ((vk_result = vkCreateImageView(this->gpu, &view_info, nullptr, &this->vk_base_views[i])) != VK_SUCCESS) {
+                logger.fatalc(GraphAttachments::channel, "Could not create image view for the first layer of attachment '", render_graph.resource(i).name, "': ", vk_error_map[vk_result]);
+            }
+        }
+    }
+
+    // Done
+    logger.logc(Verbosity::details, GraphAttachments::channel, "Allocated ", Tools::bytes_to_string(total_size), " for transient attachments; aliasing saved ", Tools::bytes_to_string(aliased_size), ".");
+    logger.logc(Verbosity::details, GraphAttachments::channel, "Init success.");
+}
+
+/* Move constructor for the GraphAttachments class. */
+GraphAttachments::GraphAttachments(GraphAttachments&& other) :
+    gpu(other.gpu),
+    draw_pool(other.draw_pool),
+    images(std::move(other.images)),
+    vk_views(std::move(other.vk_views)),
+    vk_base_views(std::move(other.vk_base_views)),
+    attachments(std::move(other.attachments)),
+    vk_extent(other.vk_extent),
+    n_layers(other.n_layers)
+{
+    // Make sure the other doesn't deallocate anything
+    other.images.clear();
+    other.vk_views.clear();
+    other.vk_base_views.clear();
+}
+
+/* Destructor for the GraphAttachments class. */
+GraphAttachments::~GraphAttachments() {
+    logger.logc(Verbosity::details, GraphAttachments::channel, "Cleaning...");
+
+    // Destroy the views first
+    for (uint32_t i = 0; i < this->vk_views.size(); i++) {
+        if (this->vk_views[i] != nullptr) {
+            vkDestroyImageView(this->gpu, this->vk_views[i], nullptr);
+        }
+    }
+    for (uint32_t i = 0; i < this->vk_base_views.size(); i++) {
+        if (this->vk_base_views[i] != nullptr) {
+            vkDestroyImageView(this->gpu, this->vk_base_views[i], nullptr);
+        }
+    }
+    // Then free the images, doing the aliases before the images they borrow the memory of
+    for (uint32_t i = 0; i < this->images.size(); i++) {
+        if (this->images[i] != nullptr && this->images[i]->is_alias()) {
+            this->draw_pool.free(this->images[i]);
+        }
+    }
+    for (uint32_t i = 0; i < this->images.size(); i++) {
+        if (this->images[i] != nullptr && !this->images[i]->is_alias()) {
+            this->draw_pool.free(this->images[i]);
+        }
+    }
+
+    logger.logc(Verbosity::details, GraphAttachments::channel, "Cleaned.");
+}
+
+
+
+/* Returns the image views for a framebuffer of the graph's render pass, in the order of its attachments. Since imported attachments differ per framebuffer, the given view is used for them. */
+Tools::Array<VkImageView> GraphAttachments::views(VkImageView vk_imported_view) const {
+    Tools::Array<VkImageView> result(this->attachments.size());
+    for (uint32_t i = 0; i < this->attachments.size(); i++) {
+        VkImageView vk_view = this->vk_views[this->attachments[i]];
+        result.push_back(vk_view != nullptr ? vk_view : vk_imported_view);
+    }
+    return result;
+}
+
+
+
+/* Swap operator for the GraphAttachments class. */
+void Rendering::swap(GraphAttachments& ga1, GraphAttachments& ga2) {
+    #ifndef NDEBUG
+    if (ga1.gpu != ga2.gpu) { logger.fatalc(GraphAttachments::channel, "Cannot swap graph attachments with different GPUs."); }
+    if (&ga1.draw_pool != &ga2.draw_pool) { logger.fatalc(GraphAttachments::channel, "Cannot swap graph attachments with different draw pools."); }
+    #endif
+
+    using std::swap;
+
+    swap(ga1.images, ga2.images);
+    swap(ga1.vk_views, ga2.vk_views);
+    swap(ga1.vk_base_views, ga2.vk_base_views);
+    swap(ga1.attachments, ga2.attachments);
+    swap(ga1.vk_extent, ga2.vk_extent);
+    swap(ga1.n_layers, ga2.n_layers);
+}
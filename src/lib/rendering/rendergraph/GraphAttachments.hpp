@@ -0,0 +1,94 @@
+/* GRAPH ATTACHMENTS.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GraphAttachments class, which allocates the transient
+ *   attachments of a compiled RenderGraph for a given size. Attachments
+ *   that the graph put in the same memory slot are allocated once and
+ *   aliased, so they share the same memory in the MemoryPool.
+**/
+
+#ifndef RENDERING_GRAPH_ATTACHMENTS_HPP
+#define RENDERING_GRAPH_ATTACHMENTS_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../memory/MemoryPool.hpp"
+
+#include "RenderGraph.hpp"
+
+namespace Makma3D::Rendering {
+    /* The GraphAttachments class, which owns the images of the transient attachments of a RenderGraph. */
+    class GraphAttachments {
+    public:
+        /* Channel name for the GraphAttachments class. */
+        static constexpr const char* channel = "GraphAttachments";
+
+        /* The GPU where the GraphAttachments live. */
+        const Rendering::GPU& gpu;
+        /* The MemoryPool used to allocate the images. */
+        Rendering::MemoryPool& draw_pool;
+
+    private:
+        /* The image of each attachment in the graph, in the order of the graph's attachments. Is a nullptr for imported and unused attachments. */
+        Tools::Array<Rendering::Image*> images;
+        /* The image view of each attachment in the graph. Is a nullptr for imported and unused attachments. */
+        Tools::Array<VkImageView> vk_views;
+        /* The image view of only the first layer of each exported attachment, if the attachments have more than one. Is a nullptr otherwise. */
+        Tools::Array<VkImageView> vk_base_views;
+        /* The index in the graph of each attachment in the compiled render pass. */
+        Tools::Array<uint32_t> attachments;
+        /* The size of the attachments. */
+        VkExtent2D vk_extent;
+        /* The number of layers of the attachments, i.e., the number of views the graph renders to. */
+        uint32_t n_layers;
+
+    public:
+        /* Constructor for the GraphAttachments class, which takes the GPU where they live, a memory pool to allocate the images from, the compiled RenderGraph to allocate the transient attachments of and the size of the attachments. */
+        GraphAttachments(const Rendering::GPU& gpu, Rendering::MemoryPool& draw_pool, const Rendering::RenderGraph& render_graph, const VkExtent2D& vk_extent);
+        /* Copy constructor for the GraphAttachments class, which is deleted. */
+        GraphAttachments(const GraphAttachments& other) = delete;
+        /* Move constructor for the GraphAttachments class. */
+        GraphAttachments(GraphAttachments&& other);
+        /* Destructor for the GraphAttachments class. */
+        ~GraphAttachments();
+
+        /* Returns the image views for a framebuffer of the graph's render pass, in the order of its attachments. Since imported attachments differ per framebuffer, the given view is used for them. */
+        Tools::Array<VkImageView> views(VkImageView vk_imported_view) const;
+
+        /* Returns the image of the attachment with the given index in the graph. Is a nullptr for imported and unused attachments. */
+        inline const Rendering::Image* image(uint32_t resource) const { return this->images[resource]; }
+        /* Returns the image view of the attachment with the given index in the graph. Is a nullptr for imported and unused attachments. */
+        inline VkImageView view(uint32_t resource) const { return this->vk_views[resource]; }
+        /* Returns an image view of only the first layer of the exported attachment with the given index in the graph, which is the same as its normal view if the attachments have only one layer. */
+        inline VkImageView base_view(uint32_t resource) const { return this->vk_base_views[resource] != nullptr ? this->vk_base_views[resource] : this->vk_views[resource]; }
+        /* Returns the size of the attachments. */
+        inline const VkExtent2D& extent() const { return this->vk_extent; }
+        /* Returns the number of layers of the attachments. */
+        inline uint32_t layers() const { return this->n_layers; }
+
+        /* Copy assignment operator for the GraphAttachments class, which is deleted. */
+        GraphAttachments& operator=(const GraphAttachments& other) = delete;
+        /* Move assignment operator for the GraphAttachments class. */
+        inline GraphAttachments& operator=(GraphAttachments&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the GraphAttachments class. */
+        friend void swap(GraphAttachments& ga1, GraphAttachments& ga2);
+
+    };
+
+    /* Swap operator for the GraphAttachments class. */
+    void swap(GraphAttachments& ga1, GraphAttachments& ga2);
+
+}
+
+#endif
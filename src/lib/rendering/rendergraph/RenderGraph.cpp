@@ -0,0 +1,513 @@
+/* RENDER GRAPH.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RenderGraph class, which describes a frame as a list of
+ *   passes that declare which attachments they read and write. From
+ *   that, it culls the passes whose results are never used, compiles
+ *   the rest to a single RenderPass with one subpass each and only the
+ *   subpass dependencies that the attachments actually need, and
+ *   decides which of its own (transient) attachments can share memory
+ *   because they're never in use at the same time.
+**/
+
+#include "tools/Logger.hpp"
+#include "../auxillary/Formats.hpp"
+
+#include "RenderGraph.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns whether the given usage writes to the attachment. */
+static bool usage_writes(AttachmentUsage usage) {
+    return usage == AttachmentUsage::colour || usage == AttachmentUsage::depth;
+}
+
+/* Returns whether the given usage depends on what's already in the attachment. */
+static bool usage_reads(AttachmentUsage usage) {
+    return usage != AttachmentUsage::colour;
+}
+
+/* Returns the pipeline stages where the given usage touches the attachment. */
+static VkPipelineStageFlags usage_stages(AttachmentUsage usage) {
+    switch (usage) {
+        case AttachmentUsage::colour:     return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        case AttachmentUsage::depth:      return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        case AttachmentUsage::depth_read: return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        case AttachmentUsage::input:      return VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    }
+    return 0;
+}
+
+/* Returns the accesses the given usage does to the attachment. */
+static VkAccessFlags usage_access(AttachmentUsage usage) {
+    switch (usage) {
+        case AttachmentUsage::colour:     return VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        case AttachmentUsage::depth:      return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        case AttachmentUsage::depth_read: return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        case AttachmentUsage::input:      return VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    }
+    return 0;
+}
+
+/* Returns the layout the attachment (with the given format) should be in for the given usage. */
+static VkImageLayout usage_layout(AttachmentUsage usage, VkFormat vk_format) {
+    switch (usage) {
+        case AttachmentUsage::colour:     return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        case AttachmentUsage::depth:      return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        case AttachmentUsage::depth_read: return VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        case AttachmentUsage::input:      return is_depth_format(vk_format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+    return VK_IMAGE_LAYOUT_UNDEFINED;
+}
+
+/* Returns the image usage flags an attachment needs for the given usage. */
+static VkImageUsageFlags usage_image_flags(AttachmentUsage usage) {
+    switch (usage) {
+        case AttachmentUsage::colour:     return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        case AttachmentUsage::depth:      return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        case AttachmentUsage::depth_read: return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        case AttachmentUsage::input:      return VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    }
+    return 0;
+}
+
+/* Adds the given stages & accesses to the dependency between the given subpasses in the given list, adding a new one if there's none yet. Only the writes of the source need to be made available, so its reads are dropped from the access mask. Returns the dependency, so callers can add more to it. */
+static VkSubpassDependency& merge_dependency(Tools::Array<VkSubpassDependency>& dependencies, uint32_t src_subpass, uint32_t dst_subpass, AttachmentUsage src_usage, AttachmentUsage dst_usage) {
+    // Find the dependency between these two subpasses
+    uint32_t index = dependencies.size();
+    for (uint32_t i = 0; i < dependencies.size(); i++) {
+        if (dependencies[i].srcSubpass == src_subpass && dependencies[i].dstSubpass == dst_subpass) {
+            index = i;
+            break;
+        }
+    }
+    if (index == dependencies.size()) {
+        VkSubpassDependency dependency = {};
+        dependency.srcSubpass = src_subpass;
+        dependency.dstSubpass = dst_subpass;
+        // Attachments are only ever accessed at the pixel that's being rendered, so within the render pass, the dependencies can be per-region
+        dependency.dependencyFlags = src_subpass != VK_SUBPASS_EXTERNAL && dst_subpass != VK_SUBPASS_EXTERNAL ? VK_DEPENDENCY_BY_REGION_BIT : 0;
+        dependencies.push_back(dependency);
+    }
+
+    // Add the masks
+    VkSubpassDependency& dependency = dependencies[index];
+    dependency.srcStageMask |= usage_stages(src_usage);
+    dependency.srcAccessMask |= usage_access(src_usage) & (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+    dependency.dstStageMask |= usage_stages(dst_usage);
+    dependency.dstAccessMask |= usage_access(dst_usage);
+    return dependency;
+}
+
+
+
+
+
+/***** RENDERGRAPH CLASS *****/
+/* Constructor for the RenderGraph class, which takes the GPU where it lives. */
+RenderGraph::RenderGraph(const Rendering::GPU& gpu) :
+    gpu(gpu),
+    _render_pass(gpu),
+    n_views(1),
+    n_subpasses(0),
+    n_slots(0),
+    compiled(false)
+{}
+
+/* Copy constructor for the RenderGraph class. */
+RenderGraph::RenderGraph(const RenderGraph& other) :
+    gpu(other.gpu),
+    resources(other.resources),
+    passes(other.passes),
+    _render_pass(other.gpu),
+    n_views(other.n_views),
+    n_subpasses(0),
+    n_slots(0),
+    compiled(false)
+{
+    // Simply re-compile the graph to get our own render pass
+    if (other.compiled) {
+        this->compile();
+    }
+}
+
+/* Move constructor for the RenderGraph class. */
+RenderGraph::RenderGraph(RenderGraph&& other) :
+    gpu(other.gpu),
+    resources(std::move(other.resources)),
+    passes(std::move(other.passes)),
+    _render_pass(std::move(other._render_pass)),
+    n_views(other.n_views),
+    n_subpasses(other.n_subpasses),
+    n_slots(other.n_slots),
+    compiled(other.compiled)
+{}
+
+/* Destructor for the RenderGraph class. */
+RenderGraph::~RenderGraph() {}
+
+
+
+/* Private helper function that adds an attachment to the graph. */
+uint32_t RenderGraph::_add_resource(const std::string& name, VkFormat format, bool imported, VkImageLayout final_layout) {
+    GraphResource resource = {};
+    resource.name = name;
+    resource.format = format;
+    resource.imported = imported;
+    resource.exported = false;
+    resource.final_layout = final_layout;
+    resource.export_usage = 0;
+    resource.attachment = RenderGraph::unused;
+    resource.first_use = RenderGraph::unused;
+    resource.last_use = RenderGraph::unused;
+    resource.slot = RenderGraph::unused;
+
+    this->resources.push_back(resource);
+    this->compiled = false;
+    return this->resources.size() - 1;
+}
+
+/* Private helper function that marks the passes whose results are never used as culled, and numbers the others as subpasses. */
+void RenderGraph::_cull() {
+    // Everything that leaves the graph is needed
+    Tools::Array<bool> needed(false, this->resources.size());
+    for (uint32_t i = 0; i < this->resources.size(); i++) {
+        needed[i] = this->resources[i].imported || this->resources[i].exported;
+    }
+
+    // Walk back through the passes. A pass is only needed if it writes something that's needed, in which case everything it reads is needed too
+    Tools::Array<bool> live(false, this->passes.size());
+    for (uint32_t i = this->passes.size(); i-- > 0;) {
+        const GraphPass& pass = this->passes[i];
+        for (uint32_t j = 0; j < pass.uses.size(); j++) {
+            if (usage_writes(pass.uses[j].second) && needed[pass.uses[j].first]) {
+                live[i] = true;
+                break;
+            }
+        }
+        if (!live[i]) { continue; }
+        for (uint32_t j = 0; j < pass.uses.size(); j++) {
+            if (usage_reads(pass.uses[j].second)) { needed[pass.uses[j].first] = true; }
+        }
+    }
+
+    // Number the surviving passes in order
+    this->n_subpasses = 0;
+    for (uint32_t i = 0; i < this->passes.size(); i++) {
+        if (live[i]) {
+            this->passes[i].subpass = this->n_subpasses++;
+        } else {
+            this->passes[i].subpass = RenderGraph::unused;
+            logger.logc(Verbosity::details, RenderGraph::channel, "Culled pass '", this->passes[i].name, "', since nothing uses its results.");
+        }
+    }
+}
+
+/* Private helper function that computes when each attachment is used, and decides which transient attachments can share memory. */
+void RenderGraph::_compute_lifetimes() {
+    // Reset what we computed last time
+    for (uint32_t i = 0; i < this->resources.size(); i++) {
+        GraphResource& resource = this->resources[i];
+        resource.attachment = RenderGraph::unused;
+        resource.first_use = RenderGraph::unused;
+        resource.last_use = RenderGraph::unused;
+        resource.image_usage = 0;
+        resource.slot = RenderGraph::unused;
+    }
+
+    // Go through the surviving passes in order to find the first and last use of each attachment. Attachments are numbered in order of their first use
+    Tools::Array<uint32_t> order(this->resources.size());
+    for (uint32_t i = 0; i < this->passes.size(); i++) {
+        const GraphPass& pass = this->passes[i];
+        if (pass.subpass == RenderGraph::unused) { continue; }
+
+        for (uint32_t j = 0; j < pass.uses.size(); j++) {
+            GraphResource& resource = this->resources[pass.uses[j].first];
+            if (resource.attachment == RenderGraph::unused) {
+                // Transient attachments have nothing in them before their first use, so they better be written by it
+                if (!resource.imported && !usage_writes(pass.uses[j].second)) {
+                    logger.fatalc(RenderGraph::channel, "Pass '", pass.name, "' reads transient attachment '", resource.name, "' before any pass wrote it.");
+                }
+                resource.attachment = order.size();
+                resource.first_use = pass.subpass;
+                order.push_back(pass.uses[j].first);
+            }
+            resource.last_use = pass.subpass;
+            resource.image_usage |= usage_image_flags(pass.uses[j].second) | resource.export_usage;
+        }
+    }
+
+    // Give each transient attachment the first slot that's free again by the time it's first used. Since the attachments are sorted by first use, this greedily packs them in as few slots as possible. Depth and colour attachments don't share memory, since they often need different memory types, and exported attachments keep their slot until after the last subpass
+    Tools::Array<uint32_t> slot_end;
+    Tools::Array<bool> slot_depth;
+    for (uint32_t i = 0; i < order.size(); i++) {
+        GraphResource& resource = this->resources[order[i]];
+        if (resource.imported) { continue; }
+
+        bool depth = is_depth_format(resource.format);
+        uint32_t slot_end_use = resource.exported ? this->n_subpasses : resource.last_use;
+        for (uint32_t s = 0; s < slot_end.size(); s++) {
+            if (slot_end[s] < resource.first_use && slot_depth[s] == depth) {
+                resource.slot = s;
+                break;
+            }
+        }
+        if (resource.slot == RenderGraph::unused) {
+            resource.slot = slot_end.size();
+            slot_end.push_back(slot_end_use);
+            slot_depth.push_back(depth);
+        } else {
+            slot_end[resource.slot] = slot_end_use;
+        }
+    }
+    this->n_slots = slot_end.size();
+}
+
+/* Private helper function that builds the render pass from the surviving passes, with only the dependencies their attachments need. */
+void RenderGraph::_build_render_pass() {
+    // Collect the attachments in the order of their first use, and remember how each of them was last used & by which subpass
+    Tools::Array<uint32_t> order(RenderGraph::unused, this->resources.size());
+    uint32_t n_attachments = 0;
+    for (uint32_t i = 0; i < this->resources.size(); i++) {
+        if (this->resources[i].attachment != RenderGraph::unused) {
+            order[this->resources[i].attachment] = i;
+            ++n_attachments;
+        }
+    }
+    Tools::Array<bool> seen(false, this->resources.size());
+    Tools::Array<AttachmentUsage> first_usage(AttachmentUsage::colour, this->resources.size());
+    Tools::Array<AttachmentUsage> last_usage(AttachmentUsage::colour, this->resources.size());
+    Tools::Array<uint32_t> last_subpass(RenderGraph::unused, this->resources.size());
+    Tools::Array<uint32_t> slot_owner(RenderGraph::unused, this->n_slots);
+    Tools::Array<uint32_t> slot_users((uint32_t) 0, this->n_slots);
+    for (uint32_t i = 0; i < n_attachments; i++) {
+        const GraphResource& resource = this->resources[order[i]];
+        if (!resource.imported) { ++slot_users[resource.slot]; }
+    }
+
+    // Walk through the passes to define the subpasses and the dependencies between them
+    Tools::Array<VkSubpassDependency> dependencies;
+    Tools::Array<Tools::Array<std::pair<uint32_t, VkImageLayout>>> colour_refs;
+    Tools::Array<std::pair<uint32_t, VkImageLayout>> depth_refs;
+    Tools::Array<Tools::Array<std::pair<uint32_t, VkImageLayout>>> input_refs;
+    for (uint32_t i = 0; i < this->passes.size(); i++) {
+        const GraphPass& pass = this->passes[i];
+        if (pass.subpass == RenderGraph::unused) { continue; }
+
+        colour_refs.push_back(Tools::Array<std::pair<uint32_t, VkImageLayout>>());
+        depth_refs.push_back(std::make_pair((uint32_t) VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED));
+        input_refs.push_back(Tools::Array<std::pair<uint32_t, VkImageLayout>>());
+        for (uint32_t j = 0; j < pass.uses.size(); j++) {
+            uint32_t r = pass.uses[j].first;
+            AttachmentUsage usage = pass.uses[j].second;
+            const GraphResource& resource = this->resources[r];
+
+            // Reference the attachment in the subpass
+            std::pair<uint32_t, VkImageLayout> ref = std::make_pair(resource.attachment, usage_layout(usage, resource.format));
+            if (usage == AttachmentUsage::colour) {
+                colour_refs.last().push_back(ref);
+            } else if (usage == AttachmentUsage::input) {
+                input_refs.last().push_back(ref);
+            } else {
+                if (depth_refs.last().first != VK_ATTACHMENT_UNUSED) {
+                    logger.fatalc(RenderGraph::channel, "Pass '", pass.name, "' uses more than one depth attachment.");
+                }
+                depth_refs.last() = ref;
+            }
+
+            // Depend on the previous subpass that used it, if either of them writes it or the layout changes
+            if (!seen[r]) {
+                // The first use depends on whatever happened to the attachment before the render pass, such as the previous frame or acquiring the swapchain image. Exported attachments are also read by shaders after the previous frame's render pass, which have to be done before we overwrite it
+                VkSubpassDependency& dependency = merge_dependency(dependencies, VK_SUBPASS_EXTERNAL, pass.subpass, usage, usage);
+                if (resource.exported) { dependency.srcStageMask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT; }
+                if (resource.export_usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) { dependency.srcStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT; }
+                first_usage[r] = usage;
+                seen[r] = true;
+
+                // If this transient attachment shares its memory with one that was used before, wait for that one to be done with it
+                if (!resource.imported) {
+                    uint32_t previous = slot_owner[resource.slot];
+                    if (previous != RenderGraph::unused) {
+                        merge_dependency(dependencies, last_subpass[previous], pass.subpass, last_usage[previous], usage);
+                    }
+                    slot_owner[resource.slot] = r;
+                }
+            } else if (last_subpass[r] != pass.subpass && (usage_writes(last_usage[r]) || usage_writes(usage) || usage_layout(last_usage[r], resource.format) != usage_layout(usage, resource.format))) {
+                merge_dependency(dependencies, last_subpass[r], pass.subpass, last_usage[r], usage);
+            }
+            last_usage[r] = usage;
+            last_subpass[r] = pass.subpass;
+        }
+    }
+
+    // Exported attachments are read by shaders (or copied from, if they're transfer sources) after the render pass, which have to wait until the last subpass that used them is done writing
+    for (uint32_t i = 0; i < n_attachments; i++) {
+        const GraphResource& resource = this->resources[order[i]];
+        if (!resource.exported) { continue; }
+        VkSubpassDependency& dependency = merge_dependency(dependencies, last_subpass[order[i]], VK_SUBPASS_EXTERNAL, last_usage[order[i]], AttachmentUsage::input);
+        dependency.dstStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        dependency.dstAccessMask = (dependency.dstAccessMask & ~VK_ACCESS_INPUT_ATTACHMENT_READ_BIT) | VK_ACCESS_SHADER_READ_BIT;
+        if (resource.export_usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+            dependency.dstStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+            dependency.dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+        }
+    }
+
+    // Now define the render pass
+    this->_render_pass = Rendering::RenderPass(this->gpu);
+    // With several views, every subpass renders to all of them at once, each to its own layer of the attachments
+    if (this->n_views > 1) { this->_render_pass.set_view_mask((1U << this->n_views) - 1); }
+    for (uint32_t i = 0; i < n_attachments; i++) {
+        const GraphResource& resource = this->resources[order[i]];
+
+        // Clear the attachment if its first use overwrites it anyway, and only keep the results if something outside of the graph needs them
+        bool clear = usage_writes(first_usage[order[i]]);
+        VkAttachmentLoadOp load_op = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        bool keep = resource.imported || resource.exported;
+        VkAttachmentStoreOp store_op = keep ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        VkImageLayout initial_layout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : resource.final_layout;
+        VkImageLayout final_layout = keep ? resource.final_layout : usage_layout(last_usage[order[i]], resource.format);
+
+        // Tell Vulkan if the attachment shares memory with another
+        VkAttachmentDescriptionFlags flags = !resource.imported && slot_users[resource.slot] > 1 ? VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT : 0;
+        this->_render_pass.add_attachment(resource.format, load_op, store_op, initial_layout, final_layout, flags);
+    }
+    for (uint32_t i = 0; i < this->n_subpasses; i++) {
+        this->_render_pass.add_subpass(colour_refs[i], depth_refs[i], input_refs[i]);
+    }
+    for (uint32_t i = 0; i < dependencies.size(); i++) {
+        const VkSubpassDependency& dependency = dependencies[i];
+        // Each view only ever touches its own layer, so with several views, a subpass only has to wait for the same view of the one before it
+        VkDependencyFlags flags = dependency.dependencyFlags;
+        if (this->n_views > 1 && dependency.srcSubpass != VK_SUBPASS_EXTERNAL && dependency.dstSubpass != VK_SUBPASS_EXTERNAL) { flags |= VK_DEPENDENCY_VIEW_LOCAL_BIT_KHR; }
+        this->_render_pass.add_dependency(dependency.srcSubpass, dependency.dstSubpass, dependency.srcStageMask, dependency.srcAccessMask, dependency.dstStageMask, dependency.dstAccessMask, flags);
+    }
+    this->_render_pass.finalize();
+
+    // Done
+    logger.logc(Verbosity::details, RenderGraph::channel, "Compiled ", this->n_subpasses, " subpasses with ", n_attachments, " attachments in ", this->n_slots, " transient memory slots and ", dependencies.size(), " dependencies.");
+}
+
+
+
+/* Adds a new pass with the given name after the existing ones. Returns the index of the pass in the graph. */
+uint32_t RenderGraph::add_pass(const std::string& name) {
+    GraphPass pass;
+    pass.name = name;
+    pass.subpass = RenderGraph::unused;
+
+    this->passes.push_back(pass);
+    this->compiled = false;
+    return this->passes.size() - 1;
+}
+
+/* Declares that the given transient attachment is read outside of the graph once it's done (e.g., by a compute shader), which needs the given image usage. Its contents are then kept in the given layout, and it never shares its memory with attachments that are used after it. */
+void RenderGraph::export_attachment(uint32_t resource, VkImageLayout final_layout, VkImageUsageFlags image_usage) {
+    #ifndef NDEBUG
+    if (resource >= this->resources.size()) { logger.fatalc(RenderGraph::channel, "Attachment index ", resource, " is out of bounds for graph with ", this->resources.size(), " attachments."); }
+    if (this->resources[resource].imported) { logger.fatalc(RenderGraph::channel, "Cannot export attachment '", this->resources[resource].name, "', since it's imported and thus already kept."); }
+    #endif
+
+    this->resources[resource].exported = true;
+    this->resources[resource].final_layout = final_layout;
+    this->resources[resource].export_usage = image_usage;
+    this->compiled = false;
+}
+
+/* Declares that the given pass uses the given attachment in the given way. */
+void RenderGraph::use(uint32_t pass, uint32_t resource, Rendering::AttachmentUsage usage) {
+    #ifndef NDEBUG
+    if (pass >= this->passes.size()) { logger.fatalc(RenderGraph::channel, "Pass index ", pass, " is out of bounds for graph with ", this->passes.size(), " passes."); }
+    if (resource >= this->resources.size()) { logger.fatalc(RenderGraph::channel, "Attachment index ", resource, " is out of bounds for graph with ", this->resources.size(), " attachments."); }
+    bool depth = is_depth_format(this->resources[resource].format);
+    if ((usage == AttachmentUsage::colour && depth) || ((usage == AttachmentUsage::depth || usage == AttachmentUsage::depth_read) && !depth)) {
+        logger.fatalc(RenderGraph::channel, "Pass '", this->passes[pass].name, "' cannot use attachment '", this->resources[resource].name, "' with format ", vk_format_map[this->resources[resource].format], " as ", attachment_usage_names[(int) usage], " attachment.");
+    }
+    #endif
+
+    this->passes[pass].uses.push_back(std::make_pair(resource, usage));
+    this->compiled = false;
+}
+
+/* Sets the number of views each pass renders to. If more than one, each attachment gets a layer per view, and the passes draw to all of them at once using multiview; imported attachments only have a single layer, so they can't be used by any pass then. Needs the GPU to support multiview. */
+void RenderGraph::set_views(uint32_t n_views) {
+    #ifndef NDEBUG
+    if (n_views == 0 || n_views > 32) { logger.fatalc(RenderGraph::channel, "Cannot render to ", n_views, " views; the number of views has to be between 1 and 32."); }
+    if (n_views > 1 && !this->gpu.supports_multiview()) { logger.fatalc(RenderGraph::channel, "Cannot render to several views on a GPU without multiview support."); }
+    #endif
+
+    this->n_views = n_views;
+    this->compiled = false;
+}
+
+
+
+/* Compiles the graph: culls the passes whose results are never used, builds the render pass and decides which transient attachments share memory. Must be called after the graph is changed and before it's used. */
+void RenderGraph::compile() {
+    logger.logc(Verbosity::details, RenderGraph::channel, "Compiling graph with ", this->passes.size(), " passes and ", this->resources.size(), " attachments...");
+
+    this->_cull();
+    this->_compute_lifetimes();
+    #ifndef NDEBUG
+    if (this->n_views > 1) {
+        for (uint32_t i = 0; i < this->resources.size(); i++) {
+            if (this->resources[i].imported && this->resources[i].attachment != RenderGraph::unused) { logger.fatalc(RenderGraph::channel, "Imported attachment '", this->resources[i].name, "' cannot be used when rendering to ", this->n_views, " views."); }
+        }
+    }
+    #endif
+    this->_build_render_pass();
+    this->compiled = true;
+}
+
+
+
+/* Returns the best depth format supported by the given GPU. */
+VkFormat RenderGraph::depth_format(const Rendering::GPU& gpu) {
+    // Go through the list of suggested formats
+    Tools::Array<VkFormat> candidates = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT };
+    for (uint32_t i = 0; i < candidates.size(); i++) {
+        // Query the properties of this format on the device
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(gpu, candidates[i], &properties);
+
+        // If the format is supported for depth stencil attachments, pick it
+        if ((properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) == VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            return candidates[i];
+        }
+    }
+
+    // Otherwise, no format we like
+    logger.fatalc(RenderGraph::channel, "Could not find a supported depth format.");
+    return VK_FORMAT_MAX_ENUM;
+}
+
+
+
+/* Swap operator for the RenderGraph class. */
+void Rendering::swap(RenderGraph& rg1, RenderGraph& rg2) {
+    #ifndef NDEBUG
+    if (rg1.gpu != rg2.gpu) { logger.fatalc(RenderGraph::channel, "Cannot swap render graphs with different GPUs"); }
+    #endif
+
+    using std::swap;
+
+    swap(rg1.resources, rg2.resources);
+    swap(rg1.passes, rg2.passes);
+    swap(rg1._render_pass, rg2._render_pass);
+    swap(rg1.n_views, rg2.n_views);
+    swap(rg1.n_subpasses, rg2.n_subpasses);
+    swap(rg1.n_slots, rg2.n_slots);
+    swap(rg1.compiled, rg2.compiled);
+}
@@ -0,0 +1,197 @@
+/* RENDER GRAPH.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RenderGraph class, which describes a frame as a list of
+ *   passes that declare which attachments they read and write. From
+ *   that, it culls the passes whose results are never used, compiles
+ *   the rest to a single RenderPass with one subpass each and only the
+ *   subpass dependencies that the attachments actually need, and
+ *   decides which of its own (transient) attachments can share memory
+ *   because they're never in use at the same time.
+**/
+
+#ifndef RENDERING_RENDER_GRAPH_HPP
+#define RENDERING_RENDER_GRAPH_HPP
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../renderpass/RenderPass.hpp"
+
+namespace Makma3D::Rendering {
+    /* The ways a pass can use one of the RenderGraph's attachments. */
+    enum class AttachmentUsage {
+        /* The pass writes colours to the attachment. */
+        colour = 0,
+        /* The pass tests against the depth values in the attachment and writes new ones. */
+        depth = 1,
+        /* The pass only tests against the depth values in the attachment, without writing them. */
+        depth_read = 2,
+        /* The pass reads the attachment as an input attachment in its fragment shader. */
+        input = 3
+    };
+
+    /* Maps AttachmentUsage values to readable strings. */
+    static const std::string attachment_usage_names[] = {
+        "colour",
+        "depth",
+        "depth_read",
+        "input"
+    };
+
+
+
+    /* A single attachment in the RenderGraph. */
+    struct GraphResource {
+        /* The name of the attachment, for debugging purposes. */
+        std::string name;
+        /* The format of the attachment. */
+        VkFormat format;
+        /* Whether the attachment lives outside of the graph (e.g., a swapchain image). If so, its contents are kept once the graph is done. Otherwise, it's a transient attachment, which is owned by the graph and discarded after its last use. */
+        bool imported;
+        /* Whether a transient attachment is read outside of the graph once it's done (e.g., by a compute shader), in which case its contents are kept as well. */
+        bool exported;
+        /* The layout an imported or exported attachment should be in once the graph is done. */
+        VkImageLayout final_layout;
+        /* The image usage flags an exported attachment needs to be read outside of the graph. */
+        VkImageUsageFlags export_usage;
+
+        /* The index of the attachment in the compiled render pass, or RenderGraph::unused if no pass that survived culling uses it. */
+        uint32_t attachment;
+        /* The first subpass that uses the attachment. */
+        uint32_t first_use;
+        /* The last subpass that uses the attachment. */
+        uint32_t last_use;
+        /* The image usage flags the attachment needs to be used by all of its passes. */
+        VkImageUsageFlags image_usage;
+        /* The memory slot of a transient attachment. Transient attachments in the same slot are never used at the same time, and thus share memory. */
+        uint32_t slot;
+    };
+
+    /* A single pass in the RenderGraph. */
+    struct GraphPass {
+        /* The name of the pass, for debugging purposes. */
+        std::string name;
+        /* The attachments used by the pass, and how. */
+        Tools::Array<std::pair<uint32_t, AttachmentUsage>> uses;
+
+        /* The subpass this pass was compiled to, or RenderGraph::unused if it was culled. */
+        uint32_t subpass;
+    };
+
+
+
+    /* The RenderGraph class, which compiles a list of passes and the attachments they use to a RenderPass. */
+    class RenderGraph {
+    public:
+        /* Channel name for the RenderGraph class. */
+        static constexpr const char* channel = "RenderGraph";
+        /* Marks passes that were culled and attachments that aren't used by any pass. */
+        static constexpr const uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+        /* The GPU where the RenderGraph lives. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The attachments in the graph, in the order they were added. */
+        Tools::Array<Rendering::GraphResource> resources;
+        /* The passes in the graph, in the order they are executed. */
+        Tools::Array<Rendering::GraphPass> passes;
+
+        /* The render pass the graph is compiled to. */
+        Rendering::RenderPass _render_pass;
+        /* The number of views each pass renders to. If more than one, the attachments have a layer per view, and the render pass uses multiview to draw all of them at once. */
+        uint32_t n_views;
+        /* The number of subpasses in the compiled render pass, i.e., the number of passes that survived culling. */
+        uint32_t n_subpasses;
+        /* The number of memory slots needed for the transient attachments. */
+        uint32_t n_slots;
+        /* Whether the graph has been compiled since it was last changed. */
+        bool compiled;
+
+        /* Private helper function that adds an attachment to the graph. */
+        uint32_t _add_resource(const std::string& name, VkFormat format, bool imported, VkImageLayout final_layout);
+        /* Private helper function that marks the passes whose results are never used as culled, and numbers the others as subpasses. */
+        void _cull();
+        /* Private helper function that computes when each attachment is used, and decides which transient attachments can share memory. */
+        void _compute_lifetimes();
+        /* Private helper function that builds the render pass from the surviving passes, with only the dependencies their attachments need. */
+        void _build_render_pass();
+
+    public:
+        /* Constructor for the RenderGraph class, which takes the GPU where it lives. */
+        RenderGraph(const Rendering::GPU& gpu);
+        /* Copy constructor for the RenderGraph class. */
+        RenderGraph(const RenderGraph& other);
+        /* Move constructor for the RenderGraph class. */
+        RenderGraph(RenderGraph&& other);
+        /* Destructor for the RenderGraph class. */
+        ~RenderGraph();
+
+        /* Adds an attachment that lives outside of the graph (e.g., a swapchain image) with the given name and format. Its contents are kept once the graph is done, in the given layout. Returns the index of the attachment in the graph. */
+        inline uint32_t import_attachment(const std::string& name, VkFormat format, VkImageLayout final_layout) { return this->_add_resource(name, format, true, final_layout); }
+        /* Adds a transient attachment with the given name and format, which is allocated by the graph's GraphAttachments and discarded after its last use. Returns the index of the attachment in the graph. */
+        inline uint32_t add_attachment(const std::string& name, VkFormat format) { return this->_add_resource(name, format, false, VK_IMAGE_LAYOUT_UNDEFINED); }
+        /* Declares that the given transient attachment is read outside of the graph once it's done (e.g., by a compute shader), which needs the given image usage. Its contents are then kept in the given layout, and it never shares its memory with attachments that are used after it. */
+        void export_attachment(uint32_t resource, VkImageLayout final_layout, VkImageUsageFlags image_usage);
+        /* Adds a new pass with the given name after the existing ones. Returns the index of the pass in the graph. */
+        uint32_t add_pass(const std::string& name);
+        /* Declares that the given pass uses the given attachment in the given way. */
+        void use(uint32_t pass, uint32_t resource, Rendering::AttachmentUsage usage);
+
+        /* Sets the number of views each pass renders to. If more than one, each attachment gets a layer per view, and the passes draw to all of them at once using multiview; imported attachments only have a single layer, so they can't be used by any pass then. Needs the GPU to support multiview. */
+        void set_views(uint32_t n_views);
+
+        /* Compiles the graph: culls the passes whose results are never used, builds the render pass and decides which transient attachments share memory. Must be called after the graph is changed and before it's used. */
+        void compile();
+
+        /* Returns the compiled render pass. */
+        inline const Rendering::RenderPass& render_pass() const { return this->_render_pass; }
+        /* Returns the subpass the given pass was compiled to, or RenderGraph::unused if it was culled. */
+        inline uint32_t subpass(uint32_t pass) const { return this->passes[pass].subpass; }
+        /* Returns whether the given pass was culled. */
+        inline bool culled(uint32_t pass) const { return this->passes[pass].subpass == RenderGraph::unused; }
+        /* Returns the attachment with the given index. */
+        inline const Rendering::GraphResource& resource(uint32_t index) const { return this->resources[index]; }
+        /* Returns the number of attachments in the graph. */
+        inline uint32_t size() const { return this->resources.size(); }
+        /* Returns the number of subpasses in the compiled render pass. */
+        inline uint32_t subpasses() const { return this->n_subpasses; }
+        /* Returns the number of views each pass renders to, which is also the number of layers of the transient attachments. */
+        inline uint32_t views() const { return this->n_views; }
+        /* Returns the number of memory slots the transient attachments need. */
+        inline uint32_t slots() const { return this->n_slots; }
+        /* Returns whether the graph has been compiled since it was last changed. */
+        inline bool is_compiled() const { return this->compiled; }
+
+        /* Returns the best depth format supported by the given GPU. */
+        static VkFormat depth_format(const Rendering::GPU& gpu);
+
+        /* Copy assignment operator for the RenderGraph class. */
+        inline RenderGraph& operator=(const RenderGraph& other) { return *this = RenderGraph(other); }
+        /* Move assignment operator for the RenderGraph class. */
+        inline RenderGraph& operator=(RenderGraph&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the RenderGraph class. */
+        friend void swap(RenderGraph& rg1, RenderGraph& rg2);
+
+    };
+
+    /* Swap operator for the RenderGraph class. */
+    void swap(RenderGraph& rg1, RenderGraph& rg2);
+
+}
+
+#endif
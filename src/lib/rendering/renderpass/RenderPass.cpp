@@ -4,7 +4,7 @@
  * Created:
  *   27/06/2021, 12:26:36
  * Last edited:
- *   27/06/2021, 12:26:36
+ *   19/10/2026, 02:41:16
  * Auto updated?
  *   Yes
  *
@@ -27,9 +27,10 @@ using namespace Makma3D::Rendering;
 
 /***** POPULATE FUNCTIONS *****/
 /* Populates the given VkAttachmentDescription struct. */
-static void populate_attachment(VkAttachmentDescription& attachment, VkFormat vk_format, VkAttachmentLoadOp vk_load_op, VkAttachmentStoreOp vk_store_op, VkImageLayout vk_initial_layout, VkImageLayout vk_final_layout) {
+static void populate_attachment(VkAttachmentDescription& attachment, VkFormat vk_format, VkAttachmentLoadOp vk_load_op, VkAttachmentStoreOp vk_store_op, VkImageLayout vk_initial_layout, VkImageLayout vk_final_layout, VkAttachmentDescriptionFlags flags) {
     // Set to default
     attachment = {};
+    attachment.flags = flags;
 
     // Set the format of the output framebuffer
     attachment.format = vk_format;
@@ -51,9 +52,10 @@ static void populate_attachment(VkAttachmentDescription& attachment, VkFormat vk
 }
 
 /* Populates the given VkSubpassDependency struct. */
-static void populate_dependency(VkSubpassDependency& dependency, uint32_t src_subpass, uint32_t dst_subpass, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) {
+static void populate_dependency(VkSubpassDependency& dependency, uint32_t src_subpass, uint32_t dst_subpass, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access, VkDependencyFlags flags) {
     // Set to default
     dependency = {};
+    dependency.dependencyFlags = flags;
     
     // Set the subpasses in question
     dependency.srcSubpass = src_subpass;
@@ -68,11 +70,31 @@ static void populate_dependency(VkSubpassDependency& dependency, uint32_t src_su
     dependency.dstAccessMask = dst_access;
 }
 
-/* Populates the given VkRenderPassCreateInfo struct. */
-static void populate_render_pass_info(VkRenderPassCreateInfo& render_pass_info, const Tools::Array<VkAttachmentDescription>& vk_attachments, const Tools::Array<VkSubpassDescription>& vk_subpasses, const Tools::Array<VkSubpassDependency>& vk_dependencies) {
+/* Populates the given VkRenderPassMultiviewCreateInfoKHR struct, which has each subpass render to the views in the given list of masks. All views are assumed to be correlated, i.e., to look at roughly the same part of the scene. */
+static void populate_multiview_info(VkRenderPassMultiviewCreateInfoKHR& multiview_info, const Tools::Array<uint32_t>& view_masks, const uint32_t& correlation_mask) {
+    // Set to default
+    multiview_info = {};
+    multiview_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO_KHR;
+
+    // Set the views of each subpass
+    multiview_info.subpassCount = view_masks.size();
+    multiview_info.pViewMasks = view_masks.rdata();
+
+    // The dependencies are between the same views of each subpass, so they don't need any offsets
+    multiview_info.dependencyCount = 0;
+    multiview_info.pViewOffsets = nullptr;
+
+    // Tell the implementation that it may render the views concurrently
+    multiview_info.correlationMaskCount = 1;
+    multiview_info.pCorrelationMasks = &correlation_mask;
+}
+
+/* Populates the given VkRenderPassCreateInfo struct. Any extension structs (such as for multiview) can be chained to it with the given next pointer. */
+static void populate_render_pass_info(VkRenderPassCreateInfo& render_pass_info, const Tools::Array<VkAttachmentDescription>& vk_attachments, const Tools::Array<VkSubpassDescription>& vk_subpasses, const Tools::Array<VkSubpassDependency>& vk_dependencies, const void* next = nullptr) {
     // Set to default
     render_pass_info = {};
     render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_info.pNext = next;
 
     // Attach the attachments
     render_pass_info.attachmentCount = vk_attachments.size();
@@ -115,7 +137,8 @@ static void populate_begin_info(VkRenderPassBeginInfo& begin_info, const VkRende
 /* Constructor for the RenderPass class, which takes a GPU, */
 RenderPass::RenderPass(const Rendering::GPU& gpu) :
     gpu(gpu),
-    vk_render_pass(nullptr)
+    vk_render_pass(nullptr),
+    vk_view_mask(0)
 {
     logger.logc(Verbosity::important, RenderPass::channel, "Initializing...");
 
@@ -128,7 +151,8 @@ RenderPass::RenderPass(const Rendering::GPU& gpu) :
 RenderPass::RenderPass(const RenderPass& other) :
     gpu(other.gpu),
     vk_attachments(other.vk_attachments),
-    vk_dependencies(other.vk_dependencies)
+    vk_dependencies(other.vk_dependencies),
+    vk_view_mask(other.vk_view_mask)
 {
     logger.logc(Verbosity::debug, RenderPass::channel, "Copying...");    
 
@@ -140,9 +164,14 @@ RenderPass::RenderPass(const RenderPass& other) :
             vk_subpasses.push_back(this->subpasses[i]);
         }
 
+        // If we render to several views, each subpass renders to all of them
+        Tools::Array<uint32_t> view_masks(this->vk_view_mask, this->subpasses.size());
+        VkRenderPassMultiviewCreateInfoKHR multiview_info;
+        populate_multiview_info(multiview_info, view_masks, this->vk_view_mask);
+
         // Simply create the renderpass
         VkRenderPassCreateInfo render_pass_info;
-        populate_render_pass_info(render_pass_info, this->vk_attachments, vk_subpasses, this->vk_dependencies);
+        populate_render_pass_info(render_pass_info, this->vk_attachments, vk_subpasses, this->vk_dependencies, this->vk_view_mask != 0 ? &multiview_info : nullptr);
 
         VkResult vk_result;
         if ((vk_result = vkCreateRenderPass(this->gpu, &render_pass_info, nullptr, &this->vk_render_pass)) != VK_SUCCESS) {
@@ -159,7 +188,8 @@ RenderPass::RenderPass(RenderPass&& other) :
     vk_render_pass(other.vk_render_pass),
     subpasses(other.subpasses),
     vk_attachments(other.vk_attachments),
-    vk_dependencies(other.vk_dependencies)
+    vk_dependencies(other.vk_dependencies),
+    vk_view_mask(other.vk_view_mask)
 {
     // Be sure that the other object does not allocate anything we need
     other.vk_render_pass = nullptr;
@@ -179,11 +209,11 @@ RenderPass::~RenderPass() {
 
 
 
-/* Adds a new attachment to the RenderPass. Note that the ordering matters w.r.t. indexing, but just to be sure, this function returns the index of the attachment. Takes the swapchain's image format, the load operation for the buffer, the store operation, the initial layout and the final layout after the subpass. */
-uint32_t RenderPass::add_attachment(VkFormat vk_swapchain_format, VkAttachmentLoadOp load_op, VkAttachmentStoreOp store_op, VkImageLayout initial_layout, VkImageLayout final_layout) {
+/* Adds a new attachment to the RenderPass. Note that the ordering matters w.r.t. indexing, but just to be sure, this function returns the index of the attachment. Takes the swapchain's image format, the load operation for the buffer, the store operation, the initial layout, the final layout after the subpass and optionally any attachment flags (such as whether it shares memory with other attachments). */
+uint32_t RenderPass::add_attachment(VkFormat vk_swapchain_format, VkAttachmentLoadOp load_op, VkAttachmentStoreOp store_op, VkImageLayout initial_layout, VkImageLayout final_layout, VkAttachmentDescriptionFlags flags) {
     // First, populate the attachmentdescription
     VkAttachmentDescription attachment;
-    populate_attachment(attachment, vk_swapchain_format, load_op, store_op, initial_layout, final_layout);
+    populate_attachment(attachment, vk_swapchain_format, load_op, store_op, initial_layout, final_layout, flags);
 
     // Add it to the list
     uint32_t index = this->vk_attachments.size();
@@ -194,24 +224,24 @@ uint32_t RenderPass::add_attachment(VkFormat vk_swapchain_format, VkAttachmentLo
     return index;
 }
 
-/* Adds a new subpass to the RenderPass. The list of indices determines which color attachments to link to the subpass, and the list of image layouts determines the layout we like during the subpass for that attachment. Optionally takes another bindpoint than the graphics bind point. */
-void RenderPass::add_subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, VkPipelineBindPoint bind_point) {
+/* Adds a new subpass to the RenderPass. The list of indices determines which color attachments to link to the subpass, and the list of image layouts determines the layout we like during the subpass for that attachment. Optionally takes a list of attachments read in the fragment shader and another bindpoint than the graphics bind point. */
+void RenderPass::add_subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, const Tools::Array<std::pair<uint32_t, VkImageLayout>>& input_attachment_refs, VkPipelineBindPoint bind_point) {
     
 
     // Store that and the list of references internally
-    this->subpasses.push_back(Subpass(color_attachment_refs, depth_attachment_ref, bind_point));
+    this->subpasses.push_back(Subpass(color_attachment_refs, depth_attachment_ref, input_attachment_refs, bind_point));
 
     // Done
     logger.logc(Verbosity::details, RenderPass::channel, "Added subpass to the RenderPass.");
 }
 
-/* Adds a new dependency to the RenderPass. Needs the subpass before the barrier, the subpass after it, the stage of the subpass before it, the access mask of the stage before it, the stage of the subpass after it and the access mask of that stage. */
-void RenderPass::add_dependency(uint32_t src_subpass, uint32_t dst_subpass, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) {
+/* Adds a new dependency to the RenderPass. Needs the subpass before the barrier, the subpass after it, the stage of the subpass before it, the access mask of the stage before it, the stage of the subpass after it, the access mask of that stage and optionally any dependency flags (such as whether it's per-region). */
+void RenderPass::add_dependency(uint32_t src_subpass, uint32_t dst_subpass, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access, VkDependencyFlags flags) {
     
 
     // Prepare the dependency definition
     VkSubpassDependency dependency;
-    populate_dependency(dependency, src_subpass, dst_subpass, src_stage, src_access, dst_stage, dst_access);
+    populate_dependency(dependency, src_subpass, dst_subpass, src_stage, src_access, dst_stage, dst_access, flags);
 
     // Store internally
     this->vk_dependencies.push_back(dependency);
@@ -220,6 +250,14 @@ void RenderPass::add_dependency(uint32_t src_subpass, uint32_t dst_subpass, VkPi
     logger.logc(Verbosity::details, RenderPass::channel, "Added dependency to the RenderPass.");
 }
 
+/* Sets the views that each subpass renders to as a bitmask, where each bit is a layer of the attachments. Zero (the default) renders to the attachments normally. Needs the GPU to support multiview if not zero, and must be set before the RenderPass is finalized. */
+void RenderPass::set_view_mask(uint32_t view_mask) {
+    #ifndef NDEBUG
+    if (view_mask != 0 && !this->gpu.supports_multiview()) { logger.fatalc(RenderPass::channel, "Cannot render to several views on a GPU without multiview support."); }
+    #endif
+    this->vk_view_mask = view_mask;
+}
+
 /* Finalizes the RenderPass. After this, no new subpasses can be defined without calling finalize() again. */
 void RenderPass::finalize() {
     // Convert the list of subpasses to their vulkan counterpart
@@ -228,9 +266,14 @@ void RenderPass::finalize() {
         vk_subpasses.push_back(this->subpasses[i].subpass());
     }
 
+    // If we render to several views, each subpass renders to all of them
+    Tools::Array<uint32_t> view_masks(this->vk_view_mask, this->subpasses.size());
+    VkRenderPassMultiviewCreateInfoKHR multiview_info;
+    populate_multiview_info(multiview_info, view_masks, this->vk_view_mask);
+
     // Simply create the renderpass
     VkRenderPassCreateInfo render_pass_info;
-    populate_render_pass_info(render_pass_info, this->vk_attachments, vk_subpasses, this->vk_dependencies);
+    populate_render_pass_info(render_pass_info, this->vk_attachments, vk_subpasses, this->vk_dependencies, this->vk_view_mask != 0 ? &multiview_info : nullptr);
 
     VkResult vk_result;
     if ((vk_result = vkCreateRenderPass(this->gpu, &render_pass_info, nullptr, &this->vk_render_pass)) != VK_SUCCESS) {
@@ -243,23 +286,32 @@ void RenderPass::finalize() {
 
 
 
-/* Schedules the RenderPass to run in the given CommandBuffer. Also takes a framebuffer to render to and a background colour for the image. */
-void RenderPass::start_scheduling(const Rendering::CommandBuffer* cmd, const VkFramebuffer& vk_framebuffer, const VkExtent2D& vk_extent, const VkClearValue& vk_clear_colour, const VkClearValue& vk_clear_depth) const {
+/* Schedules the RenderPass to run in the given CommandBuffer. Also takes a framebuffer to render to, whether the first subpass is recorded inline or in secondary command buffers and a background colour for the colour attachments and a clear value for the depth attachments. */
+void RenderPass::start_scheduling(const Rendering::CommandBuffer* cmd, const VkFramebuffer& vk_framebuffer, const VkExtent2D& vk_extent, VkSubpassContents vk_subpass_contents, const VkClearValue& vk_clear_colour, const VkClearValue& vk_clear_depth) const {
     // First, create the rect that we shall render to
     VkRect2D render_area = {};
     render_area.offset.x = 0;
     render_area.offset.y = 0;
     render_area.extent = vk_extent;
 
-    // Define the list of clear colours
-    Tools::Array<VkClearValue> clear_values = { vk_clear_colour, vk_clear_depth };
+    // Define the list of clear colours, one per attachment
+    Tools::Array<VkClearValue> clear_values(this->vk_attachments.size());
+    for (uint32_t i = 0; i < this->vk_attachments.size(); i++) {
+        clear_values.push_back(is_depth_format(this->vk_attachments[i].format) ? vk_clear_depth : vk_clear_colour);
+    }
 
     // Create the begin info and populate it
     VkRenderPassBeginInfo begin_info;
     populate_begin_info(begin_info, this->vk_render_pass, vk_framebuffer, render_area, clear_values);
 
-    // Schedule it in the command buffer (and tell it to schedule everything in the primary command buffers instead of secondary ones)
-    vkCmdBeginRenderPass(cmd->vulkan(), &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    // Schedule it in the command buffer (and tell it whether the subpass is recorded inline or in secondary command buffers)
+    vkCmdBeginRenderPass(cmd->vulkan(), &begin_info, vk_subpass_contents);
+}
+
+/* Moves the scheduled RenderPass in the given CommandBuffer on to its next subpass, which is either recorded inline or in secondary command buffers. */
+void RenderPass::next_subpass(const Rendering::CommandBuffer* cmd, VkSubpassContents vk_subpass_contents) const {
+    // Simply call the next one
+    vkCmdNextSubpass(cmd->vulkan(), vk_subpass_contents);
 }
 
 /* Finishes scheduling the RenderPass. */
@@ -283,4 +335,5 @@ void Rendering::swap(RenderPass& rp1, RenderPass& rp2) {
     swap(rp1.subpasses, rp2.subpasses);
     swap(rp1.vk_attachments, rp2.vk_attachments);
     swap(rp1.vk_dependencies, rp2.vk_dependencies);
+    swap(rp1.vk_view_mask, rp2.vk_view_mask);
 }
@@ -4,7 +4,7 @@
  * Created:
  *   27/06/2021, 12:26:32
  * Last edited:
- *   27/06/2021, 12:26:32
+ *   19/10/2026, 02:41:16
  * Auto updated?
  *   Yes
  *
@@ -45,6 +45,8 @@ namespace Makma3D::Rendering {
         Tools::Array<VkAttachmentDescription> vk_attachments;
         /* List of subpass dependencies. */
         Tools::Array<VkSubpassDependency> vk_dependencies;
+        /* The views that each subpass renders to, as a bitmask of the attachments' layers. Zero if we don't use multiview. */
+        uint32_t vk_view_mask;
 
     public:
         /* Constructor for the RenderPass class, which takes a GPU,  */
@@ -56,20 +58,28 @@ namespace Makma3D::Rendering {
         /* Destructor for the RenderPass class. */
         ~RenderPass();
 
-        /* Adds a new attachment to the RenderPass. Note that the ordering matters w.r.t. indexing, but just to be sure, this function returns the index of the attachment. Takes the swapchain's image format, the load operation for the buffer, the store operation, the initial layout and the final layout after the subpass. */
-        uint32_t add_attachment(VkFormat vk_swapchain_format, VkAttachmentLoadOp load_op, VkAttachmentStoreOp store_op, VkImageLayout initial_layout, VkImageLayout final_layout);
-        /* Adds a new subpass to the RenderPass. The list of indices determines which color attachments to link to the subpass, and the list of image layouts determines the layout we like during the subpass for that attachment. Optionally takes another bindpoint than the graphics bind point. */
-        void add_subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS);
-        /* Adds a new dependency to the RenderPass. Needs the subpass before the barrier, the subpass after it, the stage of the subpass before it, the access mask of the stage before it, the stage of the subpass after it and the access mask of that stage. */
-        void add_dependency(uint32_t src_subpass, uint32_t dst_subpass, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access);
+        /* Adds a new attachment to the RenderPass. Note that the ordering matters w.r.t. indexing, but just to be sure, this function returns the index of the attachment. Takes the swapchain's image format, the load operation for the buffer, the store operation, the initial layout, the final layout after the subpass and optionally any attachment flags (such as whether it shares memory with other attachments). */
+        uint32_t add_attachment(VkFormat vk_swapchain_format, VkAttachmentLoadOp load_op, VkAttachmentStoreOp store_op, VkImageLayout initial_layout, VkImageLayout final_layout, VkAttachmentDescriptionFlags flags = 0);
+        /* Adds a new subpass to the RenderPass. The list of indices determines which color attachments to link to the subpass, and the list of image layouts determines the layout we like during the subpass for that attachment. Optionally takes a list of attachments read in the fragment shader and another bindpoint than the graphics bind point. */
+        void add_subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, const Tools::Array<std::pair<uint32_t, VkImageLayout>>& input_attachment_refs = {}, VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS);
+        /* Adds a new dependency to the RenderPass. Needs the subpass before the barrier, the subpass after it, the stage of the subpass before it, the access mask of the stage before it, the stage of the subpass after it, the access mask of that stage and optionally any dependency flags (such as whether it's per-region). */
+        void add_dependency(uint32_t src_subpass, uint32_t dst_subpass, VkPipelineStageFlags src_stage, VkAccessFlags src_access, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access, VkDependencyFlags flags = 0);
+        /* Sets the views that each subpass renders to as a bitmask, where each bit is a layer of the attachments. Zero (the default) renders to the attachments normally. Needs the GPU to support multiview if not zero, and must be set before the RenderPass is finalized. */
+        void set_view_mask(uint32_t view_mask);
         /* Finalizes the RenderPass. After this, no new subpasses can be defined without calling finalize() again. */
         void finalize();
 
-        /* Schedules the RenderPass to run in the given CommandBuffer. Also takes a framebuffer to render to and optionally a background colour for the image. */
-        void start_scheduling(const Rendering::CommandBuffer* cmd, const VkFramebuffer& vk_framebuffer, const VkExtent2D& vk_extent, const VkClearValue& vk_clear_colour = { 0.749f, 1.0f, 0.992f, 1.0f }, const VkClearValue& vk_clear_depth = { 1.0f, 0.0 }) const;
+        /* Schedules the RenderPass to run in the given CommandBuffer. Also takes a framebuffer to render to, whether the first subpass is recorded inline or in secondary command buffers and optionally a background colour for the colour attachments and a clear value for the depth attachments. */
+        void start_scheduling(const Rendering::CommandBuffer* cmd, const VkFramebuffer& vk_framebuffer, const VkExtent2D& vk_extent, VkSubpassContents vk_subpass_contents = VK_SUBPASS_CONTENTS_INLINE, const VkClearValue& vk_clear_colour = { 0.749f, 1.0f, 0.992f, 1.0f }, const VkClearValue& vk_clear_depth = { 1.0f, 0.0 }) const;
+        /* Moves the scheduled RenderPass in the given CommandBuffer on to its next subpass, which is either recorded inline or in secondary command buffers. */
+        void next_subpass(const Rendering::CommandBuffer* cmd, VkSubpassContents vk_subpass_contents = VK_SUBPASS_CONTENTS_INLINE) const;
         /* Finishes scheduling the RenderPass. */
         void stop_scheduling(const Rendering::CommandBuffer* cmd) const;
 
+        /* Returns the number of subpasses in the RenderPass. */
+        inline uint32_t n_subpasses() const { return this->subpasses.size(); }
+        /* Returns the views that each subpass renders to as a bitmask, or zero if the RenderPass doesn't use multiview. */
+        inline uint32_t view_mask() const { return this->vk_view_mask; }
         /* Expliticly returns the internal VkRenderPass object. */
         inline const VkRenderPass& vulkan() const { return this->vk_render_pass; }
         /* Implicitly returns the internal VkRenderPass object. */
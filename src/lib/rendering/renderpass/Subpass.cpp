@@ -4,7 +4,7 @@
  * Created:
  *   29/06/2021, 13:30:04
  * Last edited:
- *   8/1/2021, 3:37:09 PM
+ *   19/10/2026, 01:31:44
  * Auto updated?
  *   Yes
  *
@@ -25,7 +25,7 @@ using namespace Makma3D::Rendering;
 
 /***** POPULATE FUNCTIONS *****/
 /* Populates the given VkSubpassDescription struct. */
-static void populate_subpass(VkSubpassDescription& subpass, VkAttachmentReference* color_attachment_refs, uint32_t n_attachments, VkAttachmentReference* depth_attachment_ref, VkPipelineBindPoint bind_point) {
+static void populate_subpass(VkSubpassDescription& subpass, VkAttachmentReference* color_attachment_refs, uint32_t n_attachments, VkAttachmentReference* depth_attachment_ref, VkAttachmentReference* input_attachment_refs, uint32_t n_input_attachments, VkPipelineBindPoint bind_point) {
     // Set to default
     subpass = {};
 
@@ -39,8 +39,11 @@ static void populate_subpass(VkSubpassDescription& subpass, VkAttachmentReferenc
     // Set the depth attachment
     subpass.pDepthStencilAttachment = depth_attachment_ref;
 
+    // Set the attachments read by the fragment shader
+    subpass.inputAttachmentCount = n_input_attachments;
+    subpass.pInputAttachments = input_attachment_refs;
+
     // In the future, more types of attachments may be given here
-    subpass.inputAttachmentCount = 0;
     subpass.preserveAttachmentCount = 0;
 }
 
@@ -49,11 +52,13 @@ static void populate_subpass(VkSubpassDescription& subpass, VkAttachmentReferenc
 
 
 /***** SUBPASS CLASS *****/
-/* Constructor for the Subpass class, which takes a list of attachment index/layout pairs to describe the colour references, an index/layout pair for the depth reference and the bind point in the pipeline (which is usually the default of graphics). */
-Subpass::Subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, VkPipelineBindPoint bind_point) :
+/* Constructor for the Subpass class, which takes a list of attachment index/layout pairs to describe the colour references, an index/layout pair for the depth reference, optionally a list of index/layout pairs for attachments read in the fragment shader and the bind point in the pipeline (which is usually the default of graphics). */
+Subpass::Subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, const Tools::Array<std::pair<uint32_t, VkImageLayout>>& input_attachment_refs, VkPipelineBindPoint bind_point) :
     color_attachment_refs(new VkAttachmentReference[color_attachment_refs.size()]),
     n_color_attachments(color_attachment_refs.size()),
-    depth_attachment_ref(new VkAttachmentReference)
+    depth_attachment_ref(new VkAttachmentReference),
+    input_attachment_refs(new VkAttachmentReference[input_attachment_refs.size()]),
+    n_input_attachments(input_attachment_refs.size())
 {
     // Populate the attachment reference list
     for (uint32_t i = 0; i < this->n_color_attachments; i++) {
@@ -67,8 +72,15 @@ Subpass::Subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_a
     this->depth_attachment_ref->attachment = depth_attachment_ref.first;
     this->depth_attachment_ref->layout = depth_attachment_ref.second;
 
+    // Populate the input attachments
+    for (uint32_t i = 0; i < this->n_input_attachments; i++) {
+        this->input_attachment_refs[i] = {};
+        this->input_attachment_refs[i].attachment = input_attachment_refs[i].first;
+        this->input_attachment_refs[i].layout = input_attachment_refs[i].second;
+    }
+
     // With that and the bind point, populate the VkSubpassDescription struct
-    populate_subpass(this->vk_subpass, this->color_attachment_refs, this->n_color_attachments, this->depth_attachment_ref, bind_point);
+    populate_subpass(this->vk_subpass, this->color_attachment_refs, this->n_color_attachments, this->depth_attachment_ref, this->input_attachment_refs, this->n_input_attachments, bind_point);
 }
 
 /* Copy constructor for the Subpass class. */
@@ -76,14 +88,18 @@ Subpass::Subpass(const Subpass& other) :
     vk_subpass(other.vk_subpass),
     color_attachment_refs(new VkAttachmentReference[other.n_color_attachments]),
     n_color_attachments(other.n_color_attachments),
-    depth_attachment_ref(new VkAttachmentReference(*other.depth_attachment_ref))
+    depth_attachment_ref(new VkAttachmentReference(*other.depth_attachment_ref)),
+    input_attachment_refs(new VkAttachmentReference[other.n_input_attachments]),
+    n_input_attachments(other.n_input_attachments)
 {
-    // Copy the elements over from the old to the new list of attachment references
+    // Copy the elements over from the old to the new lists of attachment references
     memcpy(this->color_attachment_refs, other.color_attachment_refs, this->n_color_attachments * sizeof(VkAttachmentReference));
+    memcpy(this->input_attachment_refs, other.input_attachment_refs, this->n_input_attachments * sizeof(VkAttachmentReference));
 
-    // Mark the new array as the one in the internal list
+    // Mark the new arrays as the ones in the internal list
     this->vk_subpass.pColorAttachments = this->color_attachment_refs;
     this->vk_subpass.pDepthStencilAttachment = this->depth_attachment_ref;
+    this->vk_subpass.pInputAttachments = this->input_attachment_refs;
 }
 
 /* Move constructor for the Subpass class. */
@@ -91,11 +107,14 @@ Subpass::Subpass(Subpass&& other) :
     vk_subpass(other.vk_subpass),
     color_attachment_refs(other.color_attachment_refs),
     n_color_attachments(other.n_color_attachments),
-    depth_attachment_ref(other.depth_attachment_ref)
+    depth_attachment_ref(other.depth_attachment_ref),
+    input_attachment_refs(other.input_attachment_refs),
+    n_input_attachments(other.n_input_attachments)
 {
-    // Make sure the list is not deallocated
+    // Make sure the lists are not deallocated
     other.color_attachment_refs = nullptr;
     other.depth_attachment_ref = nullptr;
+    other.input_attachment_refs = nullptr;
 }
 
 /* Destructor for the Subpass class. */
@@ -107,6 +126,9 @@ Subpass::~Subpass() {
     if (this->color_attachment_refs != nullptr) {
         delete[] this->color_attachment_refs;
     }
+    if (this->input_attachment_refs != nullptr) {
+        delete[] this->input_attachment_refs;
+    }
 }
 
 
@@ -119,4 +141,6 @@ void Rendering::swap(Subpass& s1, Subpass& s2) {
     swap(s1.color_attachment_refs, s2.color_attachment_refs);
     swap(s1.n_color_attachments, s2.n_color_attachments);
     swap(s1.depth_attachment_ref, s2.depth_attachment_ref);
+    swap(s1.input_attachment_refs, s2.input_attachment_refs);
+    swap(s1.n_input_attachments, s2.n_input_attachments);
 }
@@ -4,7 +4,7 @@
  * Created:
  *   29/06/2021, 13:30:01
  * Last edited:
- *   29/06/2021, 13:30:01
+ *   19/10/2026, 01:31:44
  * Auto updated?
  *   Yes
  *
@@ -35,9 +35,14 @@ namespace Makma3D::Rendering {
         /* The depth attachment reference for this subpass. */
         VkAttachmentReference* depth_attachment_ref;
 
+        /* The input attachment references for this subpass. */
+        VkAttachmentReference* input_attachment_refs;
+        /* The number of input attachment references. */
+        uint32_t n_input_attachments;
+
     public:
-        /* Constructor for the Subpass class, which takes a list of attachment index/layout pairs to describe the colour references, an index/layout pair for the depth reference and the bind point in the pipeline (which is usually the default of graphics). */
-        Subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS);
+        /* Constructor for the Subpass class, which takes a list of attachment index/layout pairs to describe the colour references, an index/layout pair for the depth reference, optionally a list of index/layout pairs for attachments read in the fragment shader and the bind point in the pipeline (which is usually the default of graphics). */
+        Subpass(const Tools::Array<std::pair<uint32_t, VkImageLayout>>& color_attachment_refs, const std::pair<uint32_t, VkImageLayout>& depth_attachment_ref, const Tools::Array<std::pair<uint32_t, VkImageLayout>>& input_attachment_refs = {}, VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS);
         /* Copy constructor for the Subpass class. */
         Subpass(const Subpass& other);
         /* Move constructor for the Subpass class. */
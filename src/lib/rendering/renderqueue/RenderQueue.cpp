@@ -0,0 +1,153 @@
+/* RENDER QUEUE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 11:02:17
+ * Last edited:
+ *   19/10/2026, 01:35:58
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RenderQueue class, which collects all draws for a single
+ *   frame in a flat list and sorts them on a packed 64-bit key such that
+ *   they can be recorded with as few state changes as possible.
+**/
+
+#include <cstring>
+
+#include "tools/Logger.hpp"
+
+#include "RenderQueue.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** CONSTANTS *****/
+/* The number of bits per radix sort digit. */
+static constexpr const uint32_t radix_bits = 8;
+/* The number of buckets per radix sort digit. */
+static constexpr const uint32_t radix_size = 1 << radix_bits;
+/* The number of digits in a sort key. */
+static constexpr const uint32_t radix_passes = 64 / radix_bits;
+
+
+
+
+
+/***** RENDERQUEUE CLASS *****/
+/* Default constructor for the RenderQueue class. */
+RenderQueue::RenderQueue() :
+    items(64),
+    entries(64),
+    depth_entries(64),
+    scratch(64)
+{}
+
+
+
+/* Clears the queue, but leaves its memory intact so it can be re-used next frame. */
+void RenderQueue::clear() {
+    this->items.clear();
+    this->entries.clear();
+    this->depth_entries.clear();
+}
+
+/* Adds a new draw to the queue, which is at the given view-space depth. Negative depths (behind the camera) are clamped to zero. */
+void RenderQueue::push(const DrawItem& item, float depth) {
+    // Get the identifier for the material, assigning a new one if we haven't seen it before
+    std::unordered_map<const Materials::Material*, uint32_t>::iterator iter = this->material_ids.find(item.material);
+    if (iter == this->material_ids.end()) {
+        #ifndef NDEBUG
+        if (this->material_ids.size() >= (1ULL << RenderQueue::material_bits)) {
+            logger.fatalc(RenderQueue::channel, "Too many materials to fit in a sort key (", this->material_ids.size(), ")");
+        }
+        #endif
+        iter = this->material_ids.insert({ item.material, static_cast<uint32_t>(this->material_ids.size()) }).first;
+    }
+
+    // Add the item and its key, resizing more optimally
+    while (this->items.size() >= this->items.capacity()) { this->items.reserve(2 * this->items.capacity()); }
+    while (this->entries.size() >= this->entries.capacity()) { this->entries.reserve(2 * this->entries.capacity()); }
+    while (this->depth_entries.size() >= this->depth_entries.capacity()) { this->depth_entries.reserve(2 * this->depth_entries.capacity()); }
+    this->entries.push_back({ RenderQueue::make_key(static_cast<uint32_t>(item.material->type()), (*iter).second, depth), this->items.size() });
+    this->depth_entries.push_back({ RenderQueue::make_key(0, 0, depth), this->items.size() });
+    this->items.push_back(item);
+}
+
+/* Sorts the queue on pipeline first, then on material and finally front-to-back. Optionally also sorts all draws purely front-to-back, for passes that don't care about pipelines or materials (like a depth pre-pass). */
+void RenderQueue::sort(bool front_to_back) {
+    // Make sure the scratch space is large enough; it only ever grows, so this won't allocate in a steady state
+    this->scratch.reserve_opt(this->entries.capacity());
+
+    // Sort the entries
+    RenderQueue::radix_sort(this->entries.wdata(), this->scratch.wdata(), this->entries.size());
+    // Sort the depth-only entries if asked to. Since their upper digits are all zero, the radix sort skips those passes
+    if (front_to_back) {
+        RenderQueue::radix_sort(this->depth_entries.wdata(), this->scratch.wdata(), this->depth_entries.size());
+    }
+}
+
+
+
+/* Packs the given pipeline identifier, material identifier and depth into a single 64-bit sort key. */
+uint64_t RenderQueue::make_key(uint32_t pipeline_id, uint32_t material_id, float depth) {
+    // Positive IEEE-754 floats sort the same as their bit patterns do, so clamp the depth to non-negative and take its bits
+    if (!(depth > 0.0f)) { depth = 0.0f; }
+    uint32_t depth_key;
+    memcpy(&depth_key, &depth, sizeof(uint32_t));
+
+    // Pack everything together, with the most significant part in the highest bits
+    return (static_cast<uint64_t>(pipeline_id & ((1U << RenderQueue::pipeline_bits) - 1)) << (RenderQueue::material_bits + RenderQueue::depth_bits)) |
+           (static_cast<uint64_t>(material_id & ((1U << RenderQueue::material_bits) - 1)) << RenderQueue::depth_bits) |
+           static_cast<uint64_t>(depth_key);
+}
+
+/* Sorts the given n entries on their key using an 8-bit LSD radix sort. Passes over digits that are equal for all keys are skipped. The scratch array is used as a buffer, and must be able to hold at least n entries. */
+void RenderQueue::radix_sort(SortEntry* entries, SortEntry* scratch, uint32_t n) {
+    if (n < 2) { return; }
+
+    // Build the histograms for all digits in one go
+    uint32_t counts[radix_passes][radix_size];
+    memset(counts, 0, sizeof(counts));
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t key = entries[i].key;
+        for (uint32_t p = 0; p < radix_passes; p++) {
+            ++counts[p][(key >> (p * radix_bits)) & (radix_size - 1)];
+        }
+    }
+
+    // Do a counting sort per digit, ping-ponging between the two buffers
+    SortEntry* src = entries;
+    SortEntry* dst = scratch;
+    for (uint32_t p = 0; p < radix_passes; p++) {
+        // If all keys share this digit, then this pass won't change anything
+        uint32_t* count = counts[p];
+        if (count[(src[0].key >> (p * radix_bits)) & (radix_size - 1)] == n) { continue; }
+
+        // Turn the counts into offsets
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b < radix_size; b++) {
+            uint32_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+
+        // Scatter the entries to their bucket, which is stable
+        for (uint32_t i = 0; i < n; i++) {
+            dst[count[(src[i].key >> (p * radix_bits)) & (radix_size - 1)]++] = src[i];
+        }
+
+        // Swap the buffers
+        SortEntry* temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    // If the result ended up in the scratch buffer, copy it back
+    if (src != entries) {
+        memcpy(entries, src, n * sizeof(SortEntry));
+    }
+}
@@ -0,0 +1,116 @@
+/* RENDER QUEUE.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 11:02:13
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RenderQueue class, which collects all draws for a single
+ *   frame in a flat list and sorts them on a packed 64-bit key such that
+ *   they can be recorded with as few state changes as possible.
+**/
+
+#ifndef RENDERING_RENDER_QUEUE_HPP
+#define RENDERING_RENDER_QUEUE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "glm/glm.hpp"
+#include "tools/Array.hpp"
+#include "ecs/Entity.hpp"
+#include "materials/Material.hpp"
+
+namespace Makma3D::Rendering {
+    /* Describes a single draw (i.e., a single mesh of a single entity) in the RenderQueue. */
+    struct DrawItem {
+        /* The entity to which the mesh belongs. */
+        ECS::entity_t entity;
+        /* The material with which to draw the mesh. */
+        const Materials::Material* material;
+        /* The first index of the mesh in the shared index buffer. */
+        uint32_t first_index;
+        /* The number of indices to render. */
+        uint32_t n_indices;
+        /* The offset of the mesh' vertices in the shared vertex buffer. */
+        int32_t vertex_offset;
+        /* The bounding sphere of the mesh in world space, as the centre in xyz and the radius in w. */
+        glm::vec4 bounds;
+    };
+
+
+
+    /* The RenderQueue class, which collects the draws for a frame and sorts them on (pipeline, material, depth) using a radix sort. */
+    class RenderQueue {
+    public:
+        /* Channel name for the RenderQueue class. */
+        static constexpr const char* channel = "RenderQueue";
+
+        /* The number of bits in the sort key reserved for the pipeline (i.e., the material type). */
+        static constexpr const uint32_t pipeline_bits = 8;
+        /* The number of bits in the sort key reserved for the material. */
+        static constexpr const uint32_t material_bits = 24;
+        /* The number of bits in the sort key reserved for the depth. */
+        static constexpr const uint32_t depth_bits = 32;
+
+        /* Pairs a sort key with the index of the DrawItem it belongs to. */
+        struct SortEntry {
+            /* The packed sort key. */
+            uint64_t key;
+            /* The index of the DrawItem in the unsorted list. */
+            uint32_t index;
+        };
+
+    private:
+        /* The draws as they are pushed to the queue. */
+        Tools::Array<DrawItem> items;
+        /* The sort keys for each draw, which also contain the order after sorting. */
+        Tools::Array<SortEntry> entries;
+        /* The sort keys for each draw with only their depth, which contain the front-to-back order of the draws after sorting. */
+        Tools::Array<SortEntry> depth_entries;
+        /* Scratch space for the radix sort, kept around to avoid allocations each frame. */
+        Tools::Array<SortEntry> scratch;
+
+        /* Maps each material we've seen to a dense identifier that is small enough to fit in the sort key. */
+        std::unordered_map<const Materials::Material*, uint32_t> material_ids;
+
+    public:
+        /* Default constructor for the RenderQueue class. */
+        RenderQueue();
+
+        /* Clears the queue, but leaves its memory intact so it can be re-used next frame. */
+        void clear();
+        /* Adds a new draw to the queue, which is at the given view-space depth. Negative depths (behind the camera) are clamped to zero. */
+        void push(const DrawItem& item, float depth);
+        /* Sorts the queue on pipeline first, then on material and finally front-to-back. Optionally also sorts all draws purely front-to-back, for passes that don't care about pipelines or materials (like a depth pre-pass). */
+        void sort(bool front_to_back = false);
+
+        /* Returns the i'th draw in the queue (in sorted order if sort() has been called). */
+        inline const DrawItem& operator[](uint32_t index) const { return this->items[this->entries[index].index]; }
+        /* Returns the i'th draw in the queue in front-to-back order. Only valid if sort() has been called and asked to sort front-to-back. */
+        inline const DrawItem& front_to_back(uint32_t index) const { return this->items[this->depth_entries[index].index]; }
+        /* Returns the index in push order of the i'th draw in the queue (in sorted order if sort() has been called). */
+        inline uint32_t index(uint32_t index) const { return this->entries[index].index; }
+        /* Returns the index in push order of the i'th draw in the queue in front-to-back order. Only valid if sort() has been called and asked to sort front-to-back. */
+        inline uint32_t front_to_back_index(uint32_t index) const { return this->depth_entries[index].index; }
+        /* Returns the i'th draw in the order they were pushed to the queue. */
+        inline const DrawItem& pushed(uint32_t index) const { return this->items[index]; }
+        /* Returns the number of draws in the queue. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->entries.size()); }
+        /* Returns whether the queue is empty or not. */
+        inline bool empty() const { return this->entries.empty(); }
+
+        /* Packs the given pipeline identifier, material identifier and depth into a single 64-bit sort key. */
+        static uint64_t make_key(uint32_t pipeline_id, uint32_t material_id, float depth);
+        /* Sorts the given n entries on their key using an 8-bit LSD radix sort. Passes over digits that are equal for all keys are skipped. The scratch array is used as a buffer, and must be able to hold at least n entries. */
+        static void radix_sort(SortEntry* entries, SortEntry* scratch, uint32_t n);
+
+    };
+
+}
+
+#endif
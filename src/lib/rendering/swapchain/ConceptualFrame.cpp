@@ -4,7 +4,7 @@
  * Created:
  *   08/09/2021, 19:09:54
  * Last edited:
- *   9/20/2021, 10:51:41 PM
+ *   19/10/2026, 03:24:53
  * Auto updated?
  *   Yes
  *
@@ -13,6 +13,9 @@
  *   render. Builds upon a SwapchainFrame.
 **/
 
+#include <algorithm>
+#include <cstring>
+
 #include "glm/glm.hpp"
 #include "tools/Logger.hpp"
 #include "../auxillary/ErrorCodes.hpp"
@@ -24,22 +27,67 @@ using namespace Makma3D;
 using namespace Makma3D::Rendering;
 
 
-/***** STRUCTS *****/
-/* Struct for transferring camera data to the GPU. */
-struct CameraData {
-    /* The projection matrix for the camera. */
-    glm::mat4 proj;
-    /* The view matrix for the camera. */
-    glm::mat4 view;
-};
-
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given barrier that transitions the colour aspect of the given image between the given layouts, making the given accesses visible to the given accesses. */
+static void populate_image_barrier(VkImageMemoryBarrier& image_barrier, VkImage vk_image, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    // Set to default
+    image_barrier = {};
+    image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+    // Set the layouts, and don't transfer ownership
+    image_barrier.oldLayout = old_layout;
+    image_barrier.newLayout = new_layout;
+    image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+    // Set the image and its only level & layer
+    image_barrier.image = vk_image;
+    image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_barrier.subresourceRange.baseMipLevel = 0;
+    image_barrier.subresourceRange.levelCount = 1;
+    image_barrier.subresourceRange.baseArrayLayer = 0;
+    image_barrier.subresourceRange.layerCount = 1;
+
+    // Set the accesses to wait for
+    image_barrier.srcAccessMask = src_access;
+    image_barrier.dstAccessMask = dst_access;
+}
 
+/* Populates the given memory barrier that makes the given accesses visible to the given accesses. */
+static void populate_memory_barrier(VkMemoryBarrier& memory_barrier, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    // Set to default
+    memory_barrier = {};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
 
+    // Set the accesses to wait for
+    memory_barrier.srcAccessMask = src_access;
+    memory_barrier.dstAccessMask = dst_access;
+}
 
+/* Populates the given VkImageBlit struct to stretch the entirety of the given layer of an image of the given source size over the given rectangle of the destination. */
+static void populate_blit_region(VkImageBlit& blit_region, const VkExtent2D& vk_src_extent, uint32_t src_layer, const VkRect2D& vk_dst_rect) {
+    // Set to default
+    blit_region = {};
+
+    // Read the colour aspect of the entire source...
+    blit_region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit_region.srcSubresource.mipLevel = 0;
+    blit_region.srcSubresource.baseArrayLayer = src_layer;
+    blit_region.srcSubresource.layerCount = 1;
+    blit_region.srcOffsets[0] = { 0, 0, 0 };
+    blit_region.srcOffsets[1] = { static_cast<int32_t>(vk_src_extent.width), static_cast<int32_t>(vk_src_extent.height), 1 };
+
+    // ...and write it to the given part of the destination
+    blit_region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit_region.dstSubresource.mipLevel = 0;
+    blit_region.dstSubresource.baseArrayLayer = 0;
+    blit_region.dstSubresource.layerCount = 1;
+    blit_region.dstOffsets[0] = { vk_dst_rect.offset.x, vk_dst_rect.offset.y, 0 };
+    blit_region.dstOffsets[1] = { vk_dst_rect.offset.x + static_cast<int32_t>(vk_dst_rect.extent.width), vk_dst_rect.offset.y + static_cast<int32_t>(vk_dst_rect.extent.height), 1 };
+}
 
-/***** POPULATE FUNCTIONS *****/
-/* Populates the given VkSubmitInfo struct. */
-static void populate_submit_info(VkSubmitInfo& submit_info, const CommandBuffer* cmd, const Semaphore& wait_for_semaphore,  const Tools::Array<VkPipelineStageFlags>& wait_for_stages, const Semaphore& signal_after_semaphore) {
+/* Populates the given VkSubmitInfo struct. If use_semaphores is false, the semaphores are left out. */
+static void populate_submit_info(VkSubmitInfo& submit_info, const CommandBuffer* cmd, const Semaphore& wait_for_semaphore,  const Tools::Array<VkPipelineStageFlags>& wait_for_stages, const Semaphore& signal_after_semaphore, bool use_semaphores) {
     // Set to default
     submit_info = {};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -48,6 +96,9 @@ static void populate_submit_info(VkSubmitInfo& submit_info, const CommandBuffer*
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &cmd->vulkan();
 
+    // Frames that aren't presented don't acquire an image or hand it to the presentation engine, so there's nothing to wait for or signal
+    if (!use_semaphores) { return; }
+
     // Attach the data for which we wait
     submit_info.waitSemaphoreCount = 1;
     submit_info.pWaitSemaphores = &wait_for_semaphore.semaphore();
@@ -63,12 +114,28 @@ static void populate_submit_info(VkSubmitInfo& submit_info, const CommandBuffer*
 
 
 /***** CONCEPTUALFRAME CLASS *****/
-/* Constructor for the ConceptualFrame class, which takes a MemoryManager to be able to draw games, a descriptor set layout for the global descriptor, a descriptor set layout for per-material descriptors and a descriptor set layout for the per-entity descriptors. */
-ConceptualFrame::ConceptualFrame(Rendering::MemoryManager& memory_manager, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& entity_layout) :
+/* Constructor for the ConceptualFrame class, which takes a MemoryManager to be able to draw games, a descriptor set layout for the global descriptor, a descriptor set layout for per-material descriptors, a descriptor set layout for the per-entity descriptors and the maximum number of chunks the scene may be recorded in. */
+ConceptualFrame::ConceptualFrame(Rendering::MemoryManager& memory_manager, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& entity_layout, uint32_t max_chunks) :
     memory_manager(memory_manager),
 
     swapchain_frame(nullptr),
-    pipeline(nullptr),
+    _bind_counters({}),
+    _stats({}),
+    readback_ring(nullptr),
+    readback_frame(0),
+    profiler(nullptr),
+    profiler_frame(0),
+    culler(nullptr),
+    pyramid(nullptr),
+    cull_buffers(nullptr),
+    particle_system(nullptr),
+    particle_buffers(nullptr),
+    bindless_textures(nullptr),
+    material_buffer(nullptr),
+    material_uploads(nullptr),
+    upscale_source(nullptr),
+    upscale_layout(VK_IMAGE_LAYOUT_UNDEFINED),
+    upscale_filter(VK_FILTER_LINEAR),
 
     global_layout(global_layout),
     material_layout(material_layout),
@@ -78,22 +145,36 @@ ConceptualFrame::ConceptualFrame(Rendering::MemoryManager& memory_manager, const
     render_ready_semaphore(this->memory_manager.gpu),
     in_flight_fence(this->memory_manager.gpu, VK_FENCE_CREATE_SIGNALED_BIT)
 {
-    // Initialize the stage buffer
-    this->stage_buffer = this->memory_manager.stage_pool.allocate(std::max({ sizeof(CameraData), sizeof(SimpleColouredData), sizeof(EntityData) }), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-    logger.logc(Verbosity::debug, ConceptualFrame::channel, "Allocated stage buffer @ ", this->stage_buffer->offset());
+    // Initialize the stage buffers. The camera has its own, since its data stays there until the frame is submitted
+    this->stage_buffer = this->memory_manager.stage_pool.allocate(sizeof(EntityData), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    this->camera_stage = this->memory_manager.stage_pool.allocate(max_views * sizeof(CameraData), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    this->camera_bytes = 0;
+    logger.logc(Verbosity::debug, ConceptualFrame::channel, "Allocated stage buffers @ ", this->stage_buffer->offset(), " and ", this->camera_stage->offset());
 
-    // Initialize the commandbuffer
+    // Initialize the commandbuffers
     this->draw_cmd = this->memory_manager.draw_cmd_pool.allocate();
+    this->recorders.reserve(max_chunks);
+    for (uint32_t i = 0; i < max_chunks; i++) {
+        this->recorders.push_back(new SceneRecorder(this->memory_manager.gpu));
+    }
+    this->scene_cmds.reserve(max_chunks);
+    this->scene_subpasses = 0;
+    this->scene_recorded = false;
+    this->scene_version = 0;
 
     // Initialize the pools
     this->memory_pool = new LinearMemoryPool(this->memory_manager.gpu, 10 * 1024 * 1024, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    // Next to those of the materials & entities, the global set takes the camera, one uniform & three storage buffers for the lights and the material buffer
     this->descriptor_pool = new DescriptorPool(this->memory_manager.gpu, {
-        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 10 },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 11 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, LightBuffers::n_bindings },
         { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 10 }
     }, 64);
 
     // Initialize the global descriptor set & camera buffer
-    this->camera_buffer = this->memory_manager.draw_pool.allocate(sizeof(CameraData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    this->camera_buffer = this->memory_manager.draw_pool.allocate(max_views * sizeof(CameraData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    // The lights are rewritten every frame, so they live in host-visible buffers of their own
+    this->light_buffers = new LightBuffers(this->memory_manager.gpu);
 
     // And that's it
 }
@@ -104,22 +185,47 @@ ConceptualFrame::ConceptualFrame(ConceptualFrame&& other) :
 
     swapchain_frame(std::move(other.swapchain_frame)),
     stage_buffer(std::move(other.stage_buffer)),
-    pipeline(std::move(other.pipeline)),
+    _bind_counters(other._bind_counters),
+    _stats(other._stats),
+    readback_ring(other.readback_ring),
+    readback_frame(other.readback_frame),
+    readback_path(std::move(other.readback_path)),
+    profiler(other.profiler),
+    profiler_frame(other.profiler_frame),
+    culler(other.culler),
+    pyramid(other.pyramid),
+    cull_buffers(other.cull_buffers),
+    particle_system(other.particle_system),
+    particle_buffers(other.particle_buffers),
+    bindless_textures(other.bindless_textures),
+    material_buffer(other.material_buffer),
+    material_uploads(other.material_uploads),
+    upscale_source(other.upscale_source),
+    upscale_layout(other.upscale_layout),
+    upscale_filter(other.upscale_filter),
+    upscale_rects(std::move(other.upscale_rects)),
 
     global_layout(std::move(other.global_layout)),
     material_layout(std::move(other.material_layout)),
     entity_layout(std::move(other.entity_layout)),
 
     draw_cmd(std::move(other.draw_cmd)),
+    recorders(std::move(other.recorders)),
+    scene_cmds(std::move(other.scene_cmds)),
+    scene_subpasses(other.scene_subpasses),
+    scene_recorded(other.scene_recorded),
+    scene_version(other.scene_version),
     memory_pool(std::move(other.memory_pool)),
     descriptor_pool(std::move(other.descriptor_pool)),
 
     global_set(std::move(other.global_set)),
     camera_buffer(std::move(other.camera_buffer)),
+    camera_stage(other.camera_stage),
+    camera_bytes(other.camera_bytes),
+    light_buffers(other.light_buffers),
 
     material_index_map(std::move(other.material_index_map)),
     material_sets(std::move(other.material_sets)),
-    material_buffers(std::move(other.material_buffers)),
 
     entity_index_map(std::move(other.entity_index_map)),
     entity_sets(std::move(other.entity_sets)),
@@ -131,17 +237,35 @@ ConceptualFrame::ConceptualFrame(ConceptualFrame&& other) :
 {
     // Tell the other not to deallocate any of his resources
     other.stage_buffer = nullptr;
+    other.cull_buffers = nullptr;
+    other.particle_buffers = nullptr;
+    other.material_uploads = nullptr;
     other.draw_cmd = nullptr;
     other.memory_pool = nullptr;
     other.descriptor_pool = nullptr;
     other.global_set = nullptr;
     other.camera_buffer = nullptr;
-    // No need to clear the material sets/buffers, as the Array's move function already makes sure they're reset to empty
+    other.camera_stage = nullptr;
+    other.light_buffers = nullptr;
+    // No need to clear the recorders, as the Array's move function already makes sure they're reset to empty
+    // No need to clear the material sets, as the Array's move function already makes sure they're reset to empty
     // No need to clear the entity sets/buffers, as the Array's move function already makes sure they're reset to empty
 }
 
 /* Destructor for the ConceptualFrame class. */
 ConceptualFrame::~ConceptualFrame() {
+    if (this->material_uploads != nullptr) {
+        delete this->material_uploads;
+    }
+    if (this->particle_buffers != nullptr) {
+        delete this->particle_buffers;
+    }
+    if (this->cull_buffers != nullptr) {
+        delete this->cull_buffers;
+    }
+    if (this->light_buffers != nullptr) {
+        delete this->light_buffers;
+    }
     if (this->camera_buffer != nullptr) {
         this->memory_manager.draw_pool.free(this->camera_buffer);
     }
@@ -151,9 +275,15 @@ ConceptualFrame::~ConceptualFrame() {
     if (this->memory_pool != nullptr) {
         delete this->memory_pool;
     }
+    for (uint32_t i = 0; i < this->recorders.size(); i++) {
+        delete this->recorders[i];
+    }
     if (this->draw_cmd != nullptr) {
         this->memory_manager.draw_cmd_pool.free(this->draw_cmd);
     }
+    if (this->camera_stage != nullptr) {
+        this->memory_manager.stage_pool.free(this->camera_stage);
+    }
     if (this->stage_buffer != nullptr) {
         this->memory_manager.stage_pool.free(this->stage_buffer);
     }
@@ -161,8 +291,65 @@ ConceptualFrame::~ConceptualFrame() {
 
 
 
-/* Prepares rendering the frame as new by throwing out old data preparing to render at most the given number of objects with at least the given number of materials different materials. */
+/* Private helper function that records upscaling the scene to the frame's image, in the frame's draw command buffer. */
+void ConceptualFrame::_record_upscale() {
+    VkImage vk_target = this->swapchain_frame->image();
+
+    // The render pass already left the source ready to be copied from. The frame's image still has to be acquired, though, which we wait for at the colour output stage, so chain the transition to that
+    VkImageMemoryBarrier image_barrier;
+    populate_image_barrier(image_barrier, vk_target, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0, VK_ACCESS_TRANSFER_WRITE_BIT);
+    vkCmdPipelineBarrier(this->draw_cmd->vulkan(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+    if (this->upscale_rects.empty()) {
+        // Stretch the scene over the entire image
+        VkImageBlit blit_region;
+        populate_blit_region(blit_region, this->swapchain_frame->render_extent(), 0, VkRect2D{ { 0, 0 }, this->swapchain_frame->extent() });
+        vkCmdBlitImage(this->draw_cmd->vulkan(), this->upscale_source->vulkan(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vk_target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit_region, this->upscale_filter);
+    } else {
+        // The views may not cover the entire image, so clear it like the render pass would have first
+        VkClearColorValue vk_clear_colour = { { 0.749f, 1.0f, 0.992f, 1.0f } };
+        VkImageSubresourceRange vk_range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        vkCmdClearColorImage(this->draw_cmd->vulkan(), vk_target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &vk_clear_colour, 1, &vk_range);
+        populate_image_barrier(image_barrier, vk_target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        vkCmdPipelineBarrier(this->draw_cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+        // Then stretch each view (i.e., each layer of the scene) over its own part of the image
+        Tools::Array<VkImageBlit> blit_regions(this->upscale_rects.size());
+        for (uint32_t i = 0; i < this->upscale_rects.size(); i++) {
+            VkImageBlit blit_region;
+            populate_blit_region(blit_region, this->swapchain_frame->render_extent(), i, this->upscale_rects[i]);
+            blit_regions.push_back(blit_region);
+        }
+        vkCmdBlitImage(this->draw_cmd->vulkan(), this->upscale_source->vulkan(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vk_target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, blit_regions.size(), blit_regions.rdata(), this->upscale_filter);
+    }
+
+    // Leave the image in the layout it would have had after the render pass. Readbacks expect it to be written at the colour output stage, so make the blit visible there as well as to copies
+    populate_image_barrier(image_barrier, vk_target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, this->upscale_layout, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    vkCmdPipelineBarrier(this->draw_cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+}
+
+/* Private helper function that uploads the given data to the given buffer through the staging buffer, counting it in the stats. */
+void ConceptualFrame::_upload(const Rendering::Buffer* buffer, void* data, uint32_t n_bytes) {
+    buffer->set(data, n_bytes, this->stage_buffer, this->memory_manager.copy_cmd);
+    ++this->_stats.staging_submissions;
+    this->_stats.uploaded_bytes += n_bytes;
+}
+
+/* Private helper function that resets the stats that are counted anew each time the frame is used, given the time the CPU waited for the frame's fence. */
+void ConceptualFrame::_begin_stats(uint64_t fence_wait_us) {
+    this->_stats.staging_submissions = 0;
+    this->_stats.uploaded_bytes = 0;
+    this->_stats.descriptor_sets_allocated = 0;
+    this->_stats.fence_wait_us = fence_wait_us;
+}
+
+
+
+/* Prepares rendering the frame as new by throwing out old data preparing to render at most the given number of objects with at least the given number of materials different materials. Also invalidates any recorded scene. */
 void ConceptualFrame::prepare_render(uint32_t n_materials, uint32_t n_objects) {
+    // The recorded scene refers to the sets & buffers we're about to throw away
+    this->scene_recorded = false;
+
     // Reset the index maps
     this->material_index_map.clear();
     this->entity_index_map.clear();
@@ -172,31 +359,68 @@ void ConceptualFrame::prepare_render(uint32_t n_materials, uint32_t n_objects) {
     this->descriptor_pool->reset();
 
     // Prepare enough space in the object arrays
-    this->material_buffers.clear();
     this->entity_buffers.clear();
-    this->material_buffers.resize_opt(n_materials);
     this->entity_buffers.resize_opt(n_objects);
 
     // Allocate the new descriptors
     this->global_set    = this->descriptor_pool->allocate(this->global_layout);
     this->material_sets = this->descriptor_pool->nallocate(n_materials, this->material_layout);
     this->entity_sets   = this->descriptor_pool->nallocate(n_objects, this->entity_layout);
+    this->_stats.descriptor_sets_allocated += 1 + n_materials + n_objects;
+
+    // Add the camera to the global descriptor. Since the camera buffer itself never changes, we don't have to touch the set again until the next call to prepare_render()
+    this->global_set->bind(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, { this->camera_buffer });
+    // The same goes for the light buffers, unless they have to grow (see upload_light_data())
+    this->light_buffers->bind(this->global_set, 1);
+    // The material buffer never changes either, and comes right after the lights
+    if (this->material_buffer != nullptr) { this->material_buffer->bind(this->global_set, 1 + LightBuffers::n_bindings); }
 }
 
 
 
-/* Populates the internal camera buffer with the given projection and view matrices. */
-void ConceptualFrame::upload_camera_data(const glm::mat4& proj_matrix, const glm::mat4& view_matrix) {
-    // Prepare the struct to send
-    CameraData data{ proj_matrix, view_matrix };
+/* Stages the matrices of the given views (of which there are at most max_views) to be copied to the internal camera buffer when this frame is submitted. */
+void ConceptualFrame::upload_camera_data(const Rendering::CameraData* views, uint32_t n_views) {
+    #ifndef NDEBUG
+    if (n_views == 0 || n_views > max_views) { logger.fatalc(ConceptualFrame::channel, "Cannot upload ", n_views, " views; a frame has between 1 and ", max_views, " views."); }
+    #endif
 
-    // Send it to the camera buffer using the staging buffer
-    this->camera_buffer->set((void*) &data, sizeof(CameraData), this->stage_buffer, this->memory_manager.copy_cmd);
-    // Add the camera to the descriptor
-    this->global_set->bind(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, { this->camera_buffer });
+    // Write them to the camera's staging buffer, which submit() copies to the camera buffer in the frame's own command buffer. Note that the descriptor is already bound in prepare_render(), so any recorded scene stays valid
+    void* mapped;
+    this->camera_stage->map(&mapped);
+    std::memcpy(mapped, (void*) views, n_views * sizeof(CameraData));
+    this->camera_stage->flush();
+    this->camera_stage->unmap();
+    this->camera_bytes = n_views * sizeof(CameraData);
+    this->_stats.uploaded_bytes += this->camera_bytes;
+}
+
+/* Uploads the lights and clusters of the given clusterers (one per view), and the given parameters with which the fragment shaders find them. If the buffers have to grow, this invalidates any recorded scene, since the global descriptor then has to be bound anew. */
+void ConceptualFrame::upload_light_data(const Rendering::LightClusterer* clusterers, uint32_t n_views, const Rendering::ClusterParams& params) {
+    // The buffers are host-visible, so this doesn't go through the staging buffer
+    if (this->light_buffers->upload(clusterers, n_views, params)) {
+        // The global descriptor still points to the old buffers, so have prepare_render() bind the new ones
+        this->scene_recorded = false;
+    }
+    this->_stats.uploaded_bytes += sizeof(ClusterParams);
+    for (uint32_t v = 0; v < n_views; v++) {
+        this->_stats.uploaded_bytes += clusterers[v].lights().size() * sizeof(LightData) + clusterers[v].clusters().size() * sizeof(ClusterData) + clusterers[v].indices().size() * sizeof(uint32_t);
+    }
+}
+
+/* Stages the parameters of the materials in the given pool that were allocated or modified since they were last staged by any frame, which are copied to the material buffer when this frame is submitted. Has to be done each time the frame is used, whether it records the scene again or not. */
+void ConceptualFrame::upload_material_params(const Materials::MaterialPool& pool) {
+    #ifndef NDEBUG
+    if (this->material_uploads == nullptr) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot upload material parameters for a frame without a material buffer.");
+    }
+    #endif
+
+    // The staging buffer is host-visible, and is copied along with the rest of the frame, so this never waits for the GPU
+    uint32_t n_changed = this->material_buffer->collect(pool, this->bindless_textures, *this->material_uploads);
+    this->_stats.uploaded_bytes += n_changed * sizeof(MaterialData);
 }
 
-/* Uploads the given material to the GPU. What precisely will be uploaded is, of course, material dependent. */
+/* Prepares the given material to be drawn in this frame. Its parameters live in the material buffer, so this only binds the texture of textured materials if they aren't bindless. */
 void ConceptualFrame::upload_material_data(const Materials::Material* material) {
     // Map the material in the internal index map
     std::unordered_map<const Materials::Material*, uint32_t>::iterator iter = this->material_index_map.find((const Materials::Material*) material);
@@ -212,37 +436,21 @@ void ConceptualFrame::upload_material_data(const Materials::Material* material)
     }
     #endif
 
-    // Select what to upload based on the given material
+    // Select what to bind based on the given material
     switch (material->type()) {
         case Materials::MaterialType::simple:
-            // Upload nothing
-            break;
-        
-        case Materials::MaterialType::simple_coloured: {
-            const Materials::SimpleColoured* simple_coloured = (const Materials::SimpleColoured*) material;
-
-            // Upload the SimpleColoured data
-            if (this->material_buffers[material_index] == nullptr) {
-                // Allocate a new buffer first
-                this->material_buffers[material_index] = this->memory_pool->allocate(sizeof(SimpleColouredData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-            }
-
-            // Populate the buffer with the stage data using the internal stage buffer
-            SimpleColouredData data = simple_coloured->data();
-            this->material_buffers[material_index]->set((void*) &data, sizeof(SimpleColouredData), this->stage_buffer, this->memory_manager.copy_cmd);
-
-            // Bind the descriptor set
-            this->material_sets[material_index]->bind(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, { this->material_buffers[material_index] });
-
-            // Done
+        case Materials::MaterialType::simple_coloured:
+            // Their parameters are all in the material buffer
             break;
-        }
 
         case Materials::MaterialType::simple_textured: {
             const Materials::SimpleTextured* simple_textured = (const Materials::SimpleTextured*) material;
 
+            // With bindless textures, the material buffer already tells the shader where its texture is
+            if (this->bindless_textures != nullptr) { break; }
+
             // Schedule the texture's sampler
-            this->material_sets[material_index]->bind(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2, { simple_textured->texture });
+            this->material_sets[material_index]->bind(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, { simple_textured->texture });
 
             // Done
             break;
@@ -275,48 +483,63 @@ void ConceptualFrame::upload_entity_data(ECS::entity_t entity, const Rendering::
     // Otherwise, allocate a new buffer if needed
     if (this->entity_buffers[entity_index] == nullptr) { this->entity_buffers[entity_index] = this->memory_pool->allocate(sizeof(EntityData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT); }
     // Populate the buffer with this entity's data
-    this->entity_buffers[entity_index]->set((void*) &entity_data, sizeof(EntityData), this->stage_buffer, this->memory_manager.copy_cmd);
+    this->_upload(this->entity_buffers[entity_index], (void*) &entity_data, sizeof(EntityData));
     // Bind the correct object buffer to the correct set
     this->entity_sets[entity_index]->bind(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, { this->entity_buffers[entity_index] });
 }
 
 
 
-/* Starts to schedule the render pass associated with the wrapped SwapchainFrame on the internal draw queue. */
-void ConceptualFrame::schedule_start() {
+/* Starts to record the given version of the scene in the given number of chunks for each of the given number of subpasses, each in its own secondary command buffer that continues the render pass associated with the wrapped SwapchainFrame. Chunk c of subpass s is chunk 's * n_chunks + c'. Also sets the viewport & scissor to the frame's extent. Different chunks may be scheduled from different threads at the same time, as long as all data has been uploaded beforehand. */
+void ConceptualFrame::schedule_start(uint64_t version, uint32_t n_chunks, uint32_t n_subpasses) {
     #ifndef NDEBUG
     // Check if the swapchain frame is set
     if (this->swapchain_frame == nullptr) {
         logger.fatalc(ConceptualFrame::channel, "Cannot start scheduling without assigned swapchain frame.");
     }
+    // Check if we have enough recorders
+    if (n_chunks == 0 || n_subpasses == 0 || n_chunks * n_subpasses > this->recorders.size()) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot record scene in ", n_chunks, " chunks for ", n_subpasses, " subpasses (expected between 1 and ", this->recorders.size(), " chunks in total).");
+    }
+    if (n_subpasses != this->swapchain_frame->render_pass.n_subpasses()) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot record scene for ", n_subpasses, " subpasses in a render pass with ", this->swapchain_frame->render_pass.n_subpasses(), " subpasses.");
+    }
     #endif
 
-    // Begin the command buffer
-    this->draw_cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-    // First, schedule the render pass start
-    this->swapchain_frame->render_pass.start_scheduling(this->draw_cmd, this->swapchain_frame->framebuffer(), this->swapchain_frame->extent());
+    // Mark the scene as being recorded
+    this->scene_recorded = false;
+    this->scene_version = version;
+    this->_bind_counters = {};
+    this->_stats.draws = 0;
+    this->_stats.instances = 0;
+    this->_stats.triangles = 0;
+
+    // Begin the recorders we need, each continuing the subpass its chunk belongs to, and remember their buffers to execute them later
+    this->scene_cmds.clear();
+    this->scene_subpasses = n_subpasses;
+    for (uint32_t i = 0; i < n_chunks * n_subpasses; i++) {
+        this->recorders[i]->start(this->swapchain_frame->render_pass.vulkan(), i / n_chunks, this->swapchain_frame->render_extent());
+        this->scene_cmds.push_back(this->recorders[i]->command_buffer()->vulkan());
+    }
 }
 
-/* Binds the given pipeline on the internal draw command queue. */
-void ConceptualFrame::schedule_pipeline(const Rendering::Pipeline* pipeline) {
-    // First, set the pipeline internally
-    this->pipeline = pipeline;
-
-    // Bind the pipeline to the command buffer
-    pipeline->bind(this->draw_cmd);
+/* Binds the given pipeline in the given chunk. Does nothing if the pipeline is already bound. */
+void ConceptualFrame::schedule_pipeline(uint32_t chunk, const Rendering::Pipeline* pipeline) {
+    this->recorders[chunk]->schedule_pipeline(pipeline);
 }
 
-/* Schedules frame-global descriptors on the internal draw queue (i.e., binds the camera data and the global descriptor). */
-void ConceptualFrame::schedule_global() {
+/* Schedules frame-global descriptors in the given chunk (i.e., binds the camera data and the global descriptor, and the bindless textures if there are any). */
+void ConceptualFrame::schedule_global(uint32_t chunk) {
     // Bind the descriptor itself
-    this->global_set->schedule(this->draw_cmd, this->pipeline->layout(), 0);
+    this->recorders[chunk]->schedule_set(this->global_set, 0);
+    // The bindless textures are just as global, and never change
+    if (this->bindless_textures != nullptr) { this->recorders[chunk]->schedule_set(this->bindless_textures->set(), BindlessTextures::set_index); }
 }
 
-/* Schedules the stuff for the given material. Does have to have its data uploaded first, of course. */
-void ConceptualFrame::schedule_material(const Materials::Material* material) {
+/* Schedules the stuff for the given material in the given chunk. Does have to have its data uploaded first, of course. */
+void ConceptualFrame::schedule_material(uint32_t chunk, const Materials::Material* material) {
     // Map the material in the internal index map
-    std::unordered_map<const Materials::Material*, uint32_t>::iterator iter = this->material_index_map.find((const Materials::Material*) material);
+    std::unordered_map<const Materials::Material*, uint32_t>::const_iterator iter = this->material_index_map.find((const Materials::Material*) material);
     if (iter == this->material_index_map.end()) {
         logger.fatalc(ConceptualFrame::channel, "Cannot schedule material ", material, " for which nothing has been uploaded.");
     }
@@ -330,11 +553,19 @@ void ConceptualFrame::schedule_material(const Materials::Material* material) {
     #endif
 
     // Choose what to schedule
+    uint32_t id = material->id();
     switch (material->type()) {
         case Materials::MaterialType::simple_coloured:
+            // The shaders find the material's parameters with its ID
+            this->recorders[chunk]->schedule_push_constants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, (const void*) &id, sizeof(uint32_t));
+            break;
+
         case Materials::MaterialType::simple_textured:
-            // Schedule its descriptor set
-            this->material_sets[material_index]->schedule(this->draw_cmd, this->pipeline->layout(), 1);
+            // The same goes for textured materials, which find their texture through it if the textures are bindless
+            this->recorders[chunk]->schedule_push_constants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, (const void*) &id, sizeof(uint32_t));
+            // Otherwise, schedule its descriptor set with the texture
+            if (this->bindless_textures == nullptr) { this->recorders[chunk]->schedule_set(this->material_sets[material_index], 1); }
+            break;
 
         default:
             // Don't schedule
@@ -345,10 +576,10 @@ void ConceptualFrame::schedule_material(const Materials::Material* material) {
     // Done
 }
 
-/* Schedules the given entity's descriptor set on the internal draw queue. */
-void ConceptualFrame::schedule_entity(ECS::entity_t entity) {
+/* Schedules the given entity's descriptor set in the given chunk. */
+void ConceptualFrame::schedule_entity(uint32_t chunk, ECS::entity_t entity) {
     // Map the object
-    std::unordered_map<ECS::entity_t, uint32_t>::iterator iter = this->entity_index_map.find(entity);
+    std::unordered_map<ECS::entity_t, uint32_t>::const_iterator iter = this->entity_index_map.find(entity);
     if (iter == this->entity_index_map.end()) {
         logger.fatalc(ConceptualFrame::channel, "Cannot schedule entity ", entity, " for which nothing has been uploaded.");
     }
@@ -362,43 +593,239 @@ void ConceptualFrame::schedule_entity(ECS::entity_t entity) {
     #endif
 
     // Schedule the object's descriptor set
-    this->entity_sets[entity_index]->schedule(this->draw_cmd, this->pipeline->layout(), 2);
+    this->recorders[chunk]->schedule_set(this->entity_sets[entity_index], 2);
+}
+
+/* Binds the given vertex buffer (at the given offset, in bytes) to the given binding in the given chunk. Does nothing if it's already bound there at that offset. */
+void ConceptualFrame::schedule_vertex_buffer(uint32_t chunk, uint32_t binding, const Rendering::Buffer* vertex_buffer, VkDeviceSize offset) {
+    this->recorders[chunk]->schedule_vertex_buffer(binding, vertex_buffer, offset);
 }
 
-/* Binds the given vertex buffer to the internal draw queue. */
-void ConceptualFrame::schedule_vertex_buffer(const Rendering::Buffer* vertex_buffer) {
-    // Schedule the model's vertex buffer
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(this->draw_cmd->vulkan(), 0, 1, &vertex_buffer->vulkan(), offsets);
+/* Binds the given index buffer (at the given offset, in bytes) in the given chunk. Does nothing if it's already bound at that offset. */
+void ConceptualFrame::schedule_index_buffer(uint32_t chunk, const Rendering::Buffer* index_buffer, VkDeviceSize offset) {
+    this->recorders[chunk]->schedule_index_buffer(index_buffer, offset);
 }
 
-/* Schedules a draw command for the given index buffer (with the given number of indices) on the internal draw queue. */
-void ConceptualFrame::schedule_draw(const Rendering::Buffer* index_buffer, uint32_t n_indices) {
-    // First, schedule the mesh' index buffer
-    vkCmdBindIndexBuffer(this->draw_cmd->vulkan(), index_buffer->vulkan(), 0, VK_INDEX_TYPE_UINT32);
-    // Next, schedule the draw call
-    this->pipeline->schedule_idraw(this->draw_cmd, n_indices, 1);
+/* Schedules a draw command for the given range of indices in the bound index buffer in the given chunk. The vertex offset is added to each index before it's used to lookup a vertex in the bound vertex buffer. */
+void ConceptualFrame::schedule_draw(uint32_t chunk, uint32_t first_index, uint32_t n_indices, int32_t vertex_offset) {
+    this->recorders[chunk]->schedule_draw(first_index, n_indices, vertex_offset);
 }
 
-/* Stops scheduling by stopping the render pass associated with the wrapped SwapchainFrame. Then also stops the command buffer itself. */
+/* Schedules the draw command that the GPU culling writes for the given draw (i.e., the given index in the items uploaded by upload_cull_items()) in the given chunk, which draws at most the given number of indices from the bound index buffer. */
+void ConceptualFrame::schedule_indirect_draw(uint32_t chunk, uint32_t draw_index, uint32_t n_indices) {
+    #ifndef NDEBUG
+    // Check if there are draw commands to read
+    if (this->cull_buffers == nullptr || draw_index >= this->cull_buffers->size()) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot schedule indirect draw ", draw_index, " without uploading that many draws to cull first.");
+    }
+    #endif
+
+    this->recorders[chunk]->schedule_indirect_draw(this->cull_buffers->draws(), this->cull_buffers->draw_offset(draw_index), n_indices);
+}
+
+/* Schedules drawing the living particles with the given pipeline in the given chunk, whose layout has to start with the global layout and the particle system's draw layout. */
+void ConceptualFrame::schedule_particle_draw(uint32_t chunk, const Rendering::Pipeline* pipeline) {
+    #ifndef NDEBUG
+    if (this->particle_system == nullptr) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot draw particles for a frame that doesn't have any.");
+    }
+    #endif
+
+    // The particles only need the camera and their own buffers; the GPU decides how many to draw
+    this->recorders[chunk]->schedule_pipeline(pipeline);
+    this->recorders[chunk]->schedule_set(this->global_set, 0);
+    this->recorders[chunk]->schedule_set(this->particle_system->draw_set(), 1);
+    this->recorders[chunk]->schedule_indirect_vertex_draw(this->particle_system->counters(), 0);
+}
+
+/* Starts measuring the given bucket of draws in the given chunk, if the frame is profiled. */
+void ConceptualFrame::schedule_bucket_start(uint32_t chunk, uint32_t bucket) {
+    if (this->profiler != nullptr) { this->profiler->begin_bucket(this->profiler_frame, this->recorders[chunk]->command_buffer(), chunk, bucket); }
+}
+
+/* Stops measuring the given bucket of draws in the given chunk, if the frame is profiled. */
+void ConceptualFrame::schedule_bucket_stop(uint32_t chunk, uint32_t bucket) {
+    if (this->profiler != nullptr) { this->profiler->end_bucket(this->profiler_frame, this->recorders[chunk]->command_buffer(), chunk, bucket); }
+}
+
+/* Stops recording the scene, after which it can be re-used by subsequent calls to submit(). */
 void ConceptualFrame::schedule_stop() {
-    // Stop scheduling the render pass
-    this->swapchain_frame->render_pass.stop_scheduling(this->draw_cmd);
-    // Stop the buffer altogether
-    this->draw_cmd->end();
+    // Stop all recorders we used, collecting their counters while at it
+    for (uint32_t i = 0; i < this->scene_cmds.size(); i++) {
+        this->recorders[i]->stop();
+        this->_bind_counters += this->recorders[i]->bind_counters();
+        this->_stats.draws += this->recorders[i]->draw_counters().draws;
+        this->_stats.instances += this->recorders[i]->draw_counters().instances;
+        this->_stats.triangles += this->recorders[i]->draw_counters().triangles;
+    }
+    this->_stats.pipeline_binds = this->_bind_counters.pipelines_issued;
+    this->_stats.descriptor_binds = this->_bind_counters.descriptor_sets_issued;
+    this->_stats.buffer_binds = this->_bind_counters.vertex_buffers_issued + this->_bind_counters.index_buffers_issued;
+    this->scene_recorded = true;
+
+    // Log how much we saved by not binding redundant state
+    logger.logc(Verbosity::debug, ConceptualFrame::channel, "Recorded scene in ", this->scene_cmds.size(), " chunks over ", this->scene_subpasses, " subpasses. Binds issued/skipped: pipelines ", this->_bind_counters.pipelines_issued, "/", this->_bind_counters.pipelines_skipped, ", descriptor sets ", this->_bind_counters.descriptor_sets_issued, "/", this->_bind_counters.descriptor_sets_skipped, ", vertex buffers ", this->_bind_counters.vertex_buffers_issued, "/", this->_bind_counters.vertex_buffers_skipped, ", index buffers ", this->_bind_counters.index_buffers_issued, "/", this->_bind_counters.index_buffers_skipped);
+}
+
 
-    // Clear the pipeline association as well
-    this->pipeline = nullptr;
+
+/* Tells the frame that it's rendered as the given frame number and measured by the given profiler (which may be a nullptr to not profile it). Must be done each time the frame is used, before recording or submitting it. */
+void ConceptualFrame::schedule_profiling(Rendering::GpuProfiler* profiler, uint64_t frame) {
+    this->profiler = profiler;
+    this->profiler_frame = frame;
+}
+
+/* Schedules capturing the frame to the given path when it's next submitted, by copying it to the given ReadbackRing. The given frame number tells the ring when the copy is done. */
+void ConceptualFrame::schedule_readback(Rendering::ReadbackRing* readback_ring, uint64_t frame, const std::string& path) {
+    this->readback_ring = readback_ring;
+    this->readback_frame = frame;
+    this->readback_path = path;
+}
+
+/* Tells the frame that the scene is rendered to the given image at the frame's render extent, which is then blitted to the frame's own image with the given filter, leaving that in the given layout. The image may be a nullptr if the scene is rendered to the frame's image directly. If the image has a layer per view, the given rectangles (in pixels of the frame's image) tell where each layer goes; otherwise, its only layer is stretched over the entire image. Must be done each time the frame is used, before submitting it. */
+void ConceptualFrame::schedule_upscale(const Rendering::Image* source, VkImageLayout final_layout, VkFilter filter, const Tools::Array<VkRect2D>& view_rects) {
+    #ifndef NDEBUG
+    if (source != nullptr && view_rects.size() > source->layers()) { logger.fatalc(ConceptualFrame::channel, "Cannot blit ", view_rects.size(), " views from an image with only ", source->layers(), " layers."); }
+    #endif
+
+    this->upscale_source = source;
+    this->upscale_layout = final_layout;
+    this->upscale_filter = filter;
+    this->upscale_rects = view_rects;
+}
+
+/* Tells the frame that its draws are culled on the GPU by the given culler, against the given depth pyramid (which is rebuilt from the frame's depth buffer after the render pass). Both may be nullptrs to not cull. If check is true, the results are read back so check_culling() can compare them against the CPU. Must be done each time the frame is used, before uploading culling data or recording it. */
+void ConceptualFrame::schedule_culling(const Rendering::GpuCuller* culler, Rendering::HiZPyramid* pyramid, bool check) {
+    this->culler = culler;
+    this->pyramid = pyramid;
+
+    // Only allocate the buffers once the frame is actually culled
+    if (this->culler != nullptr && this->cull_buffers == nullptr) {
+        this->cull_buffers = new CullBuffers(this->memory_manager.gpu, this->culler->cull_layout(), check);
+    }
 }
 
+/* Uploads the draws to cull, in the order of the draw indices passed to schedule_indirect_draw(). Must be done before recording the scene, since it may replace the buffer the recorded draws read from. */
+void ConceptualFrame::upload_cull_items(const Tools::Array<Rendering::CullItem>& items) {
+    #ifndef NDEBUG
+    if (this->cull_buffers == nullptr) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot upload draws to cull for a frame that isn't culled.");
+    }
+    #endif
+
+    // The buffer is host-visible, so this doesn't go through the staging buffer
+    this->cull_buffers->upload_items(items);
+    this->_stats.uploaded_bytes += items.size() * sizeof(CullItem);
+}
 
+/* Uploads the parameters to cull with when the frame is next submitted. */
+void ConceptualFrame::upload_cull_params(const Rendering::CullParams& params) {
+    #ifndef NDEBUG
+    if (this->cull_buffers == nullptr) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot upload culling parameters for a frame that isn't culled.");
+    }
+    #endif
+
+    this->cull_buffers->upload_params(params);
+    this->_stats.uploaded_bytes += sizeof(CullParams);
+}
+
+/* Compares the results of the last culling of this frame against the reference on the CPU, if they were read back. Returns the number of draws that differ. Must be called once the frame is no longer in flight. */
+uint32_t ConceptualFrame::check_culling() {
+    if (this->cull_buffers == nullptr) { return 0; }
+    return this->cull_buffers->check();
+}
+
+/* Tells the frame that it updates the particles of the given system before its render pass. The system may be a nullptr to not update any. If check is true, the counters are read back so check_particles() can compare them against the CPU. Must be done each time the frame is used, before uploading particle data or recording it. */
+void ConceptualFrame::schedule_particles(Rendering::ParticleSystem* particle_system, bool check) {
+    this->particle_system = particle_system;
+
+    // Only allocate the buffers once the frame actually has particles
+    if (this->particle_system != nullptr && this->particle_buffers == nullptr) {
+        this->particle_buffers = new ParticleBuffers(this->memory_manager.gpu, this->particle_system->simulate_layout(), check);
+    }
+}
+
+/* Uploads the emitters and the parameters to update the particles with when the frame is next submitted. */
+void ConceptualFrame::upload_particle_data(const Tools::Array<Rendering::EmitterData>& emitters, const Rendering::ParticleParams& params) {
+    #ifndef NDEBUG
+    if (this->particle_buffers == nullptr) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot upload particle data for a frame that doesn't have particles.");
+    }
+    #endif
+
+    // The buffers are host-visible, so this doesn't go through the staging buffer
+    this->particle_buffers->upload(emitters, params, *this->particle_system);
+    this->_stats.uploaded_bytes += std::min(emitters.size(), ParticleSystem::max_emitters) * sizeof(EmitterData) + sizeof(ParticleParams);
+}
+
+/* Compares the number of living particles after the last update of this frame against the reference on the CPU, if they were read back. Returns the number of particles that differ. Must be called once the frame is no longer in flight. */
+uint32_t ConceptualFrame::check_particles() {
+    if (this->particle_buffers == nullptr) { return 0; }
+    return this->particle_buffers->check();
+}
+
+/* Tells the frame that its textured materials find their textures through the given bindless array instead of through sets of their own. May be a nullptr to bind them per material. Must be done each time the frame is used, before uploading material data or recording it. */
+void ConceptualFrame::schedule_bindless(Rendering::BindlessTextures* bindless_textures) {
+    this->bindless_textures = bindless_textures;
+}
+
+/* Tells the frame that the shaders find the parameters of the materials in the given buffer, to which the frame copies those that changed before its render pass. Must be done each time the frame is used, before preparing it or uploading material parameters. */
+void ConceptualFrame::schedule_materials(Rendering::MaterialBuffer* material_buffer) {
+    this->material_buffer = material_buffer;
+
+    // Only allocate the staging buffer once the frame actually has a material buffer
+    if (this->material_buffer != nullptr && this->material_uploads == nullptr) {
+        this->material_uploads = new MaterialUploads(this->memory_manager.gpu);
+    }
+}
+
+/* "Renders" the frame by recording the render pass with the recorded scene (moving to the next subpass after each subpass' chunks) in the internal draw queue and sending that to the given device queue. If the frame isn't presentable (i.e., it renders to an OffscreenTarget), it doesn't wait for the image to be acquired nor signals that it's ready for presentation. If any materials changed, they're copied to the material buffer first. If the frame is culled, its draws are culled before the render pass and the depth pyramid is rebuilt after it. If the frame has particles, they're updated before the render pass too. If the scene is upscaled, that's done after the render pass as well. If a readback is scheduled, the frame is then also copied to the ring. */
+void ConceptualFrame::submit(const VkQueue& vk_queue, bool presentable) {
+    #ifndef NDEBUG
+    // Check if there is something to submit
+    if (!this->scene_recorded) {
+        logger.fatalc(ConceptualFrame::channel, "Cannot submit frame without a recorded scene.");
+    }
+    #endif
+
+    // Record the render pass for the current swapchain frame, which simply executes the recorded chunks of each subpass in turn
+    this->draw_cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    if (this->profiler != nullptr) { this->profiler->begin_frame(this->profiler_frame, this->draw_cmd); }
+    if (this->material_buffer != nullptr) { this->material_uploads->schedule_upload(this->draw_cmd, this->material_buffer->buffer()); }
+    if (this->camera_bytes > 0) {
+        // The frame's previous use has completed, so only the vertex shaders of this one have to wait for the copy
+        this->camera_stage->schedule_copyto(this->camera_buffer, this->camera_bytes, 0, 0, this->draw_cmd);
+        VkMemoryBarrier memory_barrier;
+        populate_memory_barrier(memory_barrier, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_UNIFORM_READ_BIT);
+        vkCmdPipelineBarrier(this->draw_cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+        this->camera_bytes = 0;
+    }
+    if (this->culler != nullptr) { this->cull_buffers->schedule_cull(this->draw_cmd, *this->culler, *this->pyramid); }
+    if (this->particle_system != nullptr) { this->particle_buffers->schedule_update(this->draw_cmd, *this->particle_system); }
+    this->swapchain_frame->render_pass.start_scheduling(this->draw_cmd, this->swapchain_frame->framebuffer(), this->swapchain_frame->render_extent(), VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    uint32_t n_chunks = this->scene_cmds.size() / this->scene_subpasses;
+    for (uint32_t s = 0; s < this->scene_subpasses; s++) {
+        if (s > 0) { this->swapchain_frame->render_pass.next_subpass(this->draw_cmd, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS); }
+        vkCmdExecuteCommands(this->draw_cmd->vulkan(), n_chunks, this->scene_cmds.rdata() + s * n_chunks);
+    }
+    this->swapchain_frame->render_pass.stop_scheduling(this->draw_cmd);
+    if (this->culler != nullptr) { this->culler->schedule_pyramid(this->draw_cmd, *this->pyramid); }
+    // Upscaling is part of what the resolution costs us, so it's measured along with the render pass
+    if (this->upscale_source != nullptr) { this->_record_upscale(); }
+    if (this->profiler != nullptr) { this->profiler->end_frame(this->profiler_frame, this->draw_cmd); }
+
+    // Copy the result to the readback ring if asked to. Since that's part of the same submission, the frame's fence also tells us when the copy is done
+    if (this->readback_ring != nullptr) {
+        this->readback_ring->record(this->readback_frame, this->draw_cmd, *this->swapchain_frame, this->readback_path);
+        this->readback_ring = nullptr;
+    }
+    this->draw_cmd->end();
 
-/* "Renders" the frame by sending the internal draw queue to the given device queue. */
-void ConceptualFrame::submit(const VkQueue& vk_queue) {
     // Prepare to submit the command buffer
     Tools::Array<VkPipelineStageFlags> wait_stages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
     VkSubmitInfo submit_info;
-    populate_submit_info(submit_info, this->draw_cmd, this->image_ready_semaphore, wait_stages, this->render_ready_semaphore);
+    populate_submit_info(submit_info, this->draw_cmd, this->image_ready_semaphore, wait_stages, this->render_ready_semaphore, presentable);
 
     // Submit to the queue
     this->in_flight_fence.reset();
@@ -420,22 +847,47 @@ void Rendering::swap(ConceptualFrame& cf1, ConceptualFrame& cf2) {
     
     swap(cf1.swapchain_frame, cf2.swapchain_frame);
     swap(cf1.stage_buffer, cf2.stage_buffer);
-    swap(cf1.pipeline, cf2.pipeline);
+    swap(cf1._bind_counters, cf2._bind_counters);
+    swap(cf1._stats, cf2._stats);
+    swap(cf1.readback_ring, cf2.readback_ring);
+    swap(cf1.readback_frame, cf2.readback_frame);
+    swap(cf1.readback_path, cf2.readback_path);
+    swap(cf1.profiler, cf2.profiler);
+    swap(cf1.profiler_frame, cf2.profiler_frame);
+    swap(cf1.culler, cf2.culler);
+    swap(cf1.pyramid, cf2.pyramid);
+    swap(cf1.cull_buffers, cf2.cull_buffers);
+    swap(cf1.particle_system, cf2.particle_system);
+    swap(cf1.particle_buffers, cf2.particle_buffers);
+    swap(cf1.bindless_textures, cf2.bindless_textures);
+    swap(cf1.material_buffer, cf2.material_buffer);
+    swap(cf1.material_uploads, cf2.material_uploads);
+    swap(cf1.upscale_source, cf2.upscale_source);
+    swap(cf1.upscale_layout, cf2.upscale_layout);
+    swap(cf1.upscale_filter, cf2.upscale_filter);
+    swap(cf1.upscale_rects, cf2.upscale_rects);
 
     swap(cf1.global_layout, cf2.global_layout);
     swap(cf1.material_layout, cf2.material_layout);
     swap(cf1.entity_layout, cf2.entity_layout);
     
     swap(cf1.draw_cmd, cf2.draw_cmd);
+    swap(cf1.recorders, cf2.recorders);
+    swap(cf1.scene_cmds, cf2.scene_cmds);
+    swap(cf1.scene_subpasses, cf2.scene_subpasses);
+    swap(cf1.scene_recorded, cf2.scene_recorded);
+    swap(cf1.scene_version, cf2.scene_version);
     swap(cf1.memory_pool, cf2.memory_pool);
     swap(cf1.descriptor_pool, cf2.descriptor_pool);
     
     swap(cf1.global_set, cf2.global_set);
     swap(cf1.camera_buffer, cf2.camera_buffer);
+    swap(cf1.camera_stage, cf2.camera_stage);
+    swap(cf1.camera_bytes, cf2.camera_bytes);
+    swap(cf1.light_buffers, cf2.light_buffers);
 
     swap(cf1.material_index_map, cf2.material_index_map);
     swap(cf1.material_sets, cf2.material_sets);
-    swap(cf1.material_buffers, cf2.material_buffers);
 
     swap(cf1.entity_index_map, cf2.entity_index_map);
     swap(cf1.entity_sets, cf2.entity_sets);
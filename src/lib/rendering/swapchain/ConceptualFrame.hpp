@@ -4,7 +4,7 @@
  * Created:
  *   08/09/2021, 18:53:40
  * Last edited:
- *   9/20/2021, 9:14:26 PM
+ *   19/10/2026, 03:24:53
  * Auto updated?
  *   Yes
  *
@@ -25,9 +25,11 @@
 
 #include "../data/MaterialData.hpp"
 #include "../data/EntityData.hpp"
+#include "../data/CameraData.hpp"
 #include "../memory_manager/MemoryManager.hpp"
 #include "../memory/LinearMemoryPool.hpp"
 #include "../memory/Buffer.hpp"
+#include "../memory/Image.hpp"
 #include "../commandbuffers/CommandBuffer.hpp"
 #include "../descriptors/DescriptorSetLayout.hpp"
 #include "../descriptors/DescriptorPool.hpp"
@@ -35,8 +37,22 @@
 #include "../pipeline/Pipeline.hpp"
 #include "../synchronization/Semaphore.hpp"
 #include "../synchronization/Fence.hpp"
+#include "../profiling/GpuProfiler.hpp"
+#include "../profiling/RenderStats.hpp"
+#include "../culling/GpuCuller.hpp"
+#include "../culling/HiZPyramid.hpp"
+#include "../culling/CullBuffers.hpp"
+#include "../particles/ParticleSystem.hpp"
+#include "../particles/ParticleBuffers.hpp"
+#include "../bindless/BindlessTextures.hpp"
+#include "../bindless/MaterialBuffer.hpp"
+#include "../bindless/MaterialUploads.hpp"
+#include "../lighting/LightClusterer.hpp"
+#include "../lighting/LightBuffers.hpp"
 
 #include "SwapchainFrame.hpp"
+#include "SceneRecorder.hpp"
+#include "ReadbackRing.hpp"
 
 namespace Makma3D::Rendering {
     /* The ConceptualFrame class, which wraps around (different) SwapchainFrames to be able to render linearly to the swapchain. */
@@ -53,8 +69,51 @@ namespace Makma3D::Rendering {
         Rendering::SwapchainFrame* swapchain_frame;
         /* Temporary staging buffer for uploading stuff to the GPU. */
         Rendering::Buffer* stage_buffer;
-        /* Pipeline bound to the ConceptualFrame for a single render pass. */
-        const Rendering::Pipeline* pipeline;
+        /* Counts the binds issued and skipped by all recorders while recording this frame. */
+        Rendering::BindCounters _bind_counters;
+        /* The work done for the current use of this frame. The draws & binds are those of the recorded scene, and are thus kept as long as it's re-used. */
+        Rendering::RenderStats _stats;
+        /* The ring to copy the frame to when it's next submitted. Is a nullptr if the frame isn't captured. */
+        Rendering::ReadbackRing* readback_ring;
+        /* The number of the frame to capture, which the ring uses to pick a slot. */
+        uint64_t readback_frame;
+        /* The path to write the captured frame to. */
+        std::string readback_path;
+        /* The profiler that measures this frame on the GPU. Is a nullptr if the frame isn't profiled. */
+        Rendering::GpuProfiler* profiler;
+        /* The number of the frame as which this frame is rendered, which the profiler uses to pick its queries. */
+        uint64_t profiler_frame;
+        /* The culler that culls this frame's draws on the GPU. Is a nullptr if the frame's draws aren't culled. */
+        const Rendering::GpuCuller* culler;
+        /* The depth pyramid to cull against, which is rebuilt from this frame's depth buffer afterwards. */
+        Rendering::HiZPyramid* pyramid;
+        /* The buffers to cull this frame's draws with. Only allocated once the frame is culled. */
+        Rendering::CullBuffers* cull_buffers;
+        /* The particle system that this frame updates on the GPU. Is a nullptr if the frame has no particles. */
+        Rendering::ParticleSystem* particle_system;
+        /* The buffers to update the particles with. Only allocated once the frame has particles. */
+        Rendering::ParticleBuffers* particle_buffers;
+        /* The array with all textures, which the textured materials index instead of binding a set of their own. Is a nullptr if the textures aren't bindless. */
+        Rendering::BindlessTextures* bindless_textures;
+        /* The buffer with the parameters of all materials, which the frame copies the changed ones to before its render pass. */
+        Rendering::MaterialBuffer* material_buffer;
+        /* The materials this frame copies to the material buffer. Only allocated once the frame has a material buffer. */
+        Rendering::MaterialUploads* material_uploads;
+        /* The image the scene is rendered to at a lower resolution, which is upscaled to the frame's image after the render pass. Is a nullptr if the scene is rendered to the frame's image directly. */
+        const Rendering::Image* upscale_source;
+        /* The layout the frame's image should be in once it's upscaled to. */
+        VkImageLayout upscale_layout;
+        /* The filter with which the scene is upscaled. */
+        VkFilter upscale_filter;
+        /* Where each layer of the scene goes in the frame's image when there's a layer per view. Empty if the scene's only layer covers the entire image. */
+        Tools::Array<VkRect2D> upscale_rects;
+
+        /* Private helper function that records upscaling the scene to the frame's image, in the frame's draw command buffer. */
+        void _record_upscale();
+        /* Private helper function that uploads the given data to the given buffer through the staging buffer, counting it in the stats. */
+        void _upload(const Rendering::Buffer* buffer, void* data, uint32_t n_bytes);
+        /* Private helper function that resets the stats that are counted anew each time the frame is used, given the time the CPU waited for the frame's fence. */
+        void _begin_stats(uint64_t fence_wait_us);
 
         /* Declare the FrameManager as a friend. */
         friend class FrameManager;
@@ -67,8 +126,18 @@ namespace Makma3D::Rendering {
         /* Descriptor set layout for the per-object descriptors. */
         Rendering::DescriptorSetLayout entity_layout;
 
-        /* Command buffer for drawing to this Frame. */
+        /* Command buffer for drawing to this Frame. Only runs the render pass and executes the recorded chunks in it, and is thus cheap to re-record every frame. */
         Rendering::CommandBuffer* draw_cmd;
+        /* The recorders that each record a chunk of the scene in their own secondary command buffer. Kept around to re-submit as long as the scene doesn't change. */
+        Tools::Array<Rendering::SceneRecorder*> recorders;
+        /* The secondary command buffers of the recorders used for the recorded scene, in order. The chunks of each subpass are stored back-to-back. */
+        Tools::Array<VkCommandBuffer> scene_cmds;
+        /* The number of subpasses the recorded scene spans. */
+        uint32_t scene_subpasses;
+        /* Whether or not the recorders contain a complete recording that may be re-used. */
+        bool scene_recorded;
+        /* The version of the scene that is recorded by the recorders. */
+        uint64_t scene_version;
         /* Memory pool for creating buffers cheaply each Frame. */
         Rendering::LinearMemoryPool* memory_pool;
         /* Descriptor pool for all descriptors in this frame. */
@@ -78,13 +147,17 @@ namespace Makma3D::Rendering {
         Rendering::DescriptorSet* global_set;
         /* Global camera buffer for this frame. */
         Rendering::Buffer* camera_buffer;
+        /* Staging buffer for the camera data, which the draw command buffer copies to the camera buffer so that uploading it never waits on the GPU. */
+        Rendering::Buffer* camera_stage;
+        /* The number of bytes of camera data staged since the frame was last submitted. */
+        uint32_t camera_bytes;
+        /* The buffers with the clustered lights for this frame, which are bound to the global descriptor set right after the camera. */
+        Rendering::LightBuffers* light_buffers;
         
         /* Maps material IDs to material indices into the arrays. */
         std::unordered_map<const Materials::Material*, uint32_t> material_index_map;
-        /* Descriptors for all materials drawn with this buffer. */
+        /* Descriptors for all materials drawn with this buffer. Only the textured ones use theirs, and only if the textures aren't bindless. */
         Tools::Array<Rendering::DescriptorSet*> material_sets;
-        /* Buffers for all materials. */
-        Tools::Array<Rendering::Buffer*> material_buffers;
 
         /* Maps entity IDs to entity indices into the arrays. */
         std::unordered_map<ECS::entity_t, uint32_t> entity_index_map;
@@ -101,8 +174,8 @@ namespace Makma3D::Rendering {
         Rendering::Fence in_flight_fence;
 
     public:
-        /* Constructor for the ConceptualFrame class, which takes a MemoryManager to be able to draw games, a descriptor set layout for the global descriptor, a descriptor set layout for per-material descriptors and a descriptor set layout for the per-entity descriptors. */
-        ConceptualFrame(Rendering::MemoryManager& memory_manager, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& entity_layout);
+        /* Constructor for the ConceptualFrame class, which takes a MemoryManager to be able to draw games, a descriptor set layout for the global descriptor, a descriptor set layout for per-material descriptors, a descriptor set layout for the per-entity descriptors and the maximum number of chunks the scene may be recorded in. */
+        ConceptualFrame(Rendering::MemoryManager& memory_manager, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& entity_layout, uint32_t max_chunks = 1);
         /* Copy constructor for the ConceptualFrame class, which is deleted. */
         ConceptualFrame(const ConceptualFrame& other) = delete;
         /* Move constructor for the ConceptualFrame class. */
@@ -110,36 +183,85 @@ namespace Makma3D::Rendering {
         /* Destructor for the ConceptualFrame class. */
         ~ConceptualFrame();
 
-        /* Prepares rendering the frame as new by throwing out old data preparing to render at most the given number of objects with at least the given number of materials different materials. */
+        /* Returns whether the recorders contain a recording of the given version of the scene, in which case the frame can be submitted again without preparing or scheduling anything. */
+        inline bool has_scene(uint64_t version) const { return this->scene_recorded && this->scene_version == version; }
+
+        /* Prepares rendering the frame as new by throwing out old data preparing to render at most the given number of objects with at least the given number of materials different materials. Also invalidates any recorded scene. */
         void prepare_render(uint32_t n_materials, uint32_t n_objects);
 
-        /* Populates the internal camera buffer with the given projection and view matrices. */
-        void upload_camera_data(const glm::mat4& proj_matrix, const glm::mat4& view_matrix);
-        /* Uploads the given material to the GPU. What precisely will be uploaded is, of course, material dependent. */
+        /* Stages the matrices of the given views (of which there are at most max_views) to be copied to the internal camera buffer when this frame is submitted. */
+        void upload_camera_data(const Rendering::CameraData* views, uint32_t n_views = 1);
+        /* Uploads the lights and clusters of the given clusterers (one per view), and the given parameters with which the fragment shaders find them. If the buffers have to grow, this invalidates any recorded scene, since the global descriptor then has to be bound anew. */
+        void upload_light_data(const Rendering::LightClusterer* clusterers, uint32_t n_views, const Rendering::ClusterParams& params);
+        /* Stages the parameters of the materials in the given pool that were allocated or modified since they were last staged by any frame, which are copied to the material buffer when this frame is submitted. Has to be done each time the frame is used, whether it records the scene again or not. */
+        void upload_material_params(const Materials::MaterialPool& pool);
+        /* Prepares the given material to be drawn in this frame. Its parameters live in the material buffer, so this only binds the texture of textured materials if they aren't bindless. */
         void upload_material_data(const Materials::Material* material);
         /* Uploads entity data for the given entity to its buffer and its descriptor set. */
         void upload_entity_data(ECS::entity_t entity, const Rendering::EntityData& entity_data);
 
-        /* Starts to schedule the render pass associated with the wrapped SwapchainFrame on the internal draw queue. */
-        void schedule_start();
-        /* Binds the given pipeline on the internal draw command queue. */
-        void schedule_pipeline(const Rendering::Pipeline* pipeline);
-        /* Schedules frame-global descriptors on the internal draw queue (i.e., binds the camera data and the global descriptor). */
-        void schedule_global();
-        /* Schedules the stuff for the given material. Does have to have its data uploaded first, of course. */
-        void schedule_material(const Materials::Material* material);
-        /* Schedules the given entity's descriptor set on the internal draw queue. */
-        void schedule_entity(ECS::entity_t entity);
-        /* Binds the given vertex buffer to the internal draw queue. */
-        void schedule_vertex_buffer(const Rendering::Buffer* vertex_buffer);
-        /* Schedules a draw command for the given index buffer (with the given number of indices) on the internal draw queue. */
-        void schedule_draw(const Rendering::Buffer* index_buffer, uint32_t n_indices);
-        /* Stops scheduling by stopping the render pass associated with the wrapped SwapchainFrame. Then also stops the command buffer itself. */
+        /* Starts to record the given version of the scene in the given number of chunks for each of the given number of subpasses, each in its own secondary command buffer that continues the render pass associated with the wrapped SwapchainFrame. Chunk c of subpass s is chunk 's * n_chunks + c'. Also sets the viewport & scissor to the frame's render extent. Different chunks may be scheduled from different threads at the same time, as long as all data has been uploaded beforehand. */
+        void schedule_start(uint64_t version, uint32_t n_chunks = 1, uint32_t n_subpasses = 1);
+        /* Binds the given pipeline in the given chunk. Does nothing if the pipeline is already bound. */
+        void schedule_pipeline(uint32_t chunk, const Rendering::Pipeline* pipeline);
+        /* Schedules frame-global descriptors in the given chunk (i.e., binds the camera data and the global descriptor, and the bindless textures if there are any). */
+        void schedule_global(uint32_t chunk);
+        /* Schedules the stuff for the given material in the given chunk. Does have to have its data uploaded first, of course. */
+        void schedule_material(uint32_t chunk, const Materials::Material* material);
+        /* Schedules the given entity's descriptor set in the given chunk. */
+        void schedule_entity(uint32_t chunk, ECS::entity_t entity);
+        /* Binds the given vertex buffer (at the given offset, in bytes) to the given binding in the given chunk. Does nothing if it's already bound there at that offset. */
+        void schedule_vertex_buffer(uint32_t chunk, uint32_t binding, const Rendering::Buffer* vertex_buffer, VkDeviceSize offset = 0);
+        /* Binds the given index buffer (at the given offset, in bytes) in the given chunk. Does nothing if it's already bound at that offset. */
+        void schedule_index_buffer(uint32_t chunk, const Rendering::Buffer* index_buffer, VkDeviceSize offset = 0);
+        /* Schedules a draw command for the given range of indices in the bound index buffer in the given chunk. The vertex offset is added to each index before it's used to lookup a vertex in the bound vertex buffer. */
+        void schedule_draw(uint32_t chunk, uint32_t first_index, uint32_t n_indices, int32_t vertex_offset);
+        /* Schedules the draw command that the GPU culling writes for the given draw (i.e., the given index in the items uploaded by upload_cull_items()) in the given chunk, which draws at most the given number of indices from the bound index buffer. */
+        void schedule_indirect_draw(uint32_t chunk, uint32_t draw_index, uint32_t n_indices);
+        /* Schedules drawing the living particles with the given pipeline in the given chunk, whose layout has to start with the global layout and the particle system's draw layout. */
+        void schedule_particle_draw(uint32_t chunk, const Rendering::Pipeline* pipeline);
+        /* Starts measuring the given bucket of draws in the given chunk, if the frame is profiled. */
+        void schedule_bucket_start(uint32_t chunk, uint32_t bucket);
+        /* Stops measuring the given bucket of draws in the given chunk, if the frame is profiled. */
+        void schedule_bucket_stop(uint32_t chunk, uint32_t bucket);
+        /* Stops recording the scene, after which it can be re-used by subsequent calls to submit(). */
         void schedule_stop();
 
-        /* "Renders" the frame by sending the internal draw queue to the given device queue. */
-        void submit(const VkQueue& vk_queue);
+        /* Tells the frame that it's rendered as the given frame number and measured by the given profiler (which may be a nullptr to not profile it). Must be done each time the frame is used, before recording or submitting it. */
+        void schedule_profiling(Rendering::GpuProfiler* profiler, uint64_t frame);
+        /* Schedules capturing the frame to the given path when it's next submitted, by copying it to the given ReadbackRing. The given frame number tells the ring when the copy is done. */
+        void schedule_readback(Rendering::ReadbackRing* readback_ring, uint64_t frame, const std::string& path);
+        /* Tells the frame that the scene is rendered to the given image at the frame's render extent, which is then blitted to the frame's own image with the given filter, leaving that in the given layout. The image may be a nullptr if the scene is rendered to the frame's image directly. If the image has a layer per view, the given rectangles (in pixels of the frame's image) tell where each layer goes; otherwise, its only layer is stretched over the entire image. Must be done each time the frame is used, before submitting it. */
+        void schedule_upscale(const Rendering::Image* source, VkImageLayout final_layout, VkFilter filter = VK_FILTER_LINEAR, const Tools::Array<VkRect2D>& view_rects = {});
+        /* Tells the frame that its draws are culled on the GPU by the given culler, against the given depth pyramid (which is rebuilt from the frame's depth buffer after the render pass). Both may be nullptrs to not cull. If check is true, the results are read back so check_culling() can compare them against the CPU. Must be done each time the frame is used, before uploading culling data or recording it. */
+        void schedule_culling(const Rendering::GpuCuller* culler, Rendering::HiZPyramid* pyramid, bool check = false);
+        /* Uploads the draws to cull, in the order of the draw indices passed to schedule_indirect_draw(). Must be done before recording the scene, since it may replace the buffer the recorded draws read from. */
+        void upload_cull_items(const Tools::Array<Rendering::CullItem>& items);
+        /* Uploads the parameters to cull with when the frame is next submitted. */
+        void upload_cull_params(const Rendering::CullParams& params);
+        /* Compares the results of the last culling of this frame against the reference on the CPU, if they were read back. Returns the number of draws that differ. Must be called once the frame is no longer in flight. */
+        uint32_t check_culling();
+        /* Tells the frame that it updates the particles of the given system before its render pass. The system may be a nullptr to not update any. If check is true, the counters are read back so check_particles() can compare them against the CPU. Must be done each time the frame is used, before uploading particle data or recording it. */
+        void schedule_particles(Rendering::ParticleSystem* particle_system, bool check = false);
+        /* Uploads the emitters and the parameters to update the particles with when the frame is next submitted. */
+        void upload_particle_data(const Tools::Array<Rendering::EmitterData>& emitters, const Rendering::ParticleParams& params);
+        /* Compares the number of living particles after the last update of this frame against the reference on the CPU, if they were read back. Returns the number of particles that differ. Must be called once the frame is no longer in flight. */
+        uint32_t check_particles();
+        /* Tells the frame that its textured materials find their textures through the given bindless array instead of through sets of their own. May be a nullptr to bind them per material. Must be done each time the frame is used, before uploading material data or recording it. */
+        void schedule_bindless(Rendering::BindlessTextures* bindless_textures);
+        /* Tells the frame that the shaders find the parameters of the materials in the given buffer, to which the frame copies those that changed before its render pass. Must be done each time the frame is used, before preparing it or uploading material parameters. */
+        void schedule_materials(Rendering::MaterialBuffer* material_buffer);
+        /* "Renders" the frame by recording the render pass with the recorded scene (moving to the next subpass after each subpass' chunks) in the internal draw queue and sending that to the given device queue. If the frame isn't presentable (i.e., it renders to an OffscreenTarget), it doesn't wait for the image to be acquired nor signals that it's ready for presentation. If any materials changed, they're copied to the material buffer first. If the frame is culled, its draws are culled before the render pass and the depth pyramid is rebuilt after it. If the frame has particles, they're updated before the render pass too. If the scene is upscaled, that's done after the render pass as well. If a readback is scheduled, the frame is then also copied to the ring. */
+        void submit(const VkQueue& vk_queue, bool presentable = true);
 
+        /* Returns the number of binds issued and skipped while recording this frame. */
+        inline const Rendering::BindCounters& bind_counters() const { return this->_bind_counters; }
+        /* Returns the work done for the current use of this frame. */
+        inline const Rendering::RenderStats& stats() const { return this->_stats; }
+        /* Returns whether the frame's draws are culled on the GPU. */
+        inline bool culled() const { return this->culler != nullptr; }
+        /* Returns the maximum number of chunks the scene may be recorded in, across all subpasses. */
+        inline uint32_t max_chunks() const { return static_cast<uint32_t>(this->recorders.size()); }
         /* Returns the index of the internal frame. */
         inline uint32_t index() const { return this->swapchain_frame->index(); }
 
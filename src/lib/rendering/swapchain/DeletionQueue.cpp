@@ -0,0 +1,83 @@
+/* DELETION QUEUE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 09:12:36
+ * Last edited:
+ *   19/10/2026, 09:12:36
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the DeletionQueue class, which keeps track of resources that
+ *   are no longer used for new frames but may still be used by frames in
+ *   flight. Each resource is tagged with the first frame that doesn't use
+ *   it anymore, and is only destroyed once all frames before it have
+ *   completed.
+**/
+
+#include "tools/Logger.hpp"
+
+#include "DeletionQueue.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** DELETIONQUEUE CLASS *****/
+/* Default constructor for the DeletionQueue class. */
+DeletionQueue::DeletionQueue() {}
+
+/* Move constructor for the DeletionQueue class. */
+DeletionQueue::DeletionQueue(DeletionQueue&& other) :
+    entries(std::move(other.entries))
+{
+    // Make sure the other doesn't destroy our resources
+    other.entries.clear();
+}
+
+/* Destructor for the DeletionQueue class, which destroys all remaining resources. Assumes the GPU is idle by then. */
+DeletionQueue::~DeletionQueue() {
+    this->flush();
+}
+
+
+
+/* Retires a resource that may be used by any frame before the given frame number. The given deleter is called to destroy it once that many frames have completed. */
+void DeletionQueue::retire(uint64_t frame, std::function<void()>&& deleter) {
+    #ifndef NDEBUG
+    // Frame numbers only go up, so the queue stays ordered by simply appending
+    if (!this->entries.empty() && frame < this->entries.back().frame) {
+        logger.fatalc(DeletionQueue::channel, "Cannot retire a resource for frame ", frame, " after one for frame ", this->entries.back().frame, '.');
+    }
+    #endif
+
+    this->entries.push_back({ frame, std::move(deleter) });
+}
+
+/* Destroys all resources that are only used by completed frames, given the number of frames that have completed so far. */
+void DeletionQueue::collect(uint64_t n_completed) {
+    while (!this->entries.empty() && this->entries.front().frame <= n_completed) {
+        logger.logc(Verbosity::debug, DeletionQueue::channel, "Destroying resource retired at frame ", this->entries.front().frame, " (", n_completed, " frames completed)");
+        this->entries.front().deleter();
+        this->entries.pop_front();
+    }
+}
+
+/* Destroys all remaining resources, regardless of their frame. Only call this when the GPU is idle. */
+void DeletionQueue::flush() {
+    while (!this->entries.empty()) {
+        this->entries.front().deleter();
+        this->entries.pop_front();
+    }
+}
+
+
+
+/* Swap operator for the DeletionQueue class. */
+void Rendering::swap(DeletionQueue& dq1, DeletionQueue& dq2) {
+    using std::swap;
+
+    swap(dq1.entries, dq2.entries);
+}
@@ -0,0 +1,79 @@
+/* DELETION QUEUE.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 09:12:40
+ * Last edited:
+ *   19/10/2026, 09:12:40
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the DeletionQueue class, which keeps track of resources that
+ *   are no longer used for new frames but may still be used by frames in
+ *   flight. Each resource is tagged with the first frame that doesn't use
+ *   it anymore, and is only destroyed once all frames before it have
+ *   completed.
+**/
+
+#ifndef RENDERING_DELETION_QUEUE_HPP
+#define RENDERING_DELETION_QUEUE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace Makma3D::Rendering {
+    /* The DeletionQueue class, which defers destroying resources until the frames that use them have completed. */
+    class DeletionQueue {
+    public:
+        /* Channel name for the DeletionQueue class. */
+        static constexpr const char* channel = "DeletionQueue";
+
+    private:
+        /* Private struct that pairs a deleter with the frame from which its resource is no longer used. */
+        struct Entry {
+            /* The number of the first frame that doesn't use the resource anymore. */
+            uint64_t frame;
+            /* The function that destroys the resource. */
+            std::function<void()> deleter;
+        };
+
+        /* The retired resources, ordered by frame number. */
+        std::deque<Entry> entries;
+
+    public:
+        /* Default constructor for the DeletionQueue class. */
+        DeletionQueue();
+        /* Copy constructor for the DeletionQueue class, which is deleted. */
+        DeletionQueue(const DeletionQueue& other) = delete;
+        /* Move constructor for the DeletionQueue class. */
+        DeletionQueue(DeletionQueue&& other);
+        /* Destructor for the DeletionQueue class, which destroys all remaining resources. Assumes the GPU is idle by then. */
+        ~DeletionQueue();
+
+        /* Retires a resource that may be used by any frame before the given frame number. The given deleter is called to destroy it once that many frames have completed. */
+        void retire(uint64_t frame, std::function<void()>&& deleter);
+        /* Destroys all resources that are only used by completed frames, given the number of frames that have completed so far. */
+        void collect(uint64_t n_completed);
+        /* Destroys all remaining resources, regardless of their frame. Only call this when the GPU is idle. */
+        void flush();
+
+        /* Returns the number of resources that are still waiting to be destroyed. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->entries.size()); }
+
+        /* Copy assignment operator for the DeletionQueue class, which is deleted. */
+        DeletionQueue& operator=(const DeletionQueue& other) = delete;
+        /* Move assignment operator for the DeletionQueue class. */
+        inline DeletionQueue& operator=(DeletionQueue&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the DeletionQueue class. */
+        friend void swap(DeletionQueue& dq1, DeletionQueue& dq2);
+
+    };
+
+    /* Swap operator for the DeletionQueue class. */
+    void swap(DeletionQueue& dq1, DeletionQueue& dq2);
+
+}
+
+#endif
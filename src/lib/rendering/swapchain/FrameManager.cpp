@@ -4,15 +4,18 @@
  * Created:
  *   08/09/2021, 23:33:43
  * Last edited:
- *   9/20/2021, 9:24:06 PM
+ *   19/10/2026, 01:31:44
  * Auto updated?
  *   Yes
  *
  * Description:
  *   Contains the FrameManager class, which is in charge of retrieving a
- *   conceptual frame from the swapchain.
+ *   conceptual frame from the swapchain (or from an OffscreenTarget when
+ *   rendering headless).
 **/
 
+#include <chrono>
+
 #include "tools/Logger.hpp"
 #include "../auxillary/ErrorCodes.hpp"
 
@@ -48,20 +51,57 @@ static void populate_present_info(VkPresentInfoKHR& present_info, const Swapchai
 
 
 /***** FRAMEMANAGER CLASS *****/
-/* Constructor for the FrameManager class, which takes a MemoryManager for stuff allocation, a Swapchain to draw images from, a layout for the frame's global descriptor, a layout for the material descriptors and a layout for the frame's per-object descriptors. */
-FrameManager::FrameManager(Rendering::MemoryManager& memory_manager, const Rendering::Swapchain& swapchain, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& object_layout) :
+/* Constructor for the FrameManager class, which takes a MemoryManager for stuff allocation, a Swapchain to draw images from, a layout for the frame's global descriptor, a layout for the material descriptors, a layout for the frame's per-object descriptors, the number of frames that may be in flight at once (between min_frames_in_flight and max_frames_in_flight) and the maximum number of chunks each frame may record its scene in. */
+FrameManager::FrameManager(Rendering::MemoryManager& memory_manager, const Rendering::Swapchain& swapchain, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& object_layout, uint32_t frames_in_flight, uint32_t max_chunks) :
     memory_manager(memory_manager),
-    swapchain(swapchain),
+    swapchain(&swapchain),
+    offscreen_target(nullptr),
 
-    frame_index(0)
+    frame_index(0),
+    frame_number(0),
+    n_completed(0),
+    _wait_stats({})
 {
     logger.logc(Verbosity::important, FrameManager::channel, "Initializing...");
 
+    // Make sure the number of frames in flight is sensible
+    if (frames_in_flight < FrameManager::min_frames_in_flight || frames_in_flight > FrameManager::max_frames_in_flight) {
+        logger.fatalc(FrameManager::channel, "Number of frames in flight must be between ", FrameManager::min_frames_in_flight, " and ", FrameManager::max_frames_in_flight, " (got ", frames_in_flight, ")");
+    }
+
+    // Create the conceptual frames
+    logger.logc(Verbosity::details, FrameManager::channel, "Preparing ", frames_in_flight, " ConceptualFrames...");
+    this->conceptual_frames.reserve(frames_in_flight);
+    for (uint32_t i = 0; i < frames_in_flight; i++) {
+        this->conceptual_frames.push_back(ConceptualFrame(this->memory_manager, global_layout, material_layout, object_layout, max_chunks));
+    }
+
+    logger.logc(Verbosity::important, FrameManager::channel, "Init success.");
+}
+
+/* Constructor for the FrameManager class, which takes a MemoryManager for stuff allocation, an OffscreenTarget to draw images from when rendering headless, a layout for the frame's global descriptor, a layout for the material descriptors, a layout for the frame's per-object descriptors, the number of frames that may be in flight at once (between min_frames_in_flight and max_frames_in_flight) and the maximum number of chunks each frame may record its scene in. */
+FrameManager::FrameManager(Rendering::MemoryManager& memory_manager, const Rendering::OffscreenTarget& offscreen_target, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& object_layout, uint32_t frames_in_flight, uint32_t max_chunks) :
+    memory_manager(memory_manager),
+    swapchain(nullptr),
+    offscreen_target(&offscreen_target),
+
+    frame_index(0),
+    frame_number(0),
+    n_completed(0),
+    _wait_stats({})
+{
+    logger.logc(Verbosity::important, FrameManager::channel, "Initializing headless...");
+
+    // Make sure the number of frames in flight is sensible
+    if (frames_in_flight < FrameManager::min_frames_in_flight || frames_in_flight > FrameManager::max_frames_in_flight) {
+        logger.fatalc(FrameManager::channel, "Number of frames in flight must be between ", FrameManager::min_frames_in_flight, " and ", FrameManager::max_frames_in_flight, " (got ", frames_in_flight, ")");
+    }
+
     // Create the conceptual frames
-    logger.logc(Verbosity::details, FrameManager::channel, "Preparing ConceptualFrames...");
-    this->conceptual_frames.reserve(FrameManager::max_frames_in_flight);
-    for (uint32_t i = 0; i < FrameManager::max_frames_in_flight; i++) {
-        this->conceptual_frames.push_back(ConceptualFrame(this->memory_manager, global_layout, material_layout, object_layout));
+    logger.logc(Verbosity::details, FrameManager::channel, "Preparing ", frames_in_flight, " ConceptualFrames...");
+    this->conceptual_frames.reserve(frames_in_flight);
+    for (uint32_t i = 0; i < frames_in_flight; i++) {
+        this->conceptual_frames.push_back(ConceptualFrame(this->memory_manager, global_layout, material_layout, object_layout, max_chunks));
     }
 
     logger.logc(Verbosity::important, FrameManager::channel, "Init success.");
@@ -71,11 +111,16 @@ FrameManager::FrameManager(Rendering::MemoryManager& memory_manager, const Rende
 FrameManager::FrameManager(FrameManager&& other) :
     memory_manager(other.memory_manager),
     swapchain(other.swapchain),
+    offscreen_target(other.offscreen_target),
 
     swapchain_frames(std::move(other.swapchain_frames)),
     conceptual_frames(std::move(other.conceptual_frames)),
 
-    frame_index(other.frame_index)
+    frame_index(other.frame_index),
+    frame_number(other.frame_number),
+    n_completed(other.n_completed),
+    _wait_stats(other._wait_stats),
+    deletion_queue(std::move(other.deletion_queue))
 {
     // Array's move guarantees that it's empty after a move constructor
 }
@@ -84,42 +129,60 @@ FrameManager::FrameManager(FrameManager&& other) :
 FrameManager::~FrameManager() {
     logger.logc(Verbosity::important, FrameManager::channel, "Cleaning...");
 
-    // Nothing yet, as C++'s default deallocators seem to deal with it
+    // Destroy any resources that are still retired. The GPU is expected to be idle by now
+    this->deletion_queue.flush();
 
     logger.logc(Verbosity::important, FrameManager::channel, "Cleaned.");
 }
 
 
 
-/* Binds the FrameManager to a render pass and a depth stencil by retrieving the swapchain frames. Must be done at least once. */
-void FrameManager::bind(const Rendering::RenderPass& render_pass, const Rendering::DepthStencil& depth_stencil) {
-    logger.logc(Verbosity::details, FrameManager::channel, "Binding FrameManager to RenderPass @ ", &render_pass, " and DepthStencil @ ", &depth_stencil);
+/* Binds the FrameManager to a render pass and the transient attachments of its RenderGraph by retrieving the swapchain frames. Must be done at least once. */
+void FrameManager::bind(const Rendering::RenderPass& render_pass, const Rendering::GraphAttachments& attachments) {
+    logger.logc(Verbosity::details, FrameManager::channel, "Binding FrameManager to RenderPass @ ", &render_pass, " and GraphAttachments @ ", &attachments);
 
-    // Clear any old frames
-    this->swapchain_frames.clear();
-    // Get the list of swapchain images
-    this->swapchain_frames = this->swapchain.get_frames(render_pass, depth_stencil);
+    // Retire any old frames, since their framebuffers and image views may still be used by frames in flight
+    if (this->swapchain_frames.size() > 0) {
+        Tools::Array<Rendering::SwapchainFrame>* old_frames = new Tools::Array<Rendering::SwapchainFrame>(std::move(this->swapchain_frames));
+        this->retire([old_frames]() { delete old_frames; });
+    }
+    // Get the list of swapchain images, or the offscreen ones if we're headless
+    this->swapchain_frames = this->swapchain != nullptr ? this->swapchain->get_frames(render_pass, attachments) : this->offscreen_target->get_frames(render_pass, attachments);
 
-    // Reset the index for the frame we're gonna render to
-    this->frame_index = 0;
+    // Note that we don't reset the frame index, since the ConceptualFrames still have to be cycled in order for their fences to tell us which frames completed
 
     // Done
 }
 
 /* Returns a new ConceptualFrame to which the render system can render. Blocks until any such frame is available. */
 Rendering::ConceptualFrame* FrameManager::get_frame() {
+    uint32_t frames_in_flight = this->frames_in_flight();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
     // First, wait until the current conceptual frame is not in flight anymore
     Rendering::ConceptualFrame* conceptual_frame = &this->conceptual_frames[this->frame_index];
     conceptual_frame->in_flight_fence.wait();
+    std::chrono::steady_clock::time_point fence_done = std::chrono::steady_clock::now();
+
+    // That fence was last used by the frame frames_in_flight ago, which means that that frame and all frames before it are done; so we can destroy anything only they used
+    if (this->frame_number >= frames_in_flight) {
+        this->n_completed = this->frame_number - frames_in_flight + 1;
+        this->deletion_queue.collect(this->n_completed);
+    }
 
     // Next, try to get a swapchain for this conceptual frame
     uint32_t swapchain_index;
-    VkResult vk_result = vkAcquireNextImageKHR(this->swapchain.gpu, this->swapchain, UINT64_MAX, conceptual_frame->image_ready_semaphore, VK_NULL_HANDLE, &swapchain_index);
-    if (vk_result == VK_ERROR_OUT_OF_DATE_KHR || vk_result == VK_SUBOPTIMAL_KHR) {
-        // The swapchain is outdated or suboptimal (probably a resize); we resize to fit again
-        return nullptr;
-    } else if (vk_result != VK_SUCCESS) {
-        logger.fatalc(FrameManager::channel, "Could not get frame from swapchain: ", vk_error_map[vk_result]);
+    if (this->swapchain != nullptr) {
+        VkResult vk_result = vkAcquireNextImageKHR(this->swapchain->gpu, *this->swapchain, UINT64_MAX, conceptual_frame->image_ready_semaphore, VK_NULL_HANDLE, &swapchain_index);
+        if (vk_result == VK_ERROR_OUT_OF_DATE_KHR) {
+            // The swapchain is outdated (probably a resize); we resize to fit again
+            return nullptr;
+        } else if (vk_result != VK_SUCCESS && vk_result != VK_SUBOPTIMAL_KHR) {
+            logger.fatalc(FrameManager::channel, "Could not get frame from swapchain: ", vk_error_map[vk_result]);
+        }
+    } else {
+        // There's nothing to acquire when rendering headless; simply cycle through the offscreen images
+        swapchain_index = static_cast<uint32_t>(this->frame_number % this->swapchain_frames.size());
     }
 
     // When we have an image, make sure it's not secretly being used by another conceptual frame
@@ -132,17 +195,34 @@ Rendering::ConceptualFrame* FrameManager::get_frame() {
     // Link the found swapchain image to the conceptualframe
     conceptual_frame->swapchain_frame = swapchain_frame;
 
-    // Done, increment the frame index and return
-    this->frame_index = (this->frame_index + 1) % FrameManager::max_frames_in_flight;
+    // Update the wait statistics
+    std::chrono::steady_clock::time_point acquire_done = std::chrono::steady_clock::now();
+    uint64_t fence_wait_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(fence_done - start).count());
+    uint64_t acquire_wait_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(acquire_done - fence_done).count());
+    ++this->_wait_stats.n_frames;
+    this->_wait_stats.fence_wait_us += fence_wait_us;
+    this->_wait_stats.acquire_wait_us += acquire_wait_us;
+    this->_wait_stats.last_wait_us = fence_wait_us + acquire_wait_us;
+    if (this->_wait_stats.last_wait_us > this->_wait_stats.max_wait_us) { this->_wait_stats.max_wait_us = this->_wait_stats.last_wait_us; }
+    conceptual_frame->_begin_stats(fence_wait_us);
+
+    // Done, increment the frame index and return. Note that a suboptimal swapchain still gave us an image (and signalled the semaphore), so we render to it anyway and leave the resize to present_frame()
+    this->frame_index = (this->frame_index + 1) % frames_in_flight;
+    ++this->frame_number;
     return conceptual_frame;
 }
 
 /* Schedules the given frame for presentation once rendering to it has been completed. Returns whether or not the window needs to be resized. */
 bool FrameManager::present_frame(const Rendering::ConceptualFrame* conceptual_frame) {
+    // Offscreen images aren't presented, and never need a resize
+    if (this->swapchain == nullptr) {
+        return false;
+    }
+
     // Prepare the present info
     uint32_t index = conceptual_frame->swapchain_frame->index();
     VkPresentInfoKHR present_info;
-    populate_present_info(present_info, this->swapchain, index, conceptual_frame->render_ready_semaphore);
+    populate_present_info(present_info, *this->swapchain, index, conceptual_frame->render_ready_semaphore);
 
     // Present it using the queue present function
     Tools::Array<VkQueue> present_queues = this->memory_manager.gpu.queues(QueueType::present);
@@ -158,13 +238,19 @@ bool FrameManager::present_frame(const Rendering::ConceptualFrame* conceptual_fr
     return false;
 }
 
+/* Retires a resource that may still be used by the frames returned so far. The given deleter is called to destroy it once all those frames have completed, without stalling the GPU. */
+void FrameManager::retire(std::function<void()>&& deleter) {
+    this->deletion_queue.retire(this->frame_number, std::move(deleter));
+}
+
 
 
 /* Swap operator for the FrameManager class. */
 void Rendering::swap(FrameManager& fm1, FrameManager& fm2) {
     #ifndef NDEBUG
     if (&fm1.memory_manager != &fm2.memory_manager) { logger.fatalc(FrameManager::channel, "Cannot swap frame managers with different memory managers."); }
-    if (&fm1.swapchain != &fm2.swapchain) { logger.fatalc(FrameManager::channel, "Cannot swap frame managers with different swapchains."); }
+    if (fm1.swapchain != fm2.swapchain) { logger.fatalc(FrameManager::channel, "Cannot swap frame managers with different swapchains."); }
+    if (fm1.offscreen_target != fm2.offscreen_target) { logger.fatalc(FrameManager::channel, "Cannot swap frame managers with different offscreen targets."); }
     #endif
 
     using std::swap;
@@ -173,4 +259,8 @@ void Rendering::swap(FrameManager& fm1, FrameManager& fm2) {
     swap(fm1.conceptual_frames, fm2.conceptual_frames);
 
     swap(fm1.frame_index, fm2.frame_index);
+    swap(fm1.frame_number, fm2.frame_number);
+    swap(fm1.n_completed, fm2.n_completed);
+    swap(fm1._wait_stats, fm2._wait_stats);
+    swap(fm1.deletion_queue, fm2.deletion_queue);
 }
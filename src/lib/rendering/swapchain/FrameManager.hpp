@@ -4,42 +4,70 @@
  * Created:
  *   08/09/2021, 23:33:27
  * Last edited:
- *   9/20/2021, 9:16:25 PM
+ *   19/10/2026, 01:31:44
  * Auto updated?
  *   Yes
  *
  * Description:
  *   Contains the FrameManager class, which is in charge of retrieving a
- *   conceptual frame from the swapchain.
+ *   conceptual frame from the swapchain (or from an OffscreenTarget when
+ *   rendering headless).
 **/
 
 #ifndef RENDERING_FRAME_MANAGER_HPP
 #define RENDERING_FRAME_MANAGER_HPP
 
+#include <functional>
+
 #include "tools/Array.hpp"
 
 #include "../memory_manager/MemoryManager.hpp"
 #include "../descriptors/DescriptorSetLayout.hpp"
 #include "../renderpass/RenderPass.hpp"
-#include "../depthtesting/DepthStencil.hpp"
+#include "../rendergraph/GraphAttachments.hpp"
 
 #include "Swapchain.hpp"
+#include "OffscreenTarget.hpp"
 #include "SwapchainFrame.hpp"
 #include "ConceptualFrame.hpp"
+#include "DeletionQueue.hpp"
 
 namespace Makma3D::Rendering {
+    /* Statistics on how long the CPU waited in FrameManager::get_frame(), which shows how much the number of frames in flight and the present mode throttle the CPU. */
+    struct FrameWaitStats {
+        /* The number of frames measured. */
+        uint32_t n_frames;
+        /* The total time spent waiting until a ConceptualFrame was no longer in flight, in microseconds. */
+        uint64_t fence_wait_us;
+        /* The total time spent acquiring a swapchain image (including waiting until it's no longer used by another frame), in microseconds. */
+        uint64_t acquire_wait_us;
+        /* The time waited for the most recent frame, in microseconds. */
+        uint64_t last_wait_us;
+        /* The longest time waited for a single frame, in microseconds. */
+        uint64_t max_wait_us;
+
+        /* Returns the average time waited per frame, in microseconds. */
+        inline double avg_wait_us() const { return this->n_frames > 0 ? (double) (this->fence_wait_us + this->acquire_wait_us) / (double) this->n_frames : 0.0; }
+    };
+
+
+
     /* The FrameManager class, which manages and synchronizes swapchain frame access. */
     class FrameManager {
     public:
         /* The channel for the FrameManager. */
         static constexpr const char* channel = "FrameManager";
-        /* The maximum number of frames that will be in-flight. */
-        static constexpr const uint32_t max_frames_in_flight = 2;
+        /* The minimum number of frames that may be in-flight. */
+        static constexpr const uint32_t min_frames_in_flight = 1;
+        /* The maximum number of frames that may be in-flight. */
+        static constexpr const uint32_t max_frames_in_flight = 4;
 
         /* A MemoryManager with which we allocate stuff. */
         Rendering::MemoryManager& memory_manager;
-        /* The Swapchain from which we draw frames. */
-        const Rendering::Swapchain& swapchain;
+        /* The Swapchain from which we draw frames. Is a nullptr if we render headless. */
+        const Rendering::Swapchain* swapchain;
+        /* The OffscreenTarget from which we draw frames when rendering headless. Is a nullptr otherwise. */
+        const Rendering::OffscreenTarget* offscreen_target;
 
     private:
         /* List of SwapchainFrames from which we pick. */
@@ -49,10 +77,20 @@ namespace Makma3D::Rendering {
 
         /* Index that keeps track of the ConceptualFrame we next intend to return. */
         uint32_t frame_index;
+        /* The number of frames returned so far, which is also the number of the next frame we return. */
+        uint64_t frame_number;
+        /* The number of frames that are known to have completed on the GPU. */
+        uint64_t n_completed;
+        /* Keeps track of how long get_frame() had to wait. */
+        Rendering::FrameWaitStats _wait_stats;
+        /* Queue of resources that aren't used by new frames anymore, but are kept alive until the frames in flight that might use them have completed. */
+        Rendering::DeletionQueue deletion_queue;
 
     public:
-        /* Constructor for the FrameManager class, which takes a MemoryManager for stuff allocation, a Swapchain to draw images from, a layout for the frame's global descriptor, a layout for the material descriptors and a layout for the frame's per-object descriptors. */
-        FrameManager(Rendering::MemoryManager& memory_manager, const Rendering::Swapchain& swapchain, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& object_layout);
+        /* Constructor for the FrameManager class, which takes a MemoryManager for stuff allocation, a Swapchain to draw images from, a layout for the frame's global descriptor, a layout for the material descriptors, a layout for the frame's per-object descriptors, the number of frames that may be in flight at once (between min_frames_in_flight and max_frames_in_flight) and the maximum number of chunks each frame may record its scene in. */
+        FrameManager(Rendering::MemoryManager& memory_manager, const Rendering::Swapchain& swapchain, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& object_layout, uint32_t frames_in_flight = 2, uint32_t max_chunks = 1);
+        /* Constructor for the FrameManager class, which takes a MemoryManager for stuff allocation, an OffscreenTarget to draw images from when rendering headless, a layout for the frame's global descriptor, a layout for the material descriptors, a layout for the frame's per-object descriptors, the number of frames that may be in flight at once (between min_frames_in_flight and max_frames_in_flight) and the maximum number of chunks each frame may record its scene in. */
+        FrameManager(Rendering::MemoryManager& memory_manager, const Rendering::OffscreenTarget& offscreen_target, const Rendering::DescriptorSetLayout& global_layout, const Rendering::DescriptorSetLayout& material_layout, const Rendering::DescriptorSetLayout& object_layout, uint32_t frames_in_flight = 2, uint32_t max_chunks = 1);
         /* Copy constructor for the FrameManager class, which is deleted. */
         FrameManager(const FrameManager& other) = delete;
         /* Move constructor for the FrameManager class. */
@@ -63,12 +101,27 @@ namespace Makma3D::Rendering {
         /* Resizes the FrameManager by getting all swapchain images again. */
         void resize();
 
-        /* Binds the FrameManager to a render pass and a depth stencil by retrieving the swapchain frames. Must be done at least once. */
-        void bind(const Rendering::RenderPass& render_pass, const Rendering::DepthStencil& depth_stencil);
-        /* Returns a new ConceptualFrame to which the render system can render. Blocks until any such frame is available. If it returns a nullptr, that means that the swapchain is out of date for some reason. */
+        /* Binds the FrameManager to a render pass and the transient attachments of its RenderGraph by retrieving the swapchain frames. Must be done at least once. Any previous swapchain frames are retired rather than destroyed, so frames in flight can still finish with them. */
+        void bind(const Rendering::RenderPass& render_pass, const Rendering::GraphAttachments& attachments);
+        /* Returns a new ConceptualFrame to which the render system can render. Blocks until any such frame is available. If it returns a nullptr, that means that the swapchain is out of date for some reason. When rendering headless, the images of the OffscreenTarget are simply cycled. */
         Rendering::ConceptualFrame* get_frame();
-        /* Schedules the given frame for presentation once rendering to it has been completed. Returns whether or not the window needs to be resized. */
+        /* Schedules the given frame for presentation once rendering to it has been completed. Returns whether or not the window needs to be resized. Does nothing when rendering headless. */
         bool present_frame(const Rendering::ConceptualFrame* conceptual_frame);
+        /* Retires a resource that may still be used by the frames returned so far. The given deleter is called to destroy it once all those frames have completed, without stalling the GPU. */
+        void retire(std::function<void()>&& deleter);
+
+        /* Returns whether or not we render headless, i.e., to an OffscreenTarget instead of a Swapchain. */
+        inline bool headless() const { return this->offscreen_target != nullptr; }
+        /* Returns the number of the frame most recently returned by get_frame(). */
+        inline uint64_t current_frame() const { return this->frame_number - 1; }
+        /* Returns the number of frames that are known to have completed on the GPU, as of the last call to get_frame(). */
+        inline uint64_t completed_frames() const { return this->n_completed; }
+        /* Returns the number of frames that may be in flight at once. */
+        inline uint32_t frames_in_flight() const { return static_cast<uint32_t>(this->conceptual_frames.size()); }
+        /* Returns how long get_frame() had to wait since the statistics were last reset. */
+        inline const Rendering::FrameWaitStats& wait_stats() const { return this->_wait_stats; }
+        /* Resets the wait statistics. */
+        inline void reset_wait_stats() { this->_wait_stats = {}; }
 
         /* Copy assignment operator for the FrameManager class, which is deleted. */
         FrameManager& operator=(const FrameManager& other) = delete;
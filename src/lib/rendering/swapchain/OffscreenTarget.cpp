@@ -0,0 +1,107 @@
+/* OFFSCREEN TARGET.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:03:31
+ * Last edited:
+ *   19/10/2026, 02:29:42
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the OffscreenTarget class, which replaces the Swapchain when
+ *   rendering headless. Instead of presentable images, it allocates its
+ *   own colour images from a MemoryPool, which can be rendered to with
+ *   the same render pass and pipelines and be captured with a
+ *   ReadbackRing.
+**/
+
+#include "tools/Logger.hpp"
+
+#include "OffscreenTarget.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** OFFSCREENTARGET CLASS *****/
+/* Constructor for the OffscreenTarget class, which takes a MemoryManager to allocate the images from, the size of the images and how many images to allocate. */
+OffscreenTarget::OffscreenTarget(Rendering::MemoryManager& memory_manager, const VkExtent2D& extent, uint32_t n_images) :
+    gpu(memory_manager.gpu),
+    memory_manager(memory_manager),
+
+    vk_extent(extent),
+    vk_format(OffscreenTarget::color_format)
+{
+    logger.logc(Verbosity::important, OffscreenTarget::channel, "Initializing ", n_images, " images of ", this->vk_extent.width, 'x', this->vk_extent.height, "...");
+
+    // Allocate the colour images. They're rendered (or upscaled) to and then copied from
+    this->images.reserve(n_images);
+    for (uint32_t i = 0; i < n_images; i++) {
+        this->images.push_back(this->memory_manager.draw_pool.allocate(this->vk_extent, this->vk_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+    }
+
+    logger.logc(Verbosity::important, OffscreenTarget::channel, "Init success.");
+}
+
+/* Move constructor for the OffscreenTarget class. */
+OffscreenTarget::OffscreenTarget(OffscreenTarget&& other) :
+    gpu(other.gpu),
+    memory_manager(other.memory_manager),
+
+    images(std::move(other.images)),
+    vk_extent(other.vk_extent),
+    vk_format(other.vk_format)
+{
+    // Array's move guarantees that it's empty after a move constructor
+}
+
+/* Destructor for the OffscreenTarget class. */
+OffscreenTarget::~OffscreenTarget() {
+    logger.logc(Verbosity::important, OffscreenTarget::channel, "Cleaning...");
+
+    for (uint32_t i = 0; i < this->images.size(); i++) {
+        this->memory_manager.draw_pool.free(this->images[i]);
+    }
+
+    logger.logc(Verbosity::important, OffscreenTarget::channel, "Cleaned.");
+}
+
+
+
+/* Returns a list of frames wrapping the images, bound to the given render pass and the given transient attachments of its RenderGraph. The render pass should leave the colour attachment in OffscreenTarget::final_layout. */
+Tools::Array<Rendering::SwapchainFrame> OffscreenTarget::get_frames(const Rendering::RenderPass& render_pass, const Rendering::GraphAttachments& attachments) const {
+    // Wrap each image in a frame, just like the swapchain does with its images
+    Tools::Array<Rendering::SwapchainFrame> result(this->images.size());
+    for (uint32_t i = 0; i < this->images.size(); i++) {
+        result.push_back(Rendering::SwapchainFrame(
+            this->gpu,
+            render_pass,
+            i,
+            this->images[i]->vulkan(),
+            this->vk_format,
+            this->vk_extent,
+            attachments
+        ));
+    }
+
+    // Return the list
+    return result;
+}
+
+
+
+/* Swap operator for the OffscreenTarget class. */
+void Rendering::swap(OffscreenTarget& ot1, OffscreenTarget& ot2) {
+    #ifndef NDEBUG
+    if (ot1.gpu != ot2.gpu) { logger.fatalc(OffscreenTarget::channel, "Cannot swap offscreen targets with different GPUs."); }
+    if (&ot1.memory_manager != &ot2.memory_manager) { logger.fatalc(OffscreenTarget::channel, "Cannot swap offscreen targets with different memory managers."); }
+    #endif
+
+    using std::swap;
+
+    swap(ot1.images, ot2.images);
+    swap(ot1.vk_extent, ot2.vk_extent);
+    swap(ot1.vk_format, ot2.vk_format);
+}
@@ -0,0 +1,94 @@
+/* OFFSCREEN TARGET.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:03:31
+ * Last edited:
+ *   19/10/2026, 01:31:44
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the OffscreenTarget class, which replaces the Swapchain when
+ *   rendering headless. Instead of presentable images, it allocates its
+ *   own colour images from a MemoryPool, which can be rendered to with
+ *   the same render pass and pipelines and be captured with a
+ *   ReadbackRing.
+**/
+
+#ifndef RENDERING_OFFSCREEN_TARGET_HPP
+#define RENDERING_OFFSCREEN_TARGET_HPP
+
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../memory_manager/MemoryManager.hpp"
+#include "../memory/Image.hpp"
+#include "../renderpass/RenderPass.hpp"
+#include "../rendergraph/GraphAttachments.hpp"
+
+#include "SwapchainFrame.hpp"
+
+namespace Makma3D::Rendering {
+    /* The OffscreenTarget class, which provides images to render to without a window or swapchain. */
+    class OffscreenTarget {
+    public:
+        /* Channel name for the OffscreenTarget class. */
+        static constexpr const char* channel = "OffscreenTarget";
+        /* The format of the colour images. Uses 8-bit RGBA, so the images can be written to disk as-is. */
+        static constexpr const VkFormat color_format = VK_FORMAT_R8G8B8A8_SRGB;
+        /* The layout the colour images should be in at the end of a render pass, so they can be copied to a ReadbackRing. */
+        static constexpr const VkImageLayout final_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+        /* The GPU where the OffscreenTarget lives. */
+        const Rendering::GPU& gpu;
+        /* The MemoryManager whose draw pool holds the images. */
+        Rendering::MemoryManager& memory_manager;
+
+    private:
+        /* The colour images we render to. */
+        Tools::Array<Rendering::Image*> images;
+        /* The size of the images, in pixels. */
+        VkExtent2D vk_extent;
+        /* The format of the images. */
+        VkFormat vk_format;
+
+    public:
+        /* Constructor for the OffscreenTarget class, which takes a MemoryManager to allocate the images from, the size of the images and how many images to allocate. */
+        OffscreenTarget(Rendering::MemoryManager& memory_manager, const VkExtent2D& extent, uint32_t n_images);
+        /* Copy constructor for the OffscreenTarget class, which is deleted. */
+        OffscreenTarget(const OffscreenTarget& other) = delete;
+        /* Move constructor for the OffscreenTarget class. */
+        OffscreenTarget(OffscreenTarget&& other);
+        /* Destructor for the OffscreenTarget class. */
+        ~OffscreenTarget();
+
+        /* Returns a list of frames wrapping the images, bound to the given render pass and the given transient attachments of its RenderGraph. The render pass should leave the colour attachment in OffscreenTarget::final_layout. */
+        Tools::Array<Rendering::SwapchainFrame> get_frames(const Rendering::RenderPass& render_pass, const Rendering::GraphAttachments& attachments) const;
+
+        /* Returns the number of images in the target. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->images.size()); }
+        /* Returns the image with the given index. */
+        inline const Rendering::Image& image(uint32_t index) const { return *this->images[index]; }
+        /* Returns the size of the images, in pixels. */
+        inline const VkExtent2D& extent() const { return this->vk_extent; }
+        /* Returns the format of the images. */
+        inline VkFormat format() const { return this->vk_format; }
+
+        /* Copy assignment operator for the OffscreenTarget class, which is deleted. */
+        OffscreenTarget& operator=(const OffscreenTarget& other) = delete;
+        /* Move assignment operator for the OffscreenTarget class. */
+        inline OffscreenTarget& operator=(OffscreenTarget&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the OffscreenTarget class. */
+        friend void swap(OffscreenTarget& ot1, OffscreenTarget& ot2);
+
+    };
+
+    /* Swap operator for the OffscreenTarget class. */
+    void swap(OffscreenTarget& ot1, OffscreenTarget& ot2);
+
+}
+
+#endif
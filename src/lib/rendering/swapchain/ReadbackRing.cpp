@@ -0,0 +1,342 @@
+/* READBACK RING.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:11:18
+ * Last edited:
+ *   19/10/2026, 03:27:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ReadbackRing class, which captures rendered frames
+ *   without stalling the render loop. A frame's colour attachment is
+ *   copied to one of a ring of host-visible buffers as part of that
+ *   frame's own command buffer, and is only read once its fence has
+ *   signalled. Writing the result to disk as a .png is done on a
+ *   separate worker thread.
+**/
+
+#include <vector>
+#include <cstring>
+
+#include "tools/Logger.hpp"
+#include "tools/Profiler.hpp"
+#include "materials/textures/formats/png/LodePNG.hpp"
+#include "../auxillary/Formats.hpp"
+
+#include "ReadbackRing.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** POPULATE FUNCTIONS *****/
+/* Populates the given barrier that transitions the given image between the given layouts, making the given accesses visible to the given accesses. */
+static void populate_image_barrier(VkImageMemoryBarrier& image_barrier, VkImage vk_image, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access) {
+    // Set to default
+    image_barrier = {};
+    image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+
+    // Set the layouts, and don't transfer ownership
+    image_barrier.oldLayout = old_layout;
+    image_barrier.newLayout = new_layout;
+    image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+    // Set the image and the part of it we copy
+    image_barrier.image = vk_image;
+    image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_barrier.subresourceRange.baseMipLevel = 0;
+    image_barrier.subresourceRange.levelCount = 1;
+    image_barrier.subresourceRange.baseArrayLayer = 0;
+    image_barrier.subresourceRange.layerCount = 1;
+
+    // Set the accesses to wait for
+    image_barrier.srcAccessMask = src_access;
+    image_barrier.dstAccessMask = dst_access;
+}
+
+/* Populates the given barrier that makes the copy to the given buffer visible to the host. */
+static void populate_host_barrier(VkBufferMemoryBarrier& buffer_barrier, VkBuffer vk_buffer) {
+    // Set to default
+    buffer_barrier = {};
+    buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+
+    // Don't transfer ownership
+    buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+    // Set the entire buffer
+    buffer_barrier.buffer = vk_buffer;
+    buffer_barrier.offset = 0;
+    buffer_barrier.size = VK_WHOLE_SIZE;
+
+    // Wait until the copy has written it before the host reads it
+    buffer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    buffer_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+}
+
+/* Populates the given VkBufferImageCopy struct to copy an entire image of the given size. */
+static void populate_copy_region(VkBufferImageCopy& copy_region, const VkExtent2D& vk_extent) {
+    // Set to default
+    copy_region = {};
+
+    // The buffer is tightly packed from its start
+    copy_region.bufferOffset = 0;
+    copy_region.bufferRowLength = 0;
+    copy_region.bufferImageHeight = 0;
+
+    // Copy the colour aspect of the entire image
+    copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy_region.imageSubresource.mipLevel = 0;
+    copy_region.imageSubresource.baseArrayLayer = 0;
+    copy_region.imageSubresource.layerCount = 1;
+    copy_region.imageOffset = { 0, 0, 0 };
+    copy_region.imageExtent = { vk_extent.width, vk_extent.height, 1 };
+}
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns whether the given format stores its colour channels as blue-green-red instead of red-green-blue. */
+static bool is_bgra(VkFormat vk_format) {
+    return vk_format == VK_FORMAT_B8G8R8A8_SRGB || vk_format == VK_FORMAT_B8G8R8A8_UNORM;
+}
+
+
+
+
+
+/***** READBACKRING CLASS *****/
+/* Constructor for the ReadbackRing class, which takes the GPU where it lives, the number of slots in the ring (which should be the number of frames in flight) and the layout the frames' colour attachments are in after the render pass. */
+ReadbackRing::ReadbackRing(const Rendering::GPU& gpu, uint32_t n_slots, VkImageLayout vk_color_layout) :
+    gpu(gpu),
+    vk_color_layout(vk_color_layout),
+    _n_dropped(0),
+    n_writing(0),
+    stopping(false)
+{
+    logger.logc(Verbosity::details, ReadbackRing::channel, "Initializing ring with ", n_slots, " slots...");
+
+    // Prepare the slots. Their buffers are only allocated once they're used, since we don't know the size of the frames yet
+    this->slots.reserve(n_slots);
+    for (uint32_t i = 0; i < n_slots; i++) {
+        this->slots.push_back(Slot{ nullptr, nullptr, nullptr, 0, SlotState::free, 0, { 0, 0 }, VK_FORMAT_UNDEFINED, "" });
+    }
+
+    // Spawn the writer thread
+    this->writer = std::thread(&ReadbackRing::_write_loop, this);
+    logger.set_thread_name(this->writer.get_id(), "png_writer");
+}
+
+/* Destructor for the ReadbackRing class. Writes any captures that are still pending, so the GPU is expected to be idle by then. */
+ReadbackRing::~ReadbackRing() {
+    // Write whatever is still pending
+    this->flush();
+
+    // Stop the writer
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->work_cond.notify_one();
+    logger.unset_thread_name(this->writer.get_id());
+    this->writer.join();
+
+    // Release the buffers
+    for (uint32_t i = 0; i < this->slots.size(); i++) {
+        Slot& slot = this->slots[i];
+        if (slot.buffer != nullptr) {
+            slot.buffer->unmap();
+            slot.pool->free(slot.buffer);
+        }
+        if (slot.pool != nullptr) {
+            delete slot.pool;
+        }
+    }
+}
+
+
+
+/* Private helper function that (re)allocates the buffer of the given slot such that it can hold at least the given number of bytes. The slot must be free. */
+void ReadbackRing::_reserve(Slot& slot, VkDeviceSize n_bytes) {
+    if (slot.capacity >= n_bytes) { return; }
+
+    // Release the old buffer, which no frame uses anymore now the slot is free
+    if (slot.buffer != nullptr) {
+        slot.buffer->unmap();
+        slot.pool->free(slot.buffer);
+        delete slot.pool;
+    }
+
+    // Allocate a new one in its own pool. The memory is coherent, so we don't have to invalidate it before reading
+    logger.logc(Verbosity::debug, ReadbackRing::channel, "Allocating readback buffer of ", n_bytes, " bytes...");
+    slot.pool = new LinearMemoryPool(this->gpu, LinearMemoryPool::required_size(this->gpu, { { n_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT } }), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    slot.buffer = slot.pool->allocate(n_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    slot.capacity = n_bytes;
+
+    // Map it once, for as long as it lives
+    slot.buffer->map(&slot.mapped);
+}
+
+/* Private helper function that forms the main loop of the writer thread. */
+void ReadbackRing::_write_loop() {
+    std::vector<unsigned char> pixels;
+    std::unique_lock<std::mutex> guard(this->lock);
+    while (true) {
+        // Wait until there's something to write or we have to stop
+        this->work_cond.wait(guard, [this]() { return this->stopping || !this->jobs.empty(); });
+        if (this->jobs.empty()) { return; }
+        Slot& slot = this->slots[this->jobs.front()];
+        this->jobs.pop_front();
+        ++this->n_writing;
+        guard.unlock();
+
+        // Copy the pixels out of the slot, swizzling them to RGBA if needed, so it can be re-used while we encode
+        PROFILE_SCOPE("write_png");
+        size_t n_bytes = 4 * (size_t) slot.extent.width * (size_t) slot.extent.height;
+        pixels.resize(n_bytes);
+        std::memcpy(pixels.data(), slot.mapped, n_bytes);
+        if (is_bgra(slot.format)) {
+            for (size_t i = 0; i < n_bytes; i += 4) {
+                std::swap(pixels[i], pixels[i + 2]);
+            }
+        }
+        VkExtent2D extent = slot.extent;
+        std::string path = std::move(slot.path);
+        guard.lock();
+        slot.state = SlotState::free;
+        guard.unlock();
+
+        // Write the pixels to disk
+        unsigned error = lodepng::encode(path, pixels.data(), extent.width, extent.height);
+        if (error) {
+            logger.warningc(ReadbackRing::channel, "Could not write frame to '", path, "': ", lodepng_error_text(error), " (error code ", error, ")");
+        } else {
+            logger.logc(Verbosity::debug, ReadbackRing::channel, "Wrote frame to '", path, "'");
+        }
+
+        // Mark that we're done, and wake anyone flushing us
+        guard.lock();
+        --this->n_writing;
+        this->done_cond.notify_all();
+    }
+}
+
+
+
+/* Records copying the colour attachment of the given frame to the ring in the given command buffer, after its render pass. The frame number is used to pick a slot and to know when the copy is done. Returns false (and records nothing) if that slot is still in use or the format can't be written. */
+bool ReadbackRing::record(uint64_t frame, const Rendering::CommandBuffer* cmd, const Rendering::SwapchainFrame& target, const std::string& path) {
+    // Make sure we can write the format at all
+    if (!ReadbackRing::supports(target.format())) {
+        logger.warningc(ReadbackRing::channel, "Cannot capture frame with format ", vk_format_map[target.format()], "; skipping capture.");
+        ++this->_n_dropped;
+        return false;
+    }
+
+    // Find the slot for this frame. It should have been collected by now, unless the writer is falling behind
+    Slot& slot = this->slots[frame % this->slots.size()];
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+        if (slot.state != SlotState::free) {
+            logger.warningc(ReadbackRing::channel, "Readback slot for frame ", frame, " is still in use; dropping capture of '", path, "'.");
+            ++this->_n_dropped;
+            return false;
+        }
+    }
+
+    // Make sure it's large enough for the frame
+    this->_reserve(slot, 4 * (VkDeviceSize) target.extent().width * (VkDeviceSize) target.extent().height);
+
+    // Wait until the render pass is done writing the image, and move it to a layout we can copy from
+    VkImageMemoryBarrier image_barrier;
+    populate_image_barrier(image_barrier, target.image(), this->vk_color_layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+    // Copy it to the slot's buffer
+    VkBufferImageCopy copy_region;
+    populate_copy_region(copy_region, target.extent());
+    vkCmdCopyImageToBuffer(cmd->vulkan(), target.image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer->vulkan(), 1, &copy_region);
+
+    // Move the image back to the layout it had (e.g., to present it), and make the copy visible to the host
+    VkBufferMemoryBarrier buffer_barrier;
+    populate_host_barrier(buffer_barrier, slot.buffer->vulkan());
+    if (this->vk_color_layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        populate_image_barrier(image_barrier, target.image(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, this->vk_color_layout, VK_ACCESS_TRANSFER_READ_BIT, 0);
+        vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &buffer_barrier, 1, &image_barrier);
+    } else {
+        vkCmdPipelineBarrier(cmd->vulkan(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &buffer_barrier, 0, nullptr);
+    }
+
+    // Remember what's in the slot, so we can write it once the frame has completed
+    slot.frame = frame;
+    slot.extent = target.extent();
+    slot.format = target.format();
+    slot.path = path;
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+        slot.state = SlotState::copying;
+    }
+
+    // Done
+    return true;
+}
+
+/* Hands all copies that are done to the writer thread, given the number of frames that have completed so far. Doesn't touch the captured pixels itself, so it's cheap to call every frame. */
+void ReadbackRing::collect(uint64_t n_completed) {
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    // Hand the slots over in frame order, so the frames are written in the order they were rendered
+    bool found = false;
+    for (uint32_t i = 0; i < this->slots.size(); i++) {
+        // Find the oldest completed copy that we haven't handed over yet
+        uint32_t oldest = this->slots.size();
+        for (uint32_t j = 0; j < this->slots.size(); j++) {
+            const Slot& slot = this->slots[j];
+            if (slot.state == SlotState::copying && slot.frame < n_completed && (oldest == this->slots.size() || slot.frame < this->slots[oldest].frame)) {
+                oldest = j;
+            }
+        }
+        if (oldest == this->slots.size()) { break; }
+
+        // Give it to the writer
+        this->slots[oldest].state = SlotState::encoding;
+        this->jobs.push_back(oldest);
+        found = true;
+    }
+
+    // Wake the writer if we gave it something
+    if (found) {
+        this->work_cond.notify_one();
+    }
+}
+
+/* Hands all recorded copies to the writer thread and waits until they are written. Only call this when the GPU is idle. */
+void ReadbackRing::flush() {
+    // Since the GPU is idle, all copies are done
+    this->collect(UINT64_MAX);
+
+    // Wait until the writer has written them all
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->done_cond.wait(guard, [this]() { return this->jobs.empty() && this->n_writing == 0; });
+}
+
+
+
+/* Returns whether the given image format can be captured. */
+bool ReadbackRing::supports(VkFormat vk_format) {
+    switch (vk_format) {
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+            return true;
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,145 @@
+/* READBACK RING.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:11:18
+ * Last edited:
+ *   19/10/2026, 01:13:36
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ReadbackRing class, which captures rendered frames
+ *   without stalling the render loop. A frame's colour attachment is
+ *   copied to one of a ring of host-visible buffers as part of that
+ *   frame's own command buffer, and is only read once its fence has
+ *   signalled. Writing the result to disk as a .png is done on a
+ *   separate worker thread.
+**/
+
+#ifndef RENDERING_READBACK_RING_HPP
+#define RENDERING_READBACK_RING_HPP
+
+#include <cstdint>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vulkan/vulkan.h>
+
+#include "tools/Array.hpp"
+
+#include "../gpu/GPU.hpp"
+#include "../memory/LinearMemoryPool.hpp"
+#include "../memory/Buffer.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+
+#include "SwapchainFrame.hpp"
+
+namespace Makma3D::Rendering {
+    /* The ReadbackRing class, which copies frames to host memory asynchronously and writes them to disk on a worker thread. */
+    class ReadbackRing {
+    public:
+        /* Channel name for the ReadbackRing class. */
+        static constexpr const char* channel = "ReadbackRing";
+
+        /* The GPU where the ReadbackRing lives. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The states a slot in the ring can be in. */
+        enum class SlotState {
+            /* The slot is not used, and may be used for a new capture. */
+            free,
+            /* A copy to the slot has been recorded, but the frame that does it may still be in flight. */
+            copying,
+            /* The copy is done and the worker thread is reading the slot. */
+            encoding
+        };
+
+        /* Private struct that describes a single buffer in the ring. */
+        struct Slot {
+            /* The pool that holds the buffer. Each slot has its own, since a pool's memory can only be mapped once at a time. */
+            Rendering::LinearMemoryPool* pool;
+            /* The host-visible buffer that the frame is copied to. */
+            Rendering::Buffer* buffer;
+            /* The buffer's memory, which stays mapped for as long as the buffer exists. */
+            void* mapped;
+            /* The number of bytes the buffer can hold. */
+            VkDeviceSize capacity;
+
+            /* The state of the slot. */
+            SlotState state;
+            /* The number of the frame whose copy is in this slot. */
+            uint64_t frame;
+            /* The size of the captured image, in pixels. */
+            VkExtent2D extent;
+            /* The format of the captured image. */
+            VkFormat format;
+            /* The path to write the captured image to. */
+            std::string path;
+        };
+
+        /* The layout that the frames' colour attachments are in after the render pass. */
+        VkImageLayout vk_color_layout;
+        /* The slots in the ring. */
+        Tools::Array<Slot> slots;
+        /* The number of captures dropped because their slot was still in use. */
+        uint64_t _n_dropped;
+
+        /* The thread that writes the captured images to disk. */
+        std::thread writer;
+        /* Lock that guards the slot states and the job queue. */
+        std::mutex lock;
+        /* Condition variable on which the writer waits for new jobs. */
+        std::condition_variable work_cond;
+        /* Condition variable on which flush() waits until the writer is done. */
+        std::condition_variable done_cond;
+        /* The indices of the slots that are ready to be written, in order. */
+        std::deque<uint32_t> jobs;
+        /* The number of slots the writer is busy with right now. */
+        uint32_t n_writing;
+        /* Whether the writer should quit. */
+        bool stopping;
+
+
+        /* Private helper function that (re)allocates the buffer of the given slot such that it can hold at least the given number of bytes. The slot must be free. */
+        void _reserve(Slot& slot, VkDeviceSize n_bytes);
+        /* Private helper function that forms the main loop of the writer thread. */
+        void _write_loop();
+
+    public:
+        /* Constructor for the ReadbackRing class, which takes the GPU where it lives, the number of slots in the ring (which should be the number of frames in flight) and the layout the frames' colour attachments are in after the render pass. */
+        ReadbackRing(const Rendering::GPU& gpu, uint32_t n_slots, VkImageLayout vk_color_layout);
+        /* Copy constructor for the ReadbackRing class, which is deleted. */
+        ReadbackRing(const ReadbackRing& other) = delete;
+        /* Move constructor for the ReadbackRing class, which is deleted since the writer thread refers to the ring it lives in. */
+        ReadbackRing(ReadbackRing&& other) = delete;
+        /* Destructor for the ReadbackRing class. Writes any captures that are still pending, so the GPU is expected to be idle by then. */
+        ~ReadbackRing();
+
+        /* Records copying the colour attachment of the given frame to the ring in the given command buffer, after its render pass. The frame number is used to pick a slot and to know when the copy is done. Returns false (and records nothing) if that slot is still in use or the format can't be written. */
+        bool record(uint64_t frame, const Rendering::CommandBuffer* cmd, const Rendering::SwapchainFrame& target, const std::string& path);
+        /* Hands all copies that are done to the writer thread, given the number of frames that have completed so far. Doesn't touch the captured pixels itself, so it's cheap to call every frame. */
+        void collect(uint64_t n_completed);
+        /* Hands all recorded copies to the writer thread and waits until they are written. Only call this when the GPU is idle. */
+        void flush();
+
+        /* Returns whether the given image format can be captured. */
+        static bool supports(VkFormat vk_format);
+        /* Returns the number of slots in the ring. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->slots.size()); }
+        /* Returns the number of captures dropped so far because their slot was still in use. */
+        inline uint64_t n_dropped() const { return this->_n_dropped; }
+
+        /* Copy assignment operator for the ReadbackRing class, which is deleted. */
+        ReadbackRing& operator=(const ReadbackRing& other) = delete;
+        /* Move assignment operator for the ReadbackRing class, which is deleted. */
+        ReadbackRing& operator=(ReadbackRing&& other) = delete;
+
+    };
+
+}
+
+#endif
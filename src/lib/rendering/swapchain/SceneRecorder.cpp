@@ -0,0 +1,286 @@
+/* SCENE RECORDER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:18:36
+ * Last edited:
+ *   19/10/2026, 03:23:40
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the SceneRecorder class, which records (part of) a scene into
+ *   a secondary command buffer that continues a render pass. Each
+ *   recorder has its own CommandPool, so different recorders can be used
+ *   from different threads at the same time.
+**/
+
+#include "tools/Logger.hpp"
+
+#include "SceneRecorder.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Rendering;
+
+
+/***** BINDCOUNTERS STRUCT *****/
+/* Adds the given counters to these ones. */
+BindCounters& BindCounters::operator+=(const BindCounters& other) {
+    this->pipelines_issued += other.pipelines_issued;
+    this->pipelines_skipped += other.pipelines_skipped;
+    this->descriptor_sets_issued += other.descriptor_sets_issued;
+    this->descriptor_sets_skipped += other.descriptor_sets_skipped;
+    this->vertex_buffers_issued += other.vertex_buffers_issued;
+    this->vertex_buffers_skipped += other.vertex_buffers_skipped;
+    this->index_buffers_issued += other.index_buffers_issued;
+    this->index_buffers_skipped += other.index_buffers_skipped;
+    return *this;
+}
+
+
+
+/***** DRAWCOUNTERS STRUCT *****/
+/* Adds the given counters to these ones. */
+DrawCounters& DrawCounters::operator+=(const DrawCounters& other) {
+    this->draws += other.draws;
+    this->instances += other.instances;
+    this->triangles += other.triangles;
+    return *this;
+}
+
+
+
+
+
+/***** SCENERECORDER CLASS *****/
+/* Constructor for the SceneRecorder class, which takes the GPU to record for. */
+SceneRecorder::SceneRecorder(const Rendering::GPU& gpu) :
+    gpu(gpu),
+    command_pool(this->gpu, this->gpu.queue_info().graphics(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT),
+    _bind_counters({}),
+    _draw_counters({})
+{
+    // Allocate the secondary command buffer
+    this->cmd = this->command_pool.allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    // Make sure no state is considered to be bound yet
+    this->reset_bound_state();
+}
+
+/* Move constructor for the SceneRecorder class. */
+SceneRecorder::SceneRecorder(SceneRecorder&& other) :
+    gpu(other.gpu),
+    command_pool(std::move(other.command_pool)),
+    cmd(other.cmd),
+
+    pipeline(other.pipeline),
+    bound_index_buffer(other.bound_index_buffer),
+    bound_index_offset(other.bound_index_offset),
+    _bind_counters(other._bind_counters),
+    _draw_counters(other._draw_counters)
+{
+    for (uint32_t i = 0; i < SceneRecorder::n_set_slots; i++) {
+        this->bound_sets[i] = other.bound_sets[i];
+    }
+    for (uint32_t i = 0; i < SceneRecorder::n_vertex_bindings; i++) {
+        this->bound_vertex_buffers[i] = other.bound_vertex_buffers[i];
+        this->bound_vertex_offsets[i] = other.bound_vertex_offsets[i];
+    }
+
+    // The buffer now belongs to our pool
+    other.cmd = nullptr;
+}
+
+/* Destructor for the SceneRecorder class. */
+SceneRecorder::~SceneRecorder() {
+    if (this->cmd != nullptr) {
+        this->command_pool.free(this->cmd);
+    }
+}
+
+
+
+/* Private helper function that forgets all bound state, so that the next binds are always issued. */
+void SceneRecorder::reset_bound_state() {
+    this->pipeline = nullptr;
+    for (uint32_t i = 0; i < SceneRecorder::n_set_slots; i++) {
+        this->bound_sets[i] = VK_NULL_HANDLE;
+    }
+    for (uint32_t i = 0; i < SceneRecorder::n_vertex_bindings; i++) {
+        this->bound_vertex_buffers[i] = VK_NULL_HANDLE;
+        this->bound_vertex_offsets[i] = 0;
+    }
+    this->bound_index_buffer = VK_NULL_HANDLE;
+    this->bound_index_offset = 0;
+}
+
+
+
+/* Starts recording as a continuation of the given subpass of the given render pass, and sets the dynamic viewport & scissor to cover the given extent. Since recordings are meant to be re-used, the buffer isn't marked as one-time only. */
+void SceneRecorder::start(VkRenderPass vk_render_pass, uint32_t subpass, const VkExtent2D& vk_extent) {
+    // A new recording starts without any state bound
+    this->reset_bound_state();
+    this->_bind_counters = {};
+    this->_draw_counters = {};
+
+    // Begin the command buffer as a continuation of the render pass
+    this->cmd->begin(vk_render_pass, subpass);
+
+    // Set the viewport & scissor, which secondary command buffers don't inherit from the primary one
+    VkViewport vk_viewport{ 0.0f, 0.0f, (float) vk_extent.width, (float) vk_extent.height, 0.0f, 1.0f };
+    VkRect2D vk_scissor{ { 0, 0 }, vk_extent };
+    vkCmdSetViewport(this->cmd->vulkan(), 0, 1, &vk_viewport);
+    vkCmdSetScissor(this->cmd->vulkan(), 0, 1, &vk_scissor);
+}
+
+/* Binds the given pipeline. Does nothing if the pipeline is already bound. */
+void SceneRecorder::schedule_pipeline(const Rendering::Pipeline* pipeline) {
+    // Skip if it's already bound
+    if (this->pipeline == pipeline) {
+        ++this->_bind_counters.pipelines_skipped;
+        return;
+    }
+
+    // Forget the sets that the new pipeline's layout disturbs. The material pipelines have compatible layouts, so only switching to or from a differently laid out pipeline (like the particles') rebinds them
+    uint32_t n_kept = this->pipeline != nullptr ? pipeline->compatible_sets(*this->pipeline) : 0;
+    for (uint32_t i = n_kept; i < SceneRecorder::n_set_slots; i++) {
+        this->bound_sets[i] = VK_NULL_HANDLE;
+    }
+
+    // Then, set the pipeline internally
+    this->pipeline = pipeline;
+
+    // Bind the pipeline to the command buffer
+    pipeline->bind(this->cmd);
+    ++this->_bind_counters.pipelines_issued;
+}
+
+/* Binds the given descriptor set to the given slot of the bound pipeline. Does nothing if it's already bound there. */
+void SceneRecorder::schedule_set(const Rendering::DescriptorSet* set, uint32_t slot) {
+    #ifndef NDEBUG
+    if (slot >= SceneRecorder::n_set_slots) {
+        logger.fatalc(SceneRecorder::channel, "Descriptor set slot ", slot, " is out of range (only ", SceneRecorder::n_set_slots, " slots are tracked)");
+    }
+    if (this->pipeline == nullptr) {
+        logger.fatalc(SceneRecorder::channel, "Cannot bind descriptor set without a pipeline bound.");
+    }
+    #endif
+
+    // Skip if it's already bound
+    if (this->bound_sets[slot] == set->vulkan()) {
+        ++this->_bind_counters.descriptor_sets_skipped;
+        return;
+    }
+
+    // Otherwise, bind it and remember we did
+    set->schedule(this->cmd, this->pipeline->layout(), slot);
+    this->bound_sets[slot] = set->vulkan();
+    ++this->_bind_counters.descriptor_sets_issued;
+}
+
+/* Pushes the given bytes as the push constants at the given offset (in bytes) for the given shader stages of the bound pipeline. */
+void SceneRecorder::schedule_push_constants(VkShaderStageFlags shader_stages, uint32_t offset, const void* data, uint32_t n_bytes) {
+    #ifndef NDEBUG
+    if (this->pipeline == nullptr) {
+        logger.fatalc(SceneRecorder::channel, "Cannot push constants without a pipeline bound.");
+    }
+    #endif
+
+    // Push constants are cheap enough that we don't bother skipping them
+    this->pipeline->schedule_push_constant(this->cmd, shader_stages, offset, const_cast<void*>(data), n_bytes);
+}
+
+/* Binds the given vertex buffer (at the given offset, in bytes) to the given binding. Does nothing if it's already bound there at that offset. */
+void SceneRecorder::schedule_vertex_buffer(uint32_t binding, const Rendering::Buffer* vertex_buffer, VkDeviceSize offset) {
+    #ifndef NDEBUG
+    if (binding >= SceneRecorder::n_vertex_bindings) {
+        logger.fatalc(SceneRecorder::channel, "Vertex buffer binding ", binding, " is out of range (only ", SceneRecorder::n_vertex_bindings, " bindings are tracked)");
+    }
+    #endif
+
+    // Skip if it's already bound
+    if (this->bound_vertex_buffers[binding] == vertex_buffer->vulkan() && this->bound_vertex_offsets[binding] == offset) {
+        ++this->_bind_counters.vertex_buffers_skipped;
+        return;
+    }
+
+    // Schedule the vertex buffer
+    VkDeviceSize offsets[] = { offset };
+    vkCmdBindVertexBuffers(this->cmd->vulkan(), binding, 1, &vertex_buffer->vulkan(), offsets);
+    this->bound_vertex_buffers[binding] = vertex_buffer->vulkan();
+    this->bound_vertex_offsets[binding] = offset;
+    ++this->_bind_counters.vertex_buffers_issued;
+}
+
+/* Binds the given index buffer (at the given offset, in bytes). Does nothing if it's already bound at that offset. */
+void SceneRecorder::schedule_index_buffer(const Rendering::Buffer* index_buffer, VkDeviceSize offset) {
+    // Skip if it's already bound
+    if (this->bound_index_buffer == index_buffer->vulkan() && this->bound_index_offset == offset) {
+        ++this->_bind_counters.index_buffers_skipped;
+        return;
+    }
+
+    // Schedule the index buffer
+    vkCmdBindIndexBuffer(this->cmd->vulkan(), index_buffer->vulkan(), offset, VK_INDEX_TYPE_UINT32);
+    this->bound_index_buffer = index_buffer->vulkan();
+    this->bound_index_offset = offset;
+    ++this->_bind_counters.index_buffers_issued;
+}
+
+/* Schedules a draw command for the given range of indices in the bound index buffer. The vertex offset is added to each index before it's used to lookup a vertex in the bound vertex buffer. */
+void SceneRecorder::schedule_draw(uint32_t first_index, uint32_t n_indices, int32_t vertex_offset) {
+    // Schedule the draw call for the mesh' range only
+    this->pipeline->schedule_idraw(this->cmd, n_indices, 1, static_cast<uint32_t>(vertex_offset), first_index);
+    ++this->_draw_counters.draws;
+    ++this->_draw_counters.instances;
+    this->_draw_counters.triangles += n_indices / 3;
+}
+
+/* Schedules an indexed draw command that is read from the given buffer at the given offset (in bytes), which draws (at most) the given number of indices. */
+void SceneRecorder::schedule_indirect_draw(const Rendering::Buffer* draws, VkDeviceSize offset, uint32_t n_indices) {
+    // Let the GPU decide whether to draw the mesh at all. We don't know its choice yet, so count the draw as if it happens
+    this->pipeline->schedule_idraw_indirect(this->cmd, draws, offset);
+    ++this->_draw_counters.draws;
+    ++this->_draw_counters.instances;
+    this->_draw_counters.triangles += n_indices / 3;
+}
+
+/* Schedules a non-indexed draw command that is read from the given buffer at the given offset (in bytes), for geometry that only the GPU knows the size of. */
+void SceneRecorder::schedule_indirect_vertex_draw(const Rendering::Buffer* draws, VkDeviceSize offset) {
+    // Since the GPU writes the number of vertices & instances itself, we can only count the draw
+    this->pipeline->schedule_draw_indirect(this->cmd, draws, offset);
+    ++this->_draw_counters.draws;
+}
+
+/* Stops recording. */
+void SceneRecorder::stop() {
+    // Stop the command buffer
+    this->cmd->end();
+
+    // Clear the bound state as well
+    this->reset_bound_state();
+}
+
+
+
+/* Swap operator for the SceneRecorder class. */
+void Rendering::swap(SceneRecorder& sr1, SceneRecorder& sr2) {
+    #ifndef NDEBUG
+    if (&sr1.gpu != &sr2.gpu) { logger.fatalc(SceneRecorder::channel, "Cannot swap scene recorders with different GPUs."); }
+    #endif
+
+    using std::swap;
+
+    swap(sr1.command_pool, sr2.command_pool);
+    swap(sr1.cmd, sr2.cmd);
+
+    swap(sr1.pipeline, sr2.pipeline);
+    swap(sr1.bound_sets, sr2.bound_sets);
+    swap(sr1.bound_vertex_buffers, sr2.bound_vertex_buffers);
+    swap(sr1.bound_vertex_offsets, sr2.bound_vertex_offsets);
+    swap(sr1.bound_index_buffer, sr2.bound_index_buffer);
+    swap(sr1.bound_index_offset, sr2.bound_index_offset);
+    swap(sr1._bind_counters, sr2._bind_counters);
+    swap(sr1._draw_counters, sr2._draw_counters);
+}
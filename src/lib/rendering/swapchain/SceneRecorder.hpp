@@ -0,0 +1,158 @@
+/* SCENE RECORDER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:18:40
+ * Last edited:
+ *   19/10/2026, 03:23:40
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the SceneRecorder class, which records (part of) a scene into
+ *   a secondary command buffer that continues a render pass. Each
+ *   recorder has its own CommandPool, so different recorders can be used
+ *   from different threads at the same time.
+**/
+
+#ifndef RENDERING_SCENE_RECORDER_HPP
+#define RENDERING_SCENE_RECORDER_HPP
+
+#include "../gpu/GPU.hpp"
+#include "../memory/Buffer.hpp"
+#include "../commandbuffers/CommandPool.hpp"
+#include "../commandbuffers/CommandBuffer.hpp"
+#include "../descriptors/DescriptorSet.hpp"
+#include "../pipeline/Pipeline.hpp"
+
+namespace Makma3D::Rendering {
+    /* Counts how many state binds were issued and how many were skipped because the state was already bound. */
+    struct BindCounters {
+        /* The number of pipeline binds issued. */
+        uint32_t pipelines_issued;
+        /* The number of pipeline binds skipped. */
+        uint32_t pipelines_skipped;
+        /* The number of descriptor set binds issued. */
+        uint32_t descriptor_sets_issued;
+        /* The number of descriptor set binds skipped. */
+        uint32_t descriptor_sets_skipped;
+        /* The number of vertex buffer binds issued. */
+        uint32_t vertex_buffers_issued;
+        /* The number of vertex buffer binds skipped. */
+        uint32_t vertex_buffers_skipped;
+        /* The number of index buffer binds issued. */
+        uint32_t index_buffers_issued;
+        /* The number of index buffer binds skipped. */
+        uint32_t index_buffers_skipped;
+
+        /* Adds the given counters to these ones. */
+        BindCounters& operator+=(const BindCounters& other);
+    };
+
+    /* Counts how much was drawn. */
+    struct DrawCounters {
+        /* The number of draw calls issued. */
+        uint32_t draws;
+        /* The number of instances drawn by those calls. */
+        uint32_t instances;
+        /* The number of triangles drawn. */
+        uint64_t triangles;
+
+        /* Adds the given counters to these ones. */
+        DrawCounters& operator+=(const DrawCounters& other);
+    };
+
+
+
+    /* The SceneRecorder class, which records draws into its own secondary command buffer while skipping redundant binds. */
+    class SceneRecorder {
+    public:
+        /* The logger channel name for the SceneRecorder class. */
+        static constexpr const char* channel = "SceneRecorder";
+        /* The number of descriptor set slots we track. */
+        static constexpr const uint32_t n_set_slots = 4;
+        /* The number of vertex buffer bindings we track. */
+        static constexpr const uint32_t n_vertex_bindings = 2;
+
+        /* The GPU on which we record. */
+        const Rendering::GPU& gpu;
+
+    private:
+        /* The command pool that only this recorder allocates from, since pools may not be used by multiple threads at once. */
+        Rendering::CommandPool command_pool;
+        /* The secondary command buffer we record in. */
+        Rendering::CommandBuffer* cmd;
+
+        /* The pipeline currently bound in the command buffer. */
+        const Rendering::Pipeline* pipeline;
+        /* The descriptor sets currently bound to each slot in the command buffer. */
+        VkDescriptorSet bound_sets[n_set_slots];
+        /* The vertex buffers currently bound to each binding in the command buffer. */
+        VkBuffer bound_vertex_buffers[n_vertex_bindings];
+        /* The offsets of the vertex buffers currently bound to each binding in the command buffer. */
+        VkDeviceSize bound_vertex_offsets[n_vertex_bindings];
+        /* The index buffer currently bound in the command buffer. */
+        VkBuffer bound_index_buffer;
+        /* The offset of the index buffer currently bound in the command buffer. */
+        VkDeviceSize bound_index_offset;
+        /* Counts the binds issued and skipped during the last recording. */
+        Rendering::BindCounters _bind_counters;
+        /* Counts the draws issued during the last recording. */
+        Rendering::DrawCounters _draw_counters;
+
+        /* Private helper function that forgets all bound state, so that the next binds are always issued. */
+        void reset_bound_state();
+
+    public:
+        /* Constructor for the SceneRecorder class, which takes the GPU to record for. */
+        SceneRecorder(const Rendering::GPU& gpu);
+        /* Copy constructor for the SceneRecorder class, which is deleted. */
+        SceneRecorder(const SceneRecorder& other) = delete;
+        /* Move constructor for the SceneRecorder class. */
+        SceneRecorder(SceneRecorder&& other);
+        /* Destructor for the SceneRecorder class. */
+        ~SceneRecorder();
+
+        /* Starts recording as a continuation of the given subpass of the given render pass, and sets the dynamic viewport & scissor to cover the given extent. Since recordings are meant to be re-used, the buffer isn't marked as one-time only. */
+        void start(VkRenderPass vk_render_pass, uint32_t subpass, const VkExtent2D& vk_extent);
+        /* Binds the given pipeline. Does nothing if the pipeline is already bound. */
+        void schedule_pipeline(const Rendering::Pipeline* pipeline);
+        /* Binds the given descriptor set to the given slot of the bound pipeline. Does nothing if it's already bound there. */
+        void schedule_set(const Rendering::DescriptorSet* set, uint32_t slot);
+        /* Pushes the given bytes as the push constants at the given offset (in bytes) for the given shader stages of the bound pipeline. */
+        void schedule_push_constants(VkShaderStageFlags shader_stages, uint32_t offset, const void* data, uint32_t n_bytes);
+        /* Binds the given vertex buffer (at the given offset, in bytes) to the given binding. Does nothing if it's already bound there at that offset. */
+        void schedule_vertex_buffer(uint32_t binding, const Rendering::Buffer* vertex_buffer, VkDeviceSize offset = 0);
+        /* Binds the given index buffer (at the given offset, in bytes). Does nothing if it's already bound at that offset. */
+        void schedule_index_buffer(const Rendering::Buffer* index_buffer, VkDeviceSize offset = 0);
+        /* Schedules a draw command for the given range of indices in the bound index buffer. The vertex offset is added to each index before it's used to lookup a vertex in the bound vertex buffer. */
+        void schedule_draw(uint32_t first_index, uint32_t n_indices, int32_t vertex_offset);
+        /* Schedules an indexed draw command that is read from the given buffer at the given offset (in bytes), which draws (at most) the given number of indices. */
+        void schedule_indirect_draw(const Rendering::Buffer* draws, VkDeviceSize offset, uint32_t n_indices);
+        /* Schedules a non-indexed draw command that is read from the given buffer at the given offset (in bytes), for geometry that only the GPU knows the size of. */
+        void schedule_indirect_vertex_draw(const Rendering::Buffer* draws, VkDeviceSize offset);
+        /* Stops recording. */
+        void stop();
+
+        /* Returns the command buffer we record in. */
+        inline const Rendering::CommandBuffer* command_buffer() const { return this->cmd; }
+        /* Returns the number of binds issued and skipped during the last recording. */
+        inline const Rendering::BindCounters& bind_counters() const { return this->_bind_counters; }
+        /* Returns the number of draws issued during the last recording. */
+        inline const Rendering::DrawCounters& draw_counters() const { return this->_draw_counters; }
+
+        /* Copy assignment operator for the SceneRecorder class, which is deleted. */
+        SceneRecorder& operator=(const SceneRecorder& other) = delete;
+        /* Move assignment operator for the SceneRecorder class. */
+        inline SceneRecorder& operator=(SceneRecorder&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the SceneRecorder class. */
+        friend void swap(SceneRecorder& sr1, SceneRecorder& sr2);
+
+    };
+
+    /* Swap operator for the SceneRecorder class. */
+    void swap(SceneRecorder& sr1, SceneRecorder& sr2);
+
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   09/05/2021, 18:40:07
  * Last edited:
- *   9/19/2021, 5:51:17 PM
+ *   19/10/2026, 02:29:42
  * Auto updated?
  *   Yes
  *
@@ -19,6 +19,7 @@
 #include "tools/Logger.hpp"
 #include "../auxillary/ErrorCodes.hpp"
 #include "../auxillary/Formats.hpp"
+#include "../auxillary/PresentModes.hpp"
 
 #include "Swapchain.hpp"
 
@@ -44,6 +45,14 @@ static void populate_swapchain_info(VkSwapchainCreateInfoKHR& swapchain_info, Vk
     swapchain_info.imageExtent = surface_extent;
     swapchain_info.imageArrayLayers = 1;
     swapchain_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    // If possible, also allow the images to be copied from, so frames can be captured
+    if (surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+        swapchain_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+    // Likewise, allow them to be copied to, so a scene rendered at a lower resolution can be upscaled to them
+    if (surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+        swapchain_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
 
     // Then, we select the sharing mode of the image. This is always exclusive, since we'll change ownership manually
     swapchain_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -57,7 +66,7 @@ static void populate_swapchain_info(VkSwapchainCreateInfoKHR& swapchain_info, Vk
     swapchain_info.presentMode = surface_present_mode;
     swapchain_info.clipped = VK_TRUE;
 
-    // FInally, set no old swapchain (for now, at least)
+    // Finally, set the swapchain we replace (if any), so it can hand over its resources
     swapchain_info.oldSwapchain = old_swapchain;
 }
 
@@ -83,13 +92,36 @@ static VkSurfaceFormatKHR choose_swapchain_format(const Tools::Array<VkSurfaceFo
     return formats[0];
 }
 
-/* Given a list of supported presentation modes, returns our most desireable one. */
-static VkPresentModeKHR choose_swapchain_present_mode(const Tools::Array<VkPresentModeKHR>& modes) {
-    // Since default, blocking VSYNC mode is guaranteed to exist, we'll pick that
-    VkPresentModeKHR result = VK_PRESENT_MODE_FIFO_KHR;
-    (void) modes;
-    
-    // Done, return
+/* Given a list of supported presentation modes, returns the desired one if it's supported or else the default, blocking VSYNC mode (which is guaranteed to exist). */
+static VkPresentModeKHR choose_swapchain_present_mode(const Tools::Array<VkPresentModeKHR>& modes, VkPresentModeKHR desired_mode) {
+    // Use the desired mode if the surface supports it
+    for (uint32_t i = 0; i < modes.size(); i++) {
+        if (modes[i] == desired_mode) {
+            logger.logc(Verbosity::debug, Swapchain::channel, "Using present mode: ", vk_present_mode_map[desired_mode]);
+            return desired_mode;
+        }
+    }
+
+    // Otherwise, fall back to FIFO
+    logger.warningc(Swapchain::channel, "Present mode ", vk_present_mode_map[desired_mode], " is not supported; falling back to ", vk_present_mode_map[VK_PRESENT_MODE_FIFO_KHR]);
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+/* Given the capabilities of a given surface and the number of images the user asked for, returns the number of images to ask for. An image count of 0 means we choose one more than the minimum, so we never have to wait on the driver before we can render. */
+static uint32_t choose_swapchain_image_count(const VkSurfaceCapabilitiesKHR& capabilities, uint32_t desired_image_count) {
+    // Pick a default if there's no desire
+    uint32_t result = desired_image_count > 0 ? desired_image_count : capabilities.minImageCount + 1;
+
+    // Make sure it's bounded by the min & maximum (where a maximum of 0 means there's none)
+    if (result < capabilities.minImageCount) {
+        logger.warningc(Swapchain::channel, "Swapchain image count ", result, " is below the minimum of ", capabilities.minImageCount, "; using that instead");
+        result = capabilities.minImageCount;
+    } else if (capabilities.maxImageCount > 0 && result > capabilities.maxImageCount) {
+        logger.warningc(Swapchain::channel, "Swapchain image count ", result, " is above the maximum of ", capabilities.maxImageCount, "; using that instead");
+        result = capabilities.maxImageCount;
+    }
+
+    // Done
     return result;
 }
 
@@ -130,8 +162,8 @@ static VkExtent2D choose_swapchain_extent(const VkSurfaceCapabilitiesKHR& capabi
 
 
 /***** SWAPCHAIN CLASS *****/
-/* Constructor for the Swapchain class, which takes the GPU where it will be constructed and the window to which it shall present. */
-Swapchain::Swapchain(const GPU& gpu, GLFWwindow* glfw_window, const Surface& surface) :
+/* Constructor for the Swapchain class, which takes the GPU where it will be constructed, the window to which it shall present, the present mode we'd like to use (falls back to FIFO if unsupported) and the number of images we'd like to have (0 to choose automatically). */
+Swapchain::Swapchain(const GPU& gpu, GLFWwindow* glfw_window, const Surface& surface, VkPresentModeKHR present_mode, uint32_t image_count) :
     gpu(gpu),
     surface(surface)
 {
@@ -143,12 +175,9 @@ Swapchain::Swapchain(const GPU& gpu, GLFWwindow* glfw_window, const Surface& sur
     logger.logc(Verbosity::details, Swapchain::channel, "Preparing Swapchain creation...");
     // Choose the options
     this->vk_surface_format = choose_swapchain_format(this->gpu.swapchain_info().formats());
-    this->vk_surface_present_mode = choose_swapchain_present_mode(this->gpu.swapchain_info().present_modes());
+    this->vk_surface_present_mode = choose_swapchain_present_mode(this->gpu.swapchain_info().present_modes(), present_mode);
     this->vk_surface_extent = choose_swapchain_extent(this->gpu.swapchain_info().capabilities(), glfw_window);
-    this->vk_desired_image_count = this->gpu.swapchain_info().capabilities().minImageCount + 1;
-    if (this->gpu.swapchain_info().capabilities().maxImageCount > 0 && this->vk_desired_image_count > this->gpu.swapchain_info().capabilities().maxImageCount) {
-        this->vk_desired_image_count = this->gpu.swapchain_info().capabilities().maxImageCount;
-    }
+    this->vk_desired_image_count = choose_swapchain_image_count(this->gpu.swapchain_info().capabilities(), image_count);
 
 
 
@@ -249,8 +278,8 @@ Swapchain::~Swapchain() {
 
 
 
-/* Returns a list of SwapchainFrames from the internal images. They will be bound to the given RenderPass and DepthStencil. */
-Tools::Array<Rendering::SwapchainFrame> Swapchain::get_frames(const Rendering::RenderPass& render_pass, const Rendering::DepthStencil& depth_stencil) const {
+/* Returns a list of SwapchainFrames from the internal images. They will be bound to the given RenderPass, together with the given transient attachments of its RenderGraph. */
+Tools::Array<Rendering::SwapchainFrame> Swapchain::get_frames(const Rendering::RenderPass& render_pass, const Rendering::GraphAttachments& attachments) const {
     // Create the list with the initial size
     Tools::Array<Rendering::SwapchainFrame> result(this->vk_actual_image_count);
     for (uint32_t i = 0; i < this->vk_actual_image_count; i++) {
@@ -261,7 +290,7 @@ Tools::Array<Rendering::SwapchainFrame> Swapchain::get_frames(const Rendering::R
             this->vk_swapchain_images[i],
             this->vk_surface_format.format,
             this->vk_surface_extent,
-            depth_stencil.view()
+            attachments
         ));
     }
 
@@ -271,16 +300,16 @@ Tools::Array<Rendering::SwapchainFrame> Swapchain::get_frames(const Rendering::R
 
 
 
-/* Resizes the swapchain. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be invalid. */
-void Swapchain::resize(uint32_t new_width, uint32_t new_height) {
+/* Resizes the swapchain to the given size. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be retired. That old swapchain is returned instead of destroyed so frames in flight can still present to it; destroy it (with vkDestroySwapchainKHR) once they're done. */
+VkSwapchainKHR Swapchain::resize(uint32_t new_width, uint32_t new_height) {
     logger.logc(Verbosity::important, Swapchain::channel, "Re-creating swapchain...");
 
 
 
-    // First, delete old stuff
-    logger.logc(Verbosity::details, Swapchain::channel, "Deallocating old swapchain...");
+    // First, retire the old stuff. The old swapchain is passed to the new one, so the driver can re-use its resources while frames in flight finish with it
+    logger.logc(Verbosity::details, Swapchain::channel, "Retiring old swapchain...");
     this->vk_swapchain_images.clear();
-    vkDestroySwapchainKHR(this->gpu, this->vk_swapchain, nullptr);
+    VkSwapchainKHR vk_old_swapchain = this->vk_swapchain;
 
 
 
@@ -291,7 +320,7 @@ void Swapchain::resize(uint32_t new_width, uint32_t new_height) {
 
     // Populate the create info
     VkSwapchainCreateInfoKHR swapchain_info;
-    populate_swapchain_info(swapchain_info, this->surface, this->gpu.swapchain_info().capabilities(), this->vk_surface_format, this->vk_surface_present_mode, this->vk_surface_extent, this->vk_desired_image_count);
+    populate_swapchain_info(swapchain_info, this->surface, this->gpu.swapchain_info().capabilities(), this->vk_surface_format, this->vk_surface_present_mode, this->vk_surface_extent, this->vk_desired_image_count, vk_old_swapchain);
 
     // Use that to actually create the swapchain
     VkResult vk_result;
@@ -311,14 +340,15 @@ void Swapchain::resize(uint32_t new_width, uint32_t new_height) {
 
 
     logger.logc(Verbosity::important, Swapchain::channel, "Re-creation success.");
+    return vk_old_swapchain;
 }
 
-/* Resizes the swapchain to the size of the given window. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be invalid. */
-void Swapchain::resize(GLFWwindow* glfw_window) {
+/* Resizes the swapchain to the size of the given window. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be retired. That old swapchain is returned instead of destroyed so frames in flight can still present to it; destroy it (with vkDestroySwapchainKHR) once they're done. */
+VkSwapchainKHR Swapchain::resize(GLFWwindow* glfw_window) {
     // Fetch the new size from the window
     VkExtent2D new_extent = choose_swapchain_extent(this->gpu.swapchain_info().capabilities(), glfw_window);
     // Call the other resize to do the actual work
-    this->resize(new_extent.width, new_extent.height);
+    return this->resize(new_extent.width, new_extent.height);
 }
 
 
@@ -4,7 +4,7 @@
  * Created:
  *   09/05/2021, 18:40:10
  * Last edited:
- *   10/09/2021, 10:55:29
+ *   19/10/2026, 01:31:44
  * Auto updated?
  *   Yes
  *
@@ -23,7 +23,7 @@
 #include "../gpu/GPU.hpp"
 #include "../gpu/Surface.hpp"
 #include "../renderpass/RenderPass.hpp"
-#include "../depthtesting/DepthStencil.hpp"
+#include "../rendergraph/GraphAttachments.hpp"
 #include "SwapchainFrame.hpp"
 
 namespace Makma3D::Rendering {
@@ -58,8 +58,8 @@ namespace Makma3D::Rendering {
         Tools::Array<VkImage> vk_swapchain_images;
 
     public:
-        /* Constructor for the Swapchain class, which takes the GPU where it will be constructed and the window to which it shall present. */
-        Swapchain(const GPU& gpu, GLFWwindow* glfw_window, const Surface& surface);
+        /* Constructor for the Swapchain class, which takes the GPU where it will be constructed, the window to which it shall present, the present mode we'd like to use (falls back to FIFO if unsupported) and the number of images we'd like to have (0 to choose automatically). */
+        Swapchain(const GPU& gpu, GLFWwindow* glfw_window, const Surface& surface, VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR, uint32_t image_count = 0);
         /* Copy constructor for the Swapchain class. */
         Swapchain(const Swapchain& other);
         /* Move constructor for the Swapchain class. */
@@ -67,16 +67,20 @@ namespace Makma3D::Rendering {
         /* Destructor for the Swapchain class. */
         ~Swapchain();
 
-        /* Returns a list of SwapchainFrames from the internal images. They will be bound to the given RenderPass and DepthStencil. */
-        Tools::Array<Rendering::SwapchainFrame> get_frames(const Rendering::RenderPass& render_pass, const Rendering::DepthStencil& depth_stencil) const;
+        /* Returns a list of SwapchainFrames from the internal images. They will be bound to the given RenderPass, together with the given transient attachments of its RenderGraph. */
+        Tools::Array<Rendering::SwapchainFrame> get_frames(const Rendering::RenderPass& render_pass, const Rendering::GraphAttachments& attachments) const;
 
-        /* Resizes the swapchain to the given size. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be invalid. */
-        void resize(uint32_t new_width, uint32_t new_height);
-        /* Resizes the swapchain to the size of the given window. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be invalid. */
-        void resize(GLFWwindow* glfw_window);
+        /* Resizes the swapchain to the given size. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be retired. That old swapchain is returned instead of destroyed so frames in flight can still present to it; destroy it (with vkDestroySwapchainKHR) once they're done. */
+        VkSwapchainKHR resize(uint32_t new_width, uint32_t new_height);
+        /* Resizes the swapchain to the size of the given window. Note that this also re-creates it, so any existing handle to the internal VkSwapchain will be retired. That old swapchain is returned instead of destroyed so frames in flight can still present to it; destroy it (with vkDestroySwapchainKHR) once they're done. */
+        VkSwapchainKHR resize(GLFWwindow* glfw_window);
 
         /* Returns the number of images in the swapchain. */
         inline uint32_t size() const { return this->vk_actual_image_count; }
+        /* Returns the number of images we asked for when creating the swapchain. */
+        inline uint32_t desired_size() const { return this->vk_desired_image_count; }
+        /* Returns the present mode used by the swapchain. */
+        inline VkPresentModeKHR present_mode() const { return this->vk_surface_present_mode; }
         /* Returns the actual extent of the swapchain. */
         inline const VkExtent2D& extent() const { return this->vk_surface_extent; }
         /* Returns the format of the swapchain images. */
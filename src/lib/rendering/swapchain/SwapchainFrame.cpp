@@ -4,7 +4,7 @@
  * Created:
  *   08/09/2021, 15:38:52
  * Last edited:
- *   08/09/2021, 15:38:52
+ *   19/10/2026, 02:29:42
  * Auto updated?
  *   Yes
  *
@@ -75,8 +75,8 @@ static void populate_framebuffer_info(VkFramebufferCreateInfo& framebuffer_info,
 
 
 /***** SWAPCHAINFRAME CLASS *****/
-/* Constructor for the SwapchainFrame class, which takes a GPU where it lives, a renderpass to bind to, the index of the swapchain image we wrap, the image itself, its format, its size and a depth-aspect image view originating from a DepthStencil. */
-SwapchainFrame::SwapchainFrame(const Rendering::GPU& gpu, const Rendering::RenderPass& render_pass, uint32_t vk_image_index, const VkImage& vk_image, VkFormat vk_image_format, const VkExtent2D& vk_image_extent, const VkImageView& vk_depth_view) :
+/* Constructor for the SwapchainFrame class, which takes a GPU where it lives, a renderpass to bind to, the index of the swapchain image we wrap, the image itself, its format, its size and the render graph's transient attachments to put in the framebuffer next to it. The framebuffer gets the size of the attachments. */
+SwapchainFrame::SwapchainFrame(const Rendering::GPU& gpu, const Rendering::RenderPass& render_pass, uint32_t vk_image_index, const VkImage& vk_image, VkFormat vk_image_format, const VkExtent2D& vk_image_extent, const Rendering::GraphAttachments& attachments) :
     gpu(gpu),
     render_pass(render_pass),
 
@@ -84,8 +84,7 @@ SwapchainFrame::SwapchainFrame(const Rendering::GPU& gpu, const Rendering::Rende
     vk_image(vk_image),
     vk_format(vk_image_format),
     vk_extent(vk_image_extent),
-
-    vk_depth_view(vk_depth_view),
+    vk_render_extent(attachments.extent()),
 
     in_flight_fence(nullptr)
 {
@@ -100,11 +99,11 @@ SwapchainFrame::SwapchainFrame(const Rendering::GPU& gpu, const Rendering::Rende
         logger.fatalc(SwapchainFrame::channel, "Could not create color-aspect image view: ", vk_error_map[vk_result]);
     }
 
-    // Create the framebuffer
+    // Create the framebuffer, with our image in the place of the graph's imported attachment (if it renders to it directly rather than upscaling to it)
     // logger.logc(Verbosity::details, SwapchainFrame::channel, "Creating framebuffer...");
-    Tools::Array<VkImageView> framebuffer_views = { this->vk_color_view, this->vk_depth_view };
+    Tools::Array<VkImageView> framebuffer_views = attachments.views(this->vk_color_view);
     VkFramebufferCreateInfo framebuffer_info;
-    populate_framebuffer_info(framebuffer_info, this->render_pass.vulkan(), framebuffer_views, this->vk_extent);
+    populate_framebuffer_info(framebuffer_info, this->render_pass.vulkan(), framebuffer_views, this->vk_render_extent);
     if ((vk_result = vkCreateFramebuffer(this->gpu, &framebuffer_info, nullptr, &this->vk_framebuffer)) != VK_SUCCESS) {
         logger.fatalc(SwapchainFrame::channel, "Could not create framebuffer: ", vk_error_map[vk_result]);
     }
@@ -121,9 +120,9 @@ SwapchainFrame::SwapchainFrame(SwapchainFrame&& other) :
     vk_image(other.vk_image),
     vk_format(other.vk_format),
     vk_extent(other.vk_extent),
+    vk_render_extent(other.vk_render_extent),
 
     vk_color_view(other.vk_color_view),
-    vk_depth_view(other.vk_depth_view),
     vk_framebuffer(other.vk_framebuffer),
 
     in_flight_fence(other.in_flight_fence)
@@ -165,9 +164,9 @@ void Rendering::swap(SwapchainFrame& sf1, SwapchainFrame& sf2) {
     swap(sf1.vk_image, sf2.vk_image);
     swap(sf1.vk_format, sf2.vk_format);
     swap(sf1.vk_extent, sf2.vk_extent);
+    swap(sf1.vk_render_extent, sf2.vk_render_extent);
     
     swap(sf1.vk_color_view, sf2.vk_color_view);
-    swap(sf1.vk_depth_view, sf2.vk_depth_view);
     swap(sf1.vk_framebuffer, sf2.vk_framebuffer);
 
     swap(sf1.in_flight_fence, sf2.in_flight_fence);
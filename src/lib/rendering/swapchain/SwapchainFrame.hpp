@@ -4,7 +4,7 @@
  * Created:
  *   08/09/2021, 15:36:31
  * Last edited:
- *   08/09/2021, 15:36:31
+ *   19/10/2026, 02:29:42
  * Auto updated?
  *   Yes
  *
@@ -21,6 +21,7 @@
 
 #include "../gpu/GPU.hpp"
 #include "../renderpass/RenderPass.hpp"
+#include "../rendergraph/GraphAttachments.hpp"
 #include "../synchronization/Fence.hpp"
 
 namespace Makma3D::Rendering {
@@ -44,11 +45,11 @@ namespace Makma3D::Rendering {
         VkFormat vk_format;
         /* The extent of the image. */
         VkExtent2D vk_extent;
+        /* The extent of the framebuffer, i.e., of the graph's attachments. Smaller than that of the image if the scene is rendered at a lower resolution and then upscaled. */
+        VkExtent2D vk_render_extent;
 
         /* The image view for the frame's colour aspect. */
         VkImageView vk_color_view;
-        /* The image view for the frame's depth aspect (is actually provided to us by a DepthStencil). */
-        VkImageView vk_depth_view;
         /* The framebuffer wrapping the image and its various aspects. */
         VkFramebuffer vk_framebuffer;
     
@@ -57,8 +58,8 @@ namespace Makma3D::Rendering {
         Rendering::Fence* in_flight_fence;
 
     public:
-        /* Constructor for the SwapchainFrame class, which takes a GPU where it lives, a renderpass to bind to, the index of the swapchain image we wrap, the image itself, its format, its size and a depth-aspect image view originating from a DepthStencil. */
-        SwapchainFrame(const Rendering::GPU& gpu, const Rendering::RenderPass& render_pass, uint32_t vk_image_index, const VkImage& vk_image, VkFormat vk_image_format, const VkExtent2D& vk_image_extent, const VkImageView& vk_depth_view);
+        /* Constructor for the SwapchainFrame class, which takes a GPU where it lives, a renderpass to bind to, the index of the swapchain image we wrap, the image itself, its format, its size and the render graph's transient attachments to put in the framebuffer next to it. The framebuffer gets the size of the attachments. */
+        SwapchainFrame(const Rendering::GPU& gpu, const Rendering::RenderPass& render_pass, uint32_t vk_image_index, const VkImage& vk_image, VkFormat vk_image_format, const VkExtent2D& vk_image_extent, const Rendering::GraphAttachments& attachments);
         /* Copy constructor for the SwapchainFrame class, which is deleted. */
         SwapchainFrame(const SwapchainFrame& other) = delete;
         /* Move constructor for the SwapchainFrame class. */
@@ -68,10 +69,14 @@ namespace Makma3D::Rendering {
 
         /* Returns the index of the internal image in the swapchain we came from. */
         inline uint32_t index() const { return this->vk_image_index; }
+        /* Returns the internal image. */
+        inline VkImage image() const { return this->vk_image; }
         /* Returns the format of the internal image. */
         inline VkFormat format() const { return this->vk_format; }
         /* Returns the extent of the internal image. */
         inline const VkExtent2D& extent() const { return this->vk_extent; }
+        /* Returns the extent of the framebuffer, which is what the render pass renders at. */
+        inline const VkExtent2D& render_extent() const { return this->vk_render_extent; }
         /* Explicitly returns the internal VkFramebuffer object. */
         inline const VkFramebuffer& framebuffer() const { return this->vk_framebuffer; }
         /* Implicitly returns the internal VkFramebuffer object. */
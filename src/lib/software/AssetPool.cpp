@@ -0,0 +1,357 @@
+/* ASSET POOL.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:24:10
+ * Last edited:
+ *   19/10/2026, 02:24:10
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the AssetPool class, which loads the same models, materials
+ *   and textures as the ModelSystem, MaterialPool & TexturePool, but
+ *   keeps them on the CPU for the software Rasterizer. It doesn't touch
+ *   Vulkan at all, so it works on hosts without a GPU.
+**/
+
+#include <vector>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/hash.hpp"
+
+#include "tools/Common.hpp"
+#include "tools/Logger.hpp"
+#include "materials/textures/formats/png/LodePNG.hpp"
+#include "materials/textures/formats/jpg/jpgd.h"
+#include "models/formats/obj/tiny_obj_loader.h"
+
+#include "AssetPool.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Software;
+
+
+/***** CONSTANTS *****/
+/* The gamma correction to apply to the colours in .mtl files, like the ObjLoader does. */
+static const constexpr float mtl_gamma = 2.2f;
+/* The default vertex colour, like the ObjLoader uses. */
+static const glm::vec3 default_colour(173.0f / 255.0f, 26.0f / 255.0f, 21.0f / 255.0f);
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Converts given string to lowercase. */
+static std::string tolower(const std::string& s) {
+    std::stringstream sstr;
+    for (uint32_t i = 0; i < s.size(); i++) {
+        sstr << (char) tolower((int) s[i]);
+    }
+    return sstr.str();
+}
+
+/* Converts the given colour to a gamma-corrected colour. */
+static inline glm::vec3 correct_for_gamma(const glm::vec3& linear_colour) {
+    return glm::vec3(
+        pow(linear_colour.r, mtl_gamma),
+        pow(linear_colour.g, mtl_gamma),
+        pow(linear_colour.b, mtl_gamma)
+    );
+}
+
+/* Logs each line of the given tinyobjloader error message as a warning. */
+static void log_obj_warnings(const std::string& error) {
+    std::stringstream sstr;
+    for (size_t i = 0; i < error.size(); i++) {
+        if (error[i] == '\n') {
+            logger.warningc(AssetPool::channel, sstr.str());
+            sstr.str("");
+        } else {
+            sstr << error[i];
+        }
+    }
+}
+
+/* Given the parsed .obj data and a vertex/normal/texel index triplet, insert the vertex in the given list and return its index. */
+static uint32_t store_vertex(Tools::Array<Software::Vertex>& vertices, std::unordered_map<glm::uvec3, uint32_t>& vertex_map, const tinyobj::attrib_t& data, int vertex_index, int normal_index, int texel_index) {
+    // Wrap the indices in a vector
+    glm::uvec3 hash_index(static_cast<uint32_t>(vertex_index), static_cast<uint32_t>(normal_index), static_cast<uint32_t>(texel_index));
+
+    // See if we already have this index pair somewhere
+    std::unordered_map<glm::uvec3, uint32_t>::iterator iter = vertex_map.find(hash_index);
+    if (iter != vertex_map.end()) { return (*iter).second; }
+
+    // Otherwise, generate the index & the Vertex
+    uint32_t index = vertices.size();
+    Software::Vertex vertex;
+    vertex.pos = glm::vec3(data.vertices[3 * vertex_index], data.vertices[3 * vertex_index + 1], data.vertices[3 * vertex_index + 2]);
+    vertex.colour = correct_for_gamma(default_colour);
+    vertex.texel = texel_index >= 0 ? glm::vec2(data.texcoords[2 * texel_index], data.texcoords[2 * texel_index + 1]) : glm::vec2(0.0f);
+
+    // Update the list of vertices (resizing more optimally) and the map
+    while (vertices.size() >= vertices.capacity()) { vertices.reserve(2 * vertices.capacity()); }
+    vertices.push_back(vertex);
+    vertex_map.insert({ hash_index, index });
+    return index;
+}
+
+
+
+
+
+/***** ASSETPOOL CLASS *****/
+/* Constructor for the AssetPool class. */
+AssetPool::AssetPool() {
+    // Allocate the default material, which simply uses the vertex colours
+    this->materials.reserve_opt(16);
+    this->_allocate(Materials::MaterialType::simple, "default", glm::vec3(0.0f), nullptr);
+}
+
+/* Move constructor for the AssetPool class. */
+AssetPool::AssetPool(AssetPool&& other) :
+    textures(std::move(other.textures)),
+    materials(std::move(other.materials))
+{
+    other.textures.clear();
+    other.materials.clear();
+}
+
+/* Destructor for the AssetPool class. */
+AssetPool::~AssetPool() {
+    for (uint32_t i = 0; i < this->materials.size(); i++) {
+        delete this->materials[i];
+    }
+    for (const auto& p : this->textures) {
+        delete p.second;
+    }
+}
+
+
+
+/* Private helper function that allocates a new material of the given type. */
+const Software::Material* AssetPool::_allocate(Materials::MaterialType type, const std::string& name, const glm::vec3& colour, const Software::Texture* texture) {
+    // Create the material
+    Software::Material* material = new Software::Material();
+    material->type = type;
+    material->name = name;
+    material->colour = colour;
+    material->texture = texture;
+
+    // Store it so we can clean it up later
+    while (this->materials.size() >= this->materials.capacity()) { this->materials.reserve(2 * this->materials.capacity()); }
+    this->materials.push_back(material);
+    return material;
+}
+
+/* Private helper function that loads the .obj file at the given (full) path into the given model, allocating materials for the ones in its .mtl file. */
+void AssetPool::_load_obj(Software::Model& model, const std::string& path) {
+    // Load the model
+    tinyobj::attrib_t data;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string error;
+    if (tinyobj::LoadObj(&data, &shapes, &materials, &error, path.c_str(), (Tools::merge_paths(Tools::get_executable_path(), "data/materials/")).c_str()) != true) {
+        logger.errorc(AssetPool::channel, "Could not parse input file '", path, "' as .obj file:");
+        log_obj_warnings(error);
+        logger.fatalc(AssetPool::channel, "Cannot continue.");
+    }
+    if (!error.empty()) { log_obj_warnings(error); }
+
+    // Allocate the materials in the .mtl file the same way the ObjLoader does
+    std::unordered_map<int, const Software::Material*> material_map = { { -1, this->default_material() } };
+    for (size_t i = 0; i < materials.size(); i++) {
+        const Software::Material* new_material;
+        if (materials[i].diffuse_texname.empty()) {
+            new_material = this->allocate_simple_coloured(materials[i].name, correct_for_gamma(glm::vec3(materials[i].diffuse[0], materials[i].diffuse[1], materials[i].diffuse[2])));
+        } else {
+            new_material = this->allocate_simple_textured(materials[i].name, materials[i].diffuse_texname);
+        }
+        material_map.insert({ static_cast<int>(i), new_material });
+    }
+
+    // Go through the shapes, splitting each into a mesh per material
+    model.meshes.reserve_opt(16);
+    model.vertices.reserve_opt(16);
+    model.indices.reserve_opt(16);
+    std::unordered_map<glm::uvec3, uint32_t> vertex_map;
+    std::unordered_map<int, Tools::Array<uint32_t>> cpu_index_lists;
+    for (size_t i = 0; i < shapes.size(); i++) {
+        // Sort the indices of the shape by material
+        for (size_t j = 0; j < shapes[i].mesh.indices.size(); j++) {
+            const tinyobj::index_t& obj_indices = shapes[i].mesh.indices[j];
+            uint32_t index = store_vertex(model.vertices, vertex_map, data, obj_indices.vertex_index, obj_indices.normal_index, obj_indices.texcoord_index);
+
+            int material_id = shapes[i].mesh.material_ids[j / 3];
+            std::unordered_map<int, Tools::Array<uint32_t>>::iterator iter = cpu_index_lists.find(material_id);
+            if (iter == cpu_index_lists.end()) {
+                iter = cpu_index_lists.insert({ material_id, Tools::Array<uint32_t>(16) }).first;
+            }
+            while ((*iter).second.size() >= (*iter).second.capacity()) { (*iter).second.reserve(2 * (*iter).second.capacity()); }
+            (*iter).second.push_back(index);
+        }
+
+        // Create a mesh for each of the lists
+        for (const auto& [ material_id, cpu_indices ] : cpu_index_lists) {
+            const Software::Material* material = material_map.at(material_id);
+
+            Software::Mesh mesh{};
+            mesh.name = cpu_index_lists.size() == 1 ? shapes[i].name : shapes[i].name + ' ' + material->name;
+            mesh.material = material;
+            mesh.first_index = model.indices.size();
+            mesh.n_indices = cpu_indices.size();
+            mesh.vertex_offset = 0;
+
+            // Append the indices to the model's list of them
+            while (model.indices.size() + cpu_indices.size() > model.indices.capacity()) { model.indices.reserve(2 * model.indices.capacity()); }
+            memcpy((void*) (model.indices.wdata(model.indices.size() + cpu_indices.size()) + mesh.first_index), (void*) cpu_indices.rdata(), cpu_indices.size() * sizeof(uint32_t));
+
+            while (model.meshes.size() >= model.meshes.capacity()) { model.meshes.reserve(2 * model.meshes.capacity()); }
+            model.meshes.push_back(std::move(mesh));
+        }
+        cpu_index_lists.clear();
+    }
+}
+
+
+
+/* Loads the texture at the given path, relative to the executable, as the given format. If the format is "automatic", deduces it from the file's extension. Textures that were loaded before are returned as-is. */
+const Software::Texture* AssetPool::load_texture(const std::string& path, Materials::TextureFormat format) {
+    // Change the given path to a full path
+    std::string fullpath = Tools::merge_paths(Tools::get_executable_path(), path);
+
+    // Check if we have already seen this path
+    std::unordered_map<std::string, Software::Texture*>::iterator iter = this->textures.find(fullpath);
+    if (iter != this->textures.end()) { return (*iter).second; }
+
+    // Deduce the format if we have to
+    if (format == Materials::TextureFormat::automatic) {
+        std::string lower = tolower(path);
+        if (lower.size() >= 4 && lower.substr(lower.size() - 4) == ".png") {
+            format = Materials::TextureFormat::png;
+        } else if ((lower.size() >= 4 && lower.substr(lower.size() - 4) == ".jpg") || (lower.size() >= 5 && lower.substr(lower.size() - 5) == ".jpeg")) {
+            format = Materials::TextureFormat::jpg;
+        } else {
+            logger.fatalc(AssetPool::channel, "Could not deduce texture format from path '", path, "'");
+        }
+    }
+
+    // Decode the file to RGBA texels
+    Software::Texture* texture = new Software::Texture();
+    texture->name = fullpath;
+    switch (format) {
+        case Materials::TextureFormat::png: {
+            logger.logc(Verbosity::details, AssetPool::channel, "Loading '", fullpath, "' as .png file...");
+            std::vector<unsigned char> image;
+            unsigned width, height;
+            unsigned error = lodepng::decode(image, width, height, fullpath);
+            if (error) {
+                logger.fatalc(AssetPool::channel, "Could not load '", fullpath, "' as .png file: ", lodepng_error_text(error), " (error code ", error, ")");
+            }
+
+            texture->width = static_cast<uint32_t>(width);
+            texture->height = static_cast<uint32_t>(height);
+            texture->texels.reserve(texture->width * texture->height);
+            memcpy((void*) texture->texels.wdata(texture->width * texture->height), (void*) image.data(), 4 * texture->width * texture->height);
+            break;
+        }
+
+        case Materials::TextureFormat::jpg: {
+            logger.logc(Verbosity::details, AssetPool::channel, "Loading '", fullpath, "' as .jpg/.jpeg file...");
+            int width, height, comps;
+            jpgd::jpgd_status status;
+            unsigned char* jpg = jpgd::decompress_jpeg_image_from_file(fullpath.c_str(), &status, &width, &height, &comps, 4);
+            if (jpg == NULL) {
+                logger.fatalc(AssetPool::channel, "Could not load '", fullpath, "' as .jpg file (error code ", status, ")");
+            }
+
+            texture->width = static_cast<uint32_t>(width);
+            texture->height = static_cast<uint32_t>(height);
+            texture->texels.reserve(texture->width * texture->height);
+            memcpy((void*) texture->texels.wdata(texture->width * texture->height), (void*) jpg, 4 * texture->width * texture->height);
+            free(jpg);
+            break;
+        }
+
+        default:
+            logger.fatalc(AssetPool::channel, "Unsupported texture format '", Materials::texture_format_names[(int) format], '\'');
+
+    }
+
+    // Store it and we're done
+    this->textures.insert({ fullpath, texture });
+    return texture;
+}
+
+/* Loads the model at the given path, relative to the executable, as the given format into the given Model. Any materials it uses are allocated in the pool, so the model shouldn't outlive it. */
+void AssetPool::load_model(Software::Model& model, const std::string& path, Models::ModelFormat format) {
+    logger.logc(Verbosity::important, AssetPool::channel, "Loading model '", path, "'...");
+
+    // Create a 'real' path, containing the executable's location as well
+    std::string fullpath = Tools::merge_paths(Tools::get_executable_path(), path);
+
+    // Start from an empty model
+    model.vertices.clear();
+    model.indices.clear();
+    model.meshes.clear();
+
+    // Load it according to the given format, with the same hardcoded geometry as the ModelSystem
+    switch (format) {
+        case Models::ModelFormat::obj:
+            logger.logc(Verbosity::details, AssetPool::channel, "Loading '", fullpath, "' as .obj file...");
+            this->_load_obj(model, fullpath);
+            model.name = fullpath;
+            break;
+
+        case Models::ModelFormat::triangle:
+            logger.logc(Verbosity::details, AssetPool::channel, "Loading static triangle...");
+            model.vertices = {
+                { { 0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f} },
+                { { 0.5f,  0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f} },
+                { {-0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f} }
+            };
+            model.indices = {
+                0, 1, 2
+            };
+            model.meshes.push_back({ 0, model.indices.size(), 0, this->default_material(), "triangle" });
+            model.name = "triangle";
+            break;
+
+        case Models::ModelFormat::square:
+            logger.logc(Verbosity::details, AssetPool::channel, "Loading static square...");
+            model.vertices = {
+                { {-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f} },
+                { { 0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f} },
+                { { 0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f} },
+                { {-0.5f,  0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f} }
+            };
+            model.indices = {
+                0, 1, 2,
+                2, 3, 0
+            };
+            model.meshes.push_back({ 0, model.indices.size(), 0, this->default_material(), "square" });
+            model.name = "square";
+            break;
+
+        default:
+            logger.fatalc(AssetPool::channel, "Unsupported model format '", Models::model_format_names[(int) format], "'");
+
+    }
+
+    logger.logc(Verbosity::details, AssetPool::channel, "Loaded ", model.meshes.size(), " meshes with ", model.vertices.size(), " vertices and ", model.indices.size() / 3, " triangles.");
+}
+
+
+
+/* Swap operator for the AssetPool class. */
+void Software::swap(AssetPool& ap1, AssetPool& ap2) {
+    using std::swap;
+
+    swap(ap1.textures, ap2.textures);
+    swap(ap1.materials, ap2.materials);
+}
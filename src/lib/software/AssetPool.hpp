@@ -0,0 +1,87 @@
+/* ASSET POOL.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:24:10
+ * Last edited:
+ *   19/10/2026, 02:24:10
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the AssetPool class, which loads the same models, materials
+ *   and textures as the ModelSystem, MaterialPool & TexturePool, but
+ *   keeps them on the CPU for the software Rasterizer. It doesn't touch
+ *   Vulkan at all, so it works on hosts without a GPU.
+**/
+
+#ifndef SOFTWARE_ASSET_POOL_HPP
+#define SOFTWARE_ASSET_POOL_HPP
+
+#include <string>
+#include <unordered_map>
+
+#include "glm/glm.hpp"
+#include "tools/Array.hpp"
+#include "materials/textures/TextureFormat.hpp"
+#include "models/ModelFormat.hpp"
+
+#include "Model.hpp"
+
+namespace Makma3D::Software {
+    /* The AssetPool class, which loads and manages the models, materials and textures of the software Rasterizer. */
+    class AssetPool {
+    public:
+        /* Channel name for the AssetPool class. */
+        static constexpr const char* channel = "SoftwareAssetPool";
+
+    private:
+        /* The textures that we loaded, mapped by their full path. */
+        std::unordered_map<std::string, Software::Texture*> textures;
+        /* The materials that we allocated. The first is always the default material. */
+        Tools::Array<Software::Material*> materials;
+
+        /* Private helper function that allocates a new material of the given type. */
+        const Software::Material* _allocate(Materials::MaterialType type, const std::string& name, const glm::vec3& colour, const Software::Texture* texture);
+        /* Private helper function that loads the .obj file at the given (full) path into the given model, allocating materials for the ones in its .mtl file. */
+        void _load_obj(Software::Model& model, const std::string& path);
+
+    public:
+        /* Constructor for the AssetPool class. */
+        AssetPool();
+        /* Copy constructor for the AssetPool class, which is deleted. */
+        AssetPool(const AssetPool& other) = delete;
+        /* Move constructor for the AssetPool class. */
+        AssetPool(AssetPool&& other);
+        /* Destructor for the AssetPool class. */
+        ~AssetPool();
+
+        /* Returns the default material, which is a simple material that uses the vertex colours. */
+        inline const Software::Material* default_material() const { return this->materials[0]; }
+        /* Allocates a new simple material, which uses the vertex colours. */
+        inline const Software::Material* allocate_simple(const std::string& name) { return this->_allocate(Materials::MaterialType::simple, name, glm::vec3(0.0f), nullptr); }
+        /* Allocates a new simple_coloured material with the given name and (linear) colour. */
+        inline const Software::Material* allocate_simple_coloured(const std::string& name, const glm::vec3& colour) { return this->_allocate(Materials::MaterialType::simple_coloured, name, colour, nullptr); }
+        /* Allocates a new simple_textured material with the given name and the texture at the given path, relative to the executable. */
+        inline const Software::Material* allocate_simple_textured(const std::string& name, const std::string& path, Materials::TextureFormat format = Materials::TextureFormat::automatic) { return this->_allocate(Materials::MaterialType::simple_textured, name, glm::vec3(0.0f), this->load_texture(path, format)); }
+
+        /* Loads the texture at the given path, relative to the executable, as the given format. If the format is "automatic", deduces it from the file's extension. Textures that were loaded before are returned as-is. */
+        const Software::Texture* load_texture(const std::string& path, Materials::TextureFormat format = Materials::TextureFormat::automatic);
+        /* Loads the model at the given path, relative to the executable, as the given format into the given Model. Any materials it uses are allocated in the pool, so the model shouldn't outlive it. */
+        void load_model(Software::Model& model, const std::string& path, Models::ModelFormat format);
+
+        /* Copy assignment operator for the AssetPool class, which is deleted. */
+        AssetPool& operator=(const AssetPool& other) = delete;
+        /* Move assignment operator for the AssetPool class. */
+        inline AssetPool& operator=(AssetPool&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the AssetPool class. */
+        friend void swap(AssetPool& ap1, AssetPool& ap2);
+
+    };
+
+    /* Swap operator for the AssetPool class. */
+    void swap(AssetPool& ap1, AssetPool& ap2);
+
+}
+
+#endif
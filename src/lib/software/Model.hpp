@@ -0,0 +1,106 @@
+/* MODEL.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:24:10
+ * Last edited:
+ *   19/10/2026, 02:24:10
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the CPU-side counterparts of the ECS::Model & ECS::Mesh
+ *   components and the materials they use, as rendered by the software
+ *   Rasterizer. They follow the same layout as the GPU ones, except
+ *   that the vertices, indices and texels live in ordinary memory
+ *   instead of in Vulkan buffers & images.
+**/
+
+#ifndef SOFTWARE_MODEL_HPP
+#define SOFTWARE_MODEL_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "glm/glm.hpp"
+#include "tools/Typenames.hpp"
+#include "tools/Array.hpp"
+#include "materials/MaterialType.hpp"
+
+namespace Makma3D::Software {
+    /* A single vertex, with the same attributes as a Rendering::Vertex. */
+    struct Vertex {
+        /* The position of the vertex, in model space. */
+        glm::vec3 pos;
+        /* The (linear) colour of the vertex. */
+        glm::vec3 colour;
+        /* The texel coordinate of the vertex. */
+        glm::vec2 texel;
+    };
+
+    /* A texture that lives on the CPU. */
+    struct Texture {
+        /* The path the texture was loaded from. */
+        std::string name;
+        /* The width of the texture, in texels. */
+        uint32_t width;
+        /* The height of the texture, in texels. */
+        uint32_t height;
+        /* The texels of the texture, row by row, as sRGB-encoded RGBA bytes (red in the lowest byte). */
+        Tools::Array<uint32_t> texels;
+    };
+
+    /* A material that lives on the CPU, which mirrors the GPU's simple, simple_coloured & simple_textured materials. */
+    struct Material {
+        /* The type of the material, which decides which of the other fields are used. */
+        Materials::MaterialType type;
+        /* The name of the material. */
+        std::string name;
+        /* The (linear) colour of a simple_coloured material. */
+        glm::vec3 colour;
+        /* The texture of a simple_textured material. */
+        const Software::Texture* texture;
+    };
+
+    /* A single mesh in a Model, which is rendered with a single material. */
+    struct Mesh {
+        /* The index of the first index of this mesh in the model's list of indices. */
+        uint32_t first_index;
+        /* The number of indices to render. */
+        uint32_t n_indices;
+        /* The offset that is added to each index before it's used to lookup a vertex in the model's list of vertices. */
+        int32_t vertex_offset;
+        /* The material for this mesh. */
+        const Software::Material* material;
+
+        /* Name for this Mesh (only used for debugging). */
+        std::string name;
+    };
+
+    /* A model that lives on the CPU, with all vertices & indices of its meshes. */
+    struct Model {
+        /* The vertices of all meshes in the Model. */
+        Tools::Array<Software::Vertex> vertices;
+        /* The indices of all meshes in the Model, three per triangle. */
+        Tools::Array<uint32_t> indices;
+        /* The list of meshes in the Model. */
+        Tools::Array<Software::Mesh> meshes;
+
+        /* Name for this Model (only used for debugging). */
+        std::string name;
+    };
+
+}
+
+
+
+namespace Tools {
+    /* The string name of the software Vertex struct. */
+    template <> inline constexpr const char* type_name<Makma3D::Software::Vertex>() { return "Software::Vertex"; }
+    /* The string name of the software Mesh struct. */
+    template <> inline constexpr const char* type_name<Makma3D::Software::Mesh>() { return "Software::Mesh"; }
+    /* The string name of the software Model struct. */
+    template <> inline constexpr const char* type_name<Makma3D::Software::Model>() { return "Software::Model"; }
+}
+
+#endif
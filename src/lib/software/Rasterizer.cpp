@@ -0,0 +1,651 @@
+/* RASTERIZER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:24:10
+ * Last edited:
+ *   19/10/2026, 02:24:10
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Rasterizer class, which renders Models on the CPU for
+ *   hosts without a GPU. It works like a tiled GPU: the vertices are
+ *   transformed in parallel, then each thread sets up a slice of the
+ *   triangles and bins them into the 64x64 tiles they touch, after
+ *   which the threads take tiles one by one and rasterize their bins
+ *   with SSE2 edge functions, four pixels at a time. Since every tile
+ *   sees its triangles in submission order, the image is the same
+ *   regardless of the number of threads.
+**/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cmath>
+
+#include "tools/Logger.hpp"
+#include "materials/textures/formats/png/LodePNG.hpp"
+
+// Use SSE2 to rasterize four pixels at a time wherever it's available, which is on any x86-64 CPU
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "Rasterizer.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::Software;
+
+
+/***** CONSTANTS *****/
+/* The colour that the framebuffer is cleared to, which is the same (linear) colour as the RenderSystem clears to. */
+static const glm::vec3 clear_colour(0.749f, 1.0f, 0.992f);
+/* How far outside the screen triangles may reach before they're clipped, as a multiple of the screen's size. Keeps the edge functions precise for triangles that pass close to the camera. */
+static constexpr const float guard_band = 4.0f;
+/* The number of entries in the table that encodes linear colours to sRGB. */
+static constexpr const uint32_t srgb_table_size = 4096;
+
+
+
+
+
+/***** HELPER STRUCTS *****/
+/* A vertex in clip space, with the attributes that are interpolated across its triangles. */
+struct ClipVertex {
+    /* The position of the vertex in clip space. */
+    glm::vec4 pos;
+    /* The (linear) colour of the vertex. */
+    glm::vec3 colour;
+    /* The texel coordinate of the vertex. */
+    glm::vec2 texel;
+};
+
+/* The lookup tables that convert between sRGB and linear colours, like the GPU does when it reads textures and writes to the swapchain. */
+struct SrgbTables {
+    /* Maps each sRGB byte to its linear value. */
+    float to_linear[256];
+    /* Maps linear values (scaled to the size of the table) to sRGB bytes. */
+    uint8_t to_srgb[srgb_table_size];
+
+    /* Constructor for the SrgbTables struct, which fills the tables. */
+    SrgbTables() {
+        for (uint32_t i = 0; i < 256; i++) {
+            float c = (float) i / 255.0f;
+            this->to_linear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (uint32_t i = 0; i < srgb_table_size; i++) {
+            float c = (float) i / (float) (srgb_table_size - 1);
+            float s = c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+            this->to_srgb[i] = static_cast<uint8_t>(s * 255.0f + 0.5f);
+        }
+    }
+};
+
+/* The one set of sRGB tables. */
+static const SrgbTables srgb_tables;
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Appends the given element to the given array, doubling its capacity whenever it runs out. */
+template <class T>
+static inline void push(Tools::Array<T>& array, const T& element) {
+    if (array.size() >= array.capacity()) { array.reserve(array.capacity() > 0 ? 2 * array.capacity() : 16); }
+    array.push_back(element);
+}
+
+/* Returns the index of the last element in the given array that starts at or before the given index, according to the given function. */
+template <class T, class F>
+static inline uint32_t find_range(const Tools::Array<T>& array, uint32_t index, F start) {
+    uint32_t lo = 0, hi = array.size();
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+        if (start(array[mid]) <= index) { lo = mid; }
+        else { hi = mid; }
+    }
+    return lo;
+}
+
+/* Encodes the given linear colour as sRGB RGBA bytes, with red in the lowest byte. */
+static inline uint32_t encode_colour(float r, float g, float b) {
+    uint32_t ir = static_cast<uint32_t>(std::clamp(r, 0.0f, 1.0f) * (float) (srgb_table_size - 1) + 0.5f);
+    uint32_t ig = static_cast<uint32_t>(std::clamp(g, 0.0f, 1.0f) * (float) (srgb_table_size - 1) + 0.5f);
+    uint32_t ib = static_cast<uint32_t>(std::clamp(b, 0.0f, 1.0f) * (float) (srgb_table_size - 1) + 0.5f);
+    return (uint32_t) srgb_tables.to_srgb[ir] | ((uint32_t) srgb_tables.to_srgb[ig] << 8) | ((uint32_t) srgb_tables.to_srgb[ib] << 16) | 0xFF000000;
+}
+
+/* Samples the given texture at the given texel coordinate with bilinear filtering and repeating addressing, like the GPU's sampler does. Returns the linear colour. */
+static inline glm::vec3 sample(const Software::Texture& texture, float u, float v) {
+    // Find the four texels around the coordinate
+    float tu = u * (float) texture.width - 0.5f;
+    float tv = v * (float) texture.height - 0.5f;
+    float fu = floorf(tu), fv = floorf(tv);
+    float wu = tu - fu, wv = tv - fv;
+    int32_t w = static_cast<int32_t>(texture.width), h = static_cast<int32_t>(texture.height);
+    int32_t x0 = ((static_cast<int32_t>(fu) % w) + w) % w, y0 = ((static_cast<int32_t>(fv) % h) + h) % h;
+    int32_t x1 = x0 + 1 < w ? x0 + 1 : 0, y1 = y0 + 1 < h ? y0 + 1 : 0;
+
+    // Decode & blend them in linear space
+    const uint32_t corners[4] = { texture.texels[y0 * w + x0], texture.texels[y0 * w + x1], texture.texels[y1 * w + x0], texture.texels[y1 * w + x1] };
+    const float weights[4] = { (1.0f - wu) * (1.0f - wv), wu * (1.0f - wv), (1.0f - wu) * wv, wu * wv };
+    glm::vec3 result(0.0f);
+    for (uint32_t i = 0; i < 4; i++) {
+        result.r += weights[i] * srgb_tables.to_linear[corners[i] & 0xFF];
+        result.g += weights[i] * srgb_tables.to_linear[(corners[i] >> 8) & 0xFF];
+        result.b += weights[i] * srgb_tables.to_linear[(corners[i] >> 16) & 0xFF];
+    }
+    return result;
+}
+
+/* Computes the plane through the given values at the given screen positions, as x, y & constant coefficients. The inverse of twice the triangle's area is given too, since it's the same for all planes. */
+static inline void compute_plane(const glm::vec3* screen, float f0, float f1, float f2, float inv_area, float* plane) {
+    float dx1 = screen[1].x - screen[0].x, dy1 = screen[1].y - screen[0].y;
+    float dx2 = screen[2].x - screen[0].x, dy2 = screen[2].y - screen[0].y;
+    plane[0] = ((f1 - f0) * dy2 - (f2 - f0) * dy1) * inv_area;
+    plane[1] = ((f2 - f0) * dx1 - (f1 - f0) * dx2) * inv_area;
+    plane[2] = f0 - plane[0] * screen[0].x - plane[1] * screen[0].y;
+}
+
+/* Clips the given polygon against the plane where the dot product with the given vector is zero, keeping the side where it's positive. Returns the new number of corners. */
+static uint32_t clip_polygon(const ClipVertex* in, uint32_t n_in, ClipVertex* out, const glm::vec4& plane) {
+    uint32_t n_out = 0;
+    for (uint32_t i = 0; i < n_in; i++) {
+        const ClipVertex& cur = in[i];
+        const ClipVertex& next = in[(i + 1) % n_in];
+        float d_cur = glm::dot(plane, cur.pos), d_next = glm::dot(plane, next.pos);
+        if (d_cur >= 0.0f) { out[n_out++] = cur; }
+        if ((d_cur >= 0.0f) != (d_next >= 0.0f)) {
+            float t = d_cur / (d_cur - d_next);
+            out[n_out].pos = cur.pos + t * (next.pos - cur.pos);
+            out[n_out].colour = cur.colour + t * (next.colour - cur.colour);
+            out[n_out].texel = cur.texel + t * (next.texel - cur.texel);
+            n_out++;
+        }
+    }
+    return n_out;
+}
+
+/* Sets up the given triangle in clip space for a framebuffer of the given size. Returns false if it's culled, because it faces away from the camera or covers no pixels. */
+static bool setup_triangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, const Software::Material* material, uint32_t width, uint32_t height, RasterTriangle& result) {
+    // Project the corners to the screen
+    const ClipVertex* corners[3] = { &v0, &v1, &v2 };
+    glm::vec3 screen[3];
+    float inv_w[3];
+    for (uint32_t i = 0; i < 3; i++) {
+        inv_w[i] = 1.0f / corners[i]->pos.w;
+        screen[i] = glm::vec3((corners[i]->pos.x * inv_w[i] * 0.5f + 0.5f) * (float) width, (corners[i]->pos.y * inv_w[i] * 0.5f + 0.5f) * (float) height, corners[i]->pos.z * inv_w[i]);
+    }
+
+    // The pipelines cull back faces with counter-clockwise front faces, which in Vulkan's y-down framebuffer means a negative area here
+    float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+    if (!(area < 0.0f)) { return false; }
+
+    // Swap two corners so the edge functions are positive on the inside
+    std::swap(screen[1], screen[2]);
+    std::swap(inv_w[1], inv_w[2]);
+    std::swap(corners[1], corners[2]);
+    area = -area;
+
+    // Compute the bounding box, and skip the triangle if it doesn't cover any pixel centres
+    float min_x = std::min({ screen[0].x, screen[1].x, screen[2].x }), max_x = std::max({ screen[0].x, screen[1].x, screen[2].x });
+    float min_y = std::min({ screen[0].y, screen[1].y, screen[2].y }), max_y = std::max({ screen[0].y, screen[1].y, screen[2].y });
+    result.min_x = static_cast<uint32_t>(std::clamp(floorf(min_x), 0.0f, (float) width));
+    result.max_x = static_cast<uint32_t>(std::clamp(ceilf(max_x), 0.0f, (float) width));
+    result.min_y = static_cast<uint32_t>(std::clamp(floorf(min_y), 0.0f, (float) height));
+    result.max_y = static_cast<uint32_t>(std::clamp(ceilf(max_y), 0.0f, (float) height));
+    if (result.min_x >= result.max_x || result.min_y >= result.max_y) { return false; }
+
+    // Compute the edge functions, each positive on the side of the opposite corner
+    for (uint32_t i = 0; i < 3; i++) {
+        const glm::vec3& p = screen[i];
+        const glm::vec3& q = screen[(i + 1) % 3];
+        result.a[i] = p.y - q.y;
+        result.b[i] = q.x - p.x;
+        result.c[i] = -(result.a[i] * p.x + result.b[i] * p.y);
+    }
+
+    // Compute the planes of the depth and of the attributes divided by w, so they can be interpolated perspective-correctly
+    float inv_area = 1.0f / area;
+    compute_plane(screen, screen[0].z, screen[1].z, screen[2].z, inv_area, result.z);
+    compute_plane(screen, inv_w[0], inv_w[1], inv_w[2], inv_area, result.w);
+    for (uint32_t i = 0; i < 3; i++) {
+        compute_plane(screen, corners[0]->colour[i] * inv_w[0], corners[1]->colour[i] * inv_w[1], corners[2]->colour[i] * inv_w[2], inv_area, result.attr[i]);
+    }
+    for (uint32_t i = 0; i < 2; i++) {
+        compute_plane(screen, corners[0]->texel[i] * inv_w[0], corners[1]->texel[i] * inv_w[1], corners[2]->texel[i] * inv_w[2], inv_area, result.attr[3 + i]);
+    }
+    result.material = material;
+    return true;
+}
+
+/* Returns whether the given triangle may cover any pixel centre in the given rectangle (maxima exclusive), by testing each edge function in the corner where it's largest. */
+static inline bool overlaps(const RasterTriangle& triangle, uint32_t min_x, uint32_t min_y, uint32_t max_x, uint32_t max_y) {
+    for (uint32_t i = 0; i < 3; i++) {
+        float x = triangle.a[i] >= 0.0f ? (float) max_x - 0.5f : (float) min_x + 0.5f;
+        float y = triangle.b[i] >= 0.0f ? (float) max_y - 0.5f : (float) min_y + 0.5f;
+        if (triangle.a[i] * x + triangle.b[i] * y + triangle.c[i] < 0.0f) { return false; }
+    }
+    return true;
+}
+
+/* Shades the covered pixels (according to the given mask) of four pixels in a row of the given triangle, starting at the given pixel, given the w at each of them. */
+static inline void shade(const RasterTriangle& triangle, uint32_t x, uint32_t y, uint32_t mask, const float* w, uint32_t* colour) {
+    float py = (float) y + 0.5f;
+    for (uint32_t lane = 0; lane < 4; lane++) {
+        if (!(mask & (1 << lane))) { continue; }
+        float px = (float) (x + lane) + 0.5f;
+
+        // Shade according to the material, like its shaders do
+        switch (triangle.material->type) {
+            case Materials::MaterialType::simple_coloured:
+                colour[lane] = encode_colour(triangle.material->colour.r, triangle.material->colour.g, triangle.material->colour.b);
+                break;
+
+            case Materials::MaterialType::simple_textured: {
+                float u = (triangle.attr[3][0] * px + triangle.attr[3][1] * py + triangle.attr[3][2]) * w[lane];
+                float v = (triangle.attr[4][0] * px + triangle.attr[4][1] * py + triangle.attr[4][2]) * w[lane];
+                glm::vec3 texel = sample(*triangle.material->texture, u, -v);
+                colour[lane] = encode_colour(texel.r, texel.g, texel.b);
+                break;
+            }
+
+            default: {
+                float r = (triangle.attr[0][0] * px + triangle.attr[0][1] * py + triangle.attr[0][2]) * w[lane];
+                float g = (triangle.attr[1][0] * px + triangle.attr[1][1] * py + triangle.attr[1][2]) * w[lane];
+                float b = (triangle.attr[2][0] * px + triangle.attr[2][1] * py + triangle.attr[2][2]) * w[lane];
+                colour[lane] = encode_colour(r, g, b);
+                break;
+            }
+
+        }
+    }
+}
+
+/* Rasterizes the given triangle in the given rectangle of the framebuffer (maxima exclusive, minimum x a multiple of four), depth-testing against & writing to the given buffers. */
+static void raster_triangle(const RasterTriangle& triangle, uint32_t min_x, uint32_t min_y, uint32_t max_x, uint32_t max_y, uint32_t stride, uint32_t* colour, float* depth) {
+    alignas(16) float w[4];
+    uint32_t shaded[4];
+
+    #ifdef RASTER_SSE2
+    // Load the planes once
+    const __m128 lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 a0 = _mm_set1_ps(triangle.a[0]), a1 = _mm_set1_ps(triangle.a[1]), a2 = _mm_set1_ps(triangle.a[2]);
+    const __m128 z_a = _mm_set1_ps(triangle.z[0]), w_a = _mm_set1_ps(triangle.w[0]);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+
+    for (uint32_t y = min_y; y < max_y; y++) {
+        // Evaluate the y & constant part of all planes once per row
+        float py = (float) y + 0.5f;
+        const __m128 e0_row = _mm_set1_ps(triangle.b[0] * py + triangle.c[0]);
+        const __m128 e1_row = _mm_set1_ps(triangle.b[1] * py + triangle.c[1]);
+        const __m128 e2_row = _mm_set1_ps(triangle.b[2] * py + triangle.c[2]);
+        const __m128 z_row = _mm_set1_ps(triangle.z[1] * py + triangle.z[2]);
+        const __m128 w_row = _mm_set1_ps(triangle.w[1] * py + triangle.w[2]);
+
+        for (uint32_t x = min_x; x < max_x; x += 4) {
+            // Test the four pixel centres against the edges
+            __m128 px = _mm_add_ps(_mm_set1_ps((float) x), lanes);
+            __m128 inside = _mm_and_ps(_mm_and_ps(
+                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), e0_row), zero),
+                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), e1_row), zero)),
+                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), e2_row), zero)
+            );
+            if (_mm_movemask_ps(inside) == 0) { continue; }
+
+            // Depth-test the covered ones, and write the depths that pass
+            float* depth_row = depth + y * stride + x;
+            __m128 z = _mm_add_ps(_mm_mul_ps(z_a, px), z_row);
+            __m128 old_z = _mm_loadu_ps(depth_row);
+            __m128 pass = _mm_and_ps(inside, _mm_and_ps(_mm_cmplt_ps(z, old_z), _mm_cmple_ps(z, one)));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(pass));
+            if (mask == 0) { continue; }
+            _mm_storeu_ps(depth_row, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, old_z)));
+
+            // Find w to undo the perspective of the attributes, then shade
+            _mm_store_ps(w, _mm_div_ps(one, _mm_add_ps(_mm_mul_ps(w_a, px), w_row)));
+            uint32_t* colour_row = colour + y * stride + x;
+            for (uint32_t lane = 0; lane < 4; lane++) { shaded[lane] = colour_row[lane]; }
+            shade(triangle, x, y, mask, w, shaded);
+            for (uint32_t lane = 0; lane < 4; lane++) { colour_row[lane] = shaded[lane]; }
+        }
+    }
+
+    #else
+    for (uint32_t y = min_y; y < max_y; y++) {
+        float py = (float) y + 0.5f;
+        for (uint32_t x = min_x; x < max_x; x += 4) {
+            // Test the four pixels one by one
+            uint32_t mask = 0;
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                float px = (float) (x + lane) + 0.5f;
+                bool inside = true;
+                for (uint32_t i = 0; i < 3; i++) { inside = inside && triangle.a[i] * px + (triangle.b[i] * py + triangle.c[i]) >= 0.0f; }
+                if (!inside) { continue; }
+
+                float& old_z = depth[y * stride + x + lane];
+                float z = triangle.z[0] * px + (triangle.z[1] * py + triangle.z[2]);
+                if (z < old_z && z <= 1.0f) {
+                    old_z = z;
+                    w[lane] = 1.0f / (triangle.w[0] * px + (triangle.w[1] * py + triangle.w[2]));
+                    mask |= 1 << lane;
+                }
+            }
+            if (mask == 0) { continue; }
+
+            // Shade the ones that passed
+            uint32_t* colour_row = colour + y * stride + x;
+            for (uint32_t lane = 0; lane < 4; lane++) { shaded[lane] = colour_row[lane]; }
+            shade(triangle, x, y, mask, w, shaded);
+            for (uint32_t lane = 0; lane < 4; lane++) { colour_row[lane] = shaded[lane]; }
+        }
+    }
+
+    #endif
+}
+
+
+
+
+
+/***** RASTERIZER CLASS *****/
+/* Constructor for the Rasterizer class, which takes the size of the framebuffer in pixels and the number of threads to render with. */
+Rasterizer::Rasterizer(uint32_t width, uint32_t height, uint32_t n_threads) :
+    _width(width),
+    _height(height),
+    stride((width + 3) & ~3u),
+    n_tiles_x((width + Rasterizer::tile_size - 1) / Rasterizer::tile_size),
+    n_tiles_y((height + Rasterizer::tile_size - 1) / Rasterizer::tile_size),
+    pool(n_threads > 1 ? new Tools::ThreadPool(n_threads, "raster") : nullptr),
+    n_threads(n_threads > 1 ? n_threads : 1),
+    view_proj(1.0f),
+    n_vertices(0),
+    n_triangles(0),
+    _stats({})
+{
+    logger.logc(Verbosity::details, Rasterizer::channel, "Initializing with a ", width, "x", height, " framebuffer on ", this->n_threads, " thread(s)...");
+
+    // Allocate the framebuffer, including the padding at the end of each row
+    this->_colour.resize(this->stride * this->_height);
+    this->_depth.resize(this->stride * this->_height);
+
+    // Prepare the per-thread lists of triangles and bins
+    this->triangles.resize(this->n_threads);
+    this->bins.resize(this->n_threads * this->n_tiles_x * this->n_tiles_y);
+
+    logger.logc(Verbosity::details, Rasterizer::channel, "Init success.");
+}
+
+/* Move constructor for the Rasterizer class. */
+Rasterizer::Rasterizer(Rasterizer&& other) :
+    _width(other._width),
+    _height(other._height),
+    stride(other.stride),
+    n_tiles_x(other.n_tiles_x),
+    n_tiles_y(other.n_tiles_y),
+    pool(other.pool),
+    n_threads(other.n_threads),
+    _colour(std::move(other._colour)),
+    _depth(std::move(other._depth)),
+    view_proj(other.view_proj),
+    draws(std::move(other.draws)),
+    batches(std::move(other.batches)),
+    n_vertices(other.n_vertices),
+    n_triangles(other.n_triangles),
+    clip_vertices(std::move(other.clip_vertices)),
+    triangles(std::move(other.triangles)),
+    bins(std::move(other.bins)),
+    _stats(other._stats)
+{
+    other.pool = nullptr;
+}
+
+/* Destructor for the Rasterizer class. */
+Rasterizer::~Rasterizer() {
+    if (this->pool != nullptr) {
+        delete this->pool;
+    }
+}
+
+
+
+/* Private helper function that runs the given job once for each thread we render with, either on the pool or on the calling thread. */
+void Rasterizer::_run(const std::function<void(uint32_t)>& job) {
+    if (this->pool != nullptr) {
+        this->pool->run(this->n_threads, job);
+    } else {
+        job(0);
+    }
+}
+
+/* Private helper function that transforms the given thread's share of the vertices to clip space. */
+void Rasterizer::_transform(uint32_t thread) {
+    // Find which vertices are ours
+    uint32_t first = static_cast<uint32_t>((uint64_t) this->n_vertices * thread / this->n_threads);
+    uint32_t last = static_cast<uint32_t>((uint64_t) this->n_vertices * (thread + 1) / this->n_threads);
+    if (first >= last) { return; }
+
+    // Transform them, moving to the next draw whenever we pass the end of one
+    glm::vec4* clip = this->clip_vertices.wdata();
+    uint32_t d = find_range(this->draws, first, [](const Draw& draw) { return draw.first_vertex; });
+    for (uint32_t v = first; v < last; v++) {
+        while (v >= this->draws[d].first_vertex + this->draws[d].model->vertices.size()) { d++; }
+        const Draw& draw = this->draws[d];
+        clip[v] = draw.model_view_proj * glm::vec4(draw.model->vertices[v - draw.first_vertex].pos, 1.0f);
+    }
+}
+
+/* Private helper function that clips, culls, sets up and bins the given thread's share of the triangles. */
+void Rasterizer::_bin(uint32_t thread) {
+    uint32_t n_tiles = this->n_tiles_x * this->n_tiles_y;
+    Tools::Array<RasterTriangle>& triangles = this->triangles[thread];
+    Tools::Array<uint32_t>* bins = this->bins.wdata() + thread * n_tiles;
+
+    // Empty our lists from the previous frame
+    triangles.clear();
+    for (uint32_t i = 0; i < n_tiles; i++) { bins[i].clear(); }
+
+    // Find which triangles are ours
+    uint32_t first = static_cast<uint32_t>((uint64_t) this->n_triangles * thread / this->n_threads);
+    uint32_t last = static_cast<uint32_t>((uint64_t) this->n_triangles * (thread + 1) / this->n_threads);
+    if (first >= last) { return; }
+
+    // The planes to clip against: the near plane (zero-to-one depth, so z >= 0) and the guard band around the screen
+    static const glm::vec4 planes[5] = {
+        glm::vec4( 0.0f,  0.0f, 1.0f, 0.0f),
+        glm::vec4( 1.0f,  0.0f, 0.0f, guard_band),
+        glm::vec4(-1.0f,  0.0f, 0.0f, guard_band),
+        glm::vec4( 0.0f,  1.0f, 0.0f, guard_band),
+        glm::vec4( 0.0f, -1.0f, 0.0f, guard_band)
+    };
+
+    const glm::vec4* clip = this->clip_vertices.rdata();
+    uint32_t b = find_range(this->batches, first, [](const Batch& batch) { return batch.first_triangle; });
+    for (uint32_t t = first; t < last; t++) {
+        // Find the mesh that this triangle belongs to
+        while (t >= this->batches[b].first_triangle + this->batches[b].mesh->n_indices / 3) { b++; }
+        const Batch& batch = this->batches[b];
+        const Draw& draw = this->draws[batch.draw];
+        const Software::Model& model = *draw.model;
+
+        // Collect its corners
+        ClipVertex polygon[2][3 + 5];
+        uint32_t index = batch.mesh->first_index + 3 * (t - batch.first_triangle);
+        bool inside = true;
+        for (uint32_t i = 0; i < 3; i++) {
+            uint32_t v = static_cast<uint32_t>(static_cast<int32_t>(model.indices[index + i]) + batch.mesh->vertex_offset);
+            polygon[0][i].pos = clip[draw.first_vertex + v];
+            polygon[0][i].colour = model.vertices[v].colour;
+            polygon[0][i].texel = model.vertices[v].texel;
+            for (uint32_t p = 0; p < 5; p++) { inside = inside && glm::dot(planes[p], polygon[0][i].pos) >= 0.0f; }
+        }
+
+        // Clip it if it pokes through any of the planes, which may turn it into a polygon
+        uint32_t n_corners = 3, current = 0;
+        if (!inside) {
+            for (uint32_t p = 0; p < 5 && n_corners >= 3; p++) {
+                n_corners = clip_polygon(polygon[current], n_corners, polygon[1 - current], planes[p]);
+                current = 1 - current;
+            }
+            if (n_corners < 3) { continue; }
+        }
+
+        // Set up & bin each triangle in the (fan of the) polygon
+        for (uint32_t i = 2; i < n_corners; i++) {
+            RasterTriangle triangle;
+            if (!setup_triangle(polygon[current][0], polygon[current][i - 1], polygon[current][i], batch.mesh->material, this->_width, this->_height, triangle)) { continue; }
+
+            // Add it to each tile it overlaps
+            uint32_t triangle_index = triangles.size();
+            push(triangles, triangle);
+            bool multiple = triangle.max_x - triangle.min_x > Rasterizer::tile_size || triangle.max_y - triangle.min_y > Rasterizer::tile_size;
+            for (uint32_t ty = triangle.min_y / Rasterizer::tile_size; ty <= (triangle.max_y - 1) / Rasterizer::tile_size; ty++) {
+                for (uint32_t tx = triangle.min_x / Rasterizer::tile_size; tx <= (triangle.max_x - 1) / Rasterizer::tile_size; tx++) {
+                    // Larger triangles may skip some of the tiles in their bounding box
+                    uint32_t x0 = tx * Rasterizer::tile_size, y0 = ty * Rasterizer::tile_size;
+                    if (multiple && !overlaps(triangle, x0, y0, std::min(x0 + Rasterizer::tile_size, this->_width), std::min(y0 + Rasterizer::tile_size, this->_height))) { continue; }
+                    push(bins[ty * this->n_tiles_x + tx], triangle_index);
+                }
+            }
+        }
+    }
+}
+
+/* Private helper function that rasterizes all triangles binned to the given tile. */
+void Rasterizer::_raster_tile(uint32_t tile) {
+    // Find the tile's pixels; the last one in each row also owns the padding at the end of the rows
+    uint32_t n_tiles = this->n_tiles_x * this->n_tiles_y;
+    uint32_t x0 = (tile % this->n_tiles_x) * Rasterizer::tile_size, y0 = (tile / this->n_tiles_x) * Rasterizer::tile_size;
+    uint32_t x1 = std::min(x0 + Rasterizer::tile_size, this->stride), y1 = std::min(y0 + Rasterizer::tile_size, this->_height);
+    uint32_t* colour = this->_colour.wdata();
+    float* depth = this->_depth.wdata();
+
+    // Clear the tile first
+    uint32_t clear = encode_colour(clear_colour.r, clear_colour.g, clear_colour.b);
+    for (uint32_t y = y0; y < y1; y++) {
+        std::fill(colour + y * this->stride + x0, colour + y * this->stride + x1, clear);
+        std::fill(depth + y * this->stride + x0, depth + y * this->stride + x1, 1.0f);
+    }
+
+    // Rasterize the bins of each thread in order, so the triangles are drawn in the order they were submitted
+    for (uint32_t thread = 0; thread < this->n_threads; thread++) {
+        const Tools::Array<RasterTriangle>& triangles = this->triangles[thread];
+        const Tools::Array<uint32_t>& bin = this->bins[thread * n_tiles + tile];
+        for (uint32_t i = 0; i < bin.size(); i++) {
+            const RasterTriangle& triangle = triangles[bin[i]];
+            uint32_t min_x = std::max(triangle.min_x, x0) & ~3u, max_x = std::min(triangle.max_x, x1);
+            uint32_t min_y = std::max(triangle.min_y, y0), max_y = std::min(triangle.max_y, y1);
+            raster_triangle(triangle, min_x, min_y, max_x, max_y, this->stride, colour, depth);
+        }
+    }
+}
+
+
+
+/* Starts a new frame as seen through a camera with the given projection & view matrices. The framebuffer is cleared once the frame is rendered, tile by tile. */
+void Rasterizer::begin(const glm::mat4& proj, const glm::mat4& view) {
+    this->view_proj = proj * view;
+    this->draws.clear();
+    this->batches.clear();
+    this->n_vertices = 0;
+    this->n_triangles = 0;
+}
+
+/* Queues the given model to be drawn with the given transformation matrix. The model has to live until end() is called. */
+void Rasterizer::draw(const Software::Model& model, const glm::mat4& transform) {
+    // Queue the model itself
+    uint32_t d = this->draws.size();
+    push(this->draws, Draw{ &model, this->view_proj * transform, this->n_vertices });
+    this->n_vertices += model.vertices.size();
+
+    // Queue its meshes, which tells us where its triangles lie in the global list
+    for (uint32_t i = 0; i < model.meshes.size(); i++) {
+        push(this->batches, Batch{ d, &model.meshes[i], this->n_triangles });
+        this->n_triangles += model.meshes[i].n_indices / 3;
+    }
+}
+
+/* Renders all models queued since begin() to the framebuffer. */
+void Rasterizer::end() {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    // Transform all vertices to clip space
+    this->clip_vertices.reserve_opt(this->n_vertices);
+    this->clip_vertices.wdata(this->n_vertices);
+    if (this->n_vertices > 0) {
+        this->_run([this](uint32_t thread) { this->_transform(thread); });
+    }
+    chrono::steady_clock::time_point transformed = chrono::steady_clock::now();
+
+    // Set up the triangles and bin them to the tiles
+    this->_run([this](uint32_t thread) { this->_bin(thread); });
+    chrono::steady_clock::time_point binned = chrono::steady_clock::now();
+
+    // Rasterize the tiles, with each thread taking the next one until they're all done
+    std::atomic<uint32_t> next_tile(0);
+    uint32_t n_tiles = this->n_tiles_x * this->n_tiles_y;
+    this->_run([this, &next_tile, n_tiles](uint32_t) {
+        uint32_t tile;
+        while ((tile = next_tile.fetch_add(1, std::memory_order_relaxed)) < n_tiles) {
+            this->_raster_tile(tile);
+        }
+    });
+    chrono::steady_clock::time_point rasterized = chrono::steady_clock::now();
+
+    // Update the statistics
+    this->_stats.n_triangles = this->n_triangles;
+    this->_stats.n_binned = 0;
+    for (uint32_t i = 0; i < this->n_threads; i++) { this->_stats.n_binned += this->triangles[i].size(); }
+    this->_stats.transform_time = chrono::duration<float, std::milli>(transformed - start).count();
+    this->_stats.bin_time = chrono::duration<float, std::milli>(binned - transformed).count();
+    this->_stats.raster_time = chrono::duration<float, std::milli>(rasterized - binned).count();
+}
+
+
+
+/* Writes the framebuffer to a .png file at the given path. */
+void Rasterizer::write_png(const std::string& path) const {
+    // Copy the rows without their padding
+    std::vector<unsigned char> image(4 * this->_width * this->_height);
+    for (uint32_t y = 0; y < this->_height; y++) {
+        memcpy((void*) (image.data() + 4 * y * this->_width), (void*) (this->_colour.rdata() + y * this->stride), 4 * this->_width);
+    }
+
+    // Encode it
+    unsigned error = lodepng::encode(path, image, this->_width, this->_height);
+    if (error) {
+        logger.fatalc(Rasterizer::channel, "Could not write framebuffer to '", path, "': ", lodepng_error_text(error), " (error code ", error, ")");
+    }
+}
+
+
+
+/* Swap operator for the Rasterizer class. */
+void Software::swap(Rasterizer& r1, Rasterizer& r2) {
+    using std::swap;
+
+    swap(r1._width, r2._width);
+    swap(r1._height, r2._height);
+    swap(r1.stride, r2.stride);
+    swap(r1.n_tiles_x, r2.n_tiles_x);
+    swap(r1.n_tiles_y, r2.n_tiles_y);
+    swap(r1.pool, r2.pool);
+    swap(r1.n_threads, r2.n_threads);
+    swap(r1._colour, r2._colour);
+    swap(r1._depth, r2._depth);
+    swap(r1.view_proj, r2.view_proj);
+    swap(r1.draws, r2.draws);
+    swap(r1.batches, r2.batches);
+    swap(r1.n_vertices, r2.n_vertices);
+    swap(r1.n_triangles, r2.n_triangles);
+    swap(r1.clip_vertices, r2.clip_vertices);
+    swap(r1.triangles, r2.triangles);
+    swap(r1.bins, r2.bins);
+    swap(r1._stats, r2._stats);
+}
@@ -0,0 +1,195 @@
+/* RASTERIZER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:24:10
+ * Last edited:
+ *   19/10/2026, 02:24:10
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Rasterizer class, which renders Models on the CPU for
+ *   hosts without a GPU. It works like a tiled GPU: the vertices are
+ *   transformed in parallel, then each thread sets up a slice of the
+ *   triangles and bins them into the 64x64 tiles they touch, after
+ *   which the threads take tiles one by one and rasterize their bins
+ *   with SSE2 edge functions, four pixels at a time. Since every tile
+ *   sees its triangles in submission order, the image is the same
+ *   regardless of the number of threads.
+**/
+
+#ifndef SOFTWARE_RASTERIZER_HPP
+#define SOFTWARE_RASTERIZER_HPP
+
+#include <cstdint>
+#include <string>
+#include <functional>
+
+#include "glm/glm.hpp"
+#include "tools/Array.hpp"
+#include "tools/ThreadPool.hpp"
+
+#include "Model.hpp"
+
+namespace Makma3D::Software {
+    /* A triangle that is ready to be rasterized, with all its attributes as planes in screen space. */
+    struct RasterTriangle {
+        /* The coefficients of the three edge functions, where a pixel centre (x, y) is covered if a * x + b * y + c >= 0 for all of them. */
+        float a[3], b[3], c[3];
+        /* The depth plane (x, y and constant coefficient). */
+        float z[3];
+        /* The plane of 1 / w, which is linear in screen space and undoes the perspective of the other attributes. */
+        float w[3];
+        /* The planes of the attributes divided by w: the red, green & blue of the colour and the u & v of the texel. */
+        float attr[5][3];
+        /* The bounding box of the triangle in pixels, clamped to the framebuffer. The maxima are exclusive. */
+        uint32_t min_x, min_y, max_x, max_y;
+        /* The material to shade the triangle with. */
+        const Software::Material* material;
+    };
+
+    /* Statistics about the last frame that the Rasterizer rendered. */
+    struct RasterStats {
+        /* The number of triangles that were drawn. */
+        uint32_t n_triangles;
+        /* The number of triangles that survived clipping & culling and were binned. */
+        uint32_t n_binned;
+        /* The time spent transforming vertices, in milliseconds. */
+        float transform_time;
+        /* The time spent setting up & binning triangles, in milliseconds. */
+        float bin_time;
+        /* The time spent rasterizing the tiles, in milliseconds. */
+        float raster_time;
+    };
+
+
+
+    /* The Rasterizer class, which renders Models to a framebuffer in memory using multiple threads. */
+    class Rasterizer {
+    public:
+        /* Channel name for the Rasterizer class. */
+        static constexpr const char* channel = "SoftwareRasterizer";
+        /* The width & height of a single tile, in pixels. */
+        static constexpr const uint32_t tile_size = 64;
+
+    private:
+        /* A single model that was queued for rendering. */
+        struct Draw {
+            /* The model to draw. */
+            const Software::Model* model;
+            /* The model's transformation matrix, combined with the camera's. */
+            glm::mat4 model_view_proj;
+            /* The index of the model's first vertex in the list of transformed vertices. */
+            uint32_t first_vertex;
+        };
+        /* A single mesh of a queued model, in the global list of triangles. */
+        struct Batch {
+            /* The index of the draw that the mesh belongs to. */
+            uint32_t draw;
+            /* The mesh itself. */
+            const Software::Mesh* mesh;
+            /* The index of the mesh' first triangle in the global list of triangles. */
+            uint32_t first_triangle;
+        };
+
+        /* The width of the framebuffer, in pixels. */
+        uint32_t _width;
+        /* The height of the framebuffer, in pixels. */
+        uint32_t _height;
+        /* The number of pixels between the start of two rows, which is the width rounded up to a whole number of SIMD lanes. */
+        uint32_t stride;
+        /* The number of tiles in each row. */
+        uint32_t n_tiles_x;
+        /* The number of tile rows. */
+        uint32_t n_tiles_y;
+        /* The threads to render with, or nullptr if we render on the calling thread. */
+        Tools::ThreadPool* pool;
+        /* The number of threads we render with. */
+        uint32_t n_threads;
+
+        /* The colour of each pixel, as sRGB-encoded RGBA bytes (red in the lowest byte). */
+        Tools::Array<uint32_t> _colour;
+        /* The depth of each pixel, zero to one. */
+        Tools::Array<float> _depth;
+
+        /* The camera's projection matrix times its view matrix. */
+        glm::mat4 view_proj;
+        /* The models queued since begin(). */
+        Tools::Array<Draw> draws;
+        /* The meshes of the queued models. */
+        Tools::Array<Batch> batches;
+        /* The total number of vertices in the queued models. */
+        uint32_t n_vertices;
+        /* The total number of triangles in the queued models. */
+        uint32_t n_triangles;
+        /* The vertices of all queued models in clip space. */
+        Tools::Array<glm::vec4> clip_vertices;
+        /* The triangles set up by each thread. */
+        Tools::Array<Tools::Array<Software::RasterTriangle>> triangles;
+        /* The bins of each thread, with one per tile, that list which of that thread's triangles touch the tile. */
+        Tools::Array<Tools::Array<uint32_t>> bins;
+        /* The statistics of the last frame. */
+        RasterStats _stats;
+
+        /* Private helper function that runs the given job once for each thread we render with, either on the pool or on the calling thread. */
+        void _run(const std::function<void(uint32_t)>& job);
+        /* Private helper function that transforms the given thread's share of the vertices to clip space. */
+        void _transform(uint32_t thread);
+        /* Private helper function that clips, culls, sets up and bins the given thread's share of the triangles. */
+        void _bin(uint32_t thread);
+        /* Private helper function that rasterizes all triangles binned to the given tile. */
+        void _raster_tile(uint32_t tile);
+
+    public:
+        /* Constructor for the Rasterizer class, which takes the size of the framebuffer in pixels and the number of threads to render with. */
+        Rasterizer(uint32_t width, uint32_t height, uint32_t n_threads);
+        /* Copy constructor for the Rasterizer class, which is deleted. */
+        Rasterizer(const Rasterizer& other) = delete;
+        /* Move constructor for the Rasterizer class. */
+        Rasterizer(Rasterizer&& other);
+        /* Destructor for the Rasterizer class. */
+        ~Rasterizer();
+
+        /* Starts a new frame as seen through a camera with the given projection & view matrices. The framebuffer is cleared once the frame is rendered, tile by tile. */
+        void begin(const glm::mat4& proj, const glm::mat4& view);
+        /* Queues the given model to be drawn with the given transformation matrix. The model has to live until end() is called. */
+        void draw(const Software::Model& model, const glm::mat4& transform);
+        /* Renders all models queued since begin() to the framebuffer. */
+        void end();
+
+        /* Writes the framebuffer to a .png file at the given path. */
+        void write_png(const std::string& path) const;
+
+        /* Returns the colours of the framebuffer, row by row and row_stride() pixels apart, as sRGB-encoded RGBA bytes (red in the lowest byte). */
+        inline const uint32_t* colour() const { return this->_colour.rdata(); }
+        /* Returns the depths of the framebuffer, row by row and row_stride() pixels apart. */
+        inline const float* depth() const { return this->_depth.rdata(); }
+        /* Returns the colour of the given pixel, as sRGB-encoded RGBA bytes (red in the lowest byte). */
+        inline uint32_t pixel(uint32_t x, uint32_t y) const { return this->_colour[y * this->stride + x]; }
+        /* Returns the statistics of the last frame. */
+        inline const RasterStats& stats() const { return this->_stats; }
+        /* Returns the width of the framebuffer, in pixels. */
+        inline uint32_t width() const { return this->_width; }
+        /* Returns the height of the framebuffer, in pixels. */
+        inline uint32_t height() const { return this->_height; }
+        /* Returns the number of pixels between the start of two rows of the framebuffer. */
+        inline uint32_t row_stride() const { return this->stride; }
+        /* Returns the number of threads the Rasterizer renders with. */
+        inline uint32_t threads() const { return this->n_threads; }
+
+        /* Copy assignment operator for the Rasterizer class, which is deleted. */
+        Rasterizer& operator=(const Rasterizer& other) = delete;
+        /* Move assignment operator for the Rasterizer class. */
+        inline Rasterizer& operator=(Rasterizer&& other) { if (this != &other) { swap(*this, other); } return *this; }
+        /* Swap operator for the Rasterizer class. */
+        friend void swap(Rasterizer& r1, Rasterizer& r2);
+
+    };
+
+    /* Swap operator for the Rasterizer class. */
+    void swap(Rasterizer& r1, Rasterizer& r2);
+
+}
+
+#endif
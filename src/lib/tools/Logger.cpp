@@ -4,7 +4,7 @@
  * Created:
  *   25/07/2021, 14:11:06
  * Last edited:
- *   10/09/2021, 11:06:08
+ *   19/10/2026, 01:20:02
  * Auto updated?
  *   Yes
  *
@@ -140,6 +140,19 @@ void Logger::unset_thread_name(const std::thread::id& tid) {
     }
 }
 
+/* Returns the name linked to the given thread ID, or an empty string if it has none. */
+std::string Logger::get_thread_name(const std::thread::id& tid) {
+    // Get a lock
+    std::unique_lock<std::mutex> local_lock(this->lock);
+
+    // Try to find the ID
+    std::unordered_map<std::thread::id, std::string>::const_iterator iter = this->thread_names.find(tid);
+    if (iter != this->thread_names.end()) {
+        return iter->second;
+    }
+    return "";
+}
+
 
 
 /* Sets the output stream for this Logger. */
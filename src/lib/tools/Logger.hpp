@@ -4,7 +4,7 @@
  * Created:
  *   25/07/2021, 14:11:20
  * Last edited:
- *   20/09/2021, 14:04:18
+ *   19/10/2026, 01:20:02
  * Auto updated?
  *   Yes
  *
@@ -120,6 +120,8 @@ namespace Tools {
         inline void unset_thread_name() { return this->unset_thread_name(std::this_thread::get_id()); }
         /* Removes the name mapping for the given thread ID. */
         void unset_thread_name(const std::thread::id& tid);
+        /* Returns the name linked to the given thread ID, or an empty string if it has none. */
+        std::string get_thread_name(const std::thread::id& tid);
 
         /* Sets the output stream for this Logger. */
         void set_output_stream(std::ostream& os);
@@ -0,0 +1,196 @@
+/* PROFILER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:18:32
+ * Last edited:
+ *   19/10/2026, 01:20:02
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Profiler class, which records scoped CPU zones in a
+ *   buffer per thread and can write them as a Chrome trace (.json) that
+ *   may be opened in chrome://tracing or Perfetto. Zones are marked with
+ *   PROFILE_SCOPE(), which compiles to nothing unless PROFILING is
+ *   defined (see the ENABLE_PROFILING CMake option).
+**/
+
+#include <fstream>
+#include <cerrno>
+#include <cstring>
+
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** GLOBALS *****/
+/* Global instance of the Profiler everyone uses. */
+Profiler Tools::profiler;
+/* The buffer of the calling thread in the global Profiler, or nullptr if it didn't record anything yet. */
+static thread_local void* thread_buffer = nullptr;
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Writes the given string to the given stream as a JSON string, quotes included. */
+static void write_json_string(std::ostream& os, const char* str) {
+    os << '"';
+    for (const char* c = str; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') { os << '\\' << *c; }
+        else if ((unsigned char) *c < 0x20) { os << ' '; }
+        else { os << *c; }
+    }
+    os << '"';
+}
+
+/* Writes the given number of nanoseconds to the given stream as microseconds, which is what Chrome traces use. */
+static void write_us(std::ostream& os, uint64_t ns) {
+    uint64_t frac = ns % 1000;
+    os << (ns / 1000) << '.' << (char) ('0' + frac / 100) << (char) ('0' + (frac / 10) % 10) << (char) ('0' + frac % 10);
+}
+
+
+
+
+
+/***** PROFILER CLASS *****/
+/* Default constructor for the Profiler class. */
+Profiler::Profiler() :
+    start_time(std::chrono::steady_clock::now())
+{}
+
+/* Destructor for the Profiler class. */
+Profiler::~Profiler() {
+    for (uint32_t i = 0; i < this->buffers.size(); i++) {
+        Block* block = this->buffers[i]->first;
+        while (block != nullptr) {
+            Block* next = block->next.load(std::memory_order_relaxed);
+            delete block;
+            block = next;
+        }
+        delete this->buffers[i];
+    }
+}
+
+
+
+/* Private helper function that creates a buffer for the calling thread. */
+Profiler::ThreadBuffer* Profiler::_register() {
+    // Prepare the buffer with a single, empty block
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->tid = std::this_thread::get_id();
+    buffer->name = logger.get_thread_name(buffer->tid);
+    buffer->first = new Block();
+    buffer->first->size.store(0, std::memory_order_relaxed);
+    buffer->first->next.store(nullptr, std::memory_order_relaxed);
+    buffer->last = buffer->first;
+    buffer->n_blocks = 1;
+    buffer->n_dropped.store(0, std::memory_order_relaxed);
+
+    // Add it to the list
+    std::unique_lock<std::mutex> local_lock(this->lock);
+    buffer->index = static_cast<uint32_t>(this->buffers.size());
+    this->buffers.push_back(buffer);
+    return buffer;
+}
+
+
+
+/* Records a zone with the given name and times in the calling thread's buffer. Doesn't take any locks, except the first time a thread calls it. */
+void Profiler::record(const char* name, uint64_t start, uint64_t end) {
+    // Get the buffer of this thread, creating it if it doesn't exist yet
+    if (thread_buffer == nullptr) { thread_buffer = this->_register(); }
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(thread_buffer);
+
+    // Move to a new block if the current one is full
+    Block* block = buffer->last;
+    uint32_t size = block->size.load(std::memory_order_relaxed);
+    if (size == Profiler::block_size) {
+        if (buffer->n_blocks == Profiler::max_blocks) {
+            buffer->n_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Link a new block, which readers only see once it's fully initialized
+        Block* new_block = new Block();
+        new_block->size.store(0, std::memory_order_relaxed);
+        new_block->next.store(nullptr, std::memory_order_relaxed);
+        block->next.store(new_block, std::memory_order_release);
+        buffer->last = new_block;
+        ++buffer->n_blocks;
+
+        block = new_block;
+        size = 0;
+    }
+
+    // Write the zone, then publish it
+    block->events[size] = ProfileEvent{ name, start, end };
+    block->size.store(size + 1, std::memory_order_release);
+}
+
+
+
+/* Writes all zones recorded so far as a Chrome trace to the given path. May be called while other threads are still recording. Returns whether it succeeded. */
+bool Profiler::write_trace(const std::string& path) {
+    // Try to open the file
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) {
+        logger.warningc(Profiler::channel, "Could not open trace file '", path, "': ", strerror(errno));
+        return false;
+    }
+
+    // Go through all buffers; we hold the lock only to prevent the list itself from changing
+    std::unique_lock<std::mutex> local_lock(this->lock);
+    uint64_t n_events = 0;
+    uint64_t n_dropped = 0;
+    bool first_event = true;
+    ofs << "{\"traceEvents\":[";
+    for (uint32_t i = 0; i < this->buffers.size(); i++) {
+        const ThreadBuffer* buffer = this->buffers[i];
+
+        // Name the thread, preferring whatever name the logger knows it by now
+        std::string name = logger.get_thread_name(buffer->tid);
+        if (name.empty()) { name = buffer->name; }
+        if (name.empty()) { name = "thread_" + std::to_string(buffer->index); }
+        ofs << (first_event ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->index << ",\"args\":{\"name\":";
+        write_json_string(ofs, name.c_str());
+        ofs << "}}";
+        first_event = false;
+
+        // Write the zones as complete events, only reading up to what the owning thread published
+        const Block* block = buffer->first;
+        while (block != nullptr) {
+            uint32_t size = block->size.load(std::memory_order_acquire);
+            for (uint32_t j = 0; j < size; j++) {
+                const ProfileEvent& event = block->events[j];
+                ofs << ",\n{\"name\":";
+                write_json_string(ofs, event.name);
+                ofs << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->index << ",\"ts\":";
+                write_us(ofs, event.start);
+                ofs << ",\"dur\":";
+                write_us(ofs, event.end - event.start);
+                ofs << '}';
+            }
+            n_events += size;
+            block = block->next.load(std::memory_order_acquire);
+        }
+        n_dropped += buffer->n_dropped.load(std::memory_order_relaxed);
+    }
+    ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    uint32_t n_threads = static_cast<uint32_t>(this->buffers.size());
+    local_lock.unlock();
+
+    // Done
+    ofs.close();
+    logger.logc(Verbosity::important, Profiler::channel, "Wrote ", n_events, " zones of ", n_threads, " threads to '", path, "'");
+    if (n_dropped > 0) {
+        logger.warningc(Profiler::channel, "Dropped ", n_dropped, " zones because their thread's buffer was full.");
+    }
+    return true;
+}
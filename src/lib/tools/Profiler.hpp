@@ -0,0 +1,181 @@
+/* PROFILER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:18:32
+ * Last edited:
+ *   19/10/2026, 01:20:02
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Profiler class, which records scoped CPU zones in a
+ *   buffer per thread and can write them as a Chrome trace (.json) that
+ *   may be opened in chrome://tracing or Perfetto. Zones are marked with
+ *   PROFILE_SCOPE(), which compiles to nothing unless PROFILING is
+ *   defined (see the ENABLE_PROFILING CMake option).
+**/
+
+#ifndef TOOLS_PROFILER_HPP
+#define TOOLS_PROFILER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+#ifdef PROFILING
+/***** MACROS WHEN PROFILING IS ENABLED *****/
+/* Helper macros that paste two tokens together after expanding them. */
+#define PROFILE_CONCAT_(A, B) A ## B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_(A, B)
+
+/* Measures the rest of the current scope as a zone with the given name. The name must be a string literal, or at least live for the remainder of the program. */
+#define PROFILE_SCOPE(NAME) \
+    Tools::ProfileZone PROFILE_CONCAT(_profile_zone_, __LINE__)((NAME))
+/* Measures the rest of the current function as a zone named after it. */
+#define PROFILE_FUNCTION \
+    PROFILE_SCOPE(__func__)
+
+#else
+/***** MACROS WHEN PROFILING IS DISABLED *****/
+/* Measures the rest of the current scope as a zone with the given name. The name must be a string literal, or at least live for the remainder of the program. */
+#define PROFILE_SCOPE(NAME)
+/* Measures the rest of the current function as a zone named after it. */
+#define PROFILE_FUNCTION
+
+#endif
+
+namespace Tools {
+    /* A single zone as recorded by the Profiler. */
+    struct ProfileEvent {
+        /* The name of the zone. */
+        const char* name;
+        /* The time the zone started, in nanoseconds since the start of the Profiler. */
+        uint64_t start;
+        /* The time the zone ended, in nanoseconds since the start of the Profiler. */
+        uint64_t end;
+    };
+
+
+
+    /* The Profiler class, which collects the zones of all threads and writes them as a Chrome trace. */
+    class Profiler {
+    public:
+        /* Channel name for the Profiler class. */
+        static constexpr const char* channel = "Profiler";
+
+        /* Whether the zones are compiled in at all. */
+        #ifdef PROFILING
+        static constexpr const bool enabled = true;
+        #else
+        static constexpr const bool enabled = false;
+        #endif
+        /* The number of zones in a single block of a thread's buffer. */
+        static constexpr const uint32_t block_size = 4096;
+        /* The maximum number of blocks a single thread may fill, after which its zones are dropped. */
+        static constexpr const uint32_t max_blocks = 256;
+
+    private:
+        /* Private struct that holds a fixed number of zones. Only the thread owning it writes to it, and it publishes each zone by bumping the size. */
+        struct Block {
+            /* The zones in the block. */
+            ProfileEvent events[Profiler::block_size];
+            /* The number of zones that have been written. */
+            std::atomic<uint32_t> size;
+            /* The next block in the buffer, or nullptr if this is the last one. */
+            std::atomic<Block*> next;
+        };
+
+        /* Private struct that holds the zones of a single thread as a linked list of blocks, so it never has to move the zones that were already written. */
+        struct ThreadBuffer {
+            /* The ID of the thread that owns the buffer. */
+            std::thread::id tid;
+            /* The name of the thread when it was registered, if any. */
+            std::string name;
+            /* The index of the buffer, which is used as the thread's ID in the trace. */
+            uint32_t index;
+
+            /* The first block in the buffer. */
+            Block* first;
+            /* The block currently written to. Only touched by the owning thread. */
+            Block* last;
+            /* The number of blocks in the buffer. Only touched by the owning thread. */
+            uint32_t n_blocks;
+            /* The number of zones dropped because the buffer was full. */
+            std::atomic<uint64_t> n_dropped;
+        };
+
+        /* The time the Profiler started, which is the zero of all timestamps. */
+        std::chrono::steady_clock::time_point start_time;
+        /* The buffers of all threads that recorded a zone so far. */
+        std::vector<ThreadBuffer*> buffers;
+        /* Lock that guards the list of buffers. Never taken when recording a zone, except the very first one of each thread. */
+        std::mutex lock;
+
+        /* Private helper function that creates a buffer for the calling thread. */
+        ThreadBuffer* _register();
+
+    public:
+        /* Default constructor for the Profiler class. */
+        Profiler();
+        /* Copy constructor for the Profiler class, which is deleted. */
+        Profiler(const Profiler& other) = delete;
+        /* Move constructor for the Profiler class, which is deleted since threads refer to their buffers in it. */
+        Profiler(Profiler&& other) = delete;
+        /* Destructor for the Profiler class. */
+        ~Profiler();
+
+        /* Returns the current time, in nanoseconds since the start of the Profiler. */
+        inline uint64_t now() const { return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start_time).count()); }
+        /* Records a zone with the given name and times in the calling thread's buffer. Doesn't take any locks, except the first time a thread calls it. */
+        void record(const char* name, uint64_t start, uint64_t end);
+
+        /* Writes all zones recorded so far as a Chrome trace to the given path. May be called while other threads are still recording. Returns whether it succeeded. */
+        bool write_trace(const std::string& path);
+
+        /* Copy assignment operator for the Profiler class, which is deleted. */
+        Profiler& operator=(const Profiler& other) = delete;
+        /* Move assignment operator for the Profiler class, which is deleted. */
+        Profiler& operator=(Profiler&& other) = delete;
+
+    };
+
+
+
+    /* Instance of the profiler that is globally available. */
+    extern Profiler profiler;
+
+
+
+    /* The ProfileZone class, which records the time between its construction and destruction as a zone on the global Profiler. Use it through PROFILE_SCOPE() instead of directly. */
+    class ProfileZone {
+    private:
+        /* The name of the zone. */
+        const char* name;
+        /* The time the zone started. */
+        uint64_t start;
+
+    public:
+        /* Constructor for the ProfileZone class, which takes the name of the zone. */
+        inline ProfileZone(const char* name) : name(name), start(profiler.now()) {}
+        /* Copy constructor for the ProfileZone class, which is deleted. */
+        ProfileZone(const ProfileZone& other) = delete;
+        /* Move constructor for the ProfileZone class, which is deleted. */
+        ProfileZone(ProfileZone&& other) = delete;
+        /* Destructor for the ProfileZone class, which records the zone. */
+        inline ~ProfileZone() { profiler.record(this->name, this->start, profiler.now()); }
+
+        /* Copy assignment operator for the ProfileZone class, which is deleted. */
+        ProfileZone& operator=(const ProfileZone& other) = delete;
+        /* Move assignment operator for the ProfileZone class, which is deleted. */
+        ProfileZone& operator=(ProfileZone&& other) = delete;
+
+    };
+
+}
+
+#endif
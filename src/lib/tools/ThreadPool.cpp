@@ -0,0 +1,127 @@
+/* THREAD POOL.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:10:09
+ * Last edited:
+ *   19/10/2026, 01:10:09
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ThreadPool class, which keeps a fixed number of worker
+ *   threads around to which a batch of jobs can be handed. Job i is
+ *   always run on worker i, so workers can safely own per-thread
+ *   resources.
+**/
+
+#include "Logger.hpp"
+
+#include "ThreadPool.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** THREADPOOL CLASS *****/
+/* Constructor for the ThreadPool class, which takes the number of worker threads to spawn and a name for them. */
+ThreadPool::ThreadPool(uint32_t n_threads, const std::string& name) :
+    name(name),
+    job(nullptr),
+    n_jobs(0),
+    n_done(0),
+    batch(0),
+    stopping(false)
+{
+    logger.logc(Verbosity::details, ThreadPool::channel, "Spawning ", n_threads, " worker threads for pool '", this->name, "'...");
+
+    // Spawn the workers, naming them in the logger while at it
+    this->threads.reserve(n_threads);
+    for (uint32_t i = 0; i < n_threads; i++) {
+        this->threads.push_back(std::thread(&ThreadPool::worker, this, i));
+        logger.set_thread_name(this->threads[i].get_id(), this->name + "_" + std::to_string(i));
+    }
+}
+
+/* Destructor for the ThreadPool class. */
+ThreadPool::~ThreadPool() {
+    // Tell the workers to stop
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->work_cond.notify_all();
+
+    // Wait for them to do so
+    for (uint32_t i = 0; i < this->threads.size(); i++) {
+        logger.unset_thread_name(this->threads[i].get_id());
+        this->threads[i].join();
+    }
+}
+
+
+
+/* Private helper function that forms the main loop of each worker thread. */
+void ThreadPool::worker(uint32_t index) {
+    uint64_t last_batch = 0;
+    std::unique_lock<std::mutex> guard(this->lock);
+    while (true) {
+        // Wait until there's a new batch or we have to stop
+        this->work_cond.wait(guard, [this, last_batch]() { return this->stopping || this->batch != last_batch; });
+        if (this->stopping) { return; }
+        last_batch = this->batch;
+
+        // Skip if this batch has no job for us
+        if (index >= this->n_jobs) { continue; }
+
+        // Run our job without holding the lock
+        const std::function<void(uint32_t)>& job = *this->job;
+        guard.unlock();
+        std::exception_ptr error;
+        try {
+            job(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        guard.lock();
+
+        // Mark that we're done, and wake the caller if we're the last one
+        if (error && !this->error) { this->error = error; }
+        if (++this->n_done == this->n_jobs) {
+            this->done_cond.notify_one();
+        }
+    }
+}
+
+
+
+/* Runs the given job for each index in [0, n_jobs), where job i runs on worker i. Blocks until all jobs are done, and rethrows the first exception any of them threw. */
+void ThreadPool::run(uint32_t n_jobs, const std::function<void(uint32_t)>& job) {
+    #ifndef NDEBUG
+    // Make sure there is a worker for each job
+    if (n_jobs > this->threads.size()) {
+        logger.fatalc(ThreadPool::channel, "Cannot run ", n_jobs, " jobs on a pool with only ", this->threads.size(), " threads.");
+    }
+    #endif
+    if (n_jobs == 0) { return; }
+
+    // Hand the batch to the workers
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->job = &job;
+    this->n_jobs = n_jobs;
+    this->n_done = 0;
+    this->error = nullptr;
+    ++this->batch;
+    this->work_cond.notify_all();
+
+    // Wait until they're all done
+    this->done_cond.wait(guard, [this]() { return this->n_done == this->n_jobs; });
+    this->job = nullptr;
+
+    // Pass any errors on to the caller
+    if (this->error) {
+        std::exception_ptr error = this->error;
+        this->error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
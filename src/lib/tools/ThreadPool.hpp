@@ -0,0 +1,91 @@
+/* THREAD POOL.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:10:12
+ * Last edited:
+ *   19/10/2026, 01:10:12
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ThreadPool class, which keeps a fixed number of worker
+ *   threads around to which a batch of jobs can be handed. Job i is
+ *   always run on worker i, so workers can safely own per-thread
+ *   resources.
+**/
+
+#ifndef TOOLS_THREAD_POOL_HPP
+#define TOOLS_THREAD_POOL_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace Tools {
+    /* The ThreadPool class, which runs batches of jobs on a fixed set of worker threads. */
+    class ThreadPool {
+    public:
+        /* Channel name for the ThreadPool class. */
+        static constexpr const char* channel = "ThreadPool";
+
+        /* The name of the pool, which is used to name its threads in the logger. */
+        const std::string name;
+
+    private:
+        /* The worker threads in this pool. */
+        std::vector<std::thread> threads;
+
+        /* Lock that guards all state below. */
+        std::mutex lock;
+        /* Condition variable on which the workers wait for a new batch. */
+        std::condition_variable work_cond;
+        /* Condition variable on which the caller of run() waits for the batch to complete. */
+        std::condition_variable done_cond;
+
+        /* The job to run for the current batch. */
+        const std::function<void(uint32_t)>* job;
+        /* The number of jobs in the current batch. */
+        uint32_t n_jobs;
+        /* The number of jobs in the current batch that have completed. */
+        uint32_t n_done;
+        /* Counts the number of batches started, so the workers know when there's a new one. */
+        uint64_t batch;
+        /* The first exception thrown by a job in the current batch, if any. */
+        std::exception_ptr error;
+        /* Whether the workers should quit. */
+        bool stopping;
+
+        /* Private helper function that forms the main loop of each worker thread. */
+        void worker(uint32_t index);
+
+    public:
+        /* Constructor for the ThreadPool class, which takes the number of worker threads to spawn and a name for them. */
+        ThreadPool(uint32_t n_threads, const std::string& name);
+        /* Copy constructor for the ThreadPool class, which is deleted. */
+        ThreadPool(const ThreadPool& other) = delete;
+        /* Move constructor for the ThreadPool class, which is deleted since the workers refer to the pool they live in. */
+        ThreadPool(ThreadPool&& other) = delete;
+        /* Destructor for the ThreadPool class. */
+        ~ThreadPool();
+
+        /* Runs the given job for each index in [0, n_jobs), where job i runs on worker i. Blocks until all jobs are done, and rethrows the first exception any of them threw. */
+        void run(uint32_t n_jobs, const std::function<void(uint32_t)>& job);
+
+        /* Returns the number of worker threads in the pool. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->threads.size()); }
+
+        /* Copy assignment operator for the ThreadPool class, which is deleted. */
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        /* Move assignment operator for the ThreadPool class, which is deleted. */
+        ThreadPool& operator=(ThreadPool&& other) = delete;
+
+    };
+}
+
+#endif
@@ -4,13 +4,15 @@
  * Created:
  *   02/07/2021, 13:44:58
  * Last edited:
- *   9/8/2021, 3:12:06 PM
+ *   19/10/2026, 01:06:35
  * Auto updated?
  *   Yes
  *
  * Description:
  *   Contains the Window class, which manages the GLFW window and bundles
  *   Vulkan instance, gpu, surface and swapchain together in one place.
+ *   Can also be headless, in which case there is no GLFW window, surface
+ *   or swapchain but only a GPU that renders to offscreen images.
 **/
 
 #include "tools/Logger.hpp"
@@ -21,10 +23,12 @@ using namespace Makma3D;
 
 
 /***** WINDOW CLASS *****/
-/* Constructor for the Window class, which takes the Vulkan instance to create the surface, GPU and swapchain with, the title and the size for the window. */
-Window::Window(const Rendering::Instance& instance, const std::string& title, uint32_t width, uint32_t height) :
+/* Constructor for the Window class, which takes the Vulkan instance to create the surface, GPU and swapchain with, the title and the size for the window. Optionally takes the present mode and the number of images (0 to choose automatically) for the swapchain. */
+Window::Window(const Rendering::Instance& instance, const std::string& title, uint32_t width, uint32_t height, VkPresentModeKHR present_mode, uint32_t image_count) :
     instance(instance),
 
+    is_headless(false),
+
     t(title),
     w(width),
     h(height),
@@ -53,7 +57,37 @@ Window::Window(const Rendering::Instance& instance, const std::string& title, ui
     // Initialize the other classes
     this->rendering_surface = new Rendering::Surface(this->instance, this->glfw_window);
     this->rendering_gpu = new Rendering::GPU(this->instance, *this->rendering_surface, { 1, 1, 1, 1 }, Rendering::device_extensions);
-    this->rendering_swapchain = new Rendering::Swapchain(*this->rendering_gpu, this->glfw_window, *this->rendering_surface);
+    this->rendering_swapchain = new Rendering::Swapchain(*this->rendering_gpu, this->glfw_window, *this->rendering_surface, present_mode, image_count);
+
+    logger.logc(Verbosity::important, Window::channel, "Init success.");
+}
+
+/* Constructor for the Window class, which creates a headless window of the given size. It doesn't need GLFW to be initialized, and only creates a GPU that doesn't have to be able to present. */
+Window::Window(const Rendering::Instance& instance, uint32_t width, uint32_t height) :
+    instance(instance),
+
+    is_headless(true),
+    glfw_window(nullptr),
+    rendering_surface(nullptr),
+    rendering_swapchain(nullptr),
+
+    t("Rasterizer (headless)"),
+    w(width),
+    h(height),
+    rw(width),
+    rh(height),
+
+    old_mouse_pos(0.0f, 0.0f),
+    new_mouse_pos(0.0f, 0.0f),
+    focused(false),
+
+    should_resize(false),
+    should_close(false)
+{
+    logger.logc(Verbosity::important, Window::channel, "Initializing headless ", width, 'x', height, " window...");
+
+    // Only create a GPU, which doesn't need a surface to present to
+    this->rendering_gpu = new Rendering::GPU(this->instance, (const Rendering::Surface*) nullptr, { 1, 1, 1, 1 }, Rendering::headless_device_extensions);
 
     logger.logc(Verbosity::important, Window::channel, "Init success.");
 }
@@ -62,6 +96,8 @@ Window::Window(const Rendering::Instance& instance, const std::string& title, ui
 Window::Window(const Window& other) :
     instance(other.instance),
 
+    is_headless(other.is_headless),
+
     t(other.t),
     w(other.w),
     h(other.h),
@@ -75,6 +111,19 @@ Window::Window(const Window& other) :
 {
     logger.logc(Verbosity::debug, Window::channel, "Copying...");
 
+    // Headless windows only have a GPU to copy
+    if (this->is_headless) {
+        this->glfw_window = nullptr;
+        this->rendering_surface = nullptr;
+        this->rendering_gpu = new Rendering::GPU(this->instance, (const Rendering::Surface*) nullptr, { 1, 1, 1, 1 }, Rendering::headless_device_extensions);
+        this->rendering_swapchain = nullptr;
+        this->rw = other.rw;
+        this->rh = other.rh;
+
+        logger.logc(Verbosity::debug, Window::channel, "Copy success.");
+        return;
+    }
+
     // First, copy the glfw window
     this->glfw_window = glfwCreateWindow(this->w, this->h, this->t.c_str(), NULL, NULL);
     if (this->glfw_window == NULL) {
@@ -94,7 +143,7 @@ Window::Window(const Window& other) :
     // Also copy the other classes
     this->rendering_surface = new Rendering::Surface(this->instance, this->glfw_window);
     this->rendering_gpu = new Rendering::GPU(this->instance, *this->rendering_surface, { 1, 1, 1, 1 }, Rendering::device_extensions);
-    this->rendering_swapchain = new Rendering::Swapchain(*this->rendering_gpu, this->glfw_window, *this->rendering_surface);
+    this->rendering_swapchain = new Rendering::Swapchain(*this->rendering_gpu, this->glfw_window, *this->rendering_surface, other.rendering_swapchain->present_mode(), other.rendering_swapchain->desired_size());
 
     logger.logc(Verbosity::debug, Window::channel, "Copy success.");
 }
@@ -103,6 +152,7 @@ Window::Window(const Window& other) :
 Window::Window(Window&& other) :
     instance(other.instance),
 
+    is_headless(other.is_headless),
     glfw_window(other.glfw_window),
     rendering_surface(other.rendering_surface),
     rendering_gpu(other.rendering_gpu),
@@ -221,8 +271,13 @@ void Window::register_callbacks(GLFWwindow* glfw_window) {
 
 
 
-/* Resizes the window to the new size of the GLFWwindow. */
-void Window::resize() {
+/* Resizes the window to the new size of the GLFWwindow. Returns the retired swapchain, which has to be destroyed once no frames in flight use it anymore. */
+VkSwapchainKHR Window::resize() {
+    // Headless windows don't have a swapchain to resize
+    if (this->is_headless) {
+        logger.fatalc(Window::channel, "Cannot resize a headless window.");
+    }
+
     // If the user minimized the application, then we shall wait until the window has a size again
     int width = 0, height = 0;
     glfwGetFramebufferSize(this->glfw_window, &width, &height);
@@ -235,25 +290,28 @@ void Window::resize() {
         }
     }
 
-    // Wait until the device is idle
-    this->rendering_gpu->wait_for_idle();
-    
     // Update the internal sizes
     this->w = static_cast<uint32_t>(width);
     this->h = static_cast<uint32_t>(height);
     this->rw = static_cast<uint32_t>(width);
     this->rh = static_cast<uint32_t>(height);
 
-    // Then, resize the swapchain (which also updates the image views)
+    // Then, resize the swapchain. We don't wait for the device to be idle, since the old swapchain is only retired and remains valid for the frames still in flight
     this->rendering_gpu->refresh_swapchain_info();
-    this->rendering_swapchain->resize(this->glfw_window);
+    VkSwapchainKHR vk_old_swapchain = this->rendering_swapchain->resize(this->glfw_window);
 
     // Done as far as the window is concerned
     this->should_resize = false;
+    return vk_old_swapchain;
 }
 
-/* Resizes the window to the given size. */
-void Window::resize(uint32_t new_width, uint32_t new_height) {
+/* Resizes the window to the given size. Returns the retired swapchain, which has to be destroyed once no frames in flight use it anymore. */
+VkSwapchainKHR Window::resize(uint32_t new_width, uint32_t new_height) {
+    // Headless windows don't have a swapchain to resize
+    if (this->is_headless) {
+        logger.fatalc(Window::channel, "Cannot resize a headless window.");
+    }
+
     // If the user minimized the application, then we shall wait until the window has a size again
     int width = 0, height = 0;
     glfwGetFramebufferSize(this->glfw_window, &width, &height);
@@ -266,27 +324,30 @@ void Window::resize(uint32_t new_width, uint32_t new_height) {
         }
     }
 
-    // Wait until the device is idle
-    this->rendering_gpu->wait_for_idle();
-
     // Update the internal sizes
     this->w = static_cast<uint32_t>(width);
     this->h = static_cast<uint32_t>(height);
     this->rw = static_cast<uint32_t>(width);
     this->rh = static_cast<uint32_t>(height);
 
-    // Then, resize the swapchain (which also updates the image views)
+    // Then, resize the swapchain. We don't wait for the device to be idle, since the old swapchain is only retired and remains valid for the frames still in flight
     this->rendering_gpu->refresh_swapchain_info();
-    this->rendering_swapchain->resize(new_width, new_height);
+    VkSwapchainKHR vk_old_swapchain = this->rendering_swapchain->resize(new_width, new_height);
 
     // Done as far as the window is concerned
     this->should_resize = false;
+    return vk_old_swapchain;
 }
 
 
 
 /* Runs window events. Returns whether or not the window can remain open (true) or should close due to user interaction (false). */
 bool Window::loop() const {
+    // Headless windows have no events to poll, and only close if asked to
+    if (this->is_headless) {
+        return !this->should_close;
+    }
+
     // First, poll the GLFW events
     glfwPollEvents();
 
@@ -304,6 +365,7 @@ void Makma3D::swap(Window& w1, Window& w2) {
 
     // Simply swap everything
     using std::swap;
+    swap(w1.is_headless, w2.is_headless);
     swap(w1.glfw_window, w2.glfw_window);
     swap(w1.rendering_surface, w2.rendering_surface);
     swap(w1.rendering_gpu, w2.rendering_gpu);
@@ -4,13 +4,15 @@
  * Created:
  *   02/07/2021, 13:45:00
  * Last edited:
- *   07/08/2021, 18:20:38
+ *   19/10/2026, 01:06:35
  * Auto updated?
  *   Yes
  *
  * Description:
  *   Contains the Window class, which manages the GLFW window and bundles
  *   Vulkan instance, gpu, surface and swapchain together in one place.
+ *   Can also be headless, in which case there is no GLFW window, surface
+ *   or swapchain but only a GPU that renders to offscreen images.
 **/
 
 #ifndef WINDOW_HPP
@@ -46,13 +48,15 @@ namespace Makma3D {
         };
 
 
-        /* The GLFWwindow object that we handle. */
+        /* Whether or not the window is headless, i.e., has no GLFW window, surface or swapchain. */
+        bool is_headless;
+        /* The GLFWwindow object that we handle. Is a nullptr if the window is headless. */
         GLFWwindow* glfw_window;
-        /* Vulkan's representation of the window. */
+        /* Vulkan's representation of the window. Is a nullptr if the window is headless. */
         Rendering::Surface* rendering_surface;
         /* The GPU which we use for this window. */
         Rendering::GPU* rendering_gpu;
-        /* The Swapchain used to reach the window. */
+        /* The Swapchain used to reach the window. Is a nullptr if the window is headless. */
         Rendering::Swapchain* rendering_swapchain;
 
         /* The title of the window. */
@@ -94,8 +98,10 @@ namespace Makma3D {
         void register_callbacks(GLFWwindow* glfw_window);
     
     public:
-        /* Constructor for the Window class, which takes the Vulkan instance to create the surface, GPU and swapchain with, the title and the size for the window. */
-        Window(const Rendering::Instance& instance, const std::string& title, uint32_t width, uint32_t height);
+        /* Constructor for the Window class, which takes the Vulkan instance to create the surface, GPU and swapchain with, the title and the size for the window. Optionally takes the present mode and the number of images (0 to choose automatically) for the swapchain. */
+        Window(const Rendering::Instance& instance, const std::string& title, uint32_t width, uint32_t height, VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR, uint32_t image_count = 0);
+        /* Constructor for the Window class, which creates a headless window of the given size. It doesn't need GLFW to be initialized, and only creates a GPU that doesn't have to be able to present. */
+        Window(const Rendering::Instance& instance, uint32_t width, uint32_t height);
         /* Copy constructor for the Window class. */
         Window(const Window& other);
         /* Move constructor for the Window class. */
@@ -104,21 +110,23 @@ namespace Makma3D {
         ~Window();
 
         /* Updates the title of the window. */
-        inline void set_title(const std::string& new_title) { glfwSetWindowTitle(this->glfw_window, new_title.c_str()); }
-        /* Resizes the window to the new size of the GLFWwindow. */
-        void resize();
-        /* Resizes the window to the given size. */
-        void resize(uint32_t new_width, uint32_t new_height);
+        inline void set_title(const std::string& new_title) { this->t = new_title; if (!this->is_headless) { glfwSetWindowTitle(this->glfw_window, new_title.c_str()); } }
+        /* Resizes the window to the new size of the GLFWwindow. Returns the retired swapchain, which has to be destroyed once no frames in flight use it anymore. */
+        VkSwapchainKHR resize();
+        /* Resizes the window to the given size. Returns the retired swapchain, which has to be destroyed once no frames in flight use it anymore. */
+        VkSwapchainKHR resize(uint32_t new_width, uint32_t new_height);
 
         /* Runs window events. Returns whether or not the window should close. */
         bool loop() const;
 
+        /* Returns whether or not the window is headless, i.e., renders offscreen without a GLFW window, surface or swapchain. */
+        inline bool headless() const { return this->is_headless; }
         /* Returns whether or not the window thinks it needs resizing. */
         inline bool needs_resize() const { return this->should_resize; }
         /* Returns whether or not the Window has focus. */
         inline bool has_focus() const { return this->focused; }
         /* Checks if the given key is pressed or not. */
-        inline bool key_pressed(int key) const { return glfwGetKey(this->glfw_window, key) == GLFW_PRESS; }
+        inline bool key_pressed(int key) const { return !this->is_headless && glfwGetKey(this->glfw_window, key) == GLFW_PRESS; }
         /* Returns the current position of the mouse. */
         inline glm::vec2 mouse_pos() const { return this->new_mouse_pos; }
         /* Returns the velocity of the mouse. */
@@ -139,11 +147,11 @@ namespace Makma3D {
         /* Returns the actual dimensions of the window as a Vulkan extent, in pixels. */
         inline VkExtent2D real_extent() const { return VkExtent2D({ this->rw, this->rh }); }
 
-        /* Explicitly returns the internal surface object. */
+        /* Explicitly returns the internal surface object. Not available for headless windows. */
         inline const Rendering::Surface& surface() const { return *this->rendering_surface; }
         /* Explicitly returns the internal GPU object. */
         inline const Rendering::GPU& gpu() const { return *this->rendering_gpu; }
-        /* Explicitly returns the internal swapchain object. */
+        /* Explicitly returns the internal swapchain object. Not available for headless windows. */
         inline const Rendering::Swapchain& swapchain() const { return *this->rendering_swapchain; }
 
         /* Expliticitly returns the internal GLFW window object. */
@@ -0,0 +1,141 @@
+/* CAMERA PATH.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:22:38
+ * Last edited:
+ *   19/10/2026, 01:25:01
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the CameraPath class, which is a list of timed camera
+ *   positions & rotations. It can be recorded while flying around and
+ *   saved to disk, so that it can later be replayed at a fixed timestep
+ *   to get reproducible benchmarks.
+**/
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cerrno>
+#include <cstring>
+
+#include "tools/Logger.hpp"
+
+#include "CameraPath.hpp"
+
+using namespace std;
+using namespace Makma3D;
+using namespace Makma3D::World;
+
+
+/***** CAMERAPATH CLASS *****/
+/* Default constructor for the CameraPath class, which initializes an empty path. */
+CameraPath::CameraPath() {}
+
+
+
+/* Adds a point to the end of the path. Its time should not lie before that of the last point. */
+void CameraPath::add(float time, const glm::vec3& position, const glm::vec3& rotation) {
+    #ifndef NDEBUG
+    if (!this->keys.empty() && time < this->keys.last().time) {
+        logger.fatalc(CameraPath::channel, "Cannot add point at ", time, "s after point at ", this->keys.last().time, "s.");
+    }
+    #endif
+
+    this->keys.push_back(CameraKey{ time, position, rotation });
+}
+
+/* Returns where the camera is on the path at the given time, interpolating linearly between points and clamping to the start and end. The path may not be empty. */
+World::CameraKey CameraPath::sample(float time) const {
+    #ifndef NDEBUG
+    if (this->keys.empty()) {
+        logger.fatalc(CameraPath::channel, "Cannot sample an empty path.");
+    }
+    #endif
+
+    // Clamp to the ends of the path
+    if (time <= this->keys.first().time) { return this->keys.first(); }
+    if (time >= this->keys.last().time) { return this->keys.last(); }
+
+    // Binary search the first point after the given time
+    uint32_t lo = 0, hi = this->keys.size() - 1;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (this->keys[mid].time <= time) { lo = mid; }
+        else { hi = mid; }
+    }
+
+    // Interpolate between the two surrounding points
+    const CameraKey& k1 = this->keys[lo];
+    const CameraKey& k2 = this->keys[hi];
+    float t = k2.time > k1.time ? (time - k1.time) / (k2.time - k1.time) : 0.0f;
+    return CameraKey{ time, glm::mix(k1.position, k2.position, t), glm::mix(k1.rotation, k2.rotation, t) };
+}
+
+
+
+/* Loads a path from the file at the given path. */
+CameraPath CameraPath::load(const std::string& path) {
+    logger.logc(Verbosity::important, CameraPath::channel, "Loading camera path '", path, "'...");
+
+    // Try to open the file
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        logger.fatalc(CameraPath::channel, "Could not open camera path '", path, "': ", strerror(errno));
+    }
+
+    // Check the header
+    std::string line;
+    if (!std::getline(ifs, line) || line != CameraPath::file_header) {
+        logger.fatalc(CameraPath::channel, "File '", path, "' is not a camera path (missing '", CameraPath::file_header, "' header).");
+    }
+
+    // Read the points, one per line
+    CameraPath result;
+    uint32_t line_number = 1;
+    while (std::getline(ifs, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') { continue; }
+
+        CameraKey key;
+        std::stringstream sstr(line);
+        if (!(sstr >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.rotation.x >> key.rotation.y >> key.rotation.z)) {
+            logger.fatalc(CameraPath::channel, path, ":", line_number, ": Expected seven numbers (time, position & rotation).");
+        }
+        if (!result.keys.empty() && key.time < result.keys.last().time) {
+            logger.fatalc(CameraPath::channel, path, ":", line_number, ": Point at ", key.time, "s lies before the previous point.");
+        }
+        result.keys.push_back(key);
+    }
+    if (result.keys.empty()) {
+        logger.fatalc(CameraPath::channel, "Camera path '", path, "' is empty.");
+    }
+
+    // Done
+    logger.logc(Verbosity::important, CameraPath::channel, "Loaded ", result.keys.size(), " points spanning ", result.duration(), "s.");
+    return result;
+}
+
+/* Saves the path to the file at the given path. */
+void CameraPath::save(const std::string& path) const {
+    // Try to open the file
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) {
+        logger.fatalc(CameraPath::channel, "Could not open camera path '", path, "' for writing: ", strerror(errno));
+    }
+
+    // Write the header and then each point
+    ofs << CameraPath::file_header << endl;
+    ofs << "# time position.x position.y position.z rotation.x rotation.y rotation.z" << endl;
+    ofs << std::setprecision(9);
+    for (uint32_t i = 0; i < this->keys.size(); i++) {
+        const CameraKey& key = this->keys[i];
+        ofs << key.time << ' ' << key.position.x << ' ' << key.position.y << ' ' << key.position.z << ' ' << key.rotation.x << ' ' << key.rotation.y << ' ' << key.rotation.z << '\n';
+    }
+    ofs.close();
+
+    // Done
+    logger.logc(Verbosity::important, CameraPath::channel, "Saved ", this->keys.size(), " points spanning ", this->duration(), "s to '", path, "'.");
+}
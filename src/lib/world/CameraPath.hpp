@@ -0,0 +1,77 @@
+/* CAMERA PATH.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:22:38
+ * Last edited:
+ *   19/10/2026, 01:25:01
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the CameraPath class, which is a list of timed camera
+ *   positions & rotations. It can be recorded while flying around and
+ *   saved to disk, so that it can later be replayed at a fixed timestep
+ *   to get reproducible benchmarks.
+**/
+
+#ifndef WORLD_CAMERA_PATH_HPP
+#define WORLD_CAMERA_PATH_HPP
+
+#include <string>
+#define GLM_FORCE_RADIANS
+#include "glm/glm.hpp"
+
+#include "tools/Array.hpp"
+
+namespace Makma3D::World {
+    /* A single point on a CameraPath. */
+    struct CameraKey {
+        /* The time of the point, in seconds since the start of the path. */
+        float time;
+        /* The position of the camera. */
+        glm::vec3 position;
+        /* The rotation of the camera. */
+        glm::vec3 rotation;
+    };
+
+
+
+    /* The CameraPath class, which records and replays where a camera went. */
+    class CameraPath {
+    public:
+        /* Channel name for the CameraPath class. */
+        static constexpr const char* channel = "CameraPath";
+        /* The header line of a camera path file, which we use to recognize them. */
+        static constexpr const char* file_header = "# Rasterizer camera path v1";
+
+    private:
+        /* The points on the path, sorted by time. */
+        Tools::Array<World::CameraKey> keys;
+
+    public:
+        /* Default constructor for the CameraPath class, which initializes an empty path. */
+        CameraPath();
+
+        /* Adds a point to the end of the path. Its time should not lie before that of the last point. */
+        void add(float time, const glm::vec3& position, const glm::vec3& rotation);
+        /* Returns where the camera is on the path at the given time, interpolating linearly between points and clamping to the start and end. The path may not be empty. */
+        World::CameraKey sample(float time) const;
+
+        /* Loads a path from the file at the given path. */
+        static CameraPath load(const std::string& path);
+        /* Saves the path to the file at the given path. */
+        void save(const std::string& path) const;
+
+        /* Returns the time of the last point on the path, in seconds. */
+        inline float duration() const { return this->keys.empty() ? 0.0f : this->keys.last().time; }
+        /* Returns the number of points on the path. */
+        inline uint32_t size() const { return static_cast<uint32_t>(this->keys.size()); }
+        /* Returns whether the path is empty. */
+        inline bool empty() const { return this->keys.empty(); }
+
+    };
+
+}
+
+#endif
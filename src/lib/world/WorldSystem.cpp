@@ -4,7 +4,7 @@
  * Created:
  *   30/07/2021, 12:17:08
  * Last edited:
- *   9/19/2021, 5:52:41 PM
+ *   19/10/2026, 02:53:26
  * Auto updated?
  *   Yes
  *
@@ -16,10 +16,14 @@
 
 #include "glm/gtc/matrix_transform.hpp"
 
+#include "tools/Profiler.hpp"
+
 #include "ecs/auxillary/ComponentList.hpp"
 #include "ecs/components/Transform.hpp"
 #include "ecs/components/Camera.hpp"
 #include "ecs/components/Controllable.hpp"
+#include "ecs/components/Light.hpp"
+#include "ecs/components/Emitter.hpp"
 
 #include "WorldSystem.hpp"
 
@@ -137,8 +141,8 @@ void WorldSystem::set_controllable(ECS::EntityManager& entity_manager, entity_t
     controllable.rot_speed = rotation_speed;  
 }
 
-/* Sets the position of a camera in the WorldSystem, recomputing the necessary camera matrices in addition to its transform matrices. */
-void WorldSystem::set_cam(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& position, const glm::vec3& rotation, float fov, float aspect_ratio) const {
+/* Sets the position of a camera in the WorldSystem, recomputing the necessary camera matrices in addition to its transform matrices. The viewport is the part of the window it renders to, in fractions of the window's size. */
+void WorldSystem::set_cam(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& position, const glm::vec3& rotation, float fov, float aspect_ratio, const glm::vec4& viewport) const {
     // Get the entity's transform & camera components
     Transform& transform = entity_manager.get_component<Transform>(entity);
     Camera& camera = entity_manager.get_component<Camera>(entity);
@@ -147,6 +151,7 @@ void WorldSystem::set_cam(ECS::EntityManager& entity_manager, entity_t entity, c
     camera.fov   = fov;
     camera.ratio = aspect_ratio;
     camera.proj  = compute_camera_proj_matrix(camera.fov, camera.ratio);
+    camera.viewport = viewport;
 
     // Next, compute the translation matrix for the camera
     transform.position    = position;
@@ -158,6 +163,32 @@ void WorldSystem::set_cam(ECS::EntityManager& entity_manager, entity_t entity, c
     camera.view = compute_camera_view_matrix(transform.position, transform.rotation.y, transform.rotation.x);
 }
 
+/* Sets the properties of a given Light: its (linear) colour, the intensity with which it shines and the distance it reaches. Its position is set like any other entity's. */
+void WorldSystem::set_light(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& colour, float intensity, float radius) const {
+    // Get the light component
+    Light& light = entity_manager.get_component<Light>(entity);
+
+    // Set the properties
+    light.colour    = colour;
+    light.intensity = intensity;
+    light.radius    = radius;
+}
+
+/* Sets the properties of a given Emitter: the velocity of its particles and the largest random speed added to it, their (linear) colour, how many it spawns per second, how long they live, how large they are and the radius around the emitter in which they spawn. Its position is set like any other entity's. */
+void WorldSystem::set_emitter(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& velocity, float speed_spread, const glm::vec3& colour, float rate, float lifetime, float size, float radius) const {
+    // Get the emitter component
+    Emitter& emitter = entity_manager.get_component<Emitter>(entity);
+
+    // Set the properties
+    emitter.velocity     = velocity;
+    emitter.speed_spread = speed_spread;
+    emitter.colour       = colour;
+    emitter.rate         = rate;
+    emitter.lifetime     = lifetime;
+    emitter.size         = size;
+    emitter.radius       = radius;
+}
+
 
 
 /* Sets an entity's position within the world, at the given location, with the given rotation and given scale. */
@@ -214,6 +245,8 @@ void WorldSystem::scale(ECS::EntityManager& entity_manager, entity_t entity, con
 
 /* Updates all relevant objects, either by physics or by window input. */
 void WorldSystem::update(ECS::EntityManager& entity_manager, const Window& window) {
+    PROFILE_SCOPE("update_world");
+
     // Compute the number of seconds passed since last update
     std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
     float passed = static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(now - this->last_update).count());
@@ -300,7 +333,7 @@ void WorldSystem::update(ECS::EntityManager& entity_manager, const Window& windo
             transform.translation = compute_translation_matrix(transform.position, transform.rotation, transform.scale);
             if (entity_manager.has_component(entity, ComponentFlags::camera)) {
                 Camera& camera = entity_manager.get_component<Camera>(entity);
-                camera.ratio = (float) window.real_width() / (float) window.real_height();
+                camera.ratio = ((float) window.real_width() * camera.viewport.z) / ((float) window.real_height() * camera.viewport.w);
                 camera.proj  = compute_camera_proj_matrix(camera.fov, camera.ratio);
                 camera.view  = compute_camera_view_matrix(transform.position, transform.rotation.y, transform.rotation.x);
             }
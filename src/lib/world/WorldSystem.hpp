@@ -4,7 +4,7 @@
  * Created:
  *   30/07/2021, 12:17:02
  * Last edited:
- *   07/08/2021, 15:35:35
+ *   19/10/2026, 02:53:26
  * Auto updated?
  *   Yes
  *
@@ -56,8 +56,12 @@ namespace Makma3D::World {
         
         /* Sets the movement speeds of a given Controllable. */
         void set_controllable(ECS::EntityManager& entity_manager, entity_t entity, float movement_speed, float rotation_speed) const;
-        /* Sets the position of a camera in the WorldSystem, recomputing the necessary camera matrices in addition to its transform matrices. */
-        void set_cam(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& position, const glm::vec3& rotation, float fov, float aspect_ratio) const;
+        /* Sets the position of a camera in the WorldSystem, recomputing the necessary camera matrices in addition to its transform matrices. The viewport is the part of the window it renders to, in fractions of the window's size. */
+        void set_cam(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& position, const glm::vec3& rotation, float fov, float aspect_ratio, const glm::vec4& viewport = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)) const;
+        /* Sets the properties of a given Light: its (linear) colour, the intensity with which it shines and the distance it reaches. Its position is set like any other entity's. */
+        void set_light(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& colour, float intensity, float radius) const;
+        /* Sets the properties of a given Emitter: the velocity of its particles and the largest random speed added to it, their (linear) colour, how many it spawns per second, how long they live, how large they are and the radius around the emitter in which they spawn. Its position is set like any other entity's. */
+        void set_emitter(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& velocity, float speed_spread, const glm::vec3& colour, float rate, float lifetime, float size, float radius) const;
 
         /* Sets an entity's position within the world, at the given location, with the given rotation and given scale. */
         void set(ECS::EntityManager& entity_manager, entity_t entity, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) const;
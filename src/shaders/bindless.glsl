@@ -0,0 +1,31 @@
+/* BINDLESS.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:02:11
+ * Last edited:
+ *   19/10/2026, 03:04:58
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Included by the fragment shaders of the materials that keep their
+ *   textures bindless. The material's parameters tell the index of its
+ *   texture in the array with all textures. The layout matches that in
+ *   BindlessTextures.hpp.
+**/
+
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+// The maximum number of textures, matching max_textures in BindlessTextures.hpp
+#define MAX_TEXTURES 1024
+
+// The parameters of the materials, which tell where their textures are
+#include "materials.glsl"
+
+/* Memory layout */
+// All textures drawn so far; only the first few are actually written
+layout(set = 3, binding = 0) uniform sampler2D textures[MAX_TEXTURES];
+
+#endif
@@ -0,0 +1,29 @@
+/* CAMERA.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:41:16
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Included by the vertex shaders to get the matrices of the camera
+ *   that is rendered to. The layout matches that of CameraData.hpp.
+**/
+
+#include "views.glsl"
+
+/* Memory layout */
+// The matrices of a single camera
+struct CameraData {
+    mat4 proj;
+    mat4 view;
+};
+// The camera data of each view as a uniform buffer
+layout(set = 0, binding = 0) uniform Camera {
+    CameraData views[MAX_VIEWS];
+} cameras;
+// The camera of the view we're rendering
+#define camera cameras.views[VIEW_INDEX]
@@ -0,0 +1,128 @@
+/* CULL COMP.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Compute shader that culls each draw against the view frustum and
+ *   against the depth pyramid of the previous frame, and writes an
+ *   indexed indirect draw command for it with an instance count of 1 if
+ *   it survives or 0 if it doesn't. Does exactly the same steps as
+ *   CullReference.cpp.
+**/
+
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "views.glsl"
+
+/* Memory layout */
+layout(local_size_x = 64) in;
+
+// A single draw to cull
+struct CullItem {
+    vec4 sphere;
+    uint first_index;
+    uint n_indices;
+    int vertex_offset;
+    uint padding;
+};
+// A single VkDrawIndexedIndirectCommand
+struct DrawCommand {
+    uint index_count;
+    uint instance_count;
+    uint first_index;
+    int vertex_offset;
+    uint first_instance;
+};
+
+// The culling parameters as a uniform buffer
+layout(set = 0, binding = 0) uniform CullParams {
+    mat4 view_proj;
+    mat4 prev_view_proj;
+    vec4 planes[MAX_VIEWS * 6];
+    vec2 pyramid_size;
+    uint n_items;
+    uint use_pyramid;
+    uint n_views;
+} params;
+// The draws to cull
+layout(std430, set = 0, binding = 1) readonly buffer CullItems {
+    CullItem items[];
+};
+// The draw commands we write, one per draw
+layout(std430, set = 0, binding = 2) writeonly buffer DrawCommands {
+    DrawCommand draws[];
+};
+// The depth pyramid of the previous frame
+layout(set = 0, binding = 3) uniform sampler2D pyramid;
+
+
+
+/* Helper functions */
+// Returns whether the given sphere lies (partly) inside the frustum of the given view
+bool in_frustum(uint view, vec4 sphere) {
+    for (uint i = view * 6u; i < view * 6u + 6u; i++) {
+        if (dot(params.planes[i].xyz, sphere.xyz) + params.planes[i].w < -sphere.w) { return false; }
+    }
+    return true;
+}
+
+// Returns whether the given sphere may be visible in the previous frame's depth buffer
+bool unoccluded(vec4 sphere) {
+    // Project the corners of the sphere's bounding box to find the rectangle it covers on the screen, and how near it gets
+    vec2 ndc_min = vec2(1.0), ndc_max = vec2(-1.0);
+    float nearest = 1.0;
+    for (uint i = 0u; i < 8u; i++) {
+        vec3 corner = sphere.xyz + sphere.w * vec3((i & 1u) != 0u ? 1.0 : -1.0, (i & 2u) != 0u ? 1.0 : -1.0, (i & 4u) != 0u ? 1.0 : -1.0);
+        vec4 clip = params.prev_view_proj * vec4(corner, 1.0);
+        if (clip.w <= 0.0) { return true; }
+        vec3 ndc = clip.xyz / clip.w;
+        ndc_min = min(ndc_min, ndc.xy);
+        ndc_max = max(ndc_max, ndc.xy);
+        nearest = min(nearest, ndc.z);
+    }
+    vec2 uv_min = clamp(ndc_min * 0.5 + 0.5, vec2(0.0), vec2(1.0));
+    vec2 uv_max = clamp(ndc_max * 0.5 + 0.5, vec2(0.0), vec2(1.0));
+
+    // Pick the level at which the rectangle spans at most two texels in each direction
+    vec2 size_px = (uv_max - uv_min) * params.pyramid_size;
+    uint span = uint(ceil(max(size_px.x, size_px.y)));
+    int level = span <= 1u ? 0 : findMSB(span - 1u) + 1;
+    level = min(level, textureQueryLevels(pyramid) - 1);
+
+    // Take the farthest depth of the texels it covers at that level
+    ivec2 extent = textureSize(pyramid, level);
+    ivec2 p0 = min(ivec2(uv_min * vec2(extent)), extent - 1);
+    ivec2 p1 = min(ivec2(uv_max * vec2(extent)), extent - 1);
+    float farthest = max(
+        max(texelFetch(pyramid, ivec2(p0.x, p0.y), level).r, texelFetch(pyramid, ivec2(p1.x, p0.y), level).r),
+        max(texelFetch(pyramid, ivec2(p0.x, p1.y), level).r, texelFetch(pyramid, ivec2(p1.x, p1.y), level).r)
+    );
+
+    // It's visible if any part of it is nearer than that
+    return nearest <= farthest;
+}
+
+
+
+/* Entry point */
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= params.n_items) { return; }
+
+    // Cull the draw
+    CullItem item = items[i];
+    bool visible = in_frustum(0u, item.sphere) && (params.use_pyramid == 0u || unoccluded(item.sphere));
+    // The pyramid only knows the first view, so the others only test their frustum
+    for (uint v = 1u; !visible && v < params.n_views; v++) {
+        visible = in_frustum(v, item.sphere);
+    }
+
+    // Write its draw command either way, so each draw keeps its place in the buffer
+    draws[i] = DrawCommand(item.n_indices, visible ? 1u : 0u, item.first_index, item.vertex_offset, 0u);
+}
@@ -0,0 +1,42 @@
+/* DEPTH PREPASS VERT.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Vertex shader for the depth pre-pass. Only reads the position stream
+ *   and doesn't output anything but the position, since the pre-pass
+ *   only writes depth and thus doesn't have a fragment shader.
+**/
+
+#version 450
+#extension GL_GOOGLE_include_directive : require
+// Must come before any declarations, since it may enable the multiview extension
+#include "views.glsl"
+
+/* Memory layout */
+// We only take the 3D positions of the points from the position stream
+layout(location = 0) in vec3 vertex;
+
+// The colour pass tests for equal depths, so make sure each shader computes exactly the same position
+invariant gl_Position;
+
+// The camera data of the view we're rendering
+#include "camera.glsl"
+// The object data as a uniform buffer
+layout(set = 2, binding = 0) uniform Object {
+    mat4 translation;
+} object;
+
+
+
+/* Entry point */
+void main() {
+    // Return the vertex as a 4D vertex, computed in the same order as the material shaders do
+    gl_Position = camera.proj * camera.view * object.translation * vec4(vertex, 1.0);
+}
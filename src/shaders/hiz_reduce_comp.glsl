@@ -0,0 +1,50 @@
+/* HIZ REDUCE COMP.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:52:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Compute shader that builds a single level of the depth pyramid from
+ *   the level before it (or from the depth buffer, for the first level),
+ *   by taking the farthest depth of all texels each texel covers. Does
+ *   exactly the same steps as reduce_depth_level() in
+ *   CullReference.cpp.
+**/
+
+#version 450
+
+/* Memory layout */
+layout(local_size_x = 8, local_size_y = 8) in;
+
+// The level (or depth buffer) to reduce
+layout(set = 0, binding = 0) uniform sampler2D src;
+// The level to write
+layout(set = 0, binding = 1, r32f) uniform writeonly image2D dst;
+
+
+
+/* Entry point */
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 dst_size = imageSize(dst);
+    if (p.x >= dst_size.x || p.y >= dst_size.y) { return; }
+
+    // Compute which source texels this texel covers, counting border texels for both sides if the sizes don't divide
+    ivec2 src_size = textureSize(src, 0);
+    ivec2 start = p * src_size / dst_size;
+    ivec2 end = ((p + 1) * src_size + dst_size - 1) / dst_size;
+
+    // Take the farthest of them
+    float depth = 0.0;
+    for (int y = start.y; y < end.y; y++) {
+        for (int x = start.x; x < end.x; x++) {
+            depth = max(depth, texelFetch(src, ivec2(x, y), 0).r);
+        }
+    }
+    imageStore(dst, p, vec4(depth));
+}
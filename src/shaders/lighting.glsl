@@ -0,0 +1,81 @@
+/* LIGHTING.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Included by the fragment shaders of the materials to light them. Finds
+ *   the cluster of the fragment and sums the diffuse light of only the
+ *   point lights that the LightClusterer assigned to it. The layouts
+ *   match those in LightData.hpp.
+**/
+
+#include "views.glsl"
+
+/* Memory layout */
+// The parameters to find the cluster of a fragment with
+layout(set = 0, binding = 1) uniform ClusterParams {
+    uvec4 grid;
+    vec2 tile_size;
+    float slice_scale;
+    float slice_bias;
+    float first_slice;
+    float ambient;
+} cluster_params;
+
+// A single point light, in view space
+struct Light {
+    vec4 position;
+    vec4 colour;
+};
+// All lights in the scene
+layout(std430, set = 0, binding = 2) readonly buffer Lights {
+    Light lights[];
+};
+// The offset & number of light indices of each cluster
+layout(std430, set = 0, binding = 3) readonly buffer Clusters {
+    uvec2 clusters[];
+};
+// The light indices of all clusters, back-to-back
+layout(std430, set = 0, binding = 4) readonly buffer LightIndices {
+    uint light_indices[];
+};
+
+
+
+/* Functions */
+// Returns the light that reaches the fragment at the given view-space position. Without any lights in the scene, the fragment is fully lit, so the materials look as they did before they were lit
+vec3 compute_lighting(vec3 view_pos) {
+    if (cluster_params.grid.w == 0) { return vec3(1.0); }
+
+    // The vertices don't have normals, so use that of the triangle, turned towards the camera
+    vec3 normal = normalize(cross(dFdx(view_pos), dFdy(view_pos)));
+    if (dot(normal, view_pos) > 0.0) { normal = -normal; }
+
+    // Find the cluster like the LightClusterer does
+    float depth = -view_pos.z;
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / cluster_params.tile_size), cluster_params.grid.xy - 1);
+    uint slice = 0;
+    if (depth >= cluster_params.first_slice) {
+        slice = uint(clamp(1 + int(floor(log(depth) * cluster_params.slice_scale + cluster_params.slice_bias)), 1, int(cluster_params.grid.z) - 1));
+    }
+    // The clusters of each view are stored back-to-back
+    uint view_offset = VIEW_INDEX * cluster_params.grid.x * cluster_params.grid.y * cluster_params.grid.z;
+    uvec2 cluster = clusters[view_offset + (slice * cluster_params.grid.y + tile.y) * cluster_params.grid.x + tile.x];
+
+    // Sum the diffuse light of its lights, each fading out smoothly towards its radius
+    vec3 result = vec3(cluster_params.ambient);
+    for (uint i = 0; i < cluster.y; i++) {
+        Light light = lights[light_indices[cluster.x + i]];
+        vec3 to_light = light.position.xyz - view_pos;
+        float distance = max(length(to_light), 1e-4);
+        float falloff = clamp(1.0 - (distance * distance) / (light.position.w * light.position.w), 0.0, 1.0);
+        result += light.colour.rgb * max(dot(normal, to_light / distance), 0.0) * falloff * falloff;
+    }
+    return result;
+}
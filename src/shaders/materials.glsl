@@ -0,0 +1,37 @@
+/* MATERIALS.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 03:04:58
+ * Last edited:
+ *   19/10/2026, 03:04:58
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Included by the shaders of the materials that have parameters. The
+ *   material's ID comes from the push constants, and finds its
+ *   parameters in the buffer with those of all materials. The layouts
+ *   match those in MaterialData.hpp.
+**/
+
+#ifndef MATERIALS_GLSL
+#define MATERIALS_GLSL
+
+/* Memory layout */
+// The parameters of a single material; each type only uses the fields that apply to it
+struct MaterialParams {
+    vec4 colour;
+    uint texture;
+};
+// The parameters of all materials, right after the lights in the global set
+layout(std430, set = 0, binding = 5) readonly buffer Materials {
+    MaterialParams params[];
+} materials;
+
+// The ID of the material that is being drawn
+layout(push_constant) uniform Material {
+    uint id;
+} material;
+
+#endif
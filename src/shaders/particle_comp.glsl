@@ -0,0 +1,167 @@
+/* PARTICLE COMP.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Compute shaders that run the particle simulation, compiled once per
+ *   stage. SIMULATE ages and moves the living particles in one half of
+ *   the particle buffer and compacts the survivors into the other half.
+ *   EMIT spawns the new particles of this frame behind them. FINALIZE
+ *   swaps the halves and writes the indirect commands that draw the
+ *   particles and simulate them next frame.
+**/
+
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#include "particles.glsl"
+
+/* Memory layout */
+layout(local_size_x = PARTICLE_GROUP_SIZE) in;
+
+// The simulation parameters as a uniform buffer
+layout(set = 0, binding = 0) uniform ParticleParams {
+    vec4 gravity;
+    float dt;
+    uint n_emitters;
+    uint n_emit;
+    uint seed;
+} params;
+// The emitters that spawn particles this frame, sorted by their first particle
+layout(std430, set = 0, binding = 1) readonly buffer Emitters {
+    Emitter emitters[];
+};
+// Both halves of the particle buffer, back-to-back
+layout(std430, set = 0, binding = 2) buffer Particles {
+    Particle particles[];
+};
+// The state of the simulation
+layout(std430, set = 0, binding = 3) buffer ParticleCounters {
+    Counters counters;
+};
+
+
+
+/* Helper functions */
+// Scrambles the bits of the given number
+uint hash(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Returns a random number in [0, 1), advancing the given state
+float random(inout uint state) {
+    state = hash(state);
+    return float(state >> 8) / 16777216.0;
+}
+
+// Returns a random point in the unit sphere, spread evenly through its volume
+vec3 random_in_sphere(inout uint state) {
+    float z = 2.0 * random(state) - 1.0;
+    float phi = 6.28318530718 * random(state);
+    float r = pow(random(state), 1.0 / 3.0);
+    float s = sqrt(max(0.0, 1.0 - z * z));
+    return r * vec3(s * cos(phi), s * sin(phi), z);
+}
+
+
+
+/* Entry point */
+#if defined(SIMULATE)
+
+// The number of survivors in this workgroup, and where they go in the other half
+shared uint group_count;
+shared uint group_first;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    uint src = counters.current * counters.capacity;
+    uint dst = (1u - counters.current) * counters.capacity;
+    if (gl_LocalInvocationIndex == 0u) { group_count = 0u; }
+    barrier();
+
+    // Age the particle. This has to stay a single subtraction, since ParticleReference.cpp decides when particles die the same way
+    bool survives = false;
+    Particle particle;
+    if (i < counters.alive) {
+        particle = particles[src + i];
+        particle.velocity.w -= params.dt;
+        survives = particle.velocity.w > 0.0;
+
+        // Move it, slowing it down by the drag
+        particle.velocity.xyz = (particle.velocity.xyz + params.gravity.xyz * params.dt) * max(0.0, 1.0 - params.gravity.w * params.dt);
+        particle.position.xyz += particle.velocity.xyz * params.dt;
+    }
+
+    // Reserve room for all survivors of the workgroup at once, so that only a single thread per group contends for the global counter
+    uint local_index = 0u;
+    if (survives) { local_index = atomicAdd(group_count, 1u); }
+    barrier();
+    if (gl_LocalInvocationIndex == 0u) { group_first = atomicAdd(counters.written, group_count); }
+    barrier();
+
+    // Write the survivors back-to-back into the other half. They never overflow it, since there were at most as many particles alive as fit
+    if (survives) { particles[dst + group_first + local_index] = particle; }
+}
+
+#elif defined(EMIT)
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= params.n_emit) { return; }
+
+    // Find the emitter that spawns this particle: the last one whose range starts at or before it
+    uint lo = 0u, hi = params.n_emitters - 1u;
+    while (lo < hi) {
+        uint mid = (lo + hi + 1u) / 2u;
+        if (emitters[mid].first <= i) { lo = mid; }
+        else { hi = mid - 1u; }
+    }
+    Emitter emitter = emitters[lo];
+
+    // Place it behind the survivors, unless the buffer is full
+    uint slot = atomicAdd(counters.written, 1u);
+    if (slot >= counters.capacity) {
+        atomicAdd(counters.dropped, 1u);
+        return;
+    }
+
+    // Spawn it somewhere in the emitter's sphere, with a random kick on top of the emitter's velocity
+    uint state = hash(params.seed ^ hash(i));
+    vec3 offset = emitter.position.w * random_in_sphere(state);
+    vec3 kick = emitter.velocity.w * random_in_sphere(state);
+    Particle particle;
+    particle.position = vec4(emitter.position.xyz + offset, emitter.size);
+    particle.velocity = vec4(emitter.velocity.xyz + kick, emitter.colour.w);
+    particle.colour = vec4(emitter.colour.rgb, 1.0 / max(emitter.colour.w, 1e-6));
+    particles[(1u - counters.current) * counters.capacity + slot] = particle;
+}
+
+#elif defined(FINALIZE)
+
+void main() {
+    if (gl_GlobalInvocationID.x != 0u) { return; }
+
+    // The half we just wrote holds the living particles now. Emitted particles that didn't fit were counted but never written
+    uint alive = min(counters.written, counters.capacity);
+    counters.current = 1u - counters.current;
+    counters.alive = alive;
+    counters.written = 0u;
+
+    // Draw a billboard per particle, and simulate each of them next frame
+    counters.draw_instances = alive;
+    counters.dispatch_x = (alive + PARTICLE_GROUP_SIZE - 1u) / PARTICLE_GROUP_SIZE;
+}
+
+#else
+#error "Define one of SIMULATE, EMIT or FINALIZE to pick the stage to compile"
+#endif
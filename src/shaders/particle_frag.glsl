@@ -0,0 +1,34 @@
+/* PARTICLE FRAG.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Fragment shader for the particles. Rounds each billboard off to a
+ *   soft disc, which is blended additively over the scene.
+**/
+
+#version 450
+
+/* Memory layout */
+// The colour & opacity of the particle
+layout(location = 0) in vec4 frag_colour;
+// Where on the billboard the fragment is, from -1 to 1 in both directions
+layout(location = 1) in vec2 frag_corner;
+// The colour to blend over the scene
+layout(location = 0) out vec4 out_colour;
+
+
+
+/* Entry point */
+void main() {
+    // Fade out towards the edge of the disc, and skip the corners altogether
+    float falloff = 1.0 - smoothstep(0.5, 1.0, length(frag_corner));
+    if (falloff <= 0.0) { discard; }
+    out_colour = vec4(frag_colour.rgb, frag_colour.a * falloff);
+}
@@ -0,0 +1,62 @@
+/* PARTICLE VERT.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Vertex shader for the particles. Draws a camera-facing billboard per
+ *   instance, for the particle at that index in the half of the particle
+ *   buffer that holds the living ones. Doesn't take any vertex input;
+ *   the corners follow from the vertex index.
+**/
+
+#version 450
+#extension GL_GOOGLE_include_directive : require
+// Must come before any declarations, since it may enable the multiview extension
+#include "views.glsl"
+#include "particles.glsl"
+
+/* Memory layout */
+// The colour & opacity of the particle
+layout(location = 0) out vec4 frag_colour;
+// Where on the billboard the vertex is, from -1 to 1 in both directions
+layout(location = 1) out vec2 frag_corner;
+
+// The camera data of the view we're rendering
+#include "camera.glsl"
+// Both halves of the particle buffer, back-to-back
+layout(std430, set = 1, binding = 0) readonly buffer Particles {
+    Particle particles[];
+};
+// The state of the simulation, which tells us which half to read
+layout(std430, set = 1, binding = 1) readonly buffer ParticleCounters {
+    Counters counters;
+};
+
+// The corners of the two triangles that make up a billboard
+const vec2 corners[6] = vec2[6](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+);
+
+
+
+/* Entry point */
+void main() {
+    Particle particle = particles[counters.current * counters.capacity + uint(gl_InstanceIndex)];
+    vec2 corner = corners[gl_VertexIndex];
+
+    // Spread the corners in view space, so that the billboard always faces the camera
+    vec4 view_pos = camera.view * vec4(particle.position.xyz, 1.0);
+    view_pos.xy += corner * particle.position.w;
+    gl_Position = camera.proj * view_pos;
+
+    // Fade the particle out as it ages
+    frag_colour = vec4(particle.colour.rgb, clamp(particle.velocity.w * particle.colour.w, 0.0, 1.0));
+    frag_corner = corner;
+}
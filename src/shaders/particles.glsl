@@ -0,0 +1,55 @@
+/* PARTICLES.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:45:05
+ * Last edited:
+ *   19/10/2026, 02:45:05
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Included by the particle shaders to get the layouts of the particles,
+ *   the emitters and the counters of the simulation. They match those in
+ *   ParticleData.hpp.
+**/
+
+#ifndef PARTICLES_GLSL
+#define PARTICLES_GLSL
+
+// The number of particles handled by a single workgroup, which has to match ParticleSystem::group_size
+#define PARTICLE_GROUP_SIZE 64
+
+// A single living particle: its position & billboard size, its velocity & remaining life, and its colour & one over its lifetime
+struct Particle {
+    vec4 position;
+    vec4 velocity;
+    vec4 colour;
+};
+// What a single emitter spawns this frame
+struct Emitter {
+    vec4 position;
+    vec4 velocity;
+    vec4 colour;
+    float size;
+    uint first;
+    uint count;
+    uint padding;
+};
+// The state of the simulation. The first members double as a VkDrawIndirectCommand and a VkDispatchIndirectCommand
+struct Counters {
+    uint draw_vertices;
+    uint draw_instances;
+    uint draw_first_vertex;
+    uint draw_first_instance;
+    uint dispatch_x;
+    uint dispatch_y;
+    uint dispatch_z;
+    uint alive;
+    uint written;
+    uint current;
+    uint capacity;
+    uint dropped;
+};
+
+#endif
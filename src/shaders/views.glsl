@@ -0,0 +1,31 @@
+/* VIEWS.glsl
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:41:16
+ * Last edited:
+ *   19/10/2026, 02:41:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Included by any shader that runs once per view. When compiled with
+ *   MULTIVIEW defined, the render pass renders all views at once and
+ *   VIEW_INDEX is the layer that is being rendered to; otherwise, it's
+ *   always the first view. Must be included before any declarations.
+**/
+
+#ifndef VIEWS_GLSL
+#define VIEWS_GLSL
+
+// The maximum number of views, matching max_views in CameraData.hpp
+#define MAX_VIEWS 4
+
+#ifdef MULTIVIEW
+#extension GL_EXT_multiview : require
+#define VIEW_INDEX uint(gl_ViewIndex)
+#else
+#define VIEW_INDEX 0u
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/* COMMON.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File with common stuff for all the testfiles.
+**/
+
+#ifndef COMMON_HPP
+#define COMMON_HPP
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "tools/Array.hpp"
+#include "rendering/data/LightData.hpp"
+
+/***** HELPER FUNCTIONS *****/
+/* Returns a random float in the given range. */
+inline float random_float(float min, float max) {
+    return min + (max - min) * ((float) rand() / (float) RAND_MAX);
+}
+
+/* Returns the projection matrix the WorldSystem uses for a camera with the given aspect ratio. */
+inline glm::mat4 camera_proj(float aspect_ratio) {
+    glm::mat4 proj = glm::perspective(45.0f, aspect_ratio, 0.001f, 10.0f);
+    proj[1][1] *= -1;
+    return proj;
+}
+
+/* Returns the given number of random lights in front of a camera at the origin that looks down the negative z-axis, with some behind it or beyond the far plane. */
+inline Tools::Array<Makma3D::Rendering::LightData> random_lights(uint32_t n_lights) {
+    Tools::Array<Makma3D::Rendering::LightData> lights(n_lights);
+    for (uint32_t i = 0; i < n_lights; i++) {
+        glm::vec4 position(random_float(-8.0f, 8.0f), random_float(-5.0f, 5.0f), random_float(-11.0f, 0.5f), random_float(0.01f, 1.5f));
+        lights.push_back({ position, glm::vec4(random_float(0.0f, 1.0f), random_float(0.0f, 1.0f), random_float(0.0f, 1.0f), 0.0f) });
+    }
+    return lights;
+}
+
+/* Returns the squared distance between the given point and the given box. */
+inline double box_distance2(const glm::vec3& point, const glm::vec3& min, const glm::vec3& max) {
+    double result = 0.0;
+    for (uint32_t i = 0; i < 3; i++) {
+        double d = std::max({ (double) min[i] - point[i], 0.0, (double) point[i] - max[i] });
+        result += d * d;
+    }
+    return result;
+}
+
+
+
+
+
+/***** USEFUL DEFINES *****/
+/* Prints the intro for a whole new test run. */
+#define TESTRUN(NAME) \
+    cout << endl << "TEST RUN for " NAME << endl;
+/* Prints the outtro for a whole new test run. */
+#define ENDRUN(SUCCESS) \
+    cout << "Run: " << ((SUCCESS) ? "\033[32;1mSUCCESS\033[0m" : "\033[31;1mFAIL\033[0m") << endl << endl; \
+    return (SUCCESS);
+/* Prints the intro for the given test case. */
+#define TESTCASE(NAME) \
+    cout << " > Testing " NAME "..." << flush;
+/* Prints a failure message. */
+#define ERROR(MESSAGE) \
+    cout << endl << "   \033[31;1mERROR\033[0m: " MESSAGE << endl;
+/* Prints the outtro for the given test case. */
+#define ENDCASE(SUCCESS) \
+    cout << ((SUCCESS) ? " \033[32;1mOK\033[0m" : "   Testcase failed.") << endl; \
+    return (SUCCESS);
+
+#endif
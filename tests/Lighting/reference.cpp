@@ -0,0 +1,100 @@
+/* REFERENCE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that checks whether the cluster lists of the LightClusterer
+ *   match testing every light against every cluster one by one.
+**/
+
+#include <iostream>
+
+#include "rendering/lighting/LightClusterer.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Makma3D::Rendering;
+
+
+/***** TESTS *****/
+/* Checks that the lists of random lights contain exactly the lights whose spheres touch the cluster, except for those that only just (don't) touch it. */
+static bool test_random_lights() {
+    TESTCASE("cluster lists of random lights against brute force");
+
+    LightClusterer clusterer;
+    clusterer.set_projection(camera_proj(16.0f / 9.0f), 1600, 900);
+    for (uint32_t i = 0; i < 20; i++) {
+        Tools::Array<LightData> lights = random_lights(200);
+        clusterer.cluster(glm::mat4(1.0f), lights.rdata(), lights.size());
+
+        for (uint32_t c = 0; c < clusterer.size(); c++) {
+            glm::vec3 min, max;
+            clusterer.cluster_bounds(c, min, max);
+            const ClusterData& cluster = clusterer.clusters()[c];
+
+            // Walk the sorted list alongside all lights
+            uint32_t next = 0;
+            for (uint32_t l = 0; l < lights.size(); l++) {
+                bool listed = next < cluster.count && clusterer.indices()[cluster.offset + next] == l;
+                if (listed) { ++next; }
+                double r2 = (double) lights[l].position.w * lights[l].position.w;
+                double d2 = box_distance2(glm::vec3(lights[l].position), min, max);
+                if (std::fabs(d2 - r2) < 1e-4 * r2) { continue; }
+                if (listed != (d2 <= r2)) {
+                    ERROR("Light " + std::to_string(l) + " in scene " + std::to_string(i) + " is " + (listed ? "" : "not ") + "listed for cluster " + std::to_string(c) + ", but it " + (listed ? "doesn't touch" : "touches") + " it");
+                    ENDCASE(false);
+                }
+            }
+            if (next != cluster.count) {
+                ERROR("Cluster " + std::to_string(c) + " in scene " + std::to_string(i) + " has an unsorted or out-of-range list of lights");
+                ENDCASE(false);
+            }
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Checks that lights behind the camera or beyond the far plane don't end up in any cluster. */
+static bool test_invisible_lights() {
+    TESTCASE("lights outside of the frustum");
+
+    LightClusterer clusterer;
+    clusterer.set_projection(camera_proj(16.0f / 9.0f), 1600, 900);
+    Tools::Array<LightData> lights({
+        { glm::vec4(0.0f, 0.0f, 2.0f, 1.0f), glm::vec4(1.0f) },
+        { glm::vec4(0.5f, -0.5f, -12.0f, 1.0f), glm::vec4(1.0f) },
+        { glm::vec4(30.0f, 0.0f, -2.0f, 1.0f), glm::vec4(1.0f) }
+    });
+    clusterer.cluster(glm::mat4(1.0f), lights.rdata(), lights.size());
+    if (clusterer.indices().size() != 0) {
+        ERROR("Expected no cluster to list any lights, but found " + std::to_string(clusterer.indices().size()) + " light indices");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_reference() {
+    TESTRUN("LightClusterer reference");
+
+    if (!test_random_lights()) {
+        ENDRUN(false);
+    }
+    if (!test_invisible_lights()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
@@ -0,0 +1,115 @@
+/* SHADING.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that checks whether a point on the screen finds every light
+ *   that reaches it in its cluster, when looked up the same way the
+ *   fragment shaders do.
+**/
+
+#include <iostream>
+
+#include "rendering/lighting/LightClusterer.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Makma3D::Rendering;
+
+
+/***** TESTS *****/
+/* Checks that random points in view of a randomly placed camera find all lights that reach them in their cluster. */
+static bool test_random_points() {
+    TESTCASE("lights of random points on the screen");
+
+    const uint32_t width = 1280, height = 720;
+    glm::mat4 proj = camera_proj((float) width / (float) height);
+    LightClusterer clusterer;
+    clusterer.set_projection(proj, width, height);
+    ClusterParams params = clusterer.params(0.0f);
+    for (uint32_t i = 0; i < 20; i++) {
+        // Place the camera somewhere, and the lights around it
+        glm::vec3 eye(random_float(-2.0f, 2.0f), random_float(-2.0f, 2.0f), random_float(-2.0f, 2.0f));
+        glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f), -1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+        Tools::Array<LightData> lights = random_lights(300);
+        glm::mat4 inv_view = glm::inverse(view);
+        for (uint32_t l = 0; l < lights.size(); l++) {
+            lights[l].position = glm::vec4(glm::vec3(inv_view * glm::vec4(glm::vec3(lights[l].position), 1.0f)), lights[l].position.w);
+        }
+        clusterer.cluster(view, lights.rdata(), lights.size());
+
+        for (uint32_t j = 0; j < 2000; j++) {
+            // Pick a pixel and a depth, and find the point in view space
+            glm::vec2 pixel(random_float(0.0f, (float) width - 0.01f), random_float(0.0f, (float) height - 0.01f));
+            float depth = 0.01f * std::pow(990.0f, random_float(0.0f, 1.0f));
+            glm::vec4 ndc(2.0f * pixel.x / (float) width - 1.0f, 2.0f * pixel.y / (float) height - 1.0f, 0.5f, 1.0f);
+            glm::vec4 ray = glm::inverse(proj) * ndc;
+            glm::vec3 point = glm::vec3(ray) / ray.w;
+            point *= depth / -point.z;
+
+            // Find its cluster like the shaders do
+            uint32_t x = std::min((uint32_t) (pixel.x / params.tile_size.x), params.grid.x - 1);
+            uint32_t y = std::min((uint32_t) (pixel.y / params.tile_size.y), params.grid.y - 1);
+            const ClusterData& cluster = clusterer.clusters()[clusterer.cluster_index(x, y, clusterer.slice(depth))];
+
+            // Every light that clearly reaches the point should be in there
+            for (uint32_t l = 0; l < lights.size(); l++) {
+                const glm::vec4& light = clusterer.lights()[l].position;
+                if (glm::length(glm::vec3(light) - point) > 0.999f * light.w) { continue; }
+                bool found = false;
+                for (uint32_t k = 0; !found && k < cluster.count; k++) { found = clusterer.indices()[cluster.offset + k] == l; }
+                if (!found) {
+                    ERROR("Point at pixel (" + std::to_string(pixel.x) + ", " + std::to_string(pixel.y) + ") and depth " + std::to_string(depth) + " in scene " + std::to_string(i) + " is reached by light " + std::to_string(l) + ", but it isn't listed in its cluster");
+                    ENDCASE(false);
+                }
+            }
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Checks that depths map to the slices whose bounds contain them. */
+static bool test_slices() {
+    TESTCASE("depth slices");
+
+    LightClusterer clusterer;
+    clusterer.set_projection(camera_proj(16.0f / 9.0f), 1600, 900);
+    for (uint32_t i = 0; i < 10000; i++) {
+        // Stay clear of the far plane itself, since it's only known up to float precision from the matrix
+        float depth = 0.001f * std::pow(9900.0f, random_float(0.0f, 1.0f));
+        uint32_t s = clusterer.slice(depth);
+        glm::vec3 min, max;
+        clusterer.cluster_bounds(clusterer.cluster_index(0, 0, s), min, max);
+        if (-max.z > depth * 1.0001f || -min.z < depth * 0.9999f) {
+            ERROR("Depth " + std::to_string(depth) + " maps to slice " + std::to_string(s) + ", which runs from " + std::to_string(-max.z) + " to " + std::to_string(-min.z));
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_shading() {
+    TESTRUN("LightClusterer shading");
+
+    if (!test_slices()) {
+        ENDRUN(false);
+    }
+    if (!test_random_points()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
@@ -0,0 +1,42 @@
+/* TEST LIGHTING.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that tests the clustered light assignment, without any GPU.
+**/
+
+#include <ctime>
+#include <cstdlib>
+
+using namespace std;
+
+// Function that tests whether the SIMD cluster lists match testing each light against each cluster
+extern bool test_reference();
+// Function that tests whether every lit point finds its lights in the cluster it falls in
+extern bool test_shading();
+// Function that tests whether clustering on multiple threads gives the same result as on one
+extern bool test_threading();
+
+int main() {
+    // Seed the random seed
+    srand((unsigned int) time(0));
+
+    if (!test_reference()) {
+        return EXIT_FAILURE;
+    }
+    if (!test_shading()) {
+        return EXIT_FAILURE;
+    }
+    if (!test_threading()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
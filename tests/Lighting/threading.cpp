@@ -0,0 +1,70 @@
+/* THREADING.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 02:52:14
+ * Last edited:
+ *   19/10/2026, 02:52:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that checks whether clustering the lights on multiple threads
+ *   gives exactly the same lists as doing it on one.
+**/
+
+#include <iostream>
+
+#include "tools/ThreadPool.hpp"
+#include "rendering/lighting/LightClusterer.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Makma3D::Rendering;
+
+
+/***** TESTS *****/
+/* Checks that clustering the same random lights with and without a thread pool gives the same lists. */
+static bool test_threaded_random() {
+    TESTCASE("threaded clustering of random lights");
+
+    Tools::ThreadPool pool(4, "lighting");
+    LightClusterer single, threaded;
+    single.set_projection(camera_proj(16.0f / 9.0f), 1600, 900);
+    threaded.set_projection(camera_proj(16.0f / 9.0f), 1600, 900);
+    for (uint32_t i = 0; i < 20; i++) {
+        Tools::Array<LightData> lights = random_lights(1000);
+        single.cluster(glm::mat4(1.0f), lights.rdata(), lights.size());
+        threaded.cluster(glm::mat4(1.0f), lights.rdata(), lights.size(), &pool);
+
+        // Compare the clusters and the indices
+        bool same = single.indices().size() == threaded.indices().size();
+        for (uint32_t c = 0; same && c < single.size(); c++) {
+            same = single.clusters()[c].offset == threaded.clusters()[c].offset && single.clusters()[c].count == threaded.clusters()[c].count;
+        }
+        for (uint32_t j = 0; same && j < single.indices().size(); j++) {
+            same = single.indices()[j] == threaded.indices()[j];
+        }
+        if (!same) {
+            ERROR("The lists of scene " + std::to_string(i) + " differ between the single- and multi-threaded clusterers");
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_threading() {
+    TESTRUN("LightClusterer threading");
+
+    if (!test_threaded_random()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
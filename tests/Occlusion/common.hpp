@@ -0,0 +1,73 @@
+/* COMMON.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File with common stuff for all the testfiles.
+**/
+
+#ifndef COMMON_HPP
+#define COMMON_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include "rendering/occlusion/MaskedDepthBuffer.hpp"
+
+/***** HELPER FUNCTIONS *****/
+/* Returns a random float in the given range. */
+inline float random_float(float min, float max) {
+    return min + (max - min) * ((float) rand() / (float) RAND_MAX);
+}
+
+/* Returns a random triangle that (mostly) lies on a screen of the given size, at a random depth. */
+inline Makma3D::Rendering::ScreenTriangle random_triangle(uint32_t width, uint32_t height) {
+    Makma3D::Rendering::ScreenTriangle triangle;
+    for (uint32_t i = 0; i < 3; i++) {
+        triangle.v[i] = glm::vec3(random_float(-16.0f, (float) width + 16.0f), random_float(-16.0f, (float) height + 16.0f), random_float(0.05f, 0.95f));
+    }
+    return triangle;
+}
+
+/* Returns the distance of the given pixel centre to the nearest edge of the given triangle, in pixels. Used to excuse pixels whose coverage is decided by rounding errors. */
+inline float edge_distance(const Makma3D::Rendering::TriangleSetup& setup, float x, float y) {
+    float distance = 1e30f;
+    for (uint32_t i = 0; i < 3; i++) {
+        float length = std::sqrt(setup.a[i] * setup.a[i] + setup.b[i] * setup.b[i]);
+        distance = std::min(distance, std::fabs(setup.edge(i, x, y)) / length);
+    }
+    return distance;
+}
+
+
+
+
+
+/***** USEFUL DEFINES *****/
+/* Prints the intro for a whole new test run. */
+#define TESTRUN(NAME) \
+    cout << endl << "TEST RUN for " NAME << endl;
+/* Prints the outtro for a whole new test run. */
+#define ENDRUN(SUCCESS) \
+    cout << "Run: " << ((SUCCESS) ? "\033[32;1mSUCCESS\033[0m" : "\033[31;1mFAIL\033[0m") << endl << endl; \
+    return (SUCCESS);
+/* Prints the intro for the given test case. */
+#define TESTCASE(NAME) \
+    cout << " > Testing " NAME "..." << flush;
+/* Prints a failure message. */
+#define ERROR(MESSAGE) \
+    cout << endl << "   \033[31;1mERROR\033[0m: " MESSAGE << endl;
+/* Prints the outtro for the given test case. */
+#define ENDCASE(SUCCESS) \
+    cout << ((SUCCESS) ? " \033[32;1mOK\033[0m" : "   Testcase failed.") << endl; \
+    return (SUCCESS);
+
+#endif
@@ -0,0 +1,172 @@
+/* CONSERVATIVE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that checks whether the MaskedDepthBuffer and the
+ *   OcclusionCuller are conservative, i.e., never report something as
+ *   hidden that the brute-force ReferenceDepthBuffer says is visible.
+**/
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <iostream>
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "rendering/occlusion/MaskedDepthBuffer.hpp"
+#include "rendering/occlusion/ReferenceDepthBuffer.hpp"
+#include "rendering/occlusion/OcclusionCuller.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Makma3D::Rendering;
+
+
+/***** TESTS *****/
+/* Checks that no pixel in the masked buffer is nearer than in the reference buffer, for random scenes. */
+static bool test_depth_bounds() {
+    TESTCASE("masked depths against reference depths");
+
+    const uint32_t width = 128, height = 64;
+    MaskedDepthBuffer masked(width, height);
+    ReferenceDepthBuffer reference(width, height);
+    for (uint32_t i = 0; i < 50; i++) {
+        // Generate a random scene
+        Tools::Array<ScreenTriangle> triangles(64);
+        for (uint32_t j = 0; j < 64; j++) { triangles.push_back(random_triangle(width, height)); }
+
+        // Rasterize it in both buffers
+        masked.clear();
+        reference.clear();
+        masked.rasterize(triangles.rdata(), triangles.size(), 0, masked.tiles_y());
+        reference.rasterize(triangles.rdata(), triangles.size());
+
+        // Compare the depths; the masked one may only be farther
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                if (masked.depth_bound(x, y) < reference.depth(x, y) - 1e-5f) {
+                    ERROR("Pixel (" + std::to_string(x) + ", " + std::to_string(y) + ") in scene " + std::to_string(i) + " has masked depth " + std::to_string(masked.depth_bound(x, y)) + ", which is nearer than the reference depth " + std::to_string(reference.depth(x, y)));
+                    ENDCASE(false);
+                }
+            }
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Checks that rectangles the masked buffer hides are hidden in the reference buffer too, for random scenes and rectangles. */
+static bool test_rect_queries() {
+    TESTCASE("masked rectangle tests against reference rectangle tests");
+
+    const uint32_t width = 128, height = 64;
+    MaskedDepthBuffer masked(width, height);
+    ReferenceDepthBuffer reference(width, height);
+    uint32_t n_hidden = 0;
+    for (uint32_t i = 0; i < 50; i++) {
+        // Generate a random scene, which is relatively dense so that there's something to hide behind
+        Tools::Array<ScreenTriangle> triangles(256);
+        for (uint32_t j = 0; j < 256; j++) { triangles.push_back(random_triangle(width, height)); }
+        masked.clear();
+        reference.clear();
+        masked.rasterize(triangles.rdata(), triangles.size(), 0, masked.tiles_y());
+        reference.rasterize(triangles.rdata(), triangles.size());
+
+        // Test a bunch of rectangles at random depths
+        for (uint32_t j = 0; j < 500; j++) {
+            uint32_t min_x = rand() % width, min_y = rand() % height;
+            uint32_t max_x = std::min(width - 1, min_x + rand() % 24), max_y = std::min(height - 1, min_y + rand() % 12);
+            float z_min = random_float(0.0f, 1.0f);
+
+            bool masked_visible = masked.test_rect(min_x, min_y, max_x, max_y, z_min);
+            bool reference_visible = reference.test_rect(min_x, min_y, max_x, max_y, z_min);
+            if (!masked_visible && reference_visible) {
+                ERROR("Rectangle (" + std::to_string(min_x) + ", " + std::to_string(min_y) + ")-(" + std::to_string(max_x) + ", " + std::to_string(max_y) + ") at depth " + std::to_string(z_min) + " in scene " + std::to_string(i) + " is hidden in the masked buffer, but visible in the reference buffer");
+                ENDCASE(false);
+            }
+            n_hidden += masked_visible ? 0 : 1;
+        }
+    }
+
+    // Make sure the masked buffer actually hides something, or the above proves nothing
+    if (n_hidden == 0) {
+        ERROR("The masked buffer didn't hide any of the rectangles");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Checks some boxes that are clearly hidden or visible behind a wall, seen through a real camera. */
+static bool test_clear_cases() {
+    TESTCASE("boxes behind and in front of a wall");
+
+    // Set up a camera at the origin looking down the negative z-axis, like the RenderSystem would
+    glm::mat4 proj = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+    proj[1][1] *= -1;
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Put a large wall at z = -10, which also reaches behind the camera so it has to be clipped
+    glm::vec3 wall[4] = { glm::vec3(-50.0f, -50.0f, -10.0f), glm::vec3(50.0f, -50.0f, -10.0f), glm::vec3(50.0f, 50.0f, -10.0f), glm::vec3(-50.0f, 50.0f, -10.0f) };
+    glm::vec3 floor[4] = { glm::vec3(-5.0f, -2.0f, 5.0f), glm::vec3(5.0f, -2.0f, 5.0f), glm::vec3(5.0f, -2.0f, -9.0f), glm::vec3(-5.0f, -2.0f, -9.0f) };
+    uint32_t indices[6] = { 0, 1, 2, 2, 3, 0 };
+    OcclusionCuller culler;
+    culler.begin(proj * view);
+    culler.add_occluder(glm::mat4(1.0f), wall, indices, 6);
+    culler.add_occluder(glm::mat4(1.0f), floor, indices, 6);
+    culler.rasterize();
+
+    // Compare a few boxes against what we expect, and against the reference
+    ReferenceDepthBuffer reference(culler.depth_buffer().width(), culler.depth_buffer().height());
+    reference.rasterize(culler.screen_triangles().rdata(), culler.screen_triangles().size());
+    struct { glm::vec3 min; glm::vec3 max; bool visible; const char* name; } boxes[] = {
+        { glm::vec3(-1.0f, -1.0f, -16.0f), glm::vec3(1.0f, 1.0f, -14.0f), false, "box behind the wall" },
+        { glm::vec3(-1.0f, -1.0f, -6.0f), glm::vec3(1.0f, 1.0f, -4.0f), true, "box in front of the wall" },
+        { glm::vec3(-1.0f, -1.0f, -11.0f), glm::vec3(1.0f, 1.0f, -9.0f), true, "box through the wall" },
+        { glm::vec3(-1.0f, -5.0f, -8.0f), glm::vec3(1.0f, -4.0f, -6.0f), false, "box under the floor" },
+        { glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f), true, "box around the camera" }
+    };
+    for (const auto& box : boxes) {
+        bool visible = culler.visible(box.min, box.max);
+        if (visible != box.visible) {
+            ERROR("The " + std::string(box.name) + " is " + (visible ? "visible" : "hidden") + ", expected it to be " + (box.visible ? "visible" : "hidden"));
+            ENDCASE(false);
+        }
+
+        uint32_t min_x, min_y, max_x, max_y;
+        float z_min;
+        if (culler.screen_bounds(box.min, box.max, min_x, min_y, max_x, max_y, z_min) && reference.test_rect(min_x, min_y, max_x, max_y, z_min) != visible) {
+            ERROR("The " + std::string(box.name) + " is " + (visible ? "visible" : "hidden") + ", but the reference disagrees");
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_conservative() {
+    TESTRUN("MaskedDepthBuffer & OcclusionCuller conservativeness");
+
+    if (!test_depth_bounds()) {
+        ENDRUN(false);
+    }
+    if (!test_rect_queries()) {
+        ENDRUN(false);
+    }
+    if (!test_clear_cases()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
@@ -0,0 +1,106 @@
+/* COVERAGE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that checks whether the SIMD coverage masks of the
+ *   MaskedDepthBuffer cover the same pixels as testing them one by one.
+**/
+
+#include <iostream>
+
+#include "rendering/occlusion/MaskedDepthBuffer.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Makma3D::Rendering;
+
+
+/***** TESTS *****/
+/* Checks the coverage masks of random triangles against testing each pixel centre against the edge functions. */
+static bool test_coverage_random() {
+    TESTCASE("coverage of random triangles");
+
+    // Generate a bunch of triangles on a small screen
+    const uint32_t width = 128, height = 64;
+    for (uint32_t i = 0; i < 2000; i++) {
+        ScreenTriangle triangle = random_triangle(width, height);
+        TriangleSetup setup;
+        if (!setup_triangle(triangle, width, height, setup)) { continue; }
+
+        // Compare each tile the triangle overlaps
+        for (uint32_t ty = setup.min_y / MaskedDepthBuffer::tile_height; ty < (setup.max_y + MaskedDepthBuffer::tile_height - 1) / MaskedDepthBuffer::tile_height; ty++) {
+            for (uint32_t tx = setup.min_x / MaskedDepthBuffer::tile_width; tx < (setup.max_x + MaskedDepthBuffer::tile_width - 1) / MaskedDepthBuffer::tile_width; tx++) {
+                uint32_t mask[MaskedDepthBuffer::tile_height];
+                MaskedDepthBuffer::coverage(setup, tx, ty, mask);
+
+                for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) {
+                    for (uint32_t c = 0; c < MaskedDepthBuffer::tile_width; c++) {
+                        float x = (float) (tx * MaskedDepthBuffer::tile_width + c) + 0.5f;
+                        float y = (float) (ty * MaskedDepthBuffer::tile_height + r) + 0.5f;
+                        bool expected = setup.edge(0, x, y) >= 0.0f && setup.edge(1, x, y) >= 0.0f && setup.edge(2, x, y) >= 0.0f;
+                        bool got = (mask[r] >> c) & 0x1;
+
+                        // Pixels right on an edge may go either way due to rounding
+                        if (expected != got && edge_distance(setup, x, y) > 1e-3f) {
+                            ERROR("Pixel (" + std::to_string(x) + ", " + std::to_string(y) + ") of triangle " + std::to_string(i) + " has coverage " + std::to_string(got) + ", expected " + std::to_string(expected));
+                            ENDCASE(false);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Checks that two triangles covering the whole screen fill every tile completely, at the right depth. */
+static bool test_coverage_full() {
+    TESTCASE("coverage of a full-screen quad");
+
+    // Rasterize a quad at a constant depth that's slightly larger than the screen
+    const uint32_t width = 128, height = 64;
+    ScreenTriangle quad[2] = {
+        { { glm::vec3(-1.0f, -1.0f, 0.5f), glm::vec3(width + 1.0f, -1.0f, 0.5f), glm::vec3(width + 1.0f, height + 1.0f, 0.5f) } },
+        { { glm::vec3(width + 1.0f, height + 1.0f, 0.5f), glm::vec3(-1.0f, height + 1.0f, 0.5f), glm::vec3(-1.0f, -1.0f, 0.5f) } }
+    };
+    MaskedDepthBuffer buffer(width, height);
+    buffer.rasterize(quad, 2, 0, buffer.tiles_y());
+
+    // Every pixel should now lie at the depth of the quad
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            if (buffer.depth_bound(x, y) != 0.5f) {
+                ERROR("Pixel (" + std::to_string(x) + ", " + std::to_string(y) + ") has depth " + std::to_string(buffer.depth_bound(x, y)) + ", expected 0.5");
+                ENDCASE(false);
+            }
+        }
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_coverage() {
+    TESTRUN("MaskedDepthBuffer coverage");
+
+    if (!test_coverage_random()) {
+        ENDRUN(false);
+    }
+    if (!test_coverage_full()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
@@ -0,0 +1,42 @@
+/* TEST OCCLUSION.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that tests the CPU occlusion culling, without any GPU.
+**/
+
+#include <ctime>
+#include <cstdlib>
+
+using namespace std;
+
+// Function that tests whether the SIMD coverage masks match testing each pixel
+extern bool test_coverage();
+// Function that tests whether the masked buffer never hides more than the brute-force reference
+extern bool test_conservative();
+// Function that tests whether rasterizing on multiple threads gives the same result as on one
+extern bool test_threading();
+
+int main() {
+    // Seed the random seed
+    srand((unsigned int) time(0));
+
+    if (!test_coverage()) {
+        return EXIT_FAILURE;
+    }
+    if (!test_conservative()) {
+        return EXIT_FAILURE;
+    }
+    if (!test_threading()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
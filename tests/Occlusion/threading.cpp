@@ -0,0 +1,83 @@
+/* THREADING.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   19/10/2026, 01:26:35
+ * Last edited:
+ *   19/10/2026, 01:26:35
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that checks whether rasterizing the occluders on multiple
+ *   threads gives exactly the same depth buffer as doing it on one.
+**/
+
+#include <iostream>
+
+#include "tools/ThreadPool.hpp"
+#include "rendering/occlusion/OcclusionCuller.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Makma3D::Rendering;
+
+
+/***** TESTS *****/
+/* Checks that rasterizing the same random occluders with and without a thread pool gives the same tiles. */
+static bool test_threaded_random() {
+    TESTCASE("threaded rasterization of random occluders");
+
+    Tools::ThreadPool pool(4, "occlusion");
+    OcclusionCuller single, threaded;
+    for (uint32_t i = 0; i < 20; i++) {
+        // Generate a random occluder directly in normalized device coordinates
+        Tools::Array<glm::vec3> vertices(300);
+        Tools::Array<uint32_t> indices(300);
+        for (uint32_t j = 0; j < 300; j++) {
+            vertices.push_back(glm::vec3(random_float(-1.2f, 1.2f), random_float(-1.2f, 1.2f), random_float(0.05f, 0.95f)));
+            indices.push_back(j);
+        }
+
+        // Rasterize it both ways
+        single.begin(glm::mat4(1.0f));
+        single.add_occluder(glm::mat4(1.0f), vertices.rdata(), indices.rdata(), indices.size());
+        single.rasterize();
+        threaded.begin(glm::mat4(1.0f));
+        threaded.add_occluder(glm::mat4(1.0f), vertices.rdata(), indices.rdata(), indices.size());
+        threaded.rasterize(&pool);
+
+        // Compare each tile
+        const MaskedDepthBuffer& a = single.depth_buffer();
+        const MaskedDepthBuffer& b = threaded.depth_buffer();
+        for (uint32_t ty = 0; ty < a.tiles_y(); ty++) {
+            for (uint32_t tx = 0; tx < a.tiles_x(); tx++) {
+                const MaskedDepthBuffer::Tile& ta = a.tile(tx, ty);
+                const MaskedDepthBuffer::Tile& tb = b.tile(tx, ty);
+                bool same = ta.z_reference == tb.z_reference && ta.z_working == tb.z_working;
+                for (uint32_t r = 0; r < MaskedDepthBuffer::tile_height; r++) { same = same && ta.mask[r] == tb.mask[r]; }
+                if (!same) {
+                    ERROR("Tile (" + std::to_string(tx) + ", " + std::to_string(ty) + ") in scene " + std::to_string(i) + " differs between the single- and multi-threaded buffers");
+                    ENDCASE(false);
+                }
+            }
+        }
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_threading() {
+    TESTRUN("OcclusionCuller threading");
+
+    if (!test_threaded_random()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}